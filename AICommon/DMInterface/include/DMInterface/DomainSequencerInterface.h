@@ -53,6 +53,14 @@ public:
      */
 	virtual bool removeDomainHandler(std::shared_ptr<DomainHandlerInterface> handler) = 0;
 
+    /**
+     * Make the set of handlers final once they have all been added, so that routing a domain no longer has to
+     * lock.  Handlers can be neither added nor removed afterwards.
+     *
+     * @return Whether the handlers were frozen.
+     */
+	virtual bool freezeDomainHandlers() = 0;
+
     /**
      * Sequence the handling of an @c NLPDomain.  The actual handling is done by whichever @c DomainHandler
      * is associated with the @c NLPDomain's pair.
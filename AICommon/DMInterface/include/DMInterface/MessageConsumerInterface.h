@@ -14,8 +14,13 @@
 #define __MESSAGE_CONSUME_INTERFACE_H_
 
 #include <memory>
+#include <string>
 
 namespace aisdk {
+namespace nlp {
+class NLPDocument;
+}  // namespace nlp
+
 namespace dmInterface {
 
 /**
@@ -35,6 +40,14 @@ public:
      * @param message The semantics message in string representation.
      */
     virtual void consumeMessage(const std::string& contextId, const std::string& message) = 0;
+
+    /**
+     * Called when a message which has already been parsed has been received from Sai sdk.
+     *
+     * @param contextId The context id for the current message.
+     * @param message The parsed semantics message.
+     */
+    virtual void consumeMessage(const std::string& contextId, std::shared_ptr<const nlp::NLPDocument> message) = 0;
 };
 
 }  // namespace dmInterface
@@ -13,9 +13,14 @@
 #ifndef __MESSAGE_OBSERVER_INTERFACE_H_
 #define __MESSAGE_OBSERVER_INTERFACE_H_
 
+#include <memory>
 #include <string>
 
 namespace aisdk {
+namespace nlp {
+class NLPDocument;
+}  // namespace nlp
+
 namespace dmInterface {
 
 /**
@@ -36,6 +41,16 @@ public:
      * @param message The NLP/sai_sdk message that has been received.
      */
     virtual void receive(const std::string& contextId, const std::string& message) = 0;
+
+    /**
+     * A function that a client must implement to receive Messages from NLP/sai_sdk which the sender has already
+     * parsed, so that they are not parsed a second time.
+     *
+     * @param contextId The context for the message, which in this case reflects the logical respond stream the
+     * message arrived on.
+     * @param message The parsed NLP/sai_sdk message that has been received.
+     */
+    virtual void receive(const std::string& contextId, std::shared_ptr<const nlp::NLPDocument> message) = 0;
 };
 
 }  // namespace dmInterface
@@ -49,6 +49,12 @@ public:
     /// The default Media Channel priority.
     static constexpr unsigned int MEDIA_CHANNEL_PRIORITY = 300;
 
+    /**
+     * By default, Channels with this priority or a lower one (a higher number) duck under a higher priority Channel
+     * rather than pause: music keeps playing quietly under speech and alarms, while an alarm still pauses for speech.
+     */
+    static constexpr unsigned int DEFAULT_DUCKING_PRIORITY = MEDIA_CHANNEL_PRIORITY;
+
     /// Destructor.
     virtual ~AudioTrackManagerInterface() = default;
 
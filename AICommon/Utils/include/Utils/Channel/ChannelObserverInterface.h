@@ -4,6 +4,7 @@
 #define _CHANNEL_OBSERVER_INTERFACE_H_
 
 #include "Utils/Channel/FocusState.h"
+#include "Utils/Channel/MixingBehavior.h"
 
 namespace aisdk {
 namespace utils {
@@ -24,6 +25,18 @@ public:
      * @param newTrace The new Track of the channel.
      */
     virtual void onTrackChanged(FocusState newTrace) = 0;
+
+    /**
+     * Used to notify the observer of track changes along with how it should sound in the new track.  Observers which
+     * can lower their volume override this to duck on @c MixingBehavior::MAY_DUCK rather than pause; the default
+     * ignores @c behavior.
+     *
+     * @param newTrace The new Track of the channel.
+     * @param behavior How the observer should sound in @c newTrace.
+     */
+    virtual void onTrackChangedWithMixing(FocusState newTrace, MixingBehavior behavior) {
+        onTrackChanged(newTrace);
+    }
 };
 
 }  // namespace channel
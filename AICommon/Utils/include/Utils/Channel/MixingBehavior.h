@@ -0,0 +1,75 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef _MIXING_BEHAVIOR_H_
+#define _MIXING_BEHAVIOR_H_
+
+#include <ostream>
+#include <string>
+
+namespace aisdk {
+namespace utils {
+namespace channel {
+
+/**
+ * How the owner of a Channel should sound in its current @c FocusState.
+ */
+enum class MixingBehavior {
+    /// The Channel is in the foreground and plays at full volume.
+    PRIMARY,
+
+    /// The Channel is in the background and may keep playing at a lowered volume.
+    MAY_DUCK,
+
+    /// The Channel is in the background and must be silent.
+    MUST_PAUSE,
+
+    /// The Channel lost its track and must stop.
+    MUST_STOP
+};
+
+/**
+ * This function converts the provided @c MixingBehavior to a string.
+ *
+ * @param behavior The @c MixingBehavior to convert to a string.
+ * @return The string conversion of @c behavior.
+ */
+inline std::string mixingBehaviorToString(MixingBehavior behavior) {
+    switch (behavior) {
+        case MixingBehavior::PRIMARY:
+            return "PRIMARY";
+        case MixingBehavior::MAY_DUCK:
+            return "MAY_DUCK";
+        case MixingBehavior::MUST_PAUSE:
+            return "MUST_PAUSE";
+        case MixingBehavior::MUST_STOP:
+            return "MUST_STOP";
+    }
+    return "Unknown Behavior";
+}
+
+/**
+ * Write a @c MixingBehavior value to an @c ostream as a string.
+ *
+ * @param stream The stream to write the value to.
+ * @param behavior The @c MixingBehavior value to write to the @c ostream as a string.
+ * @return The @c ostream that was passed in and written to.
+ */
+inline std::ostream& operator<<(std::ostream& stream, const MixingBehavior& behavior) {
+    return stream << mixingBehaviorToString(behavior);
+}
+
+}  // namespace channel
+}  // namespace utils
+}  // namespace aisdk
+
+#endif  // _MIXING_BEHAVIOR_H_
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __LOGGER_ASYNCLOGGER_H_
+#define __LOGGER_ASYNCLOGGER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Utils/Logging/Logger.h"
+
+namespace aisdk {
+namespace utils {
+namespace logging {
+
+/**
+ * A sink which hands log lines to another sink on a background thread.  @c emit() only copies the time, level,
+ * thread moniker and text of the line into a slot of a fixed lock-free ring; formatting, console output and zlog all
+ * happen on the background thread, so logging from the audio and recognizer callbacks no longer waits for them.
+ *
+ * Lines keep their order per thread.  When the ring is full new lines are dropped rather than blocking the caller,
+ * and the number dropped is reported through the wrapped sink once there is room again.
+ */
+class AsyncLogger : public Logger {
+public:
+    /// The default number of lines the ring holds.
+    static const size_t DEFAULT_CAPACITY = 512;
+
+    /**
+     * Creates an @c AsyncLogger and starts its thread.
+     *
+     * @param sink The sink to emit the lines to.  It is only called from the background thread.
+     * @param capacity The number of lines the ring holds, rounded up to a power of two.
+     * @return The logger, or @c nullptr if @c sink is @c nullptr.
+     */
+    static std::shared_ptr<AsyncLogger> create(std::shared_ptr<Logger> sink, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Destructor.  Emits the lines still in the ring and stops the thread.
+     */
+    ~AsyncLogger();
+
+    /// @name Logger methods.
+    /// @{
+    void setLevel(Level level) override;
+    void emit(Level level, std::chrono::system_clock::time_point time, const char* threadMoniker, const char* text)
+        override;
+    /// @}
+
+    /**
+     * Waits until every line emitted before the call has been handed to the sink.
+     */
+    void flush();
+
+    /**
+     * Returns the number of lines dropped because the ring was full.
+     *
+     * @return The number of dropped lines since creation.
+     */
+    size_t getDroppedCount() const;
+
+private:
+    /// Room for the thread moniker of a line, with the terminator.
+    static const size_t MONIKER_SIZE = 16;
+
+    /// The size of a slot; text which doesn't fit in the rest of it is copied to the heap.
+    static const size_t SLOT_SIZE = 256;
+
+    /// One line in the ring.
+    struct Slot {
+        /// The position the slot is ready for: equal to a producer's position when free, one past it when written.
+        std::atomic<size_t> sequence;
+        /// The time of the line.
+        std::chrono::system_clock::time_point time;
+        /// The level of the line.
+        Level level;
+        /// A copy of the moniker of the thread which logged the line.
+        char threadMoniker[MONIKER_SIZE];
+        /// Text too long for @c text, or @c nullptr.
+        std::string* longText;
+        /// The text of the line, if it fits.
+        char text[SLOT_SIZE - sizeof(std::atomic<size_t>) - sizeof(std::chrono::system_clock::time_point) -
+                  sizeof(Level) - MONIKER_SIZE - sizeof(std::string*)];
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param sink The sink to emit the lines to.
+     * @param capacity The number of slots, a power of two.
+     */
+    AsyncLogger(std::shared_ptr<Logger> sink, size_t capacity);
+
+    /**
+     * Hands every written slot to the sink, in order.
+     *
+     * @return Whether any line was handed over.
+     */
+    bool drain();
+
+    /// The loop of the background thread.
+    void consumeLoop();
+
+    /// The sink lines are emitted to.
+    std::shared_ptr<Logger> m_sink;
+
+    /// The ring of slots.
+    std::vector<Slot> m_ring;
+
+    /// @c m_ring.size() - 1, to wrap positions.
+    const size_t m_mask;
+
+    /// The position the next producer will claim.
+    std::atomic<size_t> m_enqueuePos;
+
+    /// The position of the next slot the background thread will read.
+    std::atomic<size_t> m_dequeuePos;
+
+    /// The number of lines dropped because the ring was full.
+    std::atomic<size_t> m_dropped;
+
+    /// The number of dropped lines already reported.
+    size_t m_droppedReported;
+
+    /// Set by a producer finding the ring half full, or by @c flush(), to wake the thread before its next round.
+    std::atomic<bool> m_wakeRequested;
+
+    /// Whether the thread should exit once the ring is empty.
+    bool m_stopping;
+
+    /// Guards the waits below.
+    std::mutex m_mutex;
+
+    /// Wakes the background thread.
+    std::condition_variable m_wakeTrigger;
+
+    /// Signalled by the background thread after each round, for @c flush().
+    std::condition_variable m_drained;
+
+    /// The background thread.
+    std::thread m_thread;
+};
+
+}  // namespace logging
+}  // namespace utils
+}  // namespace aisdk
+
+#endif  // __LOGGER_ASYNCLOGGER_H_
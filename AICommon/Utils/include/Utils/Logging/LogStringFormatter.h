@@ -14,9 +14,10 @@
 #define __LOGGER_LOGSTRINGFORMATTER_H_
 
 #include <chrono>
+#include <cstdint>
+#include <string>
 
 #include "Utils/Logging/Logger.h"
-#include "Utils/Logging/SafeCTimeAccess.h"
 
 namespace aisdk {
 namespace utils {
@@ -24,11 +25,26 @@ namespace logging {
 
 /**
  * A class used to format log strings.
+ *
+ * The "YYYY-MM-DD HH:MM:SS" part of the time is computed arithmetically, without @c gmtime() and the process-wide
+ * lock around it, and only once per second; lines within the same second only render their milliseconds.  Because
+ * of that cache a formatter must not be used by two threads at once; the sinks call it under their own lock.
  */
 class LogStringFormatter {
 public:
+    /**
+     * Constructs a formatter which prints local time in the zone the system is set to (e.g. by @c TZ) at the time
+     * of construction.
+     */
     LogStringFormatter();
 
+    /**
+     * Constructs a formatter which prints the time at a fixed offset from UTC.
+     *
+     * @param utcOffset The offset of the printed time from UTC, e.g. 8 hours for China Standard Time.
+     */
+    explicit LogStringFormatter(std::chrono::seconds utcOffset);
+
     /**
      * Formats a log message into a printable string with other metadata regarding the log message.
      *
@@ -44,12 +60,55 @@ public:
         const char* threadMoniker,
         const char* text);
 
+    /**
+     * Returns the offset from UTC the formatter prints time at.
+     *
+     * @return The offset.
+     */
+    std::chrono::seconds getUtcOffset() const;
+
+    /**
+     * Returns the current offset of the system time zone from UTC.
+     *
+     * @return The offset, or zero if the local time can't be determined.
+     */
+    static std::chrono::seconds getSystemUtcOffset();
+
+    /**
+     * Parses an offset from UTC written as "+HH", "+HHMM" or "+HH:MM" (or with '-').
+     *
+     * @param text The text to parse.
+     * @param[out] utcOffset The parsed offset.
+     * @return Whether @c text was a valid offset; @c utcOffset is left untouched if not.
+     */
+    static bool parseUtcOffset(const std::string& text, std::chrono::seconds* utcOffset);
+
 private:
-    std::shared_ptr<timing::SafeCTimeAccess> m_safeCTimeAccess;
+    /// The size of "YYYY-MM-DD HH:MM:SS" and a null terminator.
+    static const int DATE_AND_TIME_STRING_SIZE = 20;
+
+    /**
+     * Renders @c m_cachedDateTime for a second.
+     *
+     * @param localSecond Seconds since the epoch, already shifted by @c m_utcOffset.
+     */
+    void renderDateTime(int64_t localSecond);
+
+    /// The offset of the printed time from UTC.
+    const std::chrono::seconds m_utcOffset;
+
+    /// Whether @c m_cachedDateTime holds anything yet.
+    bool m_hasCachedSecond;
+
+    /// The local second @c m_cachedDateTime was rendered for.
+    int64_t m_cachedSecond;
+
+    /// "YYYY-MM-DD HH:MM:SS" for @c m_cachedSecond.
+    char m_cachedDateTime[DATE_AND_TIME_STRING_SIZE];
 };
 
 }  // namespace logging
 }  // namespace utils
 }  // namespace aisdk
 
-#endif  // __LOGGER_LOGSTRINGFORMATTER_H_
\ No newline at end of file
+#endif  // __LOGGER_LOGSTRINGFORMATTER_H_
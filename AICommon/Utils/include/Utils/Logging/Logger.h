@@ -137,6 +137,15 @@ public:
      */
     inline bool shouldLog(Level level) const;
 
+    /**
+     * Returns the lowest severity level of logs to be output by this Logger.
+     *
+     * @return The level.
+     */
+    Level getLevel() const {
+        return m_level;
+    }
+
     /**
      * Send a log entry to this Logger.
      *
@@ -293,153 +302,248 @@ inline Logger& ACSDK_GET_LOGGER_FUNCTION() {
         }                                                                                             \
     } while (false)
 
+/*
+ * Numeric values of the @c Level enumerators, for comparing levels in the preprocessor.
+ */
+#define AISDK_LOG_LEVEL_DEBUG5 0
+#define AISDK_LOG_LEVEL_DEBUG4 1
+#define AISDK_LOG_LEVEL_DEBUG3 2
+#define AISDK_LOG_LEVEL_DEBUG2 3
+#define AISDK_LOG_LEVEL_DEBUG1 4
+#define AISDK_LOG_LEVEL_DEBUG0 5
+#define AISDK_LOG_LEVEL_INFO 6
+#define AISDK_LOG_LEVEL_WARN 7
+#define AISDK_LOG_LEVEL_ERROR 8
+#define AISDK_LOG_LEVEL_CRITICAL 9
+#define AISDK_LOG_LEVEL_NONE 10
+
+static_assert(
+    static_cast<int>(aisdk::utils::logging::Level::DEBUG5) == AISDK_LOG_LEVEL_DEBUG5 &&
+        static_cast<int>(aisdk::utils::logging::Level::INFO) == AISDK_LOG_LEVEL_INFO &&
+        static_cast<int>(aisdk::utils::logging::Level::NONE) == AISDK_LOG_LEVEL_NONE,
+    "AISDK_LOG_LEVEL_* out of step with Level");
+
+/*
+ * The lowest level whose log lines are compiled in.  Lines below it are left only as the operand of @c sizeof, so
+ * neither the @c LogEntry nor its arguments are evaluated, yet variables used only for logging still count as used.
+ * Defaults to DEBUG5 when AISDK_DEBUG_LOG_ENABLED is defined and to INFO otherwise; a build may raise it further,
+ * e.g. -DAISDK_LOG_MIN_LEVEL=AISDK_LOG_LEVEL_WARN.
+ */
+#ifndef AISDK_LOG_MIN_LEVEL
 #ifdef AISDK_DEBUG_LOG_ENABLED
+#define AISDK_LOG_MIN_LEVEL AISDK_LOG_LEVEL_DEBUG5
+#else
+#define AISDK_LOG_MIN_LEVEL AISDK_LOG_LEVEL_INFO
+#endif
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_DEBUG5
 /**
  * Send a DEBUG5 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
 #define AISDK_DEBUG5(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG5, entry)
-
+#else
 /**
- * Send a DEBUG4 severity log line.
+ * Compile out a DEBUG5 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG4(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG4, entry)
+#define AISDK_DEBUG5(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_DEBUG4
 /**
- * Send a DEBUG3 severity log line.
+ * Send a DEBUG4 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG3(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG3, entry)
-
+#define AISDK_DEBUG4(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG4, entry)
+#else
 /**
- * Send a DEBUG2 severity log line.
+ * Compile out a DEBUG4 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG2(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG2, entry)
+#define AISDK_DEBUG4(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_DEBUG3
 /**
- * Send a DEBUG1 severity log line.
+ * Send a DEBUG3 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG1(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG1, entry)
-
+#define AISDK_DEBUG3(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG3, entry)
+#else
 /**
- * Send a DEBUG0 severity log line.
+ * Compile out a DEBUG3 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG0(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG0, entry)
+#define AISDK_DEBUG3(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_DEBUG2
 /**
- * Send a log line at the default debug level (DEBUG0).
+ * Send a DEBUG2 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG0, entry)
-
-#else  // AISDK_DEBUG_LOG_ENABLED
-
+#define AISDK_DEBUG2(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG2, entry)
+#else
 /**
- * Compile out a DEBUG5 severity log line.
+ * Compile out a DEBUG2 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG5(entry)
+#define AISDK_DEBUG2(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_DEBUG1
 /**
- * Compile out a DEBUG4 severity log line.
+ * Send a DEBUG1 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG4(entry)
-
+#define AISDK_DEBUG1(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG1, entry)
+#else
 /**
- * Compile out a DEBUG3 severity log line.
+ * Compile out a DEBUG1 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG3(entry)
+#define AISDK_DEBUG1(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_DEBUG0
 /**
- * Compile out a DEBUG2 severity log line.
+ * Send a DEBUG0 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG2(entry)
-
+#define AISDK_DEBUG0(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG0, entry)
+#else
 /**
- * Compile out a DEBUG1 severity log line.
+ * Compile out a DEBUG0 severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG1(entry)
+#define AISDK_DEBUG0(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_DEBUG0
 /**
- * Compile out a DEBUG0 severity log line.
+ * Send a DEBUG severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG0(entry)
-
+#define AISDK_DEBUG(entry) ACSDK_LOG(aisdk::utils::logging::Level::DEBUG0, entry)
+#else
 /**
  * Compile out a DEBUG severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
-#define AISDK_DEBUG(entry)
-
-#endif  // AISDK_DEBUG_LOG_ENABLED
+#define AISDK_DEBUG(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_INFO
 /**
  * Send a INFO severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
 #define AISDK_INFO(entry) ACSDK_LOG(aisdk::utils::logging::Level::INFO, entry)
+#else
+/**
+ * Compile out a INFO severity log line.
+ *
+ * @param entry The text (or builder of the text) for the log entry.
+ */
+#define AISDK_INFO(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_WARN
 /**
  * Send a WARN severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
 #define AISDK_WARN(entry) ACSDK_LOG(aisdk::utils::logging::Level::WARN, entry)
+#else
+/**
+ * Compile out a WARN severity log line.
+ *
+ * @param entry The text (or builder of the text) for the log entry.
+ */
+#define AISDK_WARN(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_ERROR
 /**
  * Send a ERROR severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
 #define AISDK_ERROR(entry) ACSDK_LOG(aisdk::utils::logging::Level::ERROR, entry)
+#else
+/**
+ * Compile out a ERROR severity log line.
+ *
+ * @param entry The text (or builder of the text) for the log entry.
+ */
+#define AISDK_ERROR(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
+
+#if AISDK_LOG_MIN_LEVEL <= AISDK_LOG_LEVEL_CRITICAL
 /**
  * Send a CRITICAL severity log line.
  *
- * @param loggerArg The Logger to send the line to.
  * @param entry The text (or builder of the text) for the log entry.
  */
 #define AISDK_CRITICAL(entry) ACSDK_LOG(aisdk::utils::logging::Level::CRITICAL, entry)
+#else
+/**
+ * Compile out a CRITICAL severity log line.
+ *
+ * @param entry The text (or builder of the text) for the log entry.
+ */
+#define AISDK_CRITICAL(entry) \
+    do {                     \
+        (void)sizeof(entry); \
+    } while (false)
+#endif
 
 #endif  // __LOGGER_LOGGER_H_
\ No newline at end of file
@@ -102,8 +102,9 @@ public:
      *
      * @return If the specified source is playing, the offset in milliseconds that the source has been playing
      *      will be returned. If the specified source is not playing, the last offset it played will be returned.
+     *      Passed to @c setSource() with the same url, it resumes the source where it was.
      */
-    //virtual std::chrono::milliseconds getOffset(SourceId id) = 0;
+    virtual std::chrono::milliseconds getOffset(SourceId id) = 0;
 	
 	/**
      * Returns the number of bytes queued up in the media player buffers.
@@ -119,6 +120,54 @@ public:
      */
     virtual void setObserver(
         std::shared_ptr<MediaPlayerObserverInterface> playerObserver) = 0;
+
+    /**
+     * Moves the volume of everything this player plays, the current source and the following ones, to @c gain,
+     * changing it gradually so there is no click.  Used to duck under a higher priority channel instead of pausing.
+     *
+     * @param gain The new gain, from 0 (silent) to 1 (unchanged).
+     * @param rampDuration How long the change takes.
+     * @return @c true if the player can change its gain; @c false if it can't, and the caller should pause instead.
+     */
+    virtual bool setGain(float gain, std::chrono::milliseconds rampDuration) {
+        return false;
+    }
+
+    /**
+     * Queues an @c url source to follow the current one without a gap.  The player opens the source and decodes the
+     * start of it in the background while the current source plays, and when the current source ends carries straight
+     * on with it: the observer gets @c onPlaybackFinished() for the current source, then @c onPlaybackStarted() for
+     * the queued one.  @c setSource(), @c stop() and another call to this method discard a queued source which hasn't
+     * started yet.
+     *
+     * @param url The url of the source to play next.
+     * @return The id the queued source plays under, or @c ERROR if nothing is playing or the player can't queue
+     * sources, in which case the caller should set the source once the current one has finished.
+     */
+    virtual SourceId setNextSource(const std::string& url) {
+        return ERROR;
+    }
+
+    /**
+     * Discards the source queued by @c setNextSource(), unless it has started.
+     *
+     * @return @c true if a queued source was discarded; @c false if there was none, or it has started already.
+     */
+    virtual bool clearNextSource() {
+        return false;
+    }
+
+    /**
+     * Decodes an @c url source ahead of time and keeps the audio in memory, so that playing it later needs no
+     * decoding and starts at once.  Meant for short local files played again and again, such as prompts.  The
+     * decoding happens in the background and doesn't disturb what this player plays.
+     *
+     * @param url The url of the source.
+     * @return @c true if the source is being decoded or has been already; @c false if the player can't keep it.
+     */
+    virtual bool preloadSource(const std::string& url) {
+        return false;
+    }
 };
 }  // namespace mediaPlayer
 }  // namespace utils
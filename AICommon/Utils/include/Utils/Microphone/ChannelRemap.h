@@ -0,0 +1,115 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __UTILS_MICROPHONE_CHANNELREMAP_H_
+#define __UTILS_MICROPHONE_CHANNELREMAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace aisdk {
+namespace utils {
+namespace microphone {
+
+/**
+ * A table-driven channel remap for interleaved 16-bit PCM.  Output channel @c c takes input channel
+ * @c channelMap[c], or silence for @c SILENCE, so reordering, duplicating and dropping channels all cost the same and
+ * there is no per-sample branching.
+ *
+ * 8-channel input (the microphone array) is handled with NEON or SSE2 when the compiler targets them; every other
+ * shape uses the scalar kernel.  The scalar kernels are public so the vector ones can be checked against them.
+ */
+class ChannelRemap {
+public:
+    /// Entry of the channel map which produces a silent output channel.
+    static const int SILENCE = -1;
+
+    /**
+     * Creates a @c ChannelRemap.
+     *
+     * @param inputChannels The number of interleaved channels in the input.
+     * @param channelMap For each output channel, the input channel it is taken from or @c SILENCE.
+     * @return The remap, or @c nullptr if the map is empty or refers to a channel which does not exist.
+     */
+    static std::unique_ptr<ChannelRemap> create(size_t inputChannels, const std::vector<int>& channelMap);
+
+    /**
+     * Remaps interleaved frames to interleaved frames.
+     *
+     * @param input @c nFrames frames of @c getInputChannels() samples.
+     * @param[out] output Room for @c nFrames frames of @c getOutputChannels() samples.  Must not overlap @c input.
+     * @param nFrames The number of frames.
+     */
+    void remap(const int16_t* input, int16_t* output, size_t nFrames) const;
+
+    /**
+     * Remaps interleaved frames into one plane per output channel.
+     *
+     * @param input @c nFrames frames of @c getInputChannels() samples.
+     * @param[out] planes @c getOutputChannels() pointers, each with room for @c nFrames samples.
+     * @param nFrames The number of frames.
+     */
+    void deinterleave(const int16_t* input, int16_t* const* planes, size_t nFrames) const;
+
+    /// The portable reference implementation of @c remap().
+    void remapScalar(const int16_t* input, int16_t* output, size_t nFrames) const;
+
+    /// The portable reference implementation of @c deinterleave().
+    void deinterleaveScalar(const int16_t* input, int16_t* const* planes, size_t nFrames) const;
+
+    /// @return The number of interleaved input channels.
+    size_t getInputChannels() const;
+
+    /// @return The number of output channels.
+    size_t getOutputChannels() const;
+
+    /// @return The name of the vector kernel compiled in: "neon", "sse2" or "scalar".
+    static const char* getKernelName();
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param inputChannels The number of interleaved channels in the input.
+     * @param channelMap The validated channel map.
+     */
+    ChannelRemap(size_t inputChannels, const std::vector<int>& channelMap);
+
+    /**
+     * Scalar deinterleave of frames [@c begin, @c end), used for the reference kernel and for the tail the vector
+     * kernel leaves over.
+     */
+    void deinterleaveFrames(const int16_t* input, int16_t* const* planes, size_t begin, size_t end) const;
+
+    /// The number of interleaved input channels.
+    size_t m_inputChannels;
+
+    /// For each output channel, the input channel to copy (0 for silent channels).
+    std::vector<size_t> m_sourceIndex;
+
+    /// For each output channel, all ones to copy the sample or zero to silence it.
+    std::vector<int16_t> m_sourceMask;
+
+    /// For each output channel, the input channel to copy or @c m_inputChannels (a zero vector) for silence.
+    std::vector<size_t> m_vectorIndex;
+
+    /// Byte shuffle for one 8-channel frame, used by the NEON @c remap(); 0xff bytes read as zero.
+    uint8_t m_byteTable[16];
+};
+
+}  // namespace microphone
+}  // namespace utils
+}  // namespace aisdk
+
+#endif  // __UTILS_MICROPHONE_CHANNELREMAP_H_
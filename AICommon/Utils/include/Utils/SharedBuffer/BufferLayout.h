@@ -17,7 +17,9 @@
 #include <memory>
 #include <mutex>
 #include <condition_variable>
-#include <vector>
+
+#include <Utils/SharedBuffer/ProcessSharedMutex.h>
+#include <Utils/SharedBuffer/RawBuffer.h>
 
 namespace aisdk {
 namespace utils {
@@ -25,9 +27,22 @@ namespace sharedbuffer {
 	
 class BufferLayout {
 public:
-	using Buffer = std::vector<uint8_t>;
+	using Buffer = RawBuffer;
 	using Index = uint64_t;
 
+    /**
+     * The synchronization primitives embedded in the @c Header.  They are process-shared so that a @c Buffer which
+     * lives in shared memory can be used by a @c Writer and @c Readers in different processes.
+     */
+    using Mutex = ProcessSharedMutex;
+    using ConditionVariable = ProcessSharedConditionVariable;
+
+    /// Magic number used to identify a @c Buffer which holds an initialized @c BufferLayout.
+    static const uint32_t MAGIC_NUMBER = 0x53414942;
+
+    /// Version of the @c Header layout; bump whenever the @c Header changes.
+    static const uint32_t VERSION = 2;
+
     /**
      * The constructor only initializes a shared pointer to the provided buffer.  Attaching and/or initializing is
      * performed by the @c init()/@c attach() functions.
@@ -42,6 +57,12 @@ public:
      * This structure defines the header fields for the @c Buffer.
      */
     struct Header {
+        /// This field contains the magic number, used by @c attach() to detect an uninitialized @c Buffer.
+        uint32_t magic;
+
+        /// This field contains the version of the @c Header layout.
+        uint32_t version;
+
         /**
          * This field specifies the word size (in bytes).
          */
@@ -53,22 +74,22 @@ public:
         uint8_t maxReaders;
 
         /// This field contains the condition variable used to notify @c Readers that data is available.
-        std::condition_variable dataAvailableConditionVariable;
+        ConditionVariable dataAvailableConditionVariable;
 
         /// This field contains the mutex used by @c dataAvailableConditionVariable.
-        std::mutex dataAvailableMutex;
+        Mutex dataAvailableMutex;
 
         /**
          * This field contains the condition variable used to notify @c Writers that space is available.  Note that
          * this condition variable does not have a dedicated mutex; the condition is protected by backwardSeekMutex.
          */
-        std::condition_variable spaceAvailableConditionVariable;
+        ConditionVariable spaceAvailableConditionVariable;
 
         /**
          * This field contains a mutex used to temporarily hold off @c Readers from seeking backwards in the buffer
          * while a @c Reader is updating @c oldestUnconsumedCursor.
          */
-        std::mutex backwardSeekMutex;
+        Mutex backwardSeekMutex;
 
         /// This field indicates whether there is an enabled (not closed) @c Writer.
         std::atomic<bool> isWriterEnabled;
@@ -80,7 +101,7 @@ public:
          * This mutex is used to protect creation of the writer.  In particular, it is locked when attempting to add
          * the writer so that there are no races between overlapping calls to @c createWriter().
          */
-        std::mutex writerEnableMutex;
+        Mutex writerEnableMutex;
 
         /// This field contains the next location to write to.
         std::atomic<uint64_t> writeStartCursor;
@@ -91,16 +112,32 @@ public:
          */
         std::atomic<uint64_t> writeEndCursor;
 
+        /**
+         * This field contains the cursor of the slowest enabled @c Reader.  It is only kept up to date while a
+         * @c BLOCKING @c Writer is enabled, because that is the only policy which needs to know how much space is free.
+         */
+        std::atomic<uint64_t> oldestUnconsumedCursor;
+
+        /// This field indicates whether the enabled @c Writer uses @c WriterPolicy::BLOCKING.
+        std::atomic<bool> isWriterBlocking;
+
+        /**
+         * This field counts the @c Readers which are waiting on @c dataAvailableConditionVariable.  A @c Writer only
+         * takes @c dataAvailableMutex to signal when this is non-zero, so the steady-state write path is lock-free.
+         */
+        std::atomic<uint32_t> waitingReaders;
+
         /// This field tracks the number of BufferLayout instances currently attached to a Buffer.
         uint32_t referenceCount;
 
-        std::mutex attachMutex;
+        /// This mutex protects @c referenceCount.
+        Mutex attachMutex;
 
         /**
          * This mutex is used to protect creation of readers.  In particular, it is locked when attempting to add a new
          * reader so that there are no races between overlapping calls to @c createReader().
          */
-        std::mutex readerEnableMutex;
+        Mutex readerEnableMutex;
     };
 
     // return A pointer to the array of @c maxReaders cursor @c Indexes.
@@ -131,7 +168,13 @@ public:
 
 	bool init(size_t wordSize, size_t maxReaders);
 
-	//bool attach();
+    /**
+     * This function attaches to a @c Buffer which was already initialized by @c init(), possibly in another process,
+     * and takes a reference on it.
+     *
+     * @return @c true if the @c Buffer holds a compatible, initialized layout, else @c false.
+     */
+	bool attach();
 
 	void detach();
 
@@ -160,6 +203,19 @@ public:
      * @c return The count of words after @c after until the circular data will wrap.
      */
     Index wordsUntilWrap(Index after) const;
+
+    /**
+     * This function recalculates @c Header::oldestUnconsumedCursor from the enabled @c Readers and wakes a waiting
+     * @c Writer if space was freed.  It is a no-op unless a @c BLOCKING @c Writer is enabled.
+     */
+    void updateOldestUnconsumedCursor();
+
+    /**
+     * This function recalculates @c Header::oldestUnconsumedCursor.  The caller must be holding
+     * Header::backwardSeekMutex when calling this function.
+     */
+    void updateOldestUnconsumedCursorLocked();
+
     /** 
      * This function calculates the offset (in bytes) from the start of a @c Buffer to the start of the circular data
      * (start storing the start address of Raw Data or (header + allReaderArray)).
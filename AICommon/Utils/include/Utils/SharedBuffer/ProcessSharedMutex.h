@@ -0,0 +1,142 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __PROCESS_SHARED_MUTEX_H_
+#define __PROCESS_SHARED_MUTEX_H_
+
+#include <pthread.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+/**
+ * A mutex which may live inside memory mapped by several processes.  It satisfies the standard @c Lockable
+ * requirements, so @c std::lock_guard and @c std::unique_lock work with it.
+ *
+ * The mutex is robust: if a process dies while holding it, the next locker recovers it instead of deadlocking.
+ */
+class ProcessSharedMutex {
+public:
+    /// Constructor.
+    ProcessSharedMutex();
+
+    /// Destructor.
+    ~ProcessSharedMutex();
+
+    /**
+     * Locks the mutex, blocking if necessary.
+     *
+     * Like @c std::mutex::lock(), this throws @c std::system_error if the mutex can't be locked, as
+     * @c std::lock_guard and @c std::unique_lock have no other way to report it to the code holding them, and
+     * carrying on unlocked would corrupt the shared state.  A dead owner is recovered, so this only happens when the
+     * mutex itself is broken, e.g. the shared memory holding it was never initialised.
+     */
+    void lock();
+
+    /// Attempts to lock the mutex without blocking. @return @c true if the lock was acquired.
+    bool try_lock();
+
+    /// Unlocks the mutex.
+    void unlock();
+
+    /// @return The underlying pthread mutex.
+    pthread_mutex_t* native_handle();
+
+    ProcessSharedMutex(const ProcessSharedMutex&) = delete;
+    ProcessSharedMutex& operator=(const ProcessSharedMutex&) = delete;
+
+private:
+    /// The underlying pthread mutex, initialised with @c PTHREAD_PROCESS_SHARED.
+    pthread_mutex_t m_mutex;
+};
+
+/**
+ * A condition variable which may live inside memory mapped by several processes.  It mirrors the subset of the
+ * @c std::condition_variable interface used by @c SharedBuffer and waits against @c std::chrono::steady_clock.
+ */
+class ProcessSharedConditionVariable {
+public:
+    /// Constructor.
+    ProcessSharedConditionVariable();
+
+    /// Destructor.
+    ~ProcessSharedConditionVariable();
+
+    /// Wakes one waiting thread.
+    void notify_one();
+
+    /// Wakes all waiting threads.
+    void notify_all();
+
+    /**
+     * Blocks until notified.
+     *
+     * @param lock A lock on the mutex protecting the condition, which is released while waiting.
+     */
+    void wait(std::unique_lock<ProcessSharedMutex>& lock);
+
+    /**
+     * Blocks until notified or @c deadline passes.
+     *
+     * @param lock A lock on the mutex protecting the condition, which is released while waiting.
+     * @param deadline The time to stop waiting at.
+     * @return @c std::cv_status::timeout if the deadline passed, else @c std::cv_status::no_timeout.
+     */
+    std::cv_status wait_until(
+        std::unique_lock<ProcessSharedMutex>& lock,
+        const std::chrono::steady_clock::time_point& deadline);
+
+    /// Blocks until @c predicate returns @c true.
+    template <typename Predicate>
+    void wait(std::unique_lock<ProcessSharedMutex>& lock, Predicate predicate) {
+        while (!predicate()) {
+            wait(lock);
+        }
+    }
+
+    /**
+     * Blocks until @c predicate returns @c true or @c timeout elapses.
+     *
+     * @return The final value of @c predicate.
+     */
+    template <typename Rep, typename Period, typename Predicate>
+    bool wait_for(
+        std::unique_lock<ProcessSharedMutex>& lock,
+        const std::chrono::duration<Rep, Period>& timeout,
+        Predicate predicate) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate()) {
+            if (std::cv_status::timeout == wait_until(lock, deadline)) {
+                return predicate();
+            }
+        }
+        return true;
+    }
+
+    ProcessSharedConditionVariable(const ProcessSharedConditionVariable&) = delete;
+    ProcessSharedConditionVariable& operator=(const ProcessSharedConditionVariable&) = delete;
+
+private:
+    /// The underlying pthread condition variable, initialised with @c PTHREAD_PROCESS_SHARED and @c CLOCK_MONOTONIC.
+    pthread_cond_t m_condition;
+};
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
+
+#endif  // __PROCESS_SHARED_MUTEX_H_
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __RAW_BUFFER_H_
+#define __RAW_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+/**
+ * The block of memory which holds a @c SharedBuffer's header, reader arrays and circular data.  It is either owned
+ * heap memory or a region provided by someone else (e.g. a shared memory mapping), in which case a release function
+ * is called on destruction.
+ */
+class RawBuffer {
+public:
+    /// The function used to give an externally provided region back.
+    using Releaser = std::function<void(uint8_t* data, size_t size)>;
+
+    /**
+     * Constructs a zero-filled heap buffer.
+     *
+     * @param size The size (in bytes) of the buffer.
+     */
+    explicit RawBuffer(size_t size);
+
+    /**
+     * Wraps an externally provided region.
+     *
+     * @param data The start of the region.
+     * @param size The size (in bytes) of the region.
+     * @param releaser Called with @c data and @c size when this object is destroyed.
+     */
+    RawBuffer(uint8_t* data, size_t size, Releaser releaser);
+
+    /// Destructor.
+    ~RawBuffer();
+
+    /// @return The start of the buffer.
+    uint8_t* data() const;
+
+    /// @return The size (in bytes) of the buffer.
+    size_t size() const;
+
+    RawBuffer(const RawBuffer&) = delete;
+    RawBuffer& operator=(const RawBuffer&) = delete;
+
+private:
+    /// The start of the buffer.
+    uint8_t* m_data;
+
+    /// The size (in bytes) of the buffer.
+    size_t m_size;
+
+    /// Releases @c m_data; for heap buffers this is @c delete[].
+    Releaser m_releaser;
+};
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
+
+#endif  // __RAW_BUFFER_H_
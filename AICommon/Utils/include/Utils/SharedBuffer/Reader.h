@@ -13,6 +13,9 @@
 #ifndef __READER_BUFFER_H_
 #define __READER_BUFFER_H_
 
+#include <chrono>
+#include <sys/types.h>
+
 #include <Utils/SharedBuffer/BufferLayout.h>
 #include <Utils/SharedBuffer/ReaderPolicy.h>
 
@@ -58,6 +61,25 @@ public:
     };
 
 
+    /// A read-only view of a contiguous run of words inside the circular data.
+    struct Span {
+        /// Pointer to the first byte of the run.
+        const uint8_t* data;
+        /// The number of @c wordSize words in the run.
+        size_t nWords;
+    };
+
+    /**
+     * The readable data returned by @c peek().  When the data wraps around the end of the circular buffer it is
+     * split in two; otherwise @c second is empty.
+     */
+    struct Spans {
+        /// The words from the @c Reader's cursor up to the wrap point.
+        Span first;
+        /// The words after the wrap point, if any.
+        Span second;
+    };
+
     /**
      * Constructs a new @c Reader.
      *
@@ -82,6 +104,42 @@ public:
      */
 	ssize_t read(void* buf, size_t nWords, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
 
+    /**
+     * This function exposes unconsumed data in place, without copying it or moving the @c Reader.  The views point
+     * straight into the ring and stay valid until the @c Writer laps them, so a caller should finish with them
+     * promptly and then call @c consume(), which reports @c Error::OVERRUN if the data was overwritten meanwhile.
+     *
+     * @param[out] spans The views of the readable data.
+     * @param nWords The maximum number of @c wordSize words to expose.
+     * @param timeout The maximum time to wait (if @c policy is @c BLOCKING) for data.  If this parameter is zero,
+     *     there is no timeout and blocking peeks will wait forever.
+     * @return The number of @c wordSize words exposed across both spans, or zero if the stream has closed, or a
+     *     negative @c Error code if the stream is still open, but no data is available.
+     */
+    ssize_t peek(Spans* spans, size_t nWords, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    /**
+     * This function releases words previously exposed by @c peek() and advances the @c Reader past them.
+     *
+     * @param nWords The number of @c wordSize words to consume.  This must not exceed what @c peek() returned.
+     * @return @c nWords on success, @c Error::OVERRUN if the @c Writer overwrote the data while it was being
+     *     accessed, or @c Error::INVALID if @c nWords reaches beyond the written data.
+     */
+    ssize_t consume(size_t nWords);
+
+    /**
+     * This function waits until at least @c nWords words are readable, without reading them.  It lets a consumer
+     * which works in batches sleep until a whole batch is there instead of waking for every write.
+     *
+     * @param nWords The number of @c wordSize words to wait for.  Words past the close index are not waited for.
+     * @param timeout The maximum time to wait (if @c policy is @c BLOCKING).  If this parameter is zero, there is no
+     *     timeout and the wait may last forever.
+     * @return The number of readable words, which is less than @c nWords if the timeout expired, the policy is
+     *     @c NONBLOCKING or the writer closed; zero if the stream has closed, or a negative @c Error code if the
+     *     stream is still open, but no data is available.
+     */
+    ssize_t wait(size_t nWords, std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
     /**
      * This function moves the @c Reader to the specified location in the stream. 
      *
@@ -123,6 +181,24 @@ public:
     static std::string errorToString(Error error);
 #endif	
 private:
+    /**
+     * This function waits (according to @c m_policy) until there are @c minWords words after the @c Reader's cursor.
+     *
+     * @param minWords The number of words to wait for; at least one.
+     * @param timeout The maximum time to wait for a @c BLOCKING @c Reader; zero waits forever.
+     * @return The number of readable words (fewer than @c minWords on timeout), or zero if the stream has closed, or
+     *     a negative @c Error code.
+     */
+    ssize_t waitForData(size_t minWords, std::chrono::milliseconds timeout);
+
+    /**
+     * This function checks whether the data at the @c Reader's cursor has been overwritten.
+     *
+     * @param writeCursor The @c Writer cursor to compare against.
+     * @return @c true if the data at the cursor is no longer valid, else @c false.
+     */
+    bool isOverrun(BufferLayout::Index writeCursor) const;
+
 	/// The @c Policy to use for writing to the stream.
     Policy m_policy;
 	
@@ -23,7 +23,7 @@ namespace sharedbuffer {
 	
 class SharedBuffer {
 public:
-	using Buffer = std::vector<uint8_t>;
+	using Buffer = BufferLayout::Buffer;
 	using Index = uint64_t;
 
     static std::unique_ptr<SharedBuffer> create(
@@ -31,6 +31,16 @@ public:
     size_t wordSize = 1,
     size_t maxReaders = 1);
 
+    /**
+     * This function attaches to a @c Buffer which already holds a @c SharedBuffer, typically one created by another
+     * process in shared memory (see @c SharedMemoryBuffer).  The attached instance can create @c Readers (and a
+     * @c Writer, if none is enabled) exactly like the one returned by @c create().
+     *
+     * @param buffer The @c Buffer which holds an initialized @c SharedBuffer.
+     * @return A @c SharedBuffer on success, or @c nullptr if @c buffer does not hold a compatible layout.
+     */
+    static std::unique_ptr<SharedBuffer> open(std::shared_ptr<Buffer> buffer);
+
 	static size_t calculateBufferSize(size_t nWords, size_t wordSize = 1, size_t maxReaders = 1);
 
 	/**
@@ -87,7 +97,7 @@ private:
         Reader::Policy policy,
         bool startWithNewData,
         bool forceReplacement,
-        std::unique_lock<std::mutex>* lock);
+        std::unique_lock<BufferLayout::Mutex>* lock);
 	
     /// The @c BufferLayout of the shared buffer.
     std::shared_ptr<BufferLayout> m_bufferLayout;
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __SHARED_MEMORY_BUFFER_H_
+#define __SHARED_MEMORY_BUFFER_H_
+
+#include <memory>
+#include <string>
+
+#include <Utils/SharedBuffer/RawBuffer.h>
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+/**
+ * Factory for @c RawBuffers backed by memory which can be mapped into several processes, so that a
+ * @c SharedBuffer created in one process can be opened with @c SharedBuffer::open() in another.
+ *
+ * The creating process calls @c SharedBuffer::create() on the returned buffer; every other process maps the same
+ * memory and calls @c SharedBuffer::open().  Each mapping is unmapped when its @c RawBuffer is destroyed.
+ *
+ * @note A reader process which dies without destroying its @c Reader keeps its reader slot enabled.  With a
+ * @c BLOCKING writer that stale cursor will eventually hold the writer back, so such deployments should prefer
+ * a @c NONBLOCKABLE writer (as the microphone does).
+ */
+class SharedMemoryBuffer {
+public:
+    /**
+     * Creates a new named POSIX shared memory object and maps it.
+     *
+     * @param name The object name, e.g. "/aisdk-mic".  Creation fails if the name is already in use.
+     * @param size The size (in bytes), normally from @c SharedBuffer::calculateBufferSize().
+     * @return The mapped buffer, or @c nullptr on failure.
+     */
+    static std::shared_ptr<RawBuffer> create(const std::string& name, size_t size);
+
+    /**
+     * Maps an existing named POSIX shared memory object.
+     *
+     * @param name The object name passed to @c create().
+     * @return The mapped buffer, or @c nullptr on failure.
+     */
+    static std::shared_ptr<RawBuffer> open(const std::string& name);
+
+    /**
+     * Removes a named object.  Existing mappings stay valid until they are released.
+     *
+     * @param name The object name passed to @c create().
+     * @return @c true if the name was removed, @c false if it did not exist or could not be removed.
+     */
+    static bool remove(const std::string& name);
+
+    /**
+     * Creates an anonymous memory file (memfd) and maps it.  The descriptor can be handed to a child process
+     * (inherited across @c fork()/@c exec() or sent over a unix socket) which maps it with @c openFd().
+     *
+     * @param size The size (in bytes).
+     * @param[out] fd Receives the descriptor; the caller owns it and closes it when no longer needed.
+     * @return The mapped buffer, or @c nullptr on failure or if memfd is not supported.
+     */
+    static std::shared_ptr<RawBuffer> createAnonymous(size_t size, int* fd);
+
+    /**
+     * Maps a descriptor from @c createAnonymous() (or any other shareable memory descriptor).
+     *
+     * @param fd The descriptor.  It is not closed by this function.
+     * @return The mapped buffer, or @c nullptr on failure.
+     */
+    static std::shared_ptr<RawBuffer> openFd(int fd);
+};
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
+
+#endif  // __SHARED_MEMORY_BUFFER_H_
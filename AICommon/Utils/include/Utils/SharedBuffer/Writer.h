@@ -13,6 +13,9 @@
 #ifndef __WRITER_BUFFER_H_
 #define __WRITER_BUFFER_H_
 
+#include <chrono>
+#include <sys/types.h>
+
 #include <Utils/SharedBuffer/BufferLayout.h>
 #include <Utils/SharedBuffer/WriterPolicy.h>
 
@@ -15,25 +15,35 @@
 #define _THREADING_EXECUTOR_H_
 
 #include <future>
+#include <memory>
 #include <utility>
 
 #include "TaskThread.h"
 #include "TaskQueue.h"
+#include "WorkerPool.h"
 
 namespace aisdk {
 namespace utils {
 namespace threading {
 
 /**
- * An Executor is used to run callable types asynchronously.
+ * An Executor is used to run callable types asynchronously. Tasks run one at a time, in the order they were
+ * submitted, either on a thread of the Executor's own or on a strand of a shared @c WorkerPool.
  */
 class Executor {
 public:
     /**
-     * Constructs an Executor.
+     * Constructs an Executor on the @c WorkerPool::getDefault() pool, or on its own thread if there is none.
      */
     Executor();
 
+    /**
+     * Constructs an Executor on the given pool.
+     *
+     * @param pool The pool to run tasks on, or @c nullptr to run them on a thread of the Executor's own.
+     */
+    explicit Executor(std::shared_ptr<WorkerPool> pool);
+
     /**
      * Destructs an Executor.
      */
@@ -61,6 +71,27 @@ public:
     template <typename Task, typename... Args>
     auto submitToFront(Task task, Args&&... args) -> std::future<decltype(task(args...))>;
 
+    /**
+     * Runs a callable type on the Executor without creating a future for its result, which @c submit() allocates
+     * for every task.  Use it for the fire-and-forget notifications which make up most of the traffic.
+     *
+     * @param task A callable type representing a task; its result and anything it throws are discarded.
+     * @param args The arguments to call the task with.
+     * @returns @c true if the task was queued, or @c false if the Executor is shutdown.
+     */
+    template <typename Task, typename... Args>
+    bool execute(Task task, Args&&... args);
+
+    /**
+     * Like @c execute(), but queues the task at the front, as @c submitToFront() does.
+     *
+     * @param task A callable type representing a task; its result and anything it throws are discarded.
+     * @param args The arguments to call the task with.
+     * @returns @c true if the task was queued, or @c false if the Executor is shutdown.
+     */
+    template <typename Task, typename... Args>
+    bool executeToFront(Task task, Args&&... args);
+
     /**
      * Wait for any previously submitted tasks to complete.
      */
@@ -76,7 +107,7 @@ private:
     /// The queue of tasks to execute.
     std::shared_ptr<TaskQueue> m_taskQueue;
 
-    /// The thread to execute tasks on.
+    /// The thread to execute tasks on, or @c nullptr when a @c WorkerPool runs them.
     std::unique_ptr<TaskThread> m_taskThread;
 };
 
@@ -90,6 +121,16 @@ auto Executor::submitToFront(Task task, Args&&... args) -> std::future<decltype(
     return m_taskQueue->pushToFront(task, std::forward<Args>(args)...);
 }
 
+template <typename Task, typename... Args>
+bool Executor::execute(Task task, Args&&... args) {
+    return m_taskQueue->pushTask(false, InlineTask(std::bind(std::move(task), std::forward<Args>(args)...)));
+}
+
+template <typename Task, typename... Args>
+bool Executor::executeToFront(Task task, Args&&... args) {
+    return m_taskQueue->pushTask(true, InlineTask(std::bind(std::move(task), std::forward<Args>(args)...)));
+}
+
 }  // namespace threading
 }  // namespace utils
 }	  // namespace aisdk
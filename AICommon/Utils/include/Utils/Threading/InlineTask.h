@@ -0,0 +1,218 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef _THREADING_INLINE_TASK_H_
+#define _THREADING_INLINE_TASK_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace aisdk {
+namespace utils {
+namespace threading {
+
+/**
+ * A move-only @c void() callable, like @c std::function<void()> but keeping callables of up to @c INLINE_SIZE bytes
+ * in the object itself.  The lambdas components submit to their @c Executor (a @c this pointer, a couple of
+ * @c shared_ptr and a string or two) fit, so queuing one costs no heap allocation; larger ones are moved to the heap.
+ */
+class InlineTask {
+public:
+    /// The largest callable kept inline.
+    static const size_t INLINE_SIZE = 96;
+
+    /**
+     * Constructs an empty task.
+     */
+    InlineTask() : m_ops{nullptr} {
+    }
+
+    /**
+     * Constructs a task holding a callable.
+     *
+     * @param callable A callable with no arguments; its result, if any, is discarded.
+     */
+    template <
+        typename Callable,
+        typename = typename std::enable_if<
+            !std::is_same<typename std::decay<Callable>::type, InlineTask>::value>::type>
+    InlineTask(Callable&& callable);
+
+    /**
+     * Move constructor.  @c other is left empty.
+     */
+    InlineTask(InlineTask&& other) noexcept;
+
+    /**
+     * Move assignment.  @c other is left empty.
+     */
+    InlineTask& operator=(InlineTask&& other) noexcept;
+
+    /**
+     * Destructor.
+     */
+    ~InlineTask();
+
+    /// Returns whether the task holds a callable.
+    explicit operator bool() const {
+        return m_ops != nullptr;
+    }
+
+    /// Runs the callable.  The task must not be empty.
+    void operator()() {
+        m_ops->invoke(&m_storage);
+    }
+
+    /// Destroys the callable, leaving the task empty.
+    void reset();
+
+    /// Returns whether the callable is kept inline rather than on the heap.
+    bool isInline() const {
+        return m_ops && m_ops->isInline;
+    }
+
+private:
+    InlineTask(const InlineTask&) = delete;
+    InlineTask& operator=(const InlineTask&) = delete;
+
+    /// Room for an inline callable, with the strictest alignment of any fundamental type.
+    using Storage = std::aligned_storage<INLINE_SIZE>::type;
+
+    /// The operations on the stored callable.
+    struct Ops {
+        /// Calls the callable.
+        void (*invoke)(void* storage);
+        /// Move constructs the callable into @c to and destroys the one in @c from.
+        void (*relocate)(void* from, void* to);
+        /// Destroys the callable.
+        void (*destroy)(void* storage);
+        /// Whether the callable lives in the storage itself.
+        bool isInline;
+    };
+
+    /// Operations for a callable of type @c Callable kept in the storage.
+    template <typename Callable>
+    struct InlineOps {
+        static void invoke(void* storage) {
+            (*static_cast<Callable*>(storage))();
+        }
+        static void relocate(void* from, void* to) {
+            new (to) Callable(std::move(*static_cast<Callable*>(from)));
+            static_cast<Callable*>(from)->~Callable();
+        }
+        static void destroy(void* storage) {
+            static_cast<Callable*>(storage)->~Callable();
+        }
+        static const Ops ops;
+    };
+
+    /// Operations for a callable of type @c Callable on the heap, with the storage holding a pointer to it.
+    template <typename Callable>
+    struct HeapOps {
+        static void invoke(void* storage) {
+            (**static_cast<Callable**>(storage))();
+        }
+        static void relocate(void* from, void* to) {
+            *static_cast<Callable**>(to) = *static_cast<Callable**>(from);
+        }
+        static void destroy(void* storage) {
+            delete *static_cast<Callable**>(storage);
+        }
+        static const Ops ops;
+    };
+
+    /// Whether a callable of type @c Callable may be kept inline.
+    template <typename Callable>
+    struct FitsInline
+            : std::integral_constant<
+                  bool,
+                  sizeof(Callable) <= INLINE_SIZE && alignof(Callable) <= alignof(Storage) &&
+                      std::is_nothrow_move_constructible<Callable>::value> {};
+
+    /// Stores a callable which fits inline.
+    template <typename Callable, typename Arg>
+    void store(Arg&& callable, std::true_type) {
+        new (&m_storage) Callable(std::forward<Arg>(callable));
+        m_ops = &InlineOps<Callable>::ops;
+    }
+
+    /// Stores a callable which does not fit inline.
+    template <typename Callable, typename Arg>
+    void store(Arg&& callable, std::false_type) {
+        *reinterpret_cast<Callable**>(&m_storage) = new Callable(std::forward<Arg>(callable));
+        m_ops = &HeapOps<Callable>::ops;
+    }
+
+    /// The operations on the stored callable, or @c nullptr if the task is empty.
+    const Ops* m_ops;
+
+    /// The callable, or a pointer to it.
+    Storage m_storage;
+};
+
+template <typename Callable>
+const InlineTask::Ops InlineTask::InlineOps<Callable>::ops = {&InlineOps<Callable>::invoke,
+                                                              &InlineOps<Callable>::relocate,
+                                                              &InlineOps<Callable>::destroy,
+                                                              true};
+
+template <typename Callable>
+const InlineTask::Ops InlineTask::HeapOps<Callable>::ops = {&HeapOps<Callable>::invoke,
+                                                            &HeapOps<Callable>::relocate,
+                                                            &HeapOps<Callable>::destroy,
+                                                            false};
+
+template <typename Callable, typename>
+InlineTask::InlineTask(Callable&& callable) : m_ops{nullptr} {
+    using Stored = typename std::decay<Callable>::type;
+    store<Stored>(std::forward<Callable>(callable), FitsInline<Stored>());
+}
+
+inline InlineTask::InlineTask(InlineTask&& other) noexcept : m_ops{other.m_ops} {
+    if (m_ops) {
+        m_ops->relocate(&other.m_storage, &m_storage);
+        other.m_ops = nullptr;
+    }
+}
+
+inline InlineTask& InlineTask::operator=(InlineTask&& other) noexcept {
+    if (this != &other) {
+        reset();
+        if (other.m_ops) {
+            other.m_ops->relocate(&other.m_storage, &m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+    return *this;
+}
+
+inline InlineTask::~InlineTask() {
+    reset();
+}
+
+inline void InlineTask::reset() {
+    if (m_ops) {
+        auto ops = m_ops;
+        m_ops = nullptr;
+        ops->destroy(&m_storage);
+    }
+}
+
+}  // namespace threading
+}  // namespace utils
+}  // namespace aisdk
+
+#endif  // _THREADING_INLINE_TASK_H_
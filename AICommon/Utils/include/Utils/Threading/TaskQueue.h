@@ -16,12 +16,16 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
+
+#include "InlineTask.h"
 
 namespace aisdk {
 namespace utils {
@@ -57,16 +61,46 @@ public:
 	template <typename Task, typename... Args>
 	auto pushToFront(Task task, Args&&... args) -> std::future<decltype(task(args...))>;
 
+    /**
+     * Pushes a task whose result nobody waits for.  Unlike @c push(), no future is created, so a task which fits in an
+     * @c InlineTask is queued without any heap allocation.
+     *
+     * @param front If @c true, push to the front of the queue, else push to the back.
+     * @param task The task; anything it throws is discarded.
+     * @returns @c true if the task was queued, or @c false if the queue is shutdown.
+     */
+    bool pushTask(bool front, InlineTask task);
+
     /**
      * Returns and removes the task at the front of the queue. If there are no tasks, this call will block until there
      * is one.
      *
-     * @returns A task which the caller assumes ownership of, or @c nullptr if the TaskQueue expects no more tasks.
+     * @returns A task which the caller assumes ownership of, or an empty task if the TaskQueue expects no more tasks.
+     */
+    InlineTask pop();
+
+    /**
+     * Makes this queue a strand of a @c WorkerPool instead of the queue of a dedicated @c TaskThread.  Rather than
+     * waiting in @c pop(), the owner is told through @c onReady whenever a task arrives at an idle queue, and then
+     * calls @c runStrand() from one of its threads.  Must be called before the first task is pushed.
+     *
+     * @param onReady Called, without the queue lock held, each time the queue goes from idle to scheduled.
+     */
+    void setReadyCallback(std::function<void()> onReady);
+
+    /**
+     * Runs tasks of a strand in the order they were queued.  The queue stays scheduled while this runs, so no other
+     * thread runs it at the same time and tasks never overlap.
+     *
+     * @param maxTasks The most tasks to run before giving the thread back.
+     * @returns @c true if tasks remain and the queue is still scheduled, so the caller must call @c runStrand() again
+     * later; @c false if the queue went idle and the next push will call the ready callback again.
      */
-    std::unique_ptr<std::function<void()>> pop();
+    bool runStrand(size_t maxTasks);
 
     /**
-     * Clears the queue .
+     * Clears the queue. For a strand, also waits for the task running on a pool thread, if any, to return, unless
+     * it is that task calling.
      */
     void shutdown();
 
@@ -78,8 +112,8 @@ public:
     bool isShutdown();
 
 private:
-    /// Define the queue type alias.
-    using Queue = std::deque<std::unique_ptr<std::function<void()>>>;
+    /// The initial number of slots of the ring; it doubles whenever it fills up.
+    static const size_t INITIAL_CAPACITY = 16;
 
     /**
      * Pushes a task on the the queue.
@@ -92,8 +126,22 @@ private:
     template <typename Task, typename... Args>
     auto pushTo(bool front, Task task, Args&&... args) -> std::future<decltype(task(args...))>;
 
-    /// The queue of tasks
-    Queue m_queue;
+    /**
+     * Removes the task at the front of the ring.  @c m_queueMutex must be held and the ring must not be empty.
+     *
+     * @returns The task.
+     */
+    InlineTask takeFrontLocked();
+
+    /// The queue of tasks, a ring of @c m_queueSize tasks starting at @c m_queueHead.  Slots are reused, so once it
+    /// has grown to the largest backlog seen, queuing a task no longer allocates.
+    std::vector<InlineTask> m_queue;
+
+    /// The slot of the task at the front of the ring.
+    size_t m_queueHead;
+
+    /// The number of tasks in the ring.
+    size_t m_queueSize;
 
     /// A condition variable to wait for new tasks to be placed on the queue.
     std::condition_variable m_queueChanged;
@@ -103,6 +151,15 @@ private:
 
     /// A flag for whether or not the queue is expecting more tasks.
     std::atomic_bool m_shutdown;
+
+    /// For a strand, notifies the @c WorkerPool that the queue has work; empty for a @c TaskThread queue.
+    std::function<void()> m_onReady;
+
+    /// Whether a strand is waiting in, or running from, the pool's ready list.
+    bool m_strandScheduled;
+
+    /// The pool thread running a task of this strand, or a default id when none is.
+    std::thread::id m_strandRunner;
 };
 
 template <typename Task, typename... Args>
@@ -118,70 +175,76 @@ auto TaskQueue::pushToFront(Task task, Args&&... args) -> std::future<decltype(t
 }
 
 /**
- * Waits for a @c std::future to be fulfilled and forward the result to a @c std::promise.
- *
- * @param promise The @c std::promise to fulfill when @c future is fulfilled.
- * @param future The @c std::future on which to wait for a result to forward to @c promise.
+ * A queued task which fulfils a @c std::promise with the result of a callable.  The callable, and everything it
+ * captured, is destroyed before the promise is fulfilled, so whoever waits on the future may rely on it being gone.
  */
-template <typename T>
-inline static void forwardPromise(std::shared_ptr<std::promise<T>> promise, std::future<T>* future) {
-    promise->set_value(future->get());
-}
+template <typename Callable, typename Result>
+class PromiseTask {
+public:
+    /**
+     * Constructor.
+     *
+     * @param callable The callable to run.
+     * @param promise The promise to fulfil with its result.
+     */
+    PromiseTask(Callable&& callable, std::promise<Result>&& promise) :
+            m_callable(std::move(callable)),
+            m_promise(std::move(promise)) {
+    }
 
-/**
- * Template <forwardPromise> function specialization.
- * Specialization of @c forwardPromise() for @c void types.
- *
- * @param promise The @c std::promise to fulfill when @c future is fulfilled.
- * @param future The @c std::future on which to wait before fulfilling @c promise.
- */
-template <>
-inline void forwardPromise<void>(std::shared_ptr<std::promise<void>> promise, std::future<void>* future) {
-    future->get();
-    promise->set_value();
-}
+    /// Runs the callable and fulfils the promise.
+    void operator()() {
+        try {
+            fulfil(std::is_void<Result>());
+        } catch (...) {
+            m_promise.set_exception(std::current_exception());
+        }
+    }
+
+private:
+    /**
+     * Runs the callable moved out of @c m_callable, so it is destroyed on return.
+     *
+     * @returns The result of the callable.
+     */
+    Result consume() {
+        Callable callable(std::move(m_callable));
+        return callable();
+    }
+
+    /// Fulfils the promise with the result of a non-void callable.
+    void fulfil(std::false_type) {
+        Result result = consume();
+        m_promise.set_value(std::move(result));
+    }
+
+    /// Fulfils the promise of a void callable.
+    void fulfil(std::true_type) {
+        consume();
+        m_promise.set_value();
+    }
+
+    /// The callable to run.
+    Callable m_callable;
+
+    /// The promise to fulfil.
+    std::promise<Result> m_promise;
+};
 
 template <typename Task, typename... Args>
 auto TaskQueue::pushTo(bool front, Task task, Args&&... args) -> std::future<decltype(task(args...))> {
+    using FutureType = decltype(task(args...));
+
     // Binding the arguments to the task.
     auto bindTask = std::bind(std::forward<Task>(task), std::forward<Args>(args)...);
-	
-    using PackagedTaskType = std::packaged_task<decltype(bindTask())()>;
-    auto packaged_task = std::make_shared<PackagedTaskType>(bindTask);
-
-    // Create a promise/future to achieve async that we will notify when we have cleaned up the task.
-    auto cleanupPromise = std::make_shared<std::promise<decltype(task(args...))>>();
-    auto cleanupFuture = cleanupPromise->get_future();
-
-    // Remove the return type from the task by wrapping it in a lambda with no return value.
-    auto translated_task = [packaged_task, cleanupPromise]() mutable {
-        // Execute the task.
-        packaged_task->operator()();
-        // Note the future for the task's result.
-        auto taskFuture = packaged_task->get_future();
-        // Clean up the task.
-        packaged_task.reset();
-        // Forward the task's result to our cleanup promise/future.
-        forwardPromise(cleanupPromise, &taskFuture);
-    };
-
-    packaged_task.reset();
-
-    {
-        std::lock_guard<std::mutex> queueLock{m_queueMutex};
-        if (!m_shutdown) {
-			// Inplace a task to taskqueue
-            m_queue.emplace(front ? m_queue.begin() : m_queue.end(), new std::function<void()>(translated_task));
-        } else {
-        	// The queue is shutdown and return an invaild @c future
-            using FutureType = decltype(task(args...));
-            return std::future<FutureType>();
-        }
-    }
 
-	// Notify pop a new task come in
-    m_queueChanged.notify_all();
-    return cleanupFuture;
+    std::promise<FutureType> promise;
+    auto future = promise.get_future();
+    if (!pushTask(front, PromiseTask<decltype(bindTask), FutureType>(std::move(bindTask), std::move(promise)))) {
+        // The queue is shutdown and return an invaild @c future
+        return std::future<FutureType>();
+    }
+    return future;
 }
 
 }  // namespace threading
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef _THREADING_WORKER_POOL_H_
+#define _THREADING_WORKER_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "TaskQueue.h"
+
+namespace aisdk {
+namespace utils {
+namespace threading {
+
+/**
+ * A fixed set of threads shared by many @c Executor objects.  Each @c Executor gets its own strand, a @c TaskQueue
+ * which the pool runs on at most one thread at a time, so tasks submitted to one @c Executor still run one after
+ * another in submission order, while idle executors no longer cost a thread each.
+ *
+ * Strands with work wait in a FIFO ready list; a thread runs a few tasks of one strand and then puts it back at the
+ * end of the list if it still has work, so a busy component cannot starve the others.
+ *
+ * Strands only hold a weak reference to their pool; whoever creates the pool keeps it alive for as long as its
+ * executors should run, and must not release it from one of the pool's own threads.
+ */
+class WorkerPool : public std::enable_shared_from_this<WorkerPool> {
+public:
+    /**
+     * Creates a pool and starts its threads.
+     *
+     * @param numThreads The number of threads, at least 1.
+     * @return The pool, or @c nullptr if @c numThreads is 0.
+     */
+    static std::shared_ptr<WorkerPool> create(size_t numThreads);
+
+    /**
+     * Sets the pool which @c Executor objects constructed from now on will run on.  Executors which already exist
+     * keep running where they are.
+     *
+     * @param pool The pool, or @c nullptr to go back to one thread per @c Executor.
+     */
+    static void setDefault(std::shared_ptr<WorkerPool> pool);
+
+    /**
+     * Returns the pool set by @c setDefault().
+     *
+     * @return The pool, or @c nullptr if executors get their own threads.
+     */
+    static std::shared_ptr<WorkerPool> getDefault();
+
+    /**
+     * Stops the threads, after the tasks they are running return.  Strands still waiting for a thread, and any which
+     * get work later, are shut down: their queued tasks are dropped without running and later submissions are
+     * rejected, as for an @c Executor which was shut down.
+     */
+    ~WorkerPool();
+
+    /**
+     * Creates a new strand run by this pool.
+     *
+     * @return A @c TaskQueue in strand mode.
+     */
+    std::shared_ptr<TaskQueue> createStrand();
+
+    /**
+     * Returns the number of threads of the pool.
+     *
+     * @return The number of threads.
+     */
+    size_t getNumThreads() const;
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param numThreads The number of threads to start.
+     */
+    explicit WorkerPool(size_t numThreads);
+
+    /**
+     * Adds a strand with work to the back of the ready list, or shuts it down if the pool is shutting down.
+     *
+     * @param strand The strand.
+     */
+    void schedule(std::shared_ptr<TaskQueue> strand);
+
+    /**
+     * Runs ready strands until the pool is destroyed.
+     */
+    void workerLoop();
+
+    /// Protects @c m_ready and @c m_shutdown.
+    std::mutex m_mutex;
+
+    /// Wakes a thread when a strand becomes ready or the pool is destroyed.
+    std::condition_variable m_wakeTrigger;
+
+    /// Strands with work, in the order they became ready.
+    std::deque<std::shared_ptr<TaskQueue>> m_ready;
+
+    /// Whether the threads should exit.
+    bool m_shutdown;
+
+    /// The threads of the pool.
+    std::vector<std::thread> m_threads;
+};
+
+}  // namespace threading
+}  // namespace utils
+}  // namespace aisdk
+
+#endif  // _THREADING_WORKER_POOL_H_
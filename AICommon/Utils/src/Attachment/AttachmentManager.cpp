@@ -0,0 +1,99 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <vector>
+
+#include "Utils/Attachment/AttachmentManager.h"
+#include "Utils/Attachment/InProcessAttachment.h"
+#include "Utils/Logging/Logger.h"
+#include "Utils/Threading/Memory.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("AttachmentManager");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace attachment {
+
+constexpr std::chrono::minutes AttachmentManager::ATTACHMENT_MANAGER_TIMOUT_MINUTES_DEFAULT;
+
+AttachmentManager::AttachmentManagementDocker::AttachmentManagementDocker() :
+        creationTime{std::chrono::steady_clock::now()} {
+}
+
+AttachmentManager::AttachmentManager() : m_attachmentExpirationMinutes{ATTACHMENT_MANAGER_TIMOUT_MINUTES_DEFAULT} {
+}
+
+AttachmentManager::AttachmentManagementDocker& AttachmentManager::getDockersLocked(const std::string& attachmentId) {
+    auto& docker = m_attachmentDockersMap[attachmentId];
+    if (!docker.attachment) {
+        docker.attachment = memory::make_unique<InProcessAttachment>(attachmentId);
+    }
+    return docker;
+}
+
+std::unique_ptr<AttachmentWriter> AttachmentManager::createWriter(
+    const std::string& attachmentId,
+    utils::sharedbuffer::WriterPolicy policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& docker = getDockersLocked(attachmentId);
+    if (!docker.attachment) {
+        AISDK_ERROR(LX("createWriterFailed").d("reason", "attachmentIsNull").d("attachmentId", attachmentId));
+        return nullptr;
+    }
+    auto writer = docker.attachment->createWriter(policy);
+    removeExpiredAttachmentsLocked();
+    return writer;
+}
+
+std::unique_ptr<AttachmentReader> AttachmentManager::createReader(
+    const std::string& attachmentId,
+    utils::sharedbuffer::ReaderPolicy policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto& docker = getDockersLocked(attachmentId);
+    if (!docker.attachment) {
+        AISDK_ERROR(LX("createReaderFailed").d("reason", "attachmentIsNull").d("attachmentId", attachmentId));
+        return nullptr;
+    }
+    auto reader = docker.attachment->createReader(policy);
+    removeExpiredAttachmentsLocked();
+    return reader;
+}
+
+void AttachmentManager::removeExpiredAttachmentsLocked() {
+    std::vector<std::string> idsToErase;
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto& iter : m_attachmentDockersMap) {
+        auto& docker = iter.second;
+        auto attachmentLifetime = std::chrono::duration_cast<std::chrono::minutes>(now - docker.creationTime);
+        if ((attachmentLifetime > m_attachmentExpirationMinutes) ||
+            (docker.attachment->hasCreatedReader() && docker.attachment->hasCreatedWriter())) {
+            idsToErase.push_back(iter.first);
+        }
+    }
+
+    for (auto& id : idsToErase) {
+        m_attachmentDockersMap.erase(id);
+    }
+}
+
+}  // namespace attachment
+}  // namespace utils
+}  // namespace aisdk
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "Utils/Attachment/InProcessAttachment.h"
+#include "Utils/Logging/Logger.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("InProcessAttachment");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace attachment {
+
+InProcessAttachment::InProcessAttachment(const std::string& id, std::unique_ptr<SDSType> sds) :
+        Attachment(id),
+        m_sds{std::move(sds)} {
+    if (!m_sds) {
+        auto buffSize = SDSType::calculateBufferSize(SDS_BUFFER_DEFAULT_SIZE_IN_BYTES);
+        auto buff = std::make_shared<SDSBufferType>(buffSize);
+        m_sds = SDSType::create(buff);
+    }
+}
+
+std::unique_ptr<AttachmentWriter> InProcessAttachment::createWriter(InProcessAttachmentWriter::SDSTypeWriter::Policy policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_hasCreatedWriter) {
+        AISDK_ERROR(LX("createWriterFailed").d("reason", "already created writer").d("attachmentId", getId()));
+        return nullptr;
+    }
+
+    auto writer = InProcessAttachmentWriter::create(m_sds, policy);
+    if (!writer) {
+        AISDK_ERROR(LX("createWriterFailed").d("reason", "could not create writer").d("attachmentId", getId()));
+        return nullptr;
+    }
+
+    m_hasCreatedWriter = true;
+    return std::move(writer);
+}
+
+std::unique_ptr<AttachmentReader> InProcessAttachment::createReader(InProcessAttachmentReader::SDSTypeReader::Policy policy) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto reader = InProcessAttachmentReader::create(policy, m_sds);
+    if (!reader) {
+        AISDK_ERROR(LX("createReaderFailed").d("reason", "could not create reader").d("attachmentId", getId()));
+        return nullptr;
+    }
+
+    m_hasCreatedReader = true;
+    return std::move(reader);
+}
+
+}  // namespace attachment
+}  // namespace utils
+}  // namespace aisdk
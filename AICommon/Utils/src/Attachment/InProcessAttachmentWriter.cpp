@@ -0,0 +1,130 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "Utils/Attachment/InProcessAttachmentWriter.h"
+#include "Utils/Logging/Logger.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("InProcessAttachmentWriter");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace attachment {
+
+std::unique_ptr<InProcessAttachmentWriter> InProcessAttachmentWriter::create(
+    std::shared_ptr<SDSType> sds,
+    SDSTypeWriter::Policy policy) {
+    auto writer = std::unique_ptr<InProcessAttachmentWriter>(new InProcessAttachmentWriter(sds, policy));
+    if (!writer->m_writer) {
+        AISDK_ERROR(LX("createFailed").d("reason", "object not fully created"));
+        return nullptr;
+    }
+
+    return writer;
+}
+
+InProcessAttachmentWriter::InProcessAttachmentWriter(std::shared_ptr<SDSType> sds, SDSTypeWriter::Policy policy) {
+    if (!sds) {
+        AISDK_ERROR(LX("ConstructorFailed").d("reason", "SDS parameter is nullptr"));
+        return;
+    }
+
+    m_writer = sds->createWriter(policy);
+
+    if (!m_writer) {
+        AISDK_ERROR(LX("ConstructorFailed").d("reason", "could not create an SDS writer"));
+    }
+}
+
+InProcessAttachmentWriter::~InProcessAttachmentWriter() {
+    close();
+}
+
+std::size_t InProcessAttachmentWriter::write(
+    const void* buf,
+    std::size_t numBytes,
+    WriteStatus* writeStatus,
+    std::chrono::milliseconds timeout) {
+    if (!writeStatus) {
+        AISDK_ERROR(LX("writeFailed").d("reason", "writeStatus is nullptr"));
+        return 0;
+    }
+
+    if (!m_writer) {
+        AISDK_ERROR(LX("writeFailed").d("reason", "SDS is closed"));
+        *writeStatus = WriteStatus::CLOSED;
+        return 0;
+    }
+
+    if (!buf) {
+        AISDK_ERROR(LX("writeFailed").d("reason", "buf is nullptr"));
+        *writeStatus = WriteStatus::ERROR_INTERNAL;
+        return 0;
+    }
+
+    auto wordSize = m_writer->getWordSize();
+    if (numBytes < wordSize) {
+        AISDK_ERROR(LX("writeFailed").d("reason", "bytes requested smaller than SDS word size"));
+        *writeStatus = WriteStatus::ERROR_BYTES_LESS_THAN_WORD_SIZE;
+        return 0;
+    }
+
+    std::size_t bytesWritten = 0;
+    auto numWords = numBytes / wordSize;
+    auto writeResult = m_writer->write(buf, numWords, timeout);
+
+    *writeStatus = WriteStatus::OK;
+
+    if (writeResult <= 0) {
+        switch (writeResult) {
+            case SDSTypeWriter::Error::CLOSED:
+                *writeStatus = WriteStatus::CLOSED;
+                AISDK_DEBUG0(LX("writeFailed").d("reason", "SDS is closed"));
+                break;
+
+            case SDSTypeWriter::Error::WOULDBLOCK:
+                *writeStatus = WriteStatus::OK_BUFFER_FULL;
+                break;
+
+            case SDSTypeWriter::Error::TIMEDOUT:
+                *writeStatus = WriteStatus::TIMEDOUT;
+                break;
+
+            case SDSTypeWriter::Error::INVALID:
+            default:
+                AISDK_ERROR(LX("writeFailed").d("reason", "unhandled error code").d("code", writeResult));
+                *writeStatus = WriteStatus::ERROR_INTERNAL;
+                break;
+        }
+    } else {
+        bytesWritten = static_cast<std::size_t>(writeResult) * wordSize;
+    }
+
+    return bytesWritten;
+}
+
+void InProcessAttachmentWriter::close() {
+    if (m_writer) {
+        m_writer->close();
+    }
+}
+
+}  // namespace attachment
+}  // namespace utils
+}  // namespace aisdk
@@ -40,7 +40,7 @@ void DialogUXStateRelay::addObserver(
         return;
     }
 	
-    m_executor.submit([this, observer]() {
+    m_executor.execute([this, observer]() {
         m_observers.insert(observer);
         observer->onDialogUXStateChanged(m_currentState);
     });
@@ -60,7 +60,7 @@ void DialogUXStateRelay::onStateChanged(soundai::SoundAiObserverInterface::State
 	
 	// AISDK_INFO(LX("onStateChanged").d("SoundAiNewState", state));
 	
-	m_executor.submit([this, state](){
+	m_executor.execute([this, state](){
 		switch(state){
 			case soundai::SoundAiObserverInterface::State::IDLE:
 //				setState(dialogRelay::DialogUXStateObserverInterface::DialogUXState::IDLE);
@@ -92,13 +92,13 @@ void DialogUXStateRelay::onStateChanged(dmInterface::SpeechSynthesizerObserverIn
 	// AISDK_INFO(LX("onStateChanged").d("SpeechSynth", state));
     m_speechSynthesizerState = state;
 
-    m_executor.submit([this, state]() {
+    m_executor.execute([this, state]() {
         switch (state) {
             case dmInterface::SpeechSynthesizerObserverInterface::SpeechSynthesizerState::PLAYING:
                 setState(DialogUXStateObserverInterface::DialogUXState::SPEAKING);
                 return;
             case dmInterface::SpeechSynthesizerObserverInterface::SpeechSynthesizerState::FINISHED:
-                 m_executor.submit([this]() {
+                 m_executor.execute([this]() {
 			        if (m_currentState != DialogUXStateObserverInterface::DialogUXState::IDLE &&
 			            m_soundAiState == soundai::SoundAiObserverInterface::State::IDLE &&
 			            m_speechSynthesizerState == dmInterface::SpeechSynthesizerObserverInterface::SpeechSynthesizerState::FINISHED) {
@@ -123,7 +123,7 @@ void DialogUXStateRelay::onStateChanged(dmInterface::ResourcesPlayerObserverInte
 	//std::cout << "ResourcesPlayer onStateChanged: " << state << std::endl;
     m_resourcesPlayerState = state;
 #if 0
-    m_executor.submit([this, state]() {
+    m_executor.execute([this, state]() {
         switch (state) {
             case dmInterface::ResourcesPlayerObserverInterface::ResourcesPlayerState::PLAYING:
                 setState(DialogUXStateObserverInterface::DialogUXState::SPEAKING);
@@ -138,7 +138,7 @@ void DialogUXStateRelay::onStateChanged(dmInterface::ResourcesPlayerObserverInte
           //      return;
     #endif       
             case dmInterface::ResourcesPlayerObserverInterface::ResourcesPlayerState::FINISHED:
-                 m_executor.submit([this]() {
+                 m_executor.execute([this]() {
 			        if (m_currentState != DialogUXStateObserverInterface::DialogUXState::IDLE &&
 			            m_soundAiState == soundai::SoundAiObserverInterface::State::IDLE &&
 			            m_resourcesPlayerState == dmInterface::ResourcesPlayerObserverInterface::ResourcesPlayerState::FINISHED) {
@@ -163,13 +163,13 @@ void DialogUXStateRelay::onStateChanged(dmInterface::AlarmsPlayerObserverInterfa
 	//std::cout << "AlarmsPlayer onStateChanged: " << state << std::endl;
     m_alarmsPlayerState = state;
 
-    m_executor.submit([this, state]() {
+    m_executor.execute([this, state]() {
         switch (state) {
             case dmInterface::AlarmsPlayerObserverInterface::AlarmsPlayerState::PLAYING:
                 setState(DialogUXStateObserverInterface::DialogUXState::SPEAKING);
                 return;
             case dmInterface::AlarmsPlayerObserverInterface::AlarmsPlayerState::FINISHED:
-                 m_executor.submit([this]() {
+                 m_executor.execute([this]() {
 			        if (m_currentState != DialogUXStateObserverInterface::DialogUXState::IDLE &&
 			            m_soundAiState == soundai::SoundAiObserverInterface::State::IDLE &&
 			            m_alarmsPlayerState == dmInterface::AlarmsPlayerObserverInterface::AlarmsPlayerState::FINISHED) {
@@ -190,7 +190,7 @@ void DialogUXStateRelay::onStateChanged(dmInterface::AlarmsPlayerObserverInterfa
 
 
 void DialogUXStateRelay::tryEnterIdleState() {
-	m_executor.submit([this]() {
+	m_executor.execute([this]() {
 		// The delay ensures that ASR state is avoided from Thinking to IDLE.
 		usleep(200*1000);
 		if(m_currentState != dialogRelay::DialogUXStateObserverInterface::DialogUXState::IDLE && \
@@ -19,10 +19,17 @@ namespace aisdk {
 namespace utils {
 namespace threading {
 
-Executor::Executor() :
-        m_taskQueue{std::make_shared<TaskQueue>()},
-        m_taskThread{memory::make_unique<TaskThread>(m_taskQueue)} {
-    m_taskThread->start();
+Executor::Executor() : Executor(WorkerPool::getDefault()) {
+}
+
+Executor::Executor(std::shared_ptr<WorkerPool> pool) {
+    if (pool) {
+        m_taskQueue = pool->createStrand();
+    } else {
+        m_taskQueue = std::make_shared<TaskQueue>();
+        m_taskThread = memory::make_unique<TaskThread>(m_taskQueue);
+        m_taskThread->start();
+    }
 }
 
 Executor::~Executor() {
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <cstring>
+#include <string>
+
+#include "Utils/Logging/AsyncLogger.h"
+#include "Utils/Logging/ThreadMoniker.h"
+
+namespace aisdk {
+namespace utils {
+namespace logging {
+
+/// How long the background thread sleeps between rounds when nobody wakes it.
+static const std::chrono::milliseconds DRAIN_INTERVAL(20);
+
+/// The smallest ring, so the half-full wake-up has some room to work with.
+static const size_t MIN_CAPACITY = 8;
+
+std::shared_ptr<AsyncLogger> AsyncLogger::create(std::shared_ptr<Logger> sink, size_t capacity) {
+    if (!sink) {
+        return nullptr;
+    }
+    size_t slots = MIN_CAPACITY;
+    while (slots < capacity) {
+        slots <<= 1;
+    }
+    return std::shared_ptr<AsyncLogger>(new AsyncLogger(std::move(sink), slots));
+}
+
+AsyncLogger::AsyncLogger(std::shared_ptr<Logger> sink, size_t capacity) :
+        Logger(sink->getLevel()),
+        m_sink{std::move(sink)},
+        m_ring(capacity),
+        m_mask{capacity - 1},
+        m_enqueuePos{0},
+        m_dequeuePos{0},
+        m_dropped{0},
+        m_droppedReported{0},
+        m_wakeRequested{false},
+        m_stopping{false} {
+    for (size_t i = 0; i < capacity; ++i) {
+        m_ring[i].sequence.store(i, std::memory_order_relaxed);
+        m_ring[i].longText = nullptr;
+    }
+    m_thread = std::thread(&AsyncLogger::consumeLoop, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wakeTrigger.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void AsyncLogger::setLevel(Level level) {
+    m_sink->setLevel(level);
+    Logger::setLevel(level);
+}
+
+void AsyncLogger::emit(
+    Level level,
+    std::chrono::system_clock::time_point time,
+    const char* threadMoniker,
+    const char* text) {
+    // Claim a free slot; see the bounded queue of Dmitry Vyukov.
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &m_ring[pos & m_mask];
+        auto sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+        if (0 == diff) {
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // The ring is full; never make the caller wait for the console.
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->time = time;
+    slot->level = level;
+    std::strncpy(slot->threadMoniker, threadMoniker, MONIKER_SIZE - 1);
+    slot->threadMoniker[MONIKER_SIZE - 1] = '\0';
+    auto length = std::strlen(text);
+    if (length < sizeof(slot->text)) {
+        std::memcpy(slot->text, text, length + 1);
+    } else {
+        slot->longText = new std::string(text, length);
+    }
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    if (pos + 1 - m_dequeuePos.load(std::memory_order_relaxed) > m_ring.size() / 2 &&
+        !m_wakeRequested.exchange(true)) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeTrigger.notify_one();
+    }
+}
+
+void AsyncLogger::flush() {
+    auto target = m_enqueuePos.load();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_wakeRequested = true;
+    m_wakeTrigger.notify_one();
+    m_drained.wait(lock, [this, target]() { return m_dequeuePos.load() >= target || m_stopping; });
+}
+
+size_t AsyncLogger::getDroppedCount() const {
+    return m_dropped.load();
+}
+
+bool AsyncLogger::drain() {
+    auto pos = m_dequeuePos.load(std::memory_order_relaxed);
+    auto first = pos;
+    while (true) {
+        auto& slot = m_ring[pos & m_mask];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1) {
+            break;
+        }
+
+        m_sink->emit(slot.level, slot.time, slot.threadMoniker, slot.longText ? slot.longText->c_str() : slot.text);
+        delete slot.longText;
+        slot.longText = nullptr;
+
+        slot.sequence.store(pos + m_ring.size(), std::memory_order_release);
+        ++pos;
+        m_dequeuePos.store(pos, std::memory_order_release);
+    }
+
+    auto dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != m_droppedReported) {
+        auto text = "AsyncLogger:linesDropped:count=" + std::to_string(dropped - m_droppedReported);
+        m_droppedReported = dropped;
+        m_sink->emit(
+            Level::WARN,
+            std::chrono::system_clock::now(),
+            ThreadMoniker::getThisThreadMoniker().c_str(),
+            text.c_str());
+    }
+    return pos != first;
+}
+
+void AsyncLogger::consumeLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        lock.unlock();
+        drain();
+        lock.lock();
+        m_drained.notify_all();
+        if (m_stopping) {
+            // Lines logged while the owner was going away.
+            lock.unlock();
+            drain();
+            lock.lock();
+            m_drained.notify_all();
+            return;
+        }
+        m_wakeTrigger.wait_for(lock, DRAIN_INTERVAL, [this]() { return m_stopping || m_wakeRequested.load(); });
+        m_wakeRequested = false;
+    }
+}
+
+}  // namespace logging
+}  // namespace utils
+}  // namespace aisdk
@@ -36,8 +36,9 @@ void ConsoleLogger::emit(
     const char* threadMoniker,
     const char* text) {
     std::lock_guard<std::mutex> lock(m_coutMutex);
-    std::cout << m_logFormatter.format(level, time, threadMoniker, text) << std::endl;
-	m_zlogManager.zlog_put(level, m_logFormatter.format(level, time, threadMoniker, text).c_str());
+    auto line = m_logFormatter.format(level, time, threadMoniker, text);
+    std::cout << line << std::endl;
+	m_zlogManager.zlog_put(level, line.c_str());
 }
 
 ConsoleLogger::ConsoleLogger() : Logger(Level::UNKNOWN) {
@@ -11,29 +11,19 @@
  */
 
 #include <cstdio>
-#include <iostream>
+#include <cstring>
+#include <ctime>
 
 #include "Utils/Logging/LogStringFormatter.h"
+#include "Utils/Logging/SafeCTimeAccess.h"
 
 namespace aisdk {
 namespace utils {
 namespace logging {
 
-/// Format string for strftime() to produce date and time in the format "YYYY-MM-DD HH:MM:SS".
-static const char* STRFTIME_FORMAT_STRING = "%Y-%m-%d %H:%M:%S";
-
-/// Size of buffer needed to hold "YYYY-MM-DD HH:MM:SS" and a null terminator.
-static const int DATE_AND_TIME_STRING_SIZE = 20;
-
 /// Separator between date/time and millis.
 static const char TIME_AND_MILLIS_SEPARATOR = '.';
 
-// Format string for sprintf() to produce millis in the format "nnn".
-static const char* MILLIS_FORMAT_STRING = "%03d";
-
-/// Size of buffer needed to hold "nnn" (milliseconds value) and a null terminator
-static const int MILLIS_STRING_SIZE = 4;
-
 /// Separator string between milliseconds value and ExampleLogger name.
 static const std::string MILLIS_AND_THREAD_SEPARATOR = " [";
 
@@ -46,7 +36,151 @@ static const char LEVEL_AND_TEXT_SEPARATOR = ' ';
 /// Number of milliseconds per second.
 static const int MILLISECONDS_PER_SECOND = 1000;
 
-LogStringFormatter::LogStringFormatter() : m_safeCTimeAccess(timing::SafeCTimeAccess::instance()) {
+/// Number of seconds per day.
+static const int64_t SECONDS_PER_DAY = 86400;
+
+/**
+ * Floor division, so times before the epoch land on the right day and second.
+ *
+ * @param dividend The dividend.
+ * @param divisor The divisor, positive.
+ * @return The quotient rounded towards negative infinity.
+ */
+static int64_t floorDivide(int64_t dividend, int64_t divisor) {
+    return (dividend >= 0 ? dividend : dividend - divisor + 1) / divisor;
+}
+
+/**
+ * Converts a count of days since 1970-01-01 to a proleptic Gregorian date, after Howard Hinnant's civil_from_days.
+ *
+ * @param days Days since 1970-01-01.
+ * @param[out] year The year.
+ * @param[out] month The month, 1 to 12.
+ * @param[out] day The day of the month, 1 to 31.
+ */
+static void civilFromDays(int64_t days, int64_t* year, int* month, int* day) {
+    days += 719468;
+    const int64_t era = floorDivide(days, 146097);
+    const int64_t dayOfEra = days - era * 146097;
+    const int64_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const int64_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const int64_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+    *day = static_cast<int>(dayOfYear - (153 * shiftedMonth + 2) / 5 + 1);
+    *month = static_cast<int>(shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9);
+    *year = yearOfEra + era * 400 + (*month <= 2 ? 1 : 0);
+}
+
+/**
+ * Converts a proleptic Gregorian date to a count of days since 1970-01-01, after Howard Hinnant's days_from_civil.
+ *
+ * @param year The year.
+ * @param month The month, 1 to 12.
+ * @param day The day of the month, 1 to 31.
+ * @return Days since 1970-01-01.
+ */
+static int64_t daysFromCivil(int64_t year, int month, int day) {
+    year -= month <= 2 ? 1 : 0;
+    const int64_t era = floorDivide(year, 400);
+    const int64_t yearOfEra = year - era * 400;
+    const int64_t dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+/**
+ * Writes a number as decimal digits, zero padded to a fixed width.
+ *
+ * @param out Where to write; @c width characters are written.
+ * @param value The value, non-negative and below 10^width.
+ * @param width The number of digits.
+ */
+static void writeDigits(char* out, int64_t value, int width) {
+    for (int i = width - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+}
+
+LogStringFormatter::LogStringFormatter() : LogStringFormatter(getSystemUtcOffset()) {
+}
+
+LogStringFormatter::LogStringFormatter(std::chrono::seconds utcOffset) :
+        m_utcOffset{utcOffset},
+        m_hasCachedSecond{false},
+        m_cachedSecond{0} {
+    m_cachedDateTime[0] = '\0';
+}
+
+std::chrono::seconds LogStringFormatter::getUtcOffset() const {
+    return m_utcOffset;
+}
+
+std::chrono::seconds LogStringFormatter::getSystemUtcOffset() {
+    auto now = std::time(nullptr);
+    std::tm localTm;
+    if (!timing::SafeCTimeAccess::instance()->getLocaltime(now, &localTm)) {
+        return std::chrono::seconds::zero();
+    }
+    // The local wall clock read as if it were UTC, minus the real UTC time.
+    auto localAsUtc = daysFromCivil(localTm.tm_year + 1900, localTm.tm_mon + 1, localTm.tm_mday) * SECONDS_PER_DAY +
+                      localTm.tm_hour * 3600 + localTm.tm_min * 60 + localTm.tm_sec;
+    return std::chrono::seconds(localAsUtc - static_cast<int64_t>(now));
+}
+
+bool LogStringFormatter::parseUtcOffset(const std::string& text, std::chrono::seconds* utcOffset) {
+    if (!utcOffset || text.size() < 3 || (text[0] != '+' && text[0] != '-')) {
+        return false;
+    }
+    std::string digits = text.substr(1);
+    if (digits.size() == 5 && digits[2] == ':') {
+        digits.erase(2, 1);
+    }
+    if (digits.size() != 2 && digits.size() != 4) {
+        return false;
+    }
+    for (auto c : digits) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+    }
+    const int hours = (digits[0] - '0') * 10 + (digits[1] - '0');
+    const int minutes = digits.size() == 4 ? (digits[2] - '0') * 10 + (digits[3] - '0') : 0;
+    // Real zones range from -12:00 to +14:00.
+    if (hours > 14 || minutes > 59) {
+        return false;
+    }
+    const int seconds = hours * 3600 + minutes * 60;
+    *utcOffset = std::chrono::seconds(text[0] == '-' ? -seconds : seconds);
+    return true;
+}
+
+void LogStringFormatter::renderDateTime(int64_t localSecond) {
+    const int64_t days = floorDivide(localSecond, SECONDS_PER_DAY);
+    const int64_t secondOfDay = localSecond - days * SECONDS_PER_DAY;
+    int64_t year;
+    int month;
+    int day;
+    civilFromDays(days, &year, &month, &day);
+    if (year < 0 || year > 9999) {
+        std::snprintf(m_cachedDateTime, sizeof(m_cachedDateTime), "%s", "(year out of range)");
+    } else {
+        // YYYY-MM-DD HH:MM:SS
+        char* out = m_cachedDateTime;
+        writeDigits(out, year, 4);
+        out[4] = '-';
+        writeDigits(out + 5, month, 2);
+        out[7] = '-';
+        writeDigits(out + 8, day, 2);
+        out[10] = ' ';
+        writeDigits(out + 11, secondOfDay / 3600, 2);
+        out[13] = ':';
+        writeDigits(out + 14, secondOfDay / 60 % 60, 2);
+        out[16] = ':';
+        writeDigits(out + 17, secondOfDay % 60, 2);
+        out[19] = '\0';
+    }
+    m_cachedSecond = localSecond;
+    m_hasCachedSecond = true;
 }
 
 std::string LogStringFormatter::format(
@@ -54,33 +188,31 @@ std::string LogStringFormatter::format(
     std::chrono::system_clock::time_point time,
     const char* threadMoniker,
     const char* text) {
-    bool dateTimeFailure = false;
-    bool millisecondFailure = false;
-    char dateTimeString[DATE_AND_TIME_STRING_SIZE];
-    auto timeAsTime_t = std::chrono::system_clock::to_time_t(time);
-	/// cts convert UTC+8 by Sven
-	timeAsTime_t += (8*3600);
-    std::tm timeAsTm;
-    if (!m_safeCTimeAccess->getGmtime(timeAsTime_t, &timeAsTm) ||
-        0 == strftime(dateTimeString, sizeof(dateTimeString), STRFTIME_FORMAT_STRING, &timeAsTm)) {
-        dateTimeFailure = true;
+    const int64_t millis = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() +
+                           std::chrono::duration_cast<std::chrono::milliseconds>(m_utcOffset).count();
+    const int64_t localSecond = floorDivide(millis, MILLISECONDS_PER_SECOND);
+    if (!m_hasCachedSecond || localSecond != m_cachedSecond) {
+        renderDateTime(localSecond);
     }
-    auto timeMillisPart = static_cast<int>(
-        std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() %
-        MILLISECONDS_PER_SECOND);
-    char millisString[MILLIS_STRING_SIZE];
-    if (std::snprintf(millisString, sizeof(millisString), MILLIS_FORMAT_STRING, timeMillisPart) < 0) {
-        millisecondFailure = true;
-    }
-
-    std::stringstream stringToEmit;
-    stringToEmit << (dateTimeFailure ? "ERROR: strftime() failed.  Date and time not logged." : dateTimeString)
-                 << TIME_AND_MILLIS_SEPARATOR
-                 << (millisecondFailure ? "ERROR: snprintf() failed.  Milliseconds not logged." : millisString)
-                 << MILLIS_AND_THREAD_SEPARATOR << threadMoniker << THREAD_AND_LEVEL_SEPARATOR
-                 << level << LEVEL_AND_TEXT_SEPARATOR << text;
-//                 << convertLevelToChar(level) << LEVEL_AND_TEXT_SEPARATOR << text;
-    return stringToEmit.str();
+    char millisString[4];
+    writeDigits(millisString, millis - localSecond * MILLISECONDS_PER_SECOND, 3);
+    millisString[3] = '\0';
+
+    auto levelName = convertLevelToName(level);
+    std::string stringToEmit;
+    stringToEmit.reserve(
+        DATE_AND_TIME_STRING_SIZE + sizeof(millisString) + MILLIS_AND_THREAD_SEPARATOR.size() +
+        std::strlen(threadMoniker) + THREAD_AND_LEVEL_SEPARATOR.size() + levelName.size() + 1 + std::strlen(text));
+    stringToEmit.append(m_cachedDateTime)
+        .append(1, TIME_AND_MILLIS_SEPARATOR)
+        .append(millisString)
+        .append(MILLIS_AND_THREAD_SEPARATOR)
+        .append(threadMoniker)
+        .append(THREAD_AND_LEVEL_SEPARATOR)
+        .append(levelName)
+        .append(1, LEVEL_AND_TEXT_SEPARATOR)
+        .append(text);
+    return stringToEmit;
 }
 
 }  // namespace logging
@@ -42,14 +42,15 @@ void Logger::setLevel(Level level) {
         m_level = level;
         //notifyObserversOnLogLevelChanged();
     }
-#ifndef AISDK_DEBUG_LOG_ENABLED
-    if (m_level <= Level::DEBUG0) {
+#if AISDK_LOG_MIN_LEVEL > AISDK_LOG_LEVEL_DEBUG5
+    if (static_cast<int>(m_level.load()) < AISDK_LOG_MIN_LEVEL) {
         // Log without AISDK_* macros to avoid recursive invocation of constructor.
         log(Level::WARN,
             LogEntry("Logger", "debugLogLevelSpecifiedWhenDebugLogsCompiledOut")
                 .d("level", m_level)
                 .m("\n"
-                   "\nWARNING: By default DEBUG logs are compiled out of RELEASE builds."
+                   "\nWARNING: By default DEBUG logs are compiled out of RELEASE builds, and logs below"
+                   "\nAISDK_LOG_MIN_LEVEL are compiled out of every build."
                    "\nRebuild with the cmake parameter -DCMAKE_BUILD_TYPE=DEBUG to enable debug logs."
                    "\n"));
     }
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define CHANNEL_REMAP_NEON
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#define CHANNEL_REMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "Utils/Logging/Logger.h"
+#include "Utils/Microphone/ChannelRemap.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("ChannelRemap");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace microphone {
+
+const int ChannelRemap::SILENCE;
+
+/// The number of 16-bit lanes in a 128-bit vector, which is also the channel count the vector kernels handle.
+static const size_t LANES = 8;
+
+/// Byte shuffle index which selects zero (out of range for @c vtbl).
+static const uint8_t ZERO_BYTE = 0xff;
+
+#ifdef CHANNEL_REMAP_SSE2
+/**
+ * Transposes an 8x8 block of 16-bit samples in place: on entry @c rows[f] holds frame @c f, on return @c rows[c]
+ * holds channel @c c of the eight frames.  The transpose is its own inverse.
+ */
+static inline void transpose8x8(__m128i rows[LANES]) {
+    __m128i a0 = _mm_unpacklo_epi16(rows[0], rows[1]);
+    __m128i a1 = _mm_unpackhi_epi16(rows[0], rows[1]);
+    __m128i a2 = _mm_unpacklo_epi16(rows[2], rows[3]);
+    __m128i a3 = _mm_unpackhi_epi16(rows[2], rows[3]);
+    __m128i a4 = _mm_unpacklo_epi16(rows[4], rows[5]);
+    __m128i a5 = _mm_unpackhi_epi16(rows[4], rows[5]);
+    __m128i a6 = _mm_unpacklo_epi16(rows[6], rows[7]);
+    __m128i a7 = _mm_unpackhi_epi16(rows[6], rows[7]);
+
+    __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+    __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+    __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+    __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+    __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+    __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+    __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+    __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+    rows[0] = _mm_unpacklo_epi64(b0, b4);
+    rows[1] = _mm_unpackhi_epi64(b0, b4);
+    rows[2] = _mm_unpacklo_epi64(b1, b5);
+    rows[3] = _mm_unpackhi_epi64(b1, b5);
+    rows[4] = _mm_unpacklo_epi64(b2, b6);
+    rows[5] = _mm_unpackhi_epi64(b2, b6);
+    rows[6] = _mm_unpacklo_epi64(b3, b7);
+    rows[7] = _mm_unpackhi_epi64(b3, b7);
+}
+#endif  // CHANNEL_REMAP_SSE2
+
+#ifdef CHANNEL_REMAP_NEON
+/**
+ * Transposes an 8x8 block of 16-bit samples in place: on entry @c rows[f] holds frame @c f, on return @c rows[c]
+ * holds channel @c c of the eight frames.
+ */
+static inline void transpose8x8(int16x8_t rows[LANES]) {
+    int16x8x2_t t01 = vtrnq_s16(rows[0], rows[1]);
+    int16x8x2_t t23 = vtrnq_s16(rows[2], rows[3]);
+    int16x8x2_t t45 = vtrnq_s16(rows[4], rows[5]);
+    int16x8x2_t t67 = vtrnq_s16(rows[6], rows[7]);
+
+    int32x4x2_t u02 = vtrnq_s32(vreinterpretq_s32_s16(t01.val[0]), vreinterpretq_s32_s16(t23.val[0]));
+    int32x4x2_t u13 = vtrnq_s32(vreinterpretq_s32_s16(t01.val[1]), vreinterpretq_s32_s16(t23.val[1]));
+    int32x4x2_t u46 = vtrnq_s32(vreinterpretq_s32_s16(t45.val[0]), vreinterpretq_s32_s16(t67.val[0]));
+    int32x4x2_t u57 = vtrnq_s32(vreinterpretq_s32_s16(t45.val[1]), vreinterpretq_s32_s16(t67.val[1]));
+
+    rows[0] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u02.val[0]), vget_low_s32(u46.val[0])));
+    rows[1] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u13.val[0]), vget_low_s32(u57.val[0])));
+    rows[2] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u02.val[1]), vget_low_s32(u46.val[1])));
+    rows[3] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(u13.val[1]), vget_low_s32(u57.val[1])));
+    rows[4] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u02.val[0]), vget_high_s32(u46.val[0])));
+    rows[5] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u13.val[0]), vget_high_s32(u57.val[0])));
+    rows[6] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u02.val[1]), vget_high_s32(u46.val[1])));
+    rows[7] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(u13.val[1]), vget_high_s32(u57.val[1])));
+}
+#endif  // CHANNEL_REMAP_NEON
+
+std::unique_ptr<ChannelRemap> ChannelRemap::create(size_t inputChannels, const std::vector<int>& channelMap) {
+    if (0 == inputChannels) {
+        AISDK_ERROR(LX("createFailed").d("reason", "zeroInputChannels"));
+        return nullptr;
+    }
+    if (channelMap.empty()) {
+        AISDK_ERROR(LX("createFailed").d("reason", "emptyChannelMap"));
+        return nullptr;
+    }
+    for (size_t c = 0; c < channelMap.size(); ++c) {
+        if (SILENCE != channelMap[c] && (channelMap[c] < 0 || static_cast<size_t>(channelMap[c]) >= inputChannels)) {
+            AISDK_ERROR(LX("createFailed")
+                            .d("reason", "channelOutOfRange")
+                            .d("outputChannel", c)
+                            .d("inputChannel", channelMap[c])
+                            .d("inputChannels", inputChannels));
+            return nullptr;
+        }
+    }
+    return std::unique_ptr<ChannelRemap>(new ChannelRemap(inputChannels, channelMap));
+}
+
+ChannelRemap::ChannelRemap(size_t inputChannels, const std::vector<int>& channelMap) :
+        m_inputChannels{inputChannels} {
+    for (size_t c = 0; c < channelMap.size(); ++c) {
+        bool silent = (SILENCE == channelMap[c]);
+        m_sourceIndex.push_back(silent ? 0 : channelMap[c]);
+        m_sourceMask.push_back(silent ? 0 : static_cast<int16_t>(-1));
+        m_vectorIndex.push_back(silent ? inputChannels : channelMap[c]);
+    }
+
+    for (size_t c = 0; c < LANES; ++c) {
+        bool copy = c < channelMap.size() && SILENCE != channelMap[c];
+        m_byteTable[2 * c] = copy ? static_cast<uint8_t>(2 * channelMap[c]) : ZERO_BYTE;
+        m_byteTable[2 * c + 1] = copy ? static_cast<uint8_t>(2 * channelMap[c] + 1) : ZERO_BYTE;
+    }
+}
+
+void ChannelRemap::remap(const int16_t* input, int16_t* output, size_t nFrames) const {
+    size_t done = 0;
+#ifdef CHANNEL_REMAP_NEON
+    if (LANES == m_inputChannels && LANES == m_sourceIndex.size()) {
+        uint8x8_t tableLow = vld1_u8(m_byteTable);
+        uint8x8_t tableHigh = vld1_u8(m_byteTable + LANES);
+        for (; done < nFrames; ++done) {
+            uint8x16_t frame = vld1q_u8(reinterpret_cast<const uint8_t*>(input + done * LANES));
+            uint8x8x2_t bytes;
+            bytes.val[0] = vget_low_u8(frame);
+            bytes.val[1] = vget_high_u8(frame);
+            uint8x16_t remapped = vcombine_u8(vtbl2_u8(bytes, tableLow), vtbl2_u8(bytes, tableHigh));
+            vst1q_u8(reinterpret_cast<uint8_t*>(output + done * LANES), remapped);
+        }
+    }
+#elif defined(CHANNEL_REMAP_SSE2)
+    if (LANES == m_inputChannels && LANES == m_sourceIndex.size()) {
+        // Transpose eight frames into channel vectors, pick them by table, and transpose back.
+        __m128i channels[LANES + 1];
+        channels[LANES] = _mm_setzero_si128();
+        for (; done + LANES <= nFrames; done += LANES) {
+            const __m128i* in = reinterpret_cast<const __m128i*>(input + done * LANES);
+            for (size_t f = 0; f < LANES; ++f) {
+                channels[f] = _mm_loadu_si128(in + f);
+            }
+            transpose8x8(channels);
+
+            __m128i rows[LANES];
+            for (size_t c = 0; c < LANES; ++c) {
+                rows[c] = channels[m_vectorIndex[c]];
+            }
+            transpose8x8(rows);
+
+            __m128i* out = reinterpret_cast<__m128i*>(output + done * LANES);
+            for (size_t f = 0; f < LANES; ++f) {
+                _mm_storeu_si128(out + f, rows[f]);
+            }
+        }
+    }
+#endif
+    if (done < nFrames) {
+        remapScalar(input + done * m_inputChannels, output + done * m_sourceIndex.size(), nFrames - done);
+    }
+}
+
+void ChannelRemap::deinterleave(const int16_t* input, int16_t* const* planes, size_t nFrames) const {
+    size_t done = 0;
+#if defined(CHANNEL_REMAP_NEON) || defined(CHANNEL_REMAP_SSE2)
+    if (LANES == m_inputChannels) {
+        const size_t outputChannels = m_sourceIndex.size();
+#ifdef CHANNEL_REMAP_NEON
+        int16x8_t channels[LANES + 1];
+        channels[LANES] = vdupq_n_s16(0);
+        for (; done + LANES <= nFrames; done += LANES) {
+            for (size_t f = 0; f < LANES; ++f) {
+                channels[f] = vld1q_s16(input + (done + f) * LANES);
+            }
+            transpose8x8(channels);
+            for (size_t c = 0; c < outputChannels; ++c) {
+                vst1q_s16(planes[c] + done, channels[m_vectorIndex[c]]);
+            }
+        }
+#else
+        __m128i channels[LANES + 1];
+        channels[LANES] = _mm_setzero_si128();
+        for (; done + LANES <= nFrames; done += LANES) {
+            const __m128i* in = reinterpret_cast<const __m128i*>(input + done * LANES);
+            for (size_t f = 0; f < LANES; ++f) {
+                channels[f] = _mm_loadu_si128(in + f);
+            }
+            transpose8x8(channels);
+            for (size_t c = 0; c < outputChannels; ++c) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(planes[c] + done), channels[m_vectorIndex[c]]);
+            }
+        }
+#endif
+    }
+#endif
+    deinterleaveFrames(input, planes, done, nFrames);
+}
+
+void ChannelRemap::remapScalar(const int16_t* input, int16_t* output, size_t nFrames) const {
+    const size_t outputChannels = m_sourceIndex.size();
+    for (size_t f = 0; f < nFrames; ++f) {
+        const int16_t* frame = input + f * m_inputChannels;
+        for (size_t c = 0; c < outputChannels; ++c) {
+            *output++ = frame[m_sourceIndex[c]] & m_sourceMask[c];
+        }
+    }
+}
+
+void ChannelRemap::deinterleaveScalar(const int16_t* input, int16_t* const* planes, size_t nFrames) const {
+    deinterleaveFrames(input, planes, 0, nFrames);
+}
+
+void ChannelRemap::deinterleaveFrames(const int16_t* input, int16_t* const* planes, size_t begin, size_t end) const {
+    const size_t outputChannels = m_sourceIndex.size();
+    for (size_t c = 0; c < outputChannels; ++c) {
+        const int16_t* source = input + m_sourceIndex[c];
+        const int16_t mask = m_sourceMask[c];
+        int16_t* plane = planes[c];
+        for (size_t f = begin; f < end; ++f) {
+            plane[f] = source[f * m_inputChannels] & mask;
+        }
+    }
+}
+
+size_t ChannelRemap::getInputChannels() const {
+    return m_inputChannels;
+}
+
+size_t ChannelRemap::getOutputChannels() const {
+    return m_sourceIndex.size();
+}
+
+const char* ChannelRemap::getKernelName() {
+#if defined(CHANNEL_REMAP_NEON)
+    return "neon";
+#elif defined(CHANNEL_REMAP_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+}  // namespace microphone
+}  // namespace utils
+}  // namespace aisdk
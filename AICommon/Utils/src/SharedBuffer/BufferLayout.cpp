@@ -0,0 +1,280 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <atomic>
+#include <limits>
+
+#include "Utils/Logging/Logger.h"
+#include "Utils/SharedBuffer/BufferLayout.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("BufferLayout");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+const uint32_t BufferLayout::MAGIC_NUMBER;
+const uint32_t BufferLayout::VERSION;
+
+BufferLayout::BufferLayout(std::shared_ptr<Buffer> buffer) :
+        m_buffer{buffer},
+        m_readerEnabledArray{nullptr},
+        m_readerCursorArray{nullptr},
+        m_readerCloseIndexArray{nullptr},
+        m_dataSize{0},
+        m_data{nullptr} {
+}
+
+BufferLayout::~BufferLayout() {
+    detach();
+}
+
+BufferLayout::Header* BufferLayout::getHeader() const {
+    return reinterpret_cast<Header*>(m_buffer->data());
+}
+
+std::atomic<bool>* BufferLayout::getReaderEnabledArray() const {
+    return m_readerEnabledArray;
+}
+
+std::atomic<uint64_t>* BufferLayout::getReaderCursorArray() const {
+    return m_readerCursorArray;
+}
+
+std::atomic<uint64_t>* BufferLayout::getReaderCloseIndexArray() const {
+    return m_readerCloseIndexArray;
+}
+
+BufferLayout::Index BufferLayout::getDataSize() const {
+    return m_dataSize;
+}
+
+uint8_t* BufferLayout::getData(Index at) const {
+    return m_data + (at % getDataSize()) * getHeader()->wordSize;
+}
+
+bool BufferLayout::init(size_t wordSize, size_t maxReaders) {
+    // Make sure parameters are not too large for our header fields.
+    if (wordSize > std::numeric_limits<decltype(Header::wordSize)>::max()) {
+        AISDK_ERROR(LX("initFailed")
+                        .d("reason", "wordSizeTooLarge")
+                        .d("wordSize", wordSize)
+                        .d("wordSizeLimit", std::numeric_limits<decltype(Header::wordSize)>::max()));
+        return false;
+    }
+    if (maxReaders > std::numeric_limits<decltype(Header::maxReaders)>::max()) {
+        AISDK_ERROR(LX("initFailed")
+                        .d("reason", "maxReadersTooLarge")
+                        .d("maxReaders", maxReaders)
+                        .d("maxReadersLimit", std::numeric_limits<decltype(Header::maxReaders)>::max()));
+        return false;
+    }
+
+    // Pre-calculate some pointers and sizes that are frequently accessed.
+    calculateAndCacheConstants(wordSize, maxReaders);
+
+    // Default construction of the Header and the reader arrays inside the raw buffer.
+    auto header = new (getHeader()) Header;
+    for (size_t id = 0; id < maxReaders; ++id) {
+        new (m_readerEnabledArray + id) std::atomic<bool>;
+        new (m_readerCursorArray + id) std::atomic<uint64_t>;
+        new (m_readerCloseIndexArray + id) std::atomic<uint64_t>;
+    }
+
+    header->wordSize = wordSize;
+    header->maxReaders = maxReaders;
+    header->isWriterEnabled = false;
+    header->hasWriterBeenClosed = false;
+    header->writeStartCursor = 0;
+    header->writeEndCursor = 0;
+    header->oldestUnconsumedCursor = 0;
+    header->isWriterBlocking = false;
+    header->waitingReaders = 0;
+    header->referenceCount = 1;
+
+    for (size_t id = 0; id < maxReaders; ++id) {
+        m_readerEnabledArray[id] = false;
+        m_readerCursorArray[id] = 0;
+        m_readerCloseIndexArray[id] = 0;
+    }
+
+    // Stamp the header last, so a process attaching concurrently never sees a half-initialized layout as valid.
+    header->version = VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = MAGIC_NUMBER;
+
+    return true;
+}
+
+bool BufferLayout::attach() {
+    if (m_buffer->size() < calculateReaderEnabledArrayOffset()) {
+        AISDK_ERROR(LX("attachFailed").d("reason", "bufferTooSmall").d("size", m_buffer->size()));
+        return false;
+    }
+
+    auto header = getHeader();
+    if (MAGIC_NUMBER != header->magic) {
+        AISDK_ERROR(LX("attachFailed").d("reason", "magicNumberMismatch").d("magic", header->magic));
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (VERSION != header->version) {
+        AISDK_ERROR(LX("attachFailed")
+                        .d("reason", "incompatibleVersion")
+                        .d("version", header->version)
+                        .d("expected", VERSION));
+        return false;
+    }
+    if (0 == header->wordSize || m_buffer->size() < calculateDataOffset(header->wordSize, header->maxReaders) +
+                                                        header->wordSize) {
+        AISDK_ERROR(LX("attachFailed").d("reason", "bufferSizeMismatch").d("size", m_buffer->size()));
+        return false;
+    }
+
+    {
+        std::lock_guard<Mutex> lock(header->attachMutex);
+        if (0 == header->referenceCount) {
+            AISDK_ERROR(LX("attachFailed").d("reason", "bufferDestroyed"));
+            return false;
+        }
+        ++header->referenceCount;
+    }
+
+    calculateAndCacheConstants(header->wordSize, header->maxReaders);
+    return true;
+}
+
+void BufferLayout::detach() {
+    if (!isAttached()) {
+        return;
+    }
+
+    auto header = getHeader();
+    {
+        std::lock_guard<Mutex> lock(header->attachMutex);
+        --header->referenceCount;
+        if (header->referenceCount > 0) {
+            return;
+        }
+    }
+
+    for (size_t id = 0; id < header->maxReaders; ++id) {
+        m_readerCloseIndexArray[id].~atomic<uint64_t>();
+        m_readerCursorArray[id].~atomic<uint64_t>();
+        m_readerEnabledArray[id].~atomic<bool>();
+    }
+    header->magic = 0;
+    header->~Header();
+    m_data = nullptr;
+}
+
+bool BufferLayout::isReaderEnabled(size_t id) const {
+    return m_readerEnabledArray[id];
+}
+
+void BufferLayout::enableReaderLocked(size_t id) {
+    m_readerEnabledArray[id] = true;
+}
+
+void BufferLayout::disableReaderLocked(size_t id) {
+    m_readerEnabledArray[id] = false;
+}
+
+BufferLayout::Index BufferLayout::wordsUntilWrap(Index after) const {
+    return alignSizeTo(after + 1, getDataSize()) - after;
+}
+
+void BufferLayout::updateOldestUnconsumedCursor() {
+    // Only a BLOCKING writer ever waits for space, so the other policies skip the lock entirely.
+    if (!getHeader()->isWriterBlocking) {
+        return;
+    }
+    std::lock_guard<Mutex> backwardSeekLock(getHeader()->backwardSeekMutex);
+    updateOldestUnconsumedCursorLocked();
+}
+
+void BufferLayout::updateOldestUnconsumedCursorLocked() {
+    auto header = getHeader();
+
+    Index oldest = std::numeric_limits<Index>::max();
+    for (size_t id = 0; id < header->maxReaders; ++id) {
+        if (isReaderEnabled(id) && m_readerCursorArray[id] < oldest) {
+            oldest = m_readerCursorArray[id];
+        }
+    }
+
+    // With no readers attached, nothing is holding data back.
+    if (std::numeric_limits<Index>::max() == oldest) {
+        oldest = header->writeStartCursor;
+    }
+
+    if (oldest != header->oldestUnconsumedCursor) {
+        bool freedSpace = oldest > header->oldestUnconsumedCursor;
+        header->oldestUnconsumedCursor = oldest;
+        if (freedSpace) {
+            header->spaceAvailableConditionVariable.notify_all();
+        }
+    }
+}
+
+size_t BufferLayout::calculateDataOffset(size_t wordSize, size_t maxReaders) {
+    return alignSizeTo(calculateReaderCloseIndexArrayOffset(maxReaders) + (maxReaders * sizeof(std::atomic<uint64_t>)),
+                       wordSize);
+}
+
+BufferLayout::Index BufferLayout::alignSizeTo(Index size, Index align) {
+    if (size) {
+        return (((size - 1) / align) + 1) * align;
+    } else {
+        return 0;
+    }
+}
+
+size_t BufferLayout::calculateReaderEnabledArrayOffset() {
+    return alignSizeTo(sizeof(Header), alignof(std::atomic<bool>));
+}
+
+size_t BufferLayout::calculateReaderCursorArrayOffset(size_t maxReaders) {
+    return alignSizeTo(
+        calculateReaderEnabledArrayOffset() + (maxReaders * sizeof(std::atomic<bool>)),
+        alignof(std::atomic<uint64_t>));
+}
+
+size_t BufferLayout::calculateReaderCloseIndexArrayOffset(size_t maxReaders) {
+    return calculateReaderCursorArrayOffset(maxReaders) + (maxReaders * sizeof(std::atomic<uint64_t>));
+}
+
+void BufferLayout::calculateAndCacheConstants(size_t wordSize, size_t maxReaders) {
+    auto buffer = reinterpret_cast<uint8_t*>(m_buffer->data());
+    m_readerEnabledArray = reinterpret_cast<std::atomic<bool>*>(buffer + calculateReaderEnabledArrayOffset());
+    m_readerCursorArray = reinterpret_cast<std::atomic<uint64_t>*>(buffer + calculateReaderCursorArrayOffset(maxReaders));
+    m_readerCloseIndexArray =
+        reinterpret_cast<std::atomic<uint64_t>*>(buffer + calculateReaderCloseIndexArrayOffset(maxReaders));
+    m_dataSize = (m_buffer->size() - calculateDataOffset(wordSize, maxReaders)) / wordSize;
+    m_data = buffer + calculateDataOffset(wordSize, maxReaders);
+}
+
+bool BufferLayout::isAttached() const {
+    return m_data != nullptr;
+}
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
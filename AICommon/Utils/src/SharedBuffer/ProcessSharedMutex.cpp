@@ -0,0 +1,128 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <cerrno>
+#include <ctime>
+#include <cstring>
+#include <system_error>
+
+#include "Utils/Logging/Logger.h"
+#include "Utils/SharedBuffer/ProcessSharedMutex.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("ProcessSharedMutex");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+/// Number of nanoseconds per second.
+static const long NANOSECONDS_PER_SECOND = 1000000000L;
+
+/**
+ * Deal with the result of a robust lock operation.  When the previous owner died holding the mutex the protected
+ * state is still consistent for our purposes (cursors and flags are atomics), so the mutex is simply marked usable.
+ *
+ * @param mutex The mutex which was locked.
+ * @param result The value returned by the pthread lock function.
+ * @return The result to report to the caller (0 on success).
+ */
+static int handleLockResult(pthread_mutex_t* mutex, int result) {
+    if (EOWNERDEAD == result) {
+        pthread_mutex_consistent(mutex);
+        return 0;
+    }
+    return result;
+}
+
+ProcessSharedMutex::ProcessSharedMutex() {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&m_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+ProcessSharedMutex::~ProcessSharedMutex() {
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void ProcessSharedMutex::lock() {
+    int result = handleLockResult(&m_mutex, pthread_mutex_lock(&m_mutex));
+    if (result) {
+        AISDK_ERROR(LX("lockFailed").d("reason", strerror(result)));
+        throw std::system_error(result, std::system_category(), "ProcessSharedMutex::lock");
+    }
+}
+
+bool ProcessSharedMutex::try_lock() {
+    return 0 == handleLockResult(&m_mutex, pthread_mutex_trylock(&m_mutex));
+}
+
+void ProcessSharedMutex::unlock() {
+    pthread_mutex_unlock(&m_mutex);
+}
+
+pthread_mutex_t* ProcessSharedMutex::native_handle() {
+    return &m_mutex;
+}
+
+ProcessSharedConditionVariable::ProcessSharedConditionVariable() {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&m_condition, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+ProcessSharedConditionVariable::~ProcessSharedConditionVariable() {
+    pthread_cond_destroy(&m_condition);
+}
+
+void ProcessSharedConditionVariable::notify_one() {
+    pthread_cond_signal(&m_condition);
+}
+
+void ProcessSharedConditionVariable::notify_all() {
+    pthread_cond_broadcast(&m_condition);
+}
+
+void ProcessSharedConditionVariable::wait(std::unique_lock<ProcessSharedMutex>& lock) {
+    auto mutex = lock.mutex()->native_handle();
+    handleLockResult(mutex, pthread_cond_wait(&m_condition, mutex));
+}
+
+std::cv_status ProcessSharedConditionVariable::wait_until(
+    std::unique_lock<ProcessSharedMutex>& lock,
+    const std::chrono::steady_clock::time_point& deadline) {
+    auto sinceEpoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(sinceEpoch / NANOSECONDS_PER_SECOND);
+    ts.tv_nsec = static_cast<long>(sinceEpoch % NANOSECONDS_PER_SECOND);
+
+    auto mutex = lock.mutex()->native_handle();
+    int result = handleLockResult(mutex, pthread_cond_timedwait(&m_condition, mutex, &ts));
+    return (ETIMEDOUT == result) ? std::cv_status::timeout : std::cv_status::no_timeout;
+}
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "Utils/SharedBuffer/RawBuffer.h"
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+RawBuffer::RawBuffer(size_t size) :
+        m_data{new uint8_t[size]()},
+        m_size{size},
+        m_releaser{[](uint8_t* data, size_t) { delete[] data; }} {
+}
+
+RawBuffer::RawBuffer(uint8_t* data, size_t size, Releaser releaser) :
+        m_data{data},
+        m_size{size},
+        m_releaser{releaser} {
+}
+
+RawBuffer::~RawBuffer() {
+    if (m_releaser) {
+        m_releaser(m_data, m_size);
+    }
+}
+
+uint8_t* RawBuffer::data() const {
+    return m_data;
+}
+
+size_t RawBuffer::size() const {
+    return m_size;
+}
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
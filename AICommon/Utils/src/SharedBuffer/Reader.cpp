@@ -0,0 +1,335 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+#include "Utils/Logging/Logger.h"
+#include "Utils/SharedBuffer/Reader.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("SharedBufferReader");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+Reader::Reader(Policy policy, std::shared_ptr<BufferLayout> bufferLayout, uint8_t id) :
+        m_policy{policy},
+        m_bufferLayout{bufferLayout},
+        m_id{id},
+        m_readerCursor{&m_bufferLayout->getReaderCursorArray()[id]},
+        m_readerCloseIndex{&m_bufferLayout->getReaderCloseIndexArray()[id]} {
+    // Note - SharedBuffer::createReader() holds readerEnableMutex while calling this function.
+    // Start at the writer's current position, and read indefinitely.
+    std::lock_guard<BufferLayout::Mutex> backwardSeekLock(m_bufferLayout->getHeader()->backwardSeekMutex);
+    *m_readerCursor = m_bufferLayout->getHeader()->writeStartCursor.load();
+    *m_readerCloseIndex = std::numeric_limits<BufferLayout::Index>::max();
+    m_bufferLayout->enableReaderLocked(m_id);
+}
+
+Reader::~Reader() {
+    auto header = m_bufferLayout->getHeader();
+    std::lock_guard<BufferLayout::Mutex> lock(header->readerEnableMutex);
+    std::lock_guard<BufferLayout::Mutex> backwardSeekLock(header->backwardSeekMutex);
+    m_bufferLayout->disableReaderLocked(m_id);
+    if (header->isWriterBlocking) {
+        m_bufferLayout->updateOldestUnconsumedCursorLocked();
+    }
+}
+
+ssize_t Reader::read(void* buf, size_t nWords, std::chrono::milliseconds timeout) {
+    if (nullptr == buf) {
+        AISDK_ERROR(LX("readFailed").d("reason", "nullBuffer"));
+        return Error::INVALID;
+    }
+
+    Spans spans;
+    auto result = peek(&spans, nWords, timeout);
+    if (result <= 0) {
+        return result;
+    }
+
+    auto wordSize = getWordSize();
+    auto buf8 = static_cast<uint8_t*>(buf);
+    memcpy(buf8, spans.first.data, spans.first.nWords * wordSize);
+    if (spans.second.nWords > 0) {
+        memcpy(buf8 + (spans.first.nWords * wordSize), spans.second.data, spans.second.nWords * wordSize);
+    }
+
+    return consume(result);
+}
+
+ssize_t Reader::peek(Spans* spans, size_t nWords, std::chrono::milliseconds timeout) {
+    if (nullptr == spans) {
+        AISDK_ERROR(LX("peekFailed").d("reason", "nullSpans"));
+        return Error::INVALID;
+    }
+    if (0 == nWords) {
+        AISDK_ERROR(LX("peekFailed").d("reason", "zeroNumWords"));
+        return Error::INVALID;
+    }
+
+    auto readableWords = waitForData(1, timeout);
+    if (readableWords <= 0) {
+        return readableWords;
+    }
+
+    // Don't expose more than the caller requested, and don't go beyond closeIndex.
+    BufferLayout::Index cursor = *m_readerCursor;
+    if (nWords > static_cast<size_t>(readableWords)) {
+        nWords = readableWords;
+    }
+    if (nWords > *m_readerCloseIndex - cursor) {
+        nWords = *m_readerCloseIndex - cursor;
+    }
+
+    // Since the buffer is circular, the data may be split in two at the wrap point.
+    size_t beforeWrap = m_bufferLayout->wordsUntilWrap(cursor);
+    if (beforeWrap > nWords) {
+        beforeWrap = nWords;
+    }
+    spans->first.data = m_bufferLayout->getData(cursor);
+    spans->first.nWords = beforeWrap;
+    spans->second.data = m_bufferLayout->getData(cursor + beforeWrap);
+    spans->second.nWords = nWords - beforeWrap;
+
+    return nWords;
+}
+
+ssize_t Reader::consume(size_t nWords) {
+    auto header = m_bufferLayout->getHeader();
+    BufferLayout::Index cursor = *m_readerCursor;
+    if (nWords > header->writeStartCursor - cursor) {
+        AISDK_ERROR(LX("consumeFailed")
+                        .d("reason", "beyondWriter")
+                        .d("nWords", nWords)
+                        .d("readable", header->writeStartCursor - cursor));
+        return Error::INVALID;
+    }
+
+    // The writer may have lapped the data while the caller was looking at it.  Check from the start of the data, as
+    // its first words are the first to go.  The fence keeps the caller's reads of the data from moving after the
+    // check, and pairs with the one in Writer::write().
+    std::atomic_thread_fence(std::memory_order_acquire);
+    bool overrun = isOverrun(header->writeEndCursor);
+
+    *m_readerCursor = cursor + nWords;
+    m_bufferLayout->updateOldestUnconsumedCursor();
+
+    if (overrun) {
+        return Error::OVERRUN;
+    }
+    return nWords;
+}
+
+ssize_t Reader::wait(size_t nWords, std::chrono::milliseconds timeout) {
+    return waitForData(nWords > 0 ? nWords : 1, timeout);
+}
+
+ssize_t Reader::waitForData(size_t minWords, std::chrono::milliseconds timeout) {
+    auto header = m_bufferLayout->getHeader();
+
+    // Initial check for overrun.
+    if (isOverrun(header->writeStartCursor)) {
+        return Error::OVERRUN;
+    }
+
+    BufferLayout::Index cursor = *m_readerCursor;
+    BufferLayout::Index closeIndex = *m_readerCloseIndex;
+    if (cursor >= closeIndex) {
+        return Error::CLOSED;
+    }
+
+    // Words beyond the close index will never be read, so don't wait for them.
+    if (minWords > closeIndex - cursor) {
+        minWords = closeIndex - cursor;
+    }
+
+    // Fast path: enough data is already there, so no lock or condition variable is involved.
+    BufferLayout::Index writeCursor = header->writeStartCursor;
+    if (writeCursor > cursor && writeCursor - cursor >= minWords) {
+        return writeCursor - cursor;
+    }
+
+    // Nothing more is coming, or the caller won't wait for it: hand over what there is.
+    if (!header->isWriterEnabled && header->hasWriterBeenClosed) {
+        return (writeCursor > cursor) ? static_cast<ssize_t>(writeCursor - cursor) : Error::CLOSED;
+    }
+
+    if (Policy::NONBLOCKING == m_policy) {
+        return (writeCursor > cursor) ? static_cast<ssize_t>(writeCursor - cursor) : Error::WOULDBLOCK;
+    }
+
+    // Slow path: register as a waiter before re-checking, so the writer either sees us or we see its data.  The
+    // writer signals every write while someone waits, so the predicate is re-evaluated as the data accumulates.
+    auto predicate = [this, header, minWords] {
+        BufferLayout::Index cursor = *m_readerCursor;
+        BufferLayout::Index writeCursor = header->writeStartCursor;
+        return header->hasWriterBeenClosed || (writeCursor > cursor && writeCursor - cursor >= minWords);
+    };
+    bool timedOut = false;
+    ++header->waitingReaders;
+    {
+        std::unique_lock<BufferLayout::Mutex> lock(header->dataAvailableMutex);
+        if (std::chrono::milliseconds::zero() == timeout) {
+            header->dataAvailableConditionVariable.wait(lock, predicate);
+        } else {
+            timedOut = !header->dataAvailableConditionVariable.wait_for(lock, timeout, predicate);
+        }
+    }
+    --header->waitingReaders;
+
+    // A timed out wait still hands back whatever arrived, so a caller asking for a batch gets a partial one.
+    writeCursor = header->writeStartCursor;
+    if (writeCursor > *m_readerCursor) {
+        return writeCursor - *m_readerCursor;
+    }
+    return timedOut ? Error::TIMEDOUT : Error::CLOSED;
+}
+
+bool Reader::isOverrun(BufferLayout::Index writeCursor) const {
+    BufferLayout::Index cursor = *m_readerCursor;
+    return (writeCursor >= cursor) && ((writeCursor - cursor) > m_bufferLayout->getDataSize());
+}
+
+bool Reader::seek(BufferLayout::Index offset, Reference reference) {
+    auto header = m_bufferLayout->getHeader();
+    BufferLayout::Index absolute = std::numeric_limits<BufferLayout::Index>::max();
+
+    switch (reference) {
+        case Reference::AFTER_READER:
+            absolute = *m_readerCursor + offset;
+            break;
+        case Reference::BEFORE_READER:
+            if (offset > *m_readerCursor) {
+                AISDK_ERROR(LX("seekFailed")
+                                .d("reason", "seekBeforeStreamStart")
+                                .d("reference", "BEFORE_READER")
+                                .d("seekOffset", offset)
+                                .d("readerCursor", m_readerCursor->load()));
+                return false;
+            }
+            absolute = *m_readerCursor - offset;
+            break;
+        case Reference::BEFORE_WRITER:
+            if (offset > header->writeStartCursor) {
+                AISDK_ERROR(LX("seekFailed")
+                                .d("reason", "seekBeforeStreamStart")
+                                .d("reference", "BEFORE_WRITER")
+                                .d("seekOffset", offset)
+                                .d("writeStartCursor", header->writeStartCursor.load()));
+                return false;
+            }
+            absolute = header->writeStartCursor - offset;
+            break;
+        case Reference::ABSOLUTE:
+            absolute = offset;
+            break;
+    }
+
+    // Don't seek to data which has already been overwritten.
+    if ((header->writeEndCursor >= absolute) && ((header->writeEndCursor - absolute) > m_bufferLayout->getDataSize())) {
+        AISDK_ERROR(LX("seekFailed").d("reason", "seekOverwrittenData"));
+        return false;
+    }
+
+    // A backward seek can pull the oldest unconsumed cursor back, so it must not race with a writer checking space.
+    std::unique_lock<BufferLayout::Mutex> lock(header->backwardSeekMutex, std::defer_lock);
+    bool backward = absolute < *m_readerCursor;
+    if (backward) {
+        lock.lock();
+    }
+
+    *m_readerCursor = absolute;
+
+    // Check again in case the writer overwrote the data while we were seeking.
+    if (isOverrun(header->writeEndCursor)) {
+        AISDK_ERROR(LX("seekFailed").d("reason", "seekOverwrittenData"));
+        return false;
+    }
+
+    if (backward) {
+        if (header->isWriterBlocking) {
+            m_bufferLayout->updateOldestUnconsumedCursorLocked();
+        }
+    } else {
+        m_bufferLayout->updateOldestUnconsumedCursor();
+    }
+
+    return true;
+}
+
+BufferLayout::Index Reader::tell(Reference reference) const {
+    auto header = m_bufferLayout->getHeader();
+    switch (reference) {
+        case Reference::AFTER_READER:
+        case Reference::BEFORE_READER:
+            return 0;
+        case Reference::BEFORE_WRITER:
+            return (header->writeStartCursor >= *m_readerCursor) ? header->writeStartCursor - *m_readerCursor : 0;
+        case Reference::ABSOLUTE:
+            return *m_readerCursor;
+    }
+    AISDK_ERROR(LX("tellFailed").d("reason", "invalidReference"));
+    return std::numeric_limits<BufferLayout::Index>::max();
+}
+
+void Reader::close(BufferLayout::Index offset, Reference reference) {
+    auto header = m_bufferLayout->getHeader();
+    BufferLayout::Index absolute = 0;
+
+    switch (reference) {
+        case Reference::AFTER_READER:
+            absolute = *m_readerCursor + offset;
+            break;
+        case Reference::BEFORE_READER:
+            absolute = (offset > *m_readerCursor) ? 0 : *m_readerCursor - offset;
+            break;
+        case Reference::BEFORE_WRITER:
+            if (header->writeStartCursor < offset) {
+                AISDK_ERROR(LX("closeFailed")
+                                .d("reason", "invalidIndex")
+                                .d("reference", "BEFORE_WRITER")
+                                .d("offset", offset)
+                                .d("writeStartCursor", header->writeStartCursor.load()));
+                return;
+            }
+            absolute = header->writeStartCursor - offset;
+            break;
+        case Reference::ABSOLUTE:
+            absolute = offset;
+            break;
+    }
+
+    *m_readerCloseIndex = absolute;
+}
+
+size_t Reader::getWordSize() const {
+    return m_bufferLayout->getHeader()->wordSize;
+}
+
+size_t Reader::getId() const {
+    return m_id;
+}
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
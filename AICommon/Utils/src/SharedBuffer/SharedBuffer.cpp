@@ -0,0 +1,149 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "Utils/Logging/Logger.h"
+#include "Utils/SharedBuffer/SharedBuffer.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("SharedBuffer");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+size_t SharedBuffer::calculateBufferSize(size_t nWords, size_t wordSize, size_t maxReaders) {
+    if (0 == nWords) {
+        AISDK_ERROR(LX("calculateBufferSizeFailed").d("reason", "numWordsZero"));
+        return 0;
+    } else if (0 == wordSize) {
+        AISDK_ERROR(LX("calculateBufferSizeFailed").d("reason", "wordSizeZero"));
+        return 0;
+    }
+    size_t overhead = BufferLayout::calculateDataOffset(wordSize, maxReaders);
+    size_t payload = nWords * wordSize;
+    return overhead + payload;
+}
+
+std::unique_ptr<SharedBuffer> SharedBuffer::create(std::shared_ptr<Buffer> buffer, size_t wordSize, size_t maxReaders) {
+    size_t expectedSize = calculateBufferSize(1, wordSize, maxReaders);
+    if (0 == expectedSize) {
+        AISDK_ERROR(LX("createFailed").d("reason", "calculateBufferSizeFailed"));
+        return nullptr;
+    } else if (nullptr == buffer) {
+        AISDK_ERROR(LX("createFailed").d("reason", "nullBuffer"));
+        return nullptr;
+    } else if (expectedSize > buffer->size()) {
+        AISDK_ERROR(LX("createFailed")
+                        .d("reason", "bufferSizeTooSmall")
+                        .d("bufferSize", buffer->size())
+                        .d("expectedSize", expectedSize));
+        return nullptr;
+    }
+
+    std::unique_ptr<SharedBuffer> sharedBuffer(new SharedBuffer(buffer));
+    if (!sharedBuffer->m_bufferLayout->init(wordSize, maxReaders)) {
+        AISDK_ERROR(LX("createFailed").d("reason", "initFailed"));
+        return nullptr;
+    }
+    return sharedBuffer;
+}
+
+std::unique_ptr<SharedBuffer> SharedBuffer::open(std::shared_ptr<Buffer> buffer) {
+    if (nullptr == buffer) {
+        AISDK_ERROR(LX("openFailed").d("reason", "nullBuffer"));
+        return nullptr;
+    }
+
+    std::unique_ptr<SharedBuffer> sharedBuffer(new SharedBuffer(buffer));
+    if (!sharedBuffer->m_bufferLayout->attach()) {
+        AISDK_ERROR(LX("openFailed").d("reason", "attachFailed"));
+        return nullptr;
+    }
+    return sharedBuffer;
+}
+
+size_t SharedBuffer::getMaxReaders() const {
+    return m_bufferLayout->getHeader()->maxReaders;
+}
+
+SharedBuffer::Index SharedBuffer::getDataSize() const {
+    return m_bufferLayout->getDataSize();
+}
+
+size_t SharedBuffer::getWordSize() const {
+    return m_bufferLayout->getHeader()->wordSize;
+}
+
+std::unique_ptr<Writer> SharedBuffer::createWriter(Writer::Policy policy, bool forceReplacement) {
+    auto header = m_bufferLayout->getHeader();
+    std::lock_guard<BufferLayout::Mutex> lock(header->writerEnableMutex);
+    if (header->isWriterEnabled && !forceReplacement) {
+        AISDK_ERROR(LX("createWriterFailed").d("reason", "existingWriterAttached").d("forceReplacement", "false"));
+        return nullptr;
+    }
+    return std::unique_ptr<Writer>(new Writer(policy, m_bufferLayout));
+}
+
+std::unique_ptr<Reader> SharedBuffer::createReader(Reader::Policy policy, bool startWithNewData) {
+    auto header = m_bufferLayout->getHeader();
+    std::unique_lock<BufferLayout::Mutex> lock(header->readerEnableMutex);
+    for (size_t id = 0; id < header->maxReaders; ++id) {
+        if (!m_bufferLayout->isReaderEnabled(id)) {
+            return createReaderLocked(id, policy, startWithNewData, false, &lock);
+        }
+    }
+    AISDK_ERROR(LX("createReaderFailed").d("reason", "noAvailableReaders").d("maxReaders", getMaxReaders()));
+    return nullptr;
+}
+
+SharedBuffer::~SharedBuffer() {
+}
+
+SharedBuffer::SharedBuffer(std::shared_ptr<Buffer> buffer) : m_bufferLayout{std::make_shared<BufferLayout>(buffer)} {
+}
+
+std::unique_ptr<Reader> SharedBuffer::createReaderLocked(
+    size_t id,
+    Reader::Policy policy,
+    bool startWithNewData,
+    bool forceReplacement,
+    std::unique_lock<BufferLayout::Mutex>* lock) {
+    if (m_bufferLayout->isReaderEnabled(id) && !forceReplacement) {
+        AISDK_ERROR(LX("createReaderLockedFailed").d("reason", "readerAlreadyAttached").d("readerId", id));
+        return nullptr;
+    }
+
+    auto reader = std::unique_ptr<Reader>(new Reader(policy, m_bufferLayout, id));
+    lock->unlock();
+
+    if (!startWithNewData) {
+        // Start with the oldest data which is still in the buffer.
+        Index offset = m_bufferLayout->getDataSize();
+        if (m_bufferLayout->getHeader()->writeStartCursor < offset) {
+            offset = m_bufferLayout->getHeader()->writeStartCursor;
+        }
+        reader->seek(offset, Reader::Reference::BEFORE_WRITER);
+    }
+
+    return reader;
+}
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
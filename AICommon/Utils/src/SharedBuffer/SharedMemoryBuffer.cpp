@@ -0,0 +1,163 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "Utils/Logging/Logger.h"
+#include "Utils/SharedBuffer/SharedMemoryBuffer.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("SharedMemoryBuffer");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+/// Access mode of the shared memory objects created here.
+static const mode_t SHARED_MEMORY_MODE = 0660;
+
+/**
+ * Maps @c size bytes of @c fd read/write and wraps the mapping in a @c RawBuffer which unmaps it on destruction.
+ *
+ * @param fd The descriptor to map.
+ * @param size The number of bytes to map.
+ * @return The mapped buffer, or @c nullptr on failure.
+ */
+static std::shared_ptr<RawBuffer> mapDescriptor(int fd, size_t size) {
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == address) {
+        AISDK_ERROR(LX("mapDescriptorFailed").d("reason", "mmapFailed").d("errno", strerror(errno)));
+        return nullptr;
+    }
+    return std::make_shared<RawBuffer>(static_cast<uint8_t*>(address), size, [](uint8_t* data, size_t length) {
+        munmap(data, length);
+    });
+}
+
+/**
+ * Looks up the size of the object behind @c fd.
+ *
+ * @param fd The descriptor.
+ * @return The size (in bytes), or 0 on failure.
+ */
+static size_t descriptorSize(int fd) {
+    struct stat status;
+    if (fstat(fd, &status) < 0) {
+        AISDK_ERROR(LX("descriptorSizeFailed").d("reason", "fstatFailed").d("errno", strerror(errno)));
+        return 0;
+    }
+    return static_cast<size_t>(status.st_size);
+}
+
+std::shared_ptr<RawBuffer> SharedMemoryBuffer::create(const std::string& name, size_t size) {
+    if (0 == size) {
+        AISDK_ERROR(LX("createFailed").d("reason", "zeroSize").d("name", name));
+        return nullptr;
+    }
+
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, SHARED_MEMORY_MODE);
+    if (fd < 0) {
+        AISDK_ERROR(LX("createFailed").d("reason", "shmOpenFailed").d("name", name).d("errno", strerror(errno)));
+        return nullptr;
+    }
+    if (ftruncate(fd, size) < 0) {
+        AISDK_ERROR(LX("createFailed").d("reason", "ftruncateFailed").d("name", name).d("errno", strerror(errno)));
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    auto buffer = mapDescriptor(fd, size);
+    close(fd);
+    if (!buffer) {
+        shm_unlink(name.c_str());
+    }
+    return buffer;
+}
+
+std::shared_ptr<RawBuffer> SharedMemoryBuffer::open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        AISDK_ERROR(LX("openFailed").d("reason", "shmOpenFailed").d("name", name).d("errno", strerror(errno)));
+        return nullptr;
+    }
+    auto buffer = openFd(fd);
+    close(fd);
+    return buffer;
+}
+
+bool SharedMemoryBuffer::remove(const std::string& name) {
+    if (shm_unlink(name.c_str()) < 0) {
+        if (ENOENT == errno) {
+            return false;
+        }
+        AISDK_ERROR(LX("removeFailed").d("name", name).d("errno", strerror(errno)));
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<RawBuffer> SharedMemoryBuffer::createAnonymous(size_t size, int* fd) {
+    if (nullptr == fd) {
+        AISDK_ERROR(LX("createAnonymousFailed").d("reason", "nullFd"));
+        return nullptr;
+    }
+#ifdef SYS_memfd_create
+    int memfd = static_cast<int>(syscall(SYS_memfd_create, "aisdk-sharedbuffer", 0));
+    if (memfd < 0) {
+        AISDK_ERROR(LX("createAnonymousFailed").d("reason", "memfdCreateFailed").d("errno", strerror(errno)));
+        return nullptr;
+    }
+    if (ftruncate(memfd, size) < 0) {
+        AISDK_ERROR(LX("createAnonymousFailed").d("reason", "ftruncateFailed").d("errno", strerror(errno)));
+        close(memfd);
+        return nullptr;
+    }
+    auto buffer = mapDescriptor(memfd, size);
+    if (!buffer) {
+        close(memfd);
+        return nullptr;
+    }
+    *fd = memfd;
+    return buffer;
+#else
+    AISDK_ERROR(LX("createAnonymousFailed").d("reason", "memfdNotSupported").d("size", size));
+    return nullptr;
+#endif
+}
+
+std::shared_ptr<RawBuffer> SharedMemoryBuffer::openFd(int fd) {
+    size_t size = descriptorSize(fd);
+    if (0 == size) {
+        AISDK_ERROR(LX("openFdFailed").d("reason", "emptyObject").d("fd", fd));
+        return nullptr;
+    }
+    return mapDescriptor(fd, size);
+}
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
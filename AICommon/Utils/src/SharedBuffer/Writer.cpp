@@ -0,0 +1,162 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <atomic>
+#include <cstring>
+
+#include "Utils/Logging/Logger.h"
+#include "Utils/SharedBuffer/Writer.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("SharedBufferWriter");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+
+Writer::Writer(Policy policy, std::shared_ptr<BufferLayout> bufferLayout) :
+        m_policy{policy},
+        m_bufferLayout{bufferLayout},
+        m_closed{false} {
+    // Note - SharedBuffer::createWriter() holds writerEnableMutex while calling this function.
+    auto header = m_bufferLayout->getHeader();
+    header->isWriterEnabled = true;
+
+    // Lock the backwardSeekMutex so no readers try to seek backwards while we're moving the write cursor.
+    std::lock_guard<BufferLayout::Mutex> lock(header->backwardSeekMutex);
+    header->writeEndCursor = header->writeStartCursor.load();
+    header->isWriterBlocking = (Policy::BLOCKING == m_policy);
+    if (header->isWriterBlocking) {
+        m_bufferLayout->updateOldestUnconsumedCursorLocked();
+    }
+}
+
+Writer::~Writer() {
+    close();
+}
+
+ssize_t Writer::write(const void* buf, size_t nWords, std::chrono::milliseconds timeout) {
+    if (nullptr == buf) {
+        AISDK_ERROR(LX("writeFailed").d("reason", "nullBuffer"));
+        return Error::INVALID;
+    }
+    if (0 == nWords) {
+        AISDK_ERROR(LX("writeFailed").d("reason", "zeroNumWords"));
+        return Error::INVALID;
+    }
+
+    auto header = m_bufferLayout->getHeader();
+    if (m_closed) {
+        return Error::CLOSED;
+    }
+
+    auto wordSize = getWordSize();
+    auto dataSize = m_bufferLayout->getDataSize();
+
+    switch (m_policy) {
+        case Policy::NONBLOCKABLE:
+            // Readers never hold a NONBLOCKABLE writer back; anything older than one buffer is simply lost.
+            if (nWords > dataSize) {
+                nWords = dataSize;
+            }
+            // Publish the region being overwritten before touching it, so readers can detect the overrun.
+            header->writeEndCursor = header->writeStartCursor + nWords;
+            break;
+        case Policy::BLOCKING: {
+            std::unique_lock<BufferLayout::Mutex> lock(header->backwardSeekMutex);
+            auto predicate = [header, dataSize] {
+                return (header->writeStartCursor - header->oldestUnconsumedCursor) < dataSize;
+            };
+            if (std::chrono::milliseconds::zero() == timeout) {
+                header->spaceAvailableConditionVariable.wait(lock, predicate);
+            } else if (!header->spaceAvailableConditionVariable.wait_for(lock, timeout, predicate)) {
+                return Error::TIMEDOUT;
+            }
+
+            size_t spaceAvailable = dataSize - (header->writeStartCursor - header->oldestUnconsumedCursor);
+            if (nWords > spaceAvailable) {
+                nWords = spaceAvailable;
+            }
+            // writeEndCursor must move while backwardSeekMutex is held so a reader cannot seek into this region.
+            header->writeEndCursor = header->writeStartCursor + nWords;
+            break;
+        }
+    }
+
+    // Keep the data below from becoming visible before the writeEndCursor store; pairs with the fence in consume().
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t beforeWrap = m_bufferLayout->wordsUntilWrap(header->writeStartCursor);
+    if (beforeWrap > nWords) {
+        beforeWrap = nWords;
+    }
+    size_t afterWrap = nWords - beforeWrap;
+
+    auto buf8 = static_cast<const uint8_t*>(buf);
+    memcpy(m_bufferLayout->getData(header->writeStartCursor), buf8, beforeWrap * wordSize);
+    if (afterWrap > 0) {
+        memcpy(
+            m_bufferLayout->getData(header->writeStartCursor + beforeWrap),
+            buf8 + (beforeWrap * wordSize),
+            afterWrap * wordSize);
+    }
+
+    // Advance the write cursor.  This store is the only thing a reader which is not waiting needs to see; a reader
+    // only sleeps on dataAvailableConditionVariable after registering in waitingReaders, and both sides use
+    // sequentially consistent atomics, so either we observe the waiter here or it observes the new cursor.
+    header->writeStartCursor = header->writeEndCursor.load();
+    if (header->waitingReaders > 0) {
+        {
+            std::lock_guard<BufferLayout::Mutex> dataAvailableLock(header->dataAvailableMutex);
+        }
+        header->dataAvailableConditionVariable.notify_all();
+    }
+
+    return nWords;
+}
+
+BufferLayout::Index Writer::tell() const {
+    return m_bufferLayout->getHeader()->writeStartCursor;
+}
+
+void Writer::close() {
+    auto header = m_bufferLayout->getHeader();
+    std::lock_guard<BufferLayout::Mutex> lock(header->writerEnableMutex);
+    if (m_closed) {
+        return;
+    }
+
+    if (header->isWriterEnabled) {
+        header->isWriterEnabled = false;
+        header->isWriterBlocking = false;
+        std::lock_guard<BufferLayout::Mutex> dataAvailableLock(header->dataAvailableMutex);
+        header->hasWriterBeenClosed = true;
+        header->dataAvailableConditionVariable.notify_all();
+    }
+
+    m_closed = true;
+}
+
+size_t Writer::getWordSize() const {
+    return m_bufferLayout->getHeader()->wordSize;
+}
+
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
@@ -18,33 +18,130 @@ namespace aisdk {
 namespace utils {
 namespace threading {
 
-TaskQueue::TaskQueue() : m_shutdown{false} {
+TaskQueue::TaskQueue() : m_queue(INITIAL_CAPACITY), m_queueHead{0}, m_queueSize{0}, m_shutdown{false}, m_strandScheduled{false} {
 }
 
-std::unique_ptr<std::function<void()>> TaskQueue::pop() {
+bool TaskQueue::pushTask(bool front, InlineTask task) {
+    bool scheduleStrand = false;
+    {
+        std::lock_guard<std::mutex> queueLock{m_queueMutex};
+        if (m_shutdown) {
+            return false;
+        }
+
+        if (m_queueSize == m_queue.size()) {
+            // Full: unroll the ring into a larger one.
+            std::vector<InlineTask> larger(m_queue.size() * 2);
+            for (size_t i = 0; i < m_queueSize; ++i) {
+                larger[i] = std::move(m_queue[(m_queueHead + i) % m_queue.size()]);
+            }
+            m_queue.swap(larger);
+            m_queueHead = 0;
+        }
+        if (front) {
+            m_queueHead = (m_queueHead + m_queue.size() - 1) % m_queue.size();
+            m_queue[m_queueHead] = std::move(task);
+        } else {
+            m_queue[(m_queueHead + m_queueSize) % m_queue.size()] = std::move(task);
+        }
+        ++m_queueSize;
+
+        if (m_onReady && !m_strandScheduled) {
+            m_strandScheduled = true;
+            scheduleStrand = true;
+        }
+    }
+
+    if (m_onReady) {
+        // A strand has nobody waiting in pop(); hand it to the pool instead.
+        if (scheduleStrand) {
+            m_onReady();
+        }
+    } else {
+        // Only the TaskThread waits in pop().
+        m_queueChanged.notify_one();
+    }
+    return true;
+}
+
+InlineTask TaskQueue::takeFrontLocked() {
+    auto task = std::move(m_queue[m_queueHead]);
+    m_queueHead = (m_queueHead + 1) % m_queue.size();
+    --m_queueSize;
+    return task;
+}
+
+InlineTask TaskQueue::pop() {
     std::unique_lock<std::mutex> queueLock{m_queueMutex};
 
-    auto shouldNotWait = [this]() { return m_shutdown || !m_queue.empty(); };
+    auto shouldNotWait = [this]() { return m_shutdown || m_queueSize != 0; };
 
     if (!shouldNotWait()) {
         m_queueChanged.wait(queueLock, shouldNotWait);
     }
 
-    if (!m_queue.empty()) {
-        auto task = std::move(m_queue.front());
-
-        m_queue.pop_front();
-        return task;
+    if (m_queueSize != 0) {
+        return takeFrontLocked();
     }
 
-    return nullptr;
+    return InlineTask();
 }
 
-void TaskQueue::shutdown() {
+void TaskQueue::setReadyCallback(std::function<void()> onReady) {
     std::lock_guard<std::mutex> queueLock{m_queueMutex};
-    m_queue.clear();
+    m_onReady = std::move(onReady);
+}
+
+bool TaskQueue::runStrand(size_t maxTasks) {
+    std::unique_lock<std::mutex> queueLock{m_queueMutex};
+    for (size_t i = 0;; ++i) {
+        if (0 == m_queueSize || m_shutdown) {
+            m_strandScheduled = false;
+            return false;
+        }
+        if (i == maxTasks) {
+            return true;
+        }
+
+        auto task = takeFrontLocked();
+        m_strandRunner = std::this_thread::get_id();
+        queueLock.unlock();
+
+        try {
+            task();
+        } catch (...) {
+            // Tasks queued with pushTask() have nobody to report to.
+        }
+        task.reset();
+
+        queueLock.lock();
+        m_strandRunner = std::thread::id();
+        if (m_shutdown) {
+            // shutdown() may be waiting for this task to return.
+            m_queueChanged.notify_all();
+        }
+    }
+}
+
+void TaskQueue::shutdown() {
+    std::vector<InlineTask> dropped;
+    std::unique_lock<std::mutex> queueLock{m_queueMutex};
+    dropped.swap(m_queue);
+    m_queueHead = 0;
+    m_queueSize = 0;
     m_shutdown = true;
     m_queueChanged.notify_all();
+
+    if (m_onReady) {
+        // Like joining the TaskThread: don't return while a task of this strand is still running elsewhere.
+        auto thisThread = std::this_thread::get_id();
+        m_queueChanged.wait(queueLock, [this, thisThread]() {
+            return m_strandRunner == std::thread::id() || m_strandRunner == thisThread;
+        });
+    }
+
+    // The dropped tasks are destroyed after the lock is released, so whatever they captured may use the queue.
+    queueLock.unlock();
 }
 
 bool TaskQueue::isShutdown() {
@@ -44,7 +44,11 @@ void TaskThread::processTasksLoop() {
             auto task = m_actualTaskQueue->pop();
 
             if (task) {
-                task->operator()();
+                try {
+                    task();
+                } catch (...) {
+                    // Tasks queued with TaskQueue::pushTask() have nobody to report to.
+                }
             }
         } else {
             // Since we could not get a shared pointer to the the TaskQueue, it must have been destroyed.
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "Utils/Logging/Logger.h"
+#include "Utils/Threading/WorkerPool.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("WorkerPool");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace utils {
+namespace threading {
+
+/// The most tasks of one strand a thread runs before moving on to the next ready strand.
+static const size_t TASKS_PER_TURN = 8;
+
+/// Guards @c defaultPool.
+static std::mutex defaultPoolMutex;
+
+/// The pool new executors run on, if any.
+static std::shared_ptr<WorkerPool> defaultPool;
+
+/**
+ * Shuts down a strand its pool will no longer run, so its queued tasks are dropped (breaking their futures) and
+ * later pushes are rejected, rather than waiting for a thread that never comes.
+ *
+ * @param strand The strand.
+ */
+static void abandonStrand(const std::shared_ptr<TaskQueue>& strand) {
+    AISDK_WARN(LX("abandonStrand").d("reason", "poolShutdown"));
+    strand->shutdown();
+}
+
+std::shared_ptr<WorkerPool> WorkerPool::create(size_t numThreads) {
+    if (0 == numThreads) {
+        return nullptr;
+    }
+    return std::shared_ptr<WorkerPool>(new WorkerPool(numThreads));
+}
+
+void WorkerPool::setDefault(std::shared_ptr<WorkerPool> pool) {
+    std::lock_guard<std::mutex> lock{defaultPoolMutex};
+    defaultPool = std::move(pool);
+}
+
+std::shared_ptr<WorkerPool> WorkerPool::getDefault() {
+    std::lock_guard<std::mutex> lock{defaultPoolMutex};
+    return defaultPool;
+}
+
+WorkerPool::WorkerPool(size_t numThreads) : m_shutdown{false} {
+    m_threads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    std::deque<std::shared_ptr<TaskQueue>> dropped;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        m_shutdown = true;
+        dropped.swap(m_ready);
+    }
+    m_wakeTrigger.notify_all();
+
+    // None of these is running, so shutting them down doesn't wait.  Strands running now are abandoned by schedule().
+    for (auto& strand : dropped) {
+        abandonStrand(strand);
+    }
+
+    for (auto& thread : m_threads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+}
+
+std::shared_ptr<TaskQueue> WorkerPool::createStrand() {
+    auto strand = std::make_shared<TaskQueue>();
+    std::weak_ptr<WorkerPool> weakPool = shared_from_this();
+    std::weak_ptr<TaskQueue> weakStrand = strand;
+    strand->setReadyCallback([weakPool, weakStrand]() {
+        auto pool = weakPool.lock();
+        auto strand = weakStrand.lock();
+        if (!strand) {
+            return;
+        }
+        if (pool) {
+            pool->schedule(std::move(strand));
+        } else {
+            abandonStrand(strand);
+        }
+    });
+    return strand;
+}
+
+size_t WorkerPool::getNumThreads() const {
+    return m_threads.size();
+}
+
+void WorkerPool::schedule(std::shared_ptr<TaskQueue> strand) {
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        if (m_shutdown) {
+            lock.unlock();
+            abandonStrand(strand);
+            return;
+        }
+        m_ready.push_back(std::move(strand));
+    }
+    m_wakeTrigger.notify_one();
+}
+
+void WorkerPool::workerLoop() {
+    while (true) {
+        std::shared_ptr<TaskQueue> strand;
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_wakeTrigger.wait(lock, [this]() { return m_shutdown || !m_ready.empty(); });
+            if (m_shutdown) {
+                return;
+            }
+            strand = std::move(m_ready.front());
+            m_ready.pop_front();
+        }
+
+        if (strand->runStrand(TASKS_PER_TURN)) {
+            schedule(std::move(strand));
+        }
+    }
+}
+
+}  // namespace threading
+}  // namespace utils
+}  // namespace aisdk
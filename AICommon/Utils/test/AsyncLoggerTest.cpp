@@ -0,0 +1,185 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Utils/Logging/AsyncLogger.h>
+
+namespace aisdk {
+namespace utils {
+namespace logging {
+namespace test {
+
+/// One line as the wrapped sink saw it.
+struct Line {
+    Level level;
+    std::string threadMoniker;
+    std::string text;
+};
+
+/**
+ * A sink which keeps the lines it is given, optionally holding up the first one until released.
+ */
+class RecordingLogger : public Logger {
+public:
+    RecordingLogger() : Logger(Level::DEBUG5), m_holdFirst{false}, m_released{m_release.get_future().share()} {
+    }
+
+    void emit(Level level, std::chrono::system_clock::time_point time, const char* threadMoniker, const char* text)
+        override {
+        if (m_holdFirst) {
+            m_holdFirst = false;
+            m_entered.set_value();
+            m_released.wait();
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lines.push_back({level, threadMoniker, text});
+    }
+
+    std::vector<Line> getLines() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_lines;
+    }
+
+    /// Makes the first line block the background thread until @c release().
+    void holdFirst() {
+        m_holdFirst = true;
+    }
+
+    /// Waits for the background thread to be held up in @c emit().
+    void waitUntilHeld() {
+        m_entered.get_future().wait();
+    }
+
+    void release() {
+        m_release.set_value();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<Line> m_lines;
+    std::atomic<bool> m_holdFirst;
+    std::promise<void> m_entered;
+    std::promise<void> m_release;
+    std::shared_future<void> m_released;
+};
+
+/// Lines reach the sink in order and intact, including ones longer than a ring slot.
+TEST(AsyncLoggerTest, test_linesReachSinkInOrder) {
+    auto sink = std::make_shared<RecordingLogger>();
+    auto logger = AsyncLogger::create(sink);
+    ASSERT_TRUE(logger);
+
+    std::string longText(1000, 'x');
+    logger->emit(Level::INFO, std::chrono::system_clock::now(), "a", "first");
+    logger->emit(Level::ERROR, std::chrono::system_clock::now(), "a-very-long-thread-moniker", longText.c_str());
+    logger->emit(Level::WARN, std::chrono::system_clock::now(), "b", "third");
+    logger->flush();
+
+    auto lines = sink->getLines();
+    ASSERT_EQ(3u, lines.size());
+    EXPECT_EQ("first", lines[0].text);
+    EXPECT_EQ(Level::INFO, lines[0].level);
+    EXPECT_EQ(longText, lines[1].text);
+    EXPECT_EQ("a-very-long-thr", lines[1].threadMoniker);
+    EXPECT_EQ("third", lines[2].text);
+    EXPECT_EQ(0u, logger->getDroppedCount());
+}
+
+/// Lines from many threads all arrive, each thread's in the order it logged them.
+TEST(AsyncLoggerTest, test_concurrentProducers) {
+    const int numThreads = 4;
+    const int linesPerThread = 2000;
+    auto sink = std::make_shared<RecordingLogger>();
+    auto logger = AsyncLogger::create(sink, numThreads * linesPerThread);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < numThreads; ++t) {
+        producers.emplace_back([&logger, t, linesPerThread]() {
+            auto moniker = std::to_string(t);
+            for (int n = 0; n < linesPerThread; ++n) {
+                logger->emit(Level::INFO, std::chrono::system_clock::now(), moniker.c_str(), std::to_string(n).c_str());
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    logger->flush();
+
+    std::map<std::string, int> next;
+    auto lines = sink->getLines();
+    ASSERT_EQ(static_cast<size_t>(numThreads * linesPerThread), lines.size());
+    for (auto& line : lines) {
+        EXPECT_EQ(std::to_string(next[line.threadMoniker]++), line.text);
+    }
+}
+
+/// A full ring drops new lines instead of blocking, and the drop is reported once there is room.
+TEST(AsyncLoggerTest, test_fullRingDropsAndReports) {
+    auto sink = std::make_shared<RecordingLogger>();
+    sink->holdFirst();
+    auto logger = AsyncLogger::create(sink, 8);
+
+    logger->emit(Level::INFO, std::chrono::system_clock::now(), "a", "held");
+    sink->waitUntilHeld();
+    for (int n = 0; n < 20; ++n) {
+        logger->emit(Level::INFO, std::chrono::system_clock::now(), "a", "filler");
+    }
+    // The held line keeps its slot until the sink returns, so 7 of the fillers fit.
+    EXPECT_EQ(13u, logger->getDroppedCount());
+
+    sink->release();
+    logger->flush();
+    auto lines = sink->getLines();
+    ASSERT_EQ(9u, lines.size());
+    EXPECT_EQ(Level::WARN, lines.back().level);
+    EXPECT_EQ("AsyncLogger:linesDropped:count=13", lines.back().text);
+}
+
+/// The level follows the wrapped sink and changes go to both.
+TEST(AsyncLoggerTest, test_levelFollowsSink) {
+    auto sink = std::make_shared<RecordingLogger>();
+    sink->setLevel(Level::WARN);
+    auto logger = AsyncLogger::create(sink);
+    EXPECT_EQ(Level::WARN, logger->getLevel());
+
+    logger->setLevel(Level::ERROR);
+    EXPECT_EQ(Level::ERROR, logger->getLevel());
+    EXPECT_EQ(Level::ERROR, sink->getLevel());
+    EXPECT_FALSE(logger->shouldLog(Level::WARN));
+}
+
+/// Lines still in the ring when the logger goes away are emitted, not lost.
+TEST(AsyncLoggerTest, test_destructorDrains) {
+    auto sink = std::make_shared<RecordingLogger>();
+    {
+        auto logger = AsyncLogger::create(sink);
+        for (int n = 0; n < 100; ++n) {
+            logger->emit(Level::INFO, std::chrono::system_clock::now(), "a", "line");
+        }
+    }
+    EXPECT_EQ(100u, sink->getLines().size());
+}
+
+}  // namespace test
+}  // namespace logging
+}  // namespace utils
+}  // namespace aisdk
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Utils/Microphone/ChannelRemap.h>
+
+namespace aisdk {
+namespace utils {
+namespace microphone {
+namespace test {
+
+/// The silence entry, as a local so gtest macros can take it by reference.
+static const int SILENT = ChannelRemap::SILENCE;
+
+/// The channel layout the SoundAi front end expects from the 8-channel microphone array.
+static const std::vector<int> MIC_ARRAY_MAP = {0, 2, 4, 7, SILENT, SILENT, SILENT, SILENT};
+
+/// A frame count which is not a multiple of the vector width, so the scalar tail is exercised too.
+static const size_t NUM_FRAMES = 203;
+
+/**
+ * Builds interleaved input in which every sample encodes its own frame and channel.
+ *
+ * @param channels The number of interleaved channels.
+ * @param nFrames The number of frames.
+ * @return The samples.
+ */
+static std::vector<int16_t> makeInput(size_t channels, size_t nFrames) {
+    std::vector<int16_t> input(channels * nFrames);
+    for (size_t f = 0; f < nFrames; ++f) {
+        for (size_t c = 0; c < channels; ++c) {
+            input[f * channels + c] = static_cast<int16_t>((f * 16 + c) * ((f % 2) ? -1 : 1));
+        }
+    }
+    return input;
+}
+
+/// Expected sample for output channel @c c of frame @c f of input from @c makeInput().
+static int16_t expected(const std::vector<int>& map, const std::vector<int16_t>& input, size_t channels, size_t f, size_t c) {
+    return (SILENT == map[c]) ? 0 : input[f * channels + map[c]];
+}
+
+/// Invalid maps are refused.
+TEST(ChannelRemapTest, createRejectsInvalidMaps) {
+    EXPECT_EQ(nullptr, ChannelRemap::create(0, {0}));
+    EXPECT_EQ(nullptr, ChannelRemap::create(8, {}));
+    EXPECT_EQ(nullptr, ChannelRemap::create(8, {0, 8}));
+    EXPECT_EQ(nullptr, ChannelRemap::create(8, {-2}));
+    EXPECT_NE(nullptr, ChannelRemap::create(8, MIC_ARRAY_MAP));
+}
+
+/// The microphone array map produces the same result as the per-sample code it replaces.
+TEST(ChannelRemapTest, remapMicArray) {
+    auto remap = ChannelRemap::create(8, MIC_ARRAY_MAP);
+    ASSERT_NE(nullptr, remap);
+    auto input = makeInput(8, NUM_FRAMES);
+    std::vector<int16_t> output(8 * NUM_FRAMES, 0x7fff);
+
+    remap->remap(input.data(), output.data(), NUM_FRAMES);
+
+    for (size_t f = 0; f < NUM_FRAMES; ++f) {
+        for (size_t c = 0; c < 8; ++c) {
+            ASSERT_EQ(expected(MIC_ARRAY_MAP, input, 8, f, c), output[f * 8 + c]) << "frame " << f << " channel " << c;
+        }
+    }
+}
+
+/// The vector kernels agree with the scalar reference for permutations, duplicates and silence.
+TEST(ChannelRemapTest, remapMatchesScalar) {
+    const std::vector<std::vector<int>> maps = {
+        {7, 6, 5, 4, 3, 2, 1, 0}, {1, 1, 1, 1, SILENT, 3, 3, 0}, {SILENT, SILENT, SILENT, SILENT, SILENT, SILENT, SILENT, SILENT}};
+    auto input = makeInput(8, NUM_FRAMES);
+    for (const auto& map : maps) {
+        auto remap = ChannelRemap::create(8, map);
+        ASSERT_NE(nullptr, remap);
+        std::vector<int16_t> vectorOutput(8 * NUM_FRAMES);
+        std::vector<int16_t> scalarOutput(8 * NUM_FRAMES);
+        remap->remap(input.data(), vectorOutput.data(), NUM_FRAMES);
+        remap->remapScalar(input.data(), scalarOutput.data(), NUM_FRAMES);
+        EXPECT_EQ(scalarOutput, vectorOutput) << "kernel " << ChannelRemap::getKernelName();
+    }
+}
+
+/// Shapes without a vector kernel still remap correctly.
+TEST(ChannelRemapTest, remapOtherShapes) {
+    const std::vector<int> map = {5, SILENT, 0};
+    auto remap = ChannelRemap::create(6, map);
+    ASSERT_NE(nullptr, remap);
+    EXPECT_EQ(3u, remap->getOutputChannels());
+    auto input = makeInput(6, NUM_FRAMES);
+    std::vector<int16_t> output(3 * NUM_FRAMES);
+
+    remap->remap(input.data(), output.data(), NUM_FRAMES);
+
+    for (size_t f = 0; f < NUM_FRAMES; ++f) {
+        for (size_t c = 0; c < 3; ++c) {
+            ASSERT_EQ(expected(map, input, 6, f, c), output[f * 3 + c]);
+        }
+    }
+}
+
+/// Deinterleaving writes one plane per output channel and agrees with the scalar reference.
+TEST(ChannelRemapTest, deinterleave) {
+    const std::vector<int> map = {3, 0, SILENT, 7, 7};
+    auto remap = ChannelRemap::create(8, map);
+    ASSERT_NE(nullptr, remap);
+    auto input = makeInput(8, NUM_FRAMES);
+
+    std::vector<std::vector<int16_t>> planes(map.size(), std::vector<int16_t>(NUM_FRAMES, 0x7fff));
+    std::vector<std::vector<int16_t>> scalarPlanes(map.size(), std::vector<int16_t>(NUM_FRAMES));
+    std::vector<int16_t*> planePointers;
+    std::vector<int16_t*> scalarPlanePointers;
+    for (size_t c = 0; c < map.size(); ++c) {
+        planePointers.push_back(planes[c].data());
+        scalarPlanePointers.push_back(scalarPlanes[c].data());
+    }
+
+    remap->deinterleave(input.data(), planePointers.data(), NUM_FRAMES);
+    remap->deinterleaveScalar(input.data(), scalarPlanePointers.data(), NUM_FRAMES);
+
+    EXPECT_EQ(scalarPlanes, planes);
+    for (size_t c = 0; c < map.size(); ++c) {
+        for (size_t f = 0; f < NUM_FRAMES; ++f) {
+            ASSERT_EQ(expected(map, input, 8, f, c), planes[c][f]) << "frame " << f << " channel " << c;
+        }
+    }
+}
+
+}  // namespace test
+}  // namespace microphone
+}  // namespace utils
+}  // namespace aisdk
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <Utils/Logging/LogStringFormatter.h>
+
+namespace aisdk {
+namespace utils {
+namespace logging {
+namespace test {
+
+/// The length of "YYYY-MM-DD HH:MM:SS.mmm".
+static const size_t TIMESTAMP_LENGTH = 23;
+
+/// 2019-12-31 23:59:59 UTC in seconds since the epoch.
+static const int64_t NEW_YEARS_EVE_LAST_SECOND = 1577836799;
+
+/**
+ * Builds a time point from milliseconds since the epoch.
+ */
+static std::chrono::system_clock::time_point atMillis(int64_t millis) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::milliseconds(millis)));
+}
+
+/**
+ * Formats an empty line at a time and returns just its timestamp.
+ */
+static std::string timestampAt(LogStringFormatter& formatter, int64_t millis) {
+    return formatter.format(Level::INFO, atMillis(millis), "0", "").substr(0, TIMESTAMP_LENGTH);
+}
+
+/**
+ * Verify the whole line has the layout the sinks and log readers expect.
+ */
+TEST(LogStringFormatterTest, test_lineLayout) {
+    LogStringFormatter formatter(std::chrono::seconds(0));
+    EXPECT_EQ(
+        "2019-12-31 23:59:59.007 [1f] INFO hello",
+        formatter.format(Level::INFO, atMillis(NEW_YEARS_EVE_LAST_SECOND * 1000 + 7), "1f", "hello"));
+    EXPECT_EQ(
+        "2019-12-31 23:59:59.120 [ab] ERROR oops",
+        formatter.format(Level::ERROR, atMillis(NEW_YEARS_EVE_LAST_SECOND * 1000 + 120), "ab", "oops"));
+}
+
+/**
+ * Verify the cached seconds are re-rendered when a line falls in the next second.
+ */
+TEST(LogStringFormatterTest, test_secondRollover) {
+    LogStringFormatter formatter(std::chrono::seconds(0));
+    const int64_t base = (NEW_YEARS_EVE_LAST_SECOND - 10) * 1000;
+    EXPECT_EQ("2019-12-31 23:59:49.000", timestampAt(formatter, base));
+    EXPECT_EQ("2019-12-31 23:59:49.999", timestampAt(formatter, base + 999));
+    EXPECT_EQ("2019-12-31 23:59:50.000", timestampAt(formatter, base + 1000));
+    EXPECT_EQ("2019-12-31 23:59:50.001", timestampAt(formatter, base + 1001));
+}
+
+/**
+ * Verify the date moves on at midnight, and into the next year.
+ */
+TEST(LogStringFormatterTest, test_dayRollover) {
+    LogStringFormatter formatter(std::chrono::seconds(0));
+    const int64_t lastMilli = NEW_YEARS_EVE_LAST_SECOND * 1000 + 999;
+    EXPECT_EQ("2019-12-31 23:59:59.999", timestampAt(formatter, lastMilli));
+    EXPECT_EQ("2020-01-01 00:00:00.000", timestampAt(formatter, lastMilli + 1));
+    // Going back in time must not keep the newer cached date.
+    EXPECT_EQ("2019-12-31 23:59:59.999", timestampAt(formatter, lastMilli));
+}
+
+/**
+ * Verify a positive offset moves the date on at 16:00 UTC, as China Standard Time does.
+ */
+TEST(LogStringFormatterTest, test_positiveOffsetCrossesDay) {
+    LogStringFormatter formatter(std::chrono::hours(8));
+    const int64_t utcFourPm = (NEW_YEARS_EVE_LAST_SECOND + 1 - 8 * 3600) * 1000;
+    EXPECT_EQ("2019-12-31 23:59:59.999", timestampAt(formatter, utcFourPm - 1));
+    EXPECT_EQ("2020-01-01 00:00:00.000", timestampAt(formatter, utcFourPm));
+}
+
+/**
+ * Verify a negative offset, including one with minutes.
+ */
+TEST(LogStringFormatterTest, test_negativeOffset) {
+    LogStringFormatter formatter(-(std::chrono::hours(3) + std::chrono::minutes(30)));
+    EXPECT_EQ("2019-12-31 20:29:59.500", timestampAt(formatter, NEW_YEARS_EVE_LAST_SECOND * 1000 + 500));
+}
+
+/**
+ * Verify leap days and times before the epoch.
+ */
+TEST(LogStringFormatterTest, test_leapDayAndBeforeEpoch) {
+    LogStringFormatter formatter(std::chrono::seconds(0));
+    // 2020-02-29 12:00:00 UTC.
+    EXPECT_EQ("2020-02-29 12:00:00.000", timestampAt(formatter, 1582977600000LL));
+    EXPECT_EQ("2020-03-01 00:00:00.000", timestampAt(formatter, 1583020800000LL));
+    // 2000 is a leap year, 2100 is not.
+    EXPECT_EQ("2000-02-29 00:00:00.000", timestampAt(formatter, 951782400000LL));
+    EXPECT_EQ("2100-03-01 00:00:00.000", timestampAt(formatter, 4107542400000LL));
+    // One millisecond before the epoch.
+    EXPECT_EQ("1969-12-31 23:59:59.999", timestampAt(formatter, -1));
+}
+
+/**
+ * Verify the date and time agree with @c gmtime() over a spread of times.
+ */
+TEST(LogStringFormatterTest, test_matchesGmtime) {
+    LogStringFormatter formatter(std::chrono::seconds(0));
+    // Step by a prime number of seconds so every time of day and day of month comes up.
+    for (int64_t second = 0; second < 4102444800LL; second += 999983) {
+        std::time_t asTimeT = static_cast<std::time_t>(second);
+        std::tm utc;
+        ASSERT_NE(nullptr, gmtime_r(&asTimeT, &utc));
+        char expected[32];
+        std::strftime(expected, sizeof(expected), "%Y-%m-%d %H:%M:%S.000", &utc);
+        ASSERT_EQ(expected, timestampAt(formatter, second * 1000)) << "second=" << second;
+    }
+}
+
+/**
+ * Verify the offsets accepted on the command line.
+ */
+TEST(LogStringFormatterTest, test_parseUtcOffset) {
+    std::chrono::seconds offset;
+    ASSERT_TRUE(LogStringFormatter::parseUtcOffset("+08:00", &offset));
+    EXPECT_EQ(std::chrono::seconds(8 * 3600), offset);
+    ASSERT_TRUE(LogStringFormatter::parseUtcOffset("+0545", &offset));
+    EXPECT_EQ(std::chrono::seconds(5 * 3600 + 45 * 60), offset);
+    ASSERT_TRUE(LogStringFormatter::parseUtcOffset("-03", &offset));
+    EXPECT_EQ(std::chrono::seconds(-3 * 3600), offset);
+
+    offset = std::chrono::seconds(42);
+    EXPECT_FALSE(LogStringFormatter::parseUtcOffset("", &offset));
+    EXPECT_FALSE(LogStringFormatter::parseUtcOffset("8", &offset));
+    EXPECT_FALSE(LogStringFormatter::parseUtcOffset("+8", &offset));
+    EXPECT_FALSE(LogStringFormatter::parseUtcOffset("+08:0", &offset));
+    EXPECT_FALSE(LogStringFormatter::parseUtcOffset("+0a00", &offset));
+    EXPECT_FALSE(LogStringFormatter::parseUtcOffset("+15:00", &offset));
+    EXPECT_FALSE(LogStringFormatter::parseUtcOffset("+08:60", &offset));
+    EXPECT_EQ(std::chrono::seconds(42), offset);
+}
+
+}  // namespace test
+}  // namespace logging
+}  // namespace utils
+}  // namespace aisdk
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Utils/SharedBuffer/SharedBuffer.h>
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+namespace test {
+
+/// The number of words the buffer under test holds.
+static const size_t BUFFER_WORDS = 16;
+
+/// A short timeout, for waits which are expected to time out.
+static const std::chrono::milliseconds SHORT_TIMEOUT(50);
+
+/// How long to wait for something which is expected to happen.
+static const std::chrono::seconds LONG_TIMEOUT(5);
+
+class SharedBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto buffer = std::make_shared<RawBuffer>(SharedBuffer::calculateBufferSize(BUFFER_WORDS));
+        m_sharedBuffer = SharedBuffer::create(buffer);
+        ASSERT_NE(nullptr, m_sharedBuffer);
+        ASSERT_EQ(BUFFER_WORDS, m_sharedBuffer->getDataSize());
+    }
+
+    /// Writes @c count words counting up from @c first.
+    void writeSequence(Writer* writer, size_t count, uint8_t first) {
+        std::vector<uint8_t> words(count);
+        for (size_t i = 0; i < count; ++i) {
+            words[i] = static_cast<uint8_t>(first + i);
+        }
+        ASSERT_EQ(static_cast<ssize_t>(count), writer->write(words.data(), words.size()));
+    }
+
+    std::unique_ptr<SharedBuffer> m_sharedBuffer;
+};
+
+/**
+ * Verify that data across the end of the ring is exposed as two spans, in order, and can be consumed as one.
+ */
+TEST_F(SharedBufferTest, test_peekSplitsAtWrapPoint) {
+    auto writer = m_sharedBuffer->createWriter(Writer::Policy::BLOCKING);
+    auto reader = m_sharedBuffer->createReader(Reader::Policy::NONBLOCKING);
+    ASSERT_NE(nullptr, writer);
+    ASSERT_NE(nullptr, reader);
+
+    std::vector<uint8_t> skipped(BUFFER_WORDS - 2);
+    writeSequence(writer.get(), skipped.size(), 0);
+    ASSERT_EQ(static_cast<ssize_t>(skipped.size()), reader->read(skipped.data(), skipped.size()));
+
+    writeSequence(writer.get(), 5, 100);
+    Reader::Spans spans;
+    ASSERT_EQ(5, reader->peek(&spans, 5));
+    ASSERT_EQ(2u, spans.first.nWords);
+    ASSERT_EQ(3u, spans.second.nWords);
+    EXPECT_EQ(100, spans.first.data[0]);
+    EXPECT_EQ(101, spans.first.data[1]);
+    EXPECT_EQ(102, spans.second.data[0]);
+    EXPECT_EQ(104, spans.second.data[2]);
+
+    // Peeking doesn't move the reader.
+    ASSERT_EQ(5, reader->peek(&spans, 5));
+    EXPECT_EQ(100, spans.first.data[0]);
+    EXPECT_EQ(5, reader->consume(5));
+    EXPECT_EQ(Reader::Error::WOULDBLOCK, reader->peek(&spans, 1));
+}
+
+/**
+ * Verify that consuming more than has been written is rejected and leaves the reader where it was.
+ */
+TEST_F(SharedBufferTest, test_consumeBeyondWriterIsInvalid) {
+    auto writer = m_sharedBuffer->createWriter(Writer::Policy::BLOCKING);
+    auto reader = m_sharedBuffer->createReader(Reader::Policy::NONBLOCKING);
+    ASSERT_NE(nullptr, writer);
+    ASSERT_NE(nullptr, reader);
+
+    writeSequence(writer.get(), 3, 0);
+    Reader::Spans spans;
+    ASSERT_EQ(3, reader->peek(&spans, 8));
+    EXPECT_EQ(Reader::Error::INVALID, reader->consume(4));
+    EXPECT_EQ(0u, reader->tell());
+    EXPECT_EQ(3, reader->consume(3));
+}
+
+/**
+ * Verify that a non-blockable writer lapping the data a reader is looking at makes @c consume() report an overrun,
+ * even when it overwrites no more than the peeked words.
+ */
+TEST_F(SharedBufferTest, test_writerLappingPeekedDataOverruns) {
+    auto writer = m_sharedBuffer->createWriter(Writer::Policy::NONBLOCKABLE);
+    auto reader = m_sharedBuffer->createReader(Reader::Policy::NONBLOCKING);
+    ASSERT_NE(nullptr, writer);
+    ASSERT_NE(nullptr, reader);
+
+    writeSequence(writer.get(), 4, 0);
+    Reader::Spans spans;
+    ASSERT_EQ(4, reader->peek(&spans, 4));
+    EXPECT_EQ(0, spans.first.data[0]);
+
+    // The whole ring goes round once more, so the last write lands on the first peeked word.
+    writeSequence(writer.get(), BUFFER_WORDS - 4, 4);
+    writeSequence(writer.get(), 1, 200);
+    EXPECT_EQ(200, spans.first.data[0]);
+    EXPECT_EQ(Reader::Error::OVERRUN, reader->consume(4));
+}
+
+/**
+ * Verify that @c wait() hands back what arrived when it times out, and reports a closed stream once the writer has
+ * closed and the data is read.
+ */
+TEST_F(SharedBufferTest, test_waitReturnsPartialCountThenClosed) {
+    auto writer = m_sharedBuffer->createWriter(Writer::Policy::BLOCKING);
+    auto reader = m_sharedBuffer->createReader(Reader::Policy::BLOCKING);
+    ASSERT_NE(nullptr, writer);
+    ASSERT_NE(nullptr, reader);
+
+    EXPECT_EQ(Reader::Error::TIMEDOUT, reader->wait(8, SHORT_TIMEOUT));
+    writeSequence(writer.get(), 3, 0);
+    EXPECT_EQ(3, reader->wait(8, SHORT_TIMEOUT));
+
+    std::vector<uint8_t> words(3);
+    ASSERT_EQ(3, reader->read(words.data(), words.size()));
+
+    // A reader waiting with no timeout is woken by the writer closing.
+    auto waited = std::async(std::launch::async, [&reader]() { return reader->wait(8); });
+    std::this_thread::sleep_for(SHORT_TIMEOUT);
+    writer->close();
+    ASSERT_EQ(std::future_status::ready, waited.wait_for(LONG_TIMEOUT));
+    EXPECT_EQ(Reader::Error::CLOSED, waited.get());
+    EXPECT_EQ(Reader::Error::CLOSED, reader->wait(8, SHORT_TIMEOUT));
+}
+
+}  // namespace test
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
@@ -0,0 +1,277 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Utils/SharedBuffer/SharedBuffer.h>
+#include <Utils/SharedBuffer/SharedMemoryBuffer.h>
+
+namespace aisdk {
+namespace utils {
+namespace sharedbuffer {
+namespace test {
+
+/// The number of words the buffers under test hold.
+static const size_t BUFFER_WORDS = 64;
+
+/// The number of words a child process writes, enough to wrap the ring several times.
+static const size_t STREAM_WORDS = BUFFER_WORDS * 8;
+
+/// How long either side waits for the other before giving up.
+static const std::chrono::seconds TIMEOUT(5);
+
+/// Exit status of a child process which did everything it was asked to.
+static const int CHILD_SUCCEEDED = 0;
+
+/// Exit status of a child process which couldn't do what it was asked to.
+static const int CHILD_FAILED = 1;
+
+/// The word at @c index of the stream the tests send between processes.
+static uint8_t streamWord(size_t index) {
+    return static_cast<uint8_t>(index * 7 + 3);
+}
+
+/// Waits for a child process and returns its exit status, or -1 if it didn't exit normally.
+static int waitForChild(pid_t pid) {
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status)) {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+/**
+ * Writes the test stream in a child process.  Runs without gtest, as the child only reports through its status.
+ *
+ * @param name The name of the shared memory holding the @c SharedBuffer.
+ * @return The exit status for the child.
+ */
+static int writeStreamInChild(const std::string& name) {
+    auto sharedBuffer = SharedBuffer::open(SharedMemoryBuffer::open(name));
+    if (!sharedBuffer) {
+        return CHILD_FAILED;
+    }
+    auto writer = sharedBuffer->createWriter(Writer::Policy::BLOCKING);
+    if (!writer) {
+        return CHILD_FAILED;
+    }
+    for (size_t index = 0; index < STREAM_WORDS; ++index) {
+        uint8_t word = streamWord(index);
+        if (writer->write(&word, 1, TIMEOUT) != 1) {
+            return CHILD_FAILED;
+        }
+    }
+    writer->close();
+    return CHILD_SUCCEEDED;
+}
+
+/**
+ * Reads and checks the test stream in a child process.
+ *
+ * @param name The name of the shared memory holding the @c SharedBuffer.
+ * @param readyFd Written to once the reader is there, so the parent doesn't write before it.
+ * @return The exit status for the child.
+ */
+static int readStreamInChild(const std::string& name, int readyFd) {
+    auto sharedBuffer = SharedBuffer::open(SharedMemoryBuffer::open(name));
+    if (!sharedBuffer) {
+        return CHILD_FAILED;
+    }
+    auto reader = sharedBuffer->createReader(Reader::Policy::BLOCKING);
+    char ready = 1;
+    if (!reader || write(readyFd, &ready, 1) != 1) {
+        return CHILD_FAILED;
+    }
+    std::vector<uint8_t> words(BUFFER_WORDS / 4);
+    size_t index = 0;
+    ssize_t result;
+    while ((result = reader->read(words.data(), words.size(), TIMEOUT)) > 0) {
+        for (ssize_t i = 0; i < result; ++i, ++index) {
+            if (words[i] != streamWord(index)) {
+                return CHILD_FAILED;
+            }
+        }
+    }
+    return (Reader::Error::CLOSED == result && STREAM_WORDS == index) ? CHILD_SUCCEEDED : CHILD_FAILED;
+}
+
+class SharedMemoryBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_name = "/aisdk-SharedMemoryBufferTest-" + std::to_string(getpid());
+        m_size = SharedBuffer::calculateBufferSize(BUFFER_WORDS);
+        SharedMemoryBuffer::remove(m_name);
+    }
+
+    void TearDown() override {
+        SharedMemoryBuffer::remove(m_name);
+    }
+
+    /// @return The header at the start of a buffer holding a @c SharedBuffer.
+    static BufferLayout::Header* headerOf(const std::shared_ptr<RawBuffer>& buffer) {
+        return reinterpret_cast<BufferLayout::Header*>(buffer->data());
+    }
+
+    std::string m_name;
+    size_t m_size;
+};
+
+/**
+ * Verify that a named buffer can be created once and opened again, with both mappings showing the same memory.
+ */
+TEST_F(SharedMemoryBufferTest, test_createAndOpenByName) {
+    auto created = SharedMemoryBuffer::create(m_name, m_size);
+    ASSERT_NE(nullptr, created);
+    EXPECT_EQ(nullptr, SharedMemoryBuffer::create(m_name, m_size));
+
+    auto opened = SharedMemoryBuffer::open(m_name);
+    ASSERT_NE(nullptr, opened);
+    ASSERT_EQ(m_size, opened->size());
+    EXPECT_NE(created->data(), opened->data());
+    created->data()[m_size - 1] = 0x5a;
+    EXPECT_EQ(0x5a, opened->data()[m_size - 1]);
+
+    EXPECT_TRUE(SharedMemoryBuffer::remove(m_name));
+    EXPECT_FALSE(SharedMemoryBuffer::remove(m_name));
+    EXPECT_EQ(nullptr, SharedMemoryBuffer::open(m_name));
+}
+
+/**
+ * Verify that only memory holding a @c SharedBuffer of this layout version can be opened.
+ */
+TEST_F(SharedMemoryBufferTest, test_openChecksMagicAndVersion) {
+    auto buffer = SharedMemoryBuffer::create(m_name, m_size);
+    ASSERT_NE(nullptr, buffer);
+    EXPECT_EQ(nullptr, SharedBuffer::open(SharedMemoryBuffer::open(m_name)));
+
+    auto sharedBuffer = SharedBuffer::create(buffer);
+    ASSERT_NE(nullptr, sharedBuffer);
+    auto header = headerOf(buffer);
+
+    header->magic = ~BufferLayout::MAGIC_NUMBER;
+    EXPECT_EQ(nullptr, SharedBuffer::open(SharedMemoryBuffer::open(m_name)));
+    header->magic = BufferLayout::MAGIC_NUMBER;
+
+    header->version = BufferLayout::VERSION + 1;
+    EXPECT_EQ(nullptr, SharedBuffer::open(SharedMemoryBuffer::open(m_name)));
+    header->version = BufferLayout::VERSION;
+
+    EXPECT_NE(nullptr, SharedBuffer::open(SharedMemoryBuffer::open(m_name)));
+}
+
+/**
+ * Verify that each open counts as a reference, and the layout is torn down only when the last one is released.
+ */
+TEST_F(SharedMemoryBufferTest, test_detachCountsReferences) {
+    int fd = -1;
+    auto buffer = SharedMemoryBuffer::createAnonymous(m_size, &fd);
+    ASSERT_NE(nullptr, buffer);
+    auto header = headerOf(buffer);
+
+    auto creator = SharedBuffer::create(buffer);
+    ASSERT_NE(nullptr, creator);
+    auto opened = SharedBuffer::open(SharedMemoryBuffer::openFd(fd));
+    ASSERT_NE(nullptr, opened);
+    EXPECT_EQ(2u, header->referenceCount);
+
+    // A reader keeps the layout attached after the SharedBuffer it came from is gone.
+    auto reader = opened->createReader(Reader::Policy::NONBLOCKING);
+    ASSERT_NE(nullptr, reader);
+    opened.reset();
+    EXPECT_EQ(2u, header->referenceCount);
+    reader.reset();
+    EXPECT_EQ(1u, header->referenceCount);
+
+    creator.reset();
+    EXPECT_NE(BufferLayout::MAGIC_NUMBER, header->magic);
+    EXPECT_EQ(nullptr, SharedBuffer::open(SharedMemoryBuffer::openFd(fd)));
+    close(fd);
+}
+
+/**
+ * Verify that a stream written in a child process arrives intact in the parent.
+ */
+TEST_F(SharedMemoryBufferTest, test_writerInChildProcess) {
+    auto sharedBuffer = SharedBuffer::create(SharedMemoryBuffer::create(m_name, m_size));
+    ASSERT_NE(nullptr, sharedBuffer);
+    auto reader = sharedBuffer->createReader(Reader::Policy::BLOCKING);
+    ASSERT_NE(nullptr, reader);
+
+    pid_t pid = fork();
+    ASSERT_NE(-1, pid);
+    if (0 == pid) {
+        _exit(writeStreamInChild(m_name));
+    }
+
+    std::vector<uint8_t> words(BUFFER_WORDS / 2);
+    size_t index = 0;
+    ssize_t result;
+    bool intact = true;
+    while ((result = reader->read(words.data(), words.size(), TIMEOUT)) > 0) {
+        for (ssize_t i = 0; i < result; ++i, ++index) {
+            intact = intact && words[i] == streamWord(index);
+        }
+    }
+    EXPECT_EQ(Reader::Error::CLOSED, result);
+    EXPECT_EQ(STREAM_WORDS, index);
+    EXPECT_TRUE(intact);
+    EXPECT_EQ(CHILD_SUCCEEDED, waitForChild(pid));
+}
+
+/**
+ * Verify that a stream written in the parent arrives intact in a reader in a child process.
+ */
+TEST_F(SharedMemoryBufferTest, test_readerInChildProcess) {
+    auto sharedBuffer = SharedBuffer::create(SharedMemoryBuffer::create(m_name, m_size));
+    ASSERT_NE(nullptr, sharedBuffer);
+    auto writer = sharedBuffer->createWriter(Writer::Policy::BLOCKING);
+    ASSERT_NE(nullptr, writer);
+
+    int readyPipe[2];
+    ASSERT_EQ(0, pipe(readyPipe));
+    pid_t pid = fork();
+    ASSERT_NE(-1, pid);
+    if (0 == pid) {
+        close(readyPipe[0]);
+        _exit(readStreamInChild(m_name, readyPipe[1]));
+    }
+    close(readyPipe[1]);
+    char ready = 0;
+    bool childReady = read(readyPipe[0], &ready, 1) == 1;
+    close(readyPipe[0]);
+    if (!childReady) {
+        waitForChild(pid);
+        FAIL() << "child reader not created";
+    }
+
+    // The blocking writer waits for the child's reader to make room once the ring is full.
+    for (size_t index = 0; index < STREAM_WORDS; ++index) {
+        uint8_t word = streamWord(index);
+        ASSERT_EQ(1, writer->write(&word, 1, TIMEOUT));
+    }
+    writer->close();
+    EXPECT_EQ(CHILD_SUCCEEDED, waitForChild(pid));
+}
+
+}  // namespace test
+}  // namespace sharedbuffer
+}  // namespace utils
+}  // namespace aisdk
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <array>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Utils/Threading/Executor.h>
+#include <Utils/Threading/InlineTask.h>
+#include <Utils/Threading/TaskQueue.h>
+
+namespace aisdk {
+namespace utils {
+namespace threading {
+namespace test {
+
+/// How long to wait for submitted work before failing.
+static const std::chrono::seconds TIMEOUT(10);
+
+/// The captures of a typical component task fit inline; oversized ones go to the heap and still run.
+TEST(InlineTaskTest, test_smallCallablesStayInline) {
+    int calls = 0;
+    auto observer = std::make_shared<int>(0);
+    std::string name("SpeechSynthesizer");
+    InlineTask small([&calls, observer, name]() { ++calls; });
+    EXPECT_TRUE(small.isInline());
+
+    std::array<char, InlineTask::INLINE_SIZE + 1> big{};
+    InlineTask large([&calls, big]() { calls += big.size() > 0 ? 1 : 0; });
+    EXPECT_TRUE(static_cast<bool>(large));
+    EXPECT_FALSE(large.isInline());
+
+    InlineTask moved(std::move(large));
+    EXPECT_FALSE(static_cast<bool>(large));
+    small();
+    moved();
+    EXPECT_EQ(2, calls);
+}
+
+/// Moving and resetting a task destroys its captures exactly once.
+TEST(InlineTaskTest, test_capturesReleasedOnReset) {
+    auto resource = std::make_shared<int>(0);
+    InlineTask task([resource]() {});
+    EXPECT_EQ(2, resource.use_count());
+
+    InlineTask other;
+    other = std::move(task);
+    EXPECT_EQ(2, resource.use_count());
+    other.reset();
+    EXPECT_EQ(1, resource.use_count());
+}
+
+/// Tasks pushed to the back and the front keep their order while the ring grows past its initial size.
+TEST(TaskQueueTest, test_orderKeptWhileRingGrows) {
+    TaskQueue queue;
+    std::vector<int> order;
+    for (int n = 0; n < 40; ++n) {
+        queue.pushTask(false, InlineTask([&order, n]() { order.push_back(n); }));
+    }
+    queue.pushTask(true, InlineTask([&order]() { order.push_back(-1); }));
+
+    std::vector<int> expected{-1};
+    for (int n = 0; n < 40; ++n) {
+        expected.push_back(n);
+    }
+    for (size_t i = 0; i < expected.size(); ++i) {
+        auto task = queue.pop();
+        ASSERT_TRUE(static_cast<bool>(task));
+        task();
+    }
+    EXPECT_EQ(expected, order);
+
+    queue.shutdown();
+    EXPECT_FALSE(static_cast<bool>(queue.pop()));
+    EXPECT_FALSE(queue.pushTask(false, InlineTask([]() {})));
+}
+
+/// The future of a submitted task carries its result or exception, and its captures are gone by then.
+TEST(TaskQueueTest, test_submitFulfilsFutureAfterReleasingTask) {
+    Executor executor(nullptr);
+    auto resource = std::make_shared<int>(42);
+    std::weak_ptr<int> watcher = resource;
+
+    auto value = executor.submit([resource]() { return *resource; });
+    resource.reset();
+    ASSERT_EQ(std::future_status::ready, value.wait_for(TIMEOUT));
+    EXPECT_EQ(42, value.get());
+    EXPECT_TRUE(watcher.expired());
+
+    auto failure = executor.submit([]() -> int { throw std::runtime_error("failed"); });
+    EXPECT_THROW(failure.get(), std::runtime_error);
+}
+
+/// execute() runs tasks in order with submit() ones, and a throwing task does not stop the Executor.
+TEST(TaskQueueTest, test_executeWithoutFuture) {
+    Executor executor(nullptr);
+    std::vector<int> order;
+    EXPECT_TRUE(executor.execute([&order]() { order.push_back(1); }));
+    EXPECT_TRUE(executor.execute([]() { throw std::runtime_error("ignored"); }));
+    EXPECT_TRUE(executor.execute([&order](int n) { order.push_back(n); }, 2));
+    auto done = executor.submit([&order]() { order.push_back(3); });
+    ASSERT_EQ(std::future_status::ready, done.wait_for(TIMEOUT));
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), order);
+
+    executor.shutdown();
+    EXPECT_FALSE(executor.execute([]() {}));
+}
+
+}  // namespace test
+}  // namespace threading
+}  // namespace utils
+}  // namespace aisdk
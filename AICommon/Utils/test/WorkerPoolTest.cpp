@@ -0,0 +1,209 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Utils/Threading/Executor.h>
+#include <Utils/Threading/WorkerPool.h>
+
+namespace aisdk {
+namespace utils {
+namespace threading {
+namespace test {
+
+/// The number of threads of the pool under test.
+static const size_t NUM_POOL_THREADS = 3;
+
+/// More executors than pool threads, so strands have to share them.
+static const size_t NUM_EXECUTORS = 16;
+
+/// The number of tasks submitted to each executor.
+static const int TASKS_PER_EXECUTOR = 500;
+
+/// How long to wait for submitted work before failing.
+static const std::chrono::seconds TIMEOUT(10);
+
+/// Tasks submitted to one executor on a pool run in order and never overlap, even with other executors busy.
+TEST(WorkerPoolTest, test_submitOrderIsKeptPerExecutor) {
+    auto pool = WorkerPool::create(NUM_POOL_THREADS);
+    ASSERT_TRUE(pool);
+    EXPECT_EQ(NUM_POOL_THREADS, pool->getNumThreads());
+
+    std::vector<std::unique_ptr<Executor>> executors;
+    std::vector<std::vector<int>> seen(NUM_EXECUTORS);
+    std::vector<std::unique_ptr<std::atomic<int>>> running;
+    for (size_t i = 0; i < NUM_EXECUTORS; ++i) {
+        executors.emplace_back(new Executor(pool));
+        running.emplace_back(new std::atomic<int>(0));
+    }
+
+    std::atomic<bool> overlapped(false);
+    std::vector<std::future<void>> last(NUM_EXECUTORS);
+    for (int n = 0; n < TASKS_PER_EXECUTOR; ++n) {
+        for (size_t i = 0; i < NUM_EXECUTORS; ++i) {
+            last[i] = executors[i]->submit([&seen, &running, &overlapped, i, n]() {
+                if (running[i]->fetch_add(1) != 0) {
+                    overlapped = true;
+                }
+                seen[i].push_back(n);
+                running[i]->fetch_sub(1);
+            });
+        }
+    }
+
+    for (size_t i = 0; i < NUM_EXECUTORS; ++i) {
+        ASSERT_EQ(std::future_status::ready, last[i].wait_for(TIMEOUT));
+        ASSERT_EQ(static_cast<size_t>(TASKS_PER_EXECUTOR), seen[i].size());
+        for (int n = 0; n < TASKS_PER_EXECUTOR; ++n) {
+            ASSERT_EQ(n, seen[i][n]);
+        }
+    }
+    EXPECT_FALSE(overlapped);
+}
+
+/// A task submitted to the front of a strand runs before the tasks already waiting.
+TEST(WorkerPoolTest, test_submitToFrontJumpsTheStrand) {
+    auto pool = WorkerPool::create(1);
+    Executor executor(pool);
+
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    std::mutex orderMutex;
+    std::vector<int> order;
+    auto record = [&orderMutex, &order](int n) {
+        std::lock_guard<std::mutex> lock{orderMutex};
+        order.push_back(n);
+    };
+
+    executor.submit([released]() { released.wait(); });
+    executor.submit([record]() { record(2); });
+    auto done = executor.submit([record]() { record(3); });
+    executor.submitToFront([record]() { record(1); });
+    release.set_value();
+
+    ASSERT_EQ(std::future_status::ready, done.wait_for(TIMEOUT));
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), order);
+}
+
+/// shutdown() waits for the running task and drops the queued ones, like the thread-per-executor model.
+TEST(WorkerPoolTest, test_shutdownWaitsForRunningTask) {
+    auto pool = WorkerPool::create(2);
+    Executor executor(pool);
+
+    std::promise<void> started;
+    std::atomic<bool> finished(false);
+    std::atomic<bool> droppedRan(false);
+    executor.submit([&started, &finished]() {
+        started.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        finished = true;
+    });
+    executor.submit([&droppedRan]() { droppedRan = true; });
+
+    started.get_future().wait();
+    executor.shutdown();
+    EXPECT_TRUE(finished);
+    EXPECT_TRUE(executor.isShutdown());
+    EXPECT_FALSE(executor.submit([]() {}).valid());
+
+    pool.reset();
+    EXPECT_FALSE(droppedRan);
+}
+
+/// Once the pool is gone its strands are shut down, so their tasks fail instead of waiting forever, whether a strand
+/// was waiting for a thread, running, or idle when the pool went.
+TEST(WorkerPoolTest, test_strandsRejectTasksAfterPoolShutdown) {
+    auto pool = WorkerPool::create(1);
+    Executor running(pool);
+    Executor waiting(pool);
+    Executor idle(pool);
+
+    std::promise<void> started;
+    std::promise<void> release;
+    auto released = release.get_future().share();
+    running.submit([&started, released]() {
+        started.set_value();
+        released.wait();
+    });
+    started.get_future().wait();
+    auto queued = waiting.submit([]() {});
+
+    // The pool's thread is busy, so destroying the pool waits for the running task.
+    std::thread destroyer([&pool]() { pool.reset(); });
+    auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (!waiting.isShutdown() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(waiting.isShutdown());
+    release.set_value();
+    destroyer.join();
+
+    ASSERT_EQ(std::future_status::ready, queued.wait_for(TIMEOUT));
+    EXPECT_THROW(queued.get(), std::future_error);
+    EXPECT_FALSE(waiting.submit([]() {}).valid());
+
+    // Idle strands, including the one whose task was running, find out on their next task, which fails rather than
+    // never running.
+    for (auto executor : {&running, &idle}) {
+        auto orphaned = executor->submit([]() {});
+        ASSERT_EQ(std::future_status::ready, orphaned.wait_for(TIMEOUT));
+        EXPECT_THROW(orphaned.get(), std::future_error);
+        EXPECT_TRUE(executor->isShutdown());
+        EXPECT_FALSE(executor->execute([]() {}));
+    }
+}
+
+/// An executor on a pool may be shut down from one of its own tasks without deadlocking.
+TEST(WorkerPoolTest, test_shutdownFromOwnTask) {
+    auto pool = WorkerPool::create(1);
+    Executor executor(pool);
+
+    auto done = executor.submit([&executor]() { executor.shutdown(); });
+    ASSERT_EQ(std::future_status::ready, done.wait_for(TIMEOUT));
+    EXPECT_TRUE(executor.isShutdown());
+}
+
+/// Executors constructed while a default pool is set run on it; without one they get their own thread.
+TEST(WorkerPoolTest, test_defaultPool) {
+    auto pool = WorkerPool::create(1);
+    WorkerPool::setDefault(pool);
+    EXPECT_EQ(pool, WorkerPool::getDefault());
+
+    std::thread::id poolThread;
+    {
+        Executor first;
+        Executor second;
+        auto firstId = first.submit([]() { return std::this_thread::get_id(); });
+        auto secondId = second.submit([]() { return std::this_thread::get_id(); });
+        poolThread = firstId.get();
+        EXPECT_EQ(poolThread, secondId.get());
+    }
+
+    WorkerPool::setDefault(nullptr);
+    EXPECT_FALSE(WorkerPool::getDefault());
+
+    Executor own;
+    EXPECT_NE(poolThread, own.submit([]() { return std::this_thread::get_id(); }).get());
+}
+
+}  // namespace test
+}  // namespace threading
+}  // namespace utils
+}  // namespace aisdk
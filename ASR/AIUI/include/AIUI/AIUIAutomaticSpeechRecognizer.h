@@ -22,6 +22,7 @@
 #include "FileUtil.h"	// To support read data from file.
 
 #include <DMInterface/MessageConsumerInterface.h>
+#include <NLP/NLPDocument.h>
 #include <Utils/Threading/Executor.h>
 #include <Utils/DeviceInfo.h>
 #include <Utils/Channel/AudioTrackManagerInterface.h>
@@ -146,6 +147,7 @@ private:
 	 * @params aiuiConfigFile The aiui.cfg configure file.
 	 * @params aiuiDir The AIUI resource directory path.
 	 * @params aiuiLogDir The log save path.
+	 * @params preRoll How much audio before the end of the keyword to send with the utterance.
 	 */
 	AIUIAutomaticSpeechRecognizer(
 		std::shared_ptr<utils::DeviceInfo> deviceInfo,
@@ -156,7 +158,8 @@ private:
 		const std::string &appId,
 		const std::string &aiuiConfigFile,
 		const std::string &aiuiDir,
-		const std::string &aiuiLogDir);
+		const std::string &aiuiLogDir,
+		std::chrono::milliseconds preRoll);
 	/**
 	 * Initaile AIUI engine.
 	 */
@@ -210,17 +213,17 @@ private:
 	 * The function that check nlp domain whether need repack message.
 	 * Because some domain classifications are confusing, we should reclassify them here.
 	 *
-	 * @params intent The unparsed intent from TPP type.
+	 * @params intent The parsed intent from TPP type.
 	 */
-	bool intentRepacking(const std::string &intent);
+	bool intentRepacking(const nlp::NLPDocument &intent);
 	
 	/**
 	 * The function that repacking nlp domain message and sent to consume modules.
 	 * Because some domain classifications are confusing, we should reclassify them here.
      *
-	 * @params intent The unparsed intent from TPP type.
+	 * @params intent The parsed intent from TPP type.
 	 */
-	void intentRepackingConsumeMessage(const std::string &intent);
+	void intentRepackingConsumeMessage(std::shared_ptr<const nlp::NLPDocument> intent);
 		
 	/**
 	 * The function to implement text to speech.
@@ -234,11 +237,11 @@ private:
 
 	/**
 	 * utility function to create a new attachment writer to write data.
-	 * @params intent The unparsed intent from TPP type.
+	 * @params intent The parsed intent from TPP type.
 	 *
 	 * @return true if success. otherwise @c false.
 	 */
-	bool createNewAttachmentWrite(const std::string &intent);
+	bool createNewAttachmentWrite(const nlp::NLPDocument &intent);
 	
     /**
      * Utility function to encapsulate the logic required to write data to an attachment.
@@ -346,6 +349,9 @@ private:
 	/// The reader which is currently being used to stream audio for a Recognize event.
 	std::shared_ptr<utils::sharedbuffer::Reader> m_reader;
 
+	/// The number of words before the end of the keyword which are sent with the utterance.
+	const size_t m_preRollWords;
+
 	/// The current @c AttachmentWriter.
 	std::shared_ptr<utils::attachment::AttachmentWriter> m_attachmentWriter;
 
@@ -63,6 +63,9 @@ static const std::string CHANNEL_INTERFACE_NAME{"AIUIAutomaticSpeechRecognizer"}
 
 const std::chrono::milliseconds TIMEOUT_FOR_READ_CALLS = std::chrono::milliseconds(200);
 
+/// The number of words per millisecond of the 16 kHz mono stream sent to AIUI.
+static const size_t WORDS_PER_MILLISECOND = 16;
+
 /// Set barge-in timeout that wait release audio channel normaly.
 const auto BARGEIN_TIMEOUT = std::chrono::milliseconds{500};
 
@@ -115,7 +118,8 @@ std::shared_ptr<AIUIAutomaticSpeechRecognizer> AIUIAutomaticSpeechRecognizer::cr
 	auto aiuiDir = config.getAiuiDir();
 	auto logDir = config.getAiuiLogDir();
 	auto engine = std::shared_ptr<AIUIAutomaticSpeechRecognizer>( new AIUIAutomaticSpeechRecognizer(
-			deviceInfo, trackManager, attachmentDocker, messageConsumer, asrRefreshConfig, appid, configFile, aiuiDir, logDir));
+			deviceInfo, trackManager, attachmentDocker, messageConsumer, asrRefreshConfig, appid, configFile, aiuiDir, logDir,
+			config.getPreRoll()));
 	if(!engine->init()) {
 		AISDK_ERROR(LX("CreateFailed").d("reason", "initedFailed."));
 		return nullptr;
@@ -398,7 +402,8 @@ AIUIAutomaticSpeechRecognizer::AIUIAutomaticSpeechRecognizer(
 	const std::string &appId,
 	const std::string &aiuiConfigFile,
 	const std::string &aiuiDir,
-	const std::string &aiuiLogDir):
+	const std::string &aiuiLogDir,
+	std::chrono::milliseconds preRoll):
 	m_deviceInfo{deviceInfo},
 	m_trackManager{trackManager},
 	m_trackState{utils::channel::FocusState::NONE},
@@ -411,6 +416,7 @@ AIUIAutomaticSpeechRecognizer::AIUIAutomaticSpeechRecognizer(
 	m_aiuiLogDir{aiuiLogDir},
 	m_running{false},
 	m_bargeIn{false},
+	m_preRollWords{static_cast<size_t>(preRoll.count()) * WORDS_PER_MILLISECOND},
 	m_attachmentWriter{nullptr},
 	m_gainTune{nullptr},
 	m_utteranceSave{false} {
@@ -575,8 +581,14 @@ bool AIUIAutomaticSpeechRecognizer::executeRecognize(
 	setVaildVad(false);
 	setState(state);
 
-	// Creating new @c Reader.
+	// Creating new @c Reader, positioned where the utterance starts so nothing said after the keyword is lost.
 	m_reader = stream->createReader(Reader::Policy::BLOCKING);
+	if(!m_reader) {
+		AISDK_ERROR(LX("executeRecognizeFailed").d("reason", "createReaderFailed"));
+		executeResetState();
+		return false;
+	}
+	seekToUtterance(m_reader, begin, keywordEnd, m_preRollWords);
 	
     // Record provider as the last-used Audio Provider so it can be used in the event of an ExpectSpeech domain.
 	m_audioProvider = stream;
@@ -620,19 +632,10 @@ bool AIUIAutomaticSpeechRecognizer::executeNLPResult(const std::string unparsedI
 	return true;
 }
 
-bool AIUIAutomaticSpeechRecognizer::intentRepacking(const std::string &intent) {
-	Json::CharReaderBuilder readerBuilder;
-	JSONCPP_STRING errs;
-	Json::Value root;
-	std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());	
-	// Start parsing.
-	if (!reader->parse(intent.c_str(), intent.c_str()+intent.length(), &root, &errs)) {
-		AISDK_ERROR(LX("intentRepacking").d("reason", "parseIntentError").d("intent", intent));
-		return false;
-	}
-
+bool AIUIAutomaticSpeechRecognizer::intentRepacking(const nlp::NLPDocument &intent) {
 	// Parsing domain node.
-	std::string domain = root["domain"].asString();
+	auto& domainNode = intent.getMember("domain");
+	std::string domain = domainNode.isString() ? domainNode.asString() : std::string();
 	if(domain.empty()) {
 		AISDK_ERROR(LX("intentRepacking").d("reason", "notFoundDomainNode."));
 		 return false;
@@ -644,8 +647,8 @@ bool AIUIAutomaticSpeechRecognizer::intentRepacking(const std::string &intent) {
 		domain == DOMAIN_PLAYCONTROL || domain == DOMAIN_VOLUME) {
 		repacking = true;
 	} else {
-		Json::Value data = root["data"];
-		auto resource = data["resource"].asBool();
+		auto& data = intent.getMember("data");
+		auto resource = data.isObject() && data["resource"].asBool();
 		if(resource) {
 			repacking = true;
 		}
@@ -654,43 +657,32 @@ bool AIUIAutomaticSpeechRecognizer::intentRepacking(const std::string &intent) {
 	return repacking;
 }
 
-void AIUIAutomaticSpeechRecognizer::intentRepackingConsumeMessage(const std::string &intent) {
-	auto repacking = intentRepacking(intent);
+void AIUIAutomaticSpeechRecognizer::intentRepackingConsumeMessage(std::shared_ptr<const nlp::NLPDocument> intent) {
+	auto repacking = intentRepacking(*intent);
 	// Should repacking to consume message.
 	if(repacking) {
-		Json::CharReaderBuilder readerBuilder;
-		JSONCPP_STRING errs;
-		Json::Value root;
-		std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());	
-		// Start parsing.
-		if (!reader->parse(intent.c_str(), intent.c_str()+intent.length(), &root, &errs)) {
-			AISDK_ERROR(LX("intentRepackingConsumeMessageFailed").d("reason", "parseIntentError").d("intent", intent));
+		// Copy the parsed tree with the new domain, rather than printing and parsing the intent again.
+		auto chat = intent->withDomain("chat");
+		if(!chat) {
+			AISDK_ERROR(LX("intentRepackingConsumeMessageFailed").d("reason", "repackIntentError"));
 			return;
 		}
-		Json::StreamWriterBuilder writerBuilder;
-		std::unique_ptr<Json::StreamWriter> writer(writerBuilder.newStreamWriter());
-		std::ostringstream os;
-		root["domain"] = "chat";
-		writer->write(root, &os);
-		// AISDK_DEBUG5(LX("intentRepackingConsumeMessage").d("newIntent", os.str()));
-		m_messageConsumer->consumeMessage(MESSAGE_ID_REPACK_COMBINING_SUBSTRING+m_sessionId, os.str());
+		m_messageConsumer->consumeMessage(MESSAGE_ID_REPACK_COMBINING_SUBSTRING+m_sessionId, chat);
 	}
 }
 
 bool AIUIAutomaticSpeechRecognizer::executeTPPResult(
 	const std::string intent,
 	std::shared_ptr<utils::attachment::AttachmentWriter> writer) {
-	Json::CharReaderBuilder readerBuilder;
-	JSONCPP_STRING errs;
-	Json::Value root;
-	std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());	
-	// Start parsing.
-	if (!reader->parse(intent.c_str(), intent.c_str()+intent.length(), &root, &errs)) {
+	// Parse the intent once; the same document goes on to the NLP and Domain layers.
+	auto document = nlp::NLPDocument::create(intent);
+	if (!document) {
 		AISDK_ERROR(LX("handleEventResultTPPFailed").d("reason", "parseIntentError").d("intent", intent));
 		return false;
 	}
+	auto& root = document->getRoot();
 
-	Json::Value data = root["data"];
+	auto& data = document->getMember("data");
 	Json::Value empty;
 	Json::Value answer = data.get("answer", empty);
 	if(answer.empty()) {
@@ -729,16 +721,16 @@ bool AIUIAutomaticSpeechRecognizer::executeTPPResult(
 	}
 	
 	// Start creating new writer.
-	if(createNewAttachmentWrite(intent) == false)
+	if(createNewAttachmentWrite(*document) == false)
 		return false;
 
 	m_timeoutForThinkingTimer.stop();
 	std::string text(answer.asString());
 	executeTextToSpeech(text);
 
-	intentRepackingConsumeMessage(intent);
+	intentRepackingConsumeMessage(document);
 	
-	m_messageConsumer->consumeMessage(m_sessionId, intent);
+	m_messageConsumer->consumeMessage(m_sessionId, document);
 	if(expectSpeech) {
 		std::stringstream expectSpeech;
 		expectSpeech << DOMAIN_EXPECT_SPEECH_FORMAT;
@@ -749,7 +741,7 @@ bool AIUIAutomaticSpeechRecognizer::executeTPPResult(
 	return true;
 }
 
-bool AIUIAutomaticSpeechRecognizer::createNewAttachmentWrite(const std::string &intent) {
+bool AIUIAutomaticSpeechRecognizer::createNewAttachmentWrite(const nlp::NLPDocument &intent) {
 	std::string attachmentId;
 	if(intentRepacking(intent)) {
 		attachmentId = MESSAGE_ID_REPACK_COMBINING_SUBSTRING+m_sessionId;
@@ -886,11 +878,7 @@ void AIUIAutomaticSpeechRecognizer::sendStreamProcessing() {
 	if(m_utteranceSave) {
 		fs.open("/tmp/utterance.pcm", std::fstream::out | std::fstream::app);
 	}
-	std::this_thread::sleep_for(std::chrono::milliseconds(300));
-
-	// Seek keyword begin position.
-	m_reader->seek(0, Reader::Reference::BEFORE_WRITER);
-
+	// The reader was placed at the start of the utterance by executeRecognize(), just carry on from there.
 	do {
 		bool didErrorOccur = false;
 		// Start read data.
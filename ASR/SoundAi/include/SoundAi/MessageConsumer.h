@@ -33,6 +33,9 @@ public:
 	/// MessageConsumerInterface method.
 	void consumeMessage(const std::string& contextId, const std::string& message) override;
 
+	/// MessageConsumerInterface method.
+	void consumeMessage(const std::string& contextId, std::shared_ptr<const nlp::NLPDocument> message) override;
+
 private:
 
 	/// The message listener, which will receive all messages sent from sai sdk.
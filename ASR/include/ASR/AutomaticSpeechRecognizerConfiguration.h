@@ -13,6 +13,7 @@
 #ifndef __AUTOMATIC_SPEECH_RECOGNIZER_CONFIGURATION_H_
 #define __AUTOMATIC_SPEECH_RECOGNIZER_CONFIGURATION_H_
 
+#include <chrono>
 #include <mutex>
 #include <unordered_set>
 
@@ -36,15 +37,19 @@ public:
 	inline std::string getAiuiDir() const;
 
 	inline std::string getAiuiLogDir() const;
+
+	inline std::chrono::milliseconds getPreRoll() const;
 	
     /**
      * Configurable constructor that can be used to set soundai configuration values.
      */
 	AutomaticSpeechRecognizerConfiguration(
 		const std::string &configPath,
-		const double threshold = 0.45):
+		const double threshold = 0.45,
+		const std::chrono::milliseconds preRoll = std::chrono::milliseconds(100)):
 		m_threshold{threshold},
-		m_soundAiConfigPath{configPath} {
+		m_soundAiConfigPath{configPath},
+		m_preRoll{preRoll} {
 
 	};
     /**
@@ -54,12 +59,14 @@ public:
 		const std::string &appId = "5c3d4427",
 		const std::string &aiuiConfigFile = "/cfg/AIUI/cfg/aiui.cfg",
 		const std::string &aiuiDir = "/cfg/AIUI/",
-		const std::string &aiuiLogDir = "/cfg/AIUI/log/"):
+		const std::string &aiuiLogDir = "/cfg/AIUI/log/",
+		const std::chrono::milliseconds preRoll = std::chrono::milliseconds(100)):
 		m_threshold{0},
 		m_aiuiAppId{appId},
 		m_aiuiConfigFile{aiuiConfigFile},
 		m_aiuiDir{aiuiDir},
-		m_aiuiLogDir{aiuiLogDir} {
+		m_aiuiLogDir{aiuiLogDir},
+		m_preRoll{preRoll} {
 
 	};
     /**
@@ -80,6 +87,12 @@ private:
 
 	const std::string m_aiuiLogDir;
 
+	/**
+	 * How much audio before the end of the keyword is sent with the utterance, so speech which follows the keyword
+	 * closely is not clipped.
+	 */
+	const std::chrono::milliseconds m_preRoll;
+
 };
 
 double AutomaticSpeechRecognizerConfiguration::getSoundAiThreshold() const {
@@ -106,6 +119,10 @@ std::string AutomaticSpeechRecognizerConfiguration::getAiuiLogDir() const {
 	return m_aiuiLogDir;
 }
 
+std::chrono::milliseconds AutomaticSpeechRecognizerConfiguration::getPreRoll() const {
+	return m_preRoll;
+}
+
 }  // namespace asr
 }  // namespace aisdk
 
@@ -128,6 +128,24 @@ protected:
         size_t nWords,
         std::chrono::milliseconds timeout,
         bool* errorOccurred);
+
+    /**
+     * Moves a reader to where the utterance starts: @c preRollWords before the end of the keyword, but not before
+     * its beginning.  Without keyword indices (e.g. ExpectSpeech) the reader goes @c preRollWords back from live
+     * data.  If the indices point at data which has already been overwritten, the reader falls back to live data.
+     *
+     * @param reader The stream reader.
+     * @param begin The absolute index of the start of the keyword, or @c INVALID_INDEX.
+     * @param keywordEnd The absolute index of the end of the keyword, or @c INVALID_INDEX.
+     * @param preRollWords The number of words before @c keywordEnd to start at.
+     * @return @c true if the reader was placed at the requested index, @c false if it fell back to live data.
+     */
+    static bool seekToUtterance(
+        std::shared_ptr<utils::sharedbuffer::Reader> reader,
+        utils::sharedbuffer::SharedBuffer::Index begin,
+        utils::sharedbuffer::SharedBuffer::Index keywordEnd,
+        size_t preRollWords);
+
 	/**
      * This function updates the @c SoundAiObserverInterface state and notifies the state observer.  Any changes to
      * @c m_state should be made through this function.
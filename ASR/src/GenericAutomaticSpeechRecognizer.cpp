@@ -100,6 +100,49 @@ ssize_t GenericAutomaticSpeechRecognizer::readFromStream(
     return wordsRead;
 }
 
+bool GenericAutomaticSpeechRecognizer::seekToUtterance(
+    std::shared_ptr<utils::sharedbuffer::Reader> reader,
+    utils::sharedbuffer::SharedBuffer::Index begin,
+    utils::sharedbuffer::SharedBuffer::Index keywordEnd,
+    size_t preRollWords) {
+    if (!reader) {
+        AISDK_ERROR(LX("seekToUtteranceFailed").d("reason", "nullReader"));
+        return false;
+    }
+
+    if (INVALID_INDEX == keywordEnd && INVALID_INDEX == begin) {
+        // No keyword to anchor on, take the pre-roll from live data.
+        if (reader->seek(preRollWords, Reader::Reference::BEFORE_WRITER)) {
+            return true;
+        }
+        reader->seek(0, Reader::Reference::BEFORE_WRITER);
+        return false;
+    }
+
+    SharedBuffer::Index start = begin;
+    if (INVALID_INDEX != keywordEnd) {
+        start = (keywordEnd > preRollWords) ? keywordEnd - preRollWords : 0;
+        if (INVALID_INDEX != begin && start < begin) {
+            start = begin;
+        }
+    }
+
+    if (!reader->seek(start, Reader::Reference::ABSOLUTE)) {
+        AISDK_WARN(LX("seekToUtteranceFailed")
+                       .d("reason", "indexNotInBuffer")
+                       .d("begin", begin)
+                       .d("keywordEnd", keywordEnd)
+                       .d("start", start));
+        reader->seek(0, Reader::Reference::BEFORE_WRITER);
+        return false;
+    }
+
+    AISDK_DEBUG1(LX("seekToUtterance")
+                     .d("start", start)
+                     .d("backlogWords", reader->tell(Reader::Reference::BEFORE_WRITER)));
+    return true;
+}
+
 void GenericAutomaticSpeechRecognizer::setState(
 	utils::soundai::SoundAiObserverInterface::State state) {
 	std::lock_guard<std::mutex> lock(m_asrObserversMutex);
@@ -26,6 +26,11 @@ void MessageConsumer::consumeMessage(const std::string& contextId, const std::st
 	 m_observer->receive(contextId, message);
 }
 
+void MessageConsumer::consumeMessage(const std::string& contextId, std::shared_ptr<const nlp::NLPDocument> message) {
+	 std::lock_guard<std::mutex> lock(m_mutex);
+	 m_observer->receive(contextId, message);
+}
+
 
 }	//asr
 } // namespace aisdk
@@ -70,13 +70,18 @@ public:
 
     /**
      * This constructor creates Channels based on the provided configurations.
+     *
+     * @param channelConfigurations The Channels to create.
+     * @param duckingPriority Channels with this priority or a higher number are told they may duck
+     * (@c MixingBehavior::MAY_DUCK) rather than pause when they go to the background.
      */
     AudioTrackManager(
         const std::vector<ChannelConfiguration> channelConfigurations = {
             {DIALOG_CHANNEL_NAME, DIALOG_CHANNEL_PRIORITY}, 
             {ALARMS_CHANNEL_NAME, ALARMS_CHANNEL_PRIORITY}, 
             {MEDIA_CHANNEL_NAME, MEDIA_CHANNEL_PRIORITY}
-        });
+        },
+        unsigned int duckingPriority = DEFAULT_DUCKING_PRIORITY);
 
 	/// name AudioTrackManagerInterface method:
 	/// @{
@@ -20,6 +20,7 @@
 
 #include <Utils/Channel/ChannelObserverInterface.h>
 #include <Utils/Channel/FocusState.h>
+#include <Utils/Channel/MixingBehavior.h>
 
 namespace aisdk {
 namespace atm {
@@ -44,6 +45,9 @@ public:
         /// The current active audio track of the Channel.
         utils::channel::FocusState focusState;
 
+        /// How the owner of the Channel should sound in @c focusState.
+        utils::channel::MixingBehavior mixingBehavior;
+
 		/// The name of the Audio Type interface that is occupying the Channel. - remove
         std::string interfaceName;
 
@@ -56,8 +60,9 @@ public:
      *
      * @param name The channel's name.
      * @param priority The priority of the channel.
+     * @param mayDuck Whether the owner may keep playing at a lowered volume in the background rather than pause.
      */
-    Channel(const std::string& name, const unsigned int priority);
+    Channel(const std::string& name, const unsigned int priority, bool mayDuck = false);
 
     /**
      * Returns the name of a channel.
@@ -135,6 +140,9 @@ private:
     /// The priority of the Channel.
     const unsigned int m_priority;
 
+    /// Whether the owner may duck rather than pause in the background.
+    const bool m_mayDuck;
+
     /// The @c State of the @c Channel.
     State m_state;
 
@@ -25,7 +25,9 @@ namespace atm {
 
 using namespace utils::channel;
 
-AudioTrackManager::AudioTrackManager(const std::vector<ChannelConfiguration> channelConfigurations){
+AudioTrackManager::AudioTrackManager(
+    const std::vector<ChannelConfiguration> channelConfigurations,
+    unsigned int duckingPriority) {
     for (auto config : channelConfigurations) {
         if (doesChannelNameExist(config.name)) {
 			AISDK_ERROR(LX("createChannelFailed").d("reason", "channel already exists").d("config", config.toString()));
@@ -36,7 +38,7 @@ AudioTrackManager::AudioTrackManager(const std::vector<ChannelConfiguration> cha
             continue;
         }
 
-        auto channel = std::make_shared<Channel>(config.name, config.priority);
+        auto channel = std::make_shared<Channel>(config.name, config.priority, config.priority >= duckingPriority);
         m_allChannels.insert({config.name, channel});
     }
 }
@@ -52,7 +54,7 @@ bool AudioTrackManager::acquireChannel(
         return false;
     }
 
-    m_executor.submit([this, channelToAcquire, channelObserver, interface]() {
+    m_executor.execute([this, channelToAcquire, channelObserver, interface]() {
         acquireChannelHelper(channelToAcquire, channelObserver, interface);
     });
 	
@@ -73,7 +75,7 @@ std::future<bool> AudioTrackManager::releaseChannel(
         return returnValue;
     }
 
-    m_executor.submit([this, channelToRelease, channelObserver, releaseChannelSuccess, channelName]() {
+    m_executor.execute([this, channelToRelease, channelObserver, releaseChannelSuccess, channelName]() {
         releaseChannelHelper(channelToRelease, channelObserver, releaseChannelSuccess, channelName);
     });
 
@@ -92,7 +94,7 @@ void AudioTrackManager::stopForegroundActivity() {
     std::string foregroundChannelInterface = foregroundChannel->getInterface();
     lock.unlock();
 
-    m_executor.submitToFront([this, foregroundChannel, foregroundChannelInterface]() {
+    m_executor.executeToFront([this, foregroundChannel, foregroundChannelInterface]() {
         stopForegroundActivityHelper(foregroundChannel, foregroundChannelInterface);
     });
 }
@@ -21,11 +21,13 @@ using namespace utils::channel;
 Channel::State::State(const std::string& name) :
         name{name},
         focusState{FocusState::NONE},
+        mixingBehavior{MixingBehavior::MUST_STOP},
         timeAtIdle{std::chrono::steady_clock::now()} {
 }
 
-Channel::Channel(const std::string& name, const unsigned int priority) :
+Channel::Channel(const std::string& name, const unsigned int priority, bool mayDuck) :
         m_priority{priority},
+        m_mayDuck{mayDuck},
         m_state{name},
         m_observer{nullptr} {
 }
@@ -44,8 +46,19 @@ bool Channel::setFocus(FocusState focus) {
     }
 
     m_state.focusState = focus;
+    switch (focus) {
+        case FocusState::FOREGROUND:
+            m_state.mixingBehavior = MixingBehavior::PRIMARY;
+            break;
+        case FocusState::BACKGROUND:
+            m_state.mixingBehavior = m_mayDuck ? MixingBehavior::MAY_DUCK : MixingBehavior::MUST_PAUSE;
+            break;
+        case FocusState::NONE:
+            m_state.mixingBehavior = MixingBehavior::MUST_STOP;
+            break;
+    }
     if (m_observer) {
-        m_observer->onTrackChanged(m_state.focusState);
+        m_observer->onTrackChangedWithMixing(m_state.focusState, m_state.mixingBehavior);
     }
 
     if (FocusState::NONE == m_state.focusState) {
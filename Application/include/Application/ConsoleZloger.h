@@ -13,6 +13,7 @@
 #ifndef __CONSOLE_ZLOGER_H_
 #define __CONSOLE_ZLOGER_H_
 
+#include <chrono>
 #include <mutex>
 #include <string>
 
@@ -29,10 +30,17 @@ namespace application {
 class ConsoleZloger : public utils::logging::Logger {
 public:
     /**
-     * Constructor.
+     * Constructor.  Lines carry local time in the system time zone.
      */
     ConsoleZloger();
 
+    /**
+     * Constructor.
+     *
+     * @param utcOffset The offset from UTC of the time printed on each line.
+     */
+    explicit ConsoleZloger(std::chrono::seconds utcOffset);
+
     void emit(
         utils::logging::Level level,
         std::chrono::system_clock::time_point time,
@@ -11,9 +11,11 @@
  */
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include <portaudio.h>
 #include <Utils/SharedBuffer/SharedBuffer.h>
+#include <Utils/Microphone/ChannelRemap.h>
 #include <Utils/Microphone/MicrophoneInterface.h>
 
 namespace aisdk {
@@ -59,11 +61,6 @@ private:
 	PortAudioMicrophoneWrapper(
 		std::shared_ptr<utils::sharedbuffer::SharedBuffer> stream);
 
-	void portAudioStreamPreprocessing(
-		void *outFrames,
-		const void *inputFrames,
-		unsigned long framesPreBuffer);
-
 	/// The callback that PortAudio will issue when audio is avaiable to read.
 	static int PortAudioCallback(
 		const void *inputBuffer,
@@ -76,6 +73,14 @@ private:
 	/// Initialize portaudio library.
 	bool initialize();
 
+	/**
+	 * Allocates everything the callback needs once the stream is open, sized from the stream's negotiated input
+	 * latency, so the real-time thread never touches the heap.
+	 *
+	 * @return Whether the capture buffers were prepared.
+	 */
+	bool prepareCaptureBuffers();
+
 	/// The stream of data.
 	std::shared_ptr<utils::sharedbuffer::SharedBuffer> m_audioInputStream;
 
@@ -85,6 +90,15 @@ private:
 	/// The PortAudio stream
     PaStream* m_paStream;
 
+	/// The table-driven remap from the device channel layout to the layout the front end expects.
+	std::unique_ptr<utils::microphone::ChannelRemap> m_channelRemap;
+
+	/// Remapped samples waiting to be written, preallocated so the callback never allocates.
+	std::vector<int16_t> m_remapBuffer;
+
+	/// The number of frames @c m_remapBuffer holds; larger callbacks are processed in pieces of this size.
+	unsigned long m_remapBufferFrames;
+
     /**
      * A lock to seralize access to startStreamingMicrophoneData() and stopStreamingMicrophoneData() between different
      * threads.
@@ -14,6 +14,8 @@
 #define __SAMPLE_APPLICATION_H_
 
 #include <memory>
+#include <string>
+#include <Utils/Threading/WorkerPool.h>
 #include <AudioMediaPlayer/AOWrapper.h>
 #include <KWD/GenericKeywordDetector.h>
 
@@ -33,8 +35,19 @@ public:
     /**
      * Constructor.
      *
+     * @param micShmName If not empty, the microphone buffer is created in the POSIX shared memory object of this name
+     * so other processes can attach to it as readers with @c SharedBuffer::open().
+     * @param workerThreads If not 0, the executors of all components share a @c WorkerPool of this many threads
+     * instead of running one thread each.
+     * @param logUtcOffset If not empty, log lines carry the time at this offset from UTC (e.g. "+08:00") rather than
+     * in the system time zone.
      */
-	static std::unique_ptr<SampleApp> createNew(const std::string& logLevels, bool rebootFlag);
+	static std::unique_ptr<SampleApp> createNew(
+		const std::string& logLevels,
+		bool rebootFlag,
+		const std::string& micShmName = "",
+		unsigned int workerThreads = 0,
+		const std::string& logUtcOffset = "");
 
 	/// Runs the application, blocking until the user asked app quit. 
 	void run();
@@ -43,11 +56,22 @@ public:
 	~SampleApp();
 
 private:
-	bool initialize(const std::string& logLevel, bool rebootFlag);
+	bool initialize(
+		const std::string& logLevel,
+		bool rebootFlag,
+		const std::string& micShmName,
+		unsigned int workerThreads,
+		const std::string& logUtcOffset);
+
+	/// The pool the component executors run on, if any. Declared first so it outlives every component.
+	std::shared_ptr<utils::threading::WorkerPool> m_workerPool;
 
 	// The used to create libao objects.
 	std::shared_ptr<mediaPlayer::ffmpeg::AOEngine> m_aoEngine;
 
+	// The mixer which plays all media players on the one libao device.
+	std::shared_ptr<mediaPlayer::ffmpeg::AudioMixer> m_audioMixer;
+
 	// The @c MediaPlayer used by @c SpeechSyth.
 	std::shared_ptr<mediaPlayer::ffmpeg::AOWrapper> m_chatMediaPlayer;
 
@@ -71,6 +95,9 @@ private:
 
     /// The @c InputControlInteraction which controls the client.
     std::shared_ptr<InputControlInteraction> m_userInputControler;
+
+	/// The name of the shared memory object holding the microphone buffer, empty if it lives on the heap.
+	std::string m_micShmName;
 };
 
 }  // namespace application
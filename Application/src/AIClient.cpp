@@ -280,6 +280,12 @@ bool AIClient::initialize(
 	/// ...
 	/// ...
 	/// ...
+
+	// All handlers are in; from here on domains are routed without locking.
+	if (!m_domainSequencer->freezeDomainHandlers()) {
+		AISDK_ERROR(LX("initializeFailed").d("reason", "unableToFreezeDomainHandlers"));
+		return false;
+	}
 	
 	/**
 	 * This method is the playback control interface. Users can control PLAY and 
@@ -20,6 +20,12 @@ ConsoleZloger::ConsoleZloger():
 
 }
 
+ConsoleZloger::ConsoleZloger(std::chrono::seconds utcOffset):
+	utils::logging::Logger(utils::logging::Level::UNKNOWN),
+	m_logFormatter(utcOffset) {
+
+}
+
 void ConsoleZloger::emit(
     utils::logging::Level level,
     std::chrono::system_clock::time_point time,
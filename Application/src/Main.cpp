@@ -10,6 +10,7 @@
  * permissions and limitations under the License.
  */
 
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include <unistd.h>
@@ -23,10 +24,13 @@
 int main(int argc, char* argv[]) {
 	std::string logLevel;
     bool rebootFlag = false;
+	std::string micShmName;
+	unsigned int workerThreads = 0;
+	std::string logUtcOffset;
 	logLevel = std::string("DEBUG0");
 
     int opt;
-	while((opt = getopt(argc, argv, "hrd:")) != -1) {
+	while((opt = getopt(argc, argv, "hrd:s:w:z:")) != -1) {
 	switch (opt) {
 		case 'd':
 			logLevel = optarg;
@@ -34,13 +38,26 @@ int main(int argc, char* argv[]) {
 		case 'r':
 			rebootFlag = true;
 			break;
+		case 's':
+			// Publish the microphone buffer in POSIX shared memory, e.g. "-s /aisdk-mic".
+			micShmName = optarg;
+			break;
+		case 'w':
+			// Run the executors of all components on a shared pool of this many threads, e.g. "-w 4".
+			workerThreads = static_cast<unsigned int>(atoi(optarg));
+			break;
+		case 'z':
+			// Print log times at this offset from UTC instead of the system zone, e.g. "-z +08:00".
+			logUtcOffset = optarg;
+			break;
 		default:
             break;
 	}
 	}
 
     std::cout << "Create rebootFlag=%d" << rebootFlag << std::endl;
-	auto sampleApp = aisdk::application::SampleApp::createNew(logLevel, rebootFlag);
+	auto sampleApp = aisdk::application::SampleApp::createNew(
+		logLevel, rebootFlag, micShmName, workerThreads, logUtcOffset);
 	if(!sampleApp) {
 		std::cout << "Create FAILED!" << std::endl;
 		return -1;
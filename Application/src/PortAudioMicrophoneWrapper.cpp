@@ -9,6 +9,8 @@
  * express or implied. See the License for the specific language governing
  * permissions and limitations under the License.
  */
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <Utils/Logging/Logger.h>
 #include "Application/PortAudioMicrophoneWrapper.h"
@@ -32,11 +34,26 @@ static const std::string DEFAULE_MICROPHONE{"6mic_loopback"};
 #endif
 #endif
 
-static const int16_t SAMPLE_SILENCE = 0;
 static const int NUM_OUTPUT_CHANNELS = 0;
 static const double SAMPLE_RATE = 16000;
 static const unsigned long PREFERRED_SAMPLES_PER_CALLBACK = paFramesPerBufferUnspecified;
 
+#if (defined KWD_SOUNDAI) && (!defined PUSH_TAP)
+/// Source channel of each channel the SoundAi front end expects; the last four are unused and left silent.
+static const std::vector<int> MIC_ARRAY_CHANNEL_MAP{
+	0, 2, 4, 7,
+	utils::microphone::ChannelRemap::SILENCE,
+	utils::microphone::ChannelRemap::SILENCE,
+	utils::microphone::ChannelRemap::SILENCE,
+	utils::microphone::ChannelRemap::SILENCE};
+#else
+/// The device layout is passed through unchanged.
+static const std::vector<int> MIC_ARRAY_CHANNEL_MAP;
+#endif
+
+/// The smallest capture buffer, used when the stream reports no (or a tiny) input latency.
+static const unsigned long MIN_CAPTURE_BUFFER_FRAMES = 512;
+
 std::unique_ptr<PortAudioMicrophoneWrapper> PortAudioMicrophoneWrapper::create(
 	std::shared_ptr<utils::sharedbuffer::SharedBuffer> stream) {
 	if(!stream) {
@@ -56,7 +73,8 @@ std::unique_ptr<PortAudioMicrophoneWrapper> PortAudioMicrophoneWrapper::create(
 PortAudioMicrophoneWrapper::PortAudioMicrophoneWrapper(
 	std::shared_ptr<utils::sharedbuffer::SharedBuffer> stream):
     m_audioInputStream{stream},
-    m_paStream{nullptr} {
+    m_paStream{nullptr},
+    m_remapBufferFrames{0} {
 }
 
 PortAudioMicrophoneWrapper::~PortAudioMicrophoneWrapper() {
@@ -151,7 +169,36 @@ bool PortAudioMicrophoneWrapper::initialize() {
         AISDK_CRITICAL(LX("Failed to open PortAudio default stream").d("errorCode", err));
         return false;
     }
-    return true;
+    return prepareCaptureBuffers();
+}
+
+bool PortAudioMicrophoneWrapper::prepareCaptureBuffers() {
+	if (MIC_ARRAY_CHANNEL_MAP.empty()) {
+		// Samples go straight from PortAudio to the stream.
+		return true;
+	}
+
+	m_channelRemap = utils::microphone::ChannelRemap::create(NUM_INPUT_CHANNELS, MIC_ARRAY_CHANNEL_MAP);
+	if (!m_channelRemap) {
+		AISDK_CRITICAL(LX("Failed to create channel remap"));
+		return false;
+	}
+
+	// With paFramesPerBufferUnspecified a callback delivers at most the host buffer, which is the input latency.
+	m_remapBufferFrames = MIN_CAPTURE_BUFFER_FRAMES;
+	const PaStreamInfo* streamInfo = Pa_GetStreamInfo(m_paStream);
+	if (streamInfo) {
+		auto latencyFrames = static_cast<unsigned long>(std::ceil(streamInfo->inputLatency * streamInfo->sampleRate));
+		if (latencyFrames > m_remapBufferFrames) {
+			m_remapBufferFrames = latencyFrames;
+		}
+	}
+	m_remapBuffer.resize(m_remapBufferFrames * m_channelRemap->getOutputChannels());
+
+	AISDK_INFO(LX("prepareCaptureBuffers")
+		.d("frames", m_remapBufferFrames)
+		.d("kernel", utils::microphone::ChannelRemap::getKernelName()));
+	return true;
 }
 
 bool PortAudioMicrophoneWrapper::startStreamingMicrophoneData() {
@@ -174,41 +221,6 @@ bool PortAudioMicrophoneWrapper::stopStreamingMicrophoneData() {
     return true;
 }
 
-void PortAudioMicrophoneWrapper::portAudioStreamPreprocessing(
-	void *outFrames,
-	const void *inputFrames,
-	unsigned long framesPreBuffer) {
-	int16_t *rdptr = (int16_t*)inputFrames;
-	auto *rwptr = static_cast<int16_t*>(outFrames);
-	int16_t instant;
-	unsigned long index;
-	int ch;
-	for(index=0; index<framesPreBuffer; index++) {
-		for(ch=0; ch<NUM_INPUT_CHANNELS; ch++) {
-			if(ch == 0) {
-				*rwptr++ = *rdptr++;	
-			} else if(ch == 1) {
-				//instant = *rdptr++;
-				(void)*rdptr++;
-				instant = *rdptr;
-				*rwptr++ = instant;  // 2
-			} else if(ch == 2) {
-				instant = *rdptr++;		// 4
-				//(void)*rdptr++;
-				instant = *(rdptr+1);
-				*rwptr++ = instant;
-			} else if(ch == 3) {
-				(void)*rdptr++;
-				instant = *(rdptr+3);
-				*rwptr++ = instant;
-			}else {
-				(void)*rdptr++;
-				*rwptr++ = SAMPLE_SILENCE;
-			}
-		}
-	}
-}
-
 int PortAudioMicrophoneWrapper::PortAudioCallback(
     const void* inputBuffer,
     void* outputBuffer,
@@ -217,24 +229,31 @@ int PortAudioMicrophoneWrapper::PortAudioCallback(
     PaStreamCallbackFlags statusFlags,
     void* userData) {
     PortAudioMicrophoneWrapper* wrapper = static_cast<PortAudioMicrophoneWrapper*>(userData);
-	auto allFramesToCalc = numSamples*NUM_INPUT_CHANNELS;
-	
-#if (defined KWD_SOUNDAI) && (!defined PUSH_TAP)
-	std::vector<int16_t> pushToData(allFramesToCalc);
-	wrapper->portAudioStreamPreprocessing(pushToData.data(), inputBuffer, numSamples);
-	ssize_t returnCode = wrapper->m_writer->write(pushToData.data(), allFramesToCalc);
-	if (returnCode <= 0) {
-		AISDK_CRITICAL(LX("Failed to write to stream."));
-		return paAbort;
+
+	if (!wrapper->m_channelRemap) {
+		ssize_t returnCode = wrapper->m_writer->write(inputBuffer, numSamples * NUM_INPUT_CHANNELS);
+		if (returnCode <= 0) {
+			AISDK_CRITICAL(LX("Failed to write to stream."));
+			return paAbort;
+		}
+		return paContinue;
 	}
-#else
-	ssize_t returnCode = wrapper->m_writer->write(inputBuffer, allFramesToCalc);
-    if (returnCode <= 0) {
-        AISDK_CRITICAL(LX("Failed to write to stream."));
-        return paAbort;
-    }
-#endif
-	
+
+	// Remap through the preallocated buffer, a buffer-full at a time if the host delivered more than expected.
+	auto input = static_cast<const int16_t*>(inputBuffer);
+	const size_t outputChannels = wrapper->m_channelRemap->getOutputChannels();
+	while (numSamples > 0) {
+		unsigned long frames = std::min(numSamples, wrapper->m_remapBufferFrames);
+		wrapper->m_channelRemap->remap(input, wrapper->m_remapBuffer.data(), frames);
+		ssize_t returnCode = wrapper->m_writer->write(wrapper->m_remapBuffer.data(), frames * outputChannels);
+		if (returnCode <= 0) {
+			AISDK_CRITICAL(LX("Failed to write to stream."));
+			return paAbort;
+		}
+		input += frames * NUM_INPUT_CHANNELS;
+		numSamples -= frames;
+	}
+
     return paContinue;
 }
 
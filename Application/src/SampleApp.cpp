@@ -10,10 +10,13 @@
  * permissions and limitations under the License.
  */
 
+#include <Utils/Logging/AsyncLogger.h>
 #include <Utils/Logging/Logger.h>
 #include <Utils/Logging/LoggerSinkManager.h>
+#include <Utils/SharedBuffer/SharedMemoryBuffer.h>
 #include <Utils/DeviceInfo.h>
 #include <KWD/KeywordDetectorRegister.h>
+#include <AudioMediaPlayer/AOSink.h>
 
 #include "Application/KeywordObserver.h"
 #include "Application/PortAudioMicrophoneWrapper.h"
@@ -46,9 +49,14 @@ static const std::chrono::seconds AMOUNT_OF_AUDIO_DATA_IN_BUFFER = std::chrono::
 /// The size of the ring buffer.
 static const size_t BUFFER_SIZE_IN_SAMPLES = (SAMPLE_RATE_HZ*NUM_CHANNELS)*AMOUNT_OF_AUDIO_DATA_IN_BUFFER.count();
 
-std::unique_ptr<SampleApp> SampleApp::createNew(const std::string& logLevel, bool rebootFlag) {
+std::unique_ptr<SampleApp> SampleApp::createNew(
+	const std::string& logLevel,
+	bool rebootFlag,
+	const std::string& micShmName,
+	unsigned int workerThreads,
+	const std::string& logUtcOffset) {
 	std::unique_ptr<SampleApp> instance(new SampleApp());
-	if(!instance->initialize(logLevel, rebootFlag)){
+	if(!instance->initialize(logLevel, rebootFlag, micShmName, workerThreads, logUtcOffset)){
 		AISDK_ERROR(LX("createNewFailed").d("reason", "failed to initialize sampleApp"));
 		return nullptr;
 	}
@@ -84,15 +92,37 @@ SampleApp::~SampleApp() {
 	if(m_alarmMediaPlayer) {
 		m_alarmMediaPlayer->shutdown();
 	}
+	// Attached processes keep their own mapping; only the name goes away.
+	if(!m_micShmName.empty()) {
+		utils::sharedbuffer::SharedMemoryBuffer::remove(m_micShmName);
+	}
+	// The components still use the pool while they are destroyed; m_workerPool keeps it until they are gone.
+	if(m_workerPool) {
+		utils::threading::WorkerPool::setDefault(nullptr);
+	}
 }
 
-bool SampleApp::initialize(const std::string& logLevel, bool rebootFlag) {
+bool SampleApp::initialize(
+	const std::string& logLevel,
+	bool rebootFlag,
+	const std::string& micShmName,
+	unsigned int workerThreads,
+	const std::string& logUtcOffset) {
 	/*
      * Set up the SDK logging system to write to the SampleApp's ConsoleZloger.
      * Also adjust the logging level if requested.
      */
-    std::shared_ptr<utils::logging::Logger> consoleLoger =
-        std::make_shared<application::ConsoleZloger>();
+    std::shared_ptr<utils::logging::Logger> consoleLoger;
+	if (logUtcOffset.empty()) {
+		consoleLoger = std::make_shared<application::ConsoleZloger>();
+	} else {
+		std::chrono::seconds utcOffset;
+		if (!utils::logging::LogStringFormatter::parseUtcOffset(logUtcOffset, &utcOffset)) {
+			AISDK_ERROR(LX("initializeFailed").d("reason", "invalidLogUtcOffset").d("offset", logUtcOffset));
+			return false;
+		}
+		consoleLoger = std::make_shared<application::ConsoleZloger>(utcOffset);
+	}
 
     utils::logging::Level logLevelValue = utils::logging::Level::UNKNOWN;
 	if (!logLevel.empty()) {
@@ -106,24 +136,38 @@ bool SampleApp::initialize(const std::string& logLevel, bool rebootFlag) {
         consoleLoger->setLevel(logLevelValue);
 	}
 #ifdef AISDK_LOG_MODULE	
-	utils::logging::LoggerSinkManager::instance().initialize(consoleLoger);
+	// Format and write the lines on a background thread rather than in the callers.
+	utils::logging::LoggerSinkManager::instance().initialize(utils::logging::AsyncLogger::create(consoleLoger));
 #endif
+	// Must happen before any component creates its Executor.
+	if(workerThreads > 0) {
+		m_workerPool = utils::threading::WorkerPool::create(workerThreads);
+		utils::threading::WorkerPool::setDefault(m_workerPool);
+		AISDK_INFO(LX("initialize").d("workerThreads", workerThreads));
+	}
 	// Create a libao engine object.
-	auto m_aoEngine = mediaPlayer::ffmpeg::AOEngine::create();
+	m_aoEngine = mediaPlayer::ffmpeg::AOEngine::create();
 	if(!m_aoEngine) {
 		AISDK_ERROR(LX("Failed to create media player engine!"));
 		return false;
 	}
+
+	// Open the one output device all media players are mixed onto.
+	m_audioMixer = mediaPlayer::ffmpeg::AudioMixer::create(mediaPlayer::ffmpeg::AOSink::create(m_aoEngine));
+	if(!m_audioMixer) {
+		AISDK_ERROR(LX("Failed to create audio mixer!"));
+		return false;
+	}
 	
 	// Create a chatMediaPlayer of @c Pawrapper.
-	m_chatMediaPlayer = mediaPlayer::ffmpeg::AOWrapper::create(m_aoEngine);
+	m_chatMediaPlayer = mediaPlayer::ffmpeg::AOWrapper::createForMixer(m_audioMixer);
 	if(!m_chatMediaPlayer) {
 		AISDK_ERROR(LX("Failed to create media player for chat speech!"));
 		return false;
 	}
 
     // Create a resourceMediaPlayer of @c Pawrapper. @20190409
-    m_resourceMediaPlayer = mediaPlayer::ffmpeg::AOWrapper::create(m_aoEngine);
+    m_resourceMediaPlayer = mediaPlayer::ffmpeg::AOWrapper::createForMixer(m_audioMixer);
     if(!m_resourceMediaPlayer) {
         AISDK_ERROR(LX("Failed to create media player for resource play!"));
         return false;
@@ -132,13 +176,13 @@ bool SampleApp::initialize(const std::string& logLevel, bool rebootFlag) {
     /// ...
     /// ...
 
-	m_streamMediaPlayer = mediaPlayer::ffmpeg::AOWrapper::create(m_aoEngine);
+	m_streamMediaPlayer = mediaPlayer::ffmpeg::AOWrapper::createForMixer(m_audioMixer);
 	if(!m_streamMediaPlayer) {
 		AISDK_ERROR(LX("Failed to create media player for stream!"));
 		return false;
 	}
 
-	m_alarmMediaPlayer = mediaPlayer::ffmpeg::AOWrapper::create(m_aoEngine);
+	m_alarmMediaPlayer = mediaPlayer::ffmpeg::AOWrapper::createForMixer(m_audioMixer);
 	if(!m_alarmMediaPlayer) {
 		AISDK_ERROR(LX("Failed to create media player for alarm!"));
 		return false;
@@ -195,8 +239,20 @@ bool SampleApp::initialize(const std::string& logLevel, bool rebootFlag) {
      */
 	size_t bufferSize = utils::sharedbuffer::SharedBuffer::calculateBufferSize(
 		BUFFER_SIZE_IN_SAMPLES, WORD_SIZE, MAX_READERS);
-	AISDK_INFO(LX("INIT").d("bufferSize", bufferSize));
-	auto buffer = std::make_shared<utils::sharedbuffer::SharedBuffer::Buffer>(bufferSize);
+	AISDK_INFO(LX("INIT").d("bufferSize", bufferSize).d("micShmName", micShmName));
+	std::shared_ptr<utils::sharedbuffer::SharedBuffer::Buffer> buffer;
+	if(micShmName.empty()) {
+		buffer = std::make_shared<utils::sharedbuffer::SharedBuffer::Buffer>(bufferSize);
+	} else {
+		// A stale object left by a crashed run would make creation fail, so clear the name first.
+		utils::sharedbuffer::SharedMemoryBuffer::remove(micShmName);
+		buffer = utils::sharedbuffer::SharedMemoryBuffer::create(micShmName, bufferSize);
+		if(!buffer) {
+			AISDK_ERROR(LX("Failed to create shared memory for the microphone buffer!").d("name", micShmName));
+			return false;
+		}
+		m_micShmName = micShmName;
+	}
 	std::shared_ptr<utils::sharedbuffer::SharedBuffer> sharedBufferStream = 
 						utils::sharedbuffer::SharedBuffer::create(buffer, WORD_SIZE, MAX_READERS);
 	if(!sharedBufferStream) {
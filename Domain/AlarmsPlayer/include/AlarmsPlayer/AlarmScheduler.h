@@ -0,0 +1,205 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __ALARMS_PLAYER_ALARM_SCHEDULER_H_
+#define __ALARMS_PLAYER_ALARM_SCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "AlarmsPlayer/AlarmStore.h"
+
+namespace aisdk {
+namespace domain {
+namespace alarmsPlayer {
+
+/**
+ * Rings alarms on time.  The alarms are read from an @c AlarmStore once, then kept in memory along with a min-heap
+ * of the times they ring next; changes go to both.  One thread sleeps until the first of those times, or until the
+ * alarms change, so nothing is read from the store while no alarm is due.  Changes are written to the store after
+ * the memory is updated and without holding the lock the thread waits on, so a slow write never delays a ring.
+ *
+ * A one-time alarm is removed once it has rung.  An alarm found more than @c MISSED_ALARM_GRACE late, because the
+ * device was off or its clock was set, doesn't ring: a one-time alarm is removed, a repeating one waits for its next
+ * time.  All methods may be called from any thread.
+ */
+class AlarmScheduler {
+public:
+    /// A point in wall clock time, which alarms are set in.
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    /// Called on the scheduler thread with each alarm when it rings.
+    using AlarmCallback = std::function<void(const Alarm& alarm)>;
+
+    /// How late an alarm may still ring.
+    static const std::chrono::seconds MISSED_ALARM_GRACE;
+
+    /**
+     * Creates a scheduler with the alarms in a store, and starts its thread.
+     *
+     * @param store The store of the alarms.
+     * @param callback Called with each alarm when it rings; it must not call back into the scheduler.
+     * @return The scheduler, or @c nullptr if the alarms can't be read.
+     */
+    static std::unique_ptr<AlarmScheduler> create(std::unique_ptr<AlarmStore> store, AlarmCallback callback);
+
+    /**
+     * Destructor.  Stops the thread.
+     */
+    ~AlarmScheduler();
+
+    /**
+     * Adds an alarm, replacing one of the same type and timestamp (and weekday, for a repeating one).
+     *
+     * @param alarm The alarm.
+     * @return Whether it was stored.
+     */
+    bool setAlarm(const Alarm& alarm);
+
+    /**
+     * Removes the alarms of a type at a timestamp, on all weekdays for repeating alarms.
+     *
+     * @param type The type of the alarms.
+     * @param timestamp The timestamp of the alarms.
+     * @return Whether the store was updated.
+     */
+    bool deleteAlarms(Alarm::Type type, int64_t timestamp);
+
+    /**
+     * Removes all alarms.
+     *
+     * @return Whether the store was updated.
+     */
+    bool clear();
+
+    /**
+     * Stops the thread; no alarm rings after this returns.  Changes are still stored.
+     */
+    void shutdown();
+
+    /**
+     * Works out when an alarm rings next.
+     *
+     * @param alarm The alarm.
+     * @param after The time to look from; a repeating alarm rings strictly after it, a one-time alarm at its time.
+     * @param[out] time When the alarm rings.
+     * @return Whether it rings at all; a repeating alarm whose weekday is out of range never does.
+     */
+    static bool getNextTime(const Alarm& alarm, TimePoint after, TimePoint* time);
+
+private:
+    /// Identifies an alarm: its type, timestamp and weekday.
+    using Key = std::tuple<Alarm::Type, int64_t, int>;
+
+    /// An alarm kept in memory.
+    struct Entry {
+        /// The alarm.
+        Alarm alarm;
+
+        /// Tells this version of the alarm from an earlier one with the same key still in the heap.
+        uint64_t version;
+    };
+
+    /// A time an alarm rings, in the heap.
+    struct Deadline {
+        /// When it rings.
+        TimePoint time;
+
+        /// The alarm.
+        Key key;
+
+        /// The version of the alarm this was scheduled for; stale once the alarm is changed or removed.
+        uint64_t version;
+
+        /// Orders the heap with the earliest time on top.
+        bool operator<(const Deadline& other) const {
+            return time > other.time;
+        }
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param store The store of the alarms.
+     * @param callback Called with each alarm when it rings.
+     */
+    AlarmScheduler(std::unique_ptr<AlarmStore> store, AlarmCallback callback);
+
+    /**
+     * Puts an alarm in memory and schedules it, without storing it.  @c m_mutex must be held.
+     *
+     * @param alarm The alarm.
+     * @param now The time to schedule from.
+     */
+    void addLocked(const Alarm& alarm, TimePoint now);
+
+    /**
+     * Writes the alarms in memory of a type at a timestamp to the store.  @c m_storeMutex must be held, and
+     * @c m_mutex must not be.
+     *
+     * @param type The type of the alarms.
+     * @param timestamp The timestamp of the alarms.
+     * @return Whether they were written.
+     */
+    bool store(Alarm::Type type, int64_t timestamp);
+
+    /// The scheduler thread: rings each alarm when its time comes.
+    void run();
+
+    /// Called with each alarm when it rings.
+    const AlarmCallback m_callback;
+
+    /**
+     * Serializes writes to @c m_store, which isn't thread safe, and keeps them in the order the changes were made.
+     * Taken before @c m_mutex when both are needed.
+     */
+    std::mutex m_storeMutex;
+
+    /// Serializes access to the members below, except @c m_store.
+    std::mutex m_mutex;
+
+    /// Woken when the alarms change or the scheduler shuts down.
+    std::condition_variable m_wakeTrigger;
+
+    /// The store of the alarms; guarded by @c m_storeMutex.
+    std::unique_ptr<AlarmStore> m_store;
+
+    /// The alarms.
+    std::map<Key, Entry> m_alarms;
+
+    /// The times the alarms ring next, the earliest first; entries of changed or removed alarms are skipped.
+    std::priority_queue<Deadline> m_deadlines;
+
+    /// The version given to the alarm added last.
+    uint64_t m_lastVersion;
+
+    /// Whether @c shutdown() has been called.
+    bool m_isShuttingDown;
+
+    /// The scheduler thread.
+    std::thread m_thread;
+};
+
+}  // namespace alarmsPlayer
+}  // namespace domain
+}  // namespace aisdk
+
+#endif  // __ALARMS_PLAYER_ALARM_SCHEDULER_H_
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __ALARMS_PLAYER_ALARM_STORE_H_
+#define __ALARMS_PLAYER_ALARM_STORE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sqlite3.h>
+
+namespace aisdk {
+namespace domain {
+namespace alarmsPlayer {
+
+/**
+ * An alarm set by the user.
+ */
+struct Alarm {
+    /// The kinds of alarm.
+    enum class Type {
+        /// Rings once, at @c timestamp; kept in the table @c alarm.
+        ONCE,
+        /// Rings every day, or every week on @c weekday, at @c timestamp into the day; kept in @c alarmList_repeat.
+        REPEAT
+    };
+
+    /// The kind of alarm.
+    Type type;
+
+    /// For @c ONCE the time in milliseconds since the epoch, for @c REPEAT the local time of day in milliseconds.
+    int64_t timestamp;
+
+    /// For @c REPEAT the day of the week as @c tm_wday counts it, or 0 for every day; always 0 for @c ONCE.
+    int weekday;
+
+    /// The event the user named, which may be empty.
+    std::string eventType;
+
+    /// What is said when the alarm rings.
+    std::string content;
+};
+
+/**
+ * Keeps the alarms in a SQLite database, in the tables the device has always used.  The database stays open, and
+ * each statement is prepared once, for as long as the store lives.  Not thread safe.
+ */
+class AlarmStore {
+public:
+    /**
+     * Opens the database, creating the tables and their indexes if they don't exist yet.
+     *
+     * @param path The path of the database file.
+     * @return The store, or @c nullptr if the database can't be opened.
+     */
+    static std::unique_ptr<AlarmStore> create(const std::string& path);
+
+    /**
+     * Destructor.  Finalizes the statements and closes the database.
+     */
+    ~AlarmStore();
+
+    /**
+     * Reads all alarms.
+     *
+     * @param[out] alarms The alarms.
+     * @return Whether they could be read.
+     */
+    bool load(std::vector<Alarm>* alarms);
+
+    /**
+     * Replaces, in one transaction, the alarms of a type at a timestamp with others.
+     *
+     * @param type The type of the alarms.
+     * @param timestamp The timestamp of the alarms.
+     * @param alarms The alarms to keep there instead, which may be none.
+     * @return Whether the alarms were written.
+     */
+    bool replace(Alarm::Type type, int64_t timestamp, const std::vector<Alarm>& alarms);
+
+    /**
+     * Removes all alarms.
+     *
+     * @return Whether they were removed.
+     */
+    bool clear();
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param db The open database, which the store closes.
+     */
+    explicit AlarmStore(sqlite3* db);
+
+    /**
+     * Creates the tables and indexes if needed and prepares the statements.
+     *
+     * @return Whether it succeeded.
+     */
+    bool initialize();
+
+    /**
+     * Prepares a statement.
+     *
+     * @param sql The statement.
+     * @param[out] statement The prepared statement.
+     * @return Whether it succeeded.
+     */
+    bool prepare(const char* sql, sqlite3_stmt** statement);
+
+    /**
+     * Runs a statement which returns no rows, then resets it for the next use.
+     *
+     * @param statement The statement, with its parameters bound.
+     * @return Whether it succeeded.
+     */
+    bool step(sqlite3_stmt* statement);
+
+    /**
+     * Runs SQL which returns no rows and is run too rarely to prepare.
+     *
+     * @param sql The SQL.
+     * @return Whether it succeeded.
+     */
+    bool execute(const char* sql);
+
+    /// The database.
+    sqlite3* m_db;
+
+    /// Selects all one-time alarms.
+    sqlite3_stmt* m_selectOnce;
+
+    /// Selects all repeating alarms.
+    sqlite3_stmt* m_selectRepeat;
+
+    /// Inserts a one-time alarm.
+    sqlite3_stmt* m_insertOnce;
+
+    /// Inserts a repeating alarm.
+    sqlite3_stmt* m_insertRepeat;
+
+    /// Deletes the one-time alarms at a timestamp.
+    sqlite3_stmt* m_deleteOnce;
+
+    /// Deletes the repeating alarms at a time of day.
+    sqlite3_stmt* m_deleteRepeat;
+};
+
+}  // namespace alarmsPlayer
+}  // namespace domain
+}  // namespace aisdk
+
+#endif  // __ALARMS_PLAYER_ALARM_STORE_H_
@@ -18,7 +18,8 @@
 #include <string>
 #include <unordered_set>
 #include <deque>
-#include <sqlite3.h>
+
+#include <json/json.h>
 
 #include <Utils/Channel/ChannelObserverInterface.h>
 #include <Utils/Channel/AudioTrackManagerInterface.h>
@@ -32,6 +33,7 @@
 #include <NLP/DomainProxy.h>
 #include <ASR/GenericAutomaticSpeechRecognizer.h>
 #include <Utils/Attachment/AttachmentManagerInterface.h>
+#include "AlarmsPlayer/AlarmScheduler.h"
 
 namespace aisdk {
 namespace domain {
@@ -182,16 +184,24 @@ private:
 
     /**
      * Initializes the @c AlarmsPlayer.
-     * Adds the @c AlarmsPlayer as an observer of the speech player.
+     * Adds the @c AlarmsPlayer as an observer of the speech player, and starts the @c AlarmScheduler.
      */
     void init();
 
+    /**
+     * Tells the ack observers (on the @c m_executor thread) that an alarm is ringing.
+     *
+     * @param content What is said for the alarm.
+     */
+    void executeAlarmRinging(const std::string& content);
 
     /**
-     * Initializes the @c AlarmsPlayer.
-     * Adds the @c AlarmsPlayer as check sqlite3 db.
+     * Sets, deletes or flushes alarms as an alarm directive asks.
+     *
+     * @param data The data of the directive.
      */
-    void sqliteThreadHander();
+    void AnalysisNlpDataForAlarmsPlayer(const Json::Value &data);
+
 
     /**
      * Pre-handle a ResourcesPlayer.Chat directive (on the @c m_executor threadpool) to parse own keys and values.
@@ -371,12 +381,6 @@ private:
         utils::dialogRelay::DialogUXStateObserverInterface::DialogUXState newState);
     ///
     const char* CreateRandomUuid(char *uuid);
-    ///
-    unsigned int getMorningTime(); 
-    ///
-    void CheckAlarmList(sqlite3 *db);
-    ///
-    void CheckRepeatAlarmList(sqlite3 *db);
 
 	/// The name of DomainHandler identifies which @c DomainHandlerInterface operates on.
 	std::unordered_set<std::string> m_handlerName;
@@ -447,8 +451,8 @@ private:
 	/// An internal thread pool which queues up operations from asynchronous API calls
 	utils::threading::Executor m_executor;
 
-    ///sqlite thread for check sqlite3 data and play alarm  
-    std::thread m_sqliteThread;
+    /// Rings the alarms kept in the alarm database; @c nullptr if the database can't be opened.
+    std::unique_ptr<AlarmScheduler> m_scheduler;
     
 };
 
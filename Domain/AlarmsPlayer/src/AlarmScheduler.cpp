@@ -0,0 +1,240 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <ctime>
+
+#include <Utils/Logging/Logger.h>
+
+#include "AlarmsPlayer/AlarmScheduler.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG{"AlarmScheduler"};
+
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace domain {
+namespace alarmsPlayer {
+
+const std::chrono::seconds AlarmScheduler::MISSED_ALARM_GRACE{10};
+
+/// The number of days in a week, which is as far as a repeating alarm can be from ringing.
+static const int DAYS_PER_WEEK = 7;
+
+std::unique_ptr<AlarmScheduler> AlarmScheduler::create(std::unique_ptr<AlarmStore> store, AlarmCallback callback) {
+    if (!store) {
+        AISDK_ERROR(LX("createFailed").d("reason", "nullStore"));
+        return nullptr;
+    }
+    if (!callback) {
+        AISDK_ERROR(LX("createFailed").d("reason", "nullCallback"));
+        return nullptr;
+    }
+    std::vector<Alarm> alarms;
+    if (!store->load(&alarms)) {
+        AISDK_ERROR(LX("createFailed").d("reason", "loadFailed"));
+        return nullptr;
+    }
+
+    std::unique_ptr<AlarmScheduler> scheduler(new AlarmScheduler(std::move(store), std::move(callback)));
+    {
+        std::lock_guard<std::mutex> lock(scheduler->m_mutex);
+        auto now = std::chrono::system_clock::now();
+        for (auto& alarm : alarms) {
+            scheduler->addLocked(alarm, now);
+        }
+    }
+    AISDK_INFO(LX("create").d("alarms", alarms.size()));
+    scheduler->m_thread = std::thread(&AlarmScheduler::run, scheduler.get());
+    return scheduler;
+}
+
+AlarmScheduler::AlarmScheduler(std::unique_ptr<AlarmStore> store, AlarmCallback callback) :
+        m_callback{std::move(callback)},
+        m_store{std::move(store)},
+        m_lastVersion{0},
+        m_isShuttingDown{false} {
+}
+
+AlarmScheduler::~AlarmScheduler() {
+    shutdown();
+}
+
+bool AlarmScheduler::setAlarm(const Alarm& alarm) {
+    std::lock_guard<std::mutex> storeLock(m_storeMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        addLocked(alarm, std::chrono::system_clock::now());
+        m_wakeTrigger.notify_one();
+    }
+    return store(alarm.type, alarm.timestamp);
+}
+
+bool AlarmScheduler::deleteAlarms(Alarm::Type type, int64_t timestamp) {
+    std::lock_guard<std::mutex> storeLock(m_storeMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_alarms.erase(
+            m_alarms.lower_bound(Key{type, timestamp, INT_MIN}), m_alarms.upper_bound(Key{type, timestamp, INT_MAX}));
+        // Their deadlines are skipped when they come up; waking lets the thread sleep until the next one instead.
+        m_wakeTrigger.notify_one();
+    }
+    return store(type, timestamp);
+}
+
+bool AlarmScheduler::clear() {
+    std::lock_guard<std::mutex> storeLock(m_storeMutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_alarms.clear();
+        m_deadlines = std::priority_queue<Deadline>();
+        m_wakeTrigger.notify_one();
+    }
+    return m_store->clear();
+}
+
+void AlarmScheduler::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isShuttingDown = true;
+        m_wakeTrigger.notify_one();
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool AlarmScheduler::getNextTime(const Alarm& alarm, TimePoint after, TimePoint* time) {
+    if (!time) {
+        return false;
+    }
+    if (Alarm::Type::ONCE == alarm.type) {
+        *time = TimePoint(std::chrono::milliseconds(alarm.timestamp));
+        return true;
+    }
+
+    auto seconds = std::chrono::system_clock::to_time_t(after);
+    struct tm today;
+    if (!localtime_r(&seconds, &today)) {
+        return false;
+    }
+    // Today's time may have passed already, so look as far as the same weekday next week.
+    for (int day = 0; day <= DAYS_PER_WEEK; ++day) {
+        struct tm midnight = today;
+        midnight.tm_mday += day;
+        midnight.tm_hour = 0;
+        midnight.tm_min = 0;
+        midnight.tm_sec = 0;
+        midnight.tm_isdst = -1;
+        auto start = mktime(&midnight);
+        if (-1 == start) {
+            return false;
+        }
+        if (0 != alarm.weekday && alarm.weekday != midnight.tm_wday) {
+            continue;
+        }
+        auto candidate = std::chrono::system_clock::from_time_t(start) + std::chrono::milliseconds(alarm.timestamp);
+        if (candidate > after) {
+            *time = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+void AlarmScheduler::addLocked(const Alarm& alarm, TimePoint now) {
+    Key key{alarm.type, alarm.timestamp, Alarm::Type::ONCE == alarm.type ? 0 : alarm.weekday};
+    auto version = ++m_lastVersion;
+    m_alarms[key] = Entry{alarm, version};
+
+    TimePoint time;
+    if (getNextTime(alarm, now, &time)) {
+        m_deadlines.push(Deadline{time, key, version});
+    } else {
+        AISDK_WARN(LX("addLocked")
+                       .d("reason", "neverRings")
+                       .d("timestamp", alarm.timestamp)
+                       .d("weekday", alarm.weekday));
+    }
+}
+
+bool AlarmScheduler::store(Alarm::Type type, int64_t timestamp) {
+    std::vector<Alarm> alarms;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto end = m_alarms.upper_bound(Key{type, timestamp, INT_MAX});
+        for (auto it = m_alarms.lower_bound(Key{type, timestamp, INT_MIN}); it != end; ++it) {
+            alarms.push_back(it->second.alarm);
+        }
+    }
+    return m_store->replace(type, timestamp, alarms);
+}
+
+void AlarmScheduler::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_isShuttingDown) {
+        if (m_deadlines.empty()) {
+            m_wakeTrigger.wait(lock);
+            continue;
+        }
+
+        auto deadline = m_deadlines.top();
+        auto it = m_alarms.find(deadline.key);
+        if (it == m_alarms.end() || it->second.version != deadline.version) {
+            m_deadlines.pop();
+            continue;
+        }
+        auto now = std::chrono::system_clock::now();
+        if (now < deadline.time) {
+            m_wakeTrigger.wait_until(lock, deadline.time);
+            continue;
+        }
+
+        m_deadlines.pop();
+        auto alarm = it->second.alarm;
+        bool isOnce = Alarm::Type::ONCE == alarm.type;
+        if (isOnce) {
+            m_alarms.erase(it);
+        } else {
+            TimePoint next;
+            if (getNextTime(alarm, std::max(now, deadline.time), &next)) {
+                m_deadlines.push(Deadline{next, deadline.key, deadline.version});
+            }
+        }
+
+        auto lateness = std::chrono::duration_cast<std::chrono::milliseconds>(now - deadline.time);
+        if (lateness > MISSED_ALARM_GRACE) {
+            AISDK_WARN(LX("alarmMissed").d("timestamp", alarm.timestamp).d("late(ms)", lateness.count()));
+        } else {
+            AISDK_INFO(LX("alarmRinging").d("timestamp", alarm.timestamp).d("late(ms)", lateness.count()));
+            lock.unlock();
+            m_callback(alarm);
+            lock.lock();
+        }
+        // Ring first: writing to flash may take a while.  The alarm is removed from memory already, and the write
+        // is made without m_mutex, so the next alarm isn't held up behind it.
+        if (isOnce) {
+            lock.unlock();
+            {
+                std::lock_guard<std::mutex> storeLock(m_storeMutex);
+                store(alarm.type, alarm.timestamp);
+            }
+            lock.lock();
+        }
+    }
+}
+
+}  // namespace alarmsPlayer
+}  // namespace domain
+}  // namespace aisdk
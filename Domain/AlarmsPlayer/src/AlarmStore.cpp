@@ -0,0 +1,187 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <Utils/Logging/Logger.h>
+
+#include "AlarmsPlayer/AlarmStore.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG{"AlarmStore"};
+
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace domain {
+namespace alarmsPlayer {
+
+/// The value of the column @c action_type of a one-time alarm.
+static const int ONCE_ACTION_TYPE = 1;
+
+/// The value of the column @c loop_mask of a one-time alarm.
+static const int ONCE_LOOP_MASK = 0;
+
+/// The value of the column @c loop_mask of a repeating alarm.
+static const int REPEAT_LOOP_MASK = 1;
+
+/// Creates the tables and the indexes the alarms are looked up by.
+static const char* CREATE_SCHEMA_SQL =
+    "CREATE TABLE IF NOT EXISTS alarm(timestamp, evt_type, action_type, loop_mask, content);"
+    "CREATE TABLE IF NOT EXISTS alarmList_repeat(timestamp_day, evt_type, weekday, loop_mask, content);"
+    "CREATE INDEX IF NOT EXISTS alarm_timestamp ON alarm(timestamp);"
+    "CREATE INDEX IF NOT EXISTS alarmList_repeat_timestamp_day ON alarmList_repeat(timestamp_day);";
+
+/**
+ * Reads a text column, which is @c NULL in rows written by old versions without an event.
+ */
+static std::string columnText(sqlite3_stmt* statement, int column) {
+    auto text = sqlite3_column_text(statement, column);
+    return text ? reinterpret_cast<const char*>(text) : "";
+}
+
+std::unique_ptr<AlarmStore> AlarmStore::create(const std::string& path) {
+    sqlite3* db = nullptr;
+    if (SQLITE_OK != sqlite3_open(path.c_str(), &db)) {
+        AISDK_ERROR(LX("createFailed").d("reason", "openFailed").d("path", path).d("error", sqlite3_errmsg(db)));
+        sqlite3_close(db);
+        return nullptr;
+    }
+
+    std::unique_ptr<AlarmStore> store(new AlarmStore(db));
+    if (!store->initialize()) {
+        AISDK_ERROR(LX("createFailed").d("reason", "initializeFailed").d("path", path));
+        return nullptr;
+    }
+    return store;
+}
+
+AlarmStore::AlarmStore(sqlite3* db) :
+        m_db{db},
+        m_selectOnce{nullptr},
+        m_selectRepeat{nullptr},
+        m_insertOnce{nullptr},
+        m_insertRepeat{nullptr},
+        m_deleteOnce{nullptr},
+        m_deleteRepeat{nullptr} {
+}
+
+AlarmStore::~AlarmStore() {
+    for (auto statement : {m_selectOnce, m_selectRepeat, m_insertOnce, m_insertRepeat, m_deleteOnce, m_deleteRepeat}) {
+        sqlite3_finalize(statement);
+    }
+    sqlite3_close(m_db);
+}
+
+bool AlarmStore::initialize() {
+    return execute(CREATE_SCHEMA_SQL) &&
+           prepare("SELECT timestamp, evt_type, content FROM alarm;", &m_selectOnce) &&
+           prepare("SELECT timestamp_day, evt_type, weekday, content FROM alarmList_repeat;", &m_selectRepeat) &&
+           prepare("INSERT INTO alarm VALUES(?, ?, ?, ?, ?);", &m_insertOnce) &&
+           prepare("INSERT INTO alarmList_repeat VALUES(?, ?, ?, ?, ?);", &m_insertRepeat) &&
+           prepare("DELETE FROM alarm WHERE timestamp = ?;", &m_deleteOnce) &&
+           prepare("DELETE FROM alarmList_repeat WHERE timestamp_day = ?;", &m_deleteRepeat);
+}
+
+bool AlarmStore::prepare(const char* sql, sqlite3_stmt** statement) {
+    if (SQLITE_OK != sqlite3_prepare_v2(m_db, sql, -1, statement, nullptr)) {
+        AISDK_ERROR(LX("prepareFailed").d("sql", sql).d("error", sqlite3_errmsg(m_db)));
+        return false;
+    }
+    return true;
+}
+
+bool AlarmStore::step(sqlite3_stmt* statement) {
+    auto result = sqlite3_step(statement);
+    sqlite3_reset(statement);
+    sqlite3_clear_bindings(statement);
+    if (SQLITE_DONE != result) {
+        AISDK_ERROR(LX("stepFailed").d("sql", sqlite3_sql(statement)).d("error", sqlite3_errmsg(m_db)));
+        return false;
+    }
+    return true;
+}
+
+bool AlarmStore::execute(const char* sql) {
+    char* error = nullptr;
+    if (SQLITE_OK != sqlite3_exec(m_db, sql, nullptr, nullptr, &error)) {
+        AISDK_ERROR(LX("executeFailed").d("sql", sql).d("error", error ? error : ""));
+        sqlite3_free(error);
+        return false;
+    }
+    return true;
+}
+
+bool AlarmStore::load(std::vector<Alarm>* alarms) {
+    if (!alarms) {
+        return false;
+    }
+    int result;
+    while (SQLITE_ROW == (result = sqlite3_step(m_selectOnce))) {
+        alarms->push_back(Alarm{Alarm::Type::ONCE,
+                                sqlite3_column_int64(m_selectOnce, 0),
+                                0,
+                                columnText(m_selectOnce, 1),
+                                columnText(m_selectOnce, 2)});
+    }
+    sqlite3_reset(m_selectOnce);
+    if (SQLITE_DONE != result) {
+        AISDK_ERROR(LX("loadFailed").d("table", "alarm").d("error", sqlite3_errmsg(m_db)));
+        return false;
+    }
+
+    while (SQLITE_ROW == (result = sqlite3_step(m_selectRepeat))) {
+        alarms->push_back(Alarm{Alarm::Type::REPEAT,
+                                sqlite3_column_int64(m_selectRepeat, 0),
+                                sqlite3_column_int(m_selectRepeat, 2),
+                                columnText(m_selectRepeat, 1),
+                                columnText(m_selectRepeat, 3)});
+    }
+    sqlite3_reset(m_selectRepeat);
+    if (SQLITE_DONE != result) {
+        AISDK_ERROR(LX("loadFailed").d("table", "alarmList_repeat").d("error", sqlite3_errmsg(m_db)));
+        return false;
+    }
+    return true;
+}
+
+bool AlarmStore::replace(Alarm::Type type, int64_t timestamp, const std::vector<Alarm>& alarms) {
+    bool isOnce = Alarm::Type::ONCE == type;
+    if (!execute("BEGIN;")) {
+        return false;
+    }
+
+    auto remove = isOnce ? m_deleteOnce : m_deleteRepeat;
+    sqlite3_bind_int64(remove, 1, timestamp);
+    bool succeeded = step(remove);
+    for (auto it = alarms.begin(); succeeded && it != alarms.end(); ++it) {
+        auto insert = isOnce ? m_insertOnce : m_insertRepeat;
+        sqlite3_bind_int64(insert, 1, it->timestamp);
+        sqlite3_bind_text(insert, 2, it->eventType.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(insert, 3, isOnce ? ONCE_ACTION_TYPE : it->weekday);
+        sqlite3_bind_int(insert, 4, isOnce ? ONCE_LOOP_MASK : REPEAT_LOOP_MASK);
+        sqlite3_bind_text(insert, 5, it->content.c_str(), -1, SQLITE_TRANSIENT);
+        succeeded = step(insert);
+    }
+
+    if (!succeeded) {
+        execute("ROLLBACK;");
+        return false;
+    }
+    return execute("COMMIT;");
+}
+
+bool AlarmStore::clear() {
+    return execute("DELETE FROM alarm; DELETE FROM alarmList_repeat;");
+}
+
+}  // namespace alarmsPlayer
+}  // namespace domain
+}  // namespace aisdk
@@ -11,10 +11,9 @@
  */
 
 #include <iostream>
-#include <sqlite3.h>
 
 #include "AlarmsPlayer/AlarmsPlayer.h"
-#include <Utils/cJSON.h>
+#include <json/json.h>
 #include "string.h"
 #include<deque>  
 #include <Utils/Logging/Logger.h>
@@ -53,9 +52,6 @@ static const std::chrono::milliseconds DEFAULT_OFFSET{0};
 //add deque for store TTS_URL_LIST;
 std::deque<std::string> TTS_URL_LIST; 
 
-//add deque for store repeat_alarm;
-std::deque<std::string> REPEAT_ALARM_LIST; 
-
 std::shared_ptr<AlarmsPlayer> AlarmsPlayer::create(
 	std::shared_ptr<MediaPlayerInterface> mediaPlayer,
 	std::shared_ptr<utils::attachment::AttachmentManagerInterface> ttsDocker,
@@ -214,6 +210,10 @@ std::unordered_set<std::string> AlarmsPlayer::getHandlerName() const {
 
 void AlarmsPlayer::doShutdown() {
 	AISDK_INFO(LX("doShutdown"));
+	// No alarm rings into the executor once it has shut down.
+	if(m_scheduler) {
+		m_scheduler->shutdown();
+	}
 	m_alarmPlayer->setObserver(nullptr);
 	{
         std::unique_lock<std::mutex> lock(m_mutex);
@@ -316,513 +316,155 @@ const char* AlarmsPlayer::CreateRandomUuid(char *uuid)
 
 
 
-unsigned int AlarmsPlayer::getMorningTime() 
-{  
-    time_t t = time(NULL); 
-    struct tm * tm= localtime(&t);  
-    tm->tm_hour = 0;  
-    tm->tm_min = 0;  
-    tm->tm_sec = 0;  
-    return  mktime(tm);  
-}  
-    
-void AlarmsPlayer::CheckAlarmList(sqlite3 *db)
-{
-    int nrow;
-    int ncolumn;
-    char *zErrMsg =NULL;
-    char **azResult=NULL;
-    char deleteAlarmTime[512];
-    int nrowContent;
-    int ncolumnContent;
-    char *zErrMsgContent =NULL;
-    char **azResultContent=NULL;
-    char deleteAlarmContent[512];
-
-    char const *alarmSql= "select *from alarm;";
-    sqlite3_get_table( db , alarmSql , &azResult , &nrow , &ncolumn , &zErrMsg );
-
-    if((nrow >= 1) && (ncolumn != 0))
-    {
-        char const *minsql = "select min(timestamp) from alarm;";
-        sqlite3_get_table( db , minsql , &azResult , &nrow , &ncolumn , &zErrMsg );
-
-        long int alarmtimesec = (long int)(atoll(azResult[nrow*ncolumn])/1000);   //long long int --> long int;
-        // struct tm *alarmp;
-        // alarmp = localtime(&alarmtimesec);
-        // printf("AlarmsPlayer:sqliteThreadHander::first alarm time:%d-%d-%d %d:%d:%d\n", 1900+alarmp->tm_year, 1+alarmp->tm_mon, alarmp->tm_mday, alarmp->tm_hour, alarmp->tm_min, alarmp->tm_sec);
-
-        // current time
-        time_t timesec;
-        // struct tm *p;
-        time(&timesec);
-        // p = localtime(&timesec);         
-        // printf("AlarmsPlayer:sqliteThreadHander::current system time:%d-%d-%d %d:%d:%d\n", 1900+p->tm_year, 1+p->tm_mon, p->tm_mday, p->tm_hour, p->tm_min, p->tm_sec);
-
-
-        if((timesec/10) == (alarmtimesec/10)) {
-            sprintf(deleteAlarmContent, "select content from alarm where timestamp = %s;" ,azResult[nrow*ncolumn]);
-            sqlite3_get_table( db , deleteAlarmContent , &azResultContent , &nrowContent , &ncolumnContent , &zErrMsgContent );
-            AISDK_DEBUG5(LX("deleteAlarmContent").d("select content from alarm where timestamp", azResultContent[nrowContent*ncolumnContent]));        
-            std::string currentContent = azResultContent[nrowContent*ncolumnContent];
-            
-            for(int i = 0; i < 1; i++) { //'i' use for set repeat times;
-                AISDK_DEBUG5(LX("AlarmsPlayer").d("sqliteThreadHander", "alarm time is coming!"));
-#if 1
-            for(auto observer:m_ackObservers){
-                observer->onAlarmAckStatusChanged(dmInterface::AlarmAckObserverInterface::Status::PLAYING, currentContent);
-            }
-#else            
-                char contentId[37];
-                CreateRandomUuid(contentId);
-                auto writer = m_ttsDocker->createWriter(contentId);
-                auto reader = m_ttsDocker->createReader(contentId, utils::sharedbuffer::ReaderPolicy::BLOCKING);
-                AISDK_DEBUG(LX("deleteAlarmContent").d("currentContent", currentContent));
-                m_asrEngine->acquireTextToSpeech(currentContent, std::move(writer));
-
-                utils::AudioFormat format {
-                        .encoding = aisdk::utils::AudioFormat::Encoding::LPCM,
-                        .endianness = aisdk::utils::AudioFormat::Endianness::LITTLE,
-                        .sampleRateHz = 16000,
-                        .sampleSizeInBits = 16,
-                        .numChannels = 1,
-                        .dataSigned = true };
-
-                auto sourceId = m_alarmPlayer->setSource(std::move(reader), &format);
-                m_alarmPlayer->play(sourceId);
-#endif                
-            }
-            sprintf(deleteAlarmTime, "delete from alarm where timestamp = %s;" ,azResult[nrow*ncolumn]);
-            sqlite3_exec( db , deleteAlarmTime , NULL , NULL , &zErrMsg );
-            sqlite3_free(zErrMsg);
-        }else if((timesec/10) > (alarmtimesec/10)) { 
-            sprintf(deleteAlarmTime, "delete from alarm where timestamp = %s;" ,azResult[nrow*ncolumn]);
-            sqlite3_exec( db , deleteAlarmTime , NULL , NULL , &zErrMsg );
-            sqlite3_free(zErrMsg);
-        }
-
+void AlarmsPlayer::executeAlarmRinging(const std::string& content) {
+    AISDK_INFO(LX("executeAlarmRinging").d("content", content));
+    for(auto observer : m_ackObservers) {
+        observer->onAlarmAckStatusChanged(dmInterface::AlarmAckObserverInterface::Status::PLAYING, content);
     }
-
 }
 
-
-void AlarmsPlayer::CheckRepeatAlarmList(sqlite3 *db)
-{
-    int nrow;
-    int ncolumn;
-    char *zErrMsg =NULL;
-    char **azResult=NULL;
-    int nrowContent;
-    int ncolumnContent;
-    char *zErrMsgContent =NULL;
-    char **azResultContent=NULL;
-    char deleteAlarmContent[1024];
-    int nrowWeekday;
-    int ncolumWeekday;
-    char *zErrMsgWeekday =NULL;
-    char **azResultWeekday=NULL;
-    char deleteAlarmWeekday[1024];
-
-    char const *alarmSql_repeat ="select *from alarmList_repeat;";    
-    sqlite3_get_table( db , alarmSql_repeat , &azResult , &nrow , &ncolumn , &zErrMsg );
-
-    // current time
-    time_t timesec;
-    struct tm *p;
-    time(&timesec);
-    p = localtime(&timesec);         
-    int m_weekday = p->tm_wday; 
-
-    if((nrow >= 1) && (ncolumn != 0)) {
-        for(int i=5;i<(nrow+1)*ncolumn;i=i+5) {
-            //AISDK_DEBUG(LX("CheckRepeatAlarmList").d("NO:", (i/5)).d("repeat alarm time ", azResult[i]));           
-            long int alarmtimesec =(long int)( getMorningTime()+ (atoll(azResult[i])/1000));
-       
-            sprintf(deleteAlarmContent, "select content from alarmList_repeat where timestamp_day = %s;" ,azResult[i]);
-            sqlite3_get_table( db , deleteAlarmContent , &azResultContent , &nrowContent , &ncolumnContent , &zErrMsgContent );
-            //AISDK_DEBUG5(LX("deleteAlarmContent").d("select content from alarmList_repeat where timestamp_day", azResultContent[nrowContent*ncolumnContent]));        
-            std::string currentContent = azResultContent[nrowContent*ncolumnContent];
-            
-            sprintf(deleteAlarmWeekday, "select weekday from alarmList_repeat where timestamp_day = %s;" ,azResult[i]);
-            sqlite3_get_table( db , deleteAlarmWeekday , &azResultWeekday , &nrowWeekday , &ncolumWeekday , &zErrMsgWeekday );
-            //AISDK_DEBUG5(LX("deleteAlarmWeekday").d("select weekday from alarmList_repeat where timestamp_day", azResultWeekday[nrowWeekday*ncolumWeekday]));        
-            std::string currentWeekday = azResultWeekday[nrowWeekday*ncolumWeekday];
-
-           if( atoi(currentWeekday.c_str()) == 0 || atoi(currentWeekday.c_str()) == m_weekday ){
-                //AISDK_DEBUG5(LX("deleteAlarmWeekday").d("currentWeekday", atoi(currentWeekday.c_str()) ) );        
-                 if((timesec/5) == (alarmtimesec/5)) {    
-                     AISDK_DEBUG5(LX("CheckRepeatAlarmList").d(" currentContent", currentContent)
-                                                          .d(" currentWeekday", currentWeekday)); 
-                     for(int i = 0; i < 1; i++) {
-                          AISDK_DEBUG5(LX("AlarmsPlayer").d("sqliteThreadHander", "alarm time is coming!"));
-#if 1
-                    for(auto observer:m_ackObservers){
-                        observer->onAlarmAckStatusChanged(dmInterface::AlarmAckObserverInterface::Status::PLAYING, currentContent);
-                    }
-#else         
-                          char contentId[37];
-                          CreateRandomUuid(contentId);
-                          auto writer = m_ttsDocker->createWriter(contentId);
-                          auto reader = m_ttsDocker->createReader(contentId, utils::sharedbuffer::ReaderPolicy::BLOCKING);
-                          AISDK_DEBUG(LX("deleteAlarmContent").d("currentContent", currentContent));
-                          m_asrEngine->acquireTextToSpeech(currentContent, std::move(writer));
-                          
-                          utils::AudioFormat format {
-                                  .encoding = aisdk::utils::AudioFormat::Encoding::LPCM,
-                                  .endianness = aisdk::utils::AudioFormat::Endianness::LITTLE,
-                                  .sampleRateHz = 16000,
-                                  .sampleSizeInBits = 16,
-                                  .numChannels = 1,
-                                  .dataSigned = true };
-                          
-                          auto sourceId = m_alarmPlayer->setSource(std::move(reader), &format);
-                          m_alarmPlayer->play(sourceId);
-#endif                          
-                     }
-                 }
-
-           }       
-        }
+void AlarmsPlayer::init() {
+    m_alarmPlayer->setObserver(shared_from_this());
+    // Observers are only touched on the executor, so ring from there rather than on the scheduler thread.
+    m_scheduler = AlarmScheduler::create(AlarmStore::create(alarmDB), [this](const Alarm& alarm) {
+        auto content = alarm.content;
+        m_executor.submit([this, content]() { executeAlarmRinging(content); });
+    });
+    if(!m_scheduler) {
+        AISDK_ERROR(LX("initFailed").d("reason", "createAlarmSchedulerFailed"));
     }
-
 }
 
-
-void AlarmsPlayer::sqliteThreadHander() {
-    sqlite3 *db=NULL;
-    int len;
-    while(1){
-        len = sqlite3_open(alarmDB, &db);
-        if( len ) {
-        fprintf(stderr, "Can't open database: %s\n", sqlite3_errmsg(db));
-        sqlite3_close(db);
-        exit(1);
-        }
-
-        CheckAlarmList(db);
-        CheckRepeatAlarmList(db);
-        sqlite3_close(db);
-        std::this_thread::sleep_for( std::chrono::seconds(5));
+/**
+ * Reads a timestamp or weekday, which the NLP service sends as a string or a number.
+ */
+static int64_t toInt64(const Json::Value& value) {
+    if(value.isString()) {
+        return atoll(value.asCString());
     }
+    return value.isNumeric() ? value.asLargestInt() : 0;
 }
 
-void AlarmsPlayer::init() {
-    m_alarmPlayer->setObserver(shared_from_this());  
-    m_sqliteThread = std::thread(&AlarmsPlayer::sqliteThreadHander, this);
+/**
+ * Builds what is said when a repeating alarm rings.
+ *
+ * @param timestampDay The time of day of the alarm in milliseconds, Beijing time.
+ * @param event The event the user named, which may be empty.
+ */
+static std::string makeRepeatContent(int64_t timestampDay, const std::string& event) {
+    char content[1024];
+    time_t timesec = (time_t)((timestampDay/1000) - 28800);
+    struct tm p;
+    localtime_r(&timesec, &p);
+    if(!event.empty()) {
+        snprintf(content, sizeof content, "重复闹钟：现在是北京时间%d点%d分，您有一个提醒%s时间到了", p.tm_hour, p.tm_min, event.c_str());
+    } else {
+        snprintf(content, sizeof content, "重复闹钟：现在是北京时间%d点%d分，您有一个提醒时间到了", p.tm_hour, p.tm_min);
+    }
+    return content;
 }
 
-void AnalysisNlpDataForAlarmsPlayer(cJSON          * datain , std::deque<std::string> &ttsurllist );
-
-void AnalysisNlpDataForAlarmsPlayer(cJSON          * datain , std::deque<std::string> &ttsurllist )
-{
+/**
+ * Builds what is said when a one-time alarm rings.
+ *
+ * @param timestamp The time of the alarm in milliseconds since the epoch.
+ * @param event The event the user named, which may be empty.
+ */
+static std::string makeOnceContent(int64_t timestamp, const std::string& event) {
+    char content[1024];
+    time_t timesec = (time_t)(timestamp/1000);
+    struct tm p;
+    localtime_r(&timesec, &p);
+    if(!event.empty()) {
+        snprintf(content, sizeof content, "现在是北京时间%d年%d月%d日%d点%d分，您有一个提醒%s时间到了",
+            1900+p.tm_year, 1+p.tm_mon, p.tm_mday, p.tm_hour, p.tm_min, event.c_str());
+    } else {
+        snprintf(content, sizeof content, "现在是北京时间%d年%d月%d日%d点%d分，您有一个提醒时间到了",
+            1900+p.tm_year, 1+p.tm_mon, p.tm_mday, p.tm_hour, p.tm_min);
+    }
+    return content;
+}
 
-     const char *ALARM_SET_OPERATION = "SET";
-     const char *ALARM_DELETE_OPERATION = "DELETE";
-     const char *ALARM_FLUSH_OPERATION = "FLUSH";
-     const char *ALARM_UPDATE_OPERATION = "UPDATE";
-
-     sqlite3 *db=NULL;
-     int len;
-     char *zErrMsg =NULL;
-     char alarmSql[1024];
-     char deleteSql[1024];
-     long long int timestamp = 0;
-     long long int repeat_timestamp_day = 0;
-     int repeat_weekday = 0;
-     char evt_type[64];
-     int action_type = 0;
-     int loop_mask = 0;
-     char content[1024];
-     
-    cJSON* json = NULL,
-    *json_data = NULL, *json_answer = NULL,
-    *json_parameters = NULL, *json_event = NULL, *json_operation = NULL, *json_timestamp = NULL,
-    *json_repeat = NULL, *json_repeat_type = NULL, *json_repeat_timestamp_day = NULL ,*json_repeat_weekday = NULL;
-     
-     (void )json;
-     (void )json_data;
-     (void )json_answer;
-     (void )json_parameters;
-     (void )json_event;
-     (void )json_operation;
-     (void )json_timestamp;   
-
-     (void )json_repeat;
-     (void )json_repeat_type;
-     (void )json_repeat_timestamp_day;
-     (void )json_repeat_weekday;
-
-
-      json_data = datain;  
-      if(!json_data)
-      {
-      AISDK_ERROR(LX("json_data").d("json Error before:", cJSON_GetErrorPtr()));
-      }
-      else
-      {
-         json_answer = cJSON_GetObjectItem(json_data, "answer");
-         AISDK_DEBUG5(LX("json_data").d("json_answer", json_answer->valuestring));
-      
-         //parameters  
-         json_parameters = cJSON_GetObjectItem(json_data, "parameters"); 
-         if(json_parameters != NULL) 
-         { 
-          json_operation = cJSON_GetObjectItem(json_parameters, "operation");
-          AISDK_DEBUG5(LX("json_parameters").d("json_operation", json_operation->valuestring));
-
-
-          json_repeat = cJSON_GetObjectItem(json_parameters, "repeat");
-          if(json_repeat != NULL)
-          //repeat alarm
-          {
-            int array_size = cJSON_GetArraySize(json_repeat);
-            AISDK_DEBUG5(LX("AnalysisNlpDataForAlarmsPlayer").d("repeat_alarm_list_size", array_size));
-            int i = 0;
-            cJSON *item,*it;
-            char *p  = NULL;
-            for(i=0; i< array_size; i++) {
-              item = cJSON_GetArrayItem(json_repeat, i);
-              if(!item) {
-                 //TODO...
-              }
-              p = cJSON_PrintUnformatted(item);
-              it = cJSON_Parse(p);
-              if(!it)
-                 continue ;
-            json_repeat_timestamp_day = cJSON_GetObjectItem(it, "timestamp_day");
-            json_repeat_type = cJSON_GetObjectItem(it, "type");
-            json_repeat_weekday = cJSON_GetObjectItem(it, "weekday");
-            AISDK_DEBUG5(LX("json_parameters").d("No:", i).d("json_repeat_timestamp_day", json_repeat_timestamp_day->valuestring));
-            AISDK_DEBUG5(LX("json_parameters").d("No:", i).d("json_repeat_type", json_repeat_type->valuestring));
-            REPEAT_ALARM_LIST.push_back(json_repeat_timestamp_day->valuestring);
-            }
+void AlarmsPlayer::AnalysisNlpDataForAlarmsPlayer(const Json::Value &data) {
+    static const std::string ALARM_SET_OPERATION = "SET";
+    static const std::string ALARM_DELETE_OPERATION = "DELETE";
+    static const std::string ALARM_FLUSH_OPERATION = "FLUSH";
+    static const std::string ALARM_UPDATE_OPERATION = "UPDATE";
 
-          }
-          else
-          //one time alarm
-          {
-          if(strcmp(json_operation->valuestring, ALARM_FLUSH_OPERATION) != 0)
-            {
-            json_timestamp = cJSON_GetObjectItem(json_parameters, "timestamp");
-            AISDK_DEBUG5(LX("json_parameters").d("json_timestamp", json_timestamp->valuestring));
-            }  
-          }
-
-           /* 打开数据库 */
-            len = sqlite3_open(alarmDB, &db);
-            if( len )
-            {
-                fprintf(stderr, "Can't open database: %s\n", sqlite3_errmsg(db));
-                sqlite3_close(db);
-                exit(1);
-            }
-            else 
-                AISDK_DEBUG(LX("You have opened a sqlite3 database named alarm.db successfully!"));
-            
-          /* 创建表 */
-          char const *alarmList = " CREATE TABLE alarm(timestamp, evt_type, action_type, loop_mask, content); " ;
-          sqlite3_exec(db,alarmList,NULL,NULL,&zErrMsg);
-          sqlite3_free(zErrMsg);
-          char const *alarmList_repeat = " CREATE TABLE alarmList_repeat(timestamp_day, evt_type, weekday, loop_mask, content); " ;   
-          sqlite3_exec(db,alarmList_repeat,NULL,NULL,&zErrMsg);
-          sqlite3_free(zErrMsg);
-
-                   
-          AISDK_DEBUG5(LX("json_parameters").d("json_operation", json_operation->valuestring));
-        ////operation type:SET 
-          if( strcmp(json_operation->valuestring, ALARM_SET_OPERATION) == 0)
-          {
-          AISDK_INFO(LX("AnalysisNlpDataForAlarmsPlayer").d("OPERATION:","SET")); 
-          
-          if(json_repeat != NULL)
-          //repeat alarm
-          {
-          std::string repeat_type = json_repeat_type->valuestring;
-           if(repeat_type == "WEEKLY" ){
-              repeat_weekday = json_repeat_weekday->valueint;
-           }else{
-              repeat_weekday = 0;
-           }
-          
-          json_event = cJSON_GetObjectItem(json_parameters, "event");  
-          AISDK_DEBUG5(LX("json_parameters").d("json_event", json_event->valuestring));
-          sprintf(evt_type,"%s", json_event->valuestring);
-          
-          repeat_timestamp_day = atoll(json_repeat_timestamp_day->valuestring);      
-          AISDK_DEBUG5(LX("repeat_timestamp_day").d("value:", repeat_timestamp_day));
-
-          long int timesec = (long int)((repeat_timestamp_day/1000) - 28800);
-          //printf("%ld \n", timesec);
-          AISDK_DEBUG5(LX("repeat_timestamp_day").d("timesec", timesec));
-          struct tm *p;
-          p = localtime(&timesec);
-
-          if(json_event != NULL){ 
-              sprintf(content, "重复闹钟：现在是北京时间%d点%d分，您有一个提醒%s时间到了",   p->tm_hour, p->tm_min, evt_type);
-          }
-          else
-          {
-              sprintf(content, "重复闹钟：现在是北京时间%d点%d分，您有一个提醒时间到了",   p->tm_hour, p->tm_min);
-          }
-          
-          loop_mask = 1;
-          
-          sprintf(alarmSql, "INSERT INTO 'alarmList_repeat'VALUES(%lld, '%s', %d, %d, '%s');" ,repeat_timestamp_day ,evt_type ,repeat_weekday ,loop_mask ,content);
-          sqlite3_exec(db, alarmSql, NULL, NULL, &zErrMsg);  
-
-          
-          }
-          else
-          //one time alarm
-          {  
-          json_event = cJSON_GetObjectItem(json_parameters, "event");  
-          AISDK_DEBUG5(LX("json_parameters").d("json_event", json_event->valuestring));
-          sprintf(evt_type,"%s", json_event->valuestring);
-          
-          timestamp = atoll(json_timestamp->valuestring);    //把字符串转换成长长整型数（64位）long long atoll(const char *nptr);
-          AISDK_DEBUG5(LX("timestamp").d("value:", timestamp));
-          
-          long int timesec = (long int)(timestamp/1000);   //long long int --> long int;
-          //printf("%ld \n", timesec);
-          AISDK_DEBUG5(LX("repeat_timestamp_day").d("timesec", timesec));
-         
-
-#if 1
-          struct tm *p ;
-          p = localtime(&timesec);
-
-          //AISDK_INFO(LX("SET ALARM").d("set alarm time:", asctime(p)));
-          if(json_event != NULL){
-              sprintf(content, "现在是北京时间%d年%d月%d日%d点%d分，您有一个提醒%s时间到了",
-                1900+p->tm_year,
-                1+p->tm_mon,
-                p->tm_mday, 
-                p->tm_hour, 
-                p->tm_min,
-                evt_type);
-          }
-          else{
-              sprintf(content, "现在是北京时间%d年%d月%d日%d点%d分，您有一个提醒时间到了",
-                1900+p->tm_year,
-                1+p->tm_mon,
-                p->tm_mday, 
-                p->tm_hour, 
-                p->tm_min);
-          }
-#else
-            if(json_event != NULL){
-                sprintf(content, "小康提醒您，您有一个提醒%s时间到了",evt_type);
-            }
-            else{
-                sprintf(content, "小康提醒您，您有一个提醒时间到了");
-            }
+    if(!data.isObject()) {
+        AISDK_ERROR(LX("AnalysisNlpDataForAlarmsPlayer").d("reason", "parseDataKeyError"));
+        return;
+    }
+    AISDK_DEBUG5(LX("json_data").d("json_answer", data["answer"].asString()));
 
+    //parameters
+    auto& parameters = data["parameters"];
+    if(!parameters.isObject()) {
+        AISDK_INFO(LX("parameters is null "));
+        return;
+    }
+    if(!m_scheduler) {
+        AISDK_ERROR(LX("AnalysisNlpDataForAlarmsPlayer").d("reason", "noAlarmScheduler"));
+        return;
+    }
 
-#endif          
-          //AISDK_INFO(LX("Set Alarm Time:").d("content:", content));
-          action_type = 1;
-          loop_mask = 0;
-          sprintf(alarmSql, "INSERT INTO 'alarm'VALUES(%lld, '%s', %d, %d, '%s');" ,timestamp ,evt_type ,action_type ,loop_mask ,content);
-          sqlite3_exec(db, alarmSql, NULL, NULL, &zErrMsg);  
-          }
-
-          
-          }
-          
-          //operation type:DELETE 
-          if(strcmp(json_operation->valuestring, ALARM_DELETE_OPERATION) == 0)
-          {
-             AISDK_INFO(LX("AnalysisNlpDataForAlarmsPlayer").d("OPERATION:","DELETE"));
-             if(json_repeat != NULL)
-            //repeat alarm
-            {
-            repeat_timestamp_day = atoll(json_repeat_timestamp_day->valuestring);      
-            AISDK_DEBUG5(LX("repeat_timestamp_day").d("value:", repeat_timestamp_day));
-            sprintf(deleteSql, "delete from alarmList_repeat where timestamp_day = %lld;" ,repeat_timestamp_day);
-            sqlite3_exec(db, deleteSql, NULL, NULL, &zErrMsg);
-            sqlite3_free(zErrMsg); 
+    auto operation = parameters["operation"].asString();
+    auto event = parameters["event"].isString() ? parameters["event"].asString() : "";
+    auto& repeat = parameters["repeat"];
+    AISDK_INFO(LX("AnalysisNlpDataForAlarmsPlayer").d("OPERATION:", operation).d("repeat", !repeat.isNull()));
+
+    if(operation == ALARM_SET_OPERATION) {
+        if(repeat.isArray()) {
+            //repeat alarm, one per item: a weekly alarm comes with an item for each of its weekdays.
+            for(auto& item : repeat) {
+                Alarm alarm;
+                alarm.type = Alarm::Type::REPEAT;
+                alarm.timestamp = toInt64(item["timestamp_day"]);
+                alarm.weekday = item["type"].asString() == "WEEKLY" ? (int)toInt64(item["weekday"]) : 0;
+                alarm.eventType = event;
+                alarm.content = makeRepeatContent(alarm.timestamp, event);
+                m_scheduler->setAlarm(alarm);
             }
-            else
+        } else {
             //one time alarm
-            {
-             timestamp = atoll(json_timestamp->valuestring);    //把字符串转换成长长整型数（64位）long long atoll(const char *nptr);
-             AISDK_DEBUG5(LX("timestamp").d("value:", timestamp));   
-             sprintf(deleteSql, "delete from alarm where timestamp = %lld;" ,timestamp);
-             sqlite3_exec(db, deleteSql, NULL, NULL, &zErrMsg);
-             printf("zErrMsg = %s \n", zErrMsg);
-             sqlite3_free(zErrMsg); 
+            Alarm alarm;
+            alarm.type = Alarm::Type::ONCE;
+            alarm.timestamp = toInt64(parameters["timestamp"]);
+            alarm.weekday = 0;
+            alarm.eventType = event;
+            alarm.content = makeOnceContent(alarm.timestamp, event);
+            m_scheduler->setAlarm(alarm);
+        }
+    } else if(operation == ALARM_DELETE_OPERATION) {
+        if(repeat.isArray()) {
+            for(auto& item : repeat) {
+                m_scheduler->deleteAlarms(Alarm::Type::REPEAT, toInt64(item["timestamp_day"]));
             }
-             
-          }
-          
-          //operation type:FLUSH 
-          if(strcmp(json_operation->valuestring, ALARM_FLUSH_OPERATION) == 0)
-          {
-             AISDK_INFO(LX("AnalysisNlpDataForAlarmsPlayer").d("OPERATION:","FLUSH"));   
-             char const *flushSql = "drop table alarm;";
-             sqlite3_exec(db, flushSql, NULL, NULL, &zErrMsg);
-             printf("zErrMsg = %s \n", zErrMsg);
-             sqlite3_free(zErrMsg); 
-             char const *flushSqlRep = "drop table alarmList_repeat;";
-             sqlite3_exec(db, flushSqlRep, NULL, NULL, &zErrMsg);
-             printf("zErrMsg = %s \n", zErrMsg);
-             sqlite3_free(zErrMsg); 
-          
-             /* 创建表 */
-             char const *rebulidalarmList = " CREATE TABLE alarm(timestamp, evt_type, action_type, loop_mask, content ); " ;
-             sqlite3_exec(db,rebulidalarmList,NULL,NULL,&zErrMsg);
-             sqlite3_free(zErrMsg);      
-             char const *rebulidalarmList_repeat = " CREATE TABLE alarmList_repeat(timestamp_day, evt_type, weekday, loop_mask, content ); " ;
-             sqlite3_exec(db,rebulidalarmList_repeat,NULL,NULL,&zErrMsg);
-             sqlite3_free(zErrMsg);                 
-           }
-          
-          //operation type:UPDATE 
-          if(strcmp(json_operation->valuestring, ALARM_UPDATE_OPERATION) == 0)
-          {
-             AISDK_INFO(LX("AnalysisNlpDataForAlarmsPlayer").d("OPERATION:","UPDATE"));   
-             //add operation
-             //...
-          }
-          
-          sqlite3_close(db);
-         }
-          else
-          {
-              AISDK_INFO(LX("parameters is null "));
-          }
-
-      }
-      
+        } else {
+            m_scheduler->deleteAlarms(Alarm::Type::ONCE, toInt64(parameters["timestamp"]));
+        }
+    } else if(operation == ALARM_FLUSH_OPERATION) {
+        m_scheduler->clear();
+    } else if(operation == ALARM_UPDATE_OPERATION) {
+        //add operation
+        //...
+    }
 }
 
 
 void AlarmsPlayer::executePreHandleAfterValidation(std::shared_ptr<AlarmDirectiveInfo> info) {
 	/// To-Do parse tts url and insert chatInfo map
 #ifdef ENABLE_SOUNDAI_ASR
-     auto nlpDomain = info->directive;
-     auto dateMessage = nlpDomain->getData();
-     AISDK_INFO(LX("executePreHandleAfterValidation").d("dateMessage", dateMessage.c_str()));
-
-     cJSON* json = NULL, *json_data = NULL;
-     (void )json;
-     (void )json_data;
-     json_data = cJSON_Parse(dateMessage.c_str());
-     AnalysisNlpDataForAlarmsPlayer(json_data, TTS_URL_LIST);
-     info->url = TTS_URL_LIST.at(0);
+     AISDK_INFO(LX("executePreHandleAfterValidation").d("messageId", info->directive->getMessageId()));
+     AnalysisNlpDataForAlarmsPlayer(info->directive->getDataValue());
+     if(!TTS_URL_LIST.empty()) {
+         info->url = TTS_URL_LIST.at(0);
+     }
      
      AISDK_INFO(LX("alarmplayer").d("当前播放内容:", info->url ));
 #else
-        auto nlpDomain = info->directive;
-        auto dateMessage = nlpDomain->getData();
-        AISDK_INFO(LX("executePreHandleAfterValidation").d("dateMessage", dateMessage.c_str()));
-
-        cJSON* json = NULL, *json_data = NULL;
-        (void )json;
-        (void )json_data;
-        json_data = cJSON_Parse(dateMessage.c_str());
-        AnalysisNlpDataForAlarmsPlayer(json_data, TTS_URL_LIST);
-        cJSON_Delete(json_data);  
+        AISDK_INFO(LX("executePreHandleAfterValidation").d("messageId", info->directive->getMessageId()));
+        AnalysisNlpDataForAlarmsPlayer(info->directive->getDataValue());
 #endif
 }
 
@@ -0,0 +1,231 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "AlarmsPlayer/AlarmScheduler.h"
+
+namespace aisdk {
+namespace domain {
+namespace alarmsPlayer {
+namespace test {
+
+using std::chrono::milliseconds;
+using std::chrono::system_clock;
+
+/// How long a test waits for an alarm which should ring.
+static const milliseconds RING_TIMEOUT{3000};
+
+/// How long a test waits to be sure an alarm doesn't ring.
+static const milliseconds NO_RING_WAIT{400};
+
+/// How far out a test sets an alarm it acts on before it rings, well past the time a sqlite commit may take.
+static const milliseconds ALARM_DELAY{1000};
+
+/**
+ * Builds a one-time alarm.
+ */
+static Alarm onceAlarm(system_clock::time_point time, const std::string& content) {
+    auto timestamp = std::chrono::duration_cast<milliseconds>(time.time_since_epoch()).count();
+    return Alarm{Alarm::Type::ONCE, timestamp, 0, "", content};
+}
+
+/**
+ * Builds a point in local time.
+ */
+static system_clock::time_point localTime(int year, int month, int day, int hour, int minute) {
+    struct tm time = {};
+    time.tm_year = year - 1900;
+    time.tm_mon = month - 1;
+    time.tm_mday = day;
+    time.tm_hour = hour;
+    time.tm_min = minute;
+    time.tm_isdst = -1;
+    return system_clock::from_time_t(mktime(&time));
+}
+
+class AlarmSchedulerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/AlarmSchedulerTestXXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_NE(-1, fd);
+        close(fd);
+        m_path = path;
+    }
+
+    void TearDown() override {
+        std::remove(m_path.c_str());
+    }
+
+    /// Creates a scheduler on the test database which records the alarms it rings.
+    std::unique_ptr<AlarmScheduler> createScheduler() {
+        return AlarmScheduler::create(AlarmStore::create(m_path), [this](const Alarm& alarm) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_rung.push_back(alarm.content);
+            m_rungTrigger.notify_all();
+        });
+    }
+
+    /// Waits until @c count alarms have rung, or @c timeout has passed.
+    bool waitForRings(size_t count, milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_rungTrigger.wait_for(lock, timeout, [this, count]() { return m_rung.size() >= count; });
+    }
+
+    /// Reads the alarms in the test database.
+    std::vector<Alarm> loadAlarms() {
+        std::vector<Alarm> alarms;
+        auto store = AlarmStore::create(m_path);
+        EXPECT_NE(nullptr, store);
+        if (store) {
+            EXPECT_TRUE(store->load(&alarms));
+        }
+        return alarms;
+    }
+
+    std::string m_path;
+    std::mutex m_mutex;
+    std::condition_variable m_rungTrigger;
+    std::vector<std::string> m_rung;
+};
+
+/**
+ * Verify that the store keeps alarms across connections, and replaces or clears them.
+ */
+TEST_F(AlarmSchedulerTest, test_storeKeepsAlarms) {
+    {
+        auto store = AlarmStore::create(m_path);
+        ASSERT_NE(nullptr, store);
+        ASSERT_TRUE(store->replace(Alarm::Type::ONCE, 1000, {Alarm{Alarm::Type::ONCE, 1000, 0, "", "once"}}));
+        ASSERT_TRUE(store->replace(
+            Alarm::Type::REPEAT,
+            25200000,
+            {Alarm{Alarm::Type::REPEAT, 25200000, 1, "run", "monday"},
+             Alarm{Alarm::Type::REPEAT, 25200000, 3, "run", "wednesday"}}));
+    }
+    auto alarms = loadAlarms();
+    ASSERT_EQ(3u, alarms.size());
+    EXPECT_EQ(Alarm::Type::ONCE, alarms[0].type);
+    EXPECT_EQ(1000, alarms[0].timestamp);
+    EXPECT_EQ("once", alarms[0].content);
+    EXPECT_EQ(Alarm::Type::REPEAT, alarms[1].type);
+    EXPECT_EQ(1, alarms[1].weekday);
+    EXPECT_EQ("run", alarms[1].eventType);
+
+    auto store = AlarmStore::create(m_path);
+    ASSERT_NE(nullptr, store);
+    ASSERT_TRUE(store->replace(Alarm::Type::REPEAT, 25200000, {}));
+    std::vector<Alarm> remaining;
+    ASSERT_TRUE(store->load(&remaining));
+    EXPECT_EQ(1u, remaining.size());
+    ASSERT_TRUE(store->clear());
+    remaining.clear();
+    ASSERT_TRUE(store->load(&remaining));
+    EXPECT_TRUE(remaining.empty());
+}
+
+/**
+ * Verify that a one-time alarm rings at its time, not a polling period later, and is removed once it has.
+ */
+TEST_F(AlarmSchedulerTest, test_ringsOnTimeAndForgetsOnceAlarm) {
+    auto scheduler = createScheduler();
+    ASSERT_NE(nullptr, scheduler);
+    // Alarms are kept to the millisecond.
+    auto due = std::chrono::time_point_cast<milliseconds>(system_clock::now() + ALARM_DELAY);
+    ASSERT_TRUE(scheduler->setAlarm(onceAlarm(due, "soon")));
+    EXPECT_EQ(1u, loadAlarms().size());
+
+    ASSERT_TRUE(waitForRings(1, RING_TIMEOUT));
+    EXPECT_GE(system_clock::now(), due);
+    EXPECT_LT(system_clock::now(), due + milliseconds(500));
+    EXPECT_EQ("soon", m_rung[0]);
+    scheduler->shutdown();
+    EXPECT_TRUE(loadAlarms().empty());
+}
+
+/**
+ * Verify that alarms in the database when the scheduler starts ring, the earliest first.
+ */
+TEST_F(AlarmSchedulerTest, test_ringsStoredAlarmsInOrder) {
+    auto now = system_clock::now();
+    {
+        auto store = AlarmStore::create(m_path);
+        ASSERT_NE(nullptr, store);
+        auto later = onceAlarm(now + milliseconds(200), "later");
+        auto sooner = onceAlarm(now + milliseconds(100), "sooner");
+        ASSERT_TRUE(store->replace(Alarm::Type::ONCE, later.timestamp, {later}));
+        ASSERT_TRUE(store->replace(Alarm::Type::ONCE, sooner.timestamp, {sooner}));
+    }
+    auto scheduler = createScheduler();
+    ASSERT_NE(nullptr, scheduler);
+    ASSERT_TRUE(waitForRings(2, RING_TIMEOUT));
+    EXPECT_EQ(std::vector<std::string>({"sooner", "later"}), m_rung);
+}
+
+/**
+ * Verify that a deleted alarm doesn't ring, and an alarm missed by more than the grace is dropped without ringing.
+ */
+TEST_F(AlarmSchedulerTest, test_deletedAndMissedAlarmsDoNotRing) {
+    auto scheduler = createScheduler();
+    ASSERT_NE(nullptr, scheduler);
+    auto deleted = onceAlarm(system_clock::now() + ALARM_DELAY, "deleted");
+    ASSERT_TRUE(scheduler->setAlarm(deleted));
+    ASSERT_TRUE(scheduler->deleteAlarms(Alarm::Type::ONCE, deleted.timestamp));
+    ASSERT_TRUE(scheduler->setAlarm(onceAlarm(system_clock::now() - std::chrono::minutes(1), "missed")));
+
+    // Wait until past the time the deleted alarm would have rung.
+    auto wait = std::chrono::duration_cast<milliseconds>(
+        system_clock::time_point(milliseconds(deleted.timestamp)) + NO_RING_WAIT - system_clock::now());
+    EXPECT_FALSE(waitForRings(1, wait));
+    scheduler->shutdown();
+    EXPECT_TRUE(loadAlarms().empty());
+}
+
+/**
+ * Verify when repeating alarms ring next, daily and weekly.
+ */
+TEST_F(AlarmSchedulerTest, test_repeatingAlarmNextTime) {
+    // Wednesday 14 October 2026, 08:00 local time.
+    auto after = localTime(2026, 10, 14, 8, 0);
+    const int64_t SEVEN = 7 * 3600 * 1000;
+    const int64_t NINE = 9 * 3600 * 1000;
+    AlarmScheduler::TimePoint time;
+
+    ASSERT_TRUE(AlarmScheduler::getNextTime(Alarm{Alarm::Type::REPEAT, NINE, 0, "", ""}, after, &time));
+    EXPECT_EQ(localTime(2026, 10, 14, 9, 0), time);
+    ASSERT_TRUE(AlarmScheduler::getNextTime(Alarm{Alarm::Type::REPEAT, SEVEN, 0, "", ""}, after, &time));
+    EXPECT_EQ(localTime(2026, 10, 15, 7, 0), time);
+
+    // Friday, then Wednesday of next week as this one's time has passed.
+    ASSERT_TRUE(AlarmScheduler::getNextTime(Alarm{Alarm::Type::REPEAT, SEVEN, 5, "", ""}, after, &time));
+    EXPECT_EQ(localTime(2026, 10, 16, 7, 0), time);
+    ASSERT_TRUE(AlarmScheduler::getNextTime(Alarm{Alarm::Type::REPEAT, SEVEN, 3, "", ""}, after, &time));
+    EXPECT_EQ(localTime(2026, 10, 21, 7, 0), time);
+
+    EXPECT_FALSE(AlarmScheduler::getNextTime(Alarm{Alarm::Type::REPEAT, SEVEN, 9, "", ""}, after, &time));
+}
+
+}  // namespace test
+}  // namespace alarmsPlayer
+}  // namespace domain
+}  // namespace aisdk
@@ -0,0 +1,460 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef _RESOURCESPLAYER_HTTP_CLIENT_H_
+#define _RESOURCESPLAYER_HTTP_CLIENT_H_
+
+#include <sys/socket.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aisdk {
+namespace domain {
+namespace resourcesPlayer {
+
+/**
+ * The parts of an @c http:// URL a request needs.
+ */
+struct HttpUrl {
+    /**
+     * Splits a URL.
+     *
+     * @param url An @c http:// URL, with an optional port, path and query.
+     * @param[out] result The parts of @c url.
+     * @return @c false if @c url is not an @c http:// URL.
+     */
+    static bool parse(const std::string& url, HttpUrl* result);
+
+    /// The host name or address.
+    std::string host;
+
+    /// The port, 80 unless the URL names one.
+    int port;
+
+    /// The path and query, starting with '/'.
+    std::string target;
+};
+
+/**
+ * A response read by @c HttpResponseParser.
+ */
+struct HttpResponse {
+    /**
+     * Returns the value of a header.
+     *
+     * @param name The name of the header, in any case.
+     * @return The value, or an empty string if the header is missing.
+     */
+    std::string getHeader(const std::string& name) const;
+
+    /// The status code.
+    int status = 0;
+
+    /// The minor version of HTTP/1.x the server answered with.
+    int minorVersion = 0;
+
+    /// The headers, with names in lower case.  Repeated headers are joined with ", ".
+    std::map<std::string, std::string> headers;
+
+    /// The body, with any chunked transfer coding removed.
+    std::string body;
+};
+
+/**
+ * Reads an HTTP/1.x response incrementally, from whatever pieces the socket delivers it in.  Every byte is looked
+ * at once: header lines are gathered in a small buffer, and the body is appended to the response as it arrives, so
+ * parsing costs time linear in the size of the response however it is split.
+ *
+ * Bodies delimited by @c Content-Length, by the chunked transfer coding or by the server closing the connection are
+ * supported.  A body larger than the parser accepts fails the parse instead of growing without bound.
+ */
+class HttpResponseParser {
+public:
+    /// The largest body accepted by default; a track link and its JSON wrapping take a few KB.
+    static constexpr size_t DEFAULT_MAX_BODY_SIZE = 1024 * 1024;
+
+    /// Where the parser is.
+    enum class State {
+        /// More bytes are needed.
+        NEED_MORE,
+        /// The response is complete.
+        DONE,
+        /// The bytes are not a valid response.
+        ERROR
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param headRequest Whether the response answers a HEAD request, which has no body whatever its headers say.
+     * @param maxBodySize The largest body, in bytes, accepted before the parse fails.
+     */
+    explicit HttpResponseParser(bool headRequest = false, size_t maxBodySize = DEFAULT_MAX_BODY_SIZE);
+
+    /**
+     * Parses the next bytes of the response.  Parsing stops at the end of the response, so bytes after it are not
+     * consumed.
+     *
+     * @param data The bytes.
+     * @param size The number of bytes.
+     * @return The number of bytes consumed.
+     */
+    size_t feed(const char* data, size_t size);
+
+    /**
+     * Tells the parser the server closed the connection, which completes a body that runs to the end of the
+     * connection and fails any other unfinished response.
+     */
+    void finish();
+
+    /**
+     * @return Where the parser is.
+     */
+    State getState() const;
+
+    /**
+     * @return Whether the connection can carry another request once this response is complete.
+     */
+    bool isKeepAlive() const;
+
+    /**
+     * @return The response read so far.
+     */
+    const HttpResponse& getResponse() const;
+
+    /**
+     * @return The response, moved out of the parser.
+     */
+    HttpResponse takeResponse();
+
+private:
+    /// What is being read.
+    enum class Stage { STATUS_LINE, HEADERS, BODY, CHUNK_SIZE, CHUNK_DATA, CHUNK_DATA_END, TRAILERS, DONE, ERROR };
+
+    /**
+     * Collects a line into @c m_line.
+     *
+     * @param data The bytes.
+     * @param size The number of bytes.
+     * @param[out] consumed The number of bytes used.
+     * @return @c true once a whole line is in @c m_line, without its line ending.
+     */
+    bool readLine(const char* data, size_t size, size_t* consumed);
+
+    /// Acts on the line in @c m_line, according to the stage it was read in.
+    void processLine();
+
+    /// @return Whether the status line in @c m_line was parsed.
+    bool parseStatusLine();
+
+    /// @return Whether the header line in @c m_line was parsed.
+    bool parseHeaderLine();
+
+    /// Decides how the body is delimited once the headers are in.
+    void startBody();
+
+    /// Moves to @c Stage::ERROR.
+    void fail(const std::string& reason);
+
+    /// Whether the request was HEAD.
+    const bool m_headRequest;
+
+    /// The largest body accepted.
+    const size_t m_maxBodySize;
+
+    /// The response.
+    HttpResponse m_response;
+
+    /// What is being read.
+    Stage m_stage;
+
+    /// A line being collected.
+    std::string m_line;
+
+    /// Bytes of the body, or of the current chunk, still to come.
+    uint64_t m_remaining;
+
+    /// Whether the body runs until the connection is closed.
+    bool m_readUntilClose;
+
+    /// Whether the server asked for the connection to be closed.
+    bool m_connectionClose;
+};
+
+/**
+ * A resolved address of a host.
+ */
+struct HttpAddress {
+    /// The address.
+    sockaddr_storage address;
+
+    /// The length of @c address.
+    socklen_t length;
+};
+
+/**
+ * Remembers the addresses of hosts for a while, so repeated requests to a host don't each pay for a lookup.
+ */
+class DnsCache {
+public:
+    /// Looks up the addresses of a host and port; returns @c false if the lookup failed.
+    using Resolver = std::function<bool(const std::string& host, int port, std::vector<HttpAddress>* addresses)>;
+
+    /**
+     * Constructor.
+     *
+     * @param ttl How long a lookup is used for.
+     * @param resolver How to look hosts up, @c getaddrinfo() if empty.
+     */
+    explicit DnsCache(std::chrono::milliseconds ttl, Resolver resolver = Resolver());
+
+    /**
+     * Returns the addresses of a host, looking it up if it hasn't been looked up within the TTL.  Failed lookups
+     * are not remembered.
+     *
+     * @param host The host.
+     * @param port The port.
+     * @param[out] addresses The addresses.
+     * @return @c false if the host could not be resolved.
+     */
+    bool resolve(const std::string& host, int port, std::vector<HttpAddress>* addresses);
+
+    /**
+     * Forgets a host, after connecting to its addresses failed.
+     *
+     * @param host The host.
+     * @param port The port.
+     */
+    void invalidate(const std::string& host, int port);
+
+    /**
+     * Looks a host up with @c getaddrinfo().
+     */
+    static bool systemResolve(const std::string& host, int port, std::vector<HttpAddress>* addresses);
+
+private:
+    /// A remembered lookup.
+    struct Entry {
+        /// The addresses.
+        std::vector<HttpAddress> addresses;
+        /// When they stop being used.
+        std::chrono::steady_clock::time_point expiry;
+    };
+
+    /// How long a lookup is used for.
+    const std::chrono::milliseconds m_ttl;
+
+    /// How hosts are looked up.
+    Resolver m_resolver;
+
+    /// Serializes access to @c m_entries.
+    std::mutex m_mutex;
+
+    /// Lookups by "host:port".
+    std::unordered_map<std::string, Entry> m_entries;
+};
+
+/**
+ * A small HTTP/1.1 client which keeps connections alive between requests.  Connections a response leaves reusable
+ * are pooled per host and port, and host lookups are cached in a @c DnsCache, so a request to a host already talked
+ * to recently costs neither a lookup nor a TCP handshake.
+ *
+ * Requests may be made from several threads at once; each request uses a connection of its own.  A request given a
+ * cancellation flag gives up within @c CANCEL_POLL_INTERVAL of the flag being set, except while looking its host up.
+ */
+class HttpClient {
+public:
+    /// How long lookups are cached by default.
+    static constexpr std::chrono::seconds DEFAULT_DNS_TTL{60};
+
+    /// How long an idle connection is kept by default.  Servers commonly close idle connections after 60 s or more.
+    static constexpr std::chrono::seconds DEFAULT_IDLE_TIMEOUT{30};
+
+    /// How many idle connections are kept per host by default.
+    static constexpr size_t DEFAULT_MAX_IDLE_PER_HOST = 2;
+
+    /// How long a request may take by default, from connecting to the end of the response.
+    static constexpr std::chrono::seconds DEFAULT_REQUEST_TIMEOUT{10};
+
+    /// How often a request waiting on the network checks whether it was cancelled.
+    static constexpr std::chrono::milliseconds CANCEL_POLL_INTERVAL{20};
+
+    /**
+     * Creates a client.
+     *
+     * @param dnsTtl How long host lookups are cached.
+     * @param idleTimeout How long a connection may stay idle before it is closed rather than reused.
+     * @param maxIdlePerHost How many idle connections are kept per host.
+     * @param resolver How hosts are looked up, @c getaddrinfo() if empty.
+     * @return The client.
+     */
+    static std::shared_ptr<HttpClient> create(
+        std::chrono::milliseconds dnsTtl = DEFAULT_DNS_TTL,
+        std::chrono::milliseconds idleTimeout = DEFAULT_IDLE_TIMEOUT,
+        size_t maxIdlePerHost = DEFAULT_MAX_IDLE_PER_HOST,
+        DnsCache::Resolver resolver = DnsCache::Resolver());
+
+    /**
+     * Closes the idle connections.
+     */
+    ~HttpClient();
+
+    /**
+     * Makes a GET request.
+     *
+     * @param url The @c http:// URL.
+     * @param[out] response The response, of any status.
+     * @param timeout How long the request may take.
+     * @param cancelled Set from another thread to abandon the request, or @c nullptr.
+     * @return @c false if no complete response was read.
+     */
+    bool get(
+        const std::string& url,
+        HttpResponse* response,
+        std::chrono::milliseconds timeout = DEFAULT_REQUEST_TIMEOUT,
+        const std::atomic<bool>* cancelled = nullptr);
+
+    /**
+     * Makes a POST request.
+     *
+     * @param url The @c http:// URL.
+     * @param contentType The type of @c body.
+     * @param body The body of the request.
+     * @param[out] response The response, of any status.
+     * @param timeout How long the request may take.
+     * @param cancelled Set from another thread to abandon the request, or @c nullptr.
+     * @return @c false if no complete response was read.
+     */
+    bool post(
+        const std::string& url,
+        const std::string& contentType,
+        const std::string& body,
+        HttpResponse* response,
+        std::chrono::milliseconds timeout = DEFAULT_REQUEST_TIMEOUT,
+        const std::atomic<bool>* cancelled = nullptr);
+
+    /**
+     * Closes all idle connections.
+     */
+    void closeIdleConnections();
+
+    /**
+     * @return The number of idle connections held.
+     */
+    size_t getIdleConnectionCount();
+
+private:
+    /// A connection to a host.
+    struct Connection {
+        /// The socket.
+        int fd;
+        /// When it was last returned to the pool.
+        std::chrono::steady_clock::time_point idleSince;
+    };
+
+    /**
+     * Constructor.
+     */
+    HttpClient(
+        std::chrono::milliseconds dnsTtl,
+        std::chrono::milliseconds idleTimeout,
+        size_t maxIdlePerHost,
+        DnsCache::Resolver resolver);
+
+    /**
+     * Makes a request, on a pooled connection if one is idle, and again on a new connection if the pooled one turns
+     * out to have been closed by the server before anything of the response came back.
+     */
+    bool request(
+        const std::string& method,
+        const std::string& url,
+        const std::string& contentType,
+        const std::string& body,
+        HttpResponse* response,
+        std::chrono::milliseconds timeout,
+        const std::atomic<bool>* cancelled);
+
+    /**
+     * Sends a request on a connection and reads the response.
+     *
+     * @param fd The connection.
+     * @param message The request.
+     * @param deadline When to give up.
+     * @param cancelled Set to abandon the request, or @c nullptr.
+     * @param[out] parser The parser the response is read with.
+     * @param[out] receivedAny Whether any of the response arrived.
+     * @param[out] reusable Whether the connection can carry another request.
+     * @return @c false if no complete response was read.
+     */
+    bool exchange(
+        int fd,
+        const std::string& message,
+        std::chrono::steady_clock::time_point deadline,
+        const std::atomic<bool>* cancelled,
+        HttpResponseParser* parser,
+        bool* receivedAny,
+        bool* reusable);
+
+    /**
+     * Takes an idle connection to a host from the pool, closing any which timed out or were closed by the server.
+     *
+     * @return The socket, or -1 if none is idle.
+     */
+    int takeIdleConnection(const std::string& key);
+
+    /**
+     * Returns a connection to the pool, or closes it if the pool for its host is full.
+     */
+    void releaseConnection(const std::string& key, int fd);
+
+    /**
+     * Connects to a host.
+     *
+     * @return The socket, or -1 if no address of the host could be connected to before @c deadline, or the request
+     * was cancelled.
+     */
+    int connectTo(
+        const HttpUrl& url,
+        std::chrono::steady_clock::time_point deadline,
+        const std::atomic<bool>* cancelled);
+
+    /// How long a connection may stay idle.
+    const std::chrono::milliseconds m_idleTimeout;
+
+    /// How many idle connections are kept per host.
+    const size_t m_maxIdlePerHost;
+
+    /// Host lookups.
+    DnsCache m_dnsCache;
+
+    /// Serializes access to @c m_idle.
+    std::mutex m_mutex;
+
+    /// Idle connections by "host:port", most recently used last.
+    std::unordered_map<std::string, std::vector<Connection>> m_idle;
+};
+
+}  // namespace resourcesPlayer
+}  // namespace domain
+}  // namespace aisdk
+
+#endif  // _RESOURCESPLAYER_HTTP_CLIENT_H_
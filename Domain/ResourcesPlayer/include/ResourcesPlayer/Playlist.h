@@ -0,0 +1,203 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef _RESOURCESPLAYER_PLAYLIST_H_
+#define _RESOURCESPLAYER_PLAYLIST_H_
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace aisdk {
+namespace domain {
+namespace resourcesPlayer {
+
+/**
+ * The items of a resources directive, the one playing and the loop modes, which together decide what plays next.
+ * It is only bookkeeping: nothing is looked up or played here.  All methods may be called from any thread.
+ *
+ * Once the end is passed without list loop there is no current item until the playlist is skipped through or reset.
+ */
+class Playlist {
+public:
+    /// An item of the playlist.
+    struct Item {
+        /// The URL to play, empty for a KuGou item.
+        std::string url;
+        /// The KuGou item id, empty for an item with a URL.
+        std::string itemId;
+        /// The KuGou album id, which may be empty.
+        std::string albumId;
+    };
+
+    /**
+     * Constructor, for an empty playlist.
+     */
+    Playlist();
+
+    /**
+     * Replaces the items, makes the first one current and turns both loop modes off.
+     *
+     * @param items The new items.
+     * @param isKuGou Whether the items are KuGou items, whose URLs must be looked up.
+     */
+    void reset(const std::vector<Item>& items, bool isKuGou);
+
+    /**
+     * Removes all items and turns both loop modes off.
+     */
+    void clear();
+
+    /**
+     * @return The number of items.
+     */
+    size_t size() const;
+
+    /**
+     * @return Whether there are no items.
+     */
+    bool empty() const;
+
+    /**
+     * @return Whether the items are KuGou items.
+     */
+    bool isKuGou() const;
+
+    /**
+     * Turns single loop, repeating the current item when it ends, on or off.
+     */
+    void setSingleLoop(bool enabled);
+
+    /**
+     * @return Whether single loop is on.
+     */
+    bool isSingleLoop() const;
+
+    /**
+     * Turns list loop, going back to the first item after the last one ends, on or off.
+     */
+    void setListLoop(bool enabled);
+
+    /**
+     * @return Whether list loop is on.
+     */
+    bool isListLoop() const;
+
+    /**
+     * @return The index of the current item, or @c size() once the end has been passed.
+     */
+    size_t getCurrentIndex() const;
+
+    /**
+     * Makes an item current.
+     *
+     * @param index The index of the item.
+     * @return Whether there is such an item.
+     */
+    bool setCurrentIndex(size_t index);
+
+    /**
+     * Reads an item.
+     *
+     * @param index The index of the item.
+     * @param[out] item The item.
+     * @return Whether there is such an item.
+     */
+    bool getItem(size_t index, Item* item) const;
+
+    /**
+     * Reads the current item.
+     *
+     * @param[out] item The item.
+     * @return Whether there is a current item.
+     */
+    bool getCurrentItem(Item* item) const;
+
+    /**
+     * Moves to the next item, from the last one to the first, as asked by the user.
+     */
+    void skipForward();
+
+    /**
+     * Moves to the previous item, from the first one to the last, as asked by the user.
+     */
+    void skipBack();
+
+    /**
+     * Moves on once the current item has played to its end, as the loop modes say.
+     *
+     * @return Whether there is an item to play next; if not, the end has been passed.
+     */
+    bool advance();
+
+    /**
+     * Tells which item @c advance() would move to, without moving.
+     *
+     * @param[out] index The index of that item.
+     * @return Whether there is one.
+     */
+    bool getFollowingIndex(size_t* index) const;
+
+    /**
+     * Moves past a current item which can't be played.  Unlike @c advance(), single loop doesn't keep it current.
+     *
+     * @return Whether there is an item to try next; if not, the end has been passed.
+     */
+    bool skipUnplayable();
+
+    /**
+     * Lists the items which are reached by playing on from an item, for looking them up ahead of time.  Nothing is
+     * listed in single loop.
+     *
+     * @param from The index of the item playing.
+     * @param count How many items to list at most.
+     * @return The indices of the items, in the order they will be played.
+     */
+    std::vector<size_t> getUpcomingIndices(size_t from, size_t count) const;
+
+private:
+    /**
+     * Finds the item played after one.  @c m_mutex must be held.
+     *
+     * @param from The index of the item.
+     * @param repeat Whether single loop repeats the item.
+     * @param[out] index The index of the following item.
+     * @return Whether there is one.
+     */
+    bool getFollowingIndexLocked(size_t from, bool repeat, size_t* index) const;
+
+    /// Serializes access to the members below.
+    mutable std::mutex m_mutex;
+
+    /// The items.
+    std::vector<Item> m_items;
+
+    /// Whether the items are KuGou items.
+    bool m_isKuGou;
+
+    /// Whether single loop is on.
+    bool m_isSingleLoop;
+
+    /// Whether list loop is on.
+    bool m_isListLoop;
+
+    /// The index of the current item, @c m_items.size() once the end has been passed.
+    size_t m_current;
+};
+
+}  // namespace resourcesPlayer
+}  // namespace domain
+}  // namespace aisdk
+
+#endif  // _RESOURCESPLAYER_PLAYLIST_H_
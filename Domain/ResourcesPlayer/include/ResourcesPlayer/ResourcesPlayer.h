@@ -13,6 +13,9 @@
 #ifndef __RESOURCES_PLAYER_H_
 #define __RESOURCES_PLAYER_H_
 
+#include <atomic>
+#include <chrono>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -30,9 +33,10 @@
 #include <DMInterface/ResourcesPlayerObserverInterface.h>
 #include <DMInterface/AutomaticSpeechRecognizerUIDObserverInterface.h>
 #include <NLP/DomainProxy.h>
-#include <Utils/cJSON.h>
+#include <json/json.h>
 #include <Utils/DeviceInfo.h>
-#include "http.h"
+#include "Playlist.h"
+#include "TrackUrlResolver.h"
 
 namespace aisdk {
 namespace domain {
@@ -83,6 +87,8 @@ public:
 	/// @name ChannelObserverInterface method.
 	/// @{
 	void onTrackChanged(utils::channel::FocusState newTrace) override;
+	void onTrackChangedWithMixing(
+		utils::channel::FocusState newTrace, utils::channel::MixingBehavior behavior) override;
 	/// @}
 	
 	/// @name MediaPlayerObserverInterface method.
@@ -186,10 +192,10 @@ private:
 
 
     ///
-    void AnalysisNlpDataForResourcesPlayer(cJSON          * datain , std::deque<std::string> &audiourllist );
+    void AnalysisNlpDataForResourcesPlayer(const Json::Value &data, std::vector<Playlist::Item> &items );
 
     ///
-    void AnalysisAudioIdForResourcesPlayer(std::shared_ptr<DirectiveInfo> info , std::deque<std::string> &audioidlist );
+    void AnalysisAudioIdForResourcesPlayer(std::shared_ptr<DirectiveInfo> info , std::vector<Playlist::Item> &items );
     
     ///
     void AnalysisNlpDataForPlayControl(std::shared_ptr<DirectiveInfo> info, std::string &operation );
@@ -251,19 +257,27 @@ private:
     void executeStateChange();
 
 
-    ///
-    void executeTrackChanged(utils::channel::FocusState newTrace);
+    /**
+     * Handle (on the @c m_executor threadpool) a track change: play, resume, duck, pause or stop as @c newTrace and
+     * @c behavior ask.
+     */
+    void executeTrackChanged(utils::channel::FocusState newTrace, utils::channel::MixingBehavior behavior);
     /**
      * Handle (on the @c m_executor threadpool) notification that speech playback has started.
+     *
+     * @param id The source which started.
      */
-    void executePlaybackStarted();
+    void executePlaybackStarted(SourceId id);
 
 
     void executePlaybackStopped();
     /**
-     * Handle (on the @c m_executor threadpool) notification that speech playback has finished.
+     * Handle (on the @c m_executor threadpool) notification that speech playback has finished.  If the player went
+     * straight on with the queued item, that item becomes current; otherwise the playlist moves on.
+     *
+     * @param id The source which finished.
      */
-    void executePlaybackFinished();
+    void executePlaybackFinished(SourceId id);
 
 
     void executePlaybackPaused();
@@ -282,7 +296,84 @@ private:
 
     void playResourceItem(std::string ResourceItem );
 
-    int playKuGouResourceItemID(std::string ResourceItemID, std::string ResourceAlbumIdID);
+    /**
+     * Start resolving the URL of the current KuGou item of @c m_playlist, and play it once the URL arrives.  The lookup
+     * runs on @c m_trackUrlResolver, so neither the handler thread nor @c m_executor waits for the track link
+     * service.  Items which can't be resolved are skipped.
+     *
+     * @param attemptsLeft How many more items may be skipped before giving up.
+     */
+    void startKuGouItem(size_t attemptsLeft);
+
+    /**
+     * Handle (on the @c m_executor threadpool) a request to continue when nothing is playing because the lookup of
+     * the current KuGou item was abandoned by a pause or stop: look it up again, so the playlist goes on from there.
+     */
+    void executeRestartKuGouItem();
+
+    /**
+     * Handle (on the @c m_executor threadpool) the URL of a KuGou item arriving: play it, or skip to the next item.
+     *
+     * @param generation The value of @c m_lookupGeneration when the lookup was started.  A lookup started before
+     * a newer stop, skip or playlist is ignored.
+     * @param itemNum The index of the item in @c m_playlist.
+     * @param attemptsLeft How many more items may be skipped before giving up.
+     * @param result The result of the lookup.
+     */
+    void executeTrackUrlResolved(
+        uint64_t generation,
+        size_t itemNum,
+        size_t attemptsLeft,
+        const TrackUrlResolver::Result& result);
+
+    /**
+     * Build the track link request for a KuGou item of @c m_playlist.
+     *
+     * @param itemNum The index of the item.
+     * @return The request.
+     */
+    TrackLinkRequest buildTrackLinkRequest(size_t itemNum) const;
+
+    /**
+     * Start looking up the items after the one at @c itemNum, so their URLs are ready when they are reached.
+     *
+     * @param itemNum The index of the item playing.
+     */
+    void prefetchKuGouItems(size_t itemNum);
+
+    /**
+     * Hand the item which follows the current one to the player, so it is opened while the current one plays and
+     * follows it without a gap.  The URL of a KuGou item comes from its prefetched lookup, once that completes.
+     * Nothing is queued if the player can't queue sources.
+     */
+    void queueFollowingItem();
+
+    /**
+     * Queue a source with the player (on the @c m_executor thread), and remember what it is.
+     *
+     * @param itemNum The index of the item in @c m_playlist.
+     * @param url The URL of the item.
+     */
+    void queueItem(size_t itemNum, const std::string& url);
+
+    /**
+     * Take back the queued item, before the current source is stopped or replaced.  If the player has gone on to it
+     * already it becomes the current item, so whatever follows acts on what is actually playing.
+     */
+    void discardQueuedItem();
+
+    /**
+     * Make the queued item current, once the player has gone on to it.  @c m_queueMutex must be held.
+     */
+    void adoptQueuedItemLocked();
+
+    /**
+     * Abandon the lookup of the track about to be played, so it won't start after a pause, stop, skip or new
+     * playlist.  After a pause or stop, @c executeRestartKuGouItem() looks it up again on continue.
+     *
+     * @param dropPrefetched Whether lookups of upcoming items are abandoned too, because the playlist changed.
+     */
+    void abandonTrackUrlLookups(bool dropPrefetched);
     
     void executePlaybackError(const utils::mediaPlayer::ErrorType& type, std::string error);
 
@@ -432,6 +523,12 @@ private:
     /// The current trace acquired by the @c ResourcesPlayer.
     utils::channel::FocusState m_currentFocus;
 
+    /**
+     * Whether playback goes on at a lowered volume under a higher priority channel instead of being paused.  Written
+     * on the executor with @c m_mutex held, so @c onTrackChangedWithMixing() can wait for it.
+     */
+    bool m_isDucked;
+
 	/// @c ResourcesDirectiveInfo instance for the @c AVSDirective currently being handled.
 	std::shared_ptr<ResourcesDirectiveInfo> m_currentInfo;
 
@@ -483,6 +580,47 @@ private:
 
     std::string m_kugouUserId;
     
+    /// A lookup of an upcoming KuGou item and when it was started.
+    struct PrefetchedLookup {
+        /// The lookup.
+        std::shared_ptr<TrackUrlResolver::Lookup> lookup;
+        /// When it was started.
+        std::chrono::steady_clock::time_point startTime;
+    };
+
+    /// Resolves KuGou item ids into URLs in the background.
+    std::unique_ptr<TrackUrlResolver> m_trackUrlResolver;
+
+    /// Bumped whenever the track being resolved is abandoned, so a late result is recognized and ignored.
+    std::atomic<uint64_t> m_lookupGeneration;
+
+    /// Serializes access to @c m_currentLookup and @c m_prefetchedLookups.
+    std::mutex m_lookupMutex;
+
+    /// The lookup of the track about to be played.
+    std::shared_ptr<TrackUrlResolver::Lookup> m_currentLookup;
+
+    /// Lookups of upcoming items, by their index in @c m_playlist.
+    std::map<size_t, PrefetchedLookup> m_prefetchedLookups;
+
+    /// The items of the last resources directive, and the one playing.
+    Playlist m_playlist;
+
+    /// Serializes access to @c m_currentUrl, @c m_queuedSourceId, @c m_queuedItemNum and @c m_queuedUrl.
+    std::mutex m_queueMutex;
+
+    /// The URL of the current item, for queueing it again in single loop.
+    std::string m_currentUrl;
+
+    /// The source queued to follow the current one, or @c MediaPlayerInterface::ERROR.
+    SourceId m_queuedSourceId;
+
+    /// The index in @c m_playlist of the queued item.
+    size_t m_queuedItemNum;
+
+    /// The URL of the queued item.
+    std::string m_queuedUrl;
+
 	/// An internal thread pool which queues up operations from asynchronous API calls
 	utils::threading::Executor m_executor;
 
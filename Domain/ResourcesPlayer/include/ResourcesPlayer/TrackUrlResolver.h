@@ -0,0 +1,292 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef _RESOURCESPLAYER_TRACK_URL_RESOLVER_H_
+#define _RESOURCESPLAYER_TRACK_URL_RESOLVER_H_
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <Utils/Threading/Executor.h>
+
+#include "HttpClient.h"
+
+namespace aisdk {
+namespace domain {
+namespace resourcesPlayer {
+
+/**
+ * What the track link service needs to sign and answer a request for the playable URL of a KuGou item.
+ */
+struct TrackLinkRequest {
+    /// The AIUI user id.
+    std::string aiuiUid;
+    /// The AIUI application id.
+    std::string appId;
+    /// The AIUI application key, which the request is signed with.
+    std::string appKey;
+    /// The KuGou user id.
+    std::string kugouUserId;
+    /// The KuGou user token.
+    std::string kugouUserToken;
+    /// The id of the device.
+    std::string clientDeviceId;
+    /// The KuGou item.
+    std::string itemId;
+    /// The album of the item, which may be empty.
+    std::string albumId;
+};
+
+/**
+ * Turns KuGou item ids into playable URLs in the background, so the thread which asks is never held up by the track
+ * link service.  Each lookup can be waited on through a future, be given a callback, and be cancelled: a cancelled
+ * lookup completes at once, and the request behind it is abandoned within @c HttpClient::CANCEL_POLL_INTERVAL.
+ * Several lookups run at once, so upcoming items can be resolved while the current one plays.
+ */
+class TrackUrlResolver {
+public:
+    /// The outcome of a lookup.
+    enum class Status {
+        /// The service answered with a URL.
+        SUCCESS,
+        /// The service could not be reached, or didn't answer with a URL.
+        FAILED,
+        /// The service answered with something that isn't JSON.
+        INVALID_RESPONSE,
+        /// The lookup took longer than its timeout.
+        TIMED_OUT,
+        /// The lookup was cancelled.
+        CANCELLED
+    };
+
+    /// What a lookup produces.
+    struct Result {
+        /// The outcome.
+        Status status;
+        /// The playable URL, if @c status is @c SUCCESS.
+        std::string url;
+    };
+
+    /// Called once with the result of a lookup which wasn't cancelled, on a thread of the resolver.
+    using Callback = std::function<void(const Result& result)>;
+
+    /**
+     * A lookup which has been started.
+     */
+    class Lookup {
+    public:
+        /**
+         * @return The request being looked up.
+         */
+        const TrackLinkRequest& getRequest() const;
+
+        /**
+         * @return A future for the result, ready once the lookup completes, times out or is cancelled.
+         */
+        std::shared_future<Result> getFuture() const;
+
+        /**
+         * @return Whether the lookup has a result.
+         */
+        bool isDone() const;
+
+        /**
+         * Sets the callback, replacing any given to @c resolve().  If the lookup has completed already the callback
+         * is called at once, on the calling thread.
+         *
+         * @param callback Called with the result unless the lookup is cancelled.
+         */
+        void setCallback(Callback callback);
+
+        /**
+         * Abandons the lookup.  If it hasn't completed yet its result becomes @c CANCELLED and its callback is not
+         * called.
+         */
+        void cancel();
+
+    private:
+        friend class TrackUrlResolver;
+
+        /**
+         * Constructor.
+         */
+        Lookup(const TrackLinkRequest& request, std::chrono::steady_clock::time_point deadline, Callback callback);
+
+        /**
+         * Sets the result, unless one is set already, and calls the callback with it unless it is @c CANCELLED.
+         *
+         * @return Whether this call set it.
+         */
+        bool settle(const Result& result);
+
+        /// The request.
+        const TrackLinkRequest m_request;
+
+        /// When the lookup times out.
+        const std::chrono::steady_clock::time_point m_deadline;
+
+        /// Called with the result.  @c m_mutex must be held to access it.
+        Callback m_callback;
+
+        /// Set when the lookup is cancelled; the request in flight watches it.
+        std::atomic<bool> m_cancelled;
+
+        /// Serializes setting the result and the callback.
+        std::mutex m_mutex;
+
+        /// Whether the result is set.
+        bool m_settled;
+
+        /// The result.
+        std::promise<Result> m_promise;
+
+        /// The future of @c m_promise.
+        std::shared_future<Result> m_future;
+    };
+
+    /// The track link service.
+    static const std::string DEFAULT_ENDPOINT;
+
+    /// How long a lookup may take by default.
+    static constexpr std::chrono::seconds DEFAULT_TIMEOUT{5};
+
+    /// How many lookups run at once by default: the track asked for and the ones after it.
+    static constexpr size_t DEFAULT_MAX_IN_FLIGHT = 3;
+
+    /**
+     * Creates a resolver.
+     *
+     * @param client The client requests are made with, or @c nullptr to create one.
+     * @param endpoint The URL of the track link service.
+     * @param timeout How long a lookup may take, from being started to completing.
+     * @param maxInFlight How many lookups run at once.
+     * @return The resolver, or @c nullptr if @c maxInFlight is 0.
+     */
+    static std::unique_ptr<TrackUrlResolver> create(
+        std::shared_ptr<HttpClient> client = nullptr,
+        const std::string& endpoint = DEFAULT_ENDPOINT,
+        std::chrono::milliseconds timeout = DEFAULT_TIMEOUT,
+        size_t maxInFlight = DEFAULT_MAX_IN_FLIGHT);
+
+    /**
+     * Cancels the lookups which haven't completed and waits for the threads to finish with them.
+     */
+    ~TrackUrlResolver();
+
+    /**
+     * Starts a lookup.
+     *
+     * @param request What to look up.
+     * @param callback Called with the result unless the lookup is cancelled, may be empty.
+     * @return The lookup.
+     */
+    std::shared_ptr<Lookup> resolve(const TrackLinkRequest& request, Callback callback = Callback());
+
+    /**
+     * Cancels all lookups which haven't completed.
+     */
+    void cancelAll();
+
+    /**
+     * Looks up the URL of an item on the calling thread.
+     *
+     * @param client The client to make the request with.
+     * @param endpoint The URL of the track link service.
+     * @param request What to look up.
+     * @param timeout How long the request may take.
+     * @param cancelled Set from another thread to abandon the request, or @c nullptr.
+     * @return The result.
+     */
+    static Result fetch(
+        HttpClient* client,
+        const std::string& endpoint,
+        const TrackLinkRequest& request,
+        std::chrono::milliseconds timeout,
+        const std::atomic<bool>* cancelled = nullptr);
+
+private:
+    /**
+     * Constructor.
+     */
+    TrackUrlResolver(
+        std::shared_ptr<HttpClient> client,
+        const std::string& endpoint,
+        std::chrono::milliseconds timeout,
+        size_t maxInFlight);
+
+    /**
+     * Runs a lookup, on one of @c m_executors.
+     *
+     * @param lookup The lookup.
+     * @param executorIndex The index of the executor it runs on.
+     */
+    void executeLookup(std::shared_ptr<Lookup> lookup, size_t executorIndex);
+
+    /// The client requests are made with.
+    std::shared_ptr<HttpClient> m_client;
+
+    /// The URL of the track link service.
+    const std::string m_endpoint;
+
+    /// How long a lookup may take.
+    const std::chrono::milliseconds m_timeout;
+
+    /// Serializes access to @c m_pending and @c m_queuedLookups.
+    std::mutex m_mutex;
+
+    /// Lookups which may not have completed yet.
+    std::list<std::weak_ptr<Lookup>> m_pending;
+
+    /// How many lookups each of @c m_executors has been given and not finished, so new ones go to the least busy.
+    std::vector<size_t> m_queuedLookups;
+
+    /// One thread per lookup in flight.  Declared last, so the threads stop before the rest is destroyed.
+    std::vector<std::unique_ptr<utils::threading::Executor>> m_executors;
+};
+
+/**
+ * Write a @c TrackUrlResolver::Status value to an @c ostream as a string.
+ *
+ * @param stream The stream to write the value to.
+ * @param status The status value to write to the @c ostream as a string.
+ * @return The @c ostream that was passed in and written to.
+ */
+inline std::ostream& operator<<(std::ostream& stream, TrackUrlResolver::Status status) {
+    switch (status) {
+        case TrackUrlResolver::Status::SUCCESS:
+            return stream << "SUCCESS";
+        case TrackUrlResolver::Status::FAILED:
+            return stream << "FAILED";
+        case TrackUrlResolver::Status::INVALID_RESPONSE:
+            return stream << "INVALID_RESPONSE";
+        case TrackUrlResolver::Status::TIMED_OUT:
+            return stream << "TIMED_OUT";
+        case TrackUrlResolver::Status::CANCELLED:
+            return stream << "CANCELLED";
+    }
+    return stream << "UNKNOWN";
+}
+
+}  // namespace resourcesPlayer
+}  // namespace domain
+}  // namespace aisdk
+
+#endif  // _RESOURCESPLAYER_TRACK_URL_RESOLVER_H_
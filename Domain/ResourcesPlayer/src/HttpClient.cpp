@@ -0,0 +1,760 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+
+#include <Utils/Logging/Logger.h>
+
+#include "ResourcesPlayer/HttpClient.h"
+
+namespace aisdk {
+namespace domain {
+namespace resourcesPlayer {
+
+/// String to identify log entries originating from this file.
+static const std::string TAG{"HttpClient"};
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+constexpr std::chrono::seconds HttpClient::DEFAULT_DNS_TTL;
+constexpr std::chrono::seconds HttpClient::DEFAULT_IDLE_TIMEOUT;
+constexpr size_t HttpClient::DEFAULT_MAX_IDLE_PER_HOST;
+constexpr std::chrono::seconds HttpClient::DEFAULT_REQUEST_TIMEOUT;
+constexpr std::chrono::milliseconds HttpClient::CANCEL_POLL_INTERVAL;
+constexpr size_t HttpResponseParser::DEFAULT_MAX_BODY_SIZE;
+
+/// The scheme the client speaks.
+static const std::string HTTP_SCHEME = "http://";
+
+/// The port of @c HTTP_SCHEME.
+static const int DEFAULT_HTTP_PORT = 80;
+
+/// The longest status, header or chunk size line accepted.
+static const size_t MAX_LINE_LENGTH = 8192;
+
+/// The most header lines accepted in a response.
+static const size_t MAX_HEADERS = 100;
+
+/// The largest chunk accepted, far beyond anything a track link needs but safe from overflow.
+static const uint64_t MAX_CHUNK_SIZE = 1ull << 40;
+
+/// The size of the buffer responses are received into.
+static const size_t RECEIVE_BUFFER_SIZE = 16384;
+
+/**
+ * @return @c text in lower case.
+ */
+static std::string toLower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    return text;
+}
+
+/**
+ * @return @c text without leading and trailing spaces and tabs.
+ */
+static std::string trim(const std::string& text) {
+    auto begin = text.find_first_not_of(" \t");
+    if (std::string::npos == begin) {
+        return "";
+    }
+    auto end = text.find_last_not_of(" \t");
+    return text.substr(begin, end - begin + 1);
+}
+
+/**
+ * @return Whether the comma separated header value @c value holds the token @c token, in any case.
+ */
+static bool hasToken(const std::string& value, const std::string& token) {
+    size_t start = 0;
+    while (start <= value.size()) {
+        auto end = value.find(',', start);
+        if (std::string::npos == end) {
+            end = value.size();
+        }
+        if (toLower(trim(value.substr(start, end - start))) == token) {
+            return true;
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+/**
+ * @return The key connections and lookups of a host and port are kept under.
+ */
+static std::string hostKey(const std::string& host, int port) {
+    return host + ":" + std::to_string(port);
+}
+
+/**
+ * @return The milliseconds left until @c deadline, rounded up, at least 0.
+ */
+static int millisecondsUntil(std::chrono::steady_clock::time_point deadline) {
+    auto left = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+    // Round up, so a wait doesn't end just short of the deadline.
+    return std::max(0, static_cast<int>((left.count() + 999) / 1000));
+}
+
+/**
+ * Waits for a socket to become ready.
+ *
+ * @param cancelled Checked every @c HttpClient::CANCEL_POLL_INTERVAL while waiting, if not @c nullptr.
+ * @return @c true if @c events happened before @c deadline and before the wait was cancelled.
+ */
+static bool waitFor(
+    int fd,
+    short events,
+    std::chrono::steady_clock::time_point deadline,
+    const std::atomic<bool>* cancelled) {
+    pollfd entry;
+    entry.fd = fd;
+    entry.events = events;
+    const int slice = static_cast<int>(HttpClient::CANCEL_POLL_INTERVAL.count());
+    while (true) {
+        if (cancelled && *cancelled) {
+            return false;
+        }
+        int left = millisecondsUntil(deadline);
+        int wait = cancelled ? std::min(left, slice) : left;
+        entry.revents = 0;
+        int result = poll(&entry, 1, wait);
+        if (result > 0) {
+            return true;
+        }
+        if (result < 0 && EINTR != errno) {
+            return false;
+        }
+        if (0 == result && wait == left) {
+            return false;
+        }
+    }
+}
+
+bool HttpUrl::parse(const std::string& url, HttpUrl* result) {
+    if (!result || url.compare(0, HTTP_SCHEME.size(), HTTP_SCHEME) != 0) {
+        return false;
+    }
+    auto authorityEnd = url.find_first_of("/?#", HTTP_SCHEME.size());
+    if (std::string::npos == authorityEnd) {
+        authorityEnd = url.size();
+    }
+    std::string authority = url.substr(HTTP_SCHEME.size(), authorityEnd - HTTP_SCHEME.size());
+    int port = DEFAULT_HTTP_PORT;
+    auto colon = authority.rfind(':');
+    if (std::string::npos != colon) {
+        std::string digits = authority.substr(colon + 1);
+        if (digits.empty() || digits.size() > 5 ||
+            std::string::npos != digits.find_first_not_of("0123456789")) {
+            return false;
+        }
+        port = std::stoi(digits);
+        authority.erase(colon);
+    }
+    if (authority.empty() || port <= 0 || port > 65535) {
+        return false;
+    }
+
+    std::string target = url.substr(authorityEnd);
+    auto fragment = target.find('#');
+    if (std::string::npos != fragment) {
+        target.erase(fragment);
+    }
+    if (target.empty() || '/' != target[0]) {
+        target.insert(0, "/");
+    }
+
+    result->host = authority;
+    result->port = port;
+    result->target = target;
+    return true;
+}
+
+std::string HttpResponse::getHeader(const std::string& name) const {
+    auto it = headers.find(toLower(name));
+    return headers.end() == it ? std::string() : it->second;
+}
+
+HttpResponseParser::HttpResponseParser(bool headRequest, size_t maxBodySize) :
+        m_headRequest{headRequest},
+        m_maxBodySize{maxBodySize},
+        m_stage{Stage::STATUS_LINE},
+        m_remaining{0},
+        m_readUntilClose{false},
+        m_connectionClose{false} {
+}
+
+size_t HttpResponseParser::feed(const char* data, size_t size) {
+    size_t position = 0;
+    while (position < size && Stage::DONE != m_stage && Stage::ERROR != m_stage) {
+        size_t consumed = 0;
+        if (Stage::BODY == m_stage || Stage::CHUNK_DATA == m_stage) {
+            consumed = size - position;
+            if (!m_readUntilClose && consumed > m_remaining) {
+                consumed = static_cast<size_t>(m_remaining);
+            }
+            if (consumed > m_maxBodySize - m_response.body.size()) {
+                fail("bodyTooLarge");
+                break;
+            }
+            m_response.body.append(data + position, consumed);
+            if (!m_readUntilClose) {
+                m_remaining -= consumed;
+                if (0 == m_remaining) {
+                    m_stage = Stage::BODY == m_stage ? Stage::DONE : Stage::CHUNK_DATA_END;
+                }
+            }
+        } else if (readLine(data + position, size - position, &consumed)) {
+            processLine();
+            m_line.clear();
+        }
+        position += consumed;
+    }
+    return position;
+}
+
+void HttpResponseParser::processLine() {
+    switch (m_stage) {
+        case Stage::STATUS_LINE:
+            if (parseStatusLine()) {
+                m_stage = Stage::HEADERS;
+            }
+            return;
+        case Stage::HEADERS:
+            if (m_line.empty()) {
+                startBody();
+            } else {
+                parseHeaderLine();
+            }
+            return;
+        case Stage::CHUNK_SIZE: {
+            // Chunk extensions after ';' carry nothing the client needs.
+            std::string digits = trim(m_line.substr(0, m_line.find(';')));
+            if (digits.empty() || std::string::npos != digits.find_first_not_of("0123456789abcdefABCDEF")) {
+                fail("invalidChunkSize");
+                return;
+            }
+            m_remaining = 0;
+            for (char digit : digits) {
+                m_remaining = m_remaining * 16 + (isdigit(digit) ? digit - '0' : (tolower(digit) - 'a' + 10));
+                if (m_remaining > MAX_CHUNK_SIZE) {
+                    fail("chunkTooLarge");
+                    return;
+                }
+            }
+            if (m_remaining > m_maxBodySize - m_response.body.size()) {
+                fail("bodyTooLarge");
+                return;
+            }
+            m_stage = 0 == m_remaining ? Stage::TRAILERS : Stage::CHUNK_DATA;
+            return;
+        }
+        case Stage::CHUNK_DATA_END:
+            if (m_line.empty()) {
+                m_stage = Stage::CHUNK_SIZE;
+            } else {
+                fail("missingChunkEnd");
+            }
+            return;
+        case Stage::TRAILERS:
+            if (m_line.empty()) {
+                m_stage = Stage::DONE;
+            }
+            return;
+        case Stage::BODY:
+        case Stage::CHUNK_DATA:
+        case Stage::DONE:
+        case Stage::ERROR:
+            return;
+    }
+}
+
+void HttpResponseParser::finish() {
+    if (Stage::BODY == m_stage && m_readUntilClose) {
+        m_stage = Stage::DONE;
+    } else if (Stage::DONE != m_stage) {
+        fail("connectionClosedEarly");
+    }
+}
+
+HttpResponseParser::State HttpResponseParser::getState() const {
+    switch (m_stage) {
+        case Stage::DONE:
+            return State::DONE;
+        case Stage::ERROR:
+            return State::ERROR;
+        default:
+            return State::NEED_MORE;
+    }
+}
+
+bool HttpResponseParser::isKeepAlive() const {
+    return Stage::DONE == m_stage && !m_readUntilClose && !m_connectionClose;
+}
+
+const HttpResponse& HttpResponseParser::getResponse() const {
+    return m_response;
+}
+
+HttpResponse HttpResponseParser::takeResponse() {
+    return std::move(m_response);
+}
+
+bool HttpResponseParser::readLine(const char* data, size_t size, size_t* consumed) {
+    auto newline = static_cast<const char*>(memchr(data, '\n', size));
+    size_t length = newline ? static_cast<size_t>(newline - data) : size;
+    if (m_line.size() + length > MAX_LINE_LENGTH) {
+        fail("lineTooLong");
+        *consumed = size;
+        return false;
+    }
+    m_line.append(data, length);
+    if (!newline) {
+        *consumed = size;
+        return false;
+    }
+    *consumed = length + 1;
+    if (!m_line.empty() && '\r' == m_line.back()) {
+        m_line.pop_back();
+    }
+    return true;
+}
+
+bool HttpResponseParser::parseStatusLine() {
+    // HTTP/1.x SP 3DIGIT [SP reason]
+    if (m_line.size() < 12 || m_line.compare(0, 7, "HTTP/1.") != 0 || !isdigit(m_line[7]) || ' ' != m_line[8] ||
+        !isdigit(m_line[9]) || !isdigit(m_line[10]) || !isdigit(m_line[11]) ||
+        (m_line.size() > 12 && ' ' != m_line[12])) {
+        fail("invalidStatusLine");
+        return false;
+    }
+    m_response.minorVersion = m_line[7] - '0';
+    m_response.status = std::stoi(m_line.substr(9, 3));
+    return true;
+}
+
+bool HttpResponseParser::parseHeaderLine() {
+    auto colon = m_line.find(':');
+    if (std::string::npos == colon || 0 == colon || ' ' == m_line[0] || '\t' == m_line[0]) {
+        fail("invalidHeader");
+        return false;
+    }
+    if (m_response.headers.size() >= MAX_HEADERS) {
+        fail("tooManyHeaders");
+        return false;
+    }
+    std::string name = toLower(m_line.substr(0, colon));
+    std::string value = trim(m_line.substr(colon + 1));
+    auto it = m_response.headers.find(name);
+    if (m_response.headers.end() == it) {
+        m_response.headers[name] = value;
+    } else {
+        it->second += ", " + value;
+    }
+    return true;
+}
+
+void HttpResponseParser::startBody() {
+    const int status = m_response.status;
+    if (status >= 100 && status < 200 && 101 != status) {
+        // An interim response; the real one follows on the same connection.
+        m_response = HttpResponse();
+        m_stage = Stage::STATUS_LINE;
+        return;
+    }
+
+    std::string connection = m_response.getHeader("connection");
+    m_connectionClose =
+        hasToken(connection, "close") || (0 == m_response.minorVersion && !hasToken(connection, "keep-alive"));
+
+    if (m_headRequest || 101 == status || 204 == status || 304 == status) {
+        m_stage = Stage::DONE;
+        return;
+    }
+    std::string transferEncoding = m_response.getHeader("transfer-encoding");
+    if (!transferEncoding.empty()) {
+        if (!hasToken(transferEncoding.substr(transferEncoding.rfind(',') + 1), "chunked")) {
+            // Only a final chunked coding delimits the body; anything else runs to the end of the connection.
+            m_readUntilClose = true;
+            m_stage = Stage::BODY;
+            return;
+        }
+        m_stage = Stage::CHUNK_SIZE;
+        return;
+    }
+    std::string contentLength = m_response.getHeader("content-length");
+    if (!contentLength.empty()) {
+        if (contentLength.size() > 18 || std::string::npos != contentLength.find_first_not_of("0123456789")) {
+            fail("invalidContentLength");
+            return;
+        }
+        m_remaining = std::stoull(contentLength);
+        if (m_remaining > m_maxBodySize) {
+            fail("bodyTooLarge");
+            return;
+        }
+        m_stage = 0 == m_remaining ? Stage::DONE : Stage::BODY;
+        return;
+    }
+    m_readUntilClose = true;
+    m_stage = Stage::BODY;
+}
+
+void HttpResponseParser::fail(const std::string& reason) {
+    AISDK_ERROR(LX("parseResponseFailed").d("reason", reason));
+    m_stage = Stage::ERROR;
+}
+
+DnsCache::DnsCache(std::chrono::milliseconds ttl, Resolver resolver) :
+        m_ttl{ttl},
+        m_resolver{resolver ? resolver : Resolver(systemResolve)} {
+}
+
+bool DnsCache::resolve(const std::string& host, int port, std::vector<HttpAddress>* addresses) {
+    const std::string key = hostKey(host, port);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (m_entries.end() != it) {
+            if (std::chrono::steady_clock::now() < it->second.expiry) {
+                *addresses = it->second.addresses;
+                return true;
+            }
+            m_entries.erase(it);
+        }
+    }
+
+    // Look up without the lock, so a slow lookup doesn't hold up requests to other hosts.
+    std::vector<HttpAddress> found;
+    if (!m_resolver(host, port, &found) || found.empty()) {
+        AISDK_ERROR(LX("resolveFailed").d("host", host));
+        return false;
+    }
+    AISDK_DEBUG0(LX("resolved").d("host", host).d("addresses", found.size()));
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries[key] = Entry{found, std::chrono::steady_clock::now() + m_ttl};
+    *addresses = std::move(found);
+    return true;
+}
+
+void DnsCache::invalidate(const std::string& host, int port) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.erase(hostKey(host, port));
+}
+
+bool DnsCache::systemResolve(const std::string& host, int port, std::vector<HttpAddress>* addresses) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    int error = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result);
+    if (0 != error) {
+        AISDK_ERROR(LX("getaddrinfoFailed").d("host", host).d("reason", gai_strerror(error)));
+        return false;
+    }
+    for (auto info = result; info; info = info->ai_next) {
+        if (info->ai_addrlen > sizeof(sockaddr_storage)) {
+            continue;
+        }
+        HttpAddress address;
+        memset(&address.address, 0, sizeof(address.address));
+        memcpy(&address.address, info->ai_addr, info->ai_addrlen);
+        address.length = info->ai_addrlen;
+        addresses->push_back(address);
+    }
+    freeaddrinfo(result);
+    return !addresses->empty();
+}
+
+std::shared_ptr<HttpClient> HttpClient::create(
+    std::chrono::milliseconds dnsTtl,
+    std::chrono::milliseconds idleTimeout,
+    size_t maxIdlePerHost,
+    DnsCache::Resolver resolver) {
+    return std::shared_ptr<HttpClient>(new HttpClient(dnsTtl, idleTimeout, maxIdlePerHost, resolver));
+}
+
+HttpClient::HttpClient(
+    std::chrono::milliseconds dnsTtl,
+    std::chrono::milliseconds idleTimeout,
+    size_t maxIdlePerHost,
+    DnsCache::Resolver resolver) :
+        m_idleTimeout{idleTimeout},
+        m_maxIdlePerHost{maxIdlePerHost},
+        m_dnsCache{dnsTtl, resolver} {
+}
+
+HttpClient::~HttpClient() {
+    closeIdleConnections();
+}
+
+bool HttpClient::get(
+    const std::string& url,
+    HttpResponse* response,
+    std::chrono::milliseconds timeout,
+    const std::atomic<bool>* cancelled) {
+    return request("GET", url, "", "", response, timeout, cancelled);
+}
+
+bool HttpClient::post(
+    const std::string& url,
+    const std::string& contentType,
+    const std::string& body,
+    HttpResponse* response,
+    std::chrono::milliseconds timeout,
+    const std::atomic<bool>* cancelled) {
+    return request("POST", url, contentType, body, response, timeout, cancelled);
+}
+
+void HttpClient::closeIdleConnections() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& host : m_idle) {
+        for (auto& connection : host.second) {
+            close(connection.fd);
+        }
+    }
+    m_idle.clear();
+}
+
+size_t HttpClient::getIdleConnectionCount() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (auto& host : m_idle) {
+        count += host.second.size();
+    }
+    return count;
+}
+
+bool HttpClient::request(
+    const std::string& method,
+    const std::string& url,
+    const std::string& contentType,
+    const std::string& body,
+    HttpResponse* response,
+    std::chrono::milliseconds timeout,
+    const std::atomic<bool>* cancelled) {
+    if (!response) {
+        AISDK_ERROR(LX("requestFailed").d("reason", "nullResponse"));
+        return false;
+    }
+    HttpUrl target;
+    if (!HttpUrl::parse(url, &target)) {
+        AISDK_ERROR(LX("requestFailed").d("reason", "invalidUrl").d("url", url));
+        return false;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    const std::string key = hostKey(target.host, target.port);
+
+    std::string message = method + " " + target.target + " HTTP/1.1\r\nHost: " + target.host;
+    if (DEFAULT_HTTP_PORT != target.port) {
+        message += ":" + std::to_string(target.port);
+    }
+    message += "\r\nAccept: */*\r\nConnection: keep-alive\r\n";
+    if ("GET" != method && "HEAD" != method) {
+        if (!contentType.empty()) {
+            message += "Content-Type: " + contentType + "\r\n";
+        }
+        message += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    }
+    message += "\r\n" + body;
+
+    while (true) {
+        int fd = takeIdleConnection(key);
+        const bool reused = fd >= 0;
+        if (!reused) {
+            fd = connectTo(target, deadline, cancelled);
+            if (fd < 0) {
+                return false;
+            }
+        }
+
+        HttpResponseParser parser("HEAD" == method);
+        bool receivedAny = false;
+        bool reusable = false;
+        if (exchange(fd, message, deadline, cancelled, &parser, &receivedAny, &reusable)) {
+            *response = parser.takeResponse();
+            if (reusable) {
+                releaseConnection(key, fd);
+            } else {
+                close(fd);
+            }
+            AISDK_DEBUG0(LX("request").d("url", url).d("status", response->status).d("reused", reused));
+            return true;
+        }
+        close(fd);
+        if (cancelled && *cancelled) {
+            AISDK_DEBUG0(LX("requestCancelled").d("url", url));
+            return false;
+        }
+        // A pooled connection may have been closed by the server while it was idle; that only shows once a request
+        // is sent on it, so try again on another connection unless the server started answering.
+        if (!reused || receivedAny) {
+            AISDK_ERROR(LX("requestFailed").d("url", url).d("reused", reused));
+            return false;
+        }
+        AISDK_DEBUG0(LX("retryingRequest").d("reason", "staleConnection").d("host", key));
+    }
+}
+
+bool HttpClient::exchange(
+    int fd,
+    const std::string& message,
+    std::chrono::steady_clock::time_point deadline,
+    const std::atomic<bool>* cancelled,
+    HttpResponseParser* parser,
+    bool* receivedAny,
+    bool* reusable) {
+    size_t sent = 0;
+    while (sent < message.size()) {
+        ssize_t result = send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (result >= 0) {
+            sent += result;
+        } else if (EINTR == errno) {
+            continue;
+        } else if ((EAGAIN != errno && EWOULDBLOCK != errno) || !waitFor(fd, POLLOUT, deadline, cancelled)) {
+            AISDK_ERROR(LX("sendFailed").d("reason", strerror(errno)));
+            return false;
+        }
+    }
+
+    char buffer[RECEIVE_BUFFER_SIZE];
+    while (true) {
+        if (!waitFor(fd, POLLIN, deadline, cancelled)) {
+            AISDK_ERROR(LX("receiveFailed").d("reason", cancelled && *cancelled ? "cancelled" : "timedOut"));
+            return false;
+        }
+        ssize_t result = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (result < 0) {
+            if (EINTR == errno || EAGAIN == errno || EWOULDBLOCK == errno) {
+                continue;
+            }
+            AISDK_ERROR(LX("receiveFailed").d("reason", strerror(errno)));
+            return false;
+        }
+        if (0 == result) {
+            parser->finish();
+            *reusable = false;
+            return HttpResponseParser::State::DONE == parser->getState();
+        }
+        *receivedAny = true;
+        size_t consumed = parser->feed(buffer, result);
+        switch (parser->getState()) {
+            case HttpResponseParser::State::NEED_MORE:
+                break;
+            case HttpResponseParser::State::DONE:
+                // Anything after the response was not asked for, so the connection is out of step.
+                *reusable = parser->isKeepAlive() && consumed == static_cast<size_t>(result);
+                return true;
+            case HttpResponseParser::State::ERROR:
+                return false;
+        }
+    }
+}
+
+int HttpClient::takeIdleConnection(const std::string& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_idle.find(key);
+    if (m_idle.end() == it) {
+        return -1;
+    }
+    auto& connections = it->second;
+    const auto now = std::chrono::steady_clock::now();
+    while (!connections.empty()) {
+        Connection connection = connections.back();
+        connections.pop_back();
+        if (now - connection.idleSince > m_idleTimeout) {
+            close(connection.fd);
+            continue;
+        }
+        // An idle connection has nothing to read unless the server closed it.
+        char byte;
+        ssize_t result = recv(connection.fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (result < 0 && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+            return connection.fd;
+        }
+        close(connection.fd);
+    }
+    return -1;
+}
+
+void HttpClient::releaseConnection(const std::string& key, int fd) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (0 == m_maxIdlePerHost) {
+        close(fd);
+        return;
+    }
+    auto& connections = m_idle[key];
+    if (connections.size() >= m_maxIdlePerHost) {
+        close(connections.front().fd);
+        connections.erase(connections.begin());
+    }
+    connections.push_back({fd, std::chrono::steady_clock::now()});
+}
+
+int HttpClient::connectTo(
+    const HttpUrl& url,
+    std::chrono::steady_clock::time_point deadline,
+    const std::atomic<bool>* cancelled) {
+    std::vector<HttpAddress> addresses;
+    if (!m_dnsCache.resolve(url.host, url.port, &addresses)) {
+        return -1;
+    }
+    for (auto& address : addresses) {
+        int fd = socket(address.address.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        int result = connect(fd, reinterpret_cast<const sockaddr*>(&address.address), address.length);
+        if (result < 0 && EINPROGRESS == errno && waitFor(fd, POLLOUT, deadline, cancelled)) {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &length);
+            result = 0 == error ? 0 : -1;
+        }
+        if (0 == result) {
+            // Requests are small and written at once; don't hold them back waiting for an ACK.
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+            return fd;
+        }
+        close(fd);
+        if (cancelled && *cancelled) {
+            return -1;
+        }
+    }
+    AISDK_ERROR(LX("connectFailed").d("host", url.host).d("port", url.port));
+    // The host may have moved; look it up again next time.
+    m_dnsCache.invalidate(url.host, url.port);
+    return -1;
+}
+
+}  // namespace resourcesPlayer
+}  // namespace domain
+}  // namespace aisdk
@@ -0,0 +1,177 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "ResourcesPlayer/Playlist.h"
+
+namespace aisdk {
+namespace domain {
+namespace resourcesPlayer {
+
+Playlist::Playlist() : m_isKuGou{false}, m_isSingleLoop{false}, m_isListLoop{false}, m_current{0} {
+}
+
+void Playlist::reset(const std::vector<Item>& items, bool isKuGou) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_items = items;
+    m_isKuGou = isKuGou;
+    m_isSingleLoop = false;
+    m_isListLoop = false;
+    m_current = 0;
+}
+
+void Playlist::clear() {
+    reset(std::vector<Item>(), false);
+}
+
+size_t Playlist::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_items.size();
+}
+
+bool Playlist::empty() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_items.empty();
+}
+
+bool Playlist::isKuGou() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_isKuGou;
+}
+
+void Playlist::setSingleLoop(bool enabled) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isSingleLoop = enabled;
+}
+
+bool Playlist::isSingleLoop() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_isSingleLoop;
+}
+
+void Playlist::setListLoop(bool enabled) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_isListLoop = enabled;
+}
+
+bool Playlist::isListLoop() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_isListLoop;
+}
+
+size_t Playlist::getCurrentIndex() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_current;
+}
+
+bool Playlist::setCurrentIndex(size_t index) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (index >= m_items.size()) {
+        return false;
+    }
+    m_current = index;
+    return true;
+}
+
+bool Playlist::getItem(size_t index, Item* item) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!item || index >= m_items.size()) {
+        return false;
+    }
+    *item = m_items[index];
+    return true;
+}
+
+bool Playlist::getCurrentItem(Item* item) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!item || m_current >= m_items.size()) {
+        return false;
+    }
+    *item = m_items[m_current];
+    return true;
+}
+
+void Playlist::skipForward() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_current = m_current + 1 < m_items.size() ? m_current + 1 : 0;
+}
+
+void Playlist::skipBack() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_items.empty()) {
+        return;
+    }
+    m_current = (0 == m_current ? m_items.size() : m_current) - 1;
+}
+
+bool Playlist::advance() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!getFollowingIndexLocked(m_current, true, &m_current)) {
+        m_current = m_items.size();
+        return false;
+    }
+    return true;
+}
+
+bool Playlist::getFollowingIndex(size_t* index) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return index && getFollowingIndexLocked(m_current, true, index);
+}
+
+bool Playlist::skipUnplayable() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!getFollowingIndexLocked(m_current, false, &m_current)) {
+        m_current = m_items.size();
+        return false;
+    }
+    return true;
+}
+
+std::vector<size_t> Playlist::getUpcomingIndices(size_t from, size_t count) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<size_t> upcoming;
+    if (m_isSingleLoop) {
+        return upcoming;
+    }
+    size_t index = from;
+    while (upcoming.size() < count && getFollowingIndexLocked(index, false, &index) && index != from) {
+        upcoming.push_back(index);
+    }
+    return upcoming;
+}
+
+bool Playlist::getFollowingIndexLocked(size_t from, bool repeat, size_t* index) const {
+    if (from >= m_items.size()) {
+        return false;
+    }
+    // A single story or song given by URL has always been played just once, whatever the loop modes.
+    if (!m_isKuGou && 1 == m_items.size()) {
+        return false;
+    }
+    if (repeat && m_isSingleLoop) {
+        *index = from;
+        return true;
+    }
+    if (from + 1 < m_items.size()) {
+        *index = from + 1;
+        return true;
+    }
+    if (m_isListLoop) {
+        *index = 0;
+        return true;
+    }
+    return false;
+}
+
+}  // namespace resourcesPlayer
+}  // namespace domain
+}  // namespace aisdk
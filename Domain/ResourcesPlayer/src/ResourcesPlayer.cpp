@@ -45,32 +45,26 @@ static const std::string PLAYCONTROL{"PlayControl"};
 /// The duration to wait for a state change in @c onTrackChanged before failing.
 static const std::chrono::seconds STATE_CHANGE_TIMEOUT{3};
 
+/// The volume music keeps while ducked under speech or an alarm, about -14 dB.
+static const float DUCKED_GAIN = 0.2f;
+
+/// How long ducking and unducking take, long enough not to click.
+static const std::chrono::milliseconds DUCK_RAMP_DURATION{150};
+
 /// The duration to start playing offset position.
 static const std::chrono::milliseconds DEFAULT_OFFSET{0};
 
-//add deque for store audio_list;
-std::deque<std::string> AUDIO_URL_LIST; 
+/// How many KuGou items after the one playing have their URLs looked up ahead of time.
+static const size_t PREFETCH_ITEMS = 2;
 
-//add deque for store audio_id_list;
-std::deque<std::string> AUDIO_ID_LIST; 
+/// How long a looked up URL is trusted before it is looked up again, well within the life of a track link.
+static const std::chrono::minutes PREFETCH_MAX_AGE{10};
 
 ///add for use store play control state; enable = 1;unable = 0;
 int flag_playControl_pause = 0; 
 
-///add for use enable single loop;enable = 1;unable = 0;
-int enable_single_loop = 0;
-
-///add for use enable LIST loop;enable = 1;unable = 0;
-int enable_list_loop = 0;
-    
 bool m_isStopped = false;
 
-///add for select resources num in audiolist;
-std::size_t currentItemNum = 0;
-
-///add for select resources from;
-bool enable_kugou_resources = false;
-
 std::shared_ptr<ResourcesPlayer> ResourcesPlayer::create(
 	std::shared_ptr<MediaPlayerInterface> mediaPlayer,
 	std::shared_ptr<AudioTrackManagerInterface> trackManager,
@@ -110,7 +104,7 @@ void ResourcesPlayer::preHandleDirective(std::shared_ptr<DirectiveInfo> info) {
     AISDK_INFO(LX("preHandleDirective").d("messageId",  info->directive->getMessageId()));
     //m_executor.submit([this, info]() { executePreHandle(info); });
     executePreHandle(info);
-    AISDK_INFO(LX("Create").d("NlpData_dataMsg", info->directive->getData()));   
+    AISDK_INFO(LX("Create").d("NlpData_dataMsg", info->directive->getUnparsedDomain()));   
 }
 
 void ResourcesPlayer::handleDirective(std::shared_ptr<DirectiveInfo> info) {
@@ -186,8 +180,23 @@ void ResourcesPlayer::cancelDirective(std::shared_ptr<DirectiveInfo> info) {
 }
 
 void ResourcesPlayer::onTrackChanged(FocusState newTrace) {
-    AISDK_INFO(LX("onTrackChanged").d("newTrace", newTrace));
-    m_executor.submit([this, newTrace]() { executeTrackChanged(newTrace); });
+    // Without a mixing behavior, pause in the background as before.
+    switch (newTrace) {
+        case FocusState::FOREGROUND:
+            onTrackChangedWithMixing(newTrace, MixingBehavior::PRIMARY);
+            return;
+        case FocusState::BACKGROUND:
+            onTrackChangedWithMixing(newTrace, MixingBehavior::MUST_PAUSE);
+            return;
+        case FocusState::NONE:
+            onTrackChangedWithMixing(newTrace, MixingBehavior::MUST_STOP);
+            return;
+    }
+}
+
+void ResourcesPlayer::onTrackChangedWithMixing(FocusState newTrace, MixingBehavior behavior) {
+    AISDK_INFO(LX("onTrackChanged").d("newTrace", newTrace).d("behavior", behavior));
+    m_executor.submit([this, newTrace, behavior]() { executeTrackChanged(newTrace, behavior); });
 
     // Set intermediate state to avoid being considered idle
     switch (newTrace) {
@@ -196,6 +205,10 @@ void ResourcesPlayer::onTrackChanged(FocusState newTrace) {
         case FocusState::BACKGROUND:
         {
              auto predicate = [this](){ 
+                // Ducked playback goes on quietly; there is no state to wait for.
+                if (m_isDucked) {
+                    return true;
+                }
                 switch (m_currentState) {
                     case  ResourcesPlayerObserverInterface::ResourcesPlayerState::IDLE:
                     case  ResourcesPlayerObserverInterface::ResourcesPlayerState::PAUSED:
@@ -244,34 +257,13 @@ void ResourcesPlayer::onTrackChanged(FocusState newTrace) {
 
 void ResourcesPlayer::onPlaybackStarted(SourceId id) {
 	AISDK_INFO(LX("onPlaybackStarted").d("callbackSourceId", id));
-    if (id != m_mediaSourceId) {
-		AISDK_ERROR(LX("queueingExecutePlaybackStartedFailed")
-					.d("reason", "mismatchSourceId")
-					.d("callbackSourceId", id)
-					.d("sourceId", m_mediaSourceId));
-        m_executor.submit([this] {
-            executePlaybackError(ErrorType::MEDIA_ERROR_INTERNAL_DEVICE_ERROR, "executePlaybackStartedFailed");
-        });
-    } else {
-        m_executor.submit([this]() { executePlaybackStarted(); });
-    }
-
+    // The source is checked on the executor, where a queued source is made current.
+    m_executor.submit([this, id]() { executePlaybackStarted(id); });
 }
 
 void ResourcesPlayer::onPlaybackFinished(SourceId id) {
     AISDK_INFO(LX("onPlaybackFinished").d("callbackSourceId", id));
-
-    if (id != m_mediaSourceId) {
-		AISDK_ERROR(LX("queueingExecutePlaybackFinishedFailed")
-					.d("reason", "mismatchSourceId")
-					.d("callbackSourceId", id)
-					.d("sourceId", m_mediaSourceId));
-		m_executor.submit([this] {
-            executePlaybackError(ErrorType::MEDIA_ERROR_INTERNAL_DEVICE_ERROR, "executePlaybackFinishedFailed");
-        });
-    } else {
-        m_executor.submit([this]() { executePlaybackFinished(); });
-    }
+    m_executor.submit([this, id]() { executePlaybackFinished(id); });
 }
 
 
@@ -416,7 +408,9 @@ void ResourcesPlayer::doShutdown() {
         }
     }
 	
+    abandonTrackUrlLookups(true);
     m_executor.shutdown();
+    m_trackUrlResolver.reset();
     m_resourcesPlayer.reset();
     m_waitOnStateChange.notify_one();
     m_trackManager.reset();
@@ -447,87 +441,58 @@ ResourcesPlayer::ResourcesPlayer(
 	m_currentState{ResourcesPlayerObserverInterface::ResourcesPlayerState::FINISHED},
 	m_desiredState{ResourcesPlayerObserverInterface::ResourcesPlayerState::FINISHED},
 	m_currentFocus{FocusState::NONE},
-	m_isAlreadyStopping{false} {
+	m_isDucked{false},
+	m_isAlreadyStopping{false},
+	m_trackUrlResolver{TrackUrlResolver::create()},
+	m_lookupGeneration{0},
+	m_queuedSourceId{MediaPlayerInterface::ERROR},
+	m_queuedItemNum{0} {
 }
 
 void ResourcesPlayer::init() {
     m_resourcesPlayer->setObserver(shared_from_this());
 }
 
-void ResourcesPlayer::AnalysisNlpDataForResourcesPlayer(cJSON          * datain , std::deque<std::string> &audiourllist )
+void ResourcesPlayer::AnalysisNlpDataForResourcesPlayer(const Json::Value &data, std::vector<Playlist::Item> &items )
 {
-    cJSON* json = NULL, *json_data = NULL, *json_answer = NULL,
-     *json_parameters = NULL, *json_title = NULL,*json_album = NULL, *json_audio_url = NULL;
-
-     (void )json;
-     (void )json_data;
-     (void )json_answer;
-     (void )json_parameters;
-     (void )json_title;
-     (void )json_album;
-     (void )json_audio_url;  
-
-     json_data = datain;
-     if(!json_data) {
-        AISDK_ERROR(LX("AnalysisNlpDataForResourcesPlayer").d("json Error before", cJSON_GetErrorPtr()));
-     }else{
-       json_answer = cJSON_GetObjectItem(json_data, "answer");
-       AISDK_INFO(LX("AnalysisNlpDataForResourcesPlayer").d("json_answer", json_answer->valuestring));
- 
-        //parameters  
-        json_parameters = cJSON_GetObjectItem(json_data, "parameters"); 
-        if(json_parameters != NULL) {
-            json_album = cJSON_GetObjectItem(json_parameters, "album");
-            json_title = cJSON_GetObjectItem(json_parameters, "title");
-        }else {
-            AISDK_ERROR(LX("AnalysisNlpDataForResourcesPlayer").d("json_parameters", "parameters is null"));
-        }
- 
-        //audio_list
-        cJSON *js_list = cJSON_GetObjectItem(json_data, "audio_list");
-         if(!js_list){
-            AISDK_ERROR(LX("AnalysisNlpDataForResourcesPlayer").d("audio_list", "no audio_list!"));
-            return;
-         }
-         
-         int array_size = cJSON_GetArraySize(js_list);
-         AISDK_DEBUG(LX("AnalysisNlpDataForResourcesPlayer").d("audio_list size", array_size));
+    if(!data.isObject()) {
+        AISDK_ERROR(LX("AnalysisNlpDataForResourcesPlayer").d("reason", "parseDataKeyError"));
+        return;
+    }
+    AISDK_INFO(LX("AnalysisNlpDataForResourcesPlayer").d("json_answer", data["answer"].asString()));
 
-         if(array_size == 0){
-               AISDK_ERROR(LX("AnalysisNlpDataForResourcesPlayer").d("audio_list", "NULL"));
-         }else{
-              int i = 0;
-              cJSON *item,*it;
-              char *p  = NULL;
-              for(i=0; i< array_size; i++) {
-                 item = cJSON_GetArrayItem(js_list, i);
-                 if(!item) {
-                    //TODO...
-                 }
-                 p = cJSON_PrintUnformatted(item);
-                 it = cJSON_Parse(p);
-                 if(!it)
-                 continue ;
-             json_title = cJSON_GetObjectItem(it, "title");
-             json_audio_url = cJSON_GetObjectItem(it, "audio_url");
-             //std::cout << "NO: " << i << ":json_title =  "<< json_title->valuestring << std::endl;
-             //std::cout << "NO: " << i << ":json_audio_url =  " << json_audio_url->valuestring << std::endl;
-             audiourllist.push_back(json_audio_url->valuestring);
-              }
-         }
-         
-           
-     }
+    //parameters
+    if(!data.isMember("parameters")) {
+        AISDK_ERROR(LX("AnalysisNlpDataForResourcesPlayer").d("json_parameters", "parameters is null"));
+    }
+
+    //audio_list
+    auto& audioList = data["audio_list"];
+    if(!audioList.isArray()) {
+        AISDK_ERROR(LX("AnalysisNlpDataForResourcesPlayer").d("audio_list", "no audio_list!"));
+        return;
+    }
+
+    AISDK_DEBUG(LX("AnalysisNlpDataForResourcesPlayer").d("audio_list size", audioList.size()));
+    if(audioList.empty()) {
+        AISDK_ERROR(LX("AnalysisNlpDataForResourcesPlayer").d("audio_list", "NULL"));
+        return;
+    }
 
+    // The items are read in place; there is no need to print each one and parse it back.
+    for(auto& item : audioList) {
+        if(!item.isObject() || !item["audio_url"].isString()) {
+            continue;
+        }
+        Playlist::Item audioItem;
+        audioItem.url = item["audio_url"].asString();
+        items.push_back(audioItem);
+    }
 }
 
-void ResourcesPlayer::AnalysisAudioIdForResourcesPlayer(std::shared_ptr<DirectiveInfo> info , std::deque<std::string> &audioidlist ) {
-    auto data = info->directive->getData();
-    Json::CharReaderBuilder readerBuilder;
-    JSONCPP_STRING errs;
-    Json::Value root;
-    std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
-    if (!reader->parse(data.c_str(), data.c_str()+data.length(), &root, &errs)) {
+void ResourcesPlayer::AnalysisAudioIdForResourcesPlayer(std::shared_ptr<DirectiveInfo> info , std::vector<Playlist::Item> &items ) {
+    auto& root = info->directive->getDataValue();
+    if (!root.isObject()) {
         AISDK_ERROR(LX("AnalysisAudioIdForResourcesPlayer").d("reason", "parseDataKeyError"));
         return;
     }
@@ -537,48 +502,40 @@ void ResourcesPlayer::AnalysisAudioIdForResourcesPlayer(std::shared_ptr<Directiv
         return;
     }
 
-    Json::Value audio_List = root["audio_list"];
+    auto& audio_List = root["audio_list"];
     int audioListSize = audio_List.size();
     for (int i = 0; i < audioListSize; (i++)) {
-        std::string audio_itemid = audio_List[i]["itemid"].asString();
-        AISDK_DEBUG3(LX("AnalysisAudioIdForResourcesPlayer").d("audioIdList[i]", i+1 ).d("itemid", audio_itemid));
-        audioidlist.push_back(audio_itemid);
+        Playlist::Item audioItem;
+        audioItem.itemId = audio_List[i]["itemid"].asString();
+        AISDK_DEBUG3(LX("AnalysisAudioIdForResourcesPlayer").d("audioIdList[i]", i+1 ).d("itemid", audioItem.itemId));
         
-        std::string audio_albumid = audio_List[i]["albumid"].asString();
-        AISDK_DEBUG3(LX("AnalysisAudioIdForResourcesPlayer").d("audioIdList[i]", i+1 ).d("albumid", audio_albumid));
-        audioidlist.push_back(audio_albumid);
+        audioItem.albumId = audio_List[i]["albumid"].asString();
+        AISDK_DEBUG3(LX("AnalysisAudioIdForResourcesPlayer").d("audioIdList[i]", i+1 ).d("albumid", audioItem.albumId));
+        items.push_back(audioItem);
     }
     
 }
 
 
 void ResourcesPlayer::AnalysisNlpDataForPlayControl(std::shared_ptr<DirectiveInfo> info, std::string &operation ) {
-    auto data = info->directive->getData();
-    Json::CharReaderBuilder readerBuilder;
-    JSONCPP_STRING errs;
-    Json::Value root;
-    std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
-    if (!reader->parse(data.c_str(), data.c_str()+data.length(), &root, &errs)) {
+    auto& root = info->directive->getDataValue();
+    if (!root.isObject()) {
         AISDK_ERROR(LX("AnalysisNlpDataForPlayControl").d("reason", "parseDataKeyError"));
         return;
     }
-    Json::Value parameters = root["parameters"];
+    auto& parameters = root["parameters"];
     operation = parameters["operation"].asString();
     AISDK_INFO(LX("AnalysisNlpDataForPlayControl").d("operation", operation));
 }
 
 
 void ResourcesPlayer::AnalysisNlpDataForVolume(std::shared_ptr<DirectiveInfo> info, std::string &operation, int &volumeValue ) {
-    auto data = info->directive->getData();
-    Json::CharReaderBuilder readerBuilder;
-    JSONCPP_STRING errs;
-    Json::Value root;
-    std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
-    if (!reader->parse(data.c_str(), data.c_str()+data.length(), &root, &errs)) {
+    auto& root = info->directive->getDataValue();
+    if (!root.isObject()) {
         AISDK_ERROR(LX("AnalysisNlpDataForVolume").d("reason", "parseDataKeyError"));
         return;
     }
-    Json::Value parameters = root["parameters"];
+    auto& parameters = root["parameters"];
     operation = parameters["operation"].asString();
     AISDK_INFO(LX("AnalysisNlpDataForVolume").d("operation", operation));
 
@@ -604,83 +561,65 @@ void ResourcesPlayer::responsePlayControl(std::shared_ptr<DirectiveInfo> info, s
               }  
         }else if(m_operation == "CONTINUE" ){
               flag_playControl_pause = 0;
-              if( !m_resourcesPlayer->resume(m_mediaSourceId)){
+              if (MediaPlayerInterface::ERROR == m_mediaSourceId && m_playlist.isKuGou()) {
+                  // Paused between two KuGou items, so there is nothing to resume.
+                  m_executor.submit([this]() { executeRestartKuGouItem(); });
+              } else if( !m_resourcesPlayer->resume(m_mediaSourceId)){
                   AISDK_ERROR(LX("responsePlayControl").d("resume","failed"));
               }  
         }else if(m_operation == "NEXT" || m_operation == "SWITCH" || m_operation == "RANDOM_PLAY") {
               flag_playControl_pause = 0;
-              
-              if(enable_kugou_resources == 1){
-                  currentItemNum = currentItemNum + 2;
-                  if(currentItemNum >= AUDIO_ID_LIST.size()){
-                    currentItemNum = 0;
-                  }
-              }else{
-                  currentItemNum ++;
-                  if(currentItemNum >= AUDIO_URL_LIST.size()){
-                    currentItemNum = 0;
-                  }
-              }
-
-              AISDK_ERROR(LX("responsePlayControl").d("currentItemNum", currentItemNum));
+              m_playlist.skipForward();
+              AISDK_ERROR(LX("responsePlayControl").d("currentItemNum", m_playlist.getCurrentIndex()));
               m_executor.submit([this, info]() { executeHandle(info); });
         }else if(m_operation == "PREVIOUS"){
               flag_playControl_pause = 0; 
-
-              if(enable_kugou_resources == 1){
-                //kugou
-                  if(currentItemNum == 0){
-                      currentItemNum = AUDIO_ID_LIST.size() - 2 ;
-                  }else{
-                      currentItemNum = currentItemNum - 2; 
-                  }
-
-              }else{//situo
-                  if(currentItemNum == 0){
-                      currentItemNum = AUDIO_URL_LIST.size() - 1 ;
-                  }else{
-                      currentItemNum --; 
-                  }
-              }
-
-              AISDK_ERROR(LX("responsePlayControl").d("currentItemNum", currentItemNum));
+              m_playlist.skipBack();
+              AISDK_ERROR(LX("responsePlayControl").d("currentItemNum", m_playlist.getCurrentIndex()));
               m_executor.submit([this, info]() { executeHandle(info); });
         }else if(m_operation == "SINGLE_LOOP"){
-              enable_single_loop = 1;
+              m_playlist.setSingleLoop(true);
               AISDK_INFO(LX("responsePlayControl").d("SINGLE_LOOP","success"));
         }else if(m_operation == "CLOSE_SINGLE_LOOP"){
-              enable_single_loop = 0;  
+              m_playlist.setSingleLoop(false);
               AISDK_INFO(LX("responsePlayControl").d("CLOSE_SINGLE_LOOP","success"));        
         }else if(m_operation == "LIST_LOOP"){
-              enable_list_loop = 1;
+              m_playlist.setListLoop(true);
               AISDK_INFO(LX("responsePlayControl").d("LIST_LOOP","success"));
         }else if(m_operation == "LIST_ORDER"){
-              enable_list_loop = 0;
-              enable_single_loop = 0;
+              m_playlist.setListLoop(false);
+              m_playlist.setSingleLoop(false);
               AISDK_INFO(LX("responsePlayControl").d("LIST_ORDER","success"));
         }else{
             
               AISDK_ERROR(LX("responsePlayControl").d("operation","null"));
         }
         
+        if(    m_operation == "SINGLE_LOOP" 
+            || m_operation == "CLOSE_SINGLE_LOOP" 
+            || m_operation == "LIST_LOOP" 
+            || m_operation == "LIST_ORDER" ){
+              // What follows the current item may have changed.
+              m_executor.submit([this]() {
+                  discardQueuedItem();
+                  queueFollowingItem();
+              });
+        }
+        
         info->result->setCompleted();  
         AISDK_INFO(LX("responsePlayControl").d("m_operation",m_operation)
                                             .d("flag_playControl_pause",flag_playControl_pause)
-                                            .d("enable_list_loop",enable_list_loop)
-                                            .d("enable_single_loop",enable_single_loop)
-                                            .d("currentItemNum",currentItemNum));
+                                            .d("enable_list_loop",m_playlist.isListLoop())
+                                            .d("enable_single_loop",m_playlist.isSingleLoop())
+                                            .d("currentItemNum",m_playlist.getCurrentIndex()));
 
 }
 
 void ResourcesPlayer::executePreHandleAfterValidation(std::shared_ptr<DirectiveInfo> info) {
 	/// To-Do parse tts url and insert resourcesInfo map
 #ifdef ENABLE_SOUNDAI_ASR
-        auto data = info->directive->getData();
-        Json::CharReaderBuilder readerBuilder;
-        JSONCPP_STRING errs;
-        Json::Value root;
-        std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
-        if (!reader->parse(data.c_str(), data.c_str()+data.length(), &root, &errs)) {
+        auto& root = info->directive->getDataValue();
+        if (!root.isObject()) {
             AISDK_ERROR(LX("executePreHandleAfterValidation").d("reason", "parseDataKeyError"));
             return;
         }
@@ -689,45 +628,38 @@ void ResourcesPlayer::executePreHandleAfterValidation(std::shared_ptr<DirectiveI
         info->url = url;
 #else	
 
-        auto dateMessage = info->directive->getData();
-        Json::CharReaderBuilder readerBuilder;
-        JSONCPP_STRING errs;
-        Json::Value root;
-        std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
-        if (!reader->parse(dateMessage.c_str(), dateMessage.c_str()+dateMessage.length(), &root, &errs)) {
+        auto& root = info->directive->getDataValue();
+        if (!root.isObject()) {
             AISDK_ERROR(LX("executePreHandleAfterValidation").d("reason", "parseDataKeyError"));
             return;
         }
-        Json::Value audiolist = root["audio_list"][0];
+        auto& audiolist = root["audio_list"][0];
         
         if(audiolist.isMember("itemid")){
             //kugou resources     
             AISDK_INFO(LX("executePreHandleAfterValidation").d("RESOURCES_FROM", "KuGou"));
-            enable_kugou_resources = true;
             m_kugouUserToken = root["kugouUserToken"].asString();
             m_kugouUserId = root["kugouUserId"].asString();
             AISDK_INFO(LX("handleDirective").d("m_kugouUserToken", m_kugouUserToken));
             AISDK_INFO(LX("handleDirective").d("m_kugouUserId", m_kugouUserId));
 
-            AnalysisAudioIdForResourcesPlayer(info, AUDIO_ID_LIST);
-            AISDK_DEBUG5(LX("AUDIO_ID_LIST").d("size",  AUDIO_ID_LIST.size()));
+            std::vector<Playlist::Item> items;
+            AnalysisAudioIdForResourcesPlayer(info, items);
+            m_playlist.reset(items, true);
+            AISDK_DEBUG5(LX("executePreHandleAfterValidation").d("playlistSize",  items.size()));
             
         }else{
             //stormorai resources 
             AISDK_INFO(LX("executePreHandleAfterValidation").d("RESOURCES_FROM", "Stormorai or others"));
-            enable_kugou_resources = false;
-            cJSON* json = NULL, *json_data = NULL;
-            (void )json;
-            (void )json_data;
-            json_data = cJSON_Parse(dateMessage.c_str());
-            AnalysisNlpDataForResourcesPlayer(json_data, AUDIO_URL_LIST);
-            AISDK_DEBUG(LX("AUDIO_URL_LIST").d("size:",  AUDIO_URL_LIST.size()));
-            for(std::size_t i = 0; i< AUDIO_URL_LIST.size(); i++) {
+            std::vector<Playlist::Item> items;
+            AnalysisNlpDataForResourcesPlayer(root, items);
+            m_playlist.reset(items, false);
+            AISDK_DEBUG(LX("executePreHandleAfterValidation").d("playlistSize",  items.size()));
+            for(std::size_t i = 0; i< items.size(); i++) {
                 AISDK_DEBUG3(LX("executePreHandleAfterValidation")
-                    .d("AUDIO_URL_LIST[i]", i+1 )
-                    .d("audio_url",  AUDIO_URL_LIST.at(i)));
+                    .d("item", i+1 )
+                    .d("audio_url",  items[i].url));
             }
-            cJSON_Delete(json_data); 
         }       
  
 
@@ -760,6 +692,9 @@ void ResourcesPlayer::executePreHandle(std::shared_ptr<DirectiveInfo> info) {
         std::string operation;
         AnalysisNlpDataForPlayControl(info, operation);
         AISDK_ERROR(LX("executePreHandle").d("operation", operation));
+        if(operation == "PAUSE" || operation == "STOP"){
+            abandonTrackUrlLookups(false);
+        }
         if(    operation == "PAUSE" 
             || operation == "STOP" 
             || operation == "CLOSE_SINGLE_LOOP" 
@@ -769,28 +704,26 @@ void ResourcesPlayer::executePreHandle(std::shared_ptr<DirectiveInfo> info) {
             || operation == "LIST_ORDER" ){
                  return;
         }
+        // Skipping: the track being looked up won't be played, but the ones after it may be.
+        abandonTrackUrlLookups(false);
+        discardQueuedItem();
         if( !m_resourcesPlayer->stop(m_mediaSourceId)){
             AISDK_ERROR(LX("executePreHandle").d("stop","failed"));
         }
     }else if(info->directive->getDomain() == RESOURCESNAME){
         //initialization parameters 
-        AUDIO_URL_LIST.clear();
-        AUDIO_ID_LIST.clear();
+        abandonTrackUrlLookups(true);
+        discardQueuedItem();
+        m_playlist.clear();
         flag_playControl_pause = 0 ;
-        currentItemNum = 0;
-        enable_single_loop = 0;
-        enable_list_loop = 0; 
 
         if( !m_resourcesPlayer->stop(m_mediaSourceId)){
             AISDK_ERROR(LX("executePreHandle").d("stop","failed"));
         }
 
         AISDK_DEBUG5(LX("executePreHandle")
-            .d(" initialization parameters ", "AUDIO_URL_LIST cleared ")
-            .d(" flag_playControl_pause ", flag_playControl_pause)
-            .d(" currentItemNum ", currentItemNum)
-            .d(" enable_list_loop ", enable_list_loop)
-            .d(" enable_single_loop ", enable_single_loop));
+            .d(" initialization parameters ", "playlist cleared ")
+            .d(" flag_playControl_pause ", flag_playControl_pause));
         executePreHandleAfterValidation(info);
     }
 
@@ -917,14 +850,21 @@ void ResourcesPlayer::executeStateChange() {
 }
 
 
-void ResourcesPlayer::executeTrackChanged(FocusState newTrace){
+void ResourcesPlayer::executeTrackChanged(FocusState newTrace, MixingBehavior behavior){
     if(m_currentFocus == newTrace){
         AISDK_ERROR(LX("executeTrackChanged").d("reason", "m_currentFocus == newTrace"));
         return;
     }
              
     m_currentFocus = newTrace;
-    AISDK_INFO(LX("executeTrackChanged").d("newTrace", newTrace));
+    AISDK_INFO(LX("executeTrackChanged").d("newTrace", newTrace).d("behavior", behavior));
+    // Back in the foreground or done: bring a ducked player back to full volume.
+    if (m_isDucked && FocusState::BACKGROUND != newTrace) {
+        auto rampDuration = FocusState::FOREGROUND == newTrace ? DUCK_RAMP_DURATION : std::chrono::milliseconds::zero();
+        m_resourcesPlayer->setGain(1.0f, rampDuration);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isDucked = false;
+    }
     switch (newTrace) {
     case FocusState::FOREGROUND:
        switch (m_currentState) {
@@ -932,66 +872,25 @@ void ResourcesPlayer::executeTrackChanged(FocusState newTrace){
         case  ResourcesPlayerObserverInterface::ResourcesPlayerState::STOPPED:             
         case  ResourcesPlayerObserverInterface::ResourcesPlayerState::FINISHED: 
             {
-                if(enable_kugou_resources == true){
-                    
-                        if(AUDIO_ID_LIST.empty()){
-                           AISDK_ERROR(LX("executeTrackChanged").d("reason", "AUDIO_ID_LIST is null"));
-                           return;
-                        }
+                if(m_playlist.empty()){
+                    AISDK_ERROR(LX("executeTrackChanged").d("reason", "playlist is null"));
+                    return;
+                }
+                Playlist::Item item;
+                if(!m_playlist.getCurrentItem(&item)){
+                    AISDK_INFO(LX("executeTrackChanged").d("reason", "End of Playing List!"));
+                    break;
+                }
+                if(m_playlist.isKuGou()){
                         AISDK_INFO(LX("executeTrackChanged").d("playKuGouResourceItemID", "play type-->-->[kugou]-->-->【1】"));
-                        if(currentItemNum >= AUDIO_ID_LIST.size()){
-                            if(enable_list_loop == 1){
-                                currentItemNum = 0;
-                            }else{
-                                if( !m_resourcesPlayer->stop(m_mediaSourceId)){
-                                AISDK_ERROR(LX("executeTrackChanged").d("stop","failed"));
-                                }
-                                break;
-                            }
-                        }
-                        TryTheNextItem:
-                        AISDK_INFO(LX("playKuGouResourceItemID").d("currentItemNum", (currentItemNum / 2)));
-                        int val = playKuGouResourceItemID(AUDIO_ID_LIST.at(currentItemNum), AUDIO_ID_LIST.at(currentItemNum+1));  
-                        if(val != 0){
-                           AISDK_INFO(LX("executeTrackChanged").d("playKuGouResourceItemID", "play type-->-->[kugou]-->-->【2】"));
-                           currentItemNum = currentItemNum + 2;
-                           if(currentItemNum >= AUDIO_ID_LIST.size()){
-                                if(enable_list_loop == 1){
-                                    currentItemNum = 0;
-                                }else{
-                                    if( !m_resourcesPlayer->stop(m_mediaSourceId)){
-                                    AISDK_ERROR(LX("executeTrackChanged").d("stop","failed"));
-                                    }
-                                    break;
-                                } 
-                           }                           
-                           goto TryTheNextItem;
-                        }
+                        AISDK_INFO(LX("startKuGouItem").d("currentItemNum", m_playlist.getCurrentIndex()));
+                        startKuGouItem(m_playlist.size());
 
                 }else{
-                
-                        if(AUDIO_URL_LIST.empty()){
-                           AISDK_ERROR(LX("executeTrackChanged").d("reason", "AUDIO_URL_LIST is null"));
-                           return;
-                        }
                         AISDK_INFO(LX("executeTrackChanged").d("playResourceItem", "play type-->-->[Not kugou resources]-->-->【1】"));
-                        if(currentItemNum >= AUDIO_URL_LIST.size()){
-                            if(enable_list_loop == 1){
-                                currentItemNum = 0;
-                            }else{
-                                if( !m_resourcesPlayer->stop(m_mediaSourceId)){
-                                AISDK_ERROR(LX("executeTrackChanged").d("stop","failed"));
-                                }
-                                break;
-                            }
-
-                        }
-                        AISDK_INFO(LX("playResourceItem").d("currentItemNum", currentItemNum));
-                        playResourceItem(AUDIO_URL_LIST.at(currentItemNum));   
+                        AISDK_INFO(LX("playResourceItem").d("currentItemNum", m_playlist.getCurrentIndex()));
+                        playResourceItem(item.url);   
                 }
-                
-
-
             }
             break;
         case ResourcesPlayerObserverInterface::ResourcesPlayerState::PLAYING:
@@ -1019,6 +918,13 @@ void ResourcesPlayer::executeTrackChanged(FocusState newTrace){
             
             break;
          case ResourcesPlayerObserverInterface::ResourcesPlayerState::PLAYING:
+            // Keep the stream open and play on quietly if allowed; a player which can't change its gain pauses.
+            if (MixingBehavior::MAY_DUCK == behavior && m_resourcesPlayer->setGain(DUCKED_GAIN, DUCK_RAMP_DURATION)) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_isDucked = true;
+                m_waitOnStateChange.notify_one();
+                break;
+            }
             if( !m_resourcesPlayer->pause(m_mediaSourceId)){
                 AISDK_ERROR(LX("executeTrackChanged").d("pause","failed"));
             }
@@ -1034,8 +940,16 @@ void ResourcesPlayer::executeTrackChanged(FocusState newTrace){
 }
 
 
-void ResourcesPlayer::executePlaybackStarted() {
-	AISDK_INFO(LX("executePlaybackStarted"));
+void ResourcesPlayer::executePlaybackStarted(SourceId id) {
+	AISDK_INFO(LX("executePlaybackStarted").d("callbackSourceId", id));
+    if (id != m_mediaSourceId) {
+        // Left behind by a source which has been replaced since.
+        AISDK_WARN(LX("executePlaybackStartedIgnored")
+                       .d("reason", "mismatchSourceId")
+                       .d("callbackSourceId", id)
+                       .d("sourceId", m_mediaSourceId));
+        return;
+    }
     if(m_currentState != ResourcesPlayerObserverInterface::ResourcesPlayerState::PLAYING ){
         {
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -1050,6 +964,11 @@ void ResourcesPlayer::executePlaybackStopped(){
 	AISDK_INFO(LX("executePlaybackStopped"));
 
     resetMediaSourceId();
+    {
+        // Stopping the player drops what was queued.
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_queuedSourceId = MediaPlayerInterface::ERROR;
+    }
 
     switch (m_currentState)
         {
@@ -1067,49 +986,38 @@ void ResourcesPlayer::executePlaybackStopped(){
         case ResourcesPlayerObserverInterface::ResourcesPlayerState::FINISHED:
         case ResourcesPlayerObserverInterface::ResourcesPlayerState::STOPPED:
         case ResourcesPlayerObserverInterface::ResourcesPlayerState::IDLE:
-#if 0            
-            if(AUDIO_URL_LIST.empty() && AUDIO_ID_LIST.empty() && m_isAlreadyStopping != false ){
-                 AISDK_INFO(LX("executePlaybackFinished").d("reason", "audioUrlList and audioIDList is Null"));
-                 if(m_currentFocus != FocusState::NONE){
-                    m_trackManager->releaseChannel(CHANNEL_NAME, shared_from_this());
-                 }
-            }else{
-
-                if(enable_kugou_resources == true){
-                     AISDK_DEBUG5(LX("executeTrackChanged").d("playKuGouResourceItemID", "play type----->2"));
-                     if(currentItemNum >= AUDIO_ID_LIST.size()){
-                         //currentItemNum = 0;
-                         if( !m_resourcesPlayer->stop(m_mediaSourceId)){
-                             AISDK_ERROR(LX("executeTrackChanged").d("stop","failed"));
-                         }
-
-                         break;
-                     }
-                     playKuGouResourceItemID(AUDIO_ID_LIST.at(currentItemNum));  
-
-                }else{
-                     // playNextItem();
-                     AISDK_DEBUG5(LX("executePlaybackStopped").d("playResourceItem", "play type----->2"));
-                     if(currentItemNum >= AUDIO_URL_LIST.size()){
-                        //currentItemNum = 0;
-                         if( !m_resourcesPlayer->stop(m_mediaSourceId)){
-                             AISDK_ERROR(LX("executeTrackChanged").d("stop","failed"));
-                         }
-
-                        break;
-                     }
-                     playResourceItem(AUDIO_URL_LIST.at(currentItemNum));
-                }
-
-            }
-#endif
         break;
             
         }
 }
 
-void ResourcesPlayer::executePlaybackFinished() {
-	AISDK_INFO(LX("executePlaybackFinished"));
+void ResourcesPlayer::executePlaybackFinished(SourceId id) {
+	AISDK_INFO(LX("executePlaybackFinished").d("callbackSourceId", id));
+    if (id != m_mediaSourceId) {
+        // Left behind by a source which has been replaced since.
+        AISDK_WARN(LX("executePlaybackFinishedIgnored")
+                       .d("reason", "mismatchSourceId")
+                       .d("callbackSourceId", id)
+                       .d("sourceId", m_mediaSourceId));
+        return;
+    }
+    bool wentOn = false;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (MediaPlayerInterface::ERROR != m_queuedSourceId) {
+            adoptQueuedItemLocked();
+            wentOn = true;
+        }
+    }
+    if (wentOn) {
+        // The player has gone straight on with the queued item, so playback never stopped.
+        if (m_playlist.isKuGou()) {
+            prefetchKuGouItems(m_playlist.getCurrentIndex());
+        }
+        queueFollowingItem();
+        return;
+    }
+
     std::shared_ptr<ResourcesDirectiveInfo> infotest;
     if(m_currentState != ResourcesPlayerObserverInterface::ResourcesPlayerState::FINISHED){
          if (!m_attachmentReader) {
@@ -1123,83 +1031,28 @@ void ResourcesPlayer::executePlaybackFinished() {
          
          resetMediaSourceId();
          
-         //Play only once when the audio resource is just one.
-         if(AUDIO_URL_LIST.size() == 1 ) {
-             AUDIO_URL_LIST.clear();
-             AISDK_INFO(LX("executePlaybackFinished").d("reason", "AUDIO_URL_LIST.size=1"));
-         }
-         if(AUDIO_ID_LIST.size() == 1 ) {
-             AUDIO_ID_LIST.clear();
-             AISDK_INFO(LX("executePlaybackFinished").d("reason", "AUDIO_ID_LIST.size=1"));
-         }   
-         
-         
-         if(AUDIO_URL_LIST.empty() && AUDIO_ID_LIST.empty()){
-               AISDK_INFO(LX("executePlaybackFinished").d("reason", "audioUrlListNull"));
+         if(!m_playlist.advance()){
+               AISDK_INFO(LX("executePlaybackFinished").d("reason", "End of Playing List!"));
                if( !m_resourcesPlayer->stop(m_mediaSourceId)){
                    AISDK_ERROR(LX("executePlaybackFinished").d("stop","failed"));
                }
-
-               
+               return;
+         }
+         if(m_playlist.isSingleLoop()){
+             AISDK_INFO(LX("executePlaybackFinished").d(" playResourceItem", "enter to single_loop"));
+         }
+         if(m_playlist.isKuGou()) {
+             AISDK_INFO(LX("executePlaybackFinished").d("playKuGouResourceItemID", "play type-->-->[kugou]-->-->【3】"));
+             AISDK_INFO(LX("startKuGouItem").d("currentItemNum", m_playlist.getCurrentIndex()));
+             startKuGouItem(m_playlist.size());
          }else{
-              if(enable_kugou_resources == true) {
-                  AISDK_INFO(LX("executePlaybackFinished").d("playKuGouResourceItemID", "play type-->-->[kugou]-->-->【3】"));
-                  
-                  TryAgain:
-                  currentItemNum = currentItemNum + 2;
-                  if(enable_single_loop == 1 ){
-                      currentItemNum = currentItemNum - 2;
-                      AISDK_INFO(LX("executePlaybackFinished").d(" playKuGouResourceItemID", "enter to single_loop")
-                                                                .d(" enable_single_loop", enable_single_loop));
-                    }
-                  if(currentItemNum >= AUDIO_ID_LIST.size()){
-                       if(enable_list_loop == 1){
-                           currentItemNum = 0;
-                       }else{
-                           if( !m_resourcesPlayer->stop(m_mediaSourceId)){
-                           AISDK_ERROR(LX("executePlaybackFinished").d("stop","failed"));
-                           }
-                           AISDK_INFO(LX("executePlaybackFinished").d("reason", "End of Playing List!"));
-                           return;
-                       } 
-                  }
-                   AISDK_INFO(LX("playKuGouResourceItemID").d("currentItemNum", (currentItemNum / 2)));
-                  int val = playKuGouResourceItemID(AUDIO_ID_LIST.at(currentItemNum), AUDIO_ID_LIST.at(currentItemNum+1));
-                  if(val != 0){
-                     AISDK_INFO(LX("executePlaybackFinished").d("playKuGouResourceItemID", "play type-->-->[kugou]-->-->【4】"));                          
-                     goto TryAgain;
-                  }                  
-         
-              }else{
-                  // playNextItem();
-                  AISDK_INFO(LX("executePlaybackFinished").d("playResourceItem", "play type-->-->[Not kugou resources]-->-->【3】"));
-                  currentItemNum ++;
-                  if(enable_single_loop == 1 ){
-                      currentItemNum --;
-                      AISDK_INFO(LX("executePlaybackFinished").d(" playResourceItem", "enter to single_loop")
-                                                                .d(" enable_single_loop", enable_single_loop));
-                    }
-                  if(currentItemNum >= AUDIO_URL_LIST.size()){
-                        if(enable_list_loop == 1){
-                            currentItemNum = 0;
-                        }else{
-                            if( !m_resourcesPlayer->stop(m_mediaSourceId)){
-                            AISDK_ERROR(LX("executePlaybackFinished").d("stop","failed"));
-                            }
-                            AISDK_INFO(LX("executePlaybackFinished").d("reason", "End of Playing List!"));
-                            return;
-                        }                 
-                  }
-                 AISDK_INFO(LX("playResourceItem").d("currentItemNum", currentItemNum));
-                 playResourceItem(AUDIO_URL_LIST.at(currentItemNum));
-              }
-         
+             AISDK_INFO(LX("executePlaybackFinished").d("playResourceItem", "play type-->-->[Not kugou resources]-->-->【3】"));
+             Playlist::Item item;
+             m_playlist.getCurrentItem(&item);
+             AISDK_INFO(LX("playResourceItem").d("currentItemNum", m_playlist.getCurrentIndex()));
+             playResourceItem(item.url);
          }
-
     }
-
-
-
 }
 
 void ResourcesPlayer::executePlaybackPaused(){
@@ -1255,10 +1108,10 @@ void ResourcesPlayer::playNextItem() {
         m_mediaSourceId = m_resourcesPlayer->setSource(std::move(m_attachmentReader), &format);
     }else{
 
-         if( !AUDIO_URL_LIST.empty()){
-             AISDK_INFO(LX("playNextItem").d("AUDIO_URL", AUDIO_URL_LIST.at(0)));
-             m_mediaSourceId = m_resourcesPlayer->setSource(AUDIO_URL_LIST.at(0));
-             AUDIO_URL_LIST.pop_front();
+         Playlist::Item item;
+         if(m_playlist.getCurrentItem(&item) && !item.url.empty()){
+             AISDK_INFO(LX("playNextItem").d("AUDIO_URL", item.url));
+             m_mediaSourceId = m_resourcesPlayer->setSource(item.url);
          }
 
     }
@@ -1276,6 +1129,7 @@ void ResourcesPlayer::playNextItem() {
 
 void ResourcesPlayer::playResourceItem(std::string ResourceItem ) {
     AISDK_INFO(LX("playResourceItem").d("ResourceItem", ResourceItem));
+    discardQueuedItem();
     m_mediaSourceId = m_resourcesPlayer->setSource(ResourceItem);
     
      if (MediaPlayerInterface::ERROR == m_mediaSourceId) {
@@ -1286,39 +1140,263 @@ void ResourcesPlayer::playResourceItem(std::string ResourceItem ) {
      } else {
          // Execution of play is successful.
          m_isAlreadyStopping = false;
+         {
+             std::lock_guard<std::mutex> lock(m_queueMutex);
+             m_currentUrl = ResourceItem;
+         }
+         queueFollowingItem();
      }
 }
 
-int ResourcesPlayer::playKuGouResourceItemID(std::string ResourceItemID, std::string ResourceAlbumIdID){
-    AISDK_INFO(LX("playKuGouResourceItemID").d("ResourceItemID", ResourceItemID).d("ResourceAlbumIdID", ResourceAlbumIdID));
-    //KUGOU API   
-    char audioUrl[1024];
-    memset(audioUrl, 0x00, sizeof(audioUrl));
-    const char* aiuiUid = m_aiuiUid.c_str();
-    const char* appId = m_appId.c_str();
-    const char* appKey = m_appKey.c_str();
-    const char* clientDeviceId = m_clientDeviceId.c_str();
-    //const char* aiuiUid = "d13007661883";
-    //const char* appId = "5c3d8827";
-    //const char* appKey = "914a80c3399a12e993559f79ae898205";
-    //const char* clientDeviceId = "250b4299265f4bcbe0dc8d147aaa3aa";
-    const char* kugouUserId = m_kugouUserId.c_str();
-    const char* kugouUserToken = m_kugouUserToken.c_str();
-    const char* itemId = ResourceItemID.c_str();
-    const char* albumId = ResourceAlbumIdID.c_str();
-
-    //AISDK_INFO(LX("playKuGouResourceItemID").d("appKey", appKey).d("appId", appId));   //加密id
-    //AISDK_INFO(LX("playKuGouResourceItemID").d("aiuiUid", aiuiUid).d("clientDeviceId", clientDeviceId));
-    //AISDK_INFO(LX("playKuGouResourceItemID").d("kugouUserId", kugouUserId).d("kugouUserToken", kugouUserToken));
-
-    int val = getMusicUrl(aiuiUid, appId, appKey, kugouUserId, kugouUserToken, clientDeviceId, itemId, albumId, audioUrl);
-    if(val != 0 || strlen(audioUrl) == 0 ){
-        AISDK_ERROR(LX("playKuGouResourceItemID").d("getMusicUrl", "NULL"));
-        return -1;
-    }else{
-        playResourceItem(std::string (audioUrl));
+void ResourcesPlayer::startKuGouItem(size_t attemptsLeft) {
+    const size_t itemNum = m_playlist.getCurrentIndex();
+    if (itemNum >= m_playlist.size()) {
+        AISDK_ERROR(LX("startKuGouItemFailed").d("reason", "noSuchItem").d("currentItemNum", itemNum));
+        return;
+    }
+    if (!m_trackUrlResolver) {
+        AISDK_ERROR(LX("startKuGouItemFailed").d("reason", "shutDown"));
+        return;
+    }
+    const uint64_t generation = m_lookupGeneration;
+    auto callback = [this, generation, itemNum, attemptsLeft](const TrackUrlResolver::Result& result) {
+        m_executor.submit([this, generation, itemNum, attemptsLeft, result]() {
+            executeTrackUrlResolved(generation, itemNum, attemptsLeft, result);
+        });
+    };
+
+    std::shared_ptr<TrackUrlResolver::Lookup> lookup;
+    {
+        std::lock_guard<std::mutex> lock(m_lookupMutex);
+        auto it = m_prefetchedLookups.find(itemNum);
+        if (m_prefetchedLookups.end() != it) {
+            auto& prefetched = it->second;
+            bool fresh = std::chrono::steady_clock::now() - prefetched.startTime < PREFETCH_MAX_AGE;
+            bool failed = prefetched.lookup->isDone() &&
+                          TrackUrlResolver::Status::SUCCESS != prefetched.lookup->getFuture().get().status;
+            if (fresh && !failed) {
+                lookup = prefetched.lookup;
+            }
+            m_prefetchedLookups.erase(it);
+        }
+        if (!lookup) {
+            lookup = m_trackUrlResolver->resolve(buildTrackLinkRequest(itemNum));
+        }
+        m_currentLookup = lookup;
+    }
+    AISDK_INFO(LX("startKuGouItem")
+                   .d("itemId", lookup->getRequest().itemId)
+                   .d("prefetched", lookup->isDone())
+                   .d("attemptsLeft", attemptsLeft));
+    // Runs the callback at once if the URL was looked up ahead of time.
+    lookup->setCallback(callback);
+}
+
+void ResourcesPlayer::executeRestartKuGouItem() {
+    if (MediaPlayerInterface::ERROR != m_mediaSourceId) {
+        // An item started in the meantime, e.g. for a new directive.
+        if (!m_resourcesPlayer->resume(m_mediaSourceId)) {
+            AISDK_ERROR(LX("executeRestartKuGouItem").d("resume", "failed"));
+        }
+        return;
+    }
+    if (m_playlist.getCurrentIndex() >= m_playlist.size()) {
+        AISDK_INFO(LX("executeRestartKuGouItem").d("reason", "endOfPlaylist"));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_lookupMutex);
+        if (m_currentLookup) {
+            AISDK_DEBUG0(LX("executeRestartKuGouItem").d("reason", "lookupInFlight"));
+            return;
+        }
+    }
+    AISDK_INFO(LX("executeRestartKuGouItem").d("currentItemNum", m_playlist.getCurrentIndex()));
+    startKuGouItem(m_playlist.size());
+}
+
+void ResourcesPlayer::executeTrackUrlResolved(
+    uint64_t generation,
+    size_t itemNum,
+    size_t attemptsLeft,
+    const TrackUrlResolver::Result& result) {
+    if (generation != m_lookupGeneration) {
+        AISDK_DEBUG0(LX("executeTrackUrlResolved").d("reason", "abandoned").d("itemNum", itemNum));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_lookupMutex);
+        m_currentLookup.reset();
+    }
+    if (TrackUrlResolver::Status::SUCCESS == result.status) {
+        // Look ahead first, so the item after this one can be queued as soon as it starts.
+        prefetchKuGouItems(itemNum);
+        playResourceItem(result.url);
+        return;
+    }
+
+    AISDK_ERROR(LX("executeTrackUrlResolved").d("reason", "lookupFailed").d("status", result.status)
+                                            .d("itemNum", itemNum));
+    if (!m_playlist.skipUnplayable()) {
+        if (!m_resourcesPlayer->stop(m_mediaSourceId)) {
+            AISDK_ERROR(LX("executeTrackUrlResolved").d("stop", "failed"));
+        }
+        return;
+    }
+    if (0 == attemptsLeft) {
+        AISDK_ERROR(LX("executeTrackUrlResolved").d("reason", "noPlayableItem"));
+        return;
+    }
+    startKuGouItem(attemptsLeft - 1);
+}
+
+TrackLinkRequest ResourcesPlayer::buildTrackLinkRequest(size_t itemNum) const {
+    TrackLinkRequest request;
+    request.aiuiUid = m_aiuiUid;
+    request.appId = m_appId;
+    request.appKey = m_appKey;
+    request.clientDeviceId = m_clientDeviceId;
+    request.kugouUserId = m_kugouUserId;
+    request.kugouUserToken = m_kugouUserToken;
+    Playlist::Item item;
+    if (m_playlist.getItem(itemNum, &item)) {
+        request.itemId = item.itemId;
+        request.albumId = item.albumId;
+    }
+    return request;
+}
+
+void ResourcesPlayer::prefetchKuGouItems(size_t itemNum) {
+    if (!m_trackUrlResolver) {
+        return;
+    }
+    std::map<size_t, PrefetchedLookup> upcoming;
+    for (auto next : m_playlist.getUpcomingIndices(itemNum, PREFETCH_ITEMS)) {
+        upcoming[next] = PrefetchedLookup();
+    }
+
+    std::lock_guard<std::mutex> lock(m_lookupMutex);
+    for (auto& entry : m_prefetchedLookups) {
+        auto it = upcoming.find(entry.first);
+        if (upcoming.end() != it) {
+            it->second = entry.second;
+        } else {
+            entry.second.lookup->cancel();
+        }
+    }
+    for (auto& entry : upcoming) {
+        if (!entry.second.lookup) {
+            entry.second.lookup = m_trackUrlResolver->resolve(buildTrackLinkRequest(entry.first));
+            entry.second.startTime = std::chrono::steady_clock::now();
+        }
+    }
+    m_prefetchedLookups.swap(upcoming);
+}
+
+void ResourcesPlayer::abandonTrackUrlLookups(bool dropPrefetched) {
+    ++m_lookupGeneration;
+    std::lock_guard<std::mutex> lock(m_lookupMutex);
+    if (m_currentLookup) {
+        m_currentLookup->cancel();
+        m_currentLookup.reset();
+    }
+    if (dropPrefetched) {
+        for (auto& entry : m_prefetchedLookups) {
+            entry.second.lookup->cancel();
+        }
+        m_prefetchedLookups.clear();
+    }
+}
+
+void ResourcesPlayer::queueFollowingItem() {
+    size_t itemNum = 0;
+    Playlist::Item item;
+    if (MediaPlayerInterface::ERROR == m_mediaSourceId || !m_playlist.getFollowingIndex(&itemNum) ||
+        !m_playlist.getItem(itemNum, &item)) {
+        return;
+    }
+    std::string currentUrl;
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        currentUrl = m_currentUrl;
+    }
+    if (itemNum == m_playlist.getCurrentIndex() && !currentUrl.empty()) {
+        // Single loop: what is playing plays again.
+        queueItem(itemNum, currentUrl);
+        return;
+    }
+    if (!m_playlist.isKuGou()) {
+        queueItem(itemNum, item.url);
+        return;
+    }
+
+    std::shared_ptr<TrackUrlResolver::Lookup> lookup;
+    {
+        std::lock_guard<std::mutex> lock(m_lookupMutex);
+        auto it = m_prefetchedLookups.find(itemNum);
+        if (m_prefetchedLookups.end() != it) {
+            lookup = it->second.lookup;
+        }
+    }
+    if (!lookup) {
+        // The item is looked up when it is reached instead.
+        return;
+    }
+    const uint64_t generation = m_lookupGeneration;
+    const SourceId sourceId = m_mediaSourceId;
+    lookup->setCallback([this, generation, sourceId, itemNum](const TrackUrlResolver::Result& result) {
+        if (TrackUrlResolver::Status::SUCCESS != result.status) {
+            return;
+        }
+        m_executor.submit([this, generation, sourceId, itemNum, result]() {
+            size_t followingNum = 0;
+            if (generation != m_lookupGeneration || sourceId != m_mediaSourceId ||
+                !m_playlist.getFollowingIndex(&followingNum) || followingNum != itemNum) {
+                AISDK_DEBUG0(LX("queueFollowingItem").d("reason", "abandoned").d("itemNum", itemNum));
+                return;
+            }
+            queueItem(itemNum, result.url);
+        });
+    });
+}
+
+void ResourcesPlayer::queueItem(size_t itemNum, const std::string& url) {
+    auto id = m_resourcesPlayer->setNextSource(url);
+    if (MediaPlayerInterface::ERROR == id) {
+        AISDK_INFO(LX("queueItemSkipped").d("reason", "notQueuedByPlayer").d("itemNum", itemNum));
+        return;
+    }
+    AISDK_INFO(LX("queueItem").d("itemNum", itemNum).d("sourceId", id));
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_queuedSourceId = id;
+    m_queuedItemNum = itemNum;
+    m_queuedUrl = url;
+}
+
+void ResourcesPlayer::discardQueuedItem() {
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if (MediaPlayerInterface::ERROR == m_queuedSourceId) {
+            return;
+        }
+        if (m_resourcesPlayer->clearNextSource()) {
+            m_queuedSourceId = MediaPlayerInterface::ERROR;
+            return;
+        }
+        // Too late: the player has gone on to it, and the callbacks saying so are still on their way.
+        adoptQueuedItemLocked();
     }
-    return 0;
+    if (m_playlist.isKuGou()) {
+        prefetchKuGouItems(m_playlist.getCurrentIndex());
+    }
+}
+
+void ResourcesPlayer::adoptQueuedItemLocked() {
+    AISDK_INFO(LX("adoptQueuedItem").d("sourceId", m_queuedSourceId).d("itemNum", m_queuedItemNum));
+    m_mediaSourceId = m_queuedSourceId;
+    m_playlist.setCurrentIndex(m_queuedItemNum);
+    m_currentUrl = m_queuedUrl;
+    m_queuedSourceId = MediaPlayerInterface::ERROR;
 }
 
 void ResourcesPlayer::startPlaying() {
@@ -1352,6 +1430,7 @@ void ResourcesPlayer::startPlaying() {
 
 void ResourcesPlayer::stopPlaying() {
 	AISDK_INFO(LX("stopPlaying"));
+    discardQueuedItem();
     if (MediaPlayerInterface::ERROR == m_mediaSourceId) {
 		AISDK_ERROR(LX("stopPlayingFailed").d("reason", "invalidMediaSourceId").d("mediaSourceId", m_mediaSourceId));
     } else if (m_isAlreadyStopping) {
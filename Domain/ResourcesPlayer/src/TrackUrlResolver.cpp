@@ -0,0 +1,315 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <Utils/Logging/Logger.h>
+
+#include "ResourcesPlayer/cJSON.h"
+#include "ResourcesPlayer/Md5Compute.h"
+#include "ResourcesPlayer/TrackUrlResolver.h"
+
+namespace aisdk {
+namespace domain {
+namespace resourcesPlayer {
+
+/// String to identify log entries originating from this file.
+static const std::string TAG{"TrackUrlResolver"};
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+const std::string TrackUrlResolver::DEFAULT_ENDPOINT = "http://content.xfyun.cn/music/tracklink";
+constexpr std::chrono::seconds TrackUrlResolver::DEFAULT_TIMEOUT;
+constexpr size_t TrackUrlResolver::DEFAULT_MAX_IN_FLIGHT;
+
+/// The query of a track link request, after the endpoint.
+static const char TRACK_LINK_QUERY[] =
+    "?&timestamp=%llu&deviceId=%s&token=%s&appId=%s&kugouUserId=%s&kugouUserToken=%s&clientId=%s&clientDeviceId=%s"
+    "&itemid=%s";
+
+/// The @c msg of a successful answer.
+static const std::string MSG_SUCCESS = "success";
+
+/// The @c msg of an answer for an item which may not be played.
+static const std::string MSG_NO_COPYRIGHT = "200102";
+
+/**
+ * Builds the URL of a signed track link request.
+ */
+static std::string buildTrackLinkUrl(const std::string& endpoint, const TrackLinkRequest& request) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    unsigned long long timeStamp = (unsigned long long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+
+    std::string token = request.appId + request.appKey + std::to_string(timeStamp);
+    char md5Token[MD5_STR_LEN + 1] = {'\0'};
+    compute_string_md5(
+        reinterpret_cast<unsigned char*>(const_cast<char*>(token.c_str())), token.size(), md5Token);
+
+    std::vector<char> query(
+        sizeof(TRACK_LINK_QUERY) + 32 + request.aiuiUid.size() + MD5_STR_LEN + 2 * request.appId.size() +
+        request.kugouUserId.size() + request.kugouUserToken.size() + request.clientDeviceId.size() +
+        request.itemId.size());
+    snprintf(
+        query.data(),
+        query.size(),
+        TRACK_LINK_QUERY,
+        timeStamp,
+        request.aiuiUid.c_str(),
+        md5Token,
+        request.appId.c_str(),
+        request.kugouUserId.c_str(),
+        request.kugouUserToken.c_str(),
+        request.appId.c_str(),
+        request.clientDeviceId.c_str(),
+        request.itemId.c_str());
+    std::string url = endpoint + query.data();
+    if (!request.albumId.empty()) {
+        url += "&albumid=" + request.albumId;
+    }
+    return url;
+}
+
+/**
+ * Reads the URL out of the answer of the track link service.
+ */
+static TrackUrlResolver::Result parseTrackLink(const std::string& body) {
+    TrackUrlResolver::Result result{TrackUrlResolver::Status::FAILED, ""};
+    cJSON* json = cJSON_Parse(body.c_str());
+    if (!json) {
+        AISDK_ERROR(LX("parseTrackLinkFailed").d("reason", "invalidJson"));
+        result.status = TrackUrlResolver::Status::INVALID_RESPONSE;
+        return result;
+    }
+    cJSON* msg = cJSON_GetObjectItem(json, "msg");
+    if (!msg || !msg->valuestring) {
+        AISDK_ERROR(LX("parseTrackLinkFailed").d("reason", "noMsg"));
+    } else if (MSG_SUCCESS == msg->valuestring) {
+        cJSON* items = cJSON_GetObjectItem(json, "result");
+        int size = items ? cJSON_GetArraySize(items) : 0;
+        for (int i = 0; i < size && result.url.empty(); ++i) {
+            cJSON* path = cJSON_GetObjectItem(cJSON_GetArrayItem(items, i), "audiopath");
+            if (path && path->valuestring) {
+                result.url = path->valuestring;
+            }
+        }
+        if (!result.url.empty()) {
+            result.status = TrackUrlResolver::Status::SUCCESS;
+        } else {
+            AISDK_ERROR(LX("parseTrackLinkFailed").d("reason", "noAudioPath"));
+        }
+    } else if (MSG_NO_COPYRIGHT == msg->valuestring) {
+        AISDK_ERROR(LX("parseTrackLinkFailed").d("error_code", msg->valuestring).d("reason", "noCopyright"));
+    } else {
+        AISDK_ERROR(LX("parseTrackLinkFailed").d("error_code", msg->valuestring));
+    }
+    cJSON_Delete(json);
+    return result;
+}
+
+TrackUrlResolver::Lookup::Lookup(
+    const TrackLinkRequest& request,
+    std::chrono::steady_clock::time_point deadline,
+    Callback callback) :
+        m_request{request},
+        m_deadline{deadline},
+        m_callback{callback},
+        m_cancelled{false},
+        m_settled{false},
+        m_future{m_promise.get_future().share()} {
+}
+
+const TrackLinkRequest& TrackUrlResolver::Lookup::getRequest() const {
+    return m_request;
+}
+
+std::shared_future<TrackUrlResolver::Result> TrackUrlResolver::Lookup::getFuture() const {
+    return m_future;
+}
+
+bool TrackUrlResolver::Lookup::isDone() const {
+    return std::future_status::ready == m_future.wait_for(std::chrono::seconds::zero());
+}
+
+void TrackUrlResolver::Lookup::cancel() {
+    m_cancelled = true;
+    if (settle(Result{Status::CANCELLED, ""})) {
+        AISDK_DEBUG0(LX("lookupCancelled").d("itemId", m_request.itemId));
+    }
+}
+
+void TrackUrlResolver::Lookup::setCallback(Callback callback) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_settled) {
+        m_callback = callback;
+        return;
+    }
+    lock.unlock();
+    auto result = m_future.get();
+    if (callback && Status::CANCELLED != result.status) {
+        callback(result);
+    }
+}
+
+bool TrackUrlResolver::Lookup::settle(const Result& result) {
+    Callback callback;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_settled) {
+            return false;
+        }
+        m_settled = true;
+        m_promise.set_value(result);
+        callback.swap(m_callback);
+    }
+    if (callback && Status::CANCELLED != result.status) {
+        callback(result);
+    }
+    return true;
+}
+
+std::unique_ptr<TrackUrlResolver> TrackUrlResolver::create(
+    std::shared_ptr<HttpClient> client,
+    const std::string& endpoint,
+    std::chrono::milliseconds timeout,
+    size_t maxInFlight) {
+    if (0 == maxInFlight) {
+        AISDK_ERROR(LX("createFailed").d("reason", "noLookupsInFlight"));
+        return nullptr;
+    }
+    if (!client) {
+        client = HttpClient::create();
+    }
+    return std::unique_ptr<TrackUrlResolver>(new TrackUrlResolver(client, endpoint, timeout, maxInFlight));
+}
+
+TrackUrlResolver::TrackUrlResolver(
+    std::shared_ptr<HttpClient> client,
+    const std::string& endpoint,
+    std::chrono::milliseconds timeout,
+    size_t maxInFlight) :
+        m_client{client},
+        m_endpoint{endpoint},
+        m_timeout{timeout},
+        m_queuedLookups(maxInFlight, 0) {
+    // Lookups spend their time waiting on the network, so they get threads of their own rather than a shared pool's.
+    for (size_t i = 0; i < maxInFlight; ++i) {
+        m_executors.emplace_back(new utils::threading::Executor(nullptr));
+    }
+}
+
+TrackUrlResolver::~TrackUrlResolver() {
+    cancelAll();
+    m_executors.clear();
+}
+
+std::shared_ptr<TrackUrlResolver::Lookup> TrackUrlResolver::resolve(
+    const TrackLinkRequest& request,
+    Callback callback) {
+    std::shared_ptr<Lookup> lookup(new Lookup(request, std::chrono::steady_clock::now() + m_timeout, callback));
+    size_t index = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_pending.begin(); it != m_pending.end();) {
+            auto pending = it->lock();
+            it = (!pending || pending->isDone()) ? m_pending.erase(it) : std::next(it);
+        }
+        m_pending.push_back(lookup);
+        for (size_t i = 1; i < m_queuedLookups.size(); ++i) {
+            if (m_queuedLookups[i] < m_queuedLookups[index]) {
+                index = i;
+            }
+        }
+        ++m_queuedLookups[index];
+    }
+    AISDK_DEBUG0(LX("resolve").d("itemId", request.itemId).d("executor", index));
+    m_executors[index]->submit([this, lookup, index]() { executeLookup(lookup, index); });
+    return lookup;
+}
+
+void TrackUrlResolver::cancelAll() {
+    std::list<std::weak_ptr<Lookup>> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending.swap(m_pending);
+    }
+    for (auto& weak : pending) {
+        if (auto lookup = weak.lock()) {
+            lookup->cancel();
+        }
+    }
+}
+
+TrackUrlResolver::Result TrackUrlResolver::fetch(
+    HttpClient* client,
+    const std::string& endpoint,
+    const TrackLinkRequest& request,
+    std::chrono::milliseconds timeout,
+    const std::atomic<bool>* cancelled) {
+    if (!client) {
+        AISDK_ERROR(LX("fetchFailed").d("reason", "nullClient"));
+        return Result{Status::FAILED, ""};
+    }
+    auto start = std::chrono::steady_clock::now();
+    HttpResponse response;
+    // The service takes its parameters in the query, but is asked with an empty POST as it always has been.
+    if (!client->post(buildTrackLinkUrl(endpoint, request), "application/json", "", &response, timeout, cancelled)) {
+        if (cancelled && *cancelled) {
+            return Result{Status::CANCELLED, ""};
+        }
+        if (std::chrono::steady_clock::now() - start >= timeout) {
+            AISDK_ERROR(LX("fetchFailed").d("reason", "timedOut").d("itemId", request.itemId));
+            return Result{Status::TIMED_OUT, ""};
+        }
+        AISDK_ERROR(LX("fetchFailed").d("reason", "requestFailed").d("itemId", request.itemId));
+        return Result{Status::FAILED, ""};
+    }
+    if (200 != response.status) {
+        AISDK_ERROR(LX("fetchFailed").d("reason", "unexpectedStatus").d("status", response.status));
+        return Result{Status::FAILED, ""};
+    }
+    return parseTrackLink(response.body);
+}
+
+void TrackUrlResolver::executeLookup(std::shared_ptr<Lookup> lookup, size_t executorIndex) {
+    auto start = std::chrono::steady_clock::now();
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(lookup->m_deadline - start);
+    Result result{Status::TIMED_OUT, ""};
+    if (!lookup->isDone() && left.count() > 0) {
+        result = fetch(m_client.get(), m_endpoint, lookup->m_request, left, &lookup->m_cancelled);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_queuedLookups[executorIndex];
+    }
+    if (lookup->settle(result)) {
+        AISDK_INFO(LX("lookupDone")
+                       .d("itemId", lookup->m_request.itemId)
+                       .d("status", result.status)
+                       .d("latency(ms)",
+                          std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::steady_clock::now() - start)
+                              .count()));
+    }
+}
+
+}  // namespace resourcesPlayer
+}  // namespace domain
+}  // namespace aisdk
@@ -32,7 +32,8 @@
 #include <ctype.h>
 #include "ResourcesPlayer/cJSON.h"
 
-static const char* ep;
+/* Per thread, as track links are parsed on several threads at once. */
+static thread_local const char* ep;
 
 const char* cJSON_GetErrorPtr(void)
 {
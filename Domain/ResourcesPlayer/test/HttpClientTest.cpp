@@ -0,0 +1,494 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ResourcesPlayer/HttpClient.h"
+
+namespace aisdk {
+namespace domain {
+namespace resourcesPlayer {
+namespace test {
+
+/// A host name only the test resolver knows.
+static const std::string TEST_HOST = "tracklink.test";
+
+/// A JSON body like the ones the track link service answers with.
+static const std::string TRACK_LINK_BODY = "{\"msg\":\"success\",\"result\":[{\"audiopath\":\"http://a/b.mp3\"}]}";
+
+/**
+ * What the loopback server answers a request with.
+ */
+struct Reply {
+    /// The bytes to send.
+    std::string bytes;
+    /// Whether to close the connection after sending them.
+    bool close;
+    /// Whether to send nothing at all, leaving the client waiting.
+    bool silent;
+};
+
+/**
+ * @return A reply with a body delimited by @c Content-Length.
+ */
+static Reply contentLengthReply(const std::string& body, const std::string& extraHeaders = "") {
+    return {"HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) +
+                "\r\n" + extraHeaders + "\r\n" + body,
+            false,
+            false};
+}
+
+/**
+ * @return @c body in the chunked transfer coding, in chunks of at most @c chunkSize bytes.
+ */
+static std::string chunked(const std::string& body, size_t chunkSize) {
+    std::string result;
+    char size[32];
+    for (size_t offset = 0; offset < body.size(); offset += chunkSize) {
+        std::string chunk = body.substr(offset, chunkSize);
+        snprintf(size, sizeof(size), "%zx", chunk.size());
+        result += std::string(size) + "\r\n" + chunk + "\r\n";
+    }
+    return result + "0\r\n\r\n";
+}
+
+/**
+ * An HTTP server on the loopback interface, run on one thread which polls all its connections.  It reads whole
+ * requests, counts them and the connections it accepts, and answers with whatever the handler returns.
+ */
+class LoopbackServer {
+public:
+    using Handler = std::function<Reply(const std::string& request)>;
+
+    explicit LoopbackServer(Handler handler) : m_handler{handler}, m_stop{false}, m_accepted{0}, m_port{0} {
+        m_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), length) == 0 && listen(m_listenFd, 16) == 0 &&
+            getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length) == 0) {
+            m_port = ntohs(address.sin_port);
+        }
+        m_thread = std::thread(&LoopbackServer::run, this);
+    }
+
+    ~LoopbackServer() {
+        m_stop = true;
+        m_thread.join();
+        for (auto& connection : m_connections) {
+            close(connection.first);
+        }
+        close(m_listenFd);
+    }
+
+    int getPort() const {
+        return m_port;
+    }
+
+    std::string getUrl(const std::string& target = "/music/tracklink?itemid=1") const {
+        return "http://127.0.0.1:" + std::to_string(m_port) + target;
+    }
+
+    int getAcceptedCount() const {
+        return m_accepted;
+    }
+
+    std::vector<std::string> getRequests() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_requests;
+    }
+
+private:
+    void run() {
+        while (!m_stop) {
+            std::vector<pollfd> fds;
+            fds.push_back({m_listenFd, POLLIN, 0});
+            for (auto& connection : m_connections) {
+                fds.push_back({connection.first, POLLIN, 0});
+            }
+            if (poll(fds.data(), fds.size(), 20) <= 0) {
+                continue;
+            }
+            if (fds[0].revents & POLLIN) {
+                int fd = accept(m_listenFd, nullptr, nullptr);
+                if (fd >= 0) {
+                    m_connections[fd] = "";
+                    ++m_accepted;
+                }
+            }
+            for (size_t i = 1; i < fds.size(); ++i) {
+                if (fds[i].revents) {
+                    serve(fds[i].fd);
+                }
+            }
+        }
+    }
+
+    void serve(int fd) {
+        char buffer[4096];
+        ssize_t size = recv(fd, buffer, sizeof(buffer), 0);
+        if (size <= 0) {
+            close(fd);
+            m_connections.erase(fd);
+            return;
+        }
+        std::string& pending = m_connections[fd];
+        pending.append(buffer, size);
+        auto headerEnd = pending.find("\r\n\r\n");
+        if (std::string::npos == headerEnd) {
+            return;
+        }
+        size_t bodySize = 0;
+        auto lengthHeader = pending.find("Content-Length: ");
+        if (std::string::npos != lengthHeader && lengthHeader < headerEnd) {
+            bodySize = std::stoul(pending.substr(lengthHeader + 16));
+        }
+        if (pending.size() < headerEnd + 4 + bodySize) {
+            return;
+        }
+        std::string request = pending.substr(0, headerEnd + 4 + bodySize);
+        pending.erase(0, request.size());
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_requests.push_back(request);
+        }
+        Reply reply = m_handler(request);
+        if (reply.silent) {
+            return;
+        }
+        send(fd, reply.bytes.data(), reply.bytes.size(), MSG_NOSIGNAL);
+        if (reply.close) {
+            close(fd);
+            m_connections.erase(fd);
+        }
+    }
+
+    Handler m_handler;
+    std::atomic<bool> m_stop;
+    std::atomic<int> m_accepted;
+    int m_listenFd;
+    int m_port;
+    std::map<int, std::string> m_connections;
+    std::mutex m_mutex;
+    std::vector<std::string> m_requests;
+    std::thread m_thread;
+};
+
+/**
+ * Feeds a response to a parser in pieces of @c pieceSize bytes.
+ *
+ * @return The number of bytes consumed.
+ */
+static size_t feedInPieces(HttpResponseParser* parser, const std::string& bytes, size_t pieceSize) {
+    size_t consumed = 0;
+    for (size_t offset = 0; offset < bytes.size(); offset += pieceSize) {
+        size_t size = std::min(pieceSize, bytes.size() - offset);
+        size_t used = parser->feed(bytes.data() + offset, size);
+        consumed += used;
+        if (used < size) {
+            break;
+        }
+    }
+    return consumed;
+}
+
+/// Verify URLs are split into host, port and target.
+TEST(HttpUrlTest, test_parse) {
+    HttpUrl url;
+    ASSERT_TRUE(HttpUrl::parse("http://content.xfyun.cn/music/tracklink?&timestamp=1&itemid=2", &url));
+    EXPECT_EQ("content.xfyun.cn", url.host);
+    EXPECT_EQ(80, url.port);
+    EXPECT_EQ("/music/tracklink?&timestamp=1&itemid=2", url.target);
+
+    ASSERT_TRUE(HttpUrl::parse("http://127.0.0.1:8080?a=b#top", &url));
+    EXPECT_EQ("127.0.0.1", url.host);
+    EXPECT_EQ(8080, url.port);
+    EXPECT_EQ("/?a=b", url.target);
+
+    EXPECT_FALSE(HttpUrl::parse("https://content.xfyun.cn/", &url));
+    EXPECT_FALSE(HttpUrl::parse("http://host:port/", &url));
+    EXPECT_FALSE(HttpUrl::parse("http:///path", &url));
+}
+
+/// Verify a response arriving a byte at a time is parsed the same as one arriving at once.
+TEST(HttpResponseParserTest, test_contentLengthByteAtATime) {
+    const std::string bytes = contentLengthReply(TRACK_LINK_BODY, "X-Test:  a \r\nX-Test: b\r\n").bytes;
+    HttpResponseParser parser;
+    EXPECT_EQ(bytes.size(), feedInPieces(&parser, bytes, 1));
+    ASSERT_EQ(HttpResponseParser::State::DONE, parser.getState());
+    EXPECT_TRUE(parser.isKeepAlive());
+    EXPECT_EQ(200, parser.getResponse().status);
+    EXPECT_EQ(TRACK_LINK_BODY, parser.getResponse().body);
+    EXPECT_EQ("a, b", parser.getResponse().getHeader("x-test"));
+    EXPECT_EQ("application/json", parser.getResponse().getHeader("CONTENT-TYPE"));
+}
+
+/// Verify chunked bodies are decoded, with chunk extensions and trailers, however the bytes are split.
+TEST(HttpResponseParserTest, test_chunked) {
+    std::string body(10000, 'x');
+    for (size_t i = 0; i < body.size(); ++i) {
+        body[i] = 'a' + i % 26;
+    }
+    std::string encoded = chunked(body, 777);
+    encoded.insert(encoded.find("\r\n"), ";name=value");
+    encoded.insert(encoded.size() - 2, "X-Trailer: 1\r\n");
+    const std::string bytes = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" + encoded;
+
+    for (size_t pieceSize : {static_cast<size_t>(1), static_cast<size_t>(5), static_cast<size_t>(4096), bytes.size()}) {
+        HttpResponseParser parser;
+        EXPECT_EQ(bytes.size(), feedInPieces(&parser, bytes, pieceSize)) << "pieces of " << pieceSize;
+        ASSERT_EQ(HttpResponseParser::State::DONE, parser.getState()) << "pieces of " << pieceSize;
+        EXPECT_TRUE(parser.isKeepAlive());
+        EXPECT_EQ(body, parser.getResponse().body) << "pieces of " << pieceSize;
+    }
+}
+
+/// Verify a body without a length runs to the end of the connection, which then can't be reused.
+TEST(HttpResponseParserTest, test_closeDelimited) {
+    HttpResponseParser parser;
+    const std::string bytes = "HTTP/1.0 200 OK\r\n\r\nhello";
+    EXPECT_EQ(bytes.size(), parser.feed(bytes.data(), bytes.size()));
+    EXPECT_EQ(HttpResponseParser::State::NEED_MORE, parser.getState());
+    parser.finish();
+    ASSERT_EQ(HttpResponseParser::State::DONE, parser.getState());
+    EXPECT_FALSE(parser.isKeepAlive());
+    EXPECT_EQ("hello", parser.getResponse().body);
+}
+
+/// Verify parsing stops at the end of the response, and skips interim responses.
+TEST(HttpResponseParserTest, test_stopsAtTheEnd) {
+    const std::string first = "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 204 No Content\r\nConnection: close\r\n\r\n";
+    const std::string bytes = first + "HTTP/1.1 200 OK\r\n";
+    HttpResponseParser parser;
+    EXPECT_EQ(first.size(), parser.feed(bytes.data(), bytes.size()));
+    ASSERT_EQ(HttpResponseParser::State::DONE, parser.getState());
+    EXPECT_EQ(204, parser.getResponse().status);
+    EXPECT_FALSE(parser.isKeepAlive());
+}
+
+/// Verify malformed responses are rejected.
+TEST(HttpResponseParserTest, test_errors) {
+    for (const std::string& bytes : {std::string("ICY 200 OK\r\n\r\n"),
+                                    std::string("HTTP/1.1 200 OK\r\nno colon\r\n\r\n"),
+                                    std::string("HTTP/1.1 200 OK\r\nContent-Length: -1\r\n\r\n"),
+                                    std::string("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n"),
+                                    std::string("HTTP/1.1 200 OK\r\n") + std::string(10000, 'a')}) {
+        HttpResponseParser parser;
+        parser.feed(bytes.data(), bytes.size());
+        EXPECT_EQ(HttpResponseParser::State::ERROR, parser.getState()) << bytes.substr(0, 60);
+    }
+
+    HttpResponseParser truncated;
+    const std::string bytes = "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nshort";
+    truncated.feed(bytes.data(), bytes.size());
+    truncated.finish();
+    EXPECT_EQ(HttpResponseParser::State::ERROR, truncated.getState());
+}
+
+/// Verify a body over the limit fails the parse however it is delimited, and one at the limit doesn't.
+TEST(HttpResponseParserTest, test_bodyTooLarge) {
+    const size_t limit = 1000;
+    const std::string atLimit(limit, 'x');
+    const std::string overLimit(limit + 1, 'x');
+    for (const std::string& bytes : {contentLengthReply(overLimit).bytes,
+                                    "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" + chunked(overLimit, 300),
+                                    "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" + chunked(overLimit, 2000),
+                                    "HTTP/1.0 200 OK\r\n\r\n" + overLimit}) {
+        HttpResponseParser parser(false, limit);
+        feedInPieces(&parser, bytes, 64);
+        EXPECT_EQ(HttpResponseParser::State::ERROR, parser.getState()) << bytes.substr(0, 60);
+        EXPECT_LE(parser.getResponse().body.size(), limit);
+    }
+
+    HttpResponseParser parser(false, limit);
+    const std::string bytes = contentLengthReply(atLimit).bytes;
+    EXPECT_EQ(bytes.size(), feedInPieces(&parser, bytes, 64));
+    ASSERT_EQ(HttpResponseParser::State::DONE, parser.getState());
+    EXPECT_EQ(atLimit, parser.getResponse().body);
+    EXPECT_GE(HttpResponseParser::DEFAULT_MAX_BODY_SIZE, TRACK_LINK_BODY.size());
+}
+
+/// Verify a large body fed in small pieces is parsed in time proportional to its size.
+TEST(HttpResponseParserTest, test_largeBodyInSmallPieces) {
+    const std::string body(8 * 1024 * 1024, 'x');
+    const std::string bytes = contentLengthReply(body).bytes;
+    auto start = std::chrono::steady_clock::now();
+    HttpResponseParser parser(false, body.size());
+    EXPECT_EQ(bytes.size(), feedInPieces(&parser, bytes, 512));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    ASSERT_EQ(HttpResponseParser::State::DONE, parser.getState());
+    EXPECT_EQ(body.size(), parser.getResponse().body.size());
+    EXPECT_LT(elapsed, std::chrono::seconds(2));
+}
+
+/// Verify consecutive requests to a host share one connection.
+TEST(HttpClientTest, test_connectionIsReused) {
+    LoopbackServer server([](const std::string&) { return contentLengthReply(TRACK_LINK_BODY); });
+    ASSERT_NE(0, server.getPort());
+    auto client = HttpClient::create();
+    for (int i = 0; i < 5; ++i) {
+        HttpResponse response;
+        ASSERT_TRUE(client->get(server.getUrl(), &response)) << "request " << i;
+        EXPECT_EQ(200, response.status);
+        EXPECT_EQ(TRACK_LINK_BODY, response.body);
+    }
+    EXPECT_EQ(1, server.getAcceptedCount());
+    EXPECT_EQ(5u, server.getRequests().size());
+    EXPECT_EQ(1u, client->getIdleConnectionCount());
+    EXPECT_NE(std::string::npos, server.getRequests()[0].find("GET /music/tracklink?itemid=1 HTTP/1.1\r\n"));
+}
+
+/// Verify chunked responses come back decoded, and leave the connection reusable.
+TEST(HttpClientTest, test_chunkedResponse) {
+    LoopbackServer server([](const std::string&) {
+        return Reply{"HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" + chunked(TRACK_LINK_BODY, 7), false, false};
+    });
+    auto client = HttpClient::create();
+    for (int i = 0; i < 2; ++i) {
+        HttpResponse response;
+        ASSERT_TRUE(client->get(server.getUrl(), &response));
+        EXPECT_EQ(TRACK_LINK_BODY, response.body);
+    }
+    EXPECT_EQ(1, server.getAcceptedCount());
+}
+
+/// Verify POST sends its body, as the track link request does.
+TEST(HttpClientTest, test_post) {
+    LoopbackServer server([](const std::string&) { return contentLengthReply("{}"); });
+    auto client = HttpClient::create();
+    HttpResponse response;
+    ASSERT_TRUE(client->post(server.getUrl("/post"), "application/json", "{\"a\":1}", &response));
+    auto request = server.getRequests().at(0);
+    EXPECT_EQ(0u, request.find("POST /post HTTP/1.1\r\n"));
+    EXPECT_NE(std::string::npos, request.find("Content-Type: application/json\r\n"));
+    EXPECT_NE(std::string::npos, request.find("Content-Length: 7\r\n"));
+    EXPECT_EQ("{\"a\":1}", request.substr(request.size() - 7));
+}
+
+/// Verify a connection the server closed while it was idle is replaced without the request failing.
+TEST(HttpClientTest, test_serverClosedIdleConnection) {
+    LoopbackServer server([](const std::string&) {
+        Reply reply = contentLengthReply(TRACK_LINK_BODY);
+        reply.close = true;
+        return reply;
+    });
+    auto client = HttpClient::create();
+    for (int i = 0; i < 3; ++i) {
+        HttpResponse response;
+        ASSERT_TRUE(client->get(server.getUrl(), &response)) << "request " << i;
+        EXPECT_EQ(TRACK_LINK_BODY, response.body);
+        // Give the close time to arrive before the next request.
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    EXPECT_EQ(3, server.getAcceptedCount());
+}
+
+/// Verify a response asking for the connection to be closed isn't pooled.
+TEST(HttpClientTest, test_connectionCloseIsHonoured) {
+    LoopbackServer server([](const std::string&) {
+        Reply reply = contentLengthReply(TRACK_LINK_BODY, "Connection: close\r\n");
+        reply.close = true;
+        return reply;
+    });
+    auto client = HttpClient::create();
+    HttpResponse response;
+    ASSERT_TRUE(client->get(server.getUrl(), &response));
+    EXPECT_EQ(0u, client->getIdleConnectionCount());
+}
+
+/// Verify lookups are cached for their TTL, and looked up again after it.
+TEST(HttpClientTest, test_dnsCacheTtl) {
+    LoopbackServer server([](const std::string&) { return contentLengthReply(TRACK_LINK_BODY); });
+    std::atomic<int> lookups{0};
+    auto resolver = [&lookups](const std::string& host, int port, std::vector<HttpAddress>* addresses) {
+        ++lookups;
+        return TEST_HOST == host && DnsCache::systemResolve("127.0.0.1", port, addresses);
+    };
+    const std::chrono::milliseconds ttl{200};
+    auto client = HttpClient::create(ttl, HttpClient::DEFAULT_IDLE_TIMEOUT, 0, resolver);
+    const std::string url = "http://" + TEST_HOST + ":" + std::to_string(server.getPort()) + "/";
+
+    HttpResponse response;
+    ASSERT_TRUE(client->get(url, &response));
+    ASSERT_TRUE(client->get(url, &response));
+    EXPECT_EQ(1, lookups);
+    // Nothing is pooled, so both requests connected and only the first looked the host up.
+    EXPECT_EQ(2, server.getAcceptedCount());
+    EXPECT_NE(std::string::npos, server.getRequests().at(0).find("Host: " + TEST_HOST + ":"));
+
+    std::this_thread::sleep_for(ttl + std::chrono::milliseconds(100));
+    ASSERT_TRUE(client->get(url, &response));
+    EXPECT_EQ(2, lookups);
+
+    EXPECT_FALSE(client->get("http://unknown.test/", &response));
+}
+
+/// Verify a server that never answers makes the request fail once its time is up.
+TEST(HttpClientTest, test_timeout) {
+    LoopbackServer server([](const std::string&) { return Reply{"", false, true}; });
+    auto client = HttpClient::create();
+    HttpResponse response;
+    const std::chrono::milliseconds timeout{300};
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(client->get(server.getUrl(), &response, timeout));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, timeout);
+    EXPECT_LT(elapsed, timeout * 3);
+    EXPECT_EQ(0u, client->getIdleConnectionCount());
+}
+
+/// Verify requests from several threads at once each get an answer.
+TEST(HttpClientTest, test_concurrentRequests) {
+    LoopbackServer server([](const std::string&) { return contentLengthReply(TRACK_LINK_BODY); });
+    auto client = HttpClient::create();
+    std::atomic<int> succeeded{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 10; ++j) {
+                HttpResponse response;
+                if (client->get(server.getUrl(), &response) && TRACK_LINK_BODY == response.body) {
+                    ++succeeded;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(40, succeeded);
+    EXPECT_LE(client->getIdleConnectionCount(), HttpClient::DEFAULT_MAX_IDLE_PER_HOST);
+}
+
+}  // namespace test
+}  // namespace resourcesPlayer
+}  // namespace domain
+}  // namespace aisdk
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ResourcesPlayer/Playlist.h"
+
+namespace aisdk {
+namespace domain {
+namespace resourcesPlayer {
+namespace test {
+
+/**
+ * Builds a playlist of items with URLs, or of KuGou items.
+ */
+static std::vector<Playlist::Item> items(size_t count, bool isKuGou) {
+    std::vector<Playlist::Item> result;
+    for (size_t i = 0; i < count; ++i) {
+        Playlist::Item item;
+        if (isKuGou) {
+            item.itemId = std::to_string(1000 + i);
+            item.albumId = "99";
+        } else {
+            item.url = "http://cdn.test/" + std::to_string(i) + ".mp3";
+        }
+        result.push_back(item);
+    }
+    return result;
+}
+
+/**
+ * Verify that playing on goes through the items in order and passes the end without list loop.
+ */
+TEST(PlaylistTest, test_advanceStopsAtEnd) {
+    Playlist playlist;
+    playlist.reset(items(3, false), false);
+    size_t following = 0;
+    ASSERT_TRUE(playlist.getFollowingIndex(&following));
+    EXPECT_EQ(1u, following);
+    EXPECT_TRUE(playlist.advance());
+    EXPECT_TRUE(playlist.advance());
+    EXPECT_EQ(2u, playlist.getCurrentIndex());
+    EXPECT_FALSE(playlist.getFollowingIndex(&following));
+    EXPECT_FALSE(playlist.advance());
+
+    Playlist::Item item;
+    EXPECT_FALSE(playlist.getCurrentItem(&item));
+    EXPECT_EQ(3u, playlist.getCurrentIndex());
+}
+
+/**
+ * Verify that list loop goes back to the first item, and single loop repeats the current one.
+ */
+TEST(PlaylistTest, test_loopModes) {
+    Playlist playlist;
+    playlist.reset(items(2, true), true);
+    playlist.setListLoop(true);
+    EXPECT_TRUE(playlist.advance());
+    EXPECT_TRUE(playlist.advance());
+    EXPECT_EQ(0u, playlist.getCurrentIndex());
+
+    playlist.setSingleLoop(true);
+    size_t following = 1;
+    ASSERT_TRUE(playlist.getFollowingIndex(&following));
+    EXPECT_EQ(0u, following);
+    EXPECT_TRUE(playlist.advance());
+    EXPECT_EQ(0u, playlist.getCurrentIndex());
+
+    // An item which can't be played is left behind even in single loop.
+    EXPECT_TRUE(playlist.skipUnplayable());
+    EXPECT_EQ(1u, playlist.getCurrentIndex());
+}
+
+/**
+ * Verify that a single item given by URL is played just once, while a single KuGou item may loop.
+ */
+TEST(PlaylistTest, test_singleUrlPlaysOnce) {
+    Playlist playlist;
+    playlist.reset(items(1, false), false);
+    playlist.setSingleLoop(true);
+    playlist.setListLoop(true);
+    EXPECT_FALSE(playlist.advance());
+
+    playlist.reset(items(1, true), true);
+    playlist.setSingleLoop(true);
+    EXPECT_TRUE(playlist.advance());
+    EXPECT_EQ(0u, playlist.getCurrentIndex());
+}
+
+/**
+ * Verify that skipping wraps around in both directions, also from past the end.
+ */
+TEST(PlaylistTest, test_skipWraps) {
+    Playlist playlist;
+    playlist.reset(items(3, false), false);
+    playlist.skipBack();
+    EXPECT_EQ(2u, playlist.getCurrentIndex());
+    playlist.skipForward();
+    EXPECT_EQ(0u, playlist.getCurrentIndex());
+
+    playlist.setCurrentIndex(2);
+    EXPECT_FALSE(playlist.advance());
+    playlist.skipBack();
+    EXPECT_EQ(2u, playlist.getCurrentIndex());
+    EXPECT_FALSE(playlist.advance());
+    playlist.skipForward();
+    EXPECT_EQ(0u, playlist.getCurrentIndex());
+}
+
+/**
+ * Verify that the items to look up ahead follow the loop modes and never include the item playing.
+ */
+TEST(PlaylistTest, test_upcomingIndices) {
+    Playlist playlist;
+    playlist.reset(items(3, true), true);
+    EXPECT_EQ(std::vector<size_t>({2}), playlist.getUpcomingIndices(1, 2));
+
+    playlist.setListLoop(true);
+    EXPECT_EQ(std::vector<size_t>({2, 0}), playlist.getUpcomingIndices(1, 2));
+    EXPECT_EQ(std::vector<size_t>({2, 0}), playlist.getUpcomingIndices(1, 5));
+
+    playlist.setSingleLoop(true);
+    EXPECT_TRUE(playlist.getUpcomingIndices(1, 2).empty());
+}
+
+/**
+ * Verify that a new playlist starts from its first item with both loop modes off.
+ */
+TEST(PlaylistTest, test_resetStartsOver) {
+    Playlist playlist;
+    playlist.reset(items(3, false), false);
+    playlist.setListLoop(true);
+    playlist.setSingleLoop(true);
+    playlist.setCurrentIndex(2);
+
+    playlist.reset(items(2, true), true);
+    EXPECT_TRUE(playlist.isKuGou());
+    EXPECT_FALSE(playlist.isListLoop());
+    EXPECT_FALSE(playlist.isSingleLoop());
+    EXPECT_EQ(0u, playlist.getCurrentIndex());
+    EXPECT_FALSE(playlist.setCurrentIndex(2));
+
+    Playlist::Item item;
+    ASSERT_TRUE(playlist.getCurrentItem(&item));
+    EXPECT_EQ("1000", item.itemId);
+    EXPECT_EQ("99", item.albumId);
+
+    playlist.clear();
+    EXPECT_TRUE(playlist.empty());
+    EXPECT_FALSE(playlist.getCurrentItem(&item));
+}
+
+}  // namespace test
+}  // namespace resourcesPlayer
+}  // namespace domain
+}  // namespace aisdk
@@ -0,0 +1,403 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "ResourcesPlayer/TrackUrlResolver.h"
+
+namespace aisdk {
+namespace domain {
+namespace resourcesPlayer {
+namespace test {
+
+/// How long the tests wait for something which should happen.
+static const std::chrono::seconds WAIT_TIMEOUT{5};
+
+/// A server latency far above anything a command should take.
+static const std::chrono::milliseconds SLOW_SERVER_LATENCY{1500};
+
+/// How long a cancel or a resolve() call may take, whatever the server latency.
+static const std::chrono::milliseconds COMMAND_LATENCY_BOUND{200};
+
+/**
+ * A mock of the track link service, which answers every request after an injectable latency with the URL
+ * "http://cdn.test/<itemid>.mp3".  Each connection is served on a thread of its own, so requests are answered
+ * concurrently, and the latency is spent in slices so the server stops promptly.
+ */
+class MockTrackLinkServer {
+public:
+    MockTrackLinkServer() : m_stop{false}, m_latency{0}, m_inFlight{0}, m_maxInFlight{0}, m_port{0} {
+        m_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), length) == 0 && listen(m_listenFd, 16) == 0 &&
+            getsockname(m_listenFd, reinterpret_cast<sockaddr*>(&address), &length) == 0) {
+            m_port = ntohs(address.sin_port);
+        }
+        m_acceptThread = std::thread(&MockTrackLinkServer::acceptLoop, this);
+    }
+
+    ~MockTrackLinkServer() {
+        m_stop = true;
+        m_acceptThread.join();
+        for (auto& thread : m_connectionThreads) {
+            thread.join();
+        }
+        close(m_listenFd);
+    }
+
+    std::string getEndpoint() const {
+        return "http://127.0.0.1:" + std::to_string(m_port) + "/music/tracklink";
+    }
+
+    void setLatency(std::chrono::milliseconds latency) {
+        m_latency = latency.count();
+    }
+
+    void setBody(const std::string& body) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = body;
+    }
+
+    int getMaxInFlight() const {
+        return m_maxInFlight;
+    }
+
+    std::vector<std::string> getRequests() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_requests;
+    }
+
+private:
+    void acceptLoop() {
+        while (!m_stop) {
+            pollfd fd{m_listenFd, POLLIN, 0};
+            if (poll(&fd, 1, 20) <= 0) {
+                continue;
+            }
+            int connection = accept(m_listenFd, nullptr, nullptr);
+            if (connection >= 0) {
+                m_connectionThreads.emplace_back(&MockTrackLinkServer::serve, this, connection);
+            }
+        }
+    }
+
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (!m_stop) {
+            size_t end = buffer.find("\r\n\r\n");
+            if (end == std::string::npos) {
+                pollfd pfd{fd, POLLIN, 0};
+                if (poll(&pfd, 1, 20) <= 0) {
+                    continue;
+                }
+                ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+                if (got <= 0) {
+                    break;
+                }
+                buffer.append(chunk, got);
+                continue;
+            }
+            // The client only ever sends empty bodies.
+            std::string request = buffer.substr(0, end);
+            buffer.erase(0, end + 4);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_requests.push_back(request);
+            }
+            int inFlight = ++m_inFlight;
+            int seen = m_maxInFlight;
+            while (inFlight > seen && !m_maxInFlight.compare_exchange_weak(seen, inFlight)) {
+            }
+            auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_latency);
+            while (!m_stop && std::chrono::steady_clock::now() < until) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+            --m_inFlight;
+            std::string reply = buildReply(request);
+            if (send(fd, reply.data(), reply.size(), MSG_NOSIGNAL) < 0) {
+                break;
+            }
+        }
+        close(fd);
+    }
+
+    std::string buildReply(const std::string& request) {
+        std::string body;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            body = m_body;
+        }
+        if (body.empty()) {
+            std::string itemId;
+            size_t start = request.find("&itemid=");
+            if (start != std::string::npos) {
+                start += strlen("&itemid=");
+                itemId = request.substr(start, request.find_first_of("& ", start) - start);
+            }
+            body = "{\"msg\":\"success\",\"result\":[{\"audiopath\":\"http://cdn.test/" + itemId + ".mp3\"}]}";
+        }
+        return "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+               std::to_string(body.size()) + "\r\n\r\n" + body;
+    }
+
+    int m_listenFd;
+    std::atomic<bool> m_stop;
+    std::atomic<long> m_latency;
+    std::atomic<int> m_inFlight;
+    std::atomic<int> m_maxInFlight;
+    int m_port;
+    std::mutex m_mutex;
+    std::string m_body;
+    std::vector<std::string> m_requests;
+    std::thread m_acceptThread;
+    std::list<std::thread> m_connectionThreads;
+};
+
+/**
+ * Counts the calls of a @c TrackUrlResolver::Callback and waits for them.
+ */
+class CallbackRecorder {
+public:
+    TrackUrlResolver::Callback get() {
+        return [this](const TrackUrlResolver::Result& result) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_results.push_back(result);
+            m_wakeUp.notify_all();
+        };
+    }
+
+    bool waitFor(size_t count) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_wakeUp.wait_for(lock, WAIT_TIMEOUT, [this, count]() { return m_results.size() >= count; });
+    }
+
+    std::vector<TrackUrlResolver::Result> getResults() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_results;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::vector<TrackUrlResolver::Result> m_results;
+};
+
+class TrackUrlResolverTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_client = HttpClient::create();
+        ASSERT_TRUE(m_client);
+    }
+
+    std::unique_ptr<TrackUrlResolver> createResolver(
+        std::chrono::milliseconds timeout = TrackUrlResolver::DEFAULT_TIMEOUT,
+        size_t maxInFlight = TrackUrlResolver::DEFAULT_MAX_IN_FLIGHT) {
+        return TrackUrlResolver::create(m_client, m_server.getEndpoint(), timeout, maxInFlight);
+    }
+
+    static TrackLinkRequest request(const std::string& itemId, const std::string& albumId = "") {
+        TrackLinkRequest request;
+        request.aiuiUid = "uid";
+        request.appId = "app";
+        request.appKey = "key";
+        request.kugouUserId = "kuser";
+        request.kugouUserToken = "ktoken";
+        request.clientDeviceId = "device";
+        request.itemId = itemId;
+        request.albumId = albumId;
+        return request;
+    }
+
+    static std::chrono::milliseconds since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    MockTrackLinkServer m_server;
+    std::shared_ptr<HttpClient> m_client;
+};
+
+/**
+ * Verify that a lookup signs its request with the item and album, and yields the URL the service answers with.
+ */
+TEST_F(TrackUrlResolverTest, test_resolveYieldsUrl) {
+    auto resolver = createResolver();
+    ASSERT_TRUE(resolver);
+    auto lookup = resolver->resolve(request("1234", "99"));
+    auto future = lookup->getFuture();
+    ASSERT_EQ(std::future_status::ready, future.wait_for(WAIT_TIMEOUT));
+    EXPECT_EQ(TrackUrlResolver::Status::SUCCESS, future.get().status);
+    EXPECT_EQ("http://cdn.test/1234.mp3", future.get().url);
+
+    auto requests = m_server.getRequests();
+    ASSERT_EQ(1u, requests.size());
+    EXPECT_EQ(0u, requests[0].find("POST /music/tracklink?&timestamp="));
+    EXPECT_NE(std::string::npos, requests[0].find("&itemid=1234&albumid=99 "));
+    EXPECT_NE(std::string::npos, requests[0].find("&token="));
+    EXPECT_NE(std::string::npos, requests[0].find("&kugouUserToken=ktoken"));
+}
+
+/**
+ * Verify that starting a lookup doesn't wait for the service, however slow it is.
+ */
+TEST_F(TrackUrlResolverTest, test_resolveDoesNotWaitForServer) {
+    m_server.setLatency(SLOW_SERVER_LATENCY);
+    auto resolver = createResolver();
+    CallbackRecorder recorder;
+    auto start = std::chrono::steady_clock::now();
+    auto lookup = resolver->resolve(request("1"), recorder.get());
+    EXPECT_LT(since(start), COMMAND_LATENCY_BOUND);
+    EXPECT_FALSE(lookup->isDone());
+    ASSERT_TRUE(recorder.waitFor(1));
+    EXPECT_EQ(TrackUrlResolver::Status::SUCCESS, recorder.getResults()[0].status);
+}
+
+/**
+ * Verify that a cancel completes the lookup at once whatever the server latency, frees its thread within the cancel
+ * poll interval, and doesn't call the callback.
+ */
+TEST_F(TrackUrlResolverTest, test_cancelLatencyIndependentOfServerLatency) {
+    auto resolver = createResolver(TrackUrlResolver::DEFAULT_TIMEOUT, 1);
+    for (auto latency : {std::chrono::milliseconds(100), SLOW_SERVER_LATENCY}) {
+        m_server.setLatency(latency);
+        CallbackRecorder recorder;
+        auto lookup = resolver->resolve(request("1"), recorder.get());
+        // Let the request reach the server.
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto start = std::chrono::steady_clock::now();
+        lookup->cancel();
+        EXPECT_TRUE(lookup->isDone());
+        EXPECT_EQ(TrackUrlResolver::Status::CANCELLED, lookup->getFuture().get().status);
+
+        // The single thread must be free again long before the server would have answered.
+        m_server.setLatency(std::chrono::milliseconds(0));
+        auto next = resolver->resolve(request("2"));
+        ASSERT_EQ(std::future_status::ready, next->getFuture().wait_for(WAIT_TIMEOUT));
+        EXPECT_EQ(TrackUrlResolver::Status::SUCCESS, next->getFuture().get().status);
+        EXPECT_LT(since(start), COMMAND_LATENCY_BOUND) << "latency=" << latency.count();
+        EXPECT_TRUE(recorder.getResults().empty());
+    }
+}
+
+/**
+ * Verify that a lookup the service doesn't answer in time times out.
+ */
+TEST_F(TrackUrlResolverTest, test_timeout) {
+    m_server.setLatency(SLOW_SERVER_LATENCY);
+    auto resolver = createResolver(std::chrono::milliseconds(200));
+    CallbackRecorder recorder;
+    auto start = std::chrono::steady_clock::now();
+    resolver->resolve(request("1"), recorder.get());
+    ASSERT_TRUE(recorder.waitFor(1));
+    EXPECT_EQ(TrackUrlResolver::Status::TIMED_OUT, recorder.getResults()[0].status);
+    EXPECT_LT(since(start), SLOW_SERVER_LATENCY);
+}
+
+/**
+ * Verify that the lookups for upcoming items run at the same time as the current one.
+ */
+TEST_F(TrackUrlResolverTest, test_lookupsRunConcurrently) {
+    m_server.setLatency(std::chrono::milliseconds(300));
+    auto resolver = createResolver();
+    CallbackRecorder recorder;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 3; ++i) {
+        resolver->resolve(request(std::to_string(i)), recorder.get());
+    }
+    ASSERT_TRUE(recorder.waitFor(3));
+    EXPECT_LT(since(start), std::chrono::milliseconds(800));
+    EXPECT_EQ(3, m_server.getMaxInFlight());
+    for (auto& result : recorder.getResults()) {
+        EXPECT_EQ(TrackUrlResolver::Status::SUCCESS, result.status);
+    }
+}
+
+/**
+ * Verify that @c cancelAll() cancels every lookup in flight.
+ */
+TEST_F(TrackUrlResolverTest, test_cancelAll) {
+    m_server.setLatency(SLOW_SERVER_LATENCY);
+    auto resolver = createResolver();
+    std::vector<std::shared_ptr<TrackUrlResolver::Lookup>> lookups;
+    for (int i = 0; i < 4; ++i) {
+        lookups.push_back(resolver->resolve(request(std::to_string(i))));
+    }
+    auto start = std::chrono::steady_clock::now();
+    resolver->cancelAll();
+    for (auto& lookup : lookups) {
+        EXPECT_TRUE(lookup->isDone());
+        EXPECT_EQ(TrackUrlResolver::Status::CANCELLED, lookup->getFuture().get().status);
+    }
+    resolver.reset();
+    EXPECT_LT(since(start), COMMAND_LATENCY_BOUND);
+}
+
+/**
+ * Verify that an answer without a URL fails, and one which isn't JSON is reported as such.
+ */
+TEST_F(TrackUrlResolverTest, test_badAnswers) {
+    auto resolver = createResolver();
+    m_server.setBody("{\"msg\":\"200102\"}");
+    auto noCopyright = resolver->resolve(request("1"))->getFuture();
+    ASSERT_EQ(std::future_status::ready, noCopyright.wait_for(WAIT_TIMEOUT));
+    EXPECT_EQ(TrackUrlResolver::Status::FAILED, noCopyright.get().status);
+
+    m_server.setBody("<html>");
+    auto notJson = resolver->resolve(request("1"))->getFuture();
+    ASSERT_EQ(std::future_status::ready, notJson.wait_for(WAIT_TIMEOUT));
+    EXPECT_EQ(TrackUrlResolver::Status::INVALID_RESPONSE, notJson.get().status);
+}
+
+/**
+ * Verify that a callback set after the lookup completed is called at once, and that a cancel afterwards changes
+ * nothing.
+ */
+TEST_F(TrackUrlResolverTest, test_setCallbackAfterCompletion) {
+    auto resolver = createResolver();
+    auto lookup = resolver->resolve(request("7"));
+    ASSERT_EQ(std::future_status::ready, lookup->getFuture().wait_for(WAIT_TIMEOUT));
+    CallbackRecorder recorder;
+    lookup->setCallback(recorder.get());
+    auto results = recorder.getResults();
+    ASSERT_EQ(1u, results.size());
+    EXPECT_EQ("http://cdn.test/7.mp3", results[0].url);
+
+    lookup->cancel();
+    EXPECT_EQ(TrackUrlResolver::Status::SUCCESS, lookup->getFuture().get().status);
+    EXPECT_EQ(1u, recorder.getResults().size());
+}
+
+}  // namespace test
+}  // namespace resourcesPlayer
+}  // namespace domain
+}  // namespace aisdk
@@ -275,12 +275,8 @@ void SpeechSynthesizer::executePreHandleAfterValidation(std::shared_ptr<ChatDire
 
 	// TODO:parse tts url and insert chatInfo map - Fix me.
 #ifdef ENABLE_SOUNDAI_ASR
-	auto data = info->directive->getData();
-	Json::CharReaderBuilder readerBuilder;
-	JSONCPP_STRING errs;
-	Json::Value root;
-	std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
-	if (!reader->parse(data.c_str(), data.c_str()+data.length(), &root, &errs)) {
+	auto& root = info->directive->getDataValue();
+	if (!root.isObject()) {
 		AISDK_ERROR(LX("executePreHandleAfterValidation").d("reason", "parseDataKeyError"));
 		return;
 	}
@@ -292,12 +288,8 @@ void SpeechSynthesizer::executePreHandleAfterValidation(std::shared_ptr<ChatDire
 	 * We should to parse the key of the 'session' to decide
 	 * whether we should release the Channel at the end.
 	 */
-	auto data = info->directive->getData();
-	Json::CharReaderBuilder readerBuilder;
-	JSONCPP_STRING errs;
-	Json::Value root;
-	std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
-	if (!reader->parse(data.c_str(), data.c_str()+data.length(), &root, &errs)) {
+	auto& root = info->directive->getDataValue();
+	if (!root.isObject()) {
 		AISDK_ERROR(LX("executePreHandleAfterValidation").d("reason", "parseDataKeyError"));
 		return;
 	}
@@ -70,7 +70,7 @@ private:
 	/// Construct.
 	VolumeManager();
 
-	bool handleSpeakerSettingsValidation(std::string &data);
+	bool handleSpeakerSettingsValidation(const Json::Value &root);
 
     void executeVolumePreHandle(std::shared_ptr<DirectiveInfo> info);
 	
@@ -80,17 +80,13 @@ void VolumeManager::doShutdown() {
 	m_observers.reset();	
 }
 
-bool VolumeManager::handleSpeakerSettingsValidation(std::string &data) {
-	if(data.empty()) {
+bool VolumeManager::handleSpeakerSettingsValidation(const Json::Value &root) {
+	if(root.isNull()) {
 		AISDK_ERROR(LX("handleSpeakerSettingsValidationFailed").d("reason", "dataIsEmpty"));
 		return false;
 	}
 
-	Json::CharReaderBuilder readerBuilder;
-	JSONCPP_STRING errs;
-	Json::Value root;
-	std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
-	if (!reader->parse(data.c_str(), data.c_str()+data.length(), &root, &errs)) {
+	if(!root.isObject()) {
 		AISDK_ERROR(LX("handleSpeakerSettingsValidationFailed").d("reason", "dataKeyParseError"));
 		return false;
 	}
@@ -129,8 +125,7 @@ bool VolumeManager::handleSpeakerSettingsValidation(std::string &data) {
 }
 
 void VolumeManager::executeVolumePreHandle(std::shared_ptr<DirectiveInfo> info) {
-	auto data = info->directive->getData();
-	if(handleSpeakerSettingsValidation(data)) {
+	if(handleSpeakerSettingsValidation(info->directive->getDataValue())) {
 		// Notify volume change observer.
 		if(m_observers) {
 			m_observers->onVolumeChange(m_setting.volumeType, m_setting.volume);
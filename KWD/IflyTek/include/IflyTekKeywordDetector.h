@@ -108,6 +108,12 @@ private:
      * This will be determined based on the sampling rate of the audio data passed in.
      */
     const size_t m_maxSamplesPerPush;	
+
+	/**
+	 * The absolute index in @c m_stream of the first sample of the current IVW session.  The engine reports the
+	 * keyword position relative to it.
+	 */
+	std::atomic<utils::sharedbuffer::SharedBuffer::Index> m_sessionStartIndex;
 };
 
 }
@@ -42,6 +42,49 @@ static const unsigned int IFLYTEK_COMPATIBLE_SAMPLE_RATE = 16000;
 /// The timeout to use for read calls to the SharedDataStream.
 const std::chrono::milliseconds TIMEOUT_FOR_READ_CALLS = std::chrono::milliseconds(1000);
 
+/// The keyword reported when the engine result does not name the one it detected.
+static const std::string DEFAULT_KEYWORD("xiaokang");
+
+/**
+ * Extracts an integer field such as @c "bos" from the IVW result, which is a small flat JSON object.
+ *
+ * @param info The IVW result.
+ * @param field The name of the field.
+ * @param[out] value The value of the field.
+ * @return @c true if the field was found, else @c false.
+ */
+static bool parseResultField(const char* info, const std::string& field, long* value) {
+	auto key = "\"" + field + "\"";
+	auto position = info ? strstr(info, key.c_str()) : nullptr;
+	if (!position) {
+		return false;
+	}
+	position = strchr(position + key.length(), ':');
+	if (!position) {
+		return false;
+	}
+	char* end = nullptr;
+	*value = strtol(position + 1, &end, 10);
+	return end != position + 1;
+}
+
+/**
+ * Extracts a string field such as @c "keyword" from the IVW result.
+ *
+ * @param info The IVW result.
+ * @param field The name of the field.
+ * @return The value of the field, or an empty string if it was not found.
+ */
+static std::string parseResultString(const char* info, const std::string& field) {
+	auto key = "\"" + field + "\"";
+	auto position = info ? strstr(info, key.c_str()) : nullptr;
+	if (!position || !(position = strchr(position + key.length(), ':')) || !(position = strchr(position, '"'))) {
+		return "";
+	}
+	auto end = strchr(position + 1, '"');
+	return end ? std::string(position + 1, end) : "";
+}
+
 std::unique_ptr<IflyTekKeywordDetector> IflyTekKeywordDetector::create(
 	std::shared_ptr<utils::sharedbuffer::SharedBuffer> stream,
 	std::unordered_set<std::shared_ptr<dmInterface::KeyWordObserverInterface>> keywordObserver,
@@ -76,7 +119,8 @@ IflyTekKeywordDetector::IflyTekKeywordDetector(
 	std::chrono::milliseconds maxSamplesPerPush):
 		GenericKeywordDetector(keywordObserver),
 		m_stream{stream},
-		m_maxSamplesPerPush((IFLYTEK_COMPATIBLE_SAMPLE_RATE/HERTZ_PER_KILOHERTZ) * maxSamplesPerPush.count()){
+		m_maxSamplesPerPush((IFLYTEK_COMPATIBLE_SAMPLE_RATE/HERTZ_PER_KILOHERTZ) * maxSamplesPerPush.count()),
+		m_sessionStartIndex{0} {
 }
 
 bool IflyTekKeywordDetector::init() {
@@ -138,11 +182,23 @@ int IflyTekKeywordDetector::keyWordDetectedCallback(
 	/**
 	 * below is info content:
 	 * {"sst":"wakeup", "id":0, "score":2077, "bos":1070, "eos":2000 ,"keyword":"xiao3kang1xiao3kang1"}
-	 * To-Do: bos and eos value.
+	 * bos and eos are the keyword bounds in milliseconds since the session's first sample.
 	 */
+	auto text = static_cast<const char *>(info);
+	auto beginIndex = dmInterface::KeyWordObserverInterface::UNSPECIFIED_INDEX;
+	auto endIndex = dmInterface::KeyWordObserverInterface::UNSPECIFIED_INDEX;
+	long bos = 0;
+	long eos = 0;
+	if (parseResultField(text, "bos", &bos) && parseResultField(text, "eos", &eos) && bos >= 0 && eos >= bos) {
+		const SharedBuffer::Index wordsPerMs = IFLYTEK_COMPATIBLE_SAMPLE_RATE / HERTZ_PER_KILOHERTZ;
+		beginIndex = engine->m_sessionStartIndex + static_cast<SharedBuffer::Index>(bos) * wordsPerMs;
+		endIndex = engine->m_sessionStartIndex + static_cast<SharedBuffer::Index>(eos) * wordsPerMs;
+	} else {
+		AISDK_WARN(LX("keyWordDetectedCallback").d("reason", "noKeywordBounds"));
+	}
+	auto keyword = parseResultString(text, "keyword");
 
-	// Notify keyword observer if detecte keyword wakeup event successfuly. defaule set beginIndex and endIndex: 0.
-	engine->notifyKeyWordObservers(engine->m_stream, "xiaokang", 0, 0);
+	engine->notifyKeyWordObservers(engine->m_stream, keyword.empty() ? DEFAULT_KEYWORD : keyword, beginIndex, endIndex);
 
 	return MSP_SUCCESS;
 }
@@ -172,6 +228,10 @@ void IflyTekKeywordDetector::detectionLoop() {
 			audioStatus = MSP_AUDIO_SAMPLE_FIRST;
 			
 		} else if(wordsRead > 0) {
+			if (MSP_AUDIO_SAMPLE_FIRST == audioStatus) {
+				// The engine reports keyword bounds relative to the first sample written after (re)starting.
+				m_sessionStartIndex = m_streamReader->tell() - wordsRead;
+			}
 			void *pbuf8 = audioDataToPush.data();
 			output.write(static_cast<char *>(pbuf8), wordsRead*sizeof(*audioDataToPush.data()));
 
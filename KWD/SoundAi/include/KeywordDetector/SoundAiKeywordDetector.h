@@ -26,6 +26,7 @@
 #include <Utils/DeviceInfo.h>
 #include "DMInterface/KeyWordObserverInterface.h"
 #include "KWD/GenericKeywordDetector.h"
+#include "KWD/StreamFeeder.h"
 
 namespace aisdk {
 namespace kwd {
@@ -43,16 +44,29 @@ public:
      * with 8channels and have a sample rate of 16 kHz. Additionally, the data should be in little endian format.
 	 * @param keyWordObservers The observers to notify of keyword detections.
 	 * @param maxSamplesPerPush The amount of data in milliseconds to push to SoundAi denoise at a time.
+	 * @param maxFeedLatency How long a partial batch may wait for the rest of its samples before it is pushed anyway.
+	 * @param denoiseBufferSizeInBytes The size of the data area of the denoised stream handed to the ASR engine.
+	 * @param maxDenoiseReaders The maximum number of readers of the denoised stream.
 	 * @Return A new @c SoundAiKeywordDetector, or @c nullptr if the operation failed.
 	 */
 	static std::unique_ptr<SoundAiKeywordDetector> create(
 		std::shared_ptr<utils::DeviceInfo> deviceInfo,
 		std::shared_ptr<utils::sharedbuffer::SharedBuffer> stream,
 		std::unordered_set<std::shared_ptr<dmInterface::KeyWordObserverInterface>> keywordObserver,
-		std::chrono::milliseconds maxSamplesPerPush = std::chrono::milliseconds(10));
+		std::chrono::milliseconds maxSamplesPerPush = std::chrono::milliseconds(10),
+		std::chrono::milliseconds maxFeedLatency = std::chrono::milliseconds(20),
+		size_t denoiseBufferSizeInBytes = 0x80000,
+		size_t maxDenoiseReaders = 2);
 
 	/// Destructor.
 	~SoundAiKeywordDetector() override;
+
+	/**
+	 * Gets the counters of the feeding loop: time spent in @c sai_denoise_feed and the microphone backlog.
+	 *
+	 * @return A snapshot of the counters, all zero before the loop has started.
+	 */
+	StreamFeeder::Statistics getFeedStatistics() const;
 private:
 	
 	/**
@@ -61,12 +75,18 @@ private:
      * with 8channels and have a sample rate of 16 kHz. Additionally, the data should be in little endian format.
 	 * @param keyWordObservers The observers to notify of keyword detections.
 	 * @param maxSamplesPerPush The amount of data in milliseconds to push to SoundAi denoise at a time.
+	 * @param maxFeedLatency How long a partial batch may wait for the rest of its samples before it is pushed anyway.
+	 * @param denoiseBufferSizeInBytes The size of the data area of the denoised stream.
+	 * @param maxDenoiseReaders The maximum number of readers of the denoised stream.
 	 */
 	SoundAiKeywordDetector(
 		std::shared_ptr<utils::DeviceInfo> deviceInfo,
 		std::shared_ptr<utils::sharedbuffer::SharedBuffer> stream,
 		std::unordered_set<std::shared_ptr<dmInterface::KeyWordObserverInterface>> keywordObserver,
-		std::chrono::milliseconds maxSamplesPerPush);
+		std::chrono::milliseconds maxSamplesPerPush,
+		std::chrono::milliseconds maxFeedLatency,
+		size_t denoiseBufferSizeInBytes,
+		size_t maxDenoiseReaders);
 
 	/**
      * Initializes the stream reader, sets up the SoundAi denoise engine, and kicks off a thread to begin processing 
@@ -161,6 +181,18 @@ private:
 	 * This will be determined based on the sampling rate of the audio data passed in.
 	 */
 	const size_t m_maxSamplesPerPush;	
+
+	/// How long a partial batch may wait for the rest of its samples.
+	const std::chrono::milliseconds m_maxFeedLatency;
+
+	/// The size (in bytes) of the data area of @c m_denoiseStream.
+	const size_t m_denoiseBufferSizeInBytes;
+
+	/// The maximum number of readers of @c m_denoiseStream.
+	const size_t m_maxDenoiseReaders;
+
+	/// Paces the data pushed from @c m_streamReader into the denoise engine.
+	std::unique_ptr<StreamFeeder> m_feeder;
 	
 	/// Denoise config structure used to denoise init. 
 	sai_denoise_cfg_t *m_denoiseConfig;
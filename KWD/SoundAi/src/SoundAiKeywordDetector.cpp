@@ -33,15 +33,11 @@ using namespace utils::sharedbuffer;
 /// The string of paraments default configure path.
 static const std::string DEFAULT_CONFIG("/cfg/sai_config");
 
-/// Default size of underlying Sharedbuffer when created internally.
-/// This buffer is used to send denoised data to ASR Engine @c GenricAutomaticSpeechRecognizer.
-static const int DENOISE_BUFFER_DEFAULT_SIZE_IN_BYTES = 0x80000;	//0x100000;
-
 /// The size of each word within the stream.
 static const size_t WORD_SIZE = 2;
 
-/// The number of reader for denoised stream.
-static const size_t MAX_DENOISE_READER = 2;
+/// The keyword reported when the engine does not name the one it detected.
+static const std::string DEFAULT_KEYWORD("xiaokang");
 
 /// The number of hertz per kilohertz.
 static const size_t HERTZ_PER_KILOHERTZ = 1000;
@@ -59,19 +55,37 @@ std::unique_ptr<SoundAiKeywordDetector> SoundAiKeywordDetector::create(
 	std::shared_ptr<utils::DeviceInfo> deviceInfo,
 	std::shared_ptr<utils::sharedbuffer::SharedBuffer> stream,
 	std::unordered_set<std::shared_ptr<dmInterface::KeyWordObserverInterface>> keywordObserver,
-	std::chrono::milliseconds maxSamplesPerPush) {
+	std::chrono::milliseconds maxSamplesPerPush,
+	std::chrono::milliseconds maxFeedLatency,
+	size_t denoiseBufferSizeInBytes,
+	size_t maxDenoiseReaders) {
 	if(!stream) {
 		AISDK_ERROR(LX("CreateFiled").d("reason", "nullStream"));
 		return nullptr;
 	}
 
+	if(denoiseBufferSizeInBytes < WORD_SIZE || 0 == maxDenoiseReaders) {
+		AISDK_ERROR(LX("CreateFiled")
+				.d("reason", "invalidDenoiseBuffer")
+				.d("denoiseBufferSizeInBytes", denoiseBufferSizeInBytes)
+				.d("maxDenoiseReaders", maxDenoiseReaders));
+		return nullptr;
+	}
+
 	if(!deviceInfo) {
 		AISDK_ERROR(LX("CreateFiled").d("reason", "nullDeviceInfo"));
 		return nullptr;
 	}
 	
 	auto detector = std::unique_ptr<SoundAiKeywordDetector>(
-		new SoundAiKeywordDetector(deviceInfo, stream, keywordObserver, maxSamplesPerPush));
+		new SoundAiKeywordDetector(
+			deviceInfo,
+			stream,
+			keywordObserver,
+			maxSamplesPerPush,
+			maxFeedLatency,
+			denoiseBufferSizeInBytes,
+			maxDenoiseReaders));
 	if(!detector->init()) {
 		AISDK_ERROR(LX("CreateFailed").d("reason", "initDetectorFailed"));
 		return nullptr;
@@ -86,6 +100,16 @@ SoundAiKeywordDetector::~SoundAiKeywordDetector() {
 	if (m_detectionThread.joinable()) {
 		m_detectionThread.join();
 	}
+	if (m_feeder) {
+		auto statistics = m_feeder->getStatistics();
+		AISDK_INFO(LX("feedStatistics")
+				.d("feeds", statistics.feeds)
+				.d("feedErrors", statistics.feedErrors)
+				.d("overruns", statistics.overruns)
+				.d("maxFeedUs", statistics.maxFeedDuration.count())
+				.d("totalFeedUs", statistics.totalFeedDuration.count())
+				.d("maxBacklogWords", statistics.maxBacklogWords));
+	}
 	// Cleanup denoise stream writer.
 	destoryDenoiseWriter();
 
@@ -100,7 +124,10 @@ SoundAiKeywordDetector::SoundAiKeywordDetector(
 	std::shared_ptr<utils::DeviceInfo> deviceInfo,
 	std::shared_ptr<utils::sharedbuffer::SharedBuffer> stream,
 	std::unordered_set<std::shared_ptr<dmInterface::KeyWordObserverInterface>> keywordObserver,
-	std::chrono::milliseconds maxSamplesPerPush):
+	std::chrono::milliseconds maxSamplesPerPush,
+	std::chrono::milliseconds maxFeedLatency,
+	size_t denoiseBufferSizeInBytes,
+	size_t maxDenoiseReaders):
 		GenericKeywordDetector(keywordObserver),
 		m_deviceInfo{deviceInfo},
 		m_isShuttingDown{false},
@@ -111,6 +138,9 @@ SoundAiKeywordDetector::SoundAiKeywordDetector(
 		m_maxSamplesPerPush(
 			(SOUNDAI_DENOISE_COMPATIBLE_SAMPLE_RATE/HERTZ_PER_KILOHERTZ) * 
 			(SOUNDAI_DENOISE_COMPATIBLE_CHANNELS) *maxSamplesPerPush.count()),
+		m_maxFeedLatency{maxFeedLatency},
+		m_denoiseBufferSizeInBytes{denoiseBufferSizeInBytes},
+		m_maxDenoiseReaders{maxDenoiseReaders},
 		m_denoiseConfig{nullptr},
 		m_wakeConfig{nullptr},
 		m_denoiseContext{nullptr} {
@@ -195,6 +225,25 @@ bool SoundAiKeywordDetector::init() {
         return false;
     }
 
+	auto denoiseContext = m_denoiseContext;
+	m_feeder = StreamFeeder::create(
+		m_streamReader,
+		m_maxSamplesPerPush,
+		m_maxFeedLatency,
+		[denoiseContext](const void* data, size_t nWords) {
+			auto errCode = sai_denoise_feed(denoiseContext, static_cast<const char*>(data), nWords * WORD_SIZE);
+			if (SAI_ASP_ERROR_SUCCESS != errCode) {
+				// TODO: Sven we should convert the 'sai_asp_err_t' state to string.
+				AISDK_ERROR(LX("detectionLoopFailed").d("reason", "sai_denoise_feed err").d("errCode", errCode));
+				return false;
+			}
+			return true;
+		});
+	if (!m_feeder) {
+		AISDK_ERROR(LX("initFailed").d("reason", "createStreamFeederFailed"));
+		return false;
+	}
+
 	establishDenoiseWriter();
 
 	m_isShuttingDown = false;
@@ -210,10 +259,10 @@ bool SoundAiKeywordDetector::establishDenoiseWriter() {
      */
     if(!m_denoiseStream) {
 		size_t bufferSize = utils::sharedbuffer::SharedBuffer::calculateBufferSize(
-			DENOISE_BUFFER_DEFAULT_SIZE_IN_BYTES, WORD_SIZE, MAX_DENOISE_READER);
-		AISDK_INFO(LX("establishDenoiseWriter").d("bufferSize", bufferSize));
+			m_denoiseBufferSizeInBytes / WORD_SIZE, WORD_SIZE, m_maxDenoiseReaders);
+		AISDK_INFO(LX("establishDenoiseWriter").d("bufferSize", bufferSize).d("maxReaders", m_maxDenoiseReaders));
 		auto buffer = std::make_shared<utils::sharedbuffer::SharedBuffer::Buffer>(bufferSize);
-		m_denoiseStream = utils::sharedbuffer::SharedBuffer::create(buffer, WORD_SIZE, MAX_DENOISE_READER);
+		m_denoiseStream = utils::sharedbuffer::SharedBuffer::create(buffer, WORD_SIZE, m_maxDenoiseReaders);
 		if(!m_denoiseStream) {
 			AISDK_ERROR(LX("establishDenoiseWriterFailed").d("reason", "createDenoiseStreamFailed"));
 			return false;
@@ -259,8 +308,17 @@ void SoundAiKeywordDetector::handleKeywordDetectedCallback(
 				.d("angle", wkload->angle)
 				.d("score", wkload->score));
 	
-	// Notify keyword observer if detecte keyword wakeup event successfuly. defaule set beginIndex and endIndex: 0.
-	detector->notifyKeyWordObservers(detector->m_denoiseStream, "xiaokang", 0, 0);
+	/**
+	 * The engine reports the wake up from inside sai_denoise_feed(), after the denoised audio leading up to it has gone
+	 * to @c m_denoiseWriter, so the keyword ends where the writer is now and began as many samples earlier as the
+	 * engine handed back with the event.
+	 */
+	auto endIndex = detector->m_denoiseWriter->tell();
+	SharedBuffer::Index keywordWords = wkload->size / WORD_SIZE;
+	auto beginIndex = (endIndex > keywordWords) ? endIndex - keywordWords : 0;
+	std::string keyword = wkload->word ? wkload->word : DEFAULT_KEYWORD;
+
+	detector->notifyKeyWordObservers(detector->m_denoiseStream, keyword, beginIndex, endIndex);
 }
 
 void SoundAiKeywordDetector::handleDenoiseVADCallback(
@@ -343,54 +401,34 @@ void SoundAiKeywordDetector::handleDenoiseStreamCallback(
 	}
 
 	if (data && size > 0) {
-		std::vector<int16_t> pushToBuffer(size/sizeof(int16_t));
-		auto pbuf8 = static_cast<void *>(pushToBuffer.data());
-		//AISDK_INFO(LX("handleDenoiseStreamCallback").d("size", size));
 		// This is debug save, we should disable it in release version.
 		//writeToFile(1100, Sai_Debug_ASR1, std::string(data, size));
-		memcpy(pbuf8, data, size);
-		detector->m_denoiseWriter->write(pushToBuffer.data(), pushToBuffer.size());
+		/*
+		 * Write straight from the engine's frame into the ring; the writer copies byte-wise, so the frame needs no
+		 * alignment and there is no intermediate buffer on this audio-rate path.
+		 */
+		detector->m_denoiseWriter->write(data, size / WORD_SIZE);
 	}
 }
 
 void SoundAiKeywordDetector::detectionLoop() {
-	std::vector<int16_t> audioDataToPush(m_maxSamplesPerPush); //(16*8*10)*2 = (1280)*2 = 2560 = 20ms 
-	int errCode = SAI_ASP_ERROR_SUCCESS;
-	ssize_t wordsRead;
-	//std::ofstream output("/tmp/Backup.pcm");
-
+	// The feeder blocks on the stream until a batch is ready, so there is no polling or sleeping here.
 	while(!m_isShuttingDown) {
-
-		bool didErrorOccur = false;
-		// Start read data.
-		wordsRead = readFromStream(
-				m_streamReader,
-				m_stream,
-				audioDataToPush.data(),
-				audioDataToPush.size(),
-				TIMEOUT_FOR_READ_CALLS,
-				&didErrorOccur);
+		auto status = m_feeder->feedOnce(TIMEOUT_FOR_READ_CALLS);
 		// Error occurrence maybe reader close.
-		if(didErrorOccur) {
+		if (StreamFeeder::Status::CLOSED == status || StreamFeeder::Status::ERROR == status) {
 			break;
-		} else if (wordsRead == Reader::Error::OVERRUN) {
-			
-		} else if(wordsRead > 0) {
-			void *pbuf8 = audioDataToPush.data();
-			//output.write(static_cast<char *>(pbuf8), wordsRead*sizeof(*audioDataToPush.data()));
-
-			errCode = sai_denoise_feed(m_denoiseContext, static_cast<char *>(pbuf8), wordsRead*sizeof(*audioDataToPush.data()));
-			if (SAI_ASP_ERROR_SUCCESS != errCode){
-				AISDK_ERROR(LX("detectionLoopFailed").d("reason", "sai_denoise_feed err").d("errCode", errCode));
-				// TODO: Sven we should convert the 'sai_asp_err_t' state to string.
-			}
-			std::this_thread::sleep_for(std::chrono::milliseconds(5));
 		}
-		
 	}
 	// Close the @c Reader which read stream occurence.
 	m_streamReader->close();
+}
 
+StreamFeeder::Statistics SoundAiKeywordDetector::getFeedStatistics() const {
+	if (!m_feeder) {
+		return StreamFeeder::Statistics();
+	}
+	return m_feeder->getStatistics();
 }
 
 }	// namespace kwd
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __KWD_STREAMFEEDER_H_
+#define __KWD_STREAMFEEDER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include <Utils/SharedBuffer/SharedBuffer.h>
+
+namespace aisdk {
+namespace kwd {
+
+/**
+ * Paces the audio a keyword engine consumes from the microphone stream.  Rather than reading and then sleeping, the
+ * feeder blocks on the stream until a batch of @c batchWords is buffered, or until @c maxLatency has passed since the
+ * first unfed word arrived, and hands the engine the data straight out of the ring.  When the engine falls behind the
+ * batches go back to back with no waiting at all, so the backlog drains as fast as the engine allows.
+ */
+class StreamFeeder {
+public:
+    /**
+     * The engine entry point.
+     *
+     * @param data Contiguous samples, pointing into the stream.  Only valid for the duration of the call.
+     * @param nWords The number of words at @c data.
+     * @return @c true if the engine accepted the data, else @c false.
+     */
+    using FeedFunction = std::function<bool(const void* data, size_t nWords)>;
+
+    /// The outcome of one @c feedOnce() call.
+    enum class Status {
+        /// A batch was handed to the engine.
+        FED,
+        /// No data arrived within the idle timeout.
+        TIMEDOUT,
+        /// The writer overran the reader; the reader was moved to live data.
+        OVERRUN,
+        /// The stream has closed.
+        CLOSED,
+        /// The reader reported an unexpected error.
+        ERROR
+    };
+
+    /// A snapshot of the feeder counters.
+    struct Statistics {
+        /// The number of batches handed to the engine.
+        uint64_t feeds;
+        /// The number of words handed to the engine.
+        uint64_t wordsFed;
+        /// The number of engine calls which reported a failure.
+        uint64_t feedErrors;
+        /// The number of overruns recovered from.
+        uint64_t overruns;
+        /// The time the engine took over the last batch.
+        std::chrono::microseconds lastFeedDuration;
+        /// The longest time the engine took over one batch.
+        std::chrono::microseconds maxFeedDuration;
+        /// The time the engine took over all batches.
+        std::chrono::microseconds totalFeedDuration;
+        /// The words buffered but not yet fed, as of the last batch.
+        size_t backlogWords;
+        /// The largest backlog seen right before a batch.
+        size_t maxBacklogWords;
+    };
+
+    /**
+     * Creates a @c StreamFeeder.
+     *
+     * @param reader A @c BLOCKING reader of the stream to feed from.
+     * @param batchWords The number of words to hand to the engine at a time.
+     * @param maxLatency How long a partial batch may wait for the rest of its words.
+     * @param feed The engine entry point.
+     * @return The feeder, or @c nullptr if a parameter is invalid.
+     */
+    static std::unique_ptr<StreamFeeder> create(
+        std::shared_ptr<utils::sharedbuffer::Reader> reader,
+        size_t batchWords,
+        std::chrono::milliseconds maxLatency,
+        FeedFunction feed);
+
+    /**
+     * Waits for a batch and hands it to the engine.  This is meant to be called in a loop from a single thread.
+     *
+     * @param idleTimeout How long to wait for the first word of a batch, so the caller can check for shutdown.
+     * @return The outcome of the call.
+     */
+    Status feedOnce(std::chrono::milliseconds idleTimeout);
+
+    /// @return A snapshot of the counters.
+    Statistics getStatistics() const;
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param reader A @c BLOCKING reader of the stream to feed from.
+     * @param batchWords The number of words to hand to the engine at a time.
+     * @param maxLatency How long a partial batch may wait for the rest of its words.
+     * @param feed The engine entry point.
+     */
+    StreamFeeder(
+        std::shared_ptr<utils::sharedbuffer::Reader> reader,
+        size_t batchWords,
+        std::chrono::milliseconds maxLatency,
+        FeedFunction feed);
+
+    /**
+     * Maps a failed reader call to a @c Status, moving the reader back to live data after an overrun.
+     *
+     * @param result The negative (or zero) result of the reader call.
+     * @return The @c Status to report.
+     */
+    Status handleReadError(ssize_t result);
+
+    /**
+     * Hands one contiguous span to the engine and accounts for it.
+     *
+     * @param data The samples.
+     * @param nWords The number of words at @c data.
+     * @return The time the engine took.
+     */
+    std::chrono::steady_clock::duration feedSpan(const void* data, size_t nWords);
+
+    /// The reader of the stream.
+    std::shared_ptr<utils::sharedbuffer::Reader> m_reader;
+
+    /// The number of words handed to the engine at a time.
+    const size_t m_batchWords;
+
+    /// How long a partial batch may wait for the rest of its words.
+    const std::chrono::milliseconds m_maxLatency;
+
+    /// The engine entry point.
+    FeedFunction m_feed;
+
+    /// @name Counters, written by the feeding thread and readable from any thread.
+    /// @{
+    std::atomic<uint64_t> m_feeds;
+    std::atomic<uint64_t> m_wordsFed;
+    std::atomic<uint64_t> m_feedErrors;
+    std::atomic<uint64_t> m_overruns;
+    std::atomic<int64_t> m_lastFeedMicros;
+    std::atomic<int64_t> m_maxFeedMicros;
+    std::atomic<int64_t> m_totalFeedMicros;
+    std::atomic<size_t> m_backlogWords;
+    std::atomic<size_t> m_maxBacklogWords;
+    /// @}
+};
+
+}  // namespace kwd
+}  // namespace aisdk
+
+#endif  // __KWD_STREAMFEEDER_H_
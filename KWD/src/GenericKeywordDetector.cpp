@@ -53,7 +53,7 @@ void GenericKeywordDetector::notifyKeyWordObservers(
     SharedBuffer::Index endIndex) const {
     std::lock_guard<std::mutex> lock(m_keyWordObserversMutex);
     for (auto keyWordObserver : m_keyWordObservers) {
-        keyWordObserver->onKeyWordDetected(stream, keyword);
+        keyWordObserver->onKeyWordDetected(stream, keyword, beginIndex, endIndex);
     }
 }
 
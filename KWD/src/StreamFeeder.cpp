@@ -0,0 +1,163 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <Utils/Logging/Logger.h>
+
+#include "KWD/StreamFeeder.h"
+
+namespace aisdk {
+namespace kwd {
+
+using namespace utils::sharedbuffer;
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("StreamFeeder");
+
+/**
+ * Create a LogEntry using this file's TAG and the specified event string.
+ *
+ * @param The event string for this @c LogEntry.
+ */
+#define LX(event) utils::logging::LogEntry(TAG, event)
+
+std::unique_ptr<StreamFeeder> StreamFeeder::create(
+    std::shared_ptr<Reader> reader,
+    size_t batchWords,
+    std::chrono::milliseconds maxLatency,
+    FeedFunction feed) {
+    if (!reader) {
+        AISDK_ERROR(LX("createFailed").d("reason", "nullReader"));
+        return nullptr;
+    }
+    if (0 == batchWords) {
+        AISDK_ERROR(LX("createFailed").d("reason", "zeroBatchWords"));
+        return nullptr;
+    }
+    if (maxLatency <= std::chrono::milliseconds::zero()) {
+        AISDK_ERROR(LX("createFailed").d("reason", "invalidMaxLatency").d("maxLatencyMs", maxLatency.count()));
+        return nullptr;
+    }
+    if (!feed) {
+        AISDK_ERROR(LX("createFailed").d("reason", "nullFeedFunction"));
+        return nullptr;
+    }
+    return std::unique_ptr<StreamFeeder>(new StreamFeeder(reader, batchWords, maxLatency, feed));
+}
+
+StreamFeeder::StreamFeeder(
+    std::shared_ptr<Reader> reader,
+    size_t batchWords,
+    std::chrono::milliseconds maxLatency,
+    FeedFunction feed) :
+        m_reader{reader},
+        m_batchWords{batchWords},
+        m_maxLatency{maxLatency},
+        m_feed{feed},
+        m_feeds{0},
+        m_wordsFed{0},
+        m_feedErrors{0},
+        m_overruns{0},
+        m_lastFeedMicros{0},
+        m_maxFeedMicros{0},
+        m_totalFeedMicros{0},
+        m_backlogWords{0},
+        m_maxBacklogWords{0} {
+}
+
+StreamFeeder::Status StreamFeeder::feedOnce(std::chrono::milliseconds idleTimeout) {
+    // Sleep until the first word of the next batch, then give the rest of the batch up to m_maxLatency to arrive.
+    auto available = m_reader->wait(1, idleTimeout);
+    if (available > 0 && static_cast<size_t>(available) < m_batchWords) {
+        available = m_reader->wait(m_batchWords, m_maxLatency);
+    }
+    if (available <= 0) {
+        return handleReadError(available);
+    }
+
+    size_t backlog = m_reader->tell(Reader::Reference::BEFORE_WRITER);
+    if (backlog > m_maxBacklogWords) {
+        m_maxBacklogWords = backlog;
+    }
+
+    Reader::Spans spans;
+    auto nWords = m_reader->peek(&spans, m_batchWords, idleTimeout);
+    if (nWords <= 0) {
+        return handleReadError(nWords);
+    }
+
+    auto elapsed = feedSpan(spans.first.data, spans.first.nWords);
+    if (spans.second.nWords > 0) {
+        elapsed += feedSpan(spans.second.data, spans.second.nWords);
+    }
+
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    ++m_feeds;
+    m_wordsFed += nWords;
+    m_lastFeedMicros = micros;
+    m_totalFeedMicros += micros;
+    if (micros > m_maxFeedMicros) {
+        m_maxFeedMicros = micros;
+    }
+
+    auto consumed = m_reader->consume(nWords);
+    if (consumed < 0) {
+        return handleReadError(consumed);
+    }
+    m_backlogWords = m_reader->tell(Reader::Reference::BEFORE_WRITER);
+    return Status::FED;
+}
+
+StreamFeeder::Statistics StreamFeeder::getStatistics() const {
+    Statistics statistics;
+    statistics.feeds = m_feeds;
+    statistics.wordsFed = m_wordsFed;
+    statistics.feedErrors = m_feedErrors;
+    statistics.overruns = m_overruns;
+    statistics.lastFeedDuration = std::chrono::microseconds(m_lastFeedMicros);
+    statistics.maxFeedDuration = std::chrono::microseconds(m_maxFeedMicros);
+    statistics.totalFeedDuration = std::chrono::microseconds(m_totalFeedMicros);
+    statistics.backlogWords = m_backlogWords;
+    statistics.maxBacklogWords = m_maxBacklogWords;
+    return statistics;
+}
+
+StreamFeeder::Status StreamFeeder::handleReadError(ssize_t result) {
+    switch (result) {
+        case 0:
+            AISDK_DEBUG1(LX("feedOnce").d("event", "streamClosed"));
+            return Status::CLOSED;
+        case Reader::Error::TIMEDOUT:
+            return Status::TIMEDOUT;
+        case Reader::Error::OVERRUN:
+            ++m_overruns;
+            AISDK_ERROR(LX("feedOnceFailed")
+                            .d("reason", "streamOverrun")
+                            .d("backlogWords", m_reader->tell(Reader::Reference::BEFORE_WRITER)));
+            // Skip to live data; the engine is better off with a gap than running further and further behind.
+            m_reader->seek(0, Reader::Reference::BEFORE_WRITER);
+            return Status::OVERRUN;
+        default:
+            AISDK_ERROR(LX("feedOnceFailed").d("reason", "unexpectedError").d("error", result));
+            return Status::ERROR;
+    }
+}
+
+std::chrono::steady_clock::duration StreamFeeder::feedSpan(const void* data, size_t nWords) {
+    auto start = std::chrono::steady_clock::now();
+    if (!m_feed(data, nWords)) {
+        ++m_feedErrors;
+    }
+    return std::chrono::steady_clock::now() - start;
+}
+
+}  // namespace kwd
+}  // namespace aisdk
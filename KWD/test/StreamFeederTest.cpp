@@ -0,0 +1,249 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "KWD/StreamFeeder.h"
+
+namespace aisdk {
+namespace kwd {
+namespace test {
+
+using namespace utils::sharedbuffer;
+
+/// The microphone format the SoundAi engine takes: 16 kHz, 8 channels, 16-bit words.
+static const size_t WORDS_PER_MS = 16 * 8;
+
+/// The size of each word within the stream.
+static const size_t WORD_SIZE = 2;
+
+/// One 10 ms batch, the default push size of @c SoundAiKeywordDetector.
+static const size_t BATCH_WORDS = 10 * WORDS_PER_MS;
+
+/// The stream holds one second, like a (short) microphone buffer.
+static const size_t STREAM_WORDS = 1000 * WORDS_PER_MS;
+
+/// The max latency the tests configure.
+static const std::chrono::milliseconds MAX_LATENCY(20);
+
+/// A generous idle timeout so a stuck feeder fails the test instead of hanging it.
+static const std::chrono::milliseconds IDLE_TIMEOUT(2000);
+
+/**
+ * A stand-in for @c sai_denoise_feed: it costs a fixed amount of time per call and checks the samples arrive in
+ * order, the way the writer numbered them.
+ */
+class FakeDenoiseFeed {
+public:
+    /**
+     * Constructor.
+     *
+     * @param costPerCall The time each call takes.
+     */
+    explicit FakeDenoiseFeed(std::chrono::microseconds costPerCall = std::chrono::microseconds(0)) :
+            m_costPerCall{costPerCall},
+            m_nextSample{0},
+            m_wordsFed{0},
+            m_outOfOrder{0} {
+    }
+
+    /// @return A @c FeedFunction calling this fake.
+    StreamFeeder::FeedFunction function() {
+        return [this](const void* data, size_t nWords) { return feed(data, nWords); };
+    }
+
+    /// The fake feed itself.
+    bool feed(const void* data, size_t nWords) {
+        auto samples = static_cast<const int16_t*>(data);
+        for (size_t i = 0; i < nWords; ++i) {
+            if (samples[i] != m_nextSample) {
+                ++m_outOfOrder;
+                m_nextSample = samples[i];
+            }
+            ++m_nextSample;
+        }
+        m_wordsFed += nWords;
+        if (m_costPerCall > std::chrono::microseconds::zero()) {
+            std::this_thread::sleep_for(m_costPerCall);
+        }
+        return true;
+    }
+
+    /// The time each call takes.
+    const std::chrono::microseconds m_costPerCall;
+    /// The sample value expected next.
+    int16_t m_nextSample;
+    /// The number of words fed so far.
+    std::atomic<size_t> m_wordsFed;
+    /// The number of discontinuities seen.
+    size_t m_outOfOrder;
+};
+
+/// Test fixture which owns a microphone-like stream with a writer and a feeder reader.
+class StreamFeederTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto bufferSize = SharedBuffer::calculateBufferSize(STREAM_WORDS, WORD_SIZE, 2);
+        auto buffer = std::make_shared<SharedBuffer::Buffer>(bufferSize);
+        m_stream = SharedBuffer::create(buffer, WORD_SIZE, 2);
+        ASSERT_NE(nullptr, m_stream);
+        m_writer = m_stream->createWriter(Writer::Policy::NONBLOCKABLE);
+        m_reader = m_stream->createReader(Reader::Policy::BLOCKING);
+        ASSERT_NE(nullptr, m_writer);
+        ASSERT_NE(nullptr, m_reader);
+        m_nextSample = 0;
+    }
+
+    /**
+     * Writes consecutively numbered samples.
+     *
+     * @param nWords The number of words to write.
+     */
+    void writeSamples(size_t nWords) {
+        std::vector<int16_t> samples(nWords);
+        for (auto& sample : samples) {
+            sample = m_nextSample++;
+        }
+        ASSERT_EQ(static_cast<ssize_t>(nWords), m_writer->write(samples.data(), nWords));
+    }
+
+    std::shared_ptr<SharedBuffer> m_stream;
+    std::shared_ptr<Writer> m_writer;
+    std::shared_ptr<Reader> m_reader;
+    int16_t m_nextSample;
+};
+
+/// Invalid parameters are refused.
+TEST_F(StreamFeederTest, createRejectsInvalidParameters) {
+    FakeDenoiseFeed fake;
+    EXPECT_EQ(nullptr, StreamFeeder::create(nullptr, BATCH_WORDS, MAX_LATENCY, fake.function()));
+    EXPECT_EQ(nullptr, StreamFeeder::create(m_reader, 0, MAX_LATENCY, fake.function()));
+    EXPECT_EQ(nullptr, StreamFeeder::create(m_reader, BATCH_WORDS, std::chrono::milliseconds(0), fake.function()));
+    EXPECT_EQ(nullptr, StreamFeeder::create(m_reader, BATCH_WORDS, MAX_LATENCY, nullptr));
+    EXPECT_NE(nullptr, StreamFeeder::create(m_reader, BATCH_WORDS, MAX_LATENCY, fake.function()));
+}
+
+/// A backlog is fed in full batches back to back, without waiting between them.
+TEST_F(StreamFeederTest, backlogIsFedInFullBatchesWithoutWaiting) {
+    FakeDenoiseFeed fake;
+    auto feeder = StreamFeeder::create(m_reader, BATCH_WORDS, MAX_LATENCY, fake.function());
+    writeSamples(BATCH_WORDS * 10);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(StreamFeeder::Status::FED, feeder->feedOnce(IDLE_TIMEOUT));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, MAX_LATENCY);
+
+    auto statistics = feeder->getStatistics();
+    EXPECT_EQ(10u, statistics.feeds);
+    EXPECT_EQ(BATCH_WORDS * 10, statistics.wordsFed);
+    EXPECT_EQ(BATCH_WORDS * 10, statistics.maxBacklogWords);
+    EXPECT_EQ(0u, statistics.backlogWords);
+    EXPECT_EQ(0u, fake.m_outOfOrder);
+}
+
+/// A partial batch goes out once the max latency has passed, not after the idle timeout.
+TEST_F(StreamFeederTest, partialBatchIsFedAfterMaxLatency) {
+    FakeDenoiseFeed fake;
+    auto feeder = StreamFeeder::create(m_reader, BATCH_WORDS, MAX_LATENCY, fake.function());
+    writeSamples(BATCH_WORDS / 4);
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(StreamFeeder::Status::FED, feeder->feedOnce(IDLE_TIMEOUT));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(elapsed, MAX_LATENCY);
+    EXPECT_LT(elapsed, IDLE_TIMEOUT / 2);
+    EXPECT_EQ(BATCH_WORDS / 4, fake.m_wordsFed);
+}
+
+/// With nothing written, the feeder gives up after the idle timeout and feeds nothing.
+TEST_F(StreamFeederTest, idleStreamTimesOut) {
+    FakeDenoiseFeed fake;
+    auto feeder = StreamFeeder::create(m_reader, BATCH_WORDS, MAX_LATENCY, fake.function());
+    EXPECT_EQ(StreamFeeder::Status::TIMEDOUT, feeder->feedOnce(std::chrono::milliseconds(10)));
+    EXPECT_EQ(0u, fake.m_wordsFed);
+}
+
+/// A lapped reader is moved to live data and feeding carries on.
+TEST_F(StreamFeederTest, overrunIsRecovered) {
+    FakeDenoiseFeed fake;
+    auto feeder = StreamFeeder::create(m_reader, BATCH_WORDS, MAX_LATENCY, fake.function());
+    for (size_t written = 0; written <= m_stream->getDataSize(); written += BATCH_WORDS) {
+        writeSamples(BATCH_WORDS);
+    }
+
+    EXPECT_EQ(StreamFeeder::Status::OVERRUN, feeder->feedOnce(IDLE_TIMEOUT));
+    writeSamples(BATCH_WORDS);
+    EXPECT_EQ(StreamFeeder::Status::FED, feeder->feedOnce(IDLE_TIMEOUT));
+    EXPECT_EQ(1u, feeder->getStatistics().overruns);
+}
+
+/// The remaining data is fed after the writer closes, then the feeder reports the stream closed.
+TEST_F(StreamFeederTest, closedStreamIsDrained) {
+    FakeDenoiseFeed fake;
+    auto feeder = StreamFeeder::create(m_reader, BATCH_WORDS, MAX_LATENCY, fake.function());
+    writeSamples(BATCH_WORDS + BATCH_WORDS / 2);
+    m_writer->close();
+
+    EXPECT_EQ(StreamFeeder::Status::FED, feeder->feedOnce(IDLE_TIMEOUT));
+    EXPECT_EQ(StreamFeeder::Status::FED, feeder->feedOnce(IDLE_TIMEOUT));
+    EXPECT_EQ(StreamFeeder::Status::CLOSED, feeder->feedOnce(IDLE_TIMEOUT));
+    EXPECT_EQ(BATCH_WORDS + BATCH_WORDS / 2, fake.m_wordsFed);
+}
+
+/**
+ * A microphone writing 10 ms periods against an engine which needs a third of real time per batch: the backlog must
+ * stay within a few periods and every sample must reach the engine, in order.  The clock runs five times faster than
+ * real time to keep the test short.
+ */
+TEST_F(StreamFeederTest, backlogStaysBoundedAtRealTimeRate) {
+    const std::chrono::microseconds period(2000);
+    const size_t periods = 500;
+    FakeDenoiseFeed fake(period / 3);
+    auto feeder = StreamFeeder::create(m_reader, BATCH_WORDS, MAX_LATENCY, fake.function());
+
+    std::thread microphone([this, period, periods] {
+        auto next = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < periods; ++i) {
+            writeSamples(BATCH_WORDS);
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+        m_writer->close();
+    });
+
+    StreamFeeder::Status status;
+    do {
+        status = feeder->feedOnce(IDLE_TIMEOUT);
+    } while (StreamFeeder::Status::FED == status);
+    microphone.join();
+
+    auto statistics = feeder->getStatistics();
+    EXPECT_EQ(StreamFeeder::Status::CLOSED, status);
+    EXPECT_EQ(0u, statistics.overruns);
+    EXPECT_EQ(BATCH_WORDS * periods, statistics.wordsFed);
+    EXPECT_EQ(0u, fake.m_outOfOrder);
+    EXPECT_LE(statistics.maxBacklogWords, BATCH_WORDS * 8);
+    EXPECT_GE(statistics.maxFeedDuration, period / 3);
+    EXPECT_GE(statistics.totalFeedDuration, statistics.maxFeedDuration);
+}
+
+}  // namespace test
+}  // namespace kwd
+}  // namespace aisdk
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __AO_SINK_H_
+#define __AO_SINK_H_
+
+#include <memory>
+
+#include "AudioMediaPlayer/AOEngine.h"
+#include "AudioMediaPlayer/AudioSinkInterface.h"
+#include "AudioMediaPlayer/PlaybackConfiguration.h"
+
+struct ao_device;
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+/**
+ * A libao live device on the default driver.  @c write() blocks in @c ao_play() until the device has room.
+ */
+class AOSink : public AudioSinkInterface {
+public:
+    /**
+     * Opens the default libao device.
+     *
+     * @param aoEngine The libao engine, kept alive for as long as the device is open.
+     * @param config The format the device is opened with.
+     * @return The sink, or @c nullptr if the device could not be opened.
+     */
+    static std::unique_ptr<AOSink> create(
+        std::shared_ptr<AOEngine> aoEngine,
+        const PlaybackConfiguration& config = PlaybackConfiguration());
+
+    /// @name AudioSinkInterface methods.
+    /// @{
+    bool write(const uint8_t* data, size_t size) override;
+    /// @}
+
+    /**
+     * Destructor.  Closes the device.
+     */
+    ~AOSink();
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param aoEngine The libao engine.
+     * @param device The open device.
+     */
+    AOSink(std::shared_ptr<AOEngine> aoEngine, ao_device* device);
+
+    /// Keeps libao initialized while the device is open.
+    std::shared_ptr<AOEngine> m_engine;
+
+    /// The libao device.
+    ao_device* m_device;
+};
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
+#endif  // __AO_SINK_H_
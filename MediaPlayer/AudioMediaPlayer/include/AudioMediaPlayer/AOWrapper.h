@@ -12,14 +12,21 @@
 #ifndef __AOWRAPPER__H_
 #define __AOWRAPPER__H_
 
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 #include <stdbool.h>
 
-#include <ao/ao.h>
 #include <Utils/MediaPlayer/MediaPlayerInterface.h>
 #include <Utils/SafeShutdown.h>
+#include <Utils/Threading/Executor.h>
 #include "FFmpegInputControllerInterface.h"
+#include "AudioMediaPlayer/AudioMixer.h"
+#include "AudioMediaPlayer/AudioSinkInterface.h"
+#include "AudioMediaPlayer/DecoderInterface.h"
 #include "AudioMediaPlayer/FFmpegDecoder.h"
 #include "AOEngine.h"
 
@@ -30,7 +37,19 @@ namespace ffmpeg{
 /**
  * This class implements an media player.
  *
- * The implementation uses Libao APIs to play the audio and FFmpeg to decode and resample the media input.
+ * The implementation uses FFmpeg to decode and resample the media input, and plays the audio on a libao device of its
+ * own or on one source of an @c AudioMixer shared with other players.
+ *
+ * One playback thread lives as long as the player. The public methods change the player state and return at once;
+ * the thread picks up new sources and releases finished ones from a command queue, and decodes and writes while the
+ * state is @c PLAYING.
+ *
+ * A source queued with @c setNextSource() is opened, and the start of it decoded, on a prefetch thread while the
+ * current source plays; when the current source ends the playback thread swaps decoders and writes on to the same
+ * output, so there is no gap between the two.  The prefetch thread is started the first time it is needed.
+ *
+ * A local file played from its start is kept decoded in the @c DecodedAudioCache once it has been played to its end,
+ * or once @c preloadSource() has decoded it on the prefetch thread, and is played from memory after that.
  */	
 class AOWrapper 
 		: public utils::mediaPlayer::MediaPlayerInterface
@@ -63,6 +82,14 @@ public:
 	std::shared_ptr<AOEngine> aoEngine,
 	const PlaybackConfiguration& config = PlaybackConfiguration());
 
+    /**
+     * Creates a player which plays on a new source of a mixer, in the mixer's format, instead of opening a device.
+     *
+     * @param mixer The mixer.
+     * @return A pointer to the @c AOWrapper if succeed; @c nullptr otherwise.
+     */
+	static std::unique_ptr<AOWrapper> createForMixer(std::shared_ptr<AudioMixer> mixer);
+
     /// @name MediaPlayerInterface methods.
     ///@{
     SourceId setSource(const std::string& url, std::chrono::milliseconds offset) override;
@@ -74,8 +101,13 @@ public:
     bool stop(SourceId id) override;
 	bool pause(SourceId id) override;
 	bool resume(SourceId id) override;
+	std::chrono::milliseconds getOffset(SourceId id) override;
 	void setObserver(
 		std::shared_ptr<utils::mediaPlayer::MediaPlayerObserverInterface> playerObserver) override;
+	bool setGain(float gain, std::chrono::milliseconds rampDuration) override;
+	SourceId setNextSource(const std::string& url) override;
+	bool clearNextSource() override;
+	bool preloadSource(const std::string& url) override;
 	///@}
 	
 
@@ -91,14 +123,52 @@ private:
      * Constructor
      */	
     AOWrapper(
-    std::shared_ptr<AOEngine> aoEngine,
+    std::shared_ptr<AudioSinkInterface> output,
     const PlaybackConfiguration& config);
 		
-	/// initialize Portaudio
+	/// initialize the FFmpeg log callback.
 	bool initialize();
 
 	static void log_callback_report(void *ptr, int level, const char *fmt, va_list vl);
 
+	/**
+	 * A request to the playback thread.
+	 */
+	struct Command {
+		enum class Type {
+			/// Start using @c decoder for source @c id, unless it has been replaced or stopped meanwhile.
+			OPEN,
+			/// Release @c decoder if it is set, otherwise the decoder of source @c id.
+			CLOSE
+		};
+
+		/// What to do.
+		Type type;
+
+		/// The source the command is for.
+		SourceId id;
+
+		/// The decoder of a new source, for @c OPEN, or one to release, for @c CLOSE.
+		std::shared_ptr<DecoderInterface> decoder;
+	};
+
+	/**
+	 * A source queued by @c setNextSource().
+	 */
+	struct NextSource {
+		/// The id it plays under.
+		SourceId id;
+
+		/// Its decoder; the prefetch thread uses it until @c isReady is set.
+		std::shared_ptr<DecoderInterface> decoder;
+
+		/// Whether the prefetch thread has finished with it.
+		bool isReady;
+
+		/// The audio the prefetch thread decoded, played before the rest of the decoder's.
+		std::vector<Byte> primedAudio;
+	};
+
 	/**
      * Internal method used to create a new media queue and increment the request id.
      */
@@ -106,14 +176,94 @@ private:
 			std::unique_ptr<FFmpegInputControllerInterface> inputController,
 			std::chrono::milliseconds offset = std::chrono::milliseconds(0));
 
+	/**
+	 * Creates the decoder of a source: one reading the @c DecodedAudioCache if the audio is there, else one decoding
+	 * the input which keeps the audio there if it can be cached.
+	 *
+	 * @param inputController The input of the source.
+	 * @param offset The position the source starts at; only a source played from its start is cached.
+	 * @return The decoder, or @c nullptr if it can't be created.
+	 */
+	std::shared_ptr<DecoderInterface> createDecoder(
+		std::unique_ptr<FFmpegInputControllerInterface> inputController,
+		std::chrono::milliseconds offset);
+
+	/**
+	 * Decodes a source given to @c preloadSource() to its end, on @c m_prefetcher.
+	 *
+	 * @param decoder The decoder of the source, which keeps the audio in the cache.
+	 */
+	void decodeAhead(std::shared_ptr<DecoderInterface> decoder);
+
 	/// Internal method implements the stop media player logic. This method should be called after acquring @c m_mutex
     bool stopLocked();
 
-	/// Thread audio play handler method.
-    void doPlayAudioLoop();
+	/**
+	 * Discards @c m_next, if there is one.  This method must be called with @c m_operationMutex held.
+	 *
+	 * @return Whether there was one.
+	 */
+	bool dropNextSourceLocked();
+
+	/**
+	 * Opens a queued source and decodes the start of it, on @c m_prefetcher.
+	 *
+	 * @param decoder The decoder of the source.
+	 */
+	void prefetch(std::shared_ptr<DecoderInterface> decoder);
+
+	/**
+	 * Creates @c m_prefetcher if it hasn't been yet.  @c m_operationMutex must be held, and the player not be shutting
+	 * down.
+	 *
+	 * @return The prefetcher.
+	 */
+	utils::threading::Executor* getPrefetcherLocked();
+
+	/**
+	 * Carries on with @c m_next once the current source has ended, waiting for the prefetch thread to finish with it
+	 * first.  This method must be called on the playback thread with @c m_operationMutex held.
+	 *
+	 * @param lock A @c unique_lock on m_operationMutex, released while waiting for the prefetch.
+	 * @return Whether playback carried on; @c false if the queued source was discarded while waiting.
+	 */
+	bool handOffToNextSourceLocked(std::unique_lock<std::mutex>& lock);
+
+	/**
+	 * Computes the position of the source being decoded from the audio of it the output has played.  This method
+	 * must be called with @c m_operationMutex held.
+	 *
+	 * @return The position in milliseconds.
+	 */
+	std::chrono::milliseconds getOffsetLocked() const;
+
+	/// The playback thread: runs commands and plays the current source until shutdown.
+    void playbackLoop();
+
+	/**
+	 * Runs one command on the playback thread. This method must be called with @c m_operationMutex held.
+	 *
+	 * @param command The command.
+	 * @return A decoder which is no longer needed, to be destroyed without holding the lock; may be @c nullptr.
+	 */
+	std::shared_ptr<DecoderInterface> executeCommandLocked(Command command);
+
+	/**
+	 * Makes @c decoder the one played, with the position counted from what the output has been written so far.  This
+	 * method must be called on the playback thread with @c m_operationMutex held.
+	 *
+	 * @param id The source of @c decoder.
+	 * @param decoder The decoder.
+	 * @param offset The position the source starts at.
+	 * @return The decoder played before, to be destroyed without holding the lock; may be @c nullptr.
+	 */
+	std::shared_ptr<DecoderInterface> switchDecoderLocked(
+		SourceId id,
+		std::shared_ptr<DecoderInterface> decoder,
+		std::chrono::milliseconds offset);
 
 	/* Processing the stream for decoding and playback.
-	 * @note This method must only be called by threads @c doPlayAudioLoop() that have acquired @c m_operationMutex.
+	 * @note This method must only be called by the thread @c playbackLoop() that has acquired @c m_operationMutex.
      *
      * @param lock A @c unique_lock on m_operationMutex, allowing this method to release the lock around callbacks
      * that need to be invoked.
@@ -122,20 +272,40 @@ private:
 	
     /// The current source id.
     SourceId m_sourceId;
+
+	/// The last id handed out by @c setSource() or @c setNextSource().
+	SourceId m_lastSourceId;
 	
-    /// Keep a pointer to the libao(initialize) engine to guarantee that it doesn't 
-    /// get destroyed before other libao objects.
-    std::shared_ptr<AOEngine> m_engine;
+	/// The decoder of the source being played. Only the playback thread changes it, with @c m_operationMutex held.
+	std::shared_ptr<DecoderInterface> m_decoder;
+
+	/// The source @c m_decoder belongs to.
+	SourceId m_decoderId;
+
+	/// Audio of @c m_decoder decoded ahead of time by the prefetch thread, written before anything else is read.
+	std::vector<Byte> m_primedAudio;
+
+	/// The source queued to follow the current one, if any.
+	std::unique_ptr<NextSource> m_next;
 
-	/// A decoder object @c FFmpegDecoder.
-	std::shared_ptr<FFmpegDecoder> m_decoder;
+	/// The commands waiting for the playback thread.
+	std::deque<Command> m_commands;
 
-	/// A specific objects @c ao_device from libao library.
-	std::shared_ptr<ao_device> m_device;
+	/// Where the decoded audio is played: an @c AOSink or a source of an @c AudioMixer.
+	std::shared_ptr<AudioSinkInterface> m_output;
 		
     /// Save the initial media offset to compute total offset.
     std::chrono::milliseconds m_initialOffset;
 
+	/// The initial offset of the source of @c m_decoderId; @c m_initialOffset moves on to a new source first.
+	std::chrono::milliseconds m_decoderOffset;
+
+	/// The bytes written to the output before the source of @c m_decoderId, when the output counts them.
+	uint64_t m_outputBaseBytes;
+
+	/// The bytes of the source of @c m_decoderId written to the output, for an output which doesn't count.
+	uint64_t m_bytesWritten;
+
 	/// A type used to set audio playback parameters.
 	//ao_sample_format m_aoSampleformat;
 	
@@ -150,16 +320,22 @@ private:
     // The android media player configuration.
     PlaybackConfiguration m_config;
 
-	/// Internal thread that process the specify stream to play audio data.
+	/// The playback thread, started by @c initialize() and joined on shutdown.
 	std::thread m_playerThread;
 	
 	std::shared_ptr<utils::mediaPlayer::MediaPlayerObserverInterface> m_observer;
 
-	/// The condition variable used to wait @c libao operater.
+	/// The condition variable the playback thread waits on for a command or for the state to become @c PLAYING.
     std::condition_variable m_playerWaitCondition;
 		
     /// Mutex used to synchronize media player operations.
     std::mutex m_operationMutex;
+
+	/**
+	 * Opens queued sources on a thread of its own, as opening may wait on the network for seconds.  Created by the
+	 * first @c setNextSource() or @c preloadSource(), so players which never queue a source have no such thread.
+	 */
+	std::unique_ptr<utils::threading::Executor> m_prefetcher;
 	
 	/// Mutex used to synchronize @c request creation.
 	//std::mutex m_requestMutex;
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __AUDIO_MIXER_H_
+#define __AUDIO_MIXER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "AudioMediaPlayer/AudioSinkInterface.h"
+#include "AudioMediaPlayer/PlaybackConfiguration.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+/**
+ * Mixes the audio of any number of players onto one output.
+ *
+ * Each player writes its PCM to a source from @c createSource(), which buffers a few periods and blocks the player
+ * once they are full, much as @c ao_play() does.  A single thread takes one period from every source that has a full
+ * one, sums them with saturation and writes the result to the output in periods of a fixed size.  A source holding
+ * less than a period (the end of a track, or a player falling behind) is mixed in, padded with silence, once its
+ * audio has waited for a whole period.  Nothing is written while every source is empty.
+ *
+ * Each source has a gain, which @c AudioSinkInterface::setGain() ramps linearly frame by frame so ducking a source
+ * under another does not click.
+ *
+ * Only native-endian signed 16 bit PCM is supported.
+ */
+class AudioMixer : public std::enable_shared_from_this<AudioMixer> {
+public:
+    /// The default length of one period.
+    static const std::chrono::milliseconds DEFAULT_PERIOD_DURATION;
+
+    /// The default number of periods each source buffers.
+    static const size_t DEFAULT_PERIODS_PER_SOURCE = 4;
+
+    /**
+     * Creates a mixer and starts its thread.
+     *
+     * @param output Where the mixed audio goes.
+     * @param config The format of the sources and of the output.
+     * @param periodDuration The length of the periods written to @c output.
+     * @param periodsPerSource How many periods each source buffers before blocking its writer.
+     * @return The mixer, or @c nullptr if the arguments are invalid.
+     */
+    static std::shared_ptr<AudioMixer> create(
+        std::unique_ptr<AudioSinkInterface> output,
+        const PlaybackConfiguration& config = PlaybackConfiguration(),
+        std::chrono::milliseconds periodDuration = DEFAULT_PERIOD_DURATION,
+        size_t periodsPerSource = DEFAULT_PERIODS_PER_SOURCE);
+
+    /**
+     * Adds a source.  The source keeps the mixer alive and leaves the mix when it is destroyed.
+     *
+     * @return The sink a player writes the source's audio to.
+     */
+    std::shared_ptr<AudioSinkInterface> createSource();
+
+    /**
+     * Returns the format of the sources and of the output.
+     *
+     * @return The format.
+     */
+    const PlaybackConfiguration& getConfiguration() const;
+
+    /**
+     * Returns the size of the periods written to the output.
+     *
+     * @return The size in bytes.
+     */
+    size_t getPeriodBytes() const;
+
+    /**
+     * Destructor.  Stops the mixing thread; audio still buffered is dropped.
+     */
+    ~AudioMixer();
+
+private:
+    class Source;
+
+    /**
+     * Constructor.
+     */
+    AudioMixer(
+        std::unique_ptr<AudioSinkInterface> output,
+        const PlaybackConfiguration& config,
+        size_t periodFrames,
+        std::chrono::milliseconds periodDuration,
+        size_t periodsPerSource);
+
+    /// The mixing thread.
+    void mixLoop();
+
+    /**
+     * Waits until some source has a period to give, or the mixer shuts down.
+     *
+     * @param lock A lock on @c m_mutex.
+     * @return @c false if the mixer is shutting down.
+     */
+    bool waitForPeriodLocked(std::unique_lock<std::mutex>& lock);
+
+    /**
+     * Sums one period of every source which has one into @c m_accumulator.
+     */
+    void accumulatePeriodLocked();
+
+    /// The mixed audio goes here; only the mixing thread uses it.
+    std::unique_ptr<AudioSinkInterface> m_output;
+
+    /// The format of the sources and of the output.
+    const PlaybackConfiguration m_config;
+
+    /// The number of samples, over all channels, in one period.
+    const size_t m_periodSamples;
+
+    /// The length of one period.
+    const std::chrono::milliseconds m_periodDuration;
+
+    /// The number of samples each source buffers.
+    const size_t m_sourceCapacity;
+
+    /// Serializes access to the sources and @c m_isShuttingDown.
+    std::mutex m_mutex;
+
+    /// Notified when a source gets audio, and on shutdown.
+    std::condition_variable m_dataAvailable;
+
+    /// Notified when the mixer takes audio from the sources, and when a source is flushed.
+    std::condition_variable m_spaceAvailable;
+
+    /// The sources in the mix.
+    std::vector<Source*> m_sources;
+
+    /// Whether the mixing thread should exit.
+    bool m_isShuttingDown;
+
+    /// The sum of the sources for the period being mixed; only the mixing thread uses it.
+    std::vector<int32_t> m_accumulator;
+
+    /// The saturated period written to @c m_output; only the mixing thread uses it.
+    std::vector<int16_t> m_period;
+
+    /// The mixing thread.
+    std::thread m_thread;
+};
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
+#endif  // __AUDIO_MIXER_H_
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __AUDIO_SINK_INTERFACE_H_
+#define __AUDIO_SINK_INTERFACE_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+/**
+ * Where a player writes the PCM it decoded: a libao device (@c AOSink), a file or nothing (@c FileSink), or one
+ * source of an @c AudioMixer.
+ */
+class AudioSinkInterface {
+public:
+    /**
+     * Destructor.
+     */
+    virtual ~AudioSinkInterface() = default;
+
+    /**
+     * Writes PCM in the format the sink was set up for, blocking for as long as the output needs to take it.
+     *
+     * @param data The samples.
+     * @param size The number of bytes in @c data.
+     * @return @c true if all of @c data was accepted; @c false if the write failed or was cut short by @c flush().
+     */
+    virtual bool write(const uint8_t* data, size_t size) = 0;
+
+    /**
+     * Discards audio written but not yet played and makes a @c write() blocked in another thread return.  Sinks
+     * which keep nothing back do nothing.
+     */
+    virtual void flush() {
+    }
+
+    /**
+     * Ramps the volume of what is written from now on towards @c gain.
+     *
+     * @param gain The new gain, from 0 (silent) to 1 (unchanged).
+     * @param rampDuration How long the change takes.
+     * @return @c true if the sink applies gain; the default does not.
+     */
+    virtual bool setGain(float gain, std::chrono::milliseconds rampDuration) {
+        return false;
+    }
+
+    /**
+     * Reports how far the audio written has got, so a player can tell its position from what was actually played.
+     *
+     * @param[out] written The bytes @c write() has accepted since the sink was created, less those @c flush() dropped.
+     * @param[out] played How many of those have been handed to the device.
+     * @return @c true if the sink counts; the default does not, as a sink whose @c write() returns once the device
+     * has the data plays everything that was written.
+     */
+    virtual bool getByteCounts(uint64_t* written, uint64_t* played) const {
+        return false;
+    }
+};
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
+#endif  // __AUDIO_SINK_INTERFACE_H_
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __CACHINGDECODER_H_
+#define __CACHINGDECODER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "AudioMediaPlayer/DecodedAudioCache.h"
+#include "AudioMediaPlayer/DecoderInterface.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+/**
+ * Passes on the audio of another decoder, keeping a copy of it which goes to a @c DecodedAudioCache once the
+ * decoder has been read to its end.  A source stopped, failing or too long to cache is not kept; one too long is
+ * logged with its size once read to the end.
+ */
+class CachingDecoder : public DecoderInterface {
+public:
+    /**
+     * Constructor.
+     *
+     * @param decoder The decoder read.
+     * @param key The key the audio is kept under.
+     * @param cache The cache to keep the audio in.
+     */
+    CachingDecoder(std::shared_ptr<DecoderInterface> decoder, const std::string& key, DecodedAudioCache& cache);
+
+    /// @name DecoderInterface methods
+    /// @{
+    std::pair<Status, size_t> read(Byte* buffer, size_t size) override;
+    void abort() override;
+    /// @}
+
+private:
+    /// The decoder read.
+    const std::shared_ptr<DecoderInterface> m_decoder;
+
+    /// The key the audio is kept under.
+    const std::string m_key;
+
+    /// The cache to keep the audio in.
+    DecodedAudioCache& m_cache;
+
+    /// The audio read so far.
+    std::vector<Byte> m_audio;
+
+    /// The bytes of audio read so far, counted on after they become too many to keep.
+    size_t m_decodedBytes;
+
+    /// Whether the audio is still being copied or counted; cleared once it can't be kept or is done.
+    bool m_isRecording;
+};
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
+
+#endif  // __CACHINGDECODER_H_
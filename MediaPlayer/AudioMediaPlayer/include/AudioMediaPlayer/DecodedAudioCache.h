@@ -0,0 +1,122 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __DECODEDAUDIOCACHE_H_
+#define __DECODEDAUDIOCACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "AudioMediaPlayer/PlaybackConfiguration.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+/**
+ * Keeps the decoded audio of media played again and again, such as prompts, so that playing it later needs no decoding
+ * and starts at once.
+ *
+ * Audio is kept in the output format of the player which decoded it, under a key made by @c makeKey() from the key of
+ * the stream and that format.  The cache holds at most a number of bytes; when it is full the audio used least
+ * recently is dropped first.  The cache is shared by every player in the process and is thread safe.
+ */
+class DecodedAudioCache {
+public:
+    /// Represents one byte of data.
+    using Byte = uint8_t;
+
+    /// Decoded audio; entries are shared with the players playing them and never change.
+    using Audio = std::shared_ptr<const std::vector<Byte>>;
+
+    /// The bytes the cache of the process holds at most: about a minute and a half of 48kHz stereo audio.
+    static constexpr size_t DEFAULT_MAX_BYTES = 16 * 1024 * 1024;
+
+    /**
+     * The size of the largest audio kept, about 44s of 48kHz stereo, so that the alarm and music prompts fit; longer
+     * media is decoded every time.
+     */
+    static constexpr size_t MAX_ENTRY_BYTES = 8 * 1024 * 1024;
+
+    /// @return The cache of this process.
+    static DecodedAudioCache& instance();
+
+    /**
+     * Builds the key of decoded audio.
+     *
+     * @param streamKey The key of the stream, which changes whenever the media does; see
+     * @c FFmpegInputControllerInterface::getStreamCacheKey().
+     * @param config The format the audio is decoded to.
+     * @return The key, or an empty string if @c streamKey is empty.
+     */
+    static std::string makeKey(const std::string& streamKey, const PlaybackConfiguration& config);
+
+    /**
+     * Constructor.
+     *
+     * @param maxBytes The bytes of audio the cache holds at most.
+     */
+    explicit DecodedAudioCache(size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    /**
+     * Looks audio up, and makes it the one used most recently.
+     *
+     * @param key The key the audio was stored under.
+     * @return The audio, or @c nullptr if it isn't cached.
+     */
+    Audio get(const std::string& key);
+
+    /**
+     * Keeps audio, replacing any under the same key and dropping the audio used least recently to make room.
+     *
+     * @param key The key of the audio; an empty key is ignored.
+     * @param audio The audio.
+     * @return Whether the audio is kept; audio larger than @c MAX_ENTRY_BYTES or than the cache is not.
+     */
+    bool put(const std::string& key, Audio audio);
+
+    /// @return The bytes of audio held.
+    size_t getBytes() const;
+
+    /// Drops all audio.
+    void clear();
+
+private:
+    /// A key and its audio.
+    using Entry = std::pair<std::string, Audio>;
+
+    /// The bytes of audio held at most.
+    const size_t m_maxBytes;
+
+    /// Serializes access to the members below.
+    mutable std::mutex m_mutex;
+
+    /// The entries, the one used most recently first.
+    std::list<Entry> m_entries;
+
+    /// The entries by key.
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+
+    /// The bytes of audio in @c m_entries.
+    size_t m_bytes;
+};
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
+
+#endif  // __DECODEDAUDIOCACHE_H_
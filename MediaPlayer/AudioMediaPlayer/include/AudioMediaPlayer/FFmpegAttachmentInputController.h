@@ -12,6 +12,7 @@
 #ifndef __FFMPEG_ATTACHMENT_INPUTCONTROLLER_H_
 #define __FFMPEG_ATTACHMENT_INPUTCONTROLLER_H_
 
+#include <chrono>
 #include <memory>
 
 #include <Utils/Attachment/AttachmentReader.h>
@@ -34,16 +35,28 @@ namespace ffmpeg {
  */
 class FFmpegAttachmentInputController : public FFmpegInputControllerInterface {
 public:
+    /// The default size of the buffer FFmpeg reads the attachment through: a regular page.
+    static constexpr int DEFAULT_BUFFER_SIZE = 4096;
+
+    /// How long a read waits for the writer before it checks whether the decoder has been stopped.
+    static const std::chrono::milliseconds READ_WAIT_SLICE;
+
+    /// How long a read waits for the writer in all before it gives the input up as ended.
+    static const std::chrono::milliseconds MAX_STARVATION;
+
     /**
      * Creates an input reader object.
      *
      * @param reader A pointer to the attachment reader.
      * @param format The audio format to be used to interpret raw audio data. This can be @c nullptr.
+     * @param bufferSize The size of the buffer FFmpeg reads through, which is also how much it probes.  A smaller
+     * buffer starts a stream sooner; a larger one means fewer reads.
      * @return A pointer to the @c FFmpegAttachmentInputController if succeed; @c nullptr otherwise.
      */
     static std::unique_ptr<FFmpegAttachmentInputController> create(
         std::shared_ptr<utils::attachment::AttachmentReader> reader,
-        const utils::AudioFormat* format = nullptr);
+        const utils::AudioFormat* format = nullptr,
+        int bufferSize = DEFAULT_BUFFER_SIZE);
 
     /// @name FFmpegInputControllerInterface methods
     /// @{
@@ -51,6 +64,7 @@ public:
     bool next() override;
 	AVFormatContext* createNewFormatContext() override;
     std::tuple<Result, std::shared_ptr<AVFormatContext>, std::chrono::milliseconds> getCurrentFormatContextOpen() override;
+    bool getStreamDescription(StreamDescription* description) const override;
     /// @}
 
     /**
@@ -65,14 +79,19 @@ private:
      * @param reader A pointer to the attachment reader.
      * @param inputFormat Optional parameter that can be used to force an input format.
      * @param inputOptions Optional parameter that can be used to force an set codec options.
+     * @param description What the format says of the input, if it was given.
+     * @param bufferSize The size of the buffer FFmpeg reads through.
      */
     FFmpegAttachmentInputController(
         std::shared_ptr<utils::attachment::AttachmentReader> reader,
-        std::shared_ptr<AVInputFormat> inputFormat = nullptr,
-        std::shared_ptr<AVDictionary> inputOptions = nullptr);
+        std::shared_ptr<AVInputFormat> inputFormat,
+        std::shared_ptr<AVDictionary> inputOptions,
+        const StreamDescription* description,
+        int bufferSize);
 
     /**
-     * Function used to provide input data to the decoder.
+     * Function used to provide input data to the decoder.  Blocks in the reader until data arrives, the writer
+     * closes, the decoder is stopped or the input has starved for @c MAX_STARVATION.
      *
      * @param buffer Buffer to copy the data to.
      * @param bufferSize The buffer size in bytes.
@@ -80,6 +99,13 @@ private:
      */
     int read(uint8_t* buffer, int bufferSize);
 
+    /**
+     * Asks the decoder, through the interrupt callback it set on the format context, whether it has been stopped.
+     *
+     * @return @c true if the read should give up.
+     */
+    bool isInterrupted() const;
+
     /**
      * Feed AvioBuffer with some data from the input controller.
      *
@@ -90,10 +116,6 @@ private:
      */
     static int feedBuffer(void* userData, uint8_t* buffer, int bufferSize);
 
-	/// Wait tryagain count.
-	/// pretry again duration is READ_TIMEOUT. so toal wait timeout is m_tryCount*tryagain.
-	int m_tryCount;
-
 	/**
 	 * This flag indicates that at least one frame of vaild data has been detected.
 	 * It will allow the task following the @c'avformat_open_input'function to
@@ -110,9 +132,22 @@ private:
     /// Optional input format options that can be used to force some format parameters.
     std::shared_ptr<AVDictionary> m_inputOptions;
 
+    /// Whether the format was given, in which case @c m_description describes the input.
+    bool m_hasDescription;
+
+    /// The input as the given format describes it.
+    StreamDescription m_description;
+
+    /// The size of the buffer FFmpeg reads through.
+    const int m_bufferSize;
+
     /// Keep a pointer to the avioContext to avoid memory leaks.
     std::shared_ptr<AVIOContext> m_ioContext;
 
+    /// The interrupt callback of the format context being read, with its argument.
+    int (*m_interruptCallback)(void*);
+    void* m_interruptOpaque;
+
 	/// The current format context original point @c AVFormatContext.
 	AVFormatContext* m_avFormatContext;
 };
@@ -26,6 +26,7 @@ extern "C" {
 }
 
 #include "DecoderInterface.h"
+#include "FFmpegDeleter.h"
 #include "FFmpegInputControllerInterface.h"
 #include "PlaybackConfiguration.h"
 
@@ -169,7 +170,8 @@ private:
         int getOffset() const;
 
         /**
-         * Resize the buffer if current capacity is less than the required minimum.
+         * Resize the buffer if current capacity is less than the required minimum. The frame is kept and its buffer
+         * at least doubles when it grows, so a stream settles on one buffer after its first frames.
          *
          * @param minimumCapacity The minimum capacity required.
          */
@@ -216,7 +218,15 @@ private:
      *
      * @param inputFrame The frame with the media data that has to be resampled.
      */
-    void resample(std::shared_ptr<AVFrame> inputFrame);
+    void resample(const std::shared_ptr<AVFrame>& inputFrame);
+
+    /**
+     * After a seek, drops the resampled samples which come before the position asked for.  The demuxer can only seek
+     * to a packet, and a compressed stream is seeked back to a keyframe, so the first frames decoded start early.
+     *
+     * @param inputFrame The decoded frame which was just resampled into @c m_unreadData.
+     */
+    void discardPreRoll(const AVFrame& inputFrame);
 
     /// Call the decoder to start processing more input data.
     void decode();
@@ -241,6 +251,16 @@ private:
      */
     void initialize();
 
+    /**
+     * Opens the stream without @c avformat_find_stream_info(), from what is known of it beforehand.
+     *
+     * @param description The codec, rate and channels of the stream as the input or the cache describes it.
+     * @param[out] codec Set to the decoder of the stream.
+     * @return The index of the stream, or a negative value if what the demuxer found doesn't match the description,
+     * in which case the stream should be probed.
+     */
+    int openDescribedStream(const StreamDescription& description, AVCodec** codec);
+
     /**
      * Parse the status returned by an FFmpeg function.
      *
@@ -253,7 +273,7 @@ private:
      * @param functionName The name of the function that was called. This is used for logging purpose.
      * @return @c true if status indicates that the operation succeeded or EOF was found; @c false, otherwise.
      */
-    bool transitionStateUsingStatus(int status, DecodingState nextState, const std::string& functionName);
+    bool transitionStateUsingStatus(int status, DecodingState nextState, const char* functionName);
 
     /// The decoder state.
     std::atomic<DecodingState> m_state;
@@ -276,8 +296,14 @@ private:
     /// Pointer to the codec context. This is used during the decoding process.
     std::shared_ptr<AVCodecContext> m_codecContext;
 
-    /// Pointer to the resample context.
-    std::shared_ptr<SwrContext> m_swrContext;
+    /// Pointer to the resample context. It is set up again, not reallocated, when the input moves to the next media.
+    std::unique_ptr<SwrContext, SwrContextDeleter> m_swrContext;
+
+    /// The frame the codec decodes into, allocated once and reused for every frame of the stream.
+    std::shared_ptr<AVFrame> m_decodedFrame;
+
+    /// The packet the demuxer reads into, allocated once and unreferenced after each use.
+    std::shared_ptr<AVPacket> m_packet;
 
     /// Object that keeps the unread data leftover from the last @c read.
     UnreadData m_unreadData;
@@ -290,6 +316,22 @@ private:
 
     /// Time when the initialize method started. This is used to abort initialization that might be taking too long.
     std::chrono::time_point<std::chrono::steady_clock> m_initializeStartTime;
+
+    /// The position playback should start at, in the time base of the stream; @c AV_NOPTS_VALUE when there is none
+    /// or once it has been reached.
+    int64_t m_seekTarget;
+
+    /// The index of the stream being decoded.
+    int m_streamIndex;
+
+    /// Whether the stream was opened without probing.
+    bool m_isFastOpen;
+
+    /// Whether the first decoded sample has been returned and its latency logged.
+    bool m_hasReturnedFirstSample;
+
+    /// Time of the first call to @c read. The time to the first sample is measured from it.
+    std::chrono::time_point<std::chrono::steady_clock> m_firstReadTime;
 };
 
 }  // namespace ffmpeg
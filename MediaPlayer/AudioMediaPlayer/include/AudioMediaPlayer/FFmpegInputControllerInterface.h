@@ -15,8 +15,11 @@
 
 #include <chrono>
 #include <ostream>
+#include <string>
 #include <tuple>
 
+#include "AudioMediaPlayer/StreamInfoCache.h"
+
 struct AVFormatContext;
 
 namespace aisdk {
@@ -68,6 +71,23 @@ public:
     virtual std::tuple<Result, std::shared_ptr<AVFormatContext>, std::chrono::milliseconds>
     getCurrentFormatContextOpen() = 0;
 
+    /**
+     * Describes the current input when its format is known up front, e.g. raw PCM of a given rate, so the decoder
+     * can open it without probing.
+     *
+     * @param[out] description Set to the description of the input if it is known.
+     * @return @c true if the input is known; @c false if it has to be probed.
+     */
+    virtual bool getStreamDescription(StreamDescription* description) const { return false; }
+
+    /**
+     * Returns a key which identifies the current input as long as its content doesn't change, under which the
+     * decoder caches what it probed.
+     *
+     * @return The key, or an empty string if the input can't be cached.
+     */
+    virtual std::string getStreamCacheKey() const { return ""; }
+
     /**
      * Destructor
      */
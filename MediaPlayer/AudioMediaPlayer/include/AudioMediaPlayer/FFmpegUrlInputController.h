@@ -46,6 +46,7 @@ public:
     std::tuple<Result, std::shared_ptr<AVFormatContext>, std::chrono::milliseconds> getCurrentFormatContextOpen() override;
     bool hasNext() const override;
     bool next() override;
+    std::string getStreamCacheKey() const override;
     /// @}
 
     /**
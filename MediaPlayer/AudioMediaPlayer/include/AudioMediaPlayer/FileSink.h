@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __FILE_SINK_H_
+#define __FILE_SINK_H_
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "AudioMediaPlayer/AudioSinkInterface.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+/**
+ * A stand-in for the libao device which writes the raw PCM to a file, or throws it away, as fast as it comes.  Lets
+ * the players and the @c AudioMixer run on a machine without audio hardware.
+ */
+class FileSink : public AudioSinkInterface {
+public:
+    /**
+     * Creates a sink writing to a file.
+     *
+     * @param path The file to create or truncate.
+     * @return The sink, or @c nullptr if the file could not be opened.
+     */
+    static std::unique_ptr<FileSink> create(const std::string& path);
+
+    /**
+     * Creates a sink which only counts what it is given.
+     *
+     * @return The sink.
+     */
+    static std::unique_ptr<FileSink> createNull();
+
+    /// @name AudioSinkInterface methods.
+    /// @{
+    bool write(const uint8_t* data, size_t size) override;
+    /// @}
+
+    /**
+     * Returns the number of bytes written so far.
+     *
+     * @return The number of bytes.
+     */
+    size_t getBytesWritten() const;
+
+    /**
+     * Destructor.  Closes the file.
+     */
+    ~FileSink();
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param file The open file, or @c nullptr to discard the audio.
+     */
+    explicit FileSink(FILE* file);
+
+    /// The file written to, or @c nullptr.
+    FILE* m_file;
+
+    /// The number of bytes written so far.
+    std::atomic<size_t> m_bytesWritten;
+};
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
+#endif  // __FILE_SINK_H_
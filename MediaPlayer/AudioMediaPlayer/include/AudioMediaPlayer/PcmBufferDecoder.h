@@ -0,0 +1,62 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __PCMBUFFERDECODER_H_
+#define __PCMBUFFERDECODER_H_
+
+#include <atomic>
+#include <memory>
+
+#include "AudioMediaPlayer/DecodedAudioCache.h"
+#include "AudioMediaPlayer/DecoderInterface.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+/**
+ * A decoder of audio decoded already, such as audio from the @c DecodedAudioCache: reading only copies it out.
+ */
+class PcmBufferDecoder : public DecoderInterface {
+public:
+    /**
+     * Constructor.
+     *
+     * @param audio The audio, in the output format of the player.
+     * @param frameSize The bytes of one frame of the audio, which reads never split.
+     */
+    PcmBufferDecoder(DecodedAudioCache::Audio audio, size_t frameSize);
+
+    /// @name DecoderInterface methods
+    /// @{
+    std::pair<Status, size_t> read(Byte* buffer, size_t size) override;
+    void abort() override;
+    /// @}
+
+private:
+    /// The audio.
+    const DecodedAudioCache::Audio m_audio;
+
+    /// The bytes of one frame.
+    const size_t m_frameSize;
+
+    /// The bytes of @c m_audio read so far.
+    size_t m_position;
+
+    /// Whether @c abort() has been called.
+    std::atomic<bool> m_isAborted;
+};
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
+
+#endif  // __PCMBUFFERDECODER_H_
@@ -16,6 +16,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <ostream>
 
 namespace aisdk {
 namespace mediaPlayer {
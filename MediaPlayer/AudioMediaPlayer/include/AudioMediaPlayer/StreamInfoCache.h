@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#ifndef __STREAMINFOCACHE_H_
+#define __STREAMINFOCACHE_H_
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+/**
+ * What the decoder needs to know about an audio stream to open it without probing.
+ */
+struct StreamDescription {
+    /// The codec, an @c AVCodecID.
+    int codecId;
+
+    /// The sample rate in Hz.
+    int sampleRate;
+
+    /// The number of channels.
+    int channels;
+};
+
+/**
+ * Remembers the description of streams the decoder has probed, so that opening the same media again can skip
+ * @c avformat_find_stream_info().
+ *
+ * The key must change whenever the media does, e.g. a file's path with its modification time and size.  The cache is
+ * shared by every player in the process and is thread safe.
+ */
+class StreamInfoCache {
+public:
+    /// The number of streams remembered; the cache starts over when it is full.
+    static constexpr size_t MAX_ENTRIES = 64;
+
+    /// @return The cache of this process.
+    static StreamInfoCache& instance();
+
+    /**
+     * Looks a stream up.
+     *
+     * @param key The key the stream was stored under.
+     * @param[out] description Set to the stream's description if it is found.
+     * @return @c true if the stream is known.
+     */
+    bool get(const std::string& key, StreamDescription* description);
+
+    /**
+     * Remembers a stream.
+     *
+     * @param key The key of the stream; an empty key is ignored.
+     * @param description The description of the stream.
+     */
+    void put(const std::string& key, const StreamDescription& description);
+
+    /// Forgets every stream.
+    void clear();
+
+private:
+    /// Serializes access to @c m_entries.
+    std::mutex m_mutex;
+
+    /// The known streams by key.
+    std::unordered_map<std::string, StreamDescription> m_entries;
+};
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
+
+#endif  // __STREAMINFOCACHE_H_
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <cstring>
+
+#include <ao/ao.h>
+#include <Utils/Logging/Logger.h>
+#include "AudioMediaPlayer/AOSink.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG{"AOSink"};
+
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+/**
+ * Returns the bits per sample @c ao_sample_format wants for a sample format.
+ */
+static int convertBitsPerSample(PlaybackConfiguration::SampleFormat format) {
+    switch (format) {
+        case PlaybackConfiguration::SampleFormat::UNSIGNED_8:
+            return 8;
+        case PlaybackConfiguration::SampleFormat::SIGNED_16:
+            return 16;
+        case PlaybackConfiguration::SampleFormat::SIGNED_32:
+            return 32;
+    }
+
+    AISDK_WARN(LX("invalidFormat").d("format", static_cast<int>(format)));
+    return 16;
+}
+
+std::unique_ptr<AOSink> AOSink::create(std::shared_ptr<AOEngine> aoEngine, const PlaybackConfiguration& config) {
+    if (!aoEngine) {
+        AISDK_ERROR(LX("createFailed").d("reason", "aoEngineIsNullptr"));
+        return nullptr;
+    }
+
+    ao_sample_format format;
+    // Bzero the structs @c ao_sample_format.
+    std::memset(&format, 0, sizeof format);
+    format.bits = convertBitsPerSample(config.sampleFormat());
+    format.channels = config.numberChannels();
+    format.rate = config.sampleRate();
+    format.byte_format = (config.isLittleEndian() ? AO_FMT_LITTLE : AO_FMT_BIG);
+
+    auto device = ao_open_live(aoEngine->getDefaultDriver(), &format, NULL);
+    if (!device) {
+        AISDK_ERROR(LX("createFailed").d("reason", "errorOpeningDevice"));
+        return nullptr;
+    }
+
+    return std::unique_ptr<AOSink>(new AOSink(aoEngine, device));
+}
+
+AOSink::AOSink(std::shared_ptr<AOEngine> aoEngine, ao_device* device) : m_engine{aoEngine}, m_device{device} {
+}
+
+AOSink::~AOSink() {
+    ao_close(m_device);
+}
+
+bool AOSink::write(const uint8_t* data, size_t size) {
+    if (ao_play(m_device, reinterpret_cast<char*>(const_cast<uint8_t*>(data)), size) == 0) {
+        AISDK_ERROR(LX("writeFailed").d("reason", "aoPlayFailed").d("size", size));
+        return false;
+    }
+    return true;
+}
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
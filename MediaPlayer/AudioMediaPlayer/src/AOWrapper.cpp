@@ -9,8 +9,7 @@
  * express or implied. See the License for the specific language governing
  * permissions and limitations under the License.
  */
-// memset references
-#include <cstring>
+#include <cstdio>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -22,8 +21,11 @@ extern "C" {
 #include "AudioMediaPlayer/FFmpegStreamInputController.h"
 #include "AudioMediaPlayer/FFmpegAttachmentInputController.h"
 //#include "AudioMediaPlayer/FFmpegDecoder.h"
+#include "AudioMediaPlayer/CachingDecoder.h"
+#include "AudioMediaPlayer/DecodedAudioCache.h"
+#include "AudioMediaPlayer/PcmBufferDecoder.h"
+#include "AudioMediaPlayer/AOSink.h"
 #include "AudioMediaPlayer/AOWrapper.h"
-#include "AudioMediaPlayer/AudioOutputDeleter.h"
 
 /// String to identify log entries originating from this file.
 static const std::string TAG{"AOWrapper"};
@@ -36,23 +38,6 @@ static constexpr size_t BUFFER_SIZE{16384u};	// 32768
 namespace aisdk {
 namespace mediaPlayer {
 namespace ffmpeg {
-/**
- * Describes the format of audio samples @c ao_sample_format.
- * It will convert the appropriate bits and channels according to config @c PlaybackConfiguration.
-*/
-static int convertBitsPreSample(PlaybackConfiguration::SampleFormat format) {
-	switch (format) {
-		case PlaybackConfiguration::SampleFormat::UNSIGNED_8:
-			return 8;
-		case PlaybackConfiguration::SampleFormat::SIGNED_16:
-			return 16;
-		case PlaybackConfiguration::SampleFormat::SIGNED_32:
-			return 32;
-	}
-
-	AISDK_WARN(LX("invalidFormat").d("format", static_cast<int>(format)));
-	return 16;
-}
 
 std::unique_ptr<AOWrapper> AOWrapper::create(
 	std::shared_ptr<AOEngine> aoEngine,
@@ -61,9 +46,15 @@ std::unique_ptr<AOWrapper> AOWrapper::create(
 		AISDK_ERROR(LX("createFailed").d("reason", "aoEngineIsNullptr"));
 		return nullptr;
 	}
+
+	std::shared_ptr<AudioSinkInterface> device = AOSink::create(aoEngine, config);
+	if(!device) {
+		AISDK_ERROR(LX("createFailed").d("reason", "openDeviceFailed"));
+		return nullptr;
+	}
 	
 	auto player = std::unique_ptr<AOWrapper>(
-			new AOWrapper(aoEngine, config));
+			new AOWrapper(device, config));
 	if(!player->initialize()){
 		AISDK_ERROR(LX("createFailed").d("reason", "initializeFailedAOWrapper"));
 		return nullptr;
@@ -72,6 +63,22 @@ std::unique_ptr<AOWrapper> AOWrapper::create(
 	return player;
 }
 
+std::unique_ptr<AOWrapper> AOWrapper::createForMixer(std::shared_ptr<AudioMixer> mixer) {
+	if(!mixer) {
+		AISDK_ERROR(LX("createForMixerFailed").d("reason", "mixerIsNullptr"));
+		return nullptr;
+	}
+
+	auto player = std::unique_ptr<AOWrapper>(
+			new AOWrapper(mixer->createSource(), mixer->getConfiguration()));
+	if(!player->initialize()){
+		AISDK_ERROR(LX("createForMixerFailed").d("reason", "initializeFailedAOWrapper"));
+		return nullptr;
+	}
+
+	return player;
+}
+
 AOWrapper::SourceId AOWrapper::setSource(const std::string& url, std::chrono::milliseconds offset){
 	auto input = FFmpegUrlInputController::create(url, offset);
 	auto newID = configureNewRequest(std::move(input), offset);
@@ -131,10 +138,16 @@ bool AOWrapper::play(SourceId id)
 
 bool AOWrapper::stopLocked(){
 
-	if(m_state != AOWrapper::AOPlayerState::IDLE) {
+	dropNextSourceLocked();
+	if(m_state != AOWrapper::AOPlayerState::IDLE && m_state != AOWrapper::AOPlayerState::FINISHED) {
 		m_state = AOWrapper::AOPlayerState::FINISHED;
-		if(m_decoder)
+		// Wake the playback thread if it is in the decoder; a source not opened yet has nothing to abort.
+		if(m_decoder && m_decoderId == m_sourceId)
 			m_decoder->abort();
+		// Drop what the output still holds of this source and wake a write blocked on it.
+		if(m_output)
+			m_output->flush();
+		m_commands.push_back(Command{Command::Type::CLOSE, m_sourceId, nullptr});
 
 		AISDK_DEBUG2(LX("stopLocked").d("reason", "startStopSuccess"));
 		m_playerWaitCondition.notify_one();
@@ -152,18 +165,10 @@ bool AOWrapper::stopLocked(){
 bool AOWrapper::stop(SourceId id)
 {
 	AISDK_DEBUG2(LX(__func__).d("requestId", id));
-	std::unique_lock<std::mutex> lock{m_operationMutex};
+	std::lock_guard<std::mutex> lock{m_operationMutex};
 	if (id == m_sourceId) {
-		if(stopLocked()) {
-			lock.unlock();
-			// Make sure current thread be destroyed.
-			if(m_playerThread.joinable()) {
-				m_playerWaitCondition.notify_one(); //
-				m_playerThread.join();
-			}
-			return true;
-		}
-		return false;
+		// The playback thread releases the decoder; no need to wait for it.
+		return stopLocked();
 	}
 	AISDK_ERROR(LX("stopFailed").d("reason", "Invalid Id").d("RequestId", id).d("currentId", m_sourceId));
 		
@@ -216,72 +221,236 @@ bool AOWrapper::resume(SourceId id){
 	return false;
 }
 
+std::chrono::milliseconds AOWrapper::getOffset(SourceId id) {
+	std::lock_guard<std::mutex> lock{m_operationMutex};
+	if (id == m_decoderId) {
+		return getOffsetLocked();
+	}
+	if (id == m_sourceId) {
+		// Not opened yet.
+		return m_initialOffset;
+	}
+	AISDK_ERROR(LX("getOffsetFailed").d("reason", "Invalid Id").d("RequestId", id).d("currentId", m_sourceId));
+	return std::chrono::milliseconds::zero();
+}
+
+std::chrono::milliseconds AOWrapper::getOffsetLocked() const {
+	uint64_t written = 0;
+	uint64_t played = m_bytesWritten;
+	if (m_output && m_output->getByteCounts(&written, &played)) {
+		// Audio of the previous source the output still held when this one was opened plays first.
+		played = played > m_outputBaseBytes ? played - m_outputBaseBytes : 0;
+	}
+	const uint64_t bytesPerSecond = m_config.sampleRate() * m_config.numberChannels() * sizeof(int16_t);
+	return m_decoderOffset + std::chrono::milliseconds(played * 1000 / bytesPerSecond);
+}
+
 void AOWrapper::setObserver(std::shared_ptr<utils::mediaPlayer::MediaPlayerObserverInterface> playerObserver){
 	std::lock_guard<std::mutex> lock{m_operationMutex};
     m_observer = playerObserver;
 }
 
-int AOWrapper::configureNewRequest(
-	std::unique_ptr<FFmpegInputControllerInterface> inputController,
-	std::chrono::milliseconds offset){
-	if(!inputController) {
-		AISDK_ERROR(LX("configureNewRequestFailed").d("reason", "inputControllerIsNullptr"));
+bool AOWrapper::setGain(float gain, std::chrono::milliseconds rampDuration) {
+	AISDK_DEBUG2(LX(__func__).d("gain", gain).d("rampDuration", rampDuration.count()));
+	std::lock_guard<std::mutex> lock{m_operationMutex};
+	// Only a mixer source applies gain; a player with a device of its own has to pause instead.
+	return m_output && m_output->setGain(gain, rampDuration);
+}
+
+AOWrapper::SourceId AOWrapper::setNextSource(const std::string& url) {
+	AISDK_DEBUG2(LX(__func__));
+	auto decoder = createDecoder(
+		FFmpegUrlInputController::create(url, std::chrono::milliseconds::zero()), std::chrono::milliseconds::zero());
+	if(!decoder) {
+		AISDK_ERROR(LX("setNextSourceFailed").d("reason", "createDecoderFailed"));
 		return utils::mediaPlayer::MediaPlayerInterface::ERROR;
 	}
 
+	SourceId id;
+	utils::threading::Executor* prefetcher;
 	{
-		// Use global lock to stop player and set new source id.
-        std::lock_guard<std::mutex> lock{m_operationMutex};
-        stopLocked();
-        m_sourceId++;
-        m_initialOffset = offset;
-		m_state = AOPlayerState::OPENED;
+		std::lock_guard<std::mutex> lock{m_operationMutex};
+		if(m_isShuttingDown || m_state == AOPlayerState::IDLE || m_state == AOPlayerState::FINISHED) {
+			AISDK_DEBUG2(LX("setNextSourceFailed").d("reason", "nothingPlaying"));
+			return utils::mediaPlayer::MediaPlayerInterface::ERROR;
+		}
+		dropNextSourceLocked();
+		m_next.reset(new NextSource{++m_lastSourceId, decoder, false, {}});
+		id = m_next->id;
+		prefetcher = getPrefetcherLocked();
 	}
+	// Ahead of any preloads waiting: the current source may be about to end.
+	prefetcher->executeToFront([this, decoder]() { prefetch(decoder); });
 
-	// Make sure current thread be destroyed.
-	if(m_playerThread.joinable()) {
-		m_playerWaitCondition.notify_one();	//
-		m_playerThread.join();
+	return id;
+}
+
+bool AOWrapper::clearNextSource() {
+	AISDK_DEBUG2(LX(__func__));
+	std::lock_guard<std::mutex> lock{m_operationMutex};
+	return dropNextSourceLocked();
+}
+
+bool AOWrapper::preloadSource(const std::string& url) {
+	AISDK_DEBUG2(LX(__func__).d("url", url));
+	auto input = FFmpegUrlInputController::create(url, std::chrono::milliseconds::zero());
+	if(!input) {
+		AISDK_ERROR(LX("preloadSourceFailed").d("reason", "createInputFailed"));
+		return false;
+	}
+	auto& cache = DecodedAudioCache::instance();
+	auto key = DecodedAudioCache::makeKey(input->getStreamCacheKey(), m_config);
+	if(key.empty()) {
+		AISDK_WARN(LX("preloadSourceFailed").d("reason", "notCacheable").d("url", url));
+		return false;
+	}
+	if(cache.get(key)) {
+		return true;
+	}
+	std::shared_ptr<DecoderInterface> decoder = FFmpegDecoder::create(std::move(input), m_config);
+	if(!decoder) {
+		AISDK_ERROR(LX("preloadSourceFailed").d("reason", "createDecoderFailed"));
+		return false;
+	}
+	decoder = std::make_shared<CachingDecoder>(decoder, key, cache);
+	utils::threading::Executor* prefetcher;
+	{
+		std::lock_guard<std::mutex> lock{m_operationMutex};
+		if(m_isShuttingDown) {
+			AISDK_ERROR(LX("preloadSourceFailed").d("reason", "shuttingDown"));
+			return false;
+		}
+		prefetcher = getPrefetcherLocked();
+	}
+	return prefetcher->execute([this, decoder]() { decodeAhead(decoder); });
+}
+
+utils::threading::Executor* AOWrapper::getPrefetcherLocked() {
+	if(!m_prefetcher) {
+		m_prefetcher.reset(new utils::threading::Executor(nullptr));
+	}
+	return m_prefetcher.get();
+}
+
+void AOWrapper::decodeAhead(std::shared_ptr<DecoderInterface> decoder) {
+	std::vector<Byte> buffer(BUFFER_SIZE);
+	auto status = DecoderInterface::Status::OK;
+	while(DecoderInterface::Status::OK == status) {
+		{
+			std::lock_guard<std::mutex> lock{m_operationMutex};
+			if(m_isShuttingDown) {
+				return;
+			}
+		}
+		status = decoder->read(buffer.data(), buffer.size()).first;
+	}
+}
+
+bool AOWrapper::dropNextSourceLocked() {
+	if(!m_next) {
+		return false;
+	}
+	// Wake the prefetch thread if it is in the decoder; the playback thread releases the decoder.
+	m_next->decoder->abort();
+	m_commands.push_back(Command{Command::Type::CLOSE, m_next->id, std::move(m_next->decoder)});
+	m_next.reset();
+	m_playerWaitCondition.notify_one();
+
+	return true;
+}
+
+void AOWrapper::prefetch(std::shared_ptr<DecoderInterface> decoder) {
+	auto start = std::chrono::steady_clock::now();
+	std::vector<Byte> audio(BUFFER_SIZE);
+	DecoderInterface::Status status;
+	size_t bytesRead = 0;
+	std::tie(status, bytesRead) = decoder->read(audio.data(), audio.size());
+	// A source which fails to open is reported by the playback thread when it reads the decoder again.
+	audio.resize(DecoderInterface::Status::ERROR == status ? 0 : bytesRead);
+
+	std::lock_guard<std::mutex> lock{m_operationMutex};
+	if(!m_next || m_next->decoder != decoder) {
+		return;
 	}
+	AISDK_INFO(LX("prefetchDone")
+		.d("requestId", m_next->id)
+		.d("bytes", audio.size())
+		.d("latency(ms)",
+		   std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()));
+	m_next->primedAudio.swap(audio);
+	m_next->isReady = true;
+	m_playerWaitCondition.notify_one();
+}
 
-	// Delete old decoder before configuring new one.
-#if 0
-	if(m_decoder)
-		m_decoder->abort();
-#endif		
-	m_decoder.reset();
+int AOWrapper::configureNewRequest(
+	std::unique_ptr<FFmpegInputControllerInterface> inputController,
+	std::chrono::milliseconds offset){
+	if(!inputController) {
+		AISDK_ERROR(LX("configureNewRequestFailed").d("reason", "inputControllerIsNullptr"));
+		return utils::mediaPlayer::MediaPlayerInterface::ERROR;
+	}
 
+	// Creating the decoder only sets it up; the input is opened by the first read, on the playback thread.
 	AISDK_DEBUG0(LX("newRequest").d("reason", "decoderCreate"));
-	m_decoder = FFmpegDecoder::create(std::move(inputController), m_config);
+	auto decoder = createDecoder(std::move(inputController), offset);
+	if(!decoder) {
+		AISDK_ERROR(LX("configureNewRequestFailed").d("reason", "createDecoderFailed"));
+		return utils::mediaPlayer::MediaPlayerInterface::ERROR;
+	}
 
-	m_playerThread = std::thread(&AOWrapper::doPlayAudioLoop, this);
+	// Use global lock to stop player and set new source id.
+	std::lock_guard<std::mutex> lock{m_operationMutex};
+	if(m_isShuttingDown) {
+		AISDK_ERROR(LX("configureNewRequestFailed").d("reason", "isShuttingDown"));
+		return utils::mediaPlayer::MediaPlayerInterface::ERROR;
+	}
+	stopLocked();
+	m_sourceId = ++m_lastSourceId;
+	m_initialOffset = offset;
+	m_state = AOPlayerState::OPENED;
+	m_commands.push_back(Command{Command::Type::OPEN, m_sourceId, std::move(decoder)});
+	m_playerWaitCondition.notify_one();
 
 	return m_sourceId;
 }
 
-bool AOWrapper::initialize(){
+std::shared_ptr<DecoderInterface> AOWrapper::createDecoder(
+	std::unique_ptr<FFmpegInputControllerInterface> inputController,
+	std::chrono::milliseconds offset) {
+	if(!inputController) {
+		return nullptr;
+	}
+	auto& cache = DecodedAudioCache::instance();
+	std::string key;
+	// Audio from part way through is not the whole source, so it is neither looked up nor kept.
+	if(std::chrono::milliseconds::zero() == offset) {
+		key = DecodedAudioCache::makeKey(inputController->getStreamCacheKey(), m_config);
+	}
+	if(!key.empty()) {
+		auto audio = cache.get(key);
+		if(audio) {
+			AISDK_DEBUG2(LX("createDecoder").d("reason", "decodedAudioCacheHit").d("key", key));
+			return std::make_shared<PcmBufferDecoder>(audio, m_config.numberChannels() * m_config.sampleSizeBytes());
+		}
+	}
 
-	ao_sample_format format;
-	// Bzero the structs @c ao_sample_format.
-	std::memset(&format, 0, sizeof format);
-	format.bits = convertBitsPreSample(m_config.sampleFormat());
-	format.channels = m_config.numberChannels();
-	format.rate = m_config.sampleRate();
-	format.byte_format = (m_config.isLittleEndian()?AO_FMT_LITTLE: AO_FMT_BIG);
+	std::shared_ptr<DecoderInterface> decoder = FFmpegDecoder::create(std::move(inputController), m_config);
+	if(!decoder || key.empty()) {
+		return decoder;
+	}
+	return std::make_shared<CachingDecoder>(decoder, key, cache);
+}
 
-	auto defaultDriver = m_engine->getDefaultDriver();
-	
-	/// Open liao driver.
-	auto device = ao_open_live(defaultDriver, &format, NULL);
-	if (device == NULL) {
-		AISDK_DEBUG2(LX("initializeFailed").d("reason", "ErrorOpeningDevice"));
+bool AOWrapper::initialize(){
+	if(!m_output) {
+		AISDK_ERROR(LX("initializeFailed").d("reason", "outputIsNullptr"));
 		return false;
 	}
 
-	m_device = std::shared_ptr<ao_device>(device, AOOpenLiveDeleter());
-
 	av_log_set_callback(log_callback_report);
 
+	m_playerThread = std::thread(&AOWrapper::playbackLoop, this);
+
 	return true;
 }
 
@@ -309,96 +478,210 @@ void AOWrapper::doShutdown()
 		m_isShuttingDown = true;
 		stopLocked();
 	    m_observer.reset();
-#if 0
-		if(m_decoder)
-			m_decoder->abort();
-#endif
 	    m_sourceId = ERROR;
+		m_playerWaitCondition.notify_one();
 	}
-	// Make sure current thread be destroyed.
-	if(m_playerThread.joinable()) {		
-		m_playerWaitCondition.notify_one();	//
+	// The prefetch of a queued source was aborted above; wait for it to let go of the player.  No prefetcher is
+	// created once m_isShuttingDown is set.
+	if(m_prefetcher) {
+		m_prefetcher->shutdown();
+	}
+	// The playback thread releases the decoders on its way out.
+	if(m_playerThread.joinable()) {
 		m_playerThread.join();
 	}
 
-	if(m_device) {
-		m_device.reset();
+	if(m_output) {
+		m_output.reset();
 	}
 }
 
-/* The instance callback, where we have access to every method/variable in object of class Sine */
-void AOWrapper::doPlayAudioLoop() {
-	auto task = [this](){
-		return (m_state == AOPlayerState::PLAYING) || (m_state == AOPlayerState::FINISHED) || m_isShuttingDown;
+void AOWrapper::playbackLoop() {
+	auto hasWork = [this](){
+		return m_isShuttingDown || !m_commands.empty() ||
+			(m_state == AOPlayerState::PLAYING && m_decoder && m_decoderId == m_sourceId);
 	};
 
 	std::unique_lock<std::mutex> lock(m_operationMutex);
 	while(true) {
-		m_playerWaitCondition.wait(lock, task);
-		if(m_isShuttingDown || m_state == AOPlayerState::FINISHED) {
-			AISDK_DEBUG2(LX("doPlayAudioLoop").d("reason", "updatingPlayerState"));
-			m_state = AOPlayerState::IDLE;
+		m_playerWaitCondition.wait(lock, hasWork);
+		if(m_isShuttingDown) {
 			break;
 		}
-		
+
+		if(!m_commands.empty()) {
+			auto command = std::move(m_commands.front());
+			m_commands.pop_front();
+			auto retired = executeCommandLocked(std::move(command));
+			if(retired) {
+				// Closing an input may wait on the network; let the callers in meanwhile.
+				lock.unlock();
+				retired.reset();
+				lock.lock();
+			}
+			continue;
+		}
+
 		doPlayAudioLocked(lock);
 	}
+
+	AISDK_DEBUG2(LX("playbackLoop").d("reason", "shutdown"));
+	auto decoder = std::move(m_decoder);
+	auto commands = std::move(m_commands);
+	m_commands.clear();
+	lock.unlock();
+}
+
+std::shared_ptr<DecoderInterface> AOWrapper::executeCommandLocked(Command command) {
+	switch(command.type) {
+		case Command::Type::OPEN: {
+			if(command.id != m_sourceId || m_state == AOPlayerState::FINISHED) {
+				// Replaced or stopped before it got here.
+				return std::move(command.decoder);
+			}
+			m_primedAudio.clear();
+			return switchDecoderLocked(command.id, std::move(command.decoder), m_initialOffset);
+		}
+		case Command::Type::CLOSE:
+			if(command.decoder) {
+				return std::move(command.decoder);
+			}
+			if(command.id == m_decoderId) {
+				return std::move(m_decoder);
+			}
+			return nullptr;
+	}
+
+	return nullptr;
+}
+
+std::shared_ptr<DecoderInterface> AOWrapper::switchDecoderLocked(
+	SourceId id,
+	std::shared_ptr<DecoderInterface> decoder,
+	std::chrono::milliseconds offset) {
+	std::swap(m_decoder, decoder);
+	m_decoderId = id;
+	// The position of the new source counts from what has been written so far.
+	m_decoderOffset = offset;
+	m_bytesWritten = 0;
+	uint64_t played = 0;
+	if(m_output && !m_output->getByteCounts(&m_outputBaseBytes, &played)) {
+		m_outputBaseBytes = 0;
+	}
+	return decoder;
+}
+
+bool AOWrapper::handOffToNextSourceLocked(std::unique_lock<std::mutex>& lock) {
+	if(!m_next) {
+		return false;
+	}
+	if(!m_next->isReady) {
+		// Still opening: waiting costs less than closing the output and opening the source from scratch after.
+		AISDK_DEBUG2(LX("handOffWaiting").d("requestId", m_next->id));
+		m_playerWaitCondition.wait(lock, [this]() { return m_isShuttingDown || !m_next || m_next->isReady; });
+		if(m_isShuttingDown || !m_next) {
+			return false;
+		}
+	}
+
+	auto next = std::move(m_next);
+	auto finishedId = m_sourceId;
+	auto finished = switchDecoderLocked(next->id, std::move(next->decoder), std::chrono::milliseconds::zero());
+	m_commands.push_back(Command{Command::Type::CLOSE, finishedId, std::move(finished)});
+	m_primedAudio.swap(next->primedAudio);
+	m_sourceId = next->id;
+	m_initialOffset = std::chrono::milliseconds::zero();
+	AISDK_DEBUG2(LX("handOff").d("finishedId", finishedId).d("requestId", m_sourceId));
+
+	if (m_observer) {
+		m_observer->onPlaybackFinished(finishedId);
+		m_observer->onPlaybackStarted(m_sourceId);
+	}
+
+	return true;
 }
 
 void AOWrapper::doPlayAudioLocked(std::unique_lock<std::mutex> &lock) {
 	bool unexpected = false;
+	bool written = false;
+	size_t wordsRead = 0;
+	auto decoder = m_decoder;
+	auto id = m_decoderId;
+	std::vector<Byte> primed;
+	primed.swap(m_primedAudio);
 
 	// We need to release the lock @c m_operationMutex when the @c FFMpegDecoder enters the decoding stage and play decode data.
 	lock.unlock();
 
-	do {
-	
-		size_t wordsRead;
-		DecoderInterface::Status status;
-		Byte buffer[BUFFER_SIZE];
+	DecoderInterface::Status status = DecoderInterface::Status::OK;
+	Byte buffer[BUFFER_SIZE];
+	const Byte* data = buffer;
+	if(!primed.empty()) {
+		// Decoded by the prefetch thread while the previous source played.
+		data = primed.data();
+		wordsRead = primed.size();
+	} else {
 		/// Start to read and decode a new frame
-		std::tie(status, wordsRead) = m_decoder->read(buffer, sizeof buffer);
-		if(DecoderInterface::Status::ERROR == status) {
-			AISDK_ERROR(LX("doPlayAudioLockedFailed").d("reason", "decodingFailed"));
-			unexpected = true;
-			break;
-		}
+		std::tie(status, wordsRead) = decoder->read(buffer, sizeof buffer);
+	}
 
+	if(DecoderInterface::Status::ERROR == status) {
+		AISDK_ERROR(LX("doPlayAudioLockedFailed").d("reason", "decodingFailed"));
+		unexpected = true;
+	} else {
 		if(DecoderInterface::Status::DONE == status) {
 			AISDK_DEBUG2(LX("doPlayAudioLockedDone").d("reason", "decodingFinished"));
 			unexpected = true;
-			break;
 		}
-		
-	//	 std::cout << "decodec size: " << wordsRead << std::endl;
-
-		if(ao_play(m_device.get(), (char *)buffer, wordsRead) == 0) {
-			AISDK_ERROR(LX("doPlayAudioLockedDone").d("reason", "ao_play failed"));
+		// The last read of a source may return the end of it along with DONE.
+		if(wordsRead > 0) {
+			written = m_output->write(data, wordsRead);
+			if(!written) {
+				AISDK_DEBUG2(LX("doPlayAudioLocked").d("reason", "outputWriteFailedOrFlushed"));
+			}
 		}
-	}while(0);
+	}
 	
 	lock.lock();
-	if(unexpected) {
-		// we should not call the @c onPlaybackFinished When stop a player.
-		if(m_state != AOWrapper::AOPlayerState::FINISHED) {
-			m_state = AOWrapper::AOPlayerState::FINISHED;
-			if (m_observer) {
-	            m_observer->onPlaybackFinished(m_sourceId);
-	        }
+	if(written && id == m_decoderId) {
+		m_bytesWritten += wordsRead;
+	}
+	// A stop() or setSource() while we were writing flushed the output before our data got there; drop it as well.
+	bool isCurrent = (id == m_sourceId && m_state != AOWrapper::AOPlayerState::FINISHED);
+	if(written && !isCurrent) {
+		m_output->flush();
+	}
+	// we should not call the @c onPlaybackFinished When stop a player.
+	if(unexpected && isCurrent) {
+		if(handOffToNextSourceLocked(lock)) {
+			return;
+		}
+		// A stop() or setSource() while waiting for the queued source has ended this one already.
+		if(id != m_sourceId || m_state == AOWrapper::AOPlayerState::FINISHED) {
+			return;
 		}
+		m_state = AOWrapper::AOPlayerState::FINISHED;
+		m_commands.push_back(Command{Command::Type::CLOSE, id, nullptr});
+		if (m_observer) {
+            m_observer->onPlaybackFinished(m_sourceId);
+        }
 	}
 	
 }
 
 AOWrapper::AOWrapper(
-	std::shared_ptr<AOEngine> aoEngine,
+	std::shared_ptr<AudioSinkInterface> output,
 	const PlaybackConfiguration& config) :
 	SafeShutdown{"AOWrapper"},
 	m_sourceId{utils::mediaPlayer::MediaPlayerInterface::ERROR},
-	m_engine{aoEngine},
+	m_lastSourceId{utils::mediaPlayer::MediaPlayerInterface::ERROR},
 	m_decoder{nullptr},
-	m_device{nullptr},
+	m_decoderId{utils::mediaPlayer::MediaPlayerInterface::ERROR},
+	m_output{output},
 	m_initialOffset{0},
+	m_decoderOffset{0},
+	m_outputBaseBytes{0},
+	m_bytesWritten{0},
 	m_state{AOPlayerState::IDLE},
 	m_isShuttingDown{false},
 	m_config{config} {
@@ -407,7 +690,6 @@ AOWrapper::AOWrapper(
 
 AOWrapper::~AOWrapper() {
 	AISDK_DEBUG5(LX("AOWrapper").d("reason", "Destructor"));
-	m_decoder.reset();
 	doShutdown();
 }
 
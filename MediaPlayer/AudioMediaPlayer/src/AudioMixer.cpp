@@ -0,0 +1,389 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <Utils/Logging/Logger.h>
+#include "AudioMediaPlayer/AudioMixer.h"
+#include "AudioMediaPlayer/Endian.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG{"AudioMixer"};
+
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+const std::chrono::milliseconds AudioMixer::DEFAULT_PERIOD_DURATION{20};
+
+const size_t AudioMixer::DEFAULT_PERIODS_PER_SOURCE;
+
+/// The size of one sample of one channel.
+static const size_t BYTES_PER_SAMPLE = sizeof(int16_t);
+
+/// The gain of a source in 16.16 fixed point: @c UNITY_GAIN leaves samples unchanged.
+static const int32_t UNITY_GAIN = 1 << 16;
+
+/**
+ * Clamps a sum of samples to the range of a sample.
+ */
+static inline int16_t saturate(int32_t sum) {
+    return static_cast<int16_t>(std::min<int32_t>(
+        std::max<int32_t>(sum, std::numeric_limits<int16_t>::min()), std::numeric_limits<int16_t>::max()));
+}
+
+/**
+ * One player's input to the mix: a ring of samples filled by @c write() and drained by the mixing thread, both under
+ * the mixer's @c m_mutex.
+ */
+class AudioMixer::Source : public AudioSinkInterface {
+public:
+    /**
+     * Constructor.
+     *
+     * @param mixer The mixer this source feeds.
+     */
+    explicit Source(std::shared_ptr<AudioMixer> mixer);
+
+    /**
+     * Destructor.  Leaves the mix.
+     */
+    ~Source();
+
+    /// @name AudioSinkInterface methods.
+    /// @{
+    bool write(const uint8_t* data, size_t size) override;
+    void flush() override;
+    bool setGain(float gain, std::chrono::milliseconds rampDuration) override;
+    bool getByteCounts(uint64_t* written, uint64_t* played) const override;
+    /// @}
+
+    /**
+     * Returns whether the mixer should take audio from this source now: it has a full period, or audio that has
+     * waited for one.
+     */
+    bool isReadyLocked(std::chrono::steady_clock::time_point now) const;
+
+    /**
+     * Adds up to one period of audio into @c accumulator and removes it from the ring.
+     */
+    void takeLocked(int32_t* accumulator, size_t maxSamples, std::chrono::steady_clock::time_point now);
+
+    /// The mixer; kept alive by its sources.
+    const std::shared_ptr<AudioMixer> m_mixer;
+
+    /// The buffered samples.
+    std::vector<int16_t> m_ring;
+
+    /// Index in @c m_ring of the oldest sample.
+    size_t m_head;
+
+    /// The number of samples buffered.
+    size_t m_size;
+
+    /// When the oldest buffered sample not yet part of a full period arrived.
+    std::chrono::steady_clock::time_point m_pendingSince;
+
+    /// Incremented by @c flush(), so a blocked @c write() knows to give up.
+    uint64_t m_flushCount;
+
+    /// Whether @c m_oddByte holds the first half of a sample split between two writes.
+    bool m_hasOddByte;
+
+    /// The first half of a split sample.
+    uint8_t m_oddByte;
+
+    /// The gain applied to the next frame, in 16.16 fixed point.
+    int32_t m_gain;
+
+    /// The gain @c m_gain is ramping to.
+    int32_t m_targetGain;
+
+    /// How much @c m_gain changes per frame while ramping.
+    int32_t m_gainStep;
+
+    /// The number of frames left until @c m_gain reaches @c m_targetGain.
+    size_t m_rampFramesLeft;
+
+    /// The number of samples the mixer has taken, which have gone to the output.
+    uint64_t m_samplesTaken;
+
+private:
+    /**
+     * Appends samples to the ring, which must have room for them.
+     */
+    void pushLocked(const uint8_t* data, size_t samples);
+};
+
+AudioMixer::Source::Source(std::shared_ptr<AudioMixer> mixer) :
+        m_mixer{mixer},
+        m_ring(mixer->m_sourceCapacity),
+        m_head{0},
+        m_size{0},
+        m_flushCount{0},
+        m_hasOddByte{false},
+        m_oddByte{0},
+        m_gain{UNITY_GAIN},
+        m_targetGain{UNITY_GAIN},
+        m_gainStep{0},
+        m_rampFramesLeft{0},
+        m_samplesTaken{0} {
+}
+
+AudioMixer::Source::~Source() {
+    std::lock_guard<std::mutex> lock(m_mixer->m_mutex);
+    auto& sources = m_mixer->m_sources;
+    sources.erase(std::remove(sources.begin(), sources.end(), this), sources.end());
+}
+
+bool AudioMixer::Source::write(const uint8_t* data, size_t size) {
+    std::unique_lock<std::mutex> lock(m_mixer->m_mutex);
+    const auto flushCount = m_flushCount;
+    auto hasRoom = [this, flushCount] { return m_size < m_ring.size() || m_flushCount != flushCount; };
+    while (size > 0) {
+        m_mixer->m_spaceAvailable.wait(lock, hasRoom);
+        if (m_flushCount != flushCount) {
+            return false;
+        }
+        if (m_hasOddByte) {
+            const uint8_t sample[BYTES_PER_SAMPLE] = {m_oddByte, data[0]};
+            m_hasOddByte = false;
+            pushLocked(sample, 1);
+            ++data;
+            --size;
+        } else if (size < BYTES_PER_SAMPLE) {
+            m_oddByte = data[0];
+            m_hasOddByte = true;
+            size = 0;
+        } else {
+            const size_t samples = std::min(size / BYTES_PER_SAMPLE, m_ring.size() - m_size);
+            pushLocked(data, samples);
+            data += samples * BYTES_PER_SAMPLE;
+            size -= samples * BYTES_PER_SAMPLE;
+        }
+    }
+    return true;
+}
+
+void AudioMixer::Source::pushLocked(const uint8_t* data, size_t samples) {
+    if (0 == m_size) {
+        m_pendingSince = std::chrono::steady_clock::now();
+    }
+    const size_t tail = (m_head + m_size) % m_ring.size();
+    const size_t firstPart = std::min(samples, m_ring.size() - tail);
+    std::memcpy(&m_ring[tail], data, firstPart * BYTES_PER_SAMPLE);
+    std::memcpy(&m_ring[0], data + firstPart * BYTES_PER_SAMPLE, (samples - firstPart) * BYTES_PER_SAMPLE);
+    m_size += samples;
+    m_mixer->m_dataAvailable.notify_one();
+}
+
+void AudioMixer::Source::flush() {
+    {
+        std::lock_guard<std::mutex> lock(m_mixer->m_mutex);
+        m_head = 0;
+        m_size = 0;
+        m_hasOddByte = false;
+        ++m_flushCount;
+    }
+    m_mixer->m_spaceAvailable.notify_all();
+}
+
+bool AudioMixer::Source::setGain(float gain, std::chrono::milliseconds rampDuration) {
+    if (gain < 0.0f || gain > 1.0f || rampDuration.count() < 0) {
+        AISDK_ERROR(LX("setGainFailed").d("gain", gain).d("rampDuration", rampDuration.count()));
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(m_mixer->m_mutex);
+    m_targetGain = static_cast<int32_t>(gain * UNITY_GAIN + 0.5f);
+    m_rampFramesLeft = m_mixer->m_config.sampleRate() * rampDuration.count() / 1000;
+    if (0 == m_rampFramesLeft) {
+        m_gain = m_targetGain;
+        m_gainStep = 0;
+    } else {
+        m_gainStep = (m_targetGain - m_gain) / static_cast<int32_t>(m_rampFramesLeft);
+    }
+    return true;
+}
+
+bool AudioMixer::Source::getByteCounts(uint64_t* written, uint64_t* played) const {
+    std::lock_guard<std::mutex> lock(m_mixer->m_mutex);
+    // Whatever is in the ring, the odd byte included, has been written and not played.
+    *played = m_samplesTaken * BYTES_PER_SAMPLE;
+    *written = *played + m_size * BYTES_PER_SAMPLE + (m_hasOddByte ? 1 : 0);
+    return true;
+}
+
+bool AudioMixer::Source::isReadyLocked(std::chrono::steady_clock::time_point now) const {
+    return m_size >= m_mixer->m_periodSamples ||
+           (m_size > 0 && now - m_pendingSince >= m_mixer->m_periodDuration);
+}
+
+void AudioMixer::Source::takeLocked(
+    int32_t* accumulator,
+    size_t maxSamples,
+    std::chrono::steady_clock::time_point now) {
+    const size_t samples = std::min(maxSamples, m_size);
+    if (0 == m_rampFramesLeft && UNITY_GAIN == m_gain) {
+        for (size_t i = 0, index = m_head; i < samples; ++i) {
+            accumulator[i] += m_ring[index];
+            if (++index == m_ring.size()) {
+                index = 0;
+            }
+        }
+    } else if (0 != m_rampFramesLeft || 0 != m_gain) {
+        const size_t channels = m_mixer->m_config.numberChannels();
+        for (size_t i = 0, index = m_head; i < samples; ++i) {
+            // Every channel of a frame gets the same gain.
+            if (i % channels == 0 && m_rampFramesLeft > 0) {
+                m_gain = --m_rampFramesLeft > 0 ? m_gain + m_gainStep : m_targetGain;
+            }
+            accumulator[i] += (m_ring[index] * m_gain) >> 16;
+            if (++index == m_ring.size()) {
+                index = 0;
+            }
+        }
+    }
+    m_head = (m_head + samples) % m_ring.size();
+    m_size -= samples;
+    m_samplesTaken += samples;
+    if (m_size > 0) {
+        m_pendingSince = now;
+    }
+}
+
+std::shared_ptr<AudioMixer> AudioMixer::create(
+    std::unique_ptr<AudioSinkInterface> output,
+    const PlaybackConfiguration& config,
+    std::chrono::milliseconds periodDuration,
+    size_t periodsPerSource) {
+    if (!output) {
+        AISDK_ERROR(LX("createFailed").d("reason", "nullOutput"));
+        return nullptr;
+    }
+    if (config.sampleFormat() != PlaybackConfiguration::SampleFormat::SIGNED_16 ||
+        config.isLittleEndian() != littleEndianMachine()) {
+        AISDK_ERROR(LX("createFailed").d("reason", "unsupportedFormat").d("format", config.sampleFormat()));
+        return nullptr;
+    }
+    const size_t periodFrames = config.sampleRate() * periodDuration.count() / 1000;
+    if (periodDuration.count() <= 0 || 0 == periodFrames || 0 == periodsPerSource) {
+        AISDK_ERROR(LX("createFailed")
+                        .d("reason", "invalidPeriod")
+                        .d("periodDuration", periodDuration.count())
+                        .d("periodsPerSource", periodsPerSource));
+        return nullptr;
+    }
+
+    std::shared_ptr<AudioMixer> mixer(
+        new AudioMixer(std::move(output), config, periodFrames, periodDuration, periodsPerSource));
+    mixer->m_thread = std::thread(&AudioMixer::mixLoop, mixer.get());
+    return mixer;
+}
+
+AudioMixer::AudioMixer(
+    std::unique_ptr<AudioSinkInterface> output,
+    const PlaybackConfiguration& config,
+    size_t periodFrames,
+    std::chrono::milliseconds periodDuration,
+    size_t periodsPerSource) :
+        m_output{std::move(output)},
+        m_config{config},
+        m_periodSamples{periodFrames * config.numberChannels()},
+        m_periodDuration{periodDuration},
+        m_sourceCapacity{m_periodSamples * periodsPerSource},
+        m_isShuttingDown{false},
+        m_accumulator(m_periodSamples),
+        m_period(m_periodSamples) {
+}
+
+AudioMixer::~AudioMixer() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isShuttingDown = true;
+    }
+    m_dataAvailable.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+std::shared_ptr<AudioSinkInterface> AudioMixer::createSource() {
+    auto source = std::make_shared<Source>(shared_from_this());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_sources.push_back(source.get());
+    return source;
+}
+
+const PlaybackConfiguration& AudioMixer::getConfiguration() const {
+    return m_config;
+}
+
+size_t AudioMixer::getPeriodBytes() const {
+    return m_periodSamples * BYTES_PER_SAMPLE;
+}
+
+bool AudioMixer::waitForPeriodLocked(std::unique_lock<std::mutex>& lock) {
+    while (!m_isShuttingDown) {
+        const auto now = std::chrono::steady_clock::now();
+        auto wakeAt = std::chrono::steady_clock::time_point::max();
+        for (auto source : m_sources) {
+            if (source->isReadyLocked(now)) {
+                return true;
+            }
+            if (source->m_size > 0) {
+                wakeAt = std::min(wakeAt, source->m_pendingSince + m_periodDuration);
+            }
+        }
+        if (std::chrono::steady_clock::time_point::max() == wakeAt) {
+            m_dataAvailable.wait(lock);
+        } else {
+            m_dataAvailable.wait_until(lock, wakeAt);
+        }
+    }
+    return false;
+}
+
+void AudioMixer::accumulatePeriodLocked() {
+    std::fill(m_accumulator.begin(), m_accumulator.end(), 0);
+    const auto now = std::chrono::steady_clock::now();
+    for (auto source : m_sources) {
+        if (source->isReadyLocked(now)) {
+            source->takeLocked(m_accumulator.data(), m_periodSamples, now);
+        }
+    }
+}
+
+void AudioMixer::mixLoop() {
+    AISDK_DEBUG0(LX("mixLoopStarted").d("periodBytes", getPeriodBytes()));
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (waitForPeriodLocked(lock)) {
+        accumulatePeriodLocked();
+        lock.unlock();
+        m_spaceAvailable.notify_all();
+
+        for (size_t i = 0; i < m_periodSamples; ++i) {
+            m_period[i] = saturate(m_accumulator[i]);
+        }
+        // The sink logs its own failures; the period is dropped and mixing goes on.
+        m_output->write(reinterpret_cast<const uint8_t*>(m_period.data()), m_period.size() * BYTES_PER_SAMPLE);
+
+        lock.lock();
+    }
+    AISDK_DEBUG0(LX("mixLoopExited"));
+}
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <Utils/Logging/Logger.h>
+
+#include "AudioMediaPlayer/CachingDecoder.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG{"CachingDecoder"};
+
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+CachingDecoder::CachingDecoder(
+    std::shared_ptr<DecoderInterface> decoder,
+    const std::string& key,
+    DecodedAudioCache& cache) :
+        m_decoder{std::move(decoder)},
+        m_key{key},
+        m_cache(cache),
+        m_decodedBytes{0},
+        m_isRecording{!key.empty()} {
+}
+
+std::pair<DecoderInterface::Status, size_t> CachingDecoder::read(Byte* buffer, size_t size) {
+    auto result = m_decoder->read(buffer, size);
+    if (!m_isRecording) {
+        return result;
+    }
+    if (Status::ERROR == result.first) {
+        m_isRecording = false;
+        std::vector<Byte>().swap(m_audio);
+        return result;
+    }
+
+    m_decodedBytes += result.second;
+    if (m_decodedBytes > DecodedAudioCache::MAX_ENTRY_BYTES) {
+        // Too long to keep; go on counting, so the warning tells how long it is.
+        std::vector<Byte>().swap(m_audio);
+        if (Status::DONE == result.first) {
+            m_isRecording = false;
+            AISDK_WARN(LX("audioNotCached")
+                           .d("reason", "tooLarge")
+                           .d("key", m_key)
+                           .d("bytes", m_decodedBytes)
+                           .d("maxBytes", DecodedAudioCache::MAX_ENTRY_BYTES));
+        }
+        return result;
+    }
+    m_audio.insert(m_audio.end(), buffer, buffer + result.second);
+    if (Status::DONE == result.first) {
+        m_isRecording = false;
+        auto audio = std::make_shared<const std::vector<Byte>>(std::move(m_audio));
+        if (m_cache.put(m_key, audio)) {
+            AISDK_INFO(LX("audioCached").d("key", m_key).d("bytes", audio->size()));
+        } else {
+            AISDK_WARN(LX("audioNotCached").d("reason", "rejected").d("key", m_key).d("bytes", audio->size()));
+        }
+        m_audio.clear();
+    }
+    return result;
+}
+
+void CachingDecoder::abort() {
+    m_decoder->abort();
+}
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
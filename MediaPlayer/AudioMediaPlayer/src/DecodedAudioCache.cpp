@@ -0,0 +1,94 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <sstream>
+
+#include "AudioMediaPlayer/DecodedAudioCache.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+constexpr size_t DecodedAudioCache::DEFAULT_MAX_BYTES;
+constexpr size_t DecodedAudioCache::MAX_ENTRY_BYTES;
+
+DecodedAudioCache& DecodedAudioCache::instance() {
+    static DecodedAudioCache cache;
+    return cache;
+}
+
+std::string DecodedAudioCache::makeKey(const std::string& streamKey, const PlaybackConfiguration& config) {
+    if (streamKey.empty()) {
+        return "";
+    }
+    std::ostringstream key;
+    key << streamKey << '#' << config.sampleRate() << 'x' << config.numberChannels() << 'x'
+        << config.sampleSizeBytes() << (config.isLittleEndian() ? "le" : "be");
+    return key.str();
+}
+
+DecodedAudioCache::DecodedAudioCache(size_t maxBytes) : m_maxBytes{maxBytes}, m_bytes{0} {
+}
+
+DecodedAudioCache::Audio DecodedAudioCache::get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+        return nullptr;
+    }
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->second;
+}
+
+bool DecodedAudioCache::put(const std::string& key, Audio audio) {
+    if (key.empty() || !audio) {
+        return false;
+    }
+    auto size = audio->size();
+    if (size > MAX_ENTRY_BYTES || size > m_maxBytes) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+        m_bytes -= it->second->second->size();
+        m_entries.erase(it->second);
+        m_index.erase(it);
+    }
+    // Audio of a file which has changed since is never looked up again, and so ages out like the rest.
+    while (m_bytes + size > m_maxBytes) {
+        m_bytes -= m_entries.back().second->size();
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+    }
+    m_entries.emplace_front(key, std::move(audio));
+    m_index[key] = m_entries.begin();
+    m_bytes += size;
+    return true;
+}
+
+size_t DecodedAudioCache::getBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_bytes;
+}
+
+void DecodedAudioCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_bytes = 0;
+}
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
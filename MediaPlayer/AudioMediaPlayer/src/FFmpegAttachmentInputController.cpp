@@ -11,6 +11,7 @@
  */
 
 #include <string>
+#include <thread>
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -42,11 +43,14 @@ namespace ffmpeg {
 using namespace utils::attachment;
 using namespace utils;
 
-/// Timeout for read operations.
-static const std::chrono::milliseconds READ_TIMEOUT{1000};
+constexpr int FFmpegAttachmentInputController::DEFAULT_BUFFER_SIZE;
 
-/// Buffers will be the size of a regular page.
-static constexpr int BUFFER_SIZE{4096};
+const std::chrono::milliseconds FFmpegAttachmentInputController::READ_WAIT_SLICE{100};
+
+const std::chrono::milliseconds FFmpegAttachmentInputController::MAX_STARVATION{3000};
+
+/// How long to wait between reads of a non blocking reader which had nothing.
+static const std::chrono::milliseconds NON_BLOCKING_POLL_INTERVAL{10};
 
 /// The size of a byte in bits.
 static constexpr unsigned int BYTE_TO_BITS{8u};
@@ -56,14 +60,20 @@ static const int EMPTY_FLAGS = 0;
 
 std::unique_ptr<FFmpegAttachmentInputController> FFmpegAttachmentInputController::create(
     std::shared_ptr<AttachmentReader> reader,
-    const utils::AudioFormat* format) {
+    const utils::AudioFormat* format,
+    int bufferSize) {
     if (!reader) {
         AISDK_ERROR(LX("createFailed").d("reason", "nullReader"));
         return nullptr;
     }
+    if (bufferSize <= 0) {
+        AISDK_ERROR(LX("createFailed").d("reason", "invalidBufferSize").d("bufferSize", bufferSize));
+        return nullptr;
+    }
 
     std::shared_ptr<AVInputFormat> inputFormat;
     std::shared_ptr<AVDictionary> inputOptions;
+    StreamDescription description{AV_CODEC_ID_NONE, 0, 0};
     if (format) {
         if (format->encoding == AudioFormat::Encoding::OPUS) {
             AISDK_ERROR(LX("createFailed").d("reason", "opusNotSupported"));
@@ -97,40 +107,67 @@ std::unique_ptr<FFmpegAttachmentInputController> FFmpegAttachmentInputController
 //        av_dict_set_int(&dictionary, "framerate", format->sampleRateHz, 0);
 		av_dict_set_int(&dictionary, "sample_rate", format->sampleRateHz, 0);
         inputOptions = std::shared_ptr<AVDictionary>(dictionary, AVDictionaryDeleter());
+
+        // Raw PCM needs no probing: the format says all there is to know.
+        description.codecId = inputFormat->raw_codec_id;
+        description.sampleRate = format->sampleRateHz;
+        description.channels = format->numChannels;
     }
 
-    return std::unique_ptr<FFmpegAttachmentInputController>(
-        new FFmpegAttachmentInputController(reader, inputFormat, inputOptions));
+    return std::unique_ptr<FFmpegAttachmentInputController>(new FFmpegAttachmentInputController(
+        reader,
+        inputFormat,
+        inputOptions,
+        AV_CODEC_ID_NONE != description.codecId ? &description : nullptr,
+        bufferSize));
 }
 
 int FFmpegAttachmentInputController::read(uint8_t* buffer, int bufferSize) {
-    AttachmentReader::ReadStatus readStatus;
-    auto readSize = m_reader->read(buffer, bufferSize, &readStatus, READ_TIMEOUT);
-    switch (readStatus) {
-        case AttachmentReader::ReadStatus::OK:
-            if(!m_hasProbedVaildData)
+    // Wait in the reader, which sleeps until the writer signals data, a slice at a time so a stop is noticed.
+    std::chrono::milliseconds starvation{0};
+    while (starvation < MAX_STARVATION) {
+        if (isInterrupted()) {
+            AISDK_DEBUG3(LX(__func__).m("Interrupted"));
+            return AVERROR_EXIT;
+        }
+
+        AttachmentReader::ReadStatus readStatus;
+        auto readSize = m_reader->read(buffer, bufferSize, &readStatus, READ_WAIT_SLICE);
+        switch (readStatus) {
+            case AttachmentReader::ReadStatus::OK:
                 m_hasProbedVaildData = true;
-            return readSize;
-        case AttachmentReader::ReadStatus::OK_WOULDBLOCK:
-        case AttachmentReader::ReadStatus::OK_TIMEDOUT:
-            AISDK_DEBUG3(LX(__func__).d("status", readStatus).d("readSize", readSize));
-            if(m_tryCount >= 2) {
-                m_tryCount = 0;
-                return readSize ? readSize : AVERROR_EOF;
-            } else {
-                m_tryCount++;
-                return readSize ? readSize : AVERROR(EAGAIN);
-            }
-        case AttachmentReader::ReadStatus::CLOSED:
-            AISDK_DEBUG3(LX(__func__).m("Found EOF"));
-            return AVERROR_EOF;
-        case AttachmentReader::ReadStatus::ERROR_BYTES_LESS_THAN_WORD_SIZE:
-        case AttachmentReader::ReadStatus::ERROR_INTERNAL:
-        case AttachmentReader::ReadStatus::ERROR_OVERRUN:
-            AISDK_ERROR(LX("readFailed").d("reason", readStatus));
-            return AVERROR_EXTERNAL;
+                return readSize;
+            case AttachmentReader::ReadStatus::OK_WOULDBLOCK:
+                if (readSize) {
+                    return readSize;
+                }
+                // A non blocking reader doesn't wait; don't spin on it either.
+                std::this_thread::sleep_for(NON_BLOCKING_POLL_INTERVAL);
+                starvation += NON_BLOCKING_POLL_INTERVAL;
+                break;
+            case AttachmentReader::ReadStatus::OK_TIMEDOUT:
+                if (readSize) {
+                    return readSize;
+                }
+                starvation += READ_WAIT_SLICE;
+                break;
+            case AttachmentReader::ReadStatus::CLOSED:
+                AISDK_DEBUG3(LX(__func__).m("Found EOF"));
+                return AVERROR_EOF;
+            case AttachmentReader::ReadStatus::ERROR_BYTES_LESS_THAN_WORD_SIZE:
+            case AttachmentReader::ReadStatus::ERROR_INTERNAL:
+            case AttachmentReader::ReadStatus::ERROR_OVERRUN:
+                AISDK_ERROR(LX("readFailed").d("reason", readStatus));
+                return AVERROR_EXTERNAL;
+        }
     }
-    return readSize;
+
+    AISDK_WARN(LX("readFailed").d("reason", "starved").d("waited(ms)", starvation.count()));
+    return AVERROR_EOF;
+}
+
+bool FFmpegAttachmentInputController::isInterrupted() const {
+    return m_interruptCallback && m_interruptCallback(m_interruptOpaque);
 }
 
 bool FFmpegAttachmentInputController::hasNext() const {
@@ -142,15 +179,29 @@ bool FFmpegAttachmentInputController::next() {
     return false;
 }
 
+bool FFmpegAttachmentInputController::getStreamDescription(StreamDescription* description) const {
+    if (m_hasDescription) {
+        *description = m_description;
+    }
+    return m_hasDescription;
+}
+
 FFmpegAttachmentInputController::FFmpegAttachmentInputController(
     std::shared_ptr<AttachmentReader> reader,
     std::shared_ptr<AVInputFormat> inputFormat,
-    std::shared_ptr<AVDictionary> inputOptions) :
-        m_tryCount{0},
+    std::shared_ptr<AVDictionary> inputOptions,
+    const StreamDescription* description,
+    int bufferSize) :
         m_hasProbedVaildData{false},
         m_reader{reader},
         m_inputFormat{inputFormat},
-        m_inputOptions{inputOptions} {
+        m_inputOptions{inputOptions},
+        m_hasDescription{nullptr != description},
+        m_description(description ? *description : StreamDescription{AV_CODEC_ID_NONE, 0, 0}),
+        m_bufferSize{bufferSize},
+        m_interruptCallback{nullptr},
+        m_interruptOpaque{nullptr},
+        m_avFormatContext{nullptr} {
 }
 
 int FFmpegAttachmentInputController::feedBuffer(void* userData, uint8_t* buffer, int bufferSize) {
@@ -159,19 +210,12 @@ int FFmpegAttachmentInputController::feedBuffer(void* userData, uint8_t* buffer,
         AISDK_ERROR(LX("feedAvioBufferFailed").d("reason", "nullInputController"));
         return AVERROR_EXTERNAL;
     }
-    int readStatus;
-    do {
-
-        readStatus = inputController->read(buffer, bufferSize);
-
-    }while(readStatus == AVERROR(EAGAIN));
-
-    return readStatus;
+    return inputController->read(buffer, bufferSize);
 }
 
 AVFormatContext* FFmpegAttachmentInputController::createNewFormatContext() {
     unsigned char* buffer =
-        static_cast<unsigned char*>(av_malloc(BUFFER_SIZE + AVPROBE_PADDING_SIZE));  // Owned by m_ioContext
+        static_cast<unsigned char*>(av_malloc(m_bufferSize + AVPROBE_PADDING_SIZE));  // Owned by m_ioContext
     if (!buffer) {
         AISDK_ERROR(LX("getContextFailed").d("reason", "avMallocFailed"));
         return nullptr;
@@ -183,7 +227,7 @@ AVFormatContext* FFmpegAttachmentInputController::createNewFormatContext() {
     }
 
     m_ioContext = std::shared_ptr<AVIOContext>(
-        avio_alloc_context(buffer, BUFFER_SIZE, false, this, feedBuffer, nullptr, nullptr), AVIOContextDeleter());
+        avio_alloc_context(buffer, m_bufferSize, false, this, feedBuffer, nullptr, nullptr), AVIOContextDeleter());
     if (!m_ioContext) {
         AISDK_ERROR(LX("getContextFailed").d("reason", "avioAllocFailed"));
         return nullptr;
@@ -211,7 +255,10 @@ FFmpegAttachmentInputController::getCurrentFormatContextOpen() {
 	m_avFormatContext = nullptr;
 		
 	avFormatContext->pb = m_ioContext.get();
-	avFormatContext->format_probesize = BUFFER_SIZE;
+	avFormatContext->format_probesize = m_bufferSize;
+	// A custom AVIO context doesn't see the interrupt callback; the reads check it themselves.
+	m_interruptCallback = avFormatContext->interrupt_callback.callback;
+	m_interruptOpaque = avFormatContext->interrupt_callback.opaque;
 
 	AVDictionary* options = nullptr;
 	av_dict_copy(&options, m_inputOptions.get(), EMPTY_FLAGS);	// Open_input will change the pointer value.
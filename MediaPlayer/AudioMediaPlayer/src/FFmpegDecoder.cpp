@@ -11,6 +11,7 @@
  * permissions and limitations under the License.
  */
 
+#include <algorithm>
 #include <atomic>
 #include <fstream>
 #include <thread>
@@ -41,9 +42,6 @@ namespace aisdk{
 namespace mediaPlayer {
 namespace ffmpeg {
 
-/// Represent scenario where there is no flag enabled.
-static constexpr int NO_FLAGS{0};
-
 /// For @c av_samples_get_buffer_size we want to disable alignment to avoid empty samples.
 static constexpr int NO_ALIGNMENT{1};
 
@@ -111,7 +109,13 @@ FFmpegDecoder::FFmpegDecoder(
         m_outputFormat{format},   //add 
         m_outputLayout{layout},		//add 
         m_outputRate{sampleRate}, 	//add
-        m_unreadData{format, layout, sampleRate} {	//add
+        m_decodedFrame{av_frame_alloc(), AVFrameDeleter()},
+        m_packet{av_packet_alloc(), AVPacketDeleter()},
+        m_unreadData{format, layout, sampleRate},	//add
+        m_seekTarget{AV_NOPTS_VALUE},
+        m_streamIndex{-1},
+        m_isFastOpen{false},
+        m_hasReturnedFirstSample{false} {
 }
 
 std::pair<FFmpegDecoder::Status, size_t> FFmpegDecoder::read(Byte* buffer, size_t size) {
@@ -130,9 +134,20 @@ std::pair<FFmpegDecoder::Status, size_t> FFmpegDecoder::read(Byte* buffer, size_
         return {Status::DONE, 0};
     }
 
+    if (!m_decodedFrame || !m_packet) {
+		AISDK_ERROR(LX("readFailed").d("reason", "allocFrameOrPacketFailed"));
+        setState(DecodingState::INVALID);
+        return {Status::ERROR, 0};
+    }
+
+    if (!m_hasReturnedFirstSample && m_firstReadTime.time_since_epoch().count() == 0) {
+        m_firstReadTime = std::chrono::steady_clock::now();
+    }
+
     m_retryCount = 0;
     size_t bytesRead = 0;
-    auto decodedFrame = std::shared_ptr<AVFrame>(av_frame_alloc(), AVFrameDeleter());
+    // Every path to resample() below receives into the frame first, so what it held from the last call is not reused.
+    auto& decodedFrame = m_decodedFrame;
     while (m_state != DecodingState::FINISHED && m_state != DecodingState::INVALID) {
         if (!m_unreadData.isEmpty()) {
             auto lastReadSize = readData(buffer, size, bytesRead);
@@ -163,10 +178,23 @@ std::pair<FFmpegDecoder::Status, size_t> FFmpegDecoder::read(Byte* buffer, size_
 
             if (m_state < DecodingState::FLUSHING_RESAMPLER && (decodedFrame->nb_samples > 0)) {
                 resample(decodedFrame);
+                if (AV_NOPTS_VALUE != m_seekTarget) {
+                    discardPreRoll(*decodedFrame);
+                }
             }
         }
     }
 
+    if (!m_hasReturnedFirstSample && bytesRead > 0) {
+        m_hasReturnedFirstSample = true;
+        AISDK_INFO(LX("firstSample")
+                       .d("latency(ms)",
+                          std::chrono::duration_cast<std::chrono::milliseconds>(
+                              std::chrono::steady_clock::now() - m_firstReadTime)
+                              .count())
+                       .d("fastOpen", m_isFastOpen));
+    }
+
     auto status = (DecodingState::INVALID == m_state)
                       ? Status::ERROR
                       : (DecodingState::FINISHED == m_state) ? Status::DONE : Status::OK;
@@ -231,28 +259,56 @@ void FFmpegDecoder::initialize() {
     m_formatContext->interrupt_callback.opaque = this;
 	m_initializeStartTime = std::chrono::steady_clock::now();
 #endif
-    
-	auto status = avformat_find_stream_info(m_formatContext.get(), nullptr);
-    if (!transitionStateUsingStatus(status, DecodingState::INVALID, "initialize::findStreamInfo")) {
-        return;
-    }
 
+    // Probing reads and decodes the start of the stream, which is most of the time to the first sample.  Skip it
+    // when the input describes itself or the same media has been probed before.
     AVCodec* codec = nullptr;  // We don't own the codec.
-    auto streamIndex = av_find_best_stream(m_formatContext.get(), AVMEDIA_TYPE_AUDIO, -1, -1, &codec, NO_ALIGNMENT);
-    if (!transitionStateUsingStatus(streamIndex, DecodingState::INVALID, "initialize::findBestStream")) {
-        return;
+    int streamIndex = AVERROR_STREAM_NOT_FOUND;
+    StreamDescription description;
+    auto cacheKey = m_inputController->getStreamCacheKey();
+    m_isFastOpen = m_inputController->getStreamDescription(&description) ||
+                   StreamInfoCache::instance().get(cacheKey, &description);
+    if (m_isFastOpen) {
+        streamIndex = openDescribedStream(description, &codec);
+        if (streamIndex < 0) {
+            AISDK_WARN(LX("fastOpenFailed").d("reason", "descriptionMismatch").d("key", cacheKey));
+            m_isFastOpen = false;
+        }
+    }
+
+    int status = 0;
+    if (!m_isFastOpen) {
+        status = avformat_find_stream_info(m_formatContext.get(), nullptr);
+        if (!transitionStateUsingStatus(status, DecodingState::INVALID, "initialize::findStreamInfo")) {
+            return;
+        }
+
+        streamIndex = av_find_best_stream(m_formatContext.get(), AVMEDIA_TYPE_AUDIO, -1, -1, &codec, NO_ALIGNMENT);
+        if (!transitionStateUsingStatus(streamIndex, DecodingState::INVALID, "initialize::findBestStream")) {
+            return;
+        }
+
+        auto parameters = m_formatContext->streams[streamIndex]->codecpar;
+        StreamInfoCache::instance().put(
+            cacheKey, StreamDescription{parameters->codec_id, parameters->sample_rate, parameters->channels});
     }
 
+    m_streamIndex = streamIndex;
+    m_seekTarget = AV_NOPTS_VALUE;
     if (initialPosition != std::chrono::milliseconds::zero()) {
-        // Convert the offset given in millisecond to the codec timebase.
+        // Convert the offset given in millisecond to the stream timebase, from the start of the stream.
         AISDK_DEBUG(LX("initialPosition").d("offset(ms)", initialPosition.count()));
-        auto timebase = m_formatContext->streams[streamIndex]->time_base;
-        int64_t timestamp =
-            std::chrono::duration_cast<std::chrono::seconds>(initialPosition).count() * timebase.den / timebase.num;
-        status = av_seek_frame(m_formatContext.get(), streamIndex, timestamp, NO_FLAGS);
+        auto stream = m_formatContext->streams[streamIndex];
+        int64_t timestamp = av_rescale_q(initialPosition.count(), AVRational{1, 1000}, stream->time_base);
+        if (AV_NOPTS_VALUE != stream->start_time) {
+            timestamp += stream->start_time;
+        }
+        // Land on or before the position; what comes before it is decoded and dropped by discardPreRoll().
+        status = av_seek_frame(m_formatContext.get(), streamIndex, timestamp, AVSEEK_FLAG_BACKWARD);
         if (!transitionStateUsingStatus(status, DecodingState::INVALID, "initialize::seekFrame")) {
             return;
         }
+        m_seekTarget = timestamp;
     }
 
 	AISDK_DEBUG5(LX("initialDurations").d("durations(ms)", m_formatContext->duration));
@@ -273,9 +329,9 @@ void FFmpegDecoder::initialize() {
 				.d("out_sample_rate", m_outputRate)
 				.d("out_layout_channel", m_outputLayout));
 
-    m_swrContext = std::shared_ptr<SwrContext>(
-        swr_alloc_set_opts(
-            nullptr,
+    // Set up the context of the previous media again if there is one; swr_init() below clears its state.
+    auto swrContext = swr_alloc_set_opts(
+            m_swrContext.get(),
             m_outputLayout,                  // output channels
             m_outputFormat,                  // output format (signed 16 bits)
             m_outputRate,                    // output sample rate
@@ -283,13 +339,17 @@ void FFmpegDecoder::initialize() {
             m_codecContext->sample_fmt,      // input sample format
             m_codecContext->sample_rate,     // input sample rate
             0,                               // logging
-            NULL),
-        SwrContextDeleter());
-    if (!m_swrContext) {
+            NULL);
+    if (!swrContext) {
+        // swr_alloc_set_opts() frees the context it was given when it fails.
+        m_swrContext.release();
 		AISDK_ERROR(LX("initializedFailed").d("reason", "allocResamplerFailed"));
         setState(DecodingState::INVALID);
         return;
     }
+    if (!m_swrContext) {
+        m_swrContext.reset(swrContext);
+    }
 
     status = swr_init(m_swrContext.get());
     if (!transitionStateUsingStatus(status, DecodingState::INVALID, "initialize::initContext")) {
@@ -299,6 +359,28 @@ void FFmpegDecoder::initialize() {
     setState(DecodingState::DECODING);
 }
 
+int FFmpegDecoder::openDescribedStream(const StreamDescription& description, AVCodec** codec) {
+    auto streamIndex = av_find_best_stream(m_formatContext.get(), AVMEDIA_TYPE_AUDIO, -1, -1, codec, NO_ALIGNMENT);
+    if (streamIndex < 0) {
+        return streamIndex;
+    }
+
+    // The demuxer fills in what the container header says; anything it says must agree with the description.
+    auto parameters = m_formatContext->streams[streamIndex]->codecpar;
+    if (parameters->codec_id != description.codecId ||
+        (parameters->sample_rate && parameters->sample_rate != description.sampleRate) ||
+        (parameters->channels && parameters->channels != description.channels)) {
+        return AVERROR_STREAM_NOT_FOUND;
+    }
+    if (!parameters->sample_rate) {
+        parameters->sample_rate = description.sampleRate;
+    }
+    if (!parameters->channels) {
+        parameters->channels = description.channels;
+    }
+    return streamIndex;
+}
+
 size_t FFmpegDecoder::readData(Byte* buffer, size_t size, size_t bytesRead) {
     // Use av_samples_copy to partially copy the frame and avoid buffer too small issue.
     auto& frame = m_unreadData.getFrame();
@@ -318,18 +400,19 @@ size_t FFmpegDecoder::readData(Byte* buffer, size_t size, size_t bytesRead) {
 
     }
 
-    if (size >= bytesRead + sampleSizeBytes) {
-        // Have enough space. Read the entire frame.
-        size_t writeOffset = bytesRead;
-        memcpy(buffer + writeOffset, frame.data[0], sampleSizeBytes);
-        m_unreadData.setOffset(frame.nb_samples);
-        return sampleSizeBytes;
+    // Copy as many of the unread samples as fit, from the offset on; the output is interleaved, all in data[0].
+    size_t frameSizeBytes = sampleSizeBytes / frame.nb_samples;
+    size_t unreadSamples = frame.nb_samples - m_unreadData.getOffset();
+    size_t samples = std::min(unreadSamples, (size - bytesRead) / frameSizeBytes);
+    if (0 == samples) {
+        return 0;
     }
-
-    return 0;
+    memcpy(buffer + bytesRead, frame.data[0] + m_unreadData.getOffset() * frameSizeBytes, samples * frameSizeBytes);
+    m_unreadData.setOffset(m_unreadData.getOffset() + static_cast<int>(samples));
+    return samples * frameSizeBytes;
 }
 
-void FFmpegDecoder::resample(std::shared_ptr<AVFrame> inputFrame) {
+void FFmpegDecoder::resample(const std::shared_ptr<AVFrame>& inputFrame) {
 	//total_duration += inputFrame->pkt_duration;
 	//AISDK_INFO(LX("resample").d("pkt_duration", inputFrame->pkt_duration).d("total_duration", total_duration));
 #if 0
@@ -347,9 +430,35 @@ void FFmpegDecoder::resample(std::shared_ptr<AVFrame> inputFrame) {
     transitionStateUsingStatus(error, DecodingState::INVALID, __func__);
 }
 
+void FFmpegDecoder::discardPreRoll(const AVFrame& inputFrame) {
+    auto timestamp = inputFrame.best_effort_timestamp;
+    if (AV_NOPTS_VALUE == timestamp) {
+        // Without timestamps there is no telling where the frame is; play from here.
+        AISDK_WARN(LX("discardPreRollFailed").d("reason", "noTimestamp"));
+        m_seekTarget = AV_NOPTS_VALUE;
+        return;
+    }
+
+    auto timebase = m_formatContext->streams[m_streamIndex]->time_base;
+    auto samples = av_rescale_q(m_seekTarget - timestamp, timebase, AVRational{1, m_outputRate});
+    if (samples <= 0) {
+        m_seekTarget = AV_NOPTS_VALUE;
+        return;
+    }
+
+    auto& frame = m_unreadData.getFrame();
+    if (samples < frame.nb_samples) {
+        // The position is inside this frame: play from it on.
+        m_unreadData.setOffset(static_cast<int>(samples));
+        m_seekTarget = AV_NOPTS_VALUE;
+    } else {
+        m_unreadData.setOffset(frame.nb_samples);
+    }
+}
+
 void FFmpegDecoder::decode() {
-    auto packet = std::shared_ptr<AVPacket>(av_packet_alloc(), AVPacketDeleter());
-    auto status = av_read_frame(m_formatContext.get(), packet.get());
+    auto packet = m_packet.get();
+    auto status = av_read_frame(m_formatContext.get(), packet);
 	if(status != 0) {
 		AISDK_DEBUG(LX("decode").d("readDecodeFrame", av_err2str(status)));
 	}
@@ -364,9 +473,11 @@ void FFmpegDecoder::decode() {
         }
 
         // Note: We still need to send empty packet when we find an EOF.
-        status = avcodec_send_packet(m_codecContext.get(), packet.get());
+        status = avcodec_send_packet(m_codecContext.get(), packet);
         transitionStateUsingStatus(status, m_state, "decode::sendPacket");
     }
+    // The codec keeps its own reference to the data; make the packet blank for the next read.
+    av_packet_unref(packet);
 }
 
 void FFmpegDecoder::next() {
@@ -434,11 +545,11 @@ void FFmpegDecoder::setState(FFmpegDecoder::DecodingState nextState) {
 bool FFmpegDecoder::transitionStateUsingStatus(
     int status,
     FFmpegDecoder::DecodingState nextState,
-    const std::string& functionName) {
+    const char* functionName) {
     if (status < 0) {
         // We'll try to keep decoding if error was due to buffer under run or corrupted data.
         if (-EAGAIN == status || AVERROR_INVALIDDATA == status) {
-            AISDK_ERROR(LX(functionName + "Failed").d("error", "tryAgain"));
+            AISDK_ERROR(LX(std::string(functionName) + "Failed").d("error", "tryAgain"));
             // Manually reset these variables since aviobuf::fill_buffer() set eof_reached even for EAGAIN error, which
             // invalidate future read operations.
             m_formatContext->pb->eof_reached = 0;
@@ -448,8 +559,7 @@ bool FFmpegDecoder::transitionStateUsingStatus(
         }
 
         if (status != AVERROR_EOF) {
-            AISDK_ERROR(LX(functionName + "Failed").d("error", av_err2str(status)));
-			AISDK_ERROR(LX(functionName + "Failed"));
+            AISDK_ERROR(LX(std::string(functionName) + "Failed").d("error", av_err2str(status)));
             setState(DecodingState::INVALID);
             return false;
         }
@@ -480,12 +590,21 @@ int FFmpegDecoder::UnreadData::getOffset() const {
 
 void FFmpegDecoder::UnreadData::resize(size_t minimumCapacity) {
     if (m_capacity < minimumCapacity) {
-        auto oldFrame = m_frame;
-        m_frame = std::shared_ptr<AVFrame>(av_frame_alloc(), AVFrameDeleter());
-        m_frame->format = oldFrame->format;
-        m_frame->sample_rate = oldFrame->sample_rate;
-        m_frame->channel_layout = oldFrame->channel_layout;
-        m_capacity = minimumCapacity;
+        // av_frame_unref() resets every field, so keep the output parameters.
+        auto format = m_frame->format;
+        auto sampleRate = m_frame->sample_rate;
+        auto layout = m_frame->channel_layout;
+        av_frame_unref(m_frame.get());
+        m_frame->format = format;
+        m_frame->sample_rate = sampleRate;
+        m_frame->channel_layout = layout;
+        m_capacity = std::max(minimumCapacity, m_capacity * 2);
+        m_frame->nb_samples = m_capacity;
+        if (av_frame_get_buffer(m_frame.get(), 0) < 0) {
+            // Leave the frame without a buffer; swr_convert_frame() then allocates one of its own.
+			AISDK_ERROR(LX("resizeFailed").d("reason", "allocBufferFailed").d("capacity", m_capacity));
+            m_capacity = 0;
+        }
     }
     m_frame->nb_samples = m_capacity;
     m_offset = 0;
@@ -126,10 +126,11 @@ FFmpegStreamInputController::getCurrentFormatContextOpen() {
         return std::make_tuple(Result::ERROR, nullptr, std::chrono::milliseconds::zero());
     }
 
-    // Allocate the AVFormatContext:
-    auto avFormatContext = avformat_alloc_context();
+    // Use the context createNewFormatContext() allocated: the decoder has set its interrupt callback.
+    auto avFormatContext = m_avFormatContext;
+    m_avFormatContext = nullptr;
     if (!avFormatContext) {
-		AISDK_ERROR(LX("getContextFailed").d("reason", "avFormatAllocFailed"));
+		AISDK_ERROR(LX("getContextFailed").d("reason", "avFormatIsnullptr"));
         return std::make_tuple(Result::ERROR, nullptr, std::chrono::milliseconds::zero());
     }
 
@@ -10,6 +10,10 @@
  * permissions and limitations under the License.
  */
 
+#include <sys/stat.h>
+
+#include <sstream>
+
 extern "C" {
 #include <libavformat/avformat.h>
 #include <libavutil/common.h>
@@ -104,6 +108,25 @@ bool FFmpegUrlInputController::next() {
     return true;
 }
 
+std::string FFmpegUrlInputController::getStreamCacheKey() const {
+    // Only local files are cached: they are the ones played again, and they can tell when they change.
+    auto path = m_currentUrl;
+    static const std::string FILE_SCHEME{"file:"};
+    if (0 == path.compare(0, FILE_SCHEME.size(), FILE_SCHEME)) {
+        path = path.substr(FILE_SCHEME.size());
+    } else if (std::string::npos != path.find("://")) {
+        return "";
+    }
+
+    struct stat status;
+    if (0 != stat(path.c_str(), &status)) {
+        return "";
+    }
+    std::ostringstream key;
+    key << path << '@' << status.st_mtime << ':' << status.st_size;
+    return key.str();
+}
+
 bool FFmpegUrlInputController::findFirstEntry() {
     //auto offset = m_offset;
     //while (!m_done) {
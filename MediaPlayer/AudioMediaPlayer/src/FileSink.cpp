@@ -0,0 +1,61 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+#include <Utils/Logging/Logger.h>
+#include "AudioMediaPlayer/FileSink.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG{"FileSink"};
+
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+std::unique_ptr<FileSink> FileSink::create(const std::string& path) {
+    auto file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        AISDK_ERROR(LX("createFailed").d("reason", "openFailed").d("path", path));
+        return nullptr;
+    }
+    return std::unique_ptr<FileSink>(new FileSink(file));
+}
+
+std::unique_ptr<FileSink> FileSink::createNull() {
+    return std::unique_ptr<FileSink>(new FileSink(nullptr));
+}
+
+FileSink::FileSink(FILE* file) : m_file{file}, m_bytesWritten{0} {
+}
+
+FileSink::~FileSink() {
+    if (m_file) {
+        std::fclose(m_file);
+    }
+}
+
+bool FileSink::write(const uint8_t* data, size_t size) {
+    if (m_file && std::fwrite(data, 1, size, m_file) != size) {
+        AISDK_ERROR(LX("writeFailed").d("size", size));
+        return false;
+    }
+    m_bytesWritten += size;
+    return true;
+}
+
+size_t FileSink::getBytesWritten() const {
+    return m_bytesWritten;
+}
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
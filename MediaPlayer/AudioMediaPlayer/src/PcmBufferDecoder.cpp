@@ -0,0 +1,50 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "AudioMediaPlayer/PcmBufferDecoder.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+PcmBufferDecoder::PcmBufferDecoder(DecodedAudioCache::Audio audio, size_t frameSize) :
+        m_audio{std::move(audio)},
+        m_frameSize{std::max<size_t>(frameSize, 1)},
+        m_position{0},
+        m_isAborted{false} {
+}
+
+std::pair<DecoderInterface::Status, size_t> PcmBufferDecoder::read(Byte* buffer, size_t size) {
+    if (m_isAborted || !m_audio || !buffer) {
+        return {Status::ERROR, 0};
+    }
+    auto remaining = m_audio->size() - m_position;
+    auto count = std::min(size - size % m_frameSize, remaining);
+    if (0 == count && remaining > 0) {
+        // Not even one frame fits.
+        return {Status::ERROR, 0};
+    }
+    std::memcpy(buffer, m_audio->data() + m_position, count);
+    m_position += count;
+    return {m_position == m_audio->size() ? Status::DONE : Status::OK, count};
+}
+
+void PcmBufferDecoder::abort() {
+    m_isAborted = true;
+}
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
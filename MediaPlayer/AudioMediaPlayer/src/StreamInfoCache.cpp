@@ -0,0 +1,55 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "AudioMediaPlayer/StreamInfoCache.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+
+constexpr size_t StreamInfoCache::MAX_ENTRIES;
+
+StreamInfoCache& StreamInfoCache::instance() {
+    static StreamInfoCache cache;
+    return cache;
+}
+
+bool StreamInfoCache::get(const std::string& key, StreamDescription* description) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return false;
+    }
+    *description = it->second;
+    return true;
+}
+
+void StreamInfoCache::put(const std::string& key, const StreamDescription& description) {
+    if (key.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_entries.size() >= MAX_ENTRIES && !m_entries.count(key)) {
+        // Entries of files which have changed since are never looked up again; starting over drops them.
+        m_entries.clear();
+    }
+    m_entries[key] = description;
+}
+
+void StreamInfoCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
@@ -0,0 +1,394 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Utils/MediaPlayer/MediaPlayerObserverInterface.h>
+
+#include "AudioMediaPlayer/AOWrapper.h"
+#include "AudioMediaPlayer/AudioMixer.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+namespace test {
+
+using namespace utils::mediaPlayer;
+
+/// How long to wait for a callback before failing.
+static const std::chrono::seconds TIMEOUT{5};
+
+/// The mixer period.
+static const std::chrono::milliseconds PERIOD_DURATION{10};
+
+/// How far ahead of the device clock the sink lets the mixer write, like the buffer of a sound card.
+static const std::chrono::milliseconds DEVICE_BUFFER_DURATION{50};
+
+/// The player's default format: 48 kHz, stereo, 16 bit.
+static const int SAMPLE_RATE = 48000;
+static const int CHANNELS = 2;
+
+/// The length of each test track.
+static const std::chrono::milliseconds TRACK_DURATION{300};
+
+/// The number of frames in each test track.
+static const size_t TRACK_FRAMES = SAMPLE_RATE * TRACK_DURATION.count() / 1000;
+
+/// The value of every sample of the first track, so its samples can be told from the second's and from silence.
+static const int16_t FIRST_TRACK_VALUE = 1000;
+
+/// The value of every sample of the second track.
+static const int16_t SECOND_TRACK_VALUE = 2000;
+
+/**
+ * An output which plays like a sound card: it takes audio no faster than real time, and when nothing has been written
+ * by the time it has played everything it holds, it plays silence.  Everything it plays, silence included, is recorded
+ * so the gap between two tracks can be counted in samples.
+ */
+class DeviceClockSink : public AudioSinkInterface {
+public:
+    DeviceClockSink() : m_isRunning{false} {
+    }
+
+    bool write(const uint8_t* data, size_t size) override {
+        std::chrono::steady_clock::time_point wakeTime;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto now = std::chrono::steady_clock::now();
+            if (!m_isRunning) {
+                m_isRunning = true;
+                m_playedUntil = now;
+            } else if (now > m_playedUntil) {
+                // Underrun: the device played silence since it ran out.
+                auto silence = std::chrono::duration_cast<std::chrono::microseconds>(now - m_playedUntil);
+                m_samples.insert(m_samples.end(), silence.count() * SAMPLE_RATE / 1000000 * CHANNELS, 0);
+                m_playedUntil = now;
+            }
+            auto samples = reinterpret_cast<const int16_t*>(data);
+            size_t count = size / sizeof(int16_t);
+            m_samples.insert(m_samples.end(), samples, samples + count);
+            m_playedUntil += std::chrono::microseconds(count / CHANNELS * 1000000 / SAMPLE_RATE);
+            wakeTime = m_playedUntil - DEVICE_BUFFER_DURATION;
+            m_wake.notify_all();
+        }
+        std::this_thread::sleep_until(wakeTime);
+        return true;
+    }
+
+    /// Waits until @c count samples of @c value have been played.
+    bool waitForSamples(int16_t value, size_t count) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_wake.wait_for(lock, TIMEOUT, [this, value, count] { return countLocked(value) >= count; });
+    }
+
+    std::vector<int16_t> getSamples() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_samples;
+    }
+
+private:
+    size_t countLocked(int16_t value) const {
+        size_t count = 0;
+        for (auto sample : m_samples) {
+            count += (sample == value);
+        }
+        return count;
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_isRunning;
+    std::chrono::steady_clock::time_point m_playedUntil;
+    std::vector<int16_t> m_samples;
+};
+
+/**
+ * Builds a WAV file in the player's default format in which every sample is @c value.
+ */
+static std::string createWav(std::chrono::milliseconds duration, int16_t value) {
+    const uint32_t sampleRate = SAMPLE_RATE;
+    const uint16_t channels = CHANNELS;
+    const uint16_t bits = 16;
+    const uint32_t dataSize = sampleRate * channels * (bits / 8) * duration.count() / 1000;
+    const uint32_t byteRate = sampleRate * channels * (bits / 8);
+    const uint16_t blockAlign = channels * (bits / 8);
+    const uint32_t riffSize = 36 + dataSize;
+    const uint32_t fmtSize = 16;
+    const uint16_t pcm = 1;
+
+    std::string wav;
+    auto append = [&wav](const void* data, size_t size) { wav.append(static_cast<const char*>(data), size); };
+    append("RIFF", 4);
+    append(&riffSize, 4);
+    append("WAVEfmt ", 8);
+    append(&fmtSize, 4);
+    append(&pcm, 2);
+    append(&channels, 2);
+    append(&sampleRate, 4);
+    append(&byteRate, 4);
+    append(&blockAlign, 2);
+    append(&bits, 2);
+    append("data", 4);
+    append(&dataSize, 4);
+    for (uint32_t i = 0; i < dataSize / sizeof(value); ++i) {
+        append(&value, sizeof(value));
+    }
+    return wav;
+}
+
+/**
+ * A WAV file which is deleted with the object.
+ */
+class TemporaryWav {
+public:
+    TemporaryWav(std::chrono::milliseconds duration, int16_t value) {
+        char path[] = "/tmp/AOWrapperGaplessTestXXXXXX";
+        int fd = mkstemp(path);
+        if (fd >= 0) {
+            close(fd);
+            m_path = path;
+            std::ofstream(m_path, std::ios::binary) << createWav(duration, value);
+        }
+    }
+
+    ~TemporaryWav() {
+        if (!m_path.empty()) {
+            unlink(m_path.c_str());
+        }
+    }
+
+    const std::string& getPath() const {
+        return m_path;
+    }
+
+private:
+    std::string m_path;
+};
+
+/// A callback and the source it was for.
+using Event = std::pair<std::string, MediaPlayerInterface::SourceId>;
+
+/**
+ * An observer which records the callbacks it gets in order.
+ */
+class RecordingObserver : public MediaPlayerObserverInterface {
+public:
+    void onPlaybackStarted(SourceId id) override {
+        record("started", id);
+    }
+    void onPlaybackFinished(SourceId id) override {
+        record("finished", id);
+    }
+    void onPlaybackStopped(SourceId id) override {
+        record("stopped", id);
+    }
+    void onPlaybackError(SourceId id, const ErrorType& type, std::string error) override {
+        record("error", id);
+    }
+
+    /// Waits until @c onPlaybackFinished has been called for @c id.
+    bool waitForFinished(SourceId id) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_wake.wait_for(lock, TIMEOUT, [this, id] {
+            for (auto& event : m_events) {
+                if (event.first == "finished" && event.second == id) {
+                    return true;
+                }
+            }
+            return false;
+        });
+    }
+
+    std::vector<Event> getEvents() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_events;
+    }
+
+private:
+    void record(const std::string& event, SourceId id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_events.emplace_back(event, id);
+        m_wake.notify_all();
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::vector<Event> m_events;
+};
+
+/**
+ * Counts the samples of silence between the last sample of the first track and the first of the second.
+ *
+ * @return The gap in frames, or -1 if either track is missing.
+ */
+static long measureGapFrames(const std::vector<int16_t>& samples) {
+    long lastOfFirst = -1;
+    long firstOfSecond = -1;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (samples[i] == FIRST_TRACK_VALUE) {
+            lastOfFirst = i;
+        } else if (samples[i] == SECOND_TRACK_VALUE && firstOfSecond < 0) {
+            firstOfSecond = i;
+        }
+    }
+    if (lastOfFirst < 0 || firstOfSecond < 0) {
+        return -1;
+    }
+    return (firstOfSecond - lastOfFirst - 1) / CHANNELS;
+}
+
+class AOWrapperGaplessTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_first.reset(new TemporaryWav(TRACK_DURATION, FIRST_TRACK_VALUE));
+        m_second.reset(new TemporaryWav(TRACK_DURATION, SECOND_TRACK_VALUE));
+        ASSERT_FALSE(m_first->getPath().empty());
+        ASSERT_FALSE(m_second->getPath().empty());
+
+        m_sink = new DeviceClockSink();
+        m_mixer = AudioMixer::create(
+            std::unique_ptr<AudioSinkInterface>(m_sink), PlaybackConfiguration(), PERIOD_DURATION);
+        ASSERT_TRUE(m_mixer);
+        m_player = AOWrapper::createForMixer(m_mixer);
+        ASSERT_TRUE(m_player);
+        m_observer = std::make_shared<RecordingObserver>();
+        m_player->setObserver(m_observer);
+    }
+
+    void TearDown() override {
+        m_player.reset();
+        m_mixer.reset();
+    }
+
+    std::unique_ptr<TemporaryWav> m_first;
+    std::unique_ptr<TemporaryWav> m_second;
+    /// Owned by @c m_mixer.
+    DeviceClockSink* m_sink;
+    std::shared_ptr<AudioMixer> m_mixer;
+    std::shared_ptr<RecordingObserver> m_observer;
+    std::unique_ptr<AOWrapper> m_player;
+};
+
+/**
+ * Verify a queued track follows the current one with no silence between them, every sample of both is played, and
+ * the observer sees the first finish before the second starts.
+ */
+TEST_F(AOWrapperGaplessTest, test_queuedTrackFollowsWithoutGap) {
+    auto first = m_player->setSource(m_first->getPath(), std::chrono::milliseconds::zero());
+    ASSERT_NE(MediaPlayerInterface::ERROR, first);
+    ASSERT_TRUE(m_player->play(first));
+    auto second = m_player->setNextSource(m_second->getPath());
+    ASSERT_NE(MediaPlayerInterface::ERROR, second);
+    ASSERT_NE(first, second);
+
+    ASSERT_TRUE(m_observer->waitForFinished(second));
+    ASSERT_TRUE(m_sink->waitForSamples(SECOND_TRACK_VALUE, TRACK_FRAMES * CHANNELS));
+
+    auto samples = m_sink->getSamples();
+    long gap = measureGapFrames(samples);
+    std::cout << "gapless hand-off: gap " << gap << " frames" << std::endl;
+    EXPECT_EQ(0, gap);
+    EXPECT_EQ(TRACK_FRAMES * CHANNELS, static_cast<size_t>(std::count(samples.begin(), samples.end(), FIRST_TRACK_VALUE)));
+    EXPECT_EQ(TRACK_FRAMES * CHANNELS, static_cast<size_t>(std::count(samples.begin(), samples.end(), SECOND_TRACK_VALUE)));
+
+    std::vector<Event> expected = {
+        Event("started", first), Event("finished", first), Event("started", second), Event("finished", second)};
+    EXPECT_EQ(expected, m_observer->getEvents());
+    EXPECT_EQ(TRACK_DURATION, m_player->getOffset(second));
+}
+
+/**
+ * Measure the gap when the second track is only set once the first has finished, as it was before queueing.  The
+ * device runs dry while the source is opened, so there is silence between the tracks.
+ */
+TEST_F(AOWrapperGaplessTest, test_setSourceAfterFinishLeavesGap) {
+    auto first = m_player->setSource(m_first->getPath(), std::chrono::milliseconds::zero());
+    ASSERT_TRUE(m_player->play(first));
+    ASSERT_TRUE(m_observer->waitForFinished(first));
+    auto second = m_player->setSource(m_second->getPath(), std::chrono::milliseconds::zero());
+    ASSERT_TRUE(m_player->play(second));
+    ASSERT_TRUE(m_observer->waitForFinished(second));
+    ASSERT_TRUE(m_sink->waitForSamples(SECOND_TRACK_VALUE, TRACK_FRAMES * CHANNELS));
+
+    long gap = measureGapFrames(m_sink->getSamples());
+    std::cout << "setSource after finish: gap " << gap << " frames" << std::endl;
+    EXPECT_GT(gap, 0);
+}
+
+/**
+ * Verify a queued track which is cleared before the current one ends is not played.
+ */
+TEST_F(AOWrapperGaplessTest, test_clearNextSource) {
+    auto first = m_player->setSource(m_first->getPath(), std::chrono::milliseconds::zero());
+    ASSERT_TRUE(m_player->play(first));
+    auto second = m_player->setNextSource(m_second->getPath());
+    ASSERT_NE(MediaPlayerInterface::ERROR, second);
+    EXPECT_TRUE(m_player->clearNextSource());
+    EXPECT_FALSE(m_player->clearNextSource());
+
+    ASSERT_TRUE(m_observer->waitForFinished(first));
+    std::this_thread::sleep_for(PERIOD_DURATION * 10);
+    std::vector<Event> expected = {
+        Event("started", first), Event("finished", first)};
+    EXPECT_EQ(expected, m_observer->getEvents());
+    auto samples = m_sink->getSamples();
+    EXPECT_EQ(0, std::count(samples.begin(), samples.end(), SECOND_TRACK_VALUE));
+}
+
+/**
+ * Verify stopping the current track discards the queued one.
+ */
+TEST_F(AOWrapperGaplessTest, test_stopDiscardsNextSource) {
+    auto first = m_player->setSource(m_first->getPath(), std::chrono::milliseconds::zero());
+    ASSERT_TRUE(m_player->play(first));
+    ASSERT_NE(MediaPlayerInterface::ERROR, m_player->setNextSource(m_second->getPath()));
+    ASSERT_TRUE(m_player->stop(first));
+    EXPECT_FALSE(m_player->clearNextSource());
+
+    std::this_thread::sleep_for(TRACK_DURATION);
+    std::vector<Event> expected = {
+        Event("started", first), Event("stopped", first)};
+    EXPECT_EQ(expected, m_observer->getEvents());
+}
+
+/**
+ * Verify nothing can be queued while nothing plays.
+ */
+TEST_F(AOWrapperGaplessTest, test_setNextSourceWhenIdle) {
+    EXPECT_EQ(MediaPlayerInterface::ERROR, m_player->setNextSource(m_second->getPath()));
+
+    auto first = m_player->setSource(m_first->getPath(), std::chrono::milliseconds::zero());
+    ASSERT_TRUE(m_player->play(first));
+    ASSERT_TRUE(m_observer->waitForFinished(first));
+    EXPECT_EQ(MediaPlayerInterface::ERROR, m_player->setNextSource(m_second->getPath()));
+}
+
+}  // namespace test
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
@@ -0,0 +1,351 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Utils/MediaPlayer/MediaPlayerObserverInterface.h>
+
+#include "AudioMediaPlayer/AOWrapper.h"
+#include "AudioMediaPlayer/AudioMixer.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+namespace test {
+
+using namespace utils::mediaPlayer;
+
+/// The number of setSource/play/stop cycles in the stress test.
+static const int CYCLES = 2000;
+
+/// How long to wait for a callback before failing.
+static const std::chrono::seconds TIMEOUT{5};
+
+/// The mixer period.
+static const std::chrono::milliseconds PERIOD_DURATION{10};
+
+/**
+ * An output which takes audio no faster than real time, like a sound card, and throws it away.
+ */
+class PacedSink : public AudioSinkInterface {
+public:
+    bool write(const uint8_t* data, size_t size) override {
+        std::this_thread::sleep_for(PERIOD_DURATION);
+        return true;
+    }
+};
+
+/**
+ * Builds a WAV file of silence in the player's default format: 48 kHz, stereo, 16 bit.
+ *
+ * @param duration The length of the audio.
+ * @return The file contents.
+ */
+static std::string createWav(std::chrono::milliseconds duration) {
+    const uint32_t sampleRate = 48000;
+    const uint16_t channels = 2;
+    const uint16_t bits = 16;
+    const uint32_t dataSize = sampleRate * channels * (bits / 8) * duration.count() / 1000;
+    const uint32_t byteRate = sampleRate * channels * (bits / 8);
+    const uint16_t blockAlign = channels * (bits / 8);
+    const uint32_t riffSize = 36 + dataSize;
+    const uint32_t fmtSize = 16;
+    const uint16_t pcm = 1;
+
+    std::string wav;
+    auto append = [&wav](const void* data, size_t size) { wav.append(static_cast<const char*>(data), size); };
+    append("RIFF", 4);
+    append(&riffSize, 4);
+    append("WAVEfmt ", 8);
+    append(&fmtSize, 4);
+    append(&pcm, 2);
+    append(&channels, 2);
+    append(&sampleRate, 4);
+    append(&byteRate, 4);
+    append(&blockAlign, 2);
+    append(&bits, 2);
+    append("data", 4);
+    append(&dataSize, 4);
+    wav.append(dataSize, '\0');
+    return wav;
+}
+
+/**
+ * An observer which counts the callbacks it gets.
+ */
+class CountingObserver : public MediaPlayerObserverInterface {
+public:
+    CountingObserver() : m_started{0}, m_finished{0}, m_stopped{0}, m_errors{0} {
+    }
+
+    void onPlaybackStarted(SourceId id) override {
+        count(&m_started);
+    }
+    void onPlaybackFinished(SourceId id) override {
+        count(&m_finished);
+    }
+    void onPlaybackStopped(SourceId id) override {
+        count(&m_stopped);
+    }
+    void onPlaybackError(SourceId id, const ErrorType& type, std::string error) override {
+        count(&m_errors);
+    }
+
+    /// Waits until @c onPlaybackFinished has been called @c count times.
+    bool waitForFinished(int count) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_wake.wait_for(lock, TIMEOUT, [this, count] { return m_finished >= count; });
+    }
+
+    int started() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_started;
+    }
+    int finished() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_finished;
+    }
+    int stopped() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stopped;
+    }
+    int errors() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_errors;
+    }
+
+private:
+    void count(int* counter) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++*counter;
+        m_wake.notify_all();
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    int m_started;
+    int m_finished;
+    int m_stopped;
+    int m_errors;
+};
+
+/**
+ * Latency figures for one kind of command, in microseconds.
+ */
+class LatencyStats {
+public:
+    void add(std::chrono::steady_clock::duration latency) {
+        m_samples.push_back(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    }
+
+    long mean() const {
+        long sum = 0;
+        for (auto sample : m_samples) {
+            sum += sample;
+        }
+        return m_samples.empty() ? 0 : sum / static_cast<long>(m_samples.size());
+    }
+
+    long percentile(double fraction) const {
+        if (m_samples.empty()) {
+            return 0;
+        }
+        auto sorted = m_samples;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[static_cast<size_t>(fraction * (sorted.size() - 1))];
+    }
+
+    void print(const std::string& name) const {
+        std::cout << name << ": mean " << mean() << " us, p99 " << percentile(0.99) << " us, max "
+                  << percentile(1.0) << " us" << std::endl;
+    }
+
+private:
+    std::vector<long> m_samples;
+};
+
+class AOWrapperWorkerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_mixer = AudioMixer::create(
+            std::unique_ptr<AudioSinkInterface>(new PacedSink()), PlaybackConfiguration(), PERIOD_DURATION);
+        ASSERT_TRUE(m_mixer);
+        m_player = AOWrapper::createForMixer(m_mixer);
+        ASSERT_TRUE(m_player);
+        m_observer = std::make_shared<CountingObserver>();
+        m_player->setObserver(m_observer);
+    }
+
+    void TearDown() override {
+        m_player.reset();
+    }
+
+    std::shared_ptr<AudioMixer> m_mixer;
+    std::shared_ptr<CountingObserver> m_observer;
+    std::unique_ptr<AOWrapper> m_player;
+};
+
+/**
+ * Verify a source plays to the end and is reported finished, not stopped.
+ */
+TEST_F(AOWrapperWorkerTest, test_playsToTheEnd) {
+    auto id = m_player->setSource(std::make_shared<std::stringstream>(createWav(std::chrono::milliseconds(100))), false);
+    ASSERT_TRUE(MediaPlayerInterface::ERROR != id);
+    ASSERT_TRUE(m_player->play(id));
+    ASSERT_TRUE(m_observer->waitForFinished(1));
+    EXPECT_EQ(1, m_observer->started());
+    EXPECT_EQ(0, m_observer->stopped());
+    EXPECT_FALSE(m_player->stop(id));
+}
+
+/**
+ * Verify thousands of setSource/play/stop cycles neither wait for the playback thread nor lose a callback, and a
+ * source set after them still plays. Prints the latency of each command.
+ */
+TEST_F(AOWrapperWorkerTest, test_rapidSetSourceAndStop) {
+    const auto wav = createWav(std::chrono::milliseconds(500));
+    LatencyStats setSourceLatency;
+    LatencyStats playLatency;
+    LatencyStats stopLatency;
+
+    for (int i = 0; i < CYCLES; ++i) {
+        auto stream = std::make_shared<std::stringstream>(wav);
+        auto start = std::chrono::steady_clock::now();
+        auto id = m_player->setSource(stream, false);
+        auto afterSetSource = std::chrono::steady_clock::now();
+        ASSERT_TRUE(MediaPlayerInterface::ERROR != id);
+        ASSERT_TRUE(m_player->play(id));
+        auto afterPlay = std::chrono::steady_clock::now();
+        ASSERT_TRUE(m_player->stop(id));
+        auto afterStop = std::chrono::steady_clock::now();
+
+        setSourceLatency.add(afterSetSource - start);
+        playLatency.add(afterPlay - afterSetSource);
+        stopLatency.add(afterStop - afterPlay);
+    }
+
+    setSourceLatency.print("setSource");
+    playLatency.print("play");
+    stopLatency.print("stop");
+    EXPECT_EQ(CYCLES, m_observer->started());
+    EXPECT_EQ(CYCLES, m_observer->stopped());
+    EXPECT_EQ(0, m_observer->finished());
+    EXPECT_EQ(0, m_observer->errors());
+
+    // None of the commands waits for the playback thread, so none takes anywhere near a mixer period.
+    EXPECT_LT(stopLatency.mean(), 1000);
+    EXPECT_LT(setSourceLatency.mean(), 1000);
+
+    auto id = m_player->setSource(std::make_shared<std::stringstream>(createWav(std::chrono::milliseconds(50))), false);
+    ASSERT_TRUE(m_player->play(id));
+    ASSERT_TRUE(m_observer->waitForFinished(1));
+}
+
+/**
+ * Waits until the position of a source stops moving, i.e. the output has played all it held of it.
+ *
+ * @return The position it settled on.
+ */
+static std::chrono::milliseconds waitForSettledOffset(AOWrapper* player, MediaPlayerInterface::SourceId id) {
+    auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    auto offset = player->getOffset(id);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(PERIOD_DURATION * 10);
+        auto next = player->getOffset(id);
+        if (next == offset) {
+            break;
+        }
+        offset = next;
+    }
+    return offset;
+}
+
+/**
+ * Verify the position counts what the output has played, not what was decoded: at the end it is the length of the
+ * source, however much the mixer still held when decoding finished.
+ */
+TEST_F(AOWrapperWorkerTest, test_offsetAtTheEnd) {
+    auto id = m_player->setSource(std::make_shared<std::stringstream>(createWav(std::chrono::milliseconds(300))), false);
+    ASSERT_TRUE(MediaPlayerInterface::ERROR != id);
+    EXPECT_EQ(std::chrono::milliseconds::zero(), m_player->getOffset(id));
+    ASSERT_TRUE(m_player->play(id));
+    ASSERT_TRUE(m_observer->waitForFinished(1));
+    EXPECT_EQ(std::chrono::milliseconds(300), waitForSettledOffset(m_player.get(), id));
+}
+
+/**
+ * Verify the position stands still while paused and carries on from there on resume, so the source plays to its
+ * length with nothing skipped or repeated.
+ */
+TEST_F(AOWrapperWorkerTest, test_offsetAcrossPause) {
+    auto id = m_player->setSource(std::make_shared<std::stringstream>(createWav(std::chrono::milliseconds(500))), false);
+    ASSERT_TRUE(m_player->play(id));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_TRUE(m_player->pause(id));
+
+    auto paused = waitForSettledOffset(m_player.get(), id);
+    EXPECT_GT(paused, std::chrono::milliseconds::zero());
+    EXPECT_LT(paused, std::chrono::milliseconds(500));
+    std::this_thread::sleep_for(PERIOD_DURATION * 10);
+    EXPECT_EQ(paused, m_player->getOffset(id));
+
+    ASSERT_TRUE(m_player->resume(id));
+    ASSERT_TRUE(m_observer->waitForFinished(1));
+    EXPECT_EQ(std::chrono::milliseconds(500), waitForSettledOffset(m_player.get(), id));
+}
+
+/**
+ * Verify a stopped source keeps the position it was stopped at, which is what a caller resumes it from later.
+ */
+TEST_F(AOWrapperWorkerTest, test_offsetAfterStop) {
+    auto id = m_player->setSource(std::make_shared<std::stringstream>(createWav(std::chrono::milliseconds(500))), false);
+    ASSERT_TRUE(m_player->play(id));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    ASSERT_TRUE(m_player->stop(id));
+
+    auto stopped = m_player->getOffset(id);
+    EXPECT_GT(stopped, std::chrono::milliseconds::zero());
+    EXPECT_LT(stopped, std::chrono::milliseconds(500));
+    std::this_thread::sleep_for(PERIOD_DURATION * 10);
+    EXPECT_EQ(stopped, m_player->getOffset(id));
+}
+
+/**
+ * Verify the player can be destroyed while a source is playing and others are still queued.
+ */
+TEST_F(AOWrapperWorkerTest, test_shutdownWhilePlaying) {
+    const auto wav = createWav(std::chrono::milliseconds(500));
+    for (int i = 0; i < 10; ++i) {
+        auto id = m_player->setSource(std::make_shared<std::stringstream>(wav), false);
+        ASSERT_TRUE(m_player->play(id));
+    }
+    m_player.reset();
+    EXPECT_EQ(10, m_observer->started());
+    EXPECT_EQ(0, m_observer->finished());
+}
+
+}  // namespace test
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
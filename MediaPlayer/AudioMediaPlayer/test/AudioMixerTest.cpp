@@ -0,0 +1,326 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "AudioMediaPlayer/AudioMixer.h"
+#include "AudioMediaPlayer/FileSink.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+namespace test {
+
+/// A short period keeps the tests quick: 48 kHz stereo, 10 ms = 960 samples.
+static const std::chrono::milliseconds PERIOD_DURATION{10};
+
+/// The number of samples in one period.
+static const size_t PERIOD_SAMPLES = 960;
+
+/// How long to wait for the mixer before failing.
+static const std::chrono::seconds TIMEOUT{2};
+
+/**
+ * A sink which records every period and can hold the mixer inside @c write() until released.
+ */
+class RecordingSink : public AudioSinkInterface {
+public:
+    RecordingSink() : m_isClosed{false}, m_blockedWrites{0} {
+    }
+
+    bool write(const uint8_t* data, size_t size) override {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        std::vector<int16_t> period(size / sizeof(int16_t));
+        std::memcpy(period.data(), data, size);
+        m_periods.push_back(period);
+        ++m_blockedWrites;
+        m_wake.notify_all();
+        m_wake.wait(lock, [this] { return !m_isClosed; });
+        --m_blockedWrites;
+        return true;
+    }
+
+    /// Makes the following writes block until @c open().
+    void close() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isClosed = true;
+    }
+
+    /// Lets writes through again.
+    void open() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isClosed = false;
+        m_wake.notify_all();
+    }
+
+    /// Waits until @c count periods have been written, and for a write to be blocked if @c blocked.
+    bool waitForPeriods(size_t count, bool blocked = false) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_wake.wait_for(lock, TIMEOUT, [this, count, blocked] {
+            return m_periods.size() >= count && (!blocked || m_blockedWrites > 0);
+        });
+    }
+
+    std::vector<std::vector<int16_t>> getPeriods() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_periods;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_isClosed;
+    int m_blockedWrites;
+    std::vector<std::vector<int16_t>> m_periods;
+};
+
+class AudioMixerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto sink = std::unique_ptr<RecordingSink>(new RecordingSink());
+        m_sink = sink.get();
+        m_mixer = AudioMixer::create(std::move(sink), PlaybackConfiguration(), PERIOD_DURATION);
+        ASSERT_TRUE(m_mixer);
+    }
+
+    void TearDown() override {
+        m_sink->open();
+    }
+
+    /// Writes @c samples samples of one value.
+    static bool writeConstant(const std::shared_ptr<AudioSinkInterface>& source, int16_t value, size_t samples) {
+        std::vector<int16_t> data(samples, value);
+        return source->write(reinterpret_cast<const uint8_t*>(data.data()), samples * sizeof(int16_t));
+    }
+
+    /**
+     * Holds the mixer in the sink's write() with one period of silence from a warm-up source, so the test can queue
+     * audio on several sources before the mixer looks at them.
+     */
+    void holdMixer() {
+        auto warmUp = m_mixer->createSource();
+        m_sink->close();
+        ASSERT_TRUE(writeConstant(warmUp, 0, PERIOD_SAMPLES));
+        ASSERT_TRUE(m_sink->waitForPeriods(1, true));
+    }
+
+    RecordingSink* m_sink;
+    std::shared_ptr<AudioMixer> m_mixer;
+};
+
+/**
+ * Verify the mixer only takes 16 bit native-endian audio and needs an output.
+ */
+TEST_F(AudioMixerTest, test_createRejectsInvalidArguments) {
+    EXPECT_FALSE(AudioMixer::create(nullptr));
+    EXPECT_FALSE(AudioMixer::create(
+        FileSink::createNull(),
+        PlaybackConfiguration(
+            true, 48000, PlaybackConfiguration::ChannelLayout::LAYOUT_STEREO,
+            PlaybackConfiguration::SampleFormat::SIGNED_32)));
+    EXPECT_FALSE(AudioMixer::create(FileSink::createNull(), PlaybackConfiguration(), std::chrono::milliseconds(0)));
+    EXPECT_EQ(PERIOD_SAMPLES * sizeof(int16_t), m_mixer->getPeriodBytes());
+}
+
+/**
+ * Verify a single source comes out unchanged, in whole periods.
+ */
+TEST_F(AudioMixerTest, test_singleSourcePassesThrough) {
+    auto source = m_mixer->createSource();
+    std::vector<int16_t> ramp(PERIOD_SAMPLES * 2);
+    for (size_t i = 0; i < ramp.size(); ++i) {
+        ramp[i] = static_cast<int16_t>(i * 17 - 16000);
+    }
+    ASSERT_TRUE(source->write(reinterpret_cast<const uint8_t*>(ramp.data()), ramp.size() * sizeof(int16_t)));
+    ASSERT_TRUE(m_sink->waitForPeriods(2));
+
+    auto periods = m_sink->getPeriods();
+    ASSERT_EQ(2u, periods.size());
+    EXPECT_EQ(std::vector<int16_t>(ramp.begin(), ramp.begin() + PERIOD_SAMPLES), periods[0]);
+    EXPECT_EQ(std::vector<int16_t>(ramp.begin() + PERIOD_SAMPLES, ramp.end()), periods[1]);
+}
+
+/**
+ * Verify sources are summed, and the sum is clamped rather than wrapped.
+ */
+TEST_F(AudioMixerTest, test_sumSaturates) {
+    auto first = m_mixer->createSource();
+    auto second = m_mixer->createSource();
+    holdMixer();
+    ASSERT_TRUE(writeConstant(first, 30000, PERIOD_SAMPLES));
+    ASSERT_TRUE(writeConstant(second, 10000, PERIOD_SAMPLES));
+    ASSERT_TRUE(writeConstant(first, -30000, PERIOD_SAMPLES));
+    ASSERT_TRUE(writeConstant(second, -10000, PERIOD_SAMPLES));
+    ASSERT_TRUE(writeConstant(first, 1000, PERIOD_SAMPLES));
+    ASSERT_TRUE(writeConstant(second, -300, PERIOD_SAMPLES));
+    m_sink->open();
+    ASSERT_TRUE(m_sink->waitForPeriods(4));
+
+    auto periods = m_sink->getPeriods();
+    ASSERT_EQ(4u, periods.size());
+    EXPECT_EQ(std::vector<int16_t>(PERIOD_SAMPLES, 32767), periods[1]);
+    EXPECT_EQ(std::vector<int16_t>(PERIOD_SAMPLES, -32768), periods[2]);
+    EXPECT_EQ(std::vector<int16_t>(PERIOD_SAMPLES, 700), periods[3]);
+}
+
+/**
+ * Verify the end of a track shorter than a period is played, padded with silence, after a period's wait.
+ */
+TEST_F(AudioMixerTest, test_partialPeriodIsPaddedAfterTimeout) {
+    auto source = m_mixer->createSource();
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(writeConstant(source, 5, PERIOD_SAMPLES / 2));
+    ASSERT_TRUE(m_sink->waitForPeriods(1));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, PERIOD_DURATION);
+
+    auto periods = m_sink->getPeriods();
+    ASSERT_EQ(1u, periods.size());
+    std::vector<int16_t> expected(PERIOD_SAMPLES, 0);
+    std::fill(expected.begin(), expected.begin() + PERIOD_SAMPLES / 2, 5);
+    EXPECT_EQ(expected, periods[0]);
+}
+
+/**
+ * Verify a sample split over two writes is put back together.
+ */
+TEST_F(AudioMixerTest, test_sampleSplitBetweenWrites) {
+    auto source = m_mixer->createSource();
+    std::vector<int16_t> samples(PERIOD_SAMPLES, 0x1234);
+    auto bytes = reinterpret_cast<const uint8_t*>(samples.data());
+    ASSERT_TRUE(source->write(bytes, 3));
+    ASSERT_TRUE(source->write(bytes + 3, samples.size() * sizeof(int16_t) - 3));
+    ASSERT_TRUE(m_sink->waitForPeriods(1));
+    EXPECT_EQ(samples, m_sink->getPeriods()[0]);
+}
+
+/**
+ * Verify flush() drops buffered audio and releases a writer blocked on a full source.
+ */
+TEST_F(AudioMixerTest, test_flushReleasesBlockedWriter) {
+    auto source = m_mixer->createSource();
+    holdMixer();
+    // More than the source can buffer, so the write blocks.
+    auto writeResult = std::async(std::launch::async, [&] {
+        return writeConstant(source, 99, PERIOD_SAMPLES * (AudioMixer::DEFAULT_PERIODS_PER_SOURCE + 2));
+    });
+    EXPECT_EQ(std::future_status::timeout, writeResult.wait_for(PERIOD_DURATION * 5));
+    source->flush();
+    ASSERT_EQ(std::future_status::ready, writeResult.wait_for(TIMEOUT));
+    EXPECT_FALSE(writeResult.get());
+
+    // Nothing of the flushed audio is played, and the source still works afterwards.
+    ASSERT_TRUE(writeConstant(source, 7, PERIOD_SAMPLES));
+    m_sink->open();
+    ASSERT_TRUE(m_sink->waitForPeriods(2));
+    auto periods = m_sink->getPeriods();
+    ASSERT_EQ(2u, periods.size());
+    EXPECT_EQ(std::vector<int16_t>(PERIOD_SAMPLES, 7), periods[1]);
+}
+
+/**
+ * Verify sources can come and go while the mixer runs, with audio still buffered.
+ */
+TEST_F(AudioMixerTest, test_sourceDestroyedWithPendingAudio) {
+    auto source = m_mixer->createSource();
+    holdMixer();
+    ASSERT_TRUE(writeConstant(source, 3, PERIOD_SAMPLES * 2));
+    source.reset();
+    m_sink->open();
+
+    auto other = m_mixer->createSource();
+    ASSERT_TRUE(writeConstant(other, 4, PERIOD_SAMPLES));
+    ASSERT_TRUE(m_sink->waitForPeriods(2));
+    EXPECT_EQ(std::vector<int16_t>(PERIOD_SAMPLES, 4), m_sink->getPeriods()[1]);
+}
+
+/**
+ * Verify setGain() only takes a gain in [0, 1] and a non-negative ramp.
+ */
+TEST_F(AudioMixerTest, test_setGainRejectsInvalidArguments) {
+    auto source = m_mixer->createSource();
+    EXPECT_FALSE(source->setGain(-0.1f, std::chrono::milliseconds::zero()));
+    EXPECT_FALSE(source->setGain(1.5f, std::chrono::milliseconds::zero()));
+    EXPECT_FALSE(source->setGain(0.5f, std::chrono::milliseconds(-1)));
+    EXPECT_TRUE(source->setGain(0.5f, std::chrono::milliseconds::zero()));
+    EXPECT_TRUE(source->setGain(1.0f, PERIOD_DURATION));
+}
+
+/**
+ * Verify a ducked source is scaled before it is summed with the others.
+ */
+TEST_F(AudioMixerTest, test_duckedSourceIsScaled) {
+    auto ducked = m_mixer->createSource();
+    auto primary = m_mixer->createSource();
+    ASSERT_TRUE(ducked->setGain(0.25f, std::chrono::milliseconds::zero()));
+    holdMixer();
+    ASSERT_TRUE(writeConstant(ducked, 8000, PERIOD_SAMPLES));
+    ASSERT_TRUE(writeConstant(primary, 100, PERIOD_SAMPLES));
+    m_sink->open();
+    ASSERT_TRUE(m_sink->waitForPeriods(2));
+    EXPECT_EQ(std::vector<int16_t>(PERIOD_SAMPLES, 2100), m_sink->getPeriods()[1]);
+}
+
+/**
+ * Verify a gain change is ramped frame by frame, without a step, and holds once the ramp is over.
+ */
+TEST_F(AudioMixerTest, test_gainRampIsSmooth) {
+    auto source = m_mixer->createSource();
+    holdMixer();
+    // Ramp to silence over exactly one period.
+    ASSERT_TRUE(source->setGain(0.0f, PERIOD_DURATION));
+    ASSERT_TRUE(writeConstant(source, 10000, PERIOD_SAMPLES * 2));
+    m_sink->open();
+    ASSERT_TRUE(m_sink->waitForPeriods(3));
+
+    auto periods = m_sink->getPeriods();
+    const auto& ramp = periods[1];
+    EXPECT_GT(ramp.front(), 9900);
+    EXPECT_LT(ramp.back(), 100);
+    for (size_t i = 2; i < ramp.size(); i += 2) {
+        // Both channels of a frame get the same gain, and no frame is louder than the one before.
+        EXPECT_EQ(ramp[i], ramp[i + 1]);
+        EXPECT_LE(ramp[i], ramp[i - 2]);
+        EXPECT_LT(ramp[i - 2] - ramp[i], 100);
+    }
+    EXPECT_EQ(std::vector<int16_t>(PERIOD_SAMPLES, 0), periods[2]);
+}
+
+/**
+ * Verify the file sink receives whole periods.
+ */
+TEST(AudioMixerFileSinkTest, test_nullSinkCountsPeriods) {
+    auto sink = FileSink::createNull();
+    auto sinkPtr = sink.get();
+    auto mixer = AudioMixer::create(std::move(sink), PlaybackConfiguration(), PERIOD_DURATION);
+    ASSERT_TRUE(mixer);
+    auto source = mixer->createSource();
+    std::vector<int16_t> data(PERIOD_SAMPLES * 10, 1);
+    ASSERT_TRUE(source->write(reinterpret_cast<const uint8_t*>(data.data()), data.size() * sizeof(int16_t)));
+    const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+    while (sinkPtr->getBytesWritten() < data.size() * sizeof(int16_t) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(data.size() * sizeof(int16_t), sinkPtr->getBytesWritten());
+}
+
+}  // namespace test
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
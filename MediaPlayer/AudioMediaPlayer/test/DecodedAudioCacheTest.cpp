@@ -0,0 +1,198 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "AudioMediaPlayer/CachingDecoder.h"
+#include "AudioMediaPlayer/DecodedAudioCache.h"
+#include "AudioMediaPlayer/PcmBufferDecoder.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+namespace test {
+
+using Byte = DecodedAudioCache::Byte;
+using Status = DecoderInterface::Status;
+
+/// The bytes of a 16 bit stereo frame.
+static const size_t FRAME_SIZE = 4;
+
+/**
+ * Builds audio of some bytes, counting up.
+ */
+static DecodedAudioCache::Audio makeAudio(size_t size) {
+    auto audio = std::make_shared<std::vector<Byte>>(size);
+    for (size_t i = 0; i < size; ++i) {
+        (*audio)[i] = static_cast<Byte>(i);
+    }
+    return audio;
+}
+
+/**
+ * A decoder handing out audio in reads, and failing with the last one if asked to.
+ */
+class FakeDecoder : public DecoderInterface {
+public:
+    FakeDecoder(DecodedAudioCache::Audio audio, bool fails) : m_decoder{audio, FRAME_SIZE}, m_fails{fails} {
+    }
+
+    std::pair<Status, size_t> read(Byte* buffer, size_t size) override {
+        auto result = m_decoder.read(buffer, size);
+        if (m_fails && Status::DONE == result.first) {
+            return {Status::ERROR, 0};
+        }
+        return result;
+    }
+
+    void abort() override {
+        m_decoder.abort();
+    }
+
+private:
+    PcmBufferDecoder m_decoder;
+    bool m_fails;
+};
+
+/**
+ * Reads a decoder to its end.
+ *
+ * @return The status of the last read.
+ */
+static Status readAll(DecoderInterface& decoder, std::vector<Byte>* audio) {
+    Byte buffer[64];
+    while (true) {
+        auto result = decoder.read(buffer, sizeof buffer);
+        if (audio) {
+            audio->insert(audio->end(), buffer, buffer + result.second);
+        }
+        if (Status::OK != result.first) {
+            return result.first;
+        }
+    }
+}
+
+/**
+ * Verify that the cache drops the audio used least recently to stay within its bytes, and refuses audio larger.
+ */
+TEST(DecodedAudioCacheTest, test_evictsLeastRecentlyUsed) {
+    DecodedAudioCache cache(300);
+    EXPECT_TRUE(cache.put("a", makeAudio(100)));
+    EXPECT_TRUE(cache.put("b", makeAudio(100)));
+    EXPECT_TRUE(cache.put("c", makeAudio(100)));
+    ASSERT_NE(nullptr, cache.get("a"));
+
+    EXPECT_TRUE(cache.put("d", makeAudio(150)));
+    EXPECT_NE(nullptr, cache.get("a"));
+    EXPECT_EQ(nullptr, cache.get("b"));
+    EXPECT_EQ(nullptr, cache.get("c"));
+    EXPECT_NE(nullptr, cache.get("d"));
+    EXPECT_EQ(250u, cache.getBytes());
+
+    EXPECT_FALSE(cache.put("e", makeAudio(301)));
+    EXPECT_FALSE(cache.put("", makeAudio(10)));
+    EXPECT_FALSE(cache.put("f", nullptr));
+    EXPECT_EQ(250u, cache.getBytes());
+
+    // Replacing audio counts only the new one.
+    EXPECT_TRUE(cache.put("a", makeAudio(50)));
+    EXPECT_EQ(200u, cache.getBytes());
+    cache.clear();
+    EXPECT_EQ(0u, cache.getBytes());
+    EXPECT_EQ(nullptr, cache.get("a"));
+}
+
+/**
+ * Verify that the key tells the output formats apart, and that a stream which can't be cached gets no key.
+ */
+TEST(DecodedAudioCacheTest, test_keyIncludesFormat) {
+    PlaybackConfiguration stereo;
+    PlaybackConfiguration mono(
+        true, 16000, PlaybackConfiguration::ChannelLayout::LAYOUT_MONO, PlaybackConfiguration::SampleFormat::SIGNED_16);
+    EXPECT_NE(
+        DecodedAudioCache::makeKey("/cfg/ding.mp3@1:100", stereo),
+        DecodedAudioCache::makeKey("/cfg/ding.mp3@1:100", mono));
+    EXPECT_TRUE(DecodedAudioCache::makeKey("", stereo).empty());
+}
+
+/**
+ * Verify that a buffer decoder reads whole frames, ends with DONE along with the last bytes, and fails once aborted.
+ */
+TEST(DecodedAudioCacheTest, test_pcmBufferDecoderReads) {
+    auto audio = makeAudio(10 * FRAME_SIZE);
+    PcmBufferDecoder decoder(audio, FRAME_SIZE);
+    Byte buffer[32];
+
+    auto result = decoder.read(buffer, 30);
+    EXPECT_EQ(Status::OK, result.first);
+    EXPECT_EQ(28u, result.second);
+    EXPECT_EQ(0, buffer[0]);
+    result = decoder.read(buffer, sizeof buffer);
+    EXPECT_EQ(Status::DONE, result.first);
+    EXPECT_EQ(12u, result.second);
+    EXPECT_EQ(28, buffer[0]);
+
+    PcmBufferDecoder aborted(audio, FRAME_SIZE);
+    aborted.abort();
+    EXPECT_EQ(Status::ERROR, aborted.read(buffer, sizeof buffer).first);
+}
+
+/**
+ * Verify that a caching decoder passes the audio on and keeps it once read to the end, but not after an error.
+ */
+TEST(DecodedAudioCacheTest, test_cachingDecoderKeepsCompleteAudio) {
+    DecodedAudioCache cache;
+    auto audio = makeAudio(100 * FRAME_SIZE);
+
+    CachingDecoder decoder(std::make_shared<FakeDecoder>(audio, false), "ok", cache);
+    std::vector<Byte> played;
+    EXPECT_EQ(Status::DONE, readAll(decoder, &played));
+    EXPECT_EQ(*audio, played);
+    auto cached = cache.get("ok");
+    ASSERT_NE(nullptr, cached);
+    EXPECT_EQ(*audio, *cached);
+
+    CachingDecoder failing(std::make_shared<FakeDecoder>(audio, true), "failed", cache);
+    EXPECT_EQ(Status::ERROR, readAll(failing, nullptr));
+    EXPECT_EQ(nullptr, cache.get("failed"));
+
+    CachingDecoder aborted(std::make_shared<FakeDecoder>(audio, false), "aborted", cache);
+    Byte buffer[64];
+    aborted.read(buffer, sizeof buffer);
+    aborted.abort();
+    EXPECT_EQ(Status::ERROR, readAll(aborted, nullptr));
+    EXPECT_EQ(nullptr, cache.get("aborted"));
+}
+
+/**
+ * Verify that a caching decoder passes on audio too long to keep, without keeping it.
+ */
+TEST(DecodedAudioCacheTest, test_cachingDecoderSkipsTooLongAudio) {
+    DecodedAudioCache cache(2 * DecodedAudioCache::MAX_ENTRY_BYTES);
+    auto audio = makeAudio(DecodedAudioCache::MAX_ENTRY_BYTES + FRAME_SIZE);
+
+    CachingDecoder decoder(std::make_shared<FakeDecoder>(audio, false), "long", cache);
+    std::vector<Byte> played;
+    EXPECT_EQ(Status::DONE, readAll(decoder, &played));
+    EXPECT_EQ(*audio, played);
+    EXPECT_EQ(nullptr, cache.get("long"));
+    EXPECT_EQ(0u, cache.getBytes());
+}
+
+}  // namespace test
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <time.h>
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <Utils/Attachment/InProcessAttachment.h>
+#include <Utils/AudioFormat.h>
+
+#include "AudioMediaPlayer/FFmpegAttachmentInputController.h"
+#include "AudioMediaPlayer/FFmpegDecoder.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+namespace test {
+
+using namespace utils::attachment;
+
+/// The format TTS audio arrives in.
+static const utils::AudioFormat TTS_FORMAT{utils::AudioFormat::Encoding::LPCM,
+                                           utils::AudioFormat::Endianness::LITTLE,
+                                           16000,
+                                           16,
+                                           1,
+                                           true,
+                                           utils::AudioFormat::Layout::INTERLEAVED};
+
+/// Bytes per millisecond of @c TTS_FORMAT.
+static const size_t BYTES_PER_MS = 16000 * sizeof(int16_t) / 1000;
+
+/// Bytes per millisecond of the decoder's output, 48 kHz stereo 16 bit.
+static const size_t OUTPUT_BYTES_PER_MS = 48000 * 2 * sizeof(int16_t) / 1000;
+
+/// How long the writer stalls, as the network does in the middle of a TTS stream.
+static const std::chrono::milliseconds STALL_DURATION{1000};
+
+/// The size of the buffer @c AOWrapper reads from the decoder.
+static const size_t READ_BYTES = 16384;
+
+/**
+ * @return The CPU time the calling thread has used.
+ */
+static std::chrono::microseconds threadCpuTime() {
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return std::chrono::microseconds(static_cast<int64_t>(time.tv_sec) * 1000000 + time.tv_nsec / 1000);
+}
+
+/**
+ * Writes @c duration of silence in small chunks, a chunk every @c chunkInterval.
+ */
+static void writeSlowly(
+    AttachmentWriter* writer,
+    std::chrono::milliseconds duration,
+    std::chrono::milliseconds chunkInterval) {
+    std::vector<uint8_t> chunk(chunkInterval.count() * BYTES_PER_MS);
+    for (auto written = std::chrono::milliseconds::zero(); written < duration; written += chunkInterval) {
+        AttachmentWriter::WriteStatus status;
+        writer->write(chunk.data(), chunk.size(), &status);
+        std::this_thread::sleep_for(chunkInterval);
+    }
+}
+
+class FFmpegAttachmentInputControllerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_attachment = std::make_shared<InProcessAttachment>("tts");
+        m_writer = m_attachment->createWriter();
+        ASSERT_TRUE(m_writer);
+        std::shared_ptr<AttachmentReader> reader =
+            m_attachment->createReader(utils::sharedbuffer::ReaderPolicy::BLOCKING);
+        ASSERT_TRUE(reader);
+        m_decoder = FFmpegDecoder::create(
+            FFmpegAttachmentInputController::create(reader, &TTS_FORMAT), PlaybackConfiguration());
+        ASSERT_TRUE(m_decoder);
+    }
+
+    void TearDown() override {
+        if (m_writerThread.joinable()) {
+            m_writerThread.join();
+        }
+    }
+
+    /**
+     * Reads the decoder until it is done or fails.
+     *
+     * @return The status of the last read, with the number of bytes decoded in all.
+     */
+    std::pair<DecoderInterface::Status, size_t> readToTheEnd() {
+        std::vector<FFmpegDecoder::Byte> buffer(READ_BYTES);
+        size_t total = 0;
+        while (true) {
+            auto result = m_decoder->read(buffer.data(), buffer.size());
+            total += result.second;
+            if (DecoderInterface::Status::OK != result.first) {
+                return {result.first, total};
+            }
+        }
+    }
+
+    std::shared_ptr<InProcessAttachment> m_attachment;
+    std::unique_ptr<AttachmentWriter> m_writer;
+    std::unique_ptr<FFmpegDecoder> m_decoder;
+    std::thread m_writerThread;
+};
+
+/**
+ * Verify a read waiting on a stalled writer sleeps instead of spinning: decoding a stream with a one second gap in it
+ * uses a small fraction of that second of CPU, and all the audio comes out.
+ */
+TEST_F(FFmpegAttachmentInputControllerTest, test_starvedReadDoesNotSpin) {
+    m_writerThread = std::thread([this] {
+        writeSlowly(m_writer.get(), std::chrono::milliseconds(200), std::chrono::milliseconds(20));
+        std::this_thread::sleep_for(STALL_DURATION);
+        writeSlowly(m_writer.get(), std::chrono::milliseconds(200), std::chrono::milliseconds(20));
+        m_writer->close();
+    });
+
+    auto cpuStart = threadCpuTime();
+    auto wallStart = std::chrono::steady_clock::now();
+    auto result = readToTheEnd();
+    auto cpu = threadCpuTime() - cpuStart;
+    auto wall = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wallStart);
+    std::cout << "decoding thread: " << cpu.count() << " us of CPU in " << wall.count() << " ms" << std::endl;
+
+    EXPECT_EQ(DecoderInterface::Status::DONE, result.first);
+    EXPECT_NEAR(400 * OUTPUT_BYTES_PER_MS, result.second, 10 * OUTPUT_BYTES_PER_MS);
+    EXPECT_GE(wall, STALL_DURATION);
+    EXPECT_LT(cpu, std::chrono::microseconds(100000));
+}
+
+/**
+ * Verify stopping the decoder while its read waits on a stalled writer ends the read within a wait slice or so,
+ * rather than after the writer has been given up on.
+ */
+TEST_F(FFmpegAttachmentInputControllerTest, test_abortDuringStarvedRead) {
+    m_writerThread = std::thread([this] {
+        writeSlowly(m_writer.get(), std::chrono::milliseconds(100), std::chrono::milliseconds(20));
+        std::this_thread::sleep_for(FFmpegAttachmentInputController::MAX_STARVATION);
+        m_writer->close();
+    });
+
+    auto reading = std::async(std::launch::async, [this] { return readToTheEnd(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    auto abortTime = std::chrono::steady_clock::now();
+    m_decoder->abort();
+    ASSERT_EQ(std::future_status::ready, reading.wait_for(FFmpegAttachmentInputController::READ_WAIT_SLICE * 3));
+    auto latency = std::chrono::steady_clock::now() - abortTime;
+    std::cout << "abort latency: " << std::chrono::duration_cast<std::chrono::milliseconds>(latency).count() << " ms"
+              << std::endl;
+    EXPECT_EQ(DecoderInterface::Status::ERROR, reading.get().first);
+}
+
+/**
+ * Verify the buffer size can be chosen, and must be positive.
+ */
+TEST_F(FFmpegAttachmentInputControllerTest, test_bufferSize) {
+    std::shared_ptr<AttachmentReader> reader = m_attachment->createReader(utils::sharedbuffer::ReaderPolicy::BLOCKING);
+    EXPECT_FALSE(FFmpegAttachmentInputController::create(reader, &TTS_FORMAT, 0));
+
+    m_decoder = FFmpegDecoder::create(
+        FFmpegAttachmentInputController::create(reader, &TTS_FORMAT, 512), PlaybackConfiguration());
+    ASSERT_TRUE(m_decoder);
+    m_writerThread = std::thread([this] {
+        writeSlowly(m_writer.get(), std::chrono::milliseconds(100), std::chrono::milliseconds(10));
+        m_writer->close();
+    });
+    auto result = readToTheEnd();
+    EXPECT_EQ(DecoderInterface::Status::DONE, result.first);
+    EXPECT_NEAR(100 * OUTPUT_BYTES_PER_MS, result.second, 10 * OUTPUT_BYTES_PER_MS);
+}
+
+}  // namespace test
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "AudioMediaPlayer/FFmpegDecoder.h"
+#include "AudioMediaPlayer/FFmpegUrlInputController.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+namespace test {
+
+/// The rate of the player's default output, which the ramp fixture is written in so it isn't resampled.
+static const int SAMPLE_RATE = 48000;
+
+/// Stereo.
+static const int CHANNELS = 2;
+
+/// The length of the ramp fixture.
+static const std::chrono::milliseconds RAMP_DURATION{3000};
+
+/// The fixture of a real prompt, 22.05 kHz stereo, which is resampled.
+static const std::string DING_FILE = std::string(FIXTURE_DIR) + "/ding.wav";
+
+/// The size of the buffer @c AOWrapper reads from the decoder.
+static const size_t READ_BYTES = 16384;
+
+/**
+ * Writes a WAV file in which every frame holds its own index: the left sample the low 15 bits, the right sample the
+ * rest.  Where decoding starts then tells exactly where a seek landed.
+ *
+ * @param path Where to write the file.
+ * @param duration The length of the audio.
+ * @return @c true if the file was written.
+ */
+static bool writeRampWav(const std::string& path, std::chrono::milliseconds duration) {
+    const uint32_t frames = SAMPLE_RATE * duration.count() / 1000;
+    const uint32_t dataSize = frames * CHANNELS * sizeof(int16_t);
+    const uint32_t riffSize = 36 + dataSize;
+    const uint32_t fmtSize = 16;
+    const uint16_t pcm = 1;
+    const uint16_t channels = CHANNELS;
+    const uint32_t sampleRate = SAMPLE_RATE;
+    const uint32_t byteRate = SAMPLE_RATE * CHANNELS * sizeof(int16_t);
+    const uint16_t blockAlign = CHANNELS * sizeof(int16_t);
+    const uint16_t bits = 16;
+
+    std::string wav;
+    auto append = [&wav](const void* data, size_t size) { wav.append(static_cast<const char*>(data), size); };
+    append("RIFF", 4);
+    append(&riffSize, 4);
+    append("WAVEfmt ", 8);
+    append(&fmtSize, 4);
+    append(&pcm, 2);
+    append(&channels, 2);
+    append(&sampleRate, 4);
+    append(&byteRate, 4);
+    append(&blockAlign, 2);
+    append(&bits, 2);
+    append("data", 4);
+    append(&dataSize, 4);
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        const int16_t samples[CHANNELS] = {static_cast<int16_t>(frame & 0x7fff), static_cast<int16_t>(frame >> 15)};
+        append(samples, sizeof samples);
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(wav.data(), wav.size());
+    return file.good();
+}
+
+/**
+ * Opens a file at an offset and decodes it.
+ *
+ * @param path The file.
+ * @param offset Where to start.
+ * @param maxFrames Stop after this many frames.
+ * @return The interleaved samples decoded, empty if decoding failed.
+ */
+static std::vector<int16_t> decode(const std::string& path, std::chrono::milliseconds offset, size_t maxFrames) {
+    std::vector<int16_t> samples;
+    auto decoder = FFmpegDecoder::create(FFmpegUrlInputController::create(path, offset), PlaybackConfiguration());
+    if (!decoder) {
+        return samples;
+    }
+    std::vector<FFmpegDecoder::Byte> buffer(READ_BYTES);
+    while (samples.size() < maxFrames * CHANNELS) {
+        auto result = decoder->read(buffer.data(), buffer.size());
+        if (DecoderInterface::Status::ERROR == result.first) {
+            return std::vector<int16_t>();
+        }
+        auto data = reinterpret_cast<const int16_t*>(buffer.data());
+        samples.insert(samples.end(), data, data + result.second / sizeof(int16_t));
+        if (DecoderInterface::Status::DONE == result.first) {
+            break;
+        }
+    }
+    return samples;
+}
+
+class FFmpegDecoderSeekTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        char path[] = "/tmp/FFmpegDecoderSeekTestXXXXXX";
+        int fd = mkstemp(path);
+        ASSERT_GE(fd, 0);
+        close(fd);
+        m_rampFile = path;
+        ASSERT_TRUE(writeRampWav(m_rampFile, RAMP_DURATION));
+    }
+
+    void TearDown() override {
+        unlink(m_rampFile.c_str());
+    }
+
+    std::string m_rampFile;
+};
+
+/**
+ * Verify decoding from an offset starts at the very frame of that millisecond, not at the second before it.
+ */
+TEST_F(FFmpegDecoderSeekTest, test_seekLandsOnTheFrame) {
+    for (int offset : {1, 250, 999, 1234, 2999}) {
+        auto samples = decode(m_rampFile, std::chrono::milliseconds(offset), 1);
+        ASSERT_GE(samples.size(), static_cast<size_t>(CHANNELS)) << "offset " << offset;
+        const int frame = samples[0] | (samples[1] << 15);
+        EXPECT_EQ(offset * SAMPLE_RATE / 1000, frame) << "offset " << offset;
+    }
+}
+
+/**
+ * Verify what follows the first frame is contiguous, so nothing was dropped or repeated around the seek.
+ */
+TEST_F(FFmpegDecoderSeekTest, test_seekIsContiguous) {
+    const std::chrono::milliseconds offset{1500};
+    auto samples = decode(m_rampFile, offset, SAMPLE_RATE);
+    ASSERT_EQ(static_cast<size_t>(SAMPLE_RATE * CHANNELS), samples.size());
+    const int first = offset.count() * SAMPLE_RATE / 1000;
+    for (size_t i = 0; i < samples.size(); i += CHANNELS) {
+        ASSERT_EQ(first + static_cast<int>(i / CHANNELS), samples[i] | (samples[i + 1] << 15)) << "frame " << i;
+    }
+}
+
+/**
+ * Verify seeking a resampled prompt skips as much audio as was asked for, to within a millisecond.
+ */
+TEST_F(FFmpegDecoderSeekTest, test_seekResampledFixture) {
+    auto whole = decode(DING_FILE, std::chrono::milliseconds::zero(), SIZE_MAX);
+    ASSERT_FALSE(whole.empty());
+
+    for (int offset : {10, 100, 333}) {
+        auto rest = decode(DING_FILE, std::chrono::milliseconds(offset), SIZE_MAX);
+        ASSERT_FALSE(rest.empty()) << "offset " << offset;
+        const long skipped = static_cast<long>(whole.size() - rest.size()) / CHANNELS;
+        EXPECT_NEAR(offset * SAMPLE_RATE / 1000, skipped, SAMPLE_RATE / 1000) << "offset " << offset;
+    }
+}
+
+}  // namespace test
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "AudioMediaPlayer/StreamInfoCache.h"
+
+namespace aisdk {
+namespace mediaPlayer {
+namespace ffmpeg {
+namespace test {
+
+/// A codec id; the cache doesn't interpret it.
+static const int CODEC_ID = 86017;
+
+class StreamInfoCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        StreamInfoCache::instance().clear();
+    }
+
+    void TearDown() override {
+        StreamInfoCache::instance().clear();
+    }
+};
+
+/**
+ * Verify a stream put in the cache is found under its key with the same description.
+ */
+TEST_F(StreamInfoCacheTest, test_putThenGet) {
+    auto& cache = StreamInfoCache::instance();
+    cache.put("/cfg/ding.mp3@1:100", StreamDescription{CODEC_ID, 44100, 2});
+
+    StreamDescription description{0, 0, 0};
+    ASSERT_TRUE(cache.get("/cfg/ding.mp3@1:100", &description));
+    EXPECT_EQ(CODEC_ID, description.codecId);
+    EXPECT_EQ(44100, description.sampleRate);
+    EXPECT_EQ(2, description.channels);
+}
+
+/**
+ * Verify a key of the same file with another modification time misses, and an empty key is never stored.
+ */
+TEST_F(StreamInfoCacheTest, test_changedFileAndEmptyKeyMiss) {
+    auto& cache = StreamInfoCache::instance();
+    cache.put("/cfg/ding.mp3@1:100", StreamDescription{CODEC_ID, 44100, 2});
+    cache.put("", StreamDescription{CODEC_ID, 16000, 1});
+
+    StreamDescription description{0, 0, 0};
+    EXPECT_FALSE(cache.get("/cfg/ding.mp3@2:100", &description));
+    EXPECT_FALSE(cache.get("", &description));
+    EXPECT_EQ(0, description.codecId);
+}
+
+/**
+ * Verify the cache doesn't grow past its limit, and the entry which overflows it is kept.
+ */
+TEST_F(StreamInfoCacheTest, test_boundedSize) {
+    auto& cache = StreamInfoCache::instance();
+    for (size_t i = 0; i <= StreamInfoCache::MAX_ENTRIES; ++i) {
+        cache.put("file" + std::to_string(i), StreamDescription{CODEC_ID, 16000, 1});
+    }
+
+    StreamDescription description{0, 0, 0};
+    EXPECT_TRUE(cache.get("file" + std::to_string(StreamInfoCache::MAX_ENTRIES), &description));
+    EXPECT_FALSE(cache.get("file0", &description));
+}
+
+}  // namespace test
+}  // namespace ffmpeg
+}  // namespace mediaPlayer
+}  // namespace aisdk
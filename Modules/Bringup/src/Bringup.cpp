@@ -19,7 +19,6 @@
 
 /// String to identify log entries originating from this file.
 static const std::string TAG("Bringup");
-static auto in = std::make_shared<std::ifstream>();
 
 /// Define output
 #define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
@@ -33,6 +32,24 @@ static const std::string CHANNEL_NAME = utils::channel::AudioTrackManagerInterfa
 /// The name of the @c SafeShutdown
 static const std::string BRINGUP_NAME{"Bringup"};
 
+/// The prompts, decoded at startup so that they start at once and cost no decoding when played.
+static const char* PROMPT_FILES[] = {
+    "/cfg/sai_config/restartconfig.mp3",
+    "/cfg/sai_config/startbind.mp3",
+    "/cfg/sai_config/bind_ok.mp3",
+    "/cfg/sai_config/gmjkstart.mp3",
+    "/cfg/sai_config/mic_close.mp3",
+    "/cfg/sai_config/mic_open.mp3",
+    "/cfg/sai_config/net_connecting.mp3",
+    "/cfg/sai_config/upgrade_start.mp3",
+    "/cfg/sai_config/default/default_1.mp3",
+    "/cfg/sai_config/alarmmusic.mp3",
+    "/cfg/pulse/pulse_connected.mp3",
+    "/cfg/pulse/press_set_start.mp3",
+    "/cfg/pulse/pulse_press.mp3",
+    "/cfg/pulse/pulse_stop_press20s.mp3",
+    "/cfg/pulse/pulse_music.mp3"};
+
 #define ALARM_REPEAT_TIME_MAX 21
 int alarm_flag = 0;
 int alarmack_repeat_time = 0;
@@ -70,15 +87,16 @@ Bringup::~Bringup() { }
 
 void Bringup::inOpenFile(const char *filePath)
 {
-    in->open(filePath, std::ifstream::in);
-    if(!in->is_open())
+    // Play prompts by path rather than through a stream: the player then knows which file it is and opens it again
+    // without probing it.
+    if(access(filePath, R_OK) != 0)
     {
-        AISDK_ERROR(LX("onTrackChanged").d("reason", "notFileBeOpened"));
+        AISDK_ERROR(LX("onTrackChanged").d("reason", "notFileBeOpened").d("file", filePath));
         //return;
     }
     else
     {
-        m_currentSourceId = m_bringupPlayer->setSource(in, false);
+        m_currentSourceId = m_bringupPlayer->setSource(std::string(filePath), std::chrono::milliseconds::zero());
         AISDK_INFO(LX("onTrackChanged").d("m_currentSourceId", m_currentSourceId));
     }
 }
@@ -218,7 +236,6 @@ void Bringup::onPlaybackFinished(SourceId id) {
     // no-op
     AISDK_INFO(LX("onPlaybackFinished").d("GM SourceId", id));
     m_playFlag = PLAY_FINISHED_FLAG;
-    in->close();
     m_trackManager->releaseChannel(CHANNEL_NAME, shared_from_this());
 }
 
@@ -231,13 +248,11 @@ void Bringup::onPlaybackFinished(SourceId id) {
     if(alarm_flag == 1){
         m_executor.submit([this]() { executePlaybackFinished(); });
         alarmack_repeat_time ++;
-        in->close();
         if(alarmack_repeat_time == ALARM_REPEAT_TIME_MAX){
             alarm_flag = 0;
         }
     }else{
         alarmack_repeat_time = 0;
-        in->close();
         if(mute_need_trigger) {
 		for(auto observer : m_observers) {
 			if(observer)
@@ -264,7 +279,6 @@ void Bringup::executePlaybackFinished() {
 void Bringup::onPlaybackError(SourceId id, const utils::mediaPlayer::ErrorType& type, std::string error) {
     // no-op
     AISDK_INFO(LX("onPlaybackError").d("GM SourceId", id));
-    in->close();
     m_playFlag = PLAY_ERROR_FLAG; 
 
 }
@@ -272,7 +286,6 @@ void Bringup::onPlaybackError(SourceId id, const utils::mediaPlayer::ErrorType&
 void Bringup::onPlaybackStopped(SourceId id) {
     // no-op
     AISDK_INFO(LX("onPlaybackStopped").d("GM SourceId", id));
-    in->close();
     m_playFlag = PLAY_STOP_FLAG; 
     if(mute_need_trigger) {
 		for(auto observer : m_observers) {
@@ -322,6 +335,11 @@ const char* Bringup::CreateRandomUuid(char *uuid)
 
 void Bringup::init() {
     m_bringupPlayer->setObserver(shared_from_this());
+    for(auto path : PROMPT_FILES) {
+        if(access(path, R_OK) == 0 && !m_bringupPlayer->preloadSource(path)) {
+            AISDK_INFO(LX("init").d("reason", "promptNotPreloaded").d("file", path));
+        }
+    }
 }
 
 
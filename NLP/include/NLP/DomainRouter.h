@@ -28,7 +28,11 @@ namespace aisdk {
 namespace nlp {
 
 /**
- *  Class for sequencing and handling a stream of @c NLPDomain instances.
+ * Class for routing @c NLPDomain instances to the @c DomainHandlerInterface registered for their domain.
+ *
+ * Handlers are registered at startup, then @c freeze() makes the routing immutable.  From then on a lookup is a
+ * single hash table find with no lock taken, and in any case the handler itself is always called without holding
+ * the router's lock, so a slow handler never holds up the routing of other domains.
  */
 class DomainRouter
 	: public utils::SafeShutdown {
@@ -57,6 +61,14 @@ public:
      */
 	bool removeDomainHandler(std::shared_ptr<dmInterface::DomainHandlerInterface> handler);
 
+    /**
+     * Make the current mappings final.  Handlers can be neither added nor removed afterwards, and lookups no
+     * longer lock.
+     *
+     * @return Whether the mappings were frozen.
+     */
+	bool freeze();
+
     /**
      * Invoke @c preHandleDomain() on the handler registered for the given @c NLPDomain.
      *
@@ -91,13 +103,21 @@ private:
 	void doShutdown() override;
 
     /**
-     * Look up the @c Handler value for the specified @c NLPDomain.
+     * Look up the @c Handler value for the specified @c NLPDomain, locking only if the mappings are not frozen yet.
      *
      * @param domain The domain directive to look up a value for.
      * @return The corresponding @c Handler value for the specified domain directive.
      */
-	std::shared_ptr<dmInterface::DomainHandlerInterface> getDomainHandlerLocked(
-	std::shared_ptr<NLPDomain> domain);
+	std::shared_ptr<dmInterface::DomainHandlerInterface> getDomainHandler(std::shared_ptr<NLPDomain> domain);
+
+    /**
+     * Look up the @c Handler value for the specified @c NLPDomain.  This function should be called while holding
+     * m_mutex, or once the mappings are frozen.
+     *
+     * @param domain The domain directive to look up a value for.
+     * @return The corresponding @c Handler value for the specified domain directive.
+     */
+	std::shared_ptr<dmInterface::DomainHandlerInterface> findDomainHandler(std::shared_ptr<NLPDomain> domain);
 
 	/**
      * Remove the specified mappings from the name of the @c DomainHandlerInterface's values, gotten through the
@@ -109,11 +129,17 @@ private:
      */
     bool removeDomainHandlerLocked(std::shared_ptr<dmInterface::DomainHandlerInterface> handler);
 		
-    /// Mutex to protect message Id to @c DomainDirectiveAndResultInterface mapping.
+    /// Mutex to serialize changes to @c m_configuration, and lookups before it is frozen.
     std::mutex m_mutex;
 
-	/// Mapping from @c HandlerName to @c Handler.
+	/// Mapping from @c HandlerName to @c Handler.  Never modified once @c m_isFrozen is set.
     std::unordered_map<std::string, std::shared_ptr<dmInterface::DomainHandlerInterface>> m_configuration;
+
+	/// Whether @c m_configuration is final.
+	std::atomic<bool> m_isFrozen;
+
+	/// Whether routing has stopped for shutdown.
+	std::atomic<bool> m_isStopped;
 };
 
 }  // namespace nlp
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __NLP_DOMAIN_ROUTING_TABLE_H_
+#define __NLP_DOMAIN_ROUTING_TABLE_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aisdk {
+namespace nlp {
+
+/**
+ * Maps the domain (service) of an NLP message, e.g. "music", to the name of the @c DomainHandlerInterface which
+ * handles it, e.g. "ResourcesPlayer".  A table is assembled with a @c Builder at startup and cannot be changed
+ * afterwards, so it can be looked up from any thread without locking.
+ */
+class DomainRoutingTable {
+public:
+    /**
+     * Collects routes and aliases for a new @c DomainRoutingTable.
+     */
+    class Builder {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param defaultHandler The handler for domains with no route.
+         */
+        explicit Builder(const std::string& defaultHandler);
+
+        /**
+         * Routes domains to a handler.
+         *
+         * @param handler The name of the handler.
+         * @param domains The domains it handles.
+         * @return @c true if the routes were added, or @c false if any domain already had a route, in which case
+         * none of them were added.
+         */
+        bool addRoute(const std::string& handler, const std::vector<std::string>& domains);
+
+        /**
+         * Makes an alternative spelling of a domain route the same way.
+         *
+         * @param alias The alternative spelling.
+         * @param domain A domain which already has a route.
+         * @return @c true if the alias was added, or @c false if @c domain has no route or @c alias already has one.
+         */
+        bool addAlias(const std::string& alias, const std::string& domain);
+
+        /**
+         * Creates the table.  The builder may be used again afterwards.
+         *
+         * @return The new table.
+         */
+        std::shared_ptr<const DomainRoutingTable> build() const;
+
+    private:
+        /// The handler for domains with no route.
+        const std::string m_defaultHandler;
+
+        /// The routes collected so far.
+        std::unordered_map<std::string, std::string> m_routes;
+    };
+
+    /**
+     * Returns a @c Builder holding the routes of the domains the bundled handlers understand, so that an
+     * application can add its own before building.
+     *
+     * @return The builder.
+     */
+    static Builder defaultRoutes();
+
+    /**
+     * Returns the table built from @c defaultRoutes().
+     *
+     * @return The shared default table.
+     */
+    static std::shared_ptr<const DomainRoutingTable> getDefault();
+
+    /**
+     * Looks up the handler for a domain.
+     *
+     * @param domain The domain of an NLP message.
+     * @return The name of the handler, which is the default handler if @c domain has no route.
+     */
+    const std::string& lookup(const std::string& domain) const;
+
+    /**
+     * Returns the handler for domains with no route.
+     *
+     * @return The name of the default handler.
+     */
+    const std::string& getDefaultHandler() const;
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param defaultHandler The handler for domains with no route.
+     * @param routes The routes, aliases included.
+     */
+    DomainRoutingTable(const std::string& defaultHandler, const std::unordered_map<std::string, std::string>& routes);
+
+    /// The handler for domains with no route.
+    const std::string m_defaultHandler;
+
+    /// Domain, or alias, to handler name.
+    const std::unordered_map<std::string, std::string> m_routes;
+};
+
+}  // namespace nlp
+}  // namespace aisdk
+
+#endif  // __NLP_DOMAIN_ROUTING_TABLE_H_
@@ -50,6 +50,8 @@ public:
 
     bool removeDomainHandler(std::shared_ptr<dmInterface::DomainHandlerInterface> handler) override;
 
+	bool freezeDomainHandlers() override;
+
 	bool onDomain(std::shared_ptr<nlp::NLPDomain> domain) override;
 	/// @}
 	
@@ -18,6 +18,8 @@
 #include <DMInterface/DomainSequencerInterface.h>
 #include <DMInterface/MessageObserverInterface.h>
 
+#include "DomainRoutingTable.h"
+
 namespace aisdk {
 namespace nlp {
 
@@ -33,12 +35,18 @@ public:
      * @param domainSequencerInterface The DomainSequencerInterface implementation, which will receive
      *        @c NLPDirectives.
      * @param attachmentDocker The @c AttachmentManager which created @c NLPDomain will use to acquire Attachments.
+     * @param routingTable The table mapping message domains to handler names.
      */
     MessageInterpreter(
         std::shared_ptr<dmInterface::DomainSequencerInterface> domainSequencer,
-        std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker);
+        std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker,
+        std::shared_ptr<const DomainRoutingTable> routingTable = DomainRoutingTable::getDefault());
 
+    /// @name MessageObserverInterface methods.
+    /// @{
     void receive(const std::string& contextId, const std::string& message) override;
+    void receive(const std::string& contextId, std::shared_ptr<const NLPDocument> message) override;
+    /// @}
 
 private:
     /// Object to which we will send @c NLPDirectives.
@@ -46,6 +54,9 @@ private:
 
 	/// The attachmentManager.
 	std::shared_ptr<utils::attachment::AttachmentManagerInterface> m_attachmentDocker;
+
+	/// The table mapping message domains to handler names.
+	std::shared_ptr<const DomainRoutingTable> m_routingTable;
 };
 
 }  // namespace nlp
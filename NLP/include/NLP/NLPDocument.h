@@ -0,0 +1,103 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#ifndef __NLP_DOCUMENT_H_
+#define __NLP_DOCUMENT_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+
+// jsoncpp ver-1.8.3
+#include <json/json.h>
+
+namespace aisdk {
+namespace nlp {
+
+/**
+ * An NLP/sai_sdk message parsed once into a JSON tree.  A document is immutable once created and is shared by
+ * @c std::shared_ptr between the ASR engine which received it, the @c MessageInterpreter, the @c DomainSequencer
+ * and the domain handlers, so none of them has to parse (or print and parse again) the same text.
+ */
+class NLPDocument {
+public:
+    /**
+     * Parses a message.
+     *
+     * @param unparsed The message in JSON string representation.
+     * @return The document, or @c nullptr if @c unparsed is not a JSON object.
+     */
+    static std::shared_ptr<const NLPDocument> create(const std::string& unparsed);
+
+    /**
+     * Wraps an already parsed message.  The string representation is only produced if somebody asks for it.
+     *
+     * @param root The JSON tree of the message.
+     * @return The document, or @c nullptr if @c root is not a JSON object.
+     */
+    static std::shared_ptr<const NLPDocument> createFromTree(Json::Value root);
+
+    /**
+     * Returns a copy of this document with the "domain" member replaced, without going through the string
+     * representation.
+     *
+     * @param domain The new domain.
+     * @return The new document.
+     */
+    std::shared_ptr<const NLPDocument> withDomain(const std::string& domain) const;
+
+    /**
+     * Returns the whole JSON tree.
+     *
+     * @return The root object.
+     */
+    const Json::Value& getRoot() const;
+
+    /**
+     * Returns a top level member.
+     *
+     * @param key The name of the member.
+     * @return The member, or a null value if there is no such member.
+     */
+    const Json::Value& getMember(const std::string& key) const;
+
+    /**
+     * Returns the message in string representation.  This is the text the document was parsed from, or the
+     * serialized tree for documents created from a tree.
+     *
+     * @return The message in JSON string representation.
+     */
+    const std::string& getUnparsed() const;
+
+private:
+    /**
+     * Constructor.
+     *
+     * @param root The JSON tree of the message.
+     * @param unparsed The text @c root was parsed from, or empty to serialize @c root on demand.
+     */
+    NLPDocument(Json::Value root, const std::string& unparsed);
+
+    /// The JSON tree of the message.
+    const Json::Value m_root;
+
+    /// Guards the one-time serialization of @c m_root into @c m_unparsed.
+    mutable std::once_flag m_unparsedFlag;
+
+    /// The message in string representation.
+    mutable std::string m_unparsed;
+};
+
+}  // namespace nlp
+}  // namespace aisdk
+
+#endif  // __NLP_DOCUMENT_H_
@@ -17,6 +17,7 @@
 #include <string>
 
 #include <Utils/Attachment/AttachmentManagerInterface.h>
+#include "DomainRoutingTable.h"
 #include "NLPMessage.h"
 
 namespace aisdk {
@@ -53,7 +54,10 @@ public:
         ERROR_MISSING_QUERY_KEY,
 
         /// The parse failed due to the message data key being missing.
-        ERROR_MISSING_DATA_KEY
+        ERROR_MISSING_DATA_KEY,
+
+        /// The message could not be handled because a dependency passed in was missing.
+        ERROR_INTERNAL
     };
 		
 	/**
@@ -62,11 +66,26 @@ public:
 	 * @param unparsedDomain The unparsed NLP Domain Directive JSON string.
 	 * @param messageId The id consistent with the current session.
 	 * @param attachmentDocker The @c AttachmentManaer object which created @c NLPDomain will use to acquire Attachment.
+	 * The domain is routed with @c DomainRoutingTable::getDefault().
 	 */
 	static std::pair<std::unique_ptr<NLPDomain>, ParseStatus> create(
 		const std::string &unparsedDomain,
 		const std::string &messageId,
 		std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker);
+
+	/**
+	 * Create a NLP Domain directive from a message which has already been parsed.
+	 *
+	 * @param document The parsed NLP Domain Directive, which the directive keeps a reference to.
+	 * @param messageId The id consistent with the current session.
+	 * @param attachmentDocker The @c AttachmentManaer object which created @c NLPDomain will use to acquire Attachment.
+	 * @param routingTable The table mapping the domain of the message to the name of its handler.
+	 */
+	static std::pair<std::unique_ptr<NLPDomain>, ParseStatus> create(
+		std::shared_ptr<const NLPDocument> document,
+		const std::string &messageId,
+		std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker,
+		std::shared_ptr<const DomainRoutingTable> routingTable);
 	
     /**
      * Returns the underlying unparsed domain directive.
@@ -89,29 +108,24 @@ private:
      * Constructor.
      *
      * @param attachmentDocker The @c AttachmentManaer object which created @c NLPDomain will use to acquire Attachment.
-     * @param unparsedDomain The unparsed NLP Domain directive from JSON string.
+     * @param document The parsed NLP Domain directive.
      * @param code The code associated with NLP message.
      * @param message The message associated with NLP message.
      * @param query The query associated with NLP message.
      * @param domain The domain associated with NLP message.
-     * @param data The data associated with an NLP message. This is expected to be in the JSON format.
      * @param messageId The message associated with NLP message.
      */
     NLPDomain(
     	std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker,
-    	const std::string &unparsedDomain,
+    	std::shared_ptr<const NLPDocument> document,
     	const int code,
     	const std::string &message,
 		const std::string &query,
 		const std::string &domain,
-		const std::string &data,
     	const std::string &messageId);
 
 	/// The @c AttachmentManager objects.
 	std::shared_ptr<utils::attachment::AttachmentManagerInterface> m_attachmentDocker;
-		
-	/// The unparsed NLP domain directive from JSON string. 
-	const std::string m_unparsedDomain;
 
 	/// The msgId(dialog id from saisdk) of a NLP message.
 	const std::string m_messageId;
@@ -141,6 +155,8 @@ inline std::string nlpDomainParseStatusToString(NLPDomain::ParseStatus status) {
 			return "ERROR_MISSING_QUERY_KEY";
 		case NLPDomain::ParseStatus::ERROR_MISSING_DATA_KEY:
 			return "ERROR_MISSING_DATA_KEY";
+		case NLPDomain::ParseStatus::ERROR_INTERNAL:
+			return "ERROR_INTERNAL";
 	}
 	
 	return "UNKNOWN_STATUS";
@@ -14,8 +14,11 @@
 #define __NLP_MESSAGE_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 
+#include "NLPDocument.h"
+
 namespace aisdk {
 namespace nlp {
 
@@ -32,7 +35,7 @@ public:
      * @param message The message associated with NLP message.
      * @param query The query associated with NLP message.
      * @param domain The domain associated with NLP message.
-     * @param data The data associated with an NLP message. This is expected to be in the JSON format.
+     * @param document The parsed message, whose "data" member is the data associated with the NLP message.
      * @param messageId A unique ID used to identify a specific message. if NLP not support it,
      * 		The device must randomly generate a UUID as the messageId
      */
@@ -41,13 +44,13 @@ public:
     	const std::string &message,
 		const std::string &query,
 		const std::string &domain,
-		const std::string &data,
+		std::shared_ptr<const NLPDocument> document,
 		const std::string &messageId):
 		m_code{code},
 		m_message{message},
 		m_query{query},
 		m_domain{domain},
-	    m_data{data},
+	    m_document{document},
 	    m_messageId{messageId} {
 	    
 	}
@@ -92,12 +95,27 @@ public:
     std::string getMessageId() const;
 
     /**
-     * Returns the data (msg) of the message.
+     * Returns the data (msg) of the message in string representation.  The data is only printed the first
+     * time this is called; prefer @c getDataValue() which needs no parsing at all.
      *
      * @return The data.
      */
     std::string getData() const;
 
+    /**
+     * Returns the data (msg) of the message, as parsed when the message arrived.
+     *
+     * @return The data, or a null value if the message has none.
+     */
+    const Json::Value& getDataValue() const;
+
+    /**
+     * Returns the whole parsed message.
+     *
+     * @return The parsed message.
+     */
+    std::shared_ptr<const NLPDocument> getDocument() const;
+
     /**
      * Return a string representation of this @c Message's header.
      *
@@ -118,8 +136,14 @@ private:
 	/// The query of a NLP message.
 	const std::string m_domain;
 	
-    /// The data(msg) of a NLP message.
-    const std::string m_data;
+    /// The parsed NLP message, holding the data(msg).
+    const std::shared_ptr<const NLPDocument> m_document;
+
+    /// Guards the one-time printing of the data into @c m_data.
+    mutable std::once_flag m_dataFlag;
+
+    /// The data(msg) of a NLP message in string representation, printed on demand.
+    mutable std::string m_data;
 
 	/// The message ID, a unique ID used to identify a specific message
 	const std::string m_messageId;
@@ -9,6 +9,7 @@
  * express or implied. See the License for the specific language governing
  * permissions and limitations under the License.
  */
+#include <algorithm>
 #include <vector>
 #include <Utils/Logging/Logger.h>
 
@@ -22,14 +23,14 @@ static const std::string TAG("DomainRouter");
 namespace aisdk {
 namespace nlp {
 
-DomainRouter::DomainRouter() : utils::SafeShutdown{"DomainRouter"} {
+DomainRouter::DomainRouter() : utils::SafeShutdown{"DomainRouter"}, m_isFrozen{false}, m_isStopped{false} {
 
 }
 
 bool DomainRouter::addDomainHandler( std::shared_ptr<dmInterface::DomainHandlerInterface> handler) {
 	std::lock_guard<std::mutex> lock(m_mutex);
 
-	if(isShutdown()){
+	if(m_isStopped){
 		AISDK_ERROR(LX("addDomainHandlerFailed").d("reason", "isShutdown"));
 		return false;
 	}
@@ -39,6 +40,11 @@ bool DomainRouter::addDomainHandler( std::shared_ptr<dmInterface::DomainHandlerI
 		return false;
 	}
 
+	if(m_isFrozen) {
+		AISDK_ERROR(LX("addDomainHandlerFailed").d("reason", "routingFrozen").d("handler", handler.get()));
+		return false;
+	}
+
 	auto configure = handler->getHandlerName();
 	for(auto name : configure) {
 		auto it = m_configuration.find(name);
@@ -89,6 +95,11 @@ bool DomainRouter::removeDomainHandlerLocked(std::shared_ptr<dmInterface::Domain
 
 bool DomainRouter::removeDomainHandler( std::shared_ptr<dmInterface::DomainHandlerInterface> handler) {
 	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if(m_isFrozen) {
+		AISDK_ERROR(LX("removeDomainHandlerFailed").d("reason", "routingFrozen").d("handler", handler.get()));
+		return false;
+	}
 	
 	if(!removeDomainHandlerLocked(handler)) {
 		return false;
@@ -101,12 +112,39 @@ bool DomainRouter::removeDomainHandler( std::shared_ptr<dmInterface::DomainHandl
 	return true;
 }
 
-std::shared_ptr<dmInterface::DomainHandlerInterface> DomainRouter::getDomainHandlerLocked(
+bool DomainRouter::freeze() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if(m_isStopped){
+		AISDK_ERROR(LX("freezeFailed").d("reason", "isShutdown"));
+		return false;
+	}
+
+	// Publishes m_configuration to the lock-free readers in getDomainHandler().
+	m_isFrozen.store(true, std::memory_order_release);
+	AISDK_DEBUG(LX("freeze").d("handlers", m_configuration.size()));
+	return true;
+}
+
+std::shared_ptr<dmInterface::DomainHandlerInterface> DomainRouter::getDomainHandler(
+	std::shared_ptr<NLPDomain> domain) {
+	if(m_isFrozen.load(std::memory_order_acquire)) {
+		if(m_isStopped) {
+			AISDK_WARN(LX("getDomainHandlerFailed").d("reason", "isShutdown"));
+			return nullptr;
+		}
+		return findDomainHandler(domain);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return findDomainHandler(domain);
+}
+
+std::shared_ptr<dmInterface::DomainHandlerInterface> DomainRouter::findDomainHandler(
 	std::shared_ptr<NLPDomain> domain) {
 	auto name = domain->getDomain();
 	auto it = m_configuration.find(name);
 	if(it == m_configuration.end()) {
-		AISDK_WARN(LX("getDomainHandlerLockedFailed").d("domainName", name).d("reason", "noHandlerRegistered"));
+		AISDK_WARN(LX("findDomainHandlerFailed").d("domainName", name).d("reason", "noHandlerRegistered"));
 		return nullptr;
 	}
 
@@ -116,8 +154,7 @@ std::shared_ptr<dmInterface::DomainHandlerInterface> DomainRouter::getDomainHand
 bool DomainRouter::preHandleDomain(
 	std::shared_ptr<NLPDomain> domain,
 	std::unique_ptr<dmInterface::DomainHandlerResultInterface> result) {
-	std::unique_lock<std::mutex> lock(m_mutex);
-	auto handler = getDomainHandlerLocked(domain);
+	auto handler = getDomainHandler(domain);
 	if(!handler) {
 		return false;
 	}
@@ -128,8 +165,7 @@ bool DomainRouter::preHandleDomain(
 }
 
 bool DomainRouter::handleDomain(std::shared_ptr<NLPDomain> domain) {
-	std::unique_lock<std::mutex> lock(m_mutex);
-	auto handler = getDomainHandlerLocked(domain);
+	auto handler = getDomainHandler(domain);
 	if(!handler) 
 		return false;
 
@@ -145,8 +181,7 @@ bool DomainRouter::handleDomain(std::shared_ptr<NLPDomain> domain) {
 }
 
 bool DomainRouter::cancelDomain(std::shared_ptr<NLPDomain> domain) {
-	std::unique_lock <std::mutex> lock(m_mutex);
-	auto handler = getDomainHandlerLocked(domain);
+	auto handler = getDomainHandler(domain);
 	if(!handler)
 		return false;
 
@@ -158,6 +193,26 @@ bool DomainRouter::cancelDomain(std::shared_ptr<NLPDomain> domain) {
 void DomainRouter::doShutdown() {
 	std::vector<std::shared_ptr<dmInterface::DomainHandlerInterface>> releasedHandlers;
 	std::unique_lock<std::mutex> lock(m_mutex);
+	m_isStopped = true;
+
+	if(m_isFrozen) {
+		/*
+		 * Lock-free readers may still be looking at the frozen mappings, so they stay intact until the
+		 * router is destroyed; the handlers are only told they are deregistered.
+		 */
+		for(auto& entry : m_configuration) {
+			if(std::find(releasedHandlers.begin(), releasedHandlers.end(), entry.second) == releasedHandlers.end()) {
+				releasedHandlers.push_back(entry.second);
+			}
+		}
+		lock.unlock();
+
+		for (auto releasedHandler : releasedHandlers) {
+			AISDK_DEBUG5(LX("onDeregisteredCalled").d("handler", releasedHandler.get()));
+			releasedHandler->onDeregistered();
+		}
+		return;
+	}
 
 	// Should remove all configurations cleanly.
     size_t numConfigurations = m_configuration.size();
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <Utils/Logging/Logger.h>
+
+#include "NLP/DomainRoutingTable.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("DomainRoutingTable");
+/// Define output
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace nlp {
+
+DomainRoutingTable::Builder::Builder(const std::string& defaultHandler) : m_defaultHandler{defaultHandler} {
+}
+
+bool DomainRoutingTable::Builder::addRoute(const std::string& handler, const std::vector<std::string>& domains) {
+    for (auto& domain : domains) {
+        if (m_routes.count(domain)) {
+            AISDK_ERROR(LX("addRouteFailed").d("reason", "alreadyRouted").d("domain", domain).d("handler", handler));
+            return false;
+        }
+    }
+
+    for (auto& domain : domains) {
+        m_routes[domain] = handler;
+    }
+    return true;
+}
+
+bool DomainRoutingTable::Builder::addAlias(const std::string& alias, const std::string& domain) {
+    auto it = m_routes.find(domain);
+    if (it == m_routes.end()) {
+        AISDK_ERROR(LX("addAliasFailed").d("reason", "domainNotRouted").d("alias", alias).d("domain", domain));
+        return false;
+    }
+    if (m_routes.count(alias)) {
+        AISDK_ERROR(LX("addAliasFailed").d("reason", "alreadyRouted").d("alias", alias));
+        return false;
+    }
+
+    auto handler = it->second;
+    m_routes[alias] = handler;
+    return true;
+}
+
+std::shared_ptr<const DomainRoutingTable> DomainRoutingTable::Builder::build() const {
+    return std::shared_ptr<const DomainRoutingTable>(new DomainRoutingTable(m_defaultHandler, m_routes));
+}
+
+DomainRoutingTable::Builder DomainRoutingTable::defaultRoutes() {
+    Builder builder("SpeechSynthesizer");
+    // weather,time,huangli,cookbook,baike,calculator,poem,chat,stock,healthAI
+    builder.addRoute(
+        "SpeechSynthesizer",
+        {"chat", "time", "healthAI", "weather", "huangli", "baike", "calculator", "cookbook", "poem", "stock"});
+    // music,audio,listenBook,news,FM,story,joke
+    builder.addRoute(
+        "ResourcesPlayer", {"music", "audio", "IREADER", "listenBook", "news", "FM", "story", "joke"});
+    // alarm,schedule
+    builder.addRoute("AlarmsPlayer", {"alarm", "schedule"});
+    builder.addRoute("PlayControl", {"playcontrol"});
+    builder.addRoute("VolumeManager", {"volume"});
+    builder.addRoute("ExpectSpeech", {"ExpectSpeech"});
+    return builder;
+}
+
+std::shared_ptr<const DomainRoutingTable> DomainRoutingTable::getDefault() {
+    static const std::shared_ptr<const DomainRoutingTable> table = defaultRoutes().build();
+    return table;
+}
+
+DomainRoutingTable::DomainRoutingTable(
+    const std::string& defaultHandler,
+    const std::unordered_map<std::string, std::string>& routes) :
+        m_defaultHandler{defaultHandler},
+        m_routes{routes} {
+}
+
+const std::string& DomainRoutingTable::lookup(const std::string& domain) const {
+    auto it = m_routes.find(domain);
+    return it != m_routes.end() ? it->second : m_defaultHandler;
+}
+
+const std::string& DomainRoutingTable::getDefaultHandler() const {
+    return m_defaultHandler;
+}
+
+}  // namespace nlp
+}  // namespace aisdk
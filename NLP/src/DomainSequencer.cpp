@@ -42,6 +42,10 @@ bool DomainSequencer::removeDomainHandler(std::shared_ptr<dmInterface::DomainHan
 	return m_domainRouter.removeDomainHandler(handler);
 }
 
+bool DomainSequencer::freezeDomainHandlers() {
+	return m_domainRouter.freeze();
+}
+
 DomainSequencer::DomainSequencer()
 	: dmInterface::DomainSequencerInterface{"DomainSequencer"},
 	m_isShuttingDown{false},
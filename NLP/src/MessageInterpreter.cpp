@@ -23,14 +23,27 @@ namespace nlp {
 
 MessageInterpreter::MessageInterpreter(
 	std::shared_ptr<dmInterface::DomainSequencerInterface> domainSequencer,
-	std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker):
+	std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker,
+	std::shared_ptr<const DomainRoutingTable> routingTable):
 	m_domainSequencer{domainSequencer},
-	m_attachmentDocker{attachmentDocker} {
+	m_attachmentDocker{attachmentDocker},
+	m_routingTable{routingTable} {
 
 }
 
 void MessageInterpreter::receive(const std::string& contextId, const std::string& message) {
-    auto createResult = NLPDomain::create(message, contextId, m_attachmentDocker);
+    auto document = NLPDocument::create(message);
+    if (!document) {
+		AISDK_WARN(LX("receiveFailed").d("Unable to parse Directive - JSON error",
+			nlpDomainParseStatusToString(NLPDomain::ParseStatus::ERROR_INVALID_JSON)));
+        return;
+    }
+
+    receive(contextId, document);
+}
+
+void MessageInterpreter::receive(const std::string& contextId, std::shared_ptr<const NLPDocument> message) {
+    auto createResult = NLPDomain::create(message, contextId, m_attachmentDocker, m_routingTable);
     std::shared_ptr<NLPDomain> nlpDomain{std::move(createResult.first)};
     if (!nlpDomain) {
 		std::string descriptMsg = nlpDomainParseStatusToString(createResult.second);		
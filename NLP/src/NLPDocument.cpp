@@ -0,0 +1,86 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <Utils/Logging/Logger.h>
+
+#include "NLP/NLPDocument.h"
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("NLPDocument");
+/// Define output
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+namespace aisdk {
+namespace nlp {
+
+/// The key of the domain member.
+static const std::string DOMAIN_KEY = "domain";
+
+std::shared_ptr<const NLPDocument> NLPDocument::create(const std::string& unparsed) {
+    Json::CharReaderBuilder readerBuilder;
+    JSONCPP_STRING errs;
+    Json::Value root;
+    std::unique_ptr<Json::CharReader> const reader(readerBuilder.newCharReader());
+    if (!reader->parse(unparsed.c_str(), unparsed.c_str() + unparsed.length(), &root, &errs)) {
+        AISDK_ERROR(LX("createFailed").d("reason", "parseError").d("error", errs));
+        return nullptr;
+    }
+    if (!root.isObject()) {
+        AISDK_ERROR(LX("createFailed").d("reason", "notAnObject"));
+        return nullptr;
+    }
+
+    return std::shared_ptr<const NLPDocument>(new NLPDocument(std::move(root), unparsed));
+}
+
+std::shared_ptr<const NLPDocument> NLPDocument::createFromTree(Json::Value root) {
+    if (!root.isObject()) {
+        AISDK_ERROR(LX("createFailed").d("reason", "notAnObject"));
+        return nullptr;
+    }
+
+    return std::shared_ptr<const NLPDocument>(new NLPDocument(std::move(root), std::string()));
+}
+
+NLPDocument::NLPDocument(Json::Value root, const std::string& unparsed) : m_root(std::move(root)), m_unparsed{unparsed} {
+    if (!m_unparsed.empty()) {
+        // Already have the text; make sure getUnparsed() never prints over it.
+        std::call_once(m_unparsedFlag, [] {});
+    }
+}
+
+std::shared_ptr<const NLPDocument> NLPDocument::withDomain(const std::string& domain) const {
+    Json::Value root(m_root);
+    root[DOMAIN_KEY] = domain;
+    return createFromTree(std::move(root));
+}
+
+const Json::Value& NLPDocument::getRoot() const {
+    return m_root;
+}
+
+const Json::Value& NLPDocument::getMember(const std::string& key) const {
+    auto member = m_root.find(key.data(), key.data() + key.length());
+    return member ? *member : Json::Value::nullSingleton();
+}
+
+const std::string& NLPDocument::getUnparsed() const {
+    std::call_once(m_unparsedFlag, [this] {
+        Json::StreamWriterBuilder writerBuilder;
+        writerBuilder["indentation"] = "";
+        m_unparsed = Json::writeString(writerBuilder, m_root);
+    });
+    return m_unparsed;
+}
+
+}  // namespace nlp
+}  // namespace aisdk
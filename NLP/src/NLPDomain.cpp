@@ -9,13 +9,9 @@
  * express or implied. See the License for the specific language governing
  * permissions and limitations under the License.
  */
-// jsoncpp ver-1.8.3 
-#include <json/json.h>
 #include <Utils/Logging/Logger.h>
 
 #include "NLP/NLPDomain.h"
-#include <Utils/cJSON.h>
-#include "string.h"
 
 
 /// String to identify log entries originating from this file.
@@ -27,28 +23,47 @@ namespace aisdk {
 namespace nlp {
 
 
-struct NlpData
-{
-    int    NlpData_code;
-    char * NlpData_message;
-    char * NlpData_query;
-    std::string NlpData_domain;
-    char * NlpData_dataMsg;
-};
+/// The key of the code member.
+static const std::string CODE_KEY = "code";
 
-void GetNLPData(const char *datain , struct NlpData *nlpdata);
+/// The key of the message member.
+static const std::string MESSAGE_KEY = "message";
 
+/// The key of the query member.
+static const std::string QUERY_KEY = "query";
+
+/// The key of the domain member.
+static const std::string DOMAIN_KEY = "domain";
 
 std::pair<std::unique_ptr<NLPDomain>, NLPDomain::ParseStatus> NLPDomain::create(
 	const std::string &unparsedDomain,
 	const std::string &messageId,
 	std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker){
+	if(unparsedDomain.empty()){
+		AISDK_WARN(LX("createFailed").d("reason", "nlpDomainNull"));
+		return {nullptr, ParseStatus::ERROR_INVALID_JSON};
+	}
+
+	auto document = NLPDocument::create(unparsedDomain);
+	if(!document) {
+		AISDK_WARN(LX("createFailed").d("reason", "parseError"));
+		return {nullptr, ParseStatus::ERROR_INVALID_JSON};
+	}
+
+	return create(document, messageId, attachmentDocker, DomainRoutingTable::getDefault());
+}
+
+std::pair<std::unique_ptr<NLPDomain>, NLPDomain::ParseStatus> NLPDomain::create(
+	std::shared_ptr<const NLPDocument> document,
+	const std::string &messageId,
+	std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker,
+	std::shared_ptr<const DomainRoutingTable> routingTable){
     std::pair<std::unique_ptr<NLPDomain>, ParseStatus> result;
 	/// Default set the state as SUCCESS
     result.second = ParseStatus::SUCCESS;
 
-	if(unparsedDomain.empty()){
-		AISDK_WARN(LX("createFailed").d("reason", "nlpDomainNull"));
+	if(!document){
+		AISDK_WARN(LX("createFailed").d("reason", "nlpDocumentNull"));
 		result.second = ParseStatus::ERROR_INVALID_JSON;
 		return result;
 	}
@@ -61,160 +76,57 @@ std::pair<std::unique_ptr<NLPDomain>, NLPDomain::ParseStatus> NLPDomain::create(
 
 	if(!attachmentDocker) {
 		AISDK_ERROR(LX("createFailed").d("reason", "nullAttachmentManager"));
+		result.second = ParseStatus::ERROR_INTERNAL;
 		return result;
 	}
-	
-    struct NlpData outnlpdata;
-    cJSON* json = NULL;
-    GetNLPData(unparsedDomain.c_str(),&outnlpdata);
-	//AISDK_INFO(LX("Create").d("NlpData_dataMsg", outnlpdata.NlpData_dataMsg));   
- 
-    // To-Do to prase json key:value from the unparsedDomain    
-        int code = outnlpdata.NlpData_code;
-        std::string message = outnlpdata.NlpData_message;
-        std::string query = outnlpdata.NlpData_query;
-        std::string domain = outnlpdata.NlpData_domain;
-        //char *dataMsg = cJSON_Print(json_data);
-		std::string data;
-		if(outnlpdata.NlpData_dataMsg)
-        data = outnlpdata.NlpData_dataMsg;
-
-#if 1
+
+	if(!routingTable) {
+		AISDK_ERROR(LX("createFailed").d("reason", "nullRoutingTable"));
+		result.second = ParseStatus::ERROR_INTERNAL;
+		return result;
+	}
+
+	// Everything comes straight from the parsed tree; nothing is printed or parsed again.
+	auto& jsonDomain = document->getMember(DOMAIN_KEY);
+	if(!jsonDomain.isString()) {
+		AISDK_WARN(LX("createFailed").d("reason", "missingDomain"));
+		result.second = ParseStatus::ERROR_MISSING_DOMAIN_KEY;
+		return result;
+	}
+
+	auto& jsonCode = document->getMember(CODE_KEY);
+	auto& jsonMessage = document->getMember(MESSAGE_KEY);
+	auto& jsonQuery = document->getMember(QUERY_KEY);
+	int code = jsonCode.isInt() ? jsonCode.asInt() : 0;
+	std::string message = jsonMessage.isString() ? jsonMessage.asString() : std::string();
+	std::string query = jsonQuery.isString() ? jsonQuery.asString() : std::string();
+	std::string domain = routingTable->lookup(jsonDomain.asString());
+	AISDK_DEBUG5(LX("create").d("domain", domain));
+
 	result.first = std::unique_ptr<NLPDomain>(
-		new NLPDomain(attachmentDocker, unparsedDomain,
-		code, message, query, domain, data,
+		new NLPDomain(attachmentDocker, document,
+		code, message, query, domain,
 		messageId));
-#endif
-    cJSON_Delete(json);  //释放内存
 
 	return result;
 }
 
-//use for analysis nlp data @20190328
-void GetNLPData(const char * datain , struct NlpData *nlpdata)
-{ 
-   cJSON* json = NULL,*json_code = NULL, *json_message = NULL,
-    *json_query = NULL,*json_domain = NULL,*json_data = NULL;
-   
-   (void )json;
-   (void )json_code;
-   (void )json_message;
-   (void )json_query;
-   (void )json_domain;
-   (void )json_data;
-  
-   json = cJSON_Parse(datain);
-   if(!json)
-   {
-   AISDK_ERROR(LX("jsonError").d("json Error before:", cJSON_GetErrorPtr()));
-   }
-   else
-   {
-      json_code = cJSON_GetObjectItem(json, "code");
-      json_message = cJSON_GetObjectItem(json, "message");
-      json_query = cJSON_GetObjectItem(json, "query");
-      json_domain = cJSON_GetObjectItem(json, "domain");
-      json_data = cJSON_GetObjectItem(json, "data"); 
-   }
-
-   nlpdata->NlpData_code = json_code->valueint;
-   nlpdata->NlpData_message = json_message->valuestring;
-   nlpdata->NlpData_query = json_query->valuestring;
-   nlpdata->NlpData_dataMsg = cJSON_Print(json_data);
-
-    //Divide domain 
-    //weather,time,huangli,cookbook,baike,calculator,poem,
-    //chat,astrology,forex,stock,healthAI
-    if(strcmp(json_domain->valuestring, "chat")== 0 
-       || strcmp(json_domain->valuestring, "time")== 0
-       || strcmp(json_domain->valuestring, "healthAI")== 0
-       || strcmp(json_domain->valuestring, "weather")== 0
-       || strcmp(json_domain->valuestring, "huangli")== 0
-       || strcmp(json_domain->valuestring, "baike")== 0
-       || strcmp(json_domain->valuestring, "calculator")== 0
-       || strcmp(json_domain->valuestring, "cookbook")== 0
-       || strcmp(json_domain->valuestring, "poem")== 0
-       || strcmp(json_domain->valuestring, "stock")== 0)
-    {
-    nlpdata->NlpData_domain = "SpeechSynthesizer";
-    }
-
-    //music,audio,listenBook,news,FM,story,joke
-    else if(strcmp(json_domain->valuestring, "music")== 0 
-       ||strcmp(json_domain->valuestring, "audio")== 0
-       ||strcmp(json_domain->valuestring, "IREADER")== 0
-       ||strcmp(json_domain->valuestring, "listenBook")== 0
-       ||strcmp(json_domain->valuestring, "news")== 0
-       ||strcmp(json_domain->valuestring, "FM")== 0
-       ||strcmp(json_domain->valuestring, "story")== 0
-       ||strcmp(json_domain->valuestring, "joke")== 0)
-    {
-    nlpdata->NlpData_domain = "ResourcesPlayer";
-    }
-       
-    //alarm,schedule
-     else if(strcmp(json_domain->valuestring, "alarm")== 0 
-           ||strcmp(json_domain->valuestring, "schedule")== 0)
-       {
-       nlpdata->NlpData_domain = "AlarmsPlayer";
-       }      //playcontrol
-     else if(strcmp(json_domain->valuestring, "playcontrol")== 0)
-     {
-       nlpdata->NlpData_domain = "PlayControl";
-     }  
-     else if(strcmp(json_domain->valuestring, "volume")== 0)
-     {
-       nlpdata->NlpData_domain = "VolumeManager";
-       AISDK_INFO(LX("domain").d("domain", "VolumeManager"));
-     } 
-	 else if(strcmp(json_domain->valuestring, "ExpectSpeech")== 0) {
-		nlpdata->NlpData_domain = "ExpectSpeech";
-     }
-     else{
-        nlpdata->NlpData_domain = "SpeechSynthesizer";
-    }
-#if 0
-    //volume
-      else if(strcmp(json_domain->valuestring, "volume")== 0 
-           ||strcmp(json_domain->valuestring, "VOLUME")== 0)
-       {
-       nlpdata->NlpData_domain = "PlayControl";
-       AISDK_INFO(LX("domain").d("domain", "PlayControl"));
-       }
-
-    
-    //customization
-       if(strcmp(json_domain->valuestring, "customization")== 0 )
-       {
-       nlpdata->NlpData_domain = "CustomizationManger";
-       AISDK_INFO(LX("domain").d("domain", "CustomizationManger"));
-       }
-     #endif  
-
-       AISDK_DEBUG5(LX("GetNLPData").d("domain", nlpdata->NlpData_domain));
-   cJSON_Delete(json);  //释放内存
-}
-
-
-
 NLPDomain::NLPDomain(
 	std::shared_ptr<utils::attachment::AttachmentManagerInterface> attachmentDocker,
-	const std::string &unparsedDomain,
+	std::shared_ptr<const NLPDocument> document,
 	const int code,
 	const std::string &message,
 	const std::string &query,
 	const std::string &domain,
-	const std::string &data,
 	const std::string &messageId) : 
-	NLPMessage(code, message, query, domain, data, messageId), 
+	NLPMessage(code, message, query, domain, document, messageId), 
 	m_attachmentDocker{attachmentDocker},
-	m_unparsedDomain{unparsedDomain}, 
 	m_messageId{messageId} {
 
 }
 
 std::string NLPDomain::getUnparsedDomain() const {
-	return m_unparsedDomain;
+	return getDocument()->getUnparsed();
 }
 
 std::unique_ptr<utils::attachment::AttachmentReader>
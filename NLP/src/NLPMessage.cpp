@@ -35,9 +35,26 @@ std::string NLPMessage::getMessageId() const {
     return m_messageId;
 }
 
+/// The key of the data(msg) member.
+static const std::string DATA_KEY = "data";
+
 std::string NLPMessage::getData() const {
+    std::call_once(m_dataFlag, [this] {
+        auto& data = getDataValue();
+        if (!data.isNull()) {
+            m_data = data.toStyledString();
+        }
+    });
     return m_data;
 }
 
+const Json::Value& NLPMessage::getDataValue() const {
+    return m_document->getMember(DATA_KEY);
+}
+
+std::shared_ptr<const NLPDocument> NLPMessage::getDocument() const {
+    return m_document;
+}
+
 }  // namespace nlp
 }  // namespace aisdk
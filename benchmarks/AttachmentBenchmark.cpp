@@ -0,0 +1,108 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Utils/Attachment/InProcessAttachment.h>
+
+using namespace aisdk::utils::attachment;
+using aisdk::utils::sharedbuffer::ReaderPolicy;
+using aisdk::utils::sharedbuffer::WriterPolicy;
+
+/// The attachment id used by the benchmarks.
+static const std::string ATTACHMENT_ID("benchmark");
+
+/**
+ * Creates the @c SharedBuffer behind an attachment.
+ *
+ * @param nBytes The size of the data area, or 0 to let @c InProcessAttachment use its default.
+ * @return The @c SharedBuffer, or @c nullptr for the default.
+ */
+static std::unique_ptr<InProcessAttachment::SDSType> createSds(size_t nBytes) {
+    if (0 == nBytes) {
+        return nullptr;
+    }
+    auto buffer = std::make_shared<InProcessAttachment::SDSBufferType>(
+        InProcessAttachment::SDSType::calculateBufferSize(nBytes));
+    return InProcessAttachment::SDSType::create(buffer);
+}
+
+/**
+ * The whole life of an attachment as one utterance sees it: create it, attach a writer and a reader, push one chunk
+ * through, close and drain.
+ *
+ * Arguments: buffer size in bytes (0 for the @c InProcessAttachment default), bytes written.
+ */
+static void BM_AttachmentRoundTrip(benchmark::State& state) {
+    const size_t sdsBytes = state.range(0);
+    const size_t chunkBytes = state.range(1);
+    std::vector<uint8_t> source(chunkBytes, 0x5a);
+    std::vector<uint8_t> sink(chunkBytes);
+
+    for (auto _ : state) {
+        InProcessAttachment attachment(ATTACHMENT_ID, createSds(sdsBytes));
+        auto writer = attachment.createWriter(WriterPolicy::NONBLOCKABLE);
+        auto reader = attachment.createReader(ReaderPolicy::NONBLOCKING);
+
+        AttachmentWriter::WriteStatus writeStatus;
+        writer->write(source.data(), source.size(), &writeStatus);
+        writer->close();
+
+        AttachmentReader::ReadStatus readStatus = AttachmentReader::ReadStatus::OK;
+        size_t received = 0;
+        while (AttachmentReader::ReadStatus::OK == readStatus) {
+            received += reader->read(sink.data(), sink.size(), &readStatus);
+        }
+        if (received != chunkBytes) {
+            state.SkipWithError("attachment lost data");
+            break;
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * chunkBytes);
+}
+
+/**
+ * Steady-state streaming through one long-lived attachment, one write and one read per iteration.
+ *
+ * Arguments: bytes per call.
+ */
+static void BM_AttachmentStreaming(benchmark::State& state) {
+    const size_t chunkBytes = state.range(0);
+    std::vector<uint8_t> source(chunkBytes, 0x5a);
+    std::vector<uint8_t> sink(chunkBytes);
+
+    InProcessAttachment attachment(ATTACHMENT_ID, createSds(256 * 1024));
+    auto writer = attachment.createWriter(WriterPolicy::NONBLOCKABLE);
+    auto reader = attachment.createReader(ReaderPolicy::NONBLOCKING);
+
+    for (auto _ : state) {
+        AttachmentWriter::WriteStatus writeStatus;
+        AttachmentReader::ReadStatus readStatus;
+        writer->write(source.data(), source.size(), &writeStatus);
+        benchmark::DoNotOptimize(reader->read(sink.data(), sink.size(), &readStatus));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * chunkBytes);
+}
+
+BENCHMARK(BM_AttachmentRoundTrip)
+    ->ArgNames({"sdsBytes", "chunkBytes"})
+    ->ArgsProduct({{64 * 1024, 0}, {320, 32 * 1024}});
+
+BENCHMARK(BM_AttachmentStreaming)->ArgNames({"chunkBytes"})->Arg(320)->Arg(4096)->Arg(32 * 1024);
+
+BENCHMARK_MAIN();
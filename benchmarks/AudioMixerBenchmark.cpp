@@ -0,0 +1,66 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <AudioMediaPlayer/AudioMixer.h>
+#include <AudioMediaPlayer/FileSink.h>
+
+using namespace aisdk::mediaPlayer::ffmpeg;
+
+/// The size of the buffers @c AOWrapper writes, as it reads them from the decoder.
+static const size_t PLAYER_WRITE_BYTES = 16384;
+
+/// The audio each source plays per iteration: 2 s at 48 kHz stereo 16 bit.
+static const size_t BYTES_PER_SOURCE = 2 * 48000 * 2 * 2;
+
+/**
+ * Several players writing into one mixer at once, the mixer summing them onto a null sink.  The sink never blocks,
+ * so this is the mixer's throughput on this CPU; on the board the device paces it to real time.
+ */
+static void BM_MixSources(benchmark::State& state) {
+    auto sink = FileSink::createNull();
+    auto sinkPtr = sink.get();
+    auto mixer = AudioMixer::create(std::move(sink));
+    const auto numSources = static_cast<size_t>(state.range(0));
+    std::vector<std::shared_ptr<AudioSinkInterface>> sources;
+    for (size_t i = 0; i < numSources; ++i) {
+        sources.push_back(mixer->createSource());
+    }
+    std::vector<uint8_t> buffer(PLAYER_WRITE_BYTES, 0x11);
+
+    const size_t bytesOutBefore = sinkPtr->getBytesWritten();
+    for (auto _ : state) {
+        std::vector<std::thread> players;
+        for (auto& source : sources) {
+            players.emplace_back([&source, &buffer] {
+                for (size_t written = 0; written < BYTES_PER_SOURCE; written += buffer.size()) {
+                    source->write(buffer.data(), buffer.size());
+                }
+            });
+        }
+        for (auto& player : players) {
+            player.join();
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * numSources * BYTES_PER_SOURCE);
+    state.counters["periodsOut"] = benchmark::Counter(
+        static_cast<double>(sinkPtr->getBytesWritten() - bytesOutBefore) / mixer->getPeriodBytes(),
+        benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_MixSources)->ArgName("sources")->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Utils/Microphone/ChannelRemap.h>
+
+using aisdk::utils::microphone::ChannelRemap;
+
+/// The number of interleaved channels delivered by the microphone array.
+static const size_t MIC_CHANNELS = 8;
+
+/// The layout the SoundAi front end expects from the microphone array.
+static const std::vector<int> MIC_ARRAY_MAP =
+    {0, 2, 4, 7, ChannelRemap::SILENCE, ChannelRemap::SILENCE, ChannelRemap::SILENCE, ChannelRemap::SILENCE};
+
+/**
+ * The per-sample remap the capture callback used before the table-driven kernel, kept as the baseline.
+ */
+static void legacyRemap(const int16_t* input, int16_t* output, size_t nFrames) {
+    for (size_t f = 0; f < nFrames; ++f) {
+        for (size_t ch = 0; ch < MIC_CHANNELS; ++ch) {
+            if (ch == 0) {
+                *output++ = input[0];
+            } else if (ch == 1) {
+                *output++ = input[2];
+            } else if (ch == 2) {
+                *output++ = input[4];
+            } else if (ch == 3) {
+                *output++ = input[7];
+            } else {
+                *output++ = 0;
+            }
+        }
+        input += MIC_CHANNELS;
+    }
+}
+
+/// Which implementation a benchmark runs.
+enum Kernel { LEGACY, SCALAR, VECTOR };
+
+/**
+ * Remaps one capture callback worth of microphone frames.
+ *
+ * Arguments: frames per callback, kernel (0 legacy per-sample, 1 table scalar, 2 table vector).
+ */
+static void BM_RemapMicArray(benchmark::State& state) {
+    const size_t nFrames = state.range(0);
+    const Kernel kernel = static_cast<Kernel>(state.range(1));
+    auto remap = ChannelRemap::create(MIC_CHANNELS, MIC_ARRAY_MAP);
+    std::vector<int16_t> input(nFrames * MIC_CHANNELS);
+    std::vector<int16_t> output(nFrames * MIC_CHANNELS);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<int16_t>(i * 31);
+    }
+
+    for (auto _ : state) {
+        switch (kernel) {
+            case LEGACY:
+                legacyRemap(input.data(), output.data(), nFrames);
+                break;
+            case SCALAR:
+                remap->remapScalar(input.data(), output.data(), nFrames);
+                break;
+            case VECTOR:
+                remap->remap(input.data(), output.data(), nFrames);
+                break;
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(int16_t));
+    state.SetLabel(VECTOR == kernel ? ChannelRemap::getKernelName() : "");
+}
+
+/**
+ * Splits microphone frames into one plane per channel.
+ *
+ * Arguments: frames per call, kernel (1 table scalar, 2 table vector).
+ */
+static void BM_DeinterleaveMicArray(benchmark::State& state) {
+    const size_t nFrames = state.range(0);
+    const bool vector = (VECTOR == state.range(1));
+    auto remap = ChannelRemap::create(MIC_CHANNELS, {0, 1, 2, 3, 4, 5, 6, 7});
+    std::vector<int16_t> input(nFrames * MIC_CHANNELS, 0x1234);
+    std::vector<std::vector<int16_t>> planes(MIC_CHANNELS, std::vector<int16_t>(nFrames));
+    std::vector<int16_t*> planePointers;
+    for (auto& plane : planes) {
+        planePointers.push_back(plane.data());
+    }
+
+    for (auto _ : state) {
+        if (vector) {
+            remap->deinterleave(input.data(), planePointers.data(), nFrames);
+        } else {
+            remap->deinterleaveScalar(input.data(), planePointers.data(), nFrames);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * input.size() * sizeof(int16_t));
+    state.SetLabel(vector ? ChannelRemap::getKernelName() : "");
+}
+
+BENCHMARK(BM_RemapMicArray)->ArgNames({"frames", "kernel"})->ArgsProduct({{160, 2400}, {LEGACY, SCALAR, VECTOR}});
+
+BENCHMARK(BM_DeinterleaveMicArray)->ArgNames({"frames", "kernel"})->ArgsProduct({{160, 2400}, {SCALAR, VECTOR}});
+
+BENCHMARK_MAIN();
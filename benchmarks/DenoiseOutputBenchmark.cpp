@@ -0,0 +1,98 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Utils/SharedBuffer/SharedBuffer.h>
+
+using namespace aisdk::utils::sharedbuffer;
+
+/// The size of each word of the denoised stream.
+static const size_t WORD_SIZE = 2;
+
+/// The default data area of the denoised stream, as @c SoundAiKeywordDetector creates it.
+static const size_t DENOISE_BUFFER_SIZE_IN_BYTES = 0x80000;
+
+/// The default number of readers of the denoised stream.
+static const size_t MAX_DENOISE_READERS = 2;
+
+/// Benchmark argument value selecting the copy through a temporary vector the callback used to make.
+static const int64_t PATH_VECTOR_COPY = 0;
+
+/**
+ * The denoise output callback as it was: a fresh vector per frame, a memcpy into it, then the write.
+ *
+ * @param writer The denoised stream writer.
+ * @param data The engine's frame.
+ * @param size The size of the frame in bytes.
+ */
+static void writeThroughVector(Writer* writer, const char* data, size_t size) {
+    std::vector<int16_t> pushToBuffer(size / sizeof(int16_t));
+    memcpy(pushToBuffer.data(), data, size);
+    writer->write(pushToBuffer.data(), pushToBuffer.size());
+}
+
+/**
+ * The denoise output callback now: the frame goes straight into the ring.
+ *
+ * @param writer The denoised stream writer.
+ * @param data The engine's frame.
+ * @param size The size of the frame in bytes.
+ */
+static void writeDirect(Writer* writer, const char* data, size_t size) {
+    writer->write(data, size / WORD_SIZE);
+}
+
+/**
+ * One engine callback's worth of denoised audio into the denoised stream, with the ASR reader draining it.  The frame
+ * is deliberately misaligned by one byte, as nothing guarantees the engine's buffer is 16-bit aligned.
+ *
+ * Arguments: frame size in bytes, path (0 vector copy, 1 direct).
+ */
+static void BM_DenoiseOutput(benchmark::State& state) {
+    const size_t frameBytes = state.range(0);
+    const bool direct = (PATH_VECTOR_COPY != state.range(1));
+
+    auto bufferSize =
+        SharedBuffer::calculateBufferSize(DENOISE_BUFFER_SIZE_IN_BYTES / WORD_SIZE, WORD_SIZE, MAX_DENOISE_READERS);
+    auto stream = SharedBuffer::create(std::make_shared<SharedBuffer::Buffer>(bufferSize), WORD_SIZE, MAX_DENOISE_READERS);
+    auto writer = stream->createWriter(WriterPolicy::NONBLOCKABLE);
+    auto reader = stream->createReader(ReaderPolicy::NONBLOCKING, true);
+
+    std::vector<char> engineFrame(frameBytes + 1);
+    for (size_t i = 0; i < engineFrame.size(); ++i) {
+        engineFrame[i] = static_cast<char>(i * 7);
+    }
+    const char* frame = engineFrame.data() + 1;
+
+    for (auto _ : state) {
+        if (direct) {
+            writeDirect(writer.get(), frame, frameBytes);
+        } else {
+            writeThroughVector(writer.get(), frame, frameBytes);
+        }
+        Reader::Spans spans;
+        auto result = reader->peek(&spans, frameBytes / WORD_SIZE);
+        benchmark::DoNotOptimize(spans.first.data);
+        reader->consume(result);
+    }
+
+    state.SetBytesProcessed(state.iterations() * frameBytes);
+}
+
+BENCHMARK(BM_DenoiseOutput)->ArgNames({"frameBytes", "direct"})->ArgsProduct({{320, 512, 2048}, {0, 1}});
+
+BENCHMARK_MAIN();
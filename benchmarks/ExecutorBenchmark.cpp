@@ -0,0 +1,220 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Utils/Threading/Executor.h>
+#include <Utils/Threading/WorkerPool.h>
+
+using namespace aisdk::utils::threading;
+
+/// Benchmark argument value selecting one thread per @c Executor, as every component used to have.
+static const int64_t MODEL_THREAD_PER_EXECUTOR = 0;
+
+/// The number of threads of the shared pool, about what the board has cores for.
+static const size_t NUM_POOL_THREADS = 4;
+
+/// Clock used to stamp submit and run times.
+using Clock = std::chrono::steady_clock;
+
+/// The number of heap allocations made so far by the whole process.
+static std::atomic<size_t> allocationCount(0);
+
+/// The allocator behind the counting operator new; called through pointers so the compiler doesn't pair them up.
+static void* (*volatile allocateMemory)(size_t) = std::malloc;
+static void (*volatile freeMemory)(void*) = std::free;
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = allocateMemory(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    freeMemory(memory);
+}
+
+/// Benchmark argument value selecting the @c submit() path as it was before tasks were stored inline.
+static const int64_t PATH_LEGACY_SUBMIT = 0;
+
+/// Benchmark argument value selecting @c Executor::submit().
+static const int64_t PATH_SUBMIT = 1;
+
+/// Benchmark argument value selecting @c Executor::execute().
+static const int64_t PATH_EXECUTE = 2;
+
+/// The number of tasks queued back to back per iteration, like a dialog state change fanning out.
+static const int TASKS_PER_BURST = 64;
+
+/**
+ * The task queue and thread as they were: every push binds the task, puts it in a shared @c std::packaged_task, makes
+ * a second shared promise for the cleanup future, copies the wrapper into a @c new @c std::function, queues that in a
+ * @c std::deque and wakes every waiter.
+ */
+class LegacyExecutor {
+public:
+    LegacyExecutor() : m_shutdown{false}, m_thread{&LegacyExecutor::loop, this} {
+    }
+
+    ~LegacyExecutor() {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_shutdown = true;
+        }
+        m_changed.notify_all();
+        m_thread.join();
+    }
+
+    template <typename Task>
+    std::future<void> submit(Task task) {
+        auto bindTask = std::bind(task);
+        auto packagedTask = std::make_shared<std::packaged_task<void()>>(bindTask);
+        auto cleanupPromise = std::make_shared<std::promise<void>>();
+        auto cleanupFuture = cleanupPromise->get_future();
+        auto translatedTask = [packagedTask, cleanupPromise]() mutable {
+            packagedTask->operator()();
+            auto taskFuture = packagedTask->get_future();
+            packagedTask.reset();
+            taskFuture.get();
+            cleanupPromise->set_value();
+        };
+        packagedTask.reset();
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_queue.emplace_back(new std::function<void()>(translatedTask));
+        }
+        m_changed.notify_all();
+        return cleanupFuture;
+    }
+
+private:
+    void loop() {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (true) {
+            m_changed.wait(lock, [this]() { return m_shutdown || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+            auto task = std::move(m_queue.front());
+            m_queue.pop_front();
+            lock.unlock();
+            (*task)();
+            lock.lock();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::deque<std::unique_ptr<std::function<void()>>> m_queue;
+    bool m_shutdown;
+    std::thread m_thread;
+};
+
+/**
+ * Measures queuing a burst of notification tasks, each capturing what a component callback typically captures, and
+ * waiting for the burst to drain.  The "allocsPerTask" counter is the number of heap allocations per queued task.
+ */
+static void BM_QueueTask(benchmark::State& state) {
+    const int64_t path = state.range(0);
+
+    LegacyExecutor legacy;
+    Executor executor(nullptr);
+    auto observer = std::make_shared<int>(0);
+    std::atomic<int> ran(0);
+
+    // Warm up the queue so the ring has already grown to the burst size.
+    executor.submit([]() {}).wait();
+
+    size_t allocations = 0;
+    for (auto _ : state) {
+        auto before = allocationCount.load(std::memory_order_relaxed);
+        for (int i = 0; i < TASKS_PER_BURST; ++i) {
+            auto task = [&ran, observer, i]() { ran.fetch_add(i, std::memory_order_relaxed); };
+            if (PATH_LEGACY_SUBMIT == path) {
+                legacy.submit(task);
+            } else if (PATH_SUBMIT == path) {
+                executor.submit(task);
+            } else {
+                executor.execute(task);
+            }
+        }
+        allocations += allocationCount.load(std::memory_order_relaxed) - before;
+
+        // Drain the burst; this wait is the same for every path.
+        std::promise<void> drained;
+        auto drainedFuture = drained.get_future();
+        if (PATH_LEGACY_SUBMIT == path) {
+            legacy.submit([&drained]() { drained.set_value(); });
+        } else {
+            executor.execute([&drained]() { drained.set_value(); });
+        }
+        drainedFuture.wait();
+    }
+
+    state.SetItemsProcessed(state.iterations() * TASKS_PER_BURST);
+    state.counters["allocsPerTask"] =
+        static_cast<double>(allocations) / (static_cast<double>(state.iterations()) * TASKS_PER_BURST);
+}
+BENCHMARK(BM_QueueTask)->ArgName("path")->DenseRange(PATH_LEGACY_SUBMIT, PATH_EXECUTE);
+
+/**
+ * Measures the time from @c Executor::submit() to the task starting, with a burst of one task to each of a number
+ * of executors per iteration, the way one NLP message or dialog state change fans out to the components.
+ * Reported time per iteration is the mean submit-to-run latency of the burst.
+ */
+static void BM_SubmitToRunLatency(benchmark::State& state) {
+    const size_t numExecutors = state.range(0);
+    const bool pooled = (MODEL_THREAD_PER_EXECUTOR != state.range(1));
+
+    auto pool = pooled ? WorkerPool::create(NUM_POOL_THREADS) : nullptr;
+    std::vector<std::unique_ptr<Executor>> executors;
+    for (size_t i = 0; i < numExecutors; ++i) {
+        executors.emplace_back(new Executor(pool));
+    }
+
+    std::vector<std::future<Clock::duration>> latencies(numExecutors);
+    for (auto _ : state) {
+        for (size_t i = 0; i < numExecutors; ++i) {
+            auto submitted = Clock::now();
+            latencies[i] = executors[i]->submit([submitted]() { return Clock::now() - submitted; });
+        }
+        Clock::duration total = Clock::duration::zero();
+        for (auto& latency : latencies) {
+            total += latency.get();
+        }
+        state.SetIterationTime(std::chrono::duration<double>(total).count() / numExecutors);
+    }
+
+    state.counters["threads"] = pooled ? NUM_POOL_THREADS : numExecutors;
+}
+BENCHMARK(BM_SubmitToRunLatency)
+    ->ArgNames({"executors", "pooled"})
+    ->ArgsProduct({{1, 8, 24}, {0, 1}})
+    ->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,271 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <dlfcn.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <AudioMediaPlayer/FFmpegDecoder.h>
+#include <AudioMediaPlayer/FFmpegStreamInputController.h>
+#include <AudioMediaPlayer/FFmpegUrlInputController.h>
+#include <AudioMediaPlayer/PlaybackConfiguration.h>
+#include <AudioMediaPlayer/StreamInfoCache.h>
+
+using namespace aisdk::mediaPlayer::ffmpeg;
+
+/**
+ * Every heap allocation of the process, FFmpeg's included: malloc and friends are wrapped below and forward to the
+ * C library through dlsym(RTLD_NEXT).
+ */
+static std::atomic<uint64_t> g_allocations{0};
+
+/// Serves the few allocations dlsym() may make while the real functions are being looked up.
+static char g_bootstrapHeap[4096];
+static std::atomic<size_t> g_bootstrapUsed{0};
+
+static bool isBootstrap(void* ptr) {
+    auto bytes = static_cast<char*>(ptr);
+    return bytes >= g_bootstrapHeap && bytes < g_bootstrapHeap + sizeof g_bootstrapHeap;
+}
+
+static void* bootstrapAlloc(size_t size) {
+    size = (size + 15) & ~static_cast<size_t>(15);
+    auto offset = g_bootstrapUsed.fetch_add(size);
+    return offset + size <= sizeof g_bootstrapHeap ? g_bootstrapHeap + offset : nullptr;
+}
+
+template <typename Function>
+static Function nextSymbol(const char* name) {
+    return reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+}
+
+extern "C" {
+
+void* malloc(size_t size) {
+    static auto real = nextSymbol<void* (*)(size_t)>("malloc");
+    if (!real) {
+        return bootstrapAlloc(size);
+    }
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return real(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    static std::atomic<bool> resolving{false};
+    static void* (*real)(size_t, size_t) = nullptr;
+    if (!real) {
+        if (resolving.exchange(true)) {
+            // dlsym() allocating while it looks calloc up; the bootstrap heap is zeroed.
+            return bootstrapAlloc(count * size);
+        }
+        real = nextSymbol<void* (*)(size_t, size_t)>("calloc");
+    }
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return real(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    static auto real = nextSymbol<void* (*)(void*, size_t)>("realloc");
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (isBootstrap(ptr)) {
+        // A bootstrap block doesn't know its size; copy as much as there can be.
+        auto available = static_cast<size_t>(g_bootstrapHeap + sizeof g_bootstrapHeap - static_cast<char*>(ptr));
+        void* moved = real(nullptr, size);
+        if (moved) {
+            std::memcpy(moved, ptr, std::min(size, available));
+        }
+        return moved;
+    }
+    return real(ptr, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    static auto real = nextSymbol<int (*)(void**, size_t, size_t)>("posix_memalign");
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return real(ptr, alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    static auto real = nextSymbol<void* (*)(size_t, size_t)>("aligned_alloc");
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return real(alignment, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    static auto real = nextSymbol<void* (*)(size_t, size_t)>("memalign");
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return real(alignment, size);
+}
+
+void free(void* ptr) {
+    static auto real = nextSymbol<void (*)(void*)>("free");
+    if (!ptr || isBootstrap(ptr)) {
+        return;
+    }
+    real(ptr);
+}
+
+}  // extern "C"
+
+/// The size of the buffer @c AOWrapper reads from the decoder.
+static const size_t PLAYER_READ_BYTES = 16384;
+
+/// Bytes per second of the default output: 48 kHz stereo 16 bit.
+static const double OUTPUT_BYTES_PER_SECOND = 48000 * 2 * 2;
+
+/**
+ * Decodes one file to the default output format from start to end, as @c AOWrapper would.
+ *
+ * Reports the decoded audio as bytes per second, the heap allocations per second of CPU time ("allocs") and per
+ * second of audio ("allocsPerAudioSecond"), and, separately, those made after the first read, which leaves out
+ * opening the input and the codec ("steadyAllocsPerAudioSecond").
+ */
+static void BM_Decode(benchmark::State& state, const std::string& path) {
+    std::vector<FFmpegDecoder::Byte> buffer(PLAYER_READ_BYTES);
+    uint64_t allocations = 0;
+    uint64_t steadyAllocations = 0;
+    size_t bytes = 0;
+    size_t steadyBytes = 0;
+
+    for (auto _ : state) {
+        auto stream = std::make_shared<std::ifstream>(path, std::ios::binary);
+        if (!stream->is_open()) {
+            state.SkipWithError(("cannot open " + path).c_str());
+            return;
+        }
+        const auto start = g_allocations.load();
+        auto decoder =
+            FFmpegDecoder::create(FFmpegStreamInputController::create(stream, false), PlaybackConfiguration());
+        uint64_t afterFirstRead = 0;
+        bool first = true;
+        while (true) {
+            auto result = decoder->read(buffer.data(), buffer.size());
+            if (DecoderInterface::Status::ERROR == result.first) {
+                state.SkipWithError(("cannot decode " + path).c_str());
+                return;
+            }
+            bytes += result.second;
+            if (first) {
+                afterFirstRead = g_allocations.load();
+                first = false;
+            } else {
+                steadyBytes += result.second;
+            }
+            if (DecoderInterface::Status::DONE == result.first) {
+                break;
+            }
+        }
+        const auto end = g_allocations.load();
+        decoder.reset();
+        allocations += end - start;
+        steadyAllocations += end - afterFirstRead;
+    }
+
+    state.SetBytesProcessed(bytes);
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kIsRate);
+    state.counters["allocsPerAudioSecond"] = bytes ? allocations / (bytes / OUTPUT_BYTES_PER_SECOND) : 0;
+    state.counters["steadyAllocsPerAudioSecond"] =
+        steadyBytes ? steadyAllocations / (steadyBytes / OUTPUT_BYTES_PER_SECOND) : 0;
+}
+
+/**
+ * Opens a file by path and decodes until the first samples come out.
+ *
+ * @return How many bytes the first successful read returned; 0 if the file couldn't be decoded.
+ */
+static size_t readFirstSamples(const std::string& path, std::vector<FFmpegDecoder::Byte>* buffer) {
+    auto decoder = FFmpegDecoder::create(
+        FFmpegUrlInputController::create(path, std::chrono::milliseconds::zero()), PlaybackConfiguration());
+    if (!decoder) {
+        return 0;
+    }
+    std::pair<DecoderInterface::Status, size_t> result{DecoderInterface::Status::OK, 0};
+    while (DecoderInterface::Status::OK == result.first && 0 == result.second) {
+        result = decoder->read(buffer->data(), buffer->size());
+    }
+    return result.second;
+}
+
+/**
+ * Opens one file by path, as the players do for prompts, and decodes until the first samples come out.
+ *
+ * With @c fastOpen the stream description is in the cache from a previous open, so @c avformat_find_stream_info() is
+ * skipped; otherwise the cache is cleared first and the stream is probed.  Reports the mean time to the first sample
+ * ("timeToFirstSampleUs").
+ */
+static void BM_TimeToFirstSample(benchmark::State& state, const std::string& path, bool fastOpen) {
+    std::vector<FFmpegDecoder::Byte> buffer(PLAYER_READ_BYTES);
+    std::chrono::steady_clock::duration total{0};
+    StreamInfoCache::instance().clear();
+    if (fastOpen && !readFirstSamples(path, &buffer)) {
+        state.SkipWithError(("cannot decode " + path).c_str());
+        return;
+    }
+
+    for (auto _ : state) {
+        if (!fastOpen) {
+            StreamInfoCache::instance().clear();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        auto bytes = readFirstSamples(path, &buffer);
+        total += std::chrono::steady_clock::now() - start;
+        if (!bytes) {
+            state.SkipWithError(("cannot decode " + path).c_str());
+            return;
+        }
+    }
+
+    state.counters["timeToFirstSampleUs"] =
+        std::chrono::duration_cast<std::chrono::microseconds>(total).count() / static_cast<double>(state.iterations());
+}
+
+/**
+ * Registers one benchmark per file in $DECODER_BENCHMARK_FILES (colon separated), or per file in the default list the
+ * build passes in.  Point it at an MP3, an AAC and a WAV file to cover the formats the players see.
+ */
+int main(int argc, char** argv) {
+    const char* files = std::getenv("DECODER_BENCHMARK_FILES");
+    std::stringstream list(files ? files : DEFAULT_DECODER_BENCHMARK_FILES);
+    std::string path;
+    while (std::getline(list, path, ':')) {
+        if (!path.empty()) {
+            auto name = path.substr(path.find_last_of('/') + 1);
+            benchmark::RegisterBenchmark(("BM_Decode/" + name).c_str(), BM_Decode, path)
+                ->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(
+                ("BM_TimeToFirstSample/probe/" + name).c_str(), BM_TimeToFirstSample, path, false)
+                ->Unit(benchmark::kMicrosecond);
+            benchmark::RegisterBenchmark(
+                ("BM_TimeToFirstSample/fast/" + name).c_str(), BM_TimeToFirstSample, path, true)
+                ->Unit(benchmark::kMicrosecond);
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
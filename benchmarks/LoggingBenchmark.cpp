@@ -0,0 +1,191 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#include <benchmark/benchmark.h>
+
+#include <Utils/Logging/AsyncLogger.h>
+#include <Utils/Logging/LogEntry.h>
+#include <Utils/Logging/LogStringFormatter.h>
+#include <Utils/Logging/Logger.h>
+#include <Utils/Logging/ThreadMoniker.h>
+#include <Utils/Logging/SafeCTimeAccess.h>
+
+using namespace aisdk::utils::logging;
+
+/// String to identify log entries originating from this file.
+static const std::string TAG("LoggingBenchmark");
+
+/// Define output
+#define LX(event) aisdk::utils::logging::LogEntry(TAG, event)
+
+/// Benchmark argument value selecting the synchronous console sink.
+static const int64_t SINK_SYNC = 0;
+
+/// The number of lines logged back to back per iteration; the async ring is drained between iterations.
+static const int LINES_PER_BURST = 64;
+
+/**
+ * The console sink as the application configures it: one mutex, format every line, write and flush it.  Output goes
+ * to /dev/null so the terminal doesn't dominate.
+ */
+class SyncConsoleSink : public Logger {
+public:
+    SyncConsoleSink() : Logger(Level::DEBUG5), m_out{std::fopen("/dev/null", "w")} {
+    }
+
+    ~SyncConsoleSink() {
+        std::fclose(m_out);
+    }
+
+    void emit(Level level, std::chrono::system_clock::time_point time, const char* threadMoniker, const char* text)
+        override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto line = m_formatter.format(level, time, threadMoniker, text);
+        std::fputs(line.c_str(), m_out);
+        std::fputc('\n', m_out);
+        std::fflush(m_out);
+    }
+
+private:
+    std::mutex m_mutex;
+    LogStringFormatter m_formatter;
+    FILE* m_out;
+};
+
+/**
+ * Creates the logger the benchmark logs to.
+ *
+ * @param state The benchmark state; range(0) selects the sink.
+ * @return The sink, or the sink behind an @c AsyncLogger.
+ */
+static std::shared_ptr<Logger> createLogger(const benchmark::State& state) {
+    std::shared_ptr<Logger> sink = std::make_shared<SyncConsoleSink>();
+    if (SINK_SYNC == state.range(0)) {
+        return sink;
+    }
+    return AsyncLogger::create(sink);
+}
+
+/**
+ * Waits for an @c AsyncLogger to empty its ring, outside the timed region.
+ *
+ * @param logger The logger.
+ */
+static void drainOutsideTiming(benchmark::State& state, const std::shared_ptr<Logger>& logger) {
+    auto asyncLogger = std::dynamic_pointer_cast<AsyncLogger>(logger);
+    if (asyncLogger) {
+        state.PauseTiming();
+        asyncLogger->flush();
+        state.ResumeTiming();
+    }
+}
+
+/**
+ * Measures the caller side of emitting an already built line: what a hot thread pays inside @c Logger::log().
+ */
+static void BM_Emit(benchmark::State& state) {
+    auto logger = createLogger(state);
+    const char* text = "SoundAiEngine:onWakeup:keyword=xiaoyixiaoyi,angle=30.000000,dialogId=123456";
+    for (auto _ : state) {
+        for (int i = 0; i < LINES_PER_BURST; ++i) {
+            logger->emit(Level::INFO, std::chrono::system_clock::now(), "1a", text);
+        }
+        drainOutsideTiming(state, logger);
+    }
+    state.SetItemsProcessed(state.iterations() * LINES_PER_BURST);
+}
+BENCHMARK(BM_Emit)->ArgName("async")->Arg(SINK_SYNC)->Arg(1);
+
+/**
+ * Measures a whole log call as the components make it, building the @c LogEntry included.
+ */
+static void BM_LogCall(benchmark::State& state) {
+    auto logger = createLogger(state);
+    int n = 0;
+    for (auto _ : state) {
+        for (int i = 0; i < LINES_PER_BURST; ++i) {
+            logger->log(Level::INFO, LX("onWakeup").d("keyword", "xiaoyixiaoyi").d("count", ++n));
+        }
+        drainOutsideTiming(state, logger);
+    }
+    state.SetItemsProcessed(state.iterations() * LINES_PER_BURST);
+}
+BENCHMARK(BM_LogCall)->ArgName("async")->Arg(SINK_SYNC)->Arg(1);
+
+/**
+ * A debug line below AISDK_LOG_MIN_LEVEL, which this release build sets to INFO: nothing is left of it, not even the
+ * @c LogEntry.
+ */
+static void BM_DebugBelowMinLevel(benchmark::State& state) {
+    int n = 0;
+    for (auto _ : state) {
+        AISDK_DEBUG5(LX("onWakeup").d("count", ++n));
+        benchmark::DoNotOptimize(n);
+    }
+}
+BENCHMARK(BM_DebugBelowMinLevel);
+
+/**
+ * The formatter as it was before it cached the date: @c gmtime() under the process-wide lock, @c strftime() and a
+ * @c std::stringstream for every line.
+ */
+static std::string legacyFormat(
+    Level level,
+    std::chrono::system_clock::time_point time,
+    const char* threadMoniker,
+    const char* text) {
+    static auto safeCTimeAccess = aisdk::utils::timing::SafeCTimeAccess::instance();
+    char dateTimeString[20];
+    auto timeAsTime_t = std::chrono::system_clock::to_time_t(time);
+    timeAsTime_t += (8 * 3600);
+    std::tm timeAsTm;
+    if (!safeCTimeAccess->getGmtime(timeAsTime_t, &timeAsTm) ||
+        0 == strftime(dateTimeString, sizeof(dateTimeString), "%Y-%m-%d %H:%M:%S", &timeAsTm)) {
+        dateTimeString[0] = '\0';
+    }
+    auto timeMillisPart =
+        static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000);
+    char millisString[12];
+    std::snprintf(millisString, sizeof(millisString), "%03d", timeMillisPart);
+    std::stringstream stringToEmit;
+    stringToEmit << dateTimeString << '.' << millisString << " [" << threadMoniker << "] " << level << ' ' << text;
+    return stringToEmit.str();
+}
+
+/// Benchmark argument value selecting the legacy formatter.
+static const int64_t FORMATTER_LEGACY = 0;
+
+/**
+ * Measures formatting one line, with the clock advancing 1 ms per line so the cached formatter re-renders its
+ * date once every thousand lines, as it would under a steady stream of logging.
+ */
+static void BM_FormatLine(benchmark::State& state) {
+    LogStringFormatter formatter(std::chrono::hours(8));
+    const char* text = "SoundAiEngine:onWakeup:keyword=xiaoyixiaoyi,angle=30.000000,dialogId=123456";
+    auto time = std::chrono::system_clock::now();
+    const bool legacy = FORMATTER_LEGACY == state.range(0);
+    for (auto _ : state) {
+        time += std::chrono::milliseconds(1);
+        auto line = legacy ? legacyFormat(Level::INFO, time, "1a", text)
+                           : formatter.format(Level::INFO, time, "1a", text);
+        benchmark::DoNotOptimize(line);
+    }
+}
+BENCHMARK(BM_FormatLine)->ArgName("cached")->Arg(FORMATTER_LEGACY)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <Utils/SharedBuffer/SharedBuffer.h>
+
+using namespace aisdk::utils::sharedbuffer;
+
+/// The number of bytes the writer pushes through the buffer per iteration of the fan-out benchmark.
+static const size_t FANOUT_BYTES_PER_ITERATION = 4 * 1024 * 1024;
+
+/// The size of the data area (in bytes) of the buffers used by the benchmarks.
+static const size_t BUFFER_DATA_BYTES = 256 * 1024;
+
+/// The @c maxReaders every benchmark buffer is created with.
+static const size_t MAX_READERS = 8;
+
+/// Benchmark argument value selecting @c ReaderPolicy::BLOCKING.
+static const int64_t READER_BLOCKING = 0;
+
+/// Benchmark argument value selecting a copying @c Reader::read().
+static const int64_t ACCESS_READ = 0;
+
+/**
+ * Allocates a heap @c Buffer large enough for @c BUFFER_DATA_BYTES of data.
+ *
+ * @param wordSize The word size the buffer will be created with.
+ * @return The buffer.
+ */
+static std::shared_ptr<SharedBuffer::Buffer> allocateBuffer(size_t wordSize) {
+    auto size = SharedBuffer::calculateBufferSize(BUFFER_DATA_BYTES / wordSize, wordSize, MAX_READERS);
+    return std::make_shared<SharedBuffer::Buffer>(size);
+}
+
+/**
+ * One writer streams @c FANOUT_BYTES_PER_ITERATION through the buffer to N reader threads, each of which must see
+ * every word.  The writer is BLOCKING so the readers' speed, not overruns, decides the throughput.
+ *
+ * Arguments: number of readers, word size, words per write/read call, reader policy (0 BLOCKING, 1 NONBLOCKING).
+ */
+static void BM_WriterToReaders(benchmark::State& state) {
+    const size_t nReaders = state.range(0);
+    const size_t wordSize = state.range(1);
+    const size_t chunkWords = state.range(2);
+    const auto readerPolicy = (READER_BLOCKING == state.range(3)) ? ReaderPolicy::BLOCKING : ReaderPolicy::NONBLOCKING;
+    const size_t totalWords = FANOUT_BYTES_PER_ITERATION / wordSize;
+
+    auto buffer = allocateBuffer(wordSize);
+    std::vector<uint8_t> source(chunkWords * wordSize);
+    for (size_t i = 0; i < source.size(); ++i) {
+        source[i] = static_cast<uint8_t>(i);
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::shared_ptr<SharedBuffer> sharedBuffer = SharedBuffer::create(buffer, wordSize, MAX_READERS);
+        auto writer = sharedBuffer->createWriter(WriterPolicy::BLOCKING);
+        std::atomic<size_t> shortReaders{0};
+        std::vector<std::thread> threads;
+        for (size_t r = 0; r < nReaders; ++r) {
+            std::shared_ptr<Reader> reader = sharedBuffer->createReader(readerPolicy, true);
+            threads.emplace_back([reader, chunkWords, wordSize, totalWords, &shortReaders] {
+                std::vector<uint8_t> sink(chunkWords * wordSize);
+                size_t received = 0;
+                while (true) {
+                    auto result = reader->read(sink.data(), chunkWords);
+                    if (result > 0) {
+                        received += result;
+                    } else if (Reader::Error::WOULDBLOCK == result) {
+                        std::this_thread::yield();
+                    } else {
+                        break;
+                    }
+                }
+                if (received != totalWords) {
+                    ++shortReaders;
+                }
+            });
+        }
+        state.ResumeTiming();
+
+        for (size_t written = 0; written < totalWords;) {
+            size_t nWords = std::min(chunkWords, totalWords - written);
+            auto result = writer->write(source.data(), nWords);
+            if (result <= 0) {
+                break;
+            }
+            written += result;
+        }
+        writer->close();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (shortReaders > 0) {
+            state.SkipWithError("reader missed data");
+            break;
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * FANOUT_BYTES_PER_ITERATION);
+    state.counters["readers"] = nReaders;
+}
+
+/**
+ * Single-threaded write-then-read of one chunk, the per-call cost without any waiting.
+ *
+ * Arguments: word size, words per call, access (0 read(), 1 peek()/consume()).
+ */
+static void BM_WriteRead(benchmark::State& state) {
+    const size_t wordSize = state.range(0);
+    const size_t chunkWords = state.range(1);
+    const bool copying = (ACCESS_READ == state.range(2));
+
+    auto sharedBuffer = SharedBuffer::create(allocateBuffer(wordSize), wordSize, MAX_READERS);
+    auto writer = sharedBuffer->createWriter(WriterPolicy::NONBLOCKABLE);
+    auto reader = sharedBuffer->createReader(ReaderPolicy::NONBLOCKING, true);
+    std::vector<uint8_t> source(chunkWords * wordSize, 0x5a);
+    std::vector<uint8_t> sink(chunkWords * wordSize);
+
+    for (auto _ : state) {
+        writer->write(source.data(), chunkWords);
+        if (copying) {
+            benchmark::DoNotOptimize(reader->read(sink.data(), chunkWords));
+        } else {
+            Reader::Spans spans;
+            auto result = reader->peek(&spans, chunkWords);
+            benchmark::DoNotOptimize(spans.first.data);
+            reader->consume(result);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * chunkWords * wordSize);
+}
+
+/**
+ * A NONBLOCKING reader which fell a full buffer behind a NONBLOCKABLE writer: time to notice the overrun, seek back
+ * to live data and get the next chunk.  Only the recovery is timed, not the writes that cause it.
+ *
+ * Arguments: words per call.
+ */
+static void BM_OverrunRecovery(benchmark::State& state) {
+    const size_t wordSize = 2;
+    const size_t chunkWords = state.range(0);
+
+    auto sharedBuffer = SharedBuffer::create(allocateBuffer(wordSize), wordSize, MAX_READERS);
+    auto writer = sharedBuffer->createWriter(WriterPolicy::NONBLOCKABLE);
+    auto reader = sharedBuffer->createReader(ReaderPolicy::NONBLOCKING, true);
+    const size_t lapWords = sharedBuffer->getDataSize() + chunkWords;
+    std::vector<uint8_t> source(lapWords * wordSize, 0x5a);
+    std::vector<uint8_t> sink(chunkWords * wordSize);
+
+    for (auto _ : state) {
+        writer->write(source.data(), chunkWords);
+        writer->write(source.data(), lapWords - chunkWords);
+
+        auto start = std::chrono::steady_clock::now();
+        auto result = reader->read(sink.data(), chunkWords);
+        if (Reader::Error::OVERRUN == result) {
+            reader->seek(chunkWords, Reader::Reference::BEFORE_WRITER);
+            result = reader->read(sink.data(), chunkWords);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        if (result != static_cast<ssize_t>(chunkWords)) {
+            state.SkipWithError("overrun recovery failed");
+            break;
+        }
+        state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+    }
+}
+
+BENCHMARK(BM_WriterToReaders)
+    ->ArgNames({"readers", "wordSize", "chunkWords", "nonblocking"})
+    ->ArgsProduct({{1, 2, 4}, {2, 16}, {64, 1024}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_WriteRead)
+    ->ArgNames({"wordSize", "chunkWords", "peek"})
+    ->ArgsProduct({{2, 16}, {64, 1024}, {0, 1}});
+
+BENCHMARK(BM_OverrunRecovery)->ArgNames({"chunkWords"})->Arg(64)->Arg(1024)->UseManualTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2019 gm its affiliates. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License").
+ * You may not use this file except in compliance with the License.
+ *
+ * or in the "license" file accompanying this file. This file is distributed
+ * on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ * express or implied. See the License for the specific language governing
+ * permissions and limitations under the License.
+ */
+
+#include "Utils/Logging/Logger.h"
+
+namespace aisdk {
+namespace utils {
+namespace logging {
+
+/**
+ * A @c Logger which drops everything, so the benchmarks measure the data path rather than console output.
+ * It is selected with @c ACSDK_LOG_SINK=Null.
+ */
+class NullLogger : public Logger {
+public:
+    /// Constructor.
+    NullLogger() : Logger(Level::NONE) {
+    }
+
+    void emit(Level level, std::chrono::system_clock::time_point time, const char* threadMoniker, const char* text)
+        override {
+    }
+};
+
+std::shared_ptr<Logger> getNullLogger() {
+    static std::shared_ptr<Logger> nullLogger = std::make_shared<NullLogger>();
+    return nullLogger;
+}
+
+}  // namespace logging
+}  // namespace utils
+}  // namespace aisdk
@@ -26,3 +26,6 @@ include (ASREngine)
 
 # Setup googletest variables.
 include (Gtest)
+
+# Setup google benchmark variables.
+include (Benchmark)
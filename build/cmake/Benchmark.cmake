@@ -0,0 +1,25 @@
+#
+# Set up google benchmark for the microbenchmarks in benchmarks/.
+#
+# To build the benchmarks as part of the tree, run the following command,
+#     cmake <path-to-source>
+#       -DBENCHMARK_ENABLE=ON
+#           -DBENCHMARK_LIB_DIR=<path-to-benchmark-lib-dir>
+#           -DBENCHMARK_INCLUDE_DIR=<path-to-benchmark-include-dir>
+#
+# The benchmarks can also be built on their own for the host, which needs none of the board libraries,
+#     cmake -S <path-to-source>/benchmarks -B <build-dir> && cmake --build <build-dir> --target run_benchmarks
+#
+# If the paths are not given, the installed google benchmark is used.
+#
+
+option(BENCHMARK_ENABLE "Enable google benchmark for the microbenchmarks" OFF)
+
+if(BENCHMARK_ENABLE)
+	if(BENCHMARK_LIB_DIR)
+		link_directories(${BENCHMARK_LIB_DIR})
+	endif()
+	if(BENCHMARK_INCLUDE_DIR)
+		include_directories(${BENCHMARK_INCLUDE_DIR})
+	endif()
+endif()
@@ -5,6 +5,7 @@
 #     cmake <path-to-source> -DCMAKE_BUILD_TYPE=<build-type>
 #
 option(AISDK_LOG_MODULE "Enable module log level set." OFF)
+set(AISDK_LOG_MIN_LEVEL "" CACHE STRING "Compile out log lines below this level: DEBUG5..DEBUG0, INFO, WARN, ERROR, CRITICAL or NONE. Empty keeps the build type default.")
 
 # If no build type is specified by specifying it on the command line, default to debug.
 if(NOT CMAKE_BUILD_TYPE)
@@ -30,6 +31,10 @@ if(AISDK_LOG_MODULE)
 	add_definitions(-DAISDK_LOG_MODULE)	
 endif()
 
+if(AISDK_LOG_MIN_LEVEL)
+	add_definitions(-DAISDK_LOG_MIN_LEVEL=AISDK_LOG_LEVEL_${AISDK_LOG_MIN_LEVEL})
+endif()
+
 set(CMAKE_CXX_FLAGS_DEBUG "${CXX_PLATFORM_DEPENDENT_FLAGS_DEBUG} -DRAPIDJSON_HAS_STDSTRING" CACHE INTERNAL "Flags used for DEBUG builds" FORCE)
 set(CMAKE_C_FLAGS_DEBUG ${CMAKE_CXX_FLAGS_DEBUG} CACHE INTERNAL "Flags used for DEBUG builds" FORCE)
 
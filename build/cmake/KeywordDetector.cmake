@@ -18,7 +18,6 @@ option(SOUNDAI_KEY_WORD_DETECTOR "Enable SoundAi keyword detector." OFF)
 if(NOT IFLYTEK_KEY_WORD_DETECTOR AND NOT SOUNDAI_KEY_WORD_DETECTOR)
     message("No keyword detector type specified, skipping build of keyword detector.")
     add_definitions(-DPUSH_TAP)
-    set(LIB_SHARED_BUFFER "${SOUNDAI_KEY_WORD_DETECTOR_LIB_PATH}/libsharedbuffer.a")
     return()
 endif()
 
@@ -33,7 +32,6 @@ if(IFLYTEK_KEY_WORD_DETECTOR)
     add_definitions(-DKWD)
     add_definitions(-DKWD_IFLYTEK)
 	link_directories("${IFLYTEK_KEY_WORD_DETECTOR_LIB_PATH}")
-	set(LIB_SHARED_BUFFER "${IFLYTEK_KEY_WORD_DETECTOR_LIB_PATH}/libSharedBuffer.a")
     set(KWD ON)
 endif()
 
@@ -48,6 +46,5 @@ if(SOUNDAI_KEY_WORD_DETECTOR)
     add_definitions(-DKWD)
     add_definitions(-DKWD_SOUNDAI)
 	link_directories("${SOUNDAI_KEY_WORD_DETECTOR_LIB_PATH}")
-	set(LIB_SHARED_BUFFER "${SOUNDAI_KEY_WORD_DETECTOR_LIB_PATH}/libsharedbuffer.a")
     set(KWD ON)
 endif()